@@ -215,6 +215,51 @@ if (WAMR_BUILD_LINUX_PERF EQUAL 1)
   endif ()
 endif ()
 
+if (WAMR_BUILD_INSTANCE_SNAPSHOT EQUAL 1)
+  if (WAMR_BUILD_GC EQUAL 1)
+    message(WARNING "instance snapshot isn't supported when GC is enabled")
+    set(WAMR_BUILD_INSTANCE_SNAPSHOT 0)
+  endif ()
+endif ()
+
+if (WAMR_BUILD_INSTANCE_RESET EQUAL 1)
+  if (WAMR_BUILD_GC EQUAL 1)
+    message(WARNING "instance reset isn't supported when GC is enabled")
+    set(WAMR_BUILD_INSTANCE_RESET 0)
+  endif ()
+endif ()
+
+if (WAMR_BUILD_LAZY_VALIDATION EQUAL 1)
+  if (WAMR_BUILD_JIT EQUAL 1 OR WAMR_BUILD_FAST_JIT EQUAL 1
+      OR WAMR_BUILD_DEBUG_INTERP EQUAL 1 OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message(WARNING "lazy validation isn't supported when JIT, source debugging or mini loader is enabled")
+    set(WAMR_BUILD_LAZY_VALIDATION 0)
+  endif ()
+endif ()
+
+if (WAMR_BUILD_PARALLEL_LOADER EQUAL 1)
+  if (WAMR_BUILD_GC EQUAL 1 OR WAMR_BUILD_DEBUG_INTERP EQUAL 1
+      OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message(WARNING "parallel loader isn't supported when GC, source debugging or mini loader is enabled")
+    set(WAMR_BUILD_PARALLEL_LOADER 0)
+  endif ()
+endif ()
+
+if (WAMR_BUILD_STREAM_LOADER EQUAL 1)
+  if (NOT WAMR_BUILD_INTERP EQUAL 1 OR WAMR_BUILD_GC EQUAL 1
+      OR WAMR_BUILD_DEBUG_INTERP EQUAL 1 OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message(WARNING "stream loader requires the interpreter, and isn't supported when GC, source debugging or mini loader is enabled")
+    set(WAMR_BUILD_STREAM_LOADER 0)
+  endif ()
+endif ()
+
+if (WAMR_BUILD_FAST_INTERP_CACHE EQUAL 1)
+  if (WAMR_BUILD_GC EQUAL 1 OR WAMR_BUILD_MINI_LOADER EQUAL 1)
+    message(WARNING "fast interpreter code cache isn't supported when GC or mini loader is enabled")
+    set(WAMR_BUILD_FAST_INTERP_CACHE 0)
+  endif ()
+endif ()
+
 if (NOT DEFINED WAMR_BUILD_SHRUNK_MEMORY)
   # Enable shrunk memory by default
   set (WAMR_BUILD_SHRUNK_MEMORY 1)
@@ -304,6 +349,14 @@ endif ()
 if ((WAMR_BUILD_FAST_INTERP EQUAL 1) AND (WAMR_BUILD_INTERP EQUAL 1))
   add_definitions (-DWASM_ENABLE_FAST_INTERP=1)
   message ("     Fast interpreter enabled")
+  if (WAMR_BUILD_SUPERINSTRUCTIONS EQUAL 1)
+    add_definitions (-DWASM_ENABLE_SUPERINSTRUCTIONS=1)
+    message ("     Fast interpreter superinstructions enabled")
+  endif ()
+  if (WAMR_BUILD_FAST_INTERP_CACHE EQUAL 1)
+    add_definitions (-DWASM_ENABLE_FAST_INTERP_CACHE=1)
+    message ("     Fast interpreter code cache enabled")
+  endif ()
 else ()
   add_definitions (-DWASM_ENABLE_FAST_INTERP=0)
   message ("     Fast interpreter disabled")
@@ -418,6 +471,34 @@ if (WAMR_BUILD_COPY_CALL_STACK EQUAL 1)
   add_definitions (-DWASM_ENABLE_COPY_CALL_STACK=1)
   message("     Copy callstack enabled")
 endif()
+if (WAMR_BUILD_INSTANCE_SNAPSHOT EQUAL 1)
+  add_definitions (-DWASM_ENABLE_INSTANCE_SNAPSHOT=1)
+  message ("     Instance snapshot enabled")
+endif ()
+if (WAMR_BUILD_INSTANCE_RESET EQUAL 1)
+  add_definitions (-DWASM_ENABLE_INSTANCE_RESET=1)
+  message ("     Instance reset enabled")
+endif ()
+if (WAMR_BUILD_MEMORY_IMAGE EQUAL 1)
+  add_definitions (-DWASM_ENABLE_MEMORY_IMAGE=1)
+  message ("     Memory image of data segments enabled")
+endif ()
+if (WAMR_BUILD_LAZY_LINEAR_MEMORY EQUAL 1)
+  add_definitions (-DWASM_ENABLE_LAZY_LINEAR_MEMORY=1)
+  message ("     Lazy linear memory enabled")
+endif ()
+if (WAMR_BUILD_LAZY_VALIDATION EQUAL 1)
+  add_definitions (-DWASM_ENABLE_LAZY_VALIDATION=1)
+  message ("     Lazy validation of functions enabled")
+endif ()
+if (WAMR_BUILD_PARALLEL_LOADER EQUAL 1)
+  add_definitions (-DWASM_ENABLE_PARALLEL_LOADER=1)
+  message ("     Parallel loader enabled")
+endif ()
+if (WAMR_BUILD_STREAM_LOADER EQUAL 1)
+  add_definitions (-DWASM_ENABLE_STREAM_LOADER=1)
+  message ("     Stream loader enabled")
+endif ()
 if (WAMR_BUILD_MEMORY64 EQUAL 1)
   # if native is 32-bit or cross-compiled to 32-bit
   if (NOT WAMR_BUILD_TARGET MATCHES ".*64.*")
@@ -478,6 +559,10 @@ if (WAMR_BUILD_PERF_PROFILING EQUAL 1)
   add_definitions (-DWASM_ENABLE_PERF_PROFILING=1)
   message ("     Performance profiling enabled")
 endif ()
+if (WAMR_BUILD_OPCODE_COUNTER EQUAL 1)
+  add_definitions (-DWASM_ENABLE_OPCODE_COUNTER=1)
+  message ("     Opcode counter enabled")
+endif ()
 if (DEFINED WAMR_APP_THREAD_STACK_SIZE_MAX)
   add_definitions (-DAPP_THREAD_STACK_SIZE_MAX=${WAMR_APP_THREAD_STACK_SIZE_MAX})
 endif ()
@@ -511,6 +596,22 @@ if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_PERF_PROFILING EQUAL 1)
 else ()
   message ("     GC performance profiling disabled")
 endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_INCREMENTAL EQUAL 1)
+  add_definitions (-DWASM_ENABLE_GC_INCREMENTAL=1)
+  message ("     GC incremental marking enabled")
+endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_PARALLEL_MARKING EQUAL 1)
+  add_definitions (-DWASM_ENABLE_GC_PARALLEL_MARKING=1)
+  message ("     GC parallel marking enabled")
+endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_COMPACTION EQUAL 1)
+  add_definitions (-DWASM_ENABLE_GC_COMPACTION=1)
+  message ("     GC heap compaction enabled")
+endif ()
+if (WAMR_BUILD_GC EQUAL 1 AND WAMR_BUILD_GC_BUMP_ALLOC EQUAL 1)
+  add_definitions (-DWASM_ENABLE_GC_BUMP_ALLOC=1)
+  message ("     GC bump pointer allocation enabled")
+endif ()
 if (WAMR_BUILD_STRINGREF EQUAL 1)
   if (NOT DEFINED WAMR_STRINGREF_IMPL_SOURCE)
     message ("       Using WAMR builtin implementation for stringref")
@@ -559,6 +660,10 @@ if (WAMR_BUILD_GLOBAL_HEAP_POOL EQUAL 1)
   add_definitions(-DWASM_ENABLE_GLOBAL_HEAP_POOL=1)
   message ("     Global heap pool enabled")
 endif ()
+if (WAMR_BUILD_ALLOC_THREAD_CACHE EQUAL 1)
+  add_definitions (-DWASM_ENABLE_ALLOC_THREAD_CACHE=1)
+  message ("     Thread caches of global heap pool enabled")
+endif ()
 if (WAMR_BUILD_GLOBAL_HEAP_SIZE GREATER 0)
   add_definitions (-DWASM_GLOBAL_HEAP_SIZE=${WAMR_BUILD_GLOBAL_HEAP_SIZE})
   message ("     Custom global heap size: " ${WAMR_BUILD_GLOBAL_HEAP_SIZE})
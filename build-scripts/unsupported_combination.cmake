@@ -98,5 +98,18 @@ endif()
 
 if(WAMR_BUILD_SIMD EQUAL 1)
   check_classic_interp_error("Unsupported build configuration: SIMD + CLASSIC_INTERP")
-  check_fast_jit_error("Unsupported build configuration: SIMD + FAST_JIT")
+endif()
+
+# The AArch64 Fast JIT codegen doesn't lower the V128, atomic and
+# multi-tier (LLVM JIT) call insns yet
+if(WAMR_BUILD_TARGET MATCHES "AARCH64.*")
+  if(WAMR_BUILD_SIMD EQUAL 1)
+    check_fast_jit_error("Unsupported build configuration: SIMD + FAST_JIT on AARCH64")
+  endif()
+  if(WAMR_BUILD_SHARED_MEMORY EQUAL 1)
+    check_fast_jit_error("Unsupported build configuration: SHARED_MEMORY + FAST_JIT on AARCH64")
+  endif()
+  if(WAMR_BUILD_JIT EQUAL 1)
+    check_fast_jit_error("Unsupported build configuration: JIT + FAST_JIT on AARCH64")
+  endif()
 endif()
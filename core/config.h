@@ -133,6 +133,11 @@
 #define FAST_JIT_DEFAULT_CODE_CACHE_SIZE 10 * 1024 * 1024
 #endif
 
+/* Default optimization level of Fast JIT, 0 to 2 */
+#ifndef FAST_JIT_DEFAULT_OPT_LEVEL
+#define FAST_JIT_DEFAULT_OPT_LEVEL 0
+#endif
+
 #ifndef WASM_ENABLE_WAMR_COMPILER
 #define WASM_ENABLE_WAMR_COMPILER 0
 #endif
@@ -294,6 +299,29 @@
 #define WASM_DEBUG_PREPROCESSOR 0
 #endif
 
+/* Enable the superinstructions of fast interpreter or not, which fuse
+   the frequent opcode sequences into one opcode when pre-compiling */
+#ifndef WASM_ENABLE_SUPERINSTRUCTIONS
+#define WASM_ENABLE_SUPERINSTRUCTIONS 0
+#endif
+
+#if WASM_ENABLE_FAST_INTERP == 0
+#undef WASM_ENABLE_SUPERINSTRUCTIONS
+#define WASM_ENABLE_SUPERINSTRUCTIONS 0
+#endif
+
+/* Enable the code cache of fast interpreter or not, which saves the
+   pre-compiled code of the modules to files and loads it from them
+   instead of pre-compiling the code again */
+#ifndef WASM_ENABLE_FAST_INTERP_CACHE
+#define WASM_ENABLE_FAST_INTERP_CACHE 0
+#endif
+
+#if WASM_ENABLE_FAST_INTERP == 0
+#undef WASM_ENABLE_FAST_INTERP_CACHE
+#define WASM_ENABLE_FAST_INTERP_CACHE 0
+#endif
+
 /* Enable opcode counter or not */
 #ifndef WASM_ENABLE_OPCODE_COUNTER
 #define WASM_ENABLE_OPCODE_COUNTER 0
@@ -337,6 +365,26 @@ unless used elsewhere */
 #define WASM_ENABLE_GC_PERF_PROFILING 0
 #endif
 
+/* Incremental marking of GC heap */
+#ifndef WASM_ENABLE_GC_INCREMENTAL
+#define WASM_ENABLE_GC_INCREMENTAL 0
+#endif
+
+/* Parallel marking of GC heap */
+#ifndef WASM_ENABLE_GC_PARALLEL_MARKING
+#define WASM_ENABLE_GC_PARALLEL_MARKING 0
+#endif
+
+/* Compaction of GC heap */
+#ifndef WASM_ENABLE_GC_COMPACTION
+#define WASM_ENABLE_GC_COMPACTION 0
+#endif
+
+/* Bump pointer allocation of small GC objects */
+#ifndef WASM_ENABLE_GC_BUMP_ALLOC
+#define WASM_ENABLE_GC_BUMP_ALLOC 0
+#endif
+
 /* Memory profiling */
 #ifndef WASM_ENABLE_MEMORY_PROFILING
 #define WASM_ENABLE_MEMORY_PROFILING 0
@@ -382,6 +430,11 @@ unless used elsewhere */
 #define WASM_ENABLE_GLOBAL_HEAP_POOL 0
 #endif
 
+/* Per-thread caches of small chunks in the global heap pool */
+#ifndef WASM_ENABLE_ALLOC_THREAD_CACHE
+#define WASM_ENABLE_ALLOC_THREAD_CACHE 0
+#endif
+
 #ifndef WASM_ENABLE_SPEC_TEST
 #define WASM_ENABLE_SPEC_TEST 0
 #endif
@@ -720,6 +773,89 @@ unless used elsewhere */
 #define WASM_ENABLE_SHARED_HEAP 0
 #endif
 
+/* Save the state of module instances to snapshot files and restore
+   new instances from them */
+#ifndef WASM_ENABLE_INSTANCE_SNAPSHOT
+#define WASM_ENABLE_INSTANCE_SNAPSHOT 0
+#endif
+
+/* Reset module instances to a saved state so that they can be reused
+   instead of being instantiated again */
+#ifndef WASM_ENABLE_INSTANCE_RESET
+#define WASM_ENABLE_INSTANCE_RESET 0
+#endif
+
+/* Map the data segments of the default memory from an image prepared
+   by the loader instead of copying them on instantiation */
+#ifndef WASM_ENABLE_MEMORY_IMAGE
+#define WASM_ENABLE_MEMORY_IMAGE 0
+#endif
+
+/* The minimal total size of the data segments to build a memory image */
+#ifndef WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+#define WASM_MEMORY_IMAGE_MIN_DATA_SIZE (64 * 1024)
+#endif
+
+/* Map linear memories without reserving swap space for them, so that
+   only the pages touched consume memory */
+#ifndef WASM_ENABLE_LAZY_LINEAR_MEMORY
+#define WASM_ENABLE_LAZY_LINEAR_MEMORY 0
+#endif
+
+/* Validate and pre-compile the function bodies on their first calls
+   instead of at load time for the modules loaded with
+   LoadArgs::lazy_validation set */
+#ifndef WASM_ENABLE_LAZY_VALIDATION
+#define WASM_ENABLE_LAZY_VALIDATION 0
+#endif
+
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_FAST_JIT != 0                  \
+    || WASM_ENABLE_WAMR_COMPILER != 0 || WASM_ENABLE_DEBUG_INTERP != 0 \
+    || WASM_ENABLE_MINI_LOADER != 0
+#undef WASM_ENABLE_LAZY_VALIDATION
+#define WASM_ENABLE_LAZY_VALIDATION 0
+#endif
+
+/* Validate and pre-compile the function bodies of a module with several
+   threads when it is loaded */
+#ifndef WASM_ENABLE_PARALLEL_LOADER
+#define WASM_ENABLE_PARALLEL_LOADER 0
+#endif
+
+#if WASM_ENABLE_GC != 0 || WASM_ENABLE_DEBUG_INTERP != 0 \
+    || WASM_ENABLE_MINI_LOADER != 0
+#undef WASM_ENABLE_PARALLEL_LOADER
+#define WASM_ENABLE_PARALLEL_LOADER 0
+#endif
+
+#ifndef WASM_PARALLEL_LOADER_THREAD_NUM
+/* The default number of threads that load the function bodies, including
+   the loading thread, used if RuntimeInitArgs::loader_thread_num is 0 */
+#define WASM_PARALLEL_LOADER_THREAD_NUM 4
+#endif
+
+#if WASM_PARALLEL_LOADER_THREAD_NUM < 1
+#error "WASM_PARALLEL_LOADER_THREAD_NUM must be greater than 0"
+#endif
+
+#ifndef WASM_PARALLEL_LOADER_MIN_CODE_SIZE
+/* The code section is loaded by the loading thread only if it is smaller
+   than this, as creating the threads costs more than it saves */
+#define WASM_PARALLEL_LOADER_MIN_CODE_SIZE (64 * 1024)
+#endif
+
+/* Load the wasm modules from byte streams fed one chunk after another,
+   see wasm_runtime_stream_load_begin */
+#ifndef WASM_ENABLE_STREAM_LOADER
+#define WASM_ENABLE_STREAM_LOADER 0
+#endif
+
+#if WASM_ENABLE_INTERP == 0 || WASM_ENABLE_GC != 0 \
+    || WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_MINI_LOADER != 0
+#undef WASM_ENABLE_STREAM_LOADER
+#define WASM_ENABLE_STREAM_LOADER 0
+#endif
+
 #ifndef WASM_ENABLE_SHRUNK_MEMORY
 #define WASM_ENABLE_SHRUNK_MEMORY 1
 #endif
@@ -6,6 +6,7 @@
 #include "aot_runtime.h"
 #include "aot_reloc.h"
 #include "bh_platform.h"
+#include "bh_atomic.h"
 #include "../common/wasm_runtime_common.h"
 #include "../common/wasm_native.h"
 #include "../common/wasm_loader_common.h"
@@ -23,6 +24,10 @@
 #include "aot_perf_map.h"
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+#include "../common/wasm_memory.h"
+#endif
+
 #define YMM_PLT_PREFIX "__ymm@"
 #define XMM_PLT_PREFIX "__xmm@"
 #define REAL_PLT_PREFIX "__real@"
@@ -338,6 +343,31 @@ loader_mmap(uint32 size, bool prot_exec, char *error_buf, uint32 error_buf_size)
     return mem;
 }
 
+#ifdef OS_ENABLE_FILE_MAPPING
+static void *
+loader_mmap_file(uint32 size, os_file_handle file, uint64 offset,
+                 char *error_buf, uint32 error_buf_size)
+{
+    int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
+    void *mem;
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+    /* Keep the mapped code in range 0 to 2G like loader_mmap() does */
+    if ((mem = os_mmap_file(NULL, size, map_prot, MMAP_MAP_32BIT, file,
+                            offset))) {
+        return mem;
+    }
+#endif
+
+    if (!(mem = os_mmap_file(NULL, size, map_prot, MMAP_MAP_NONE, file,
+                             offset))) {
+        set_error_buf(error_buf, error_buf_size, "map file failed");
+        return NULL;
+    }
+    return mem;
+}
+#endif /* end of OS_ENABLE_FILE_MAPPING */
+
 static char *
 load_string(uint8 **p_buf, const uint8 *buf_end, AOTModule *module,
             bool is_load_from_file_buf,
@@ -514,6 +544,16 @@ check_feature_flags(char *error_buf, uint32 error_buf_size,
     }
 #endif
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if ((feature_flags & WASM_FEATURE_GARBAGE_COLLECTION)
+        && !(feature_flags & WASM_FEATURE_GC_WRITE_BARRIER)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "incremental GC is enabled in this build, the AOT file "
+                      "must be compiled with --enable-gc-write-barrier");
+        return false;
+    }
+#endif
+
     return true;
 }
 
@@ -3180,6 +3220,339 @@ is_text_section(const char *section_name)
     return !strcmp(section_name, ".text") || !strcmp(section_name, ".ltext");
 }
 
+#ifdef AOT_LAZY_TEXT_RELOCATION
+typedef struct AOTLazyRelocation {
+    uint64 offset;
+    int64 addend;
+    void *symbol_addr;
+    uint32 type;
+    int32 symbol_index;
+} AOTLazyRelocation;
+
+/* The states of a text page whose relocations are deferred, a page
+   is patched by the thread which changes it from pending to patching */
+enum {
+    LAZY_PAGE_READY = 0,
+    LAZY_PAGE_PENDING,
+    LAZY_PAGE_PATCHING,
+};
+
+/* A module whose text relocations are deferred, which is looked up by
+   the signal handler without taking any lock: the range is published by
+   setting the state to active after the other fields are set, and the
+   slot is released before the module is destroyed, which doesn't race
+   with the handler since the code of a module being unloaded can't be
+   running */
+typedef struct AOTLazyTextSlot {
+    bh_atomic_32_t state;
+    uint8 *text_start;
+    uint8 *text_end;
+    AOTModule *module;
+} AOTLazyTextSlot;
+
+enum {
+    LAZY_SLOT_FREE = 0,
+    LAZY_SLOT_RESERVED,
+    LAZY_SLOT_ACTIVE,
+};
+
+/* The text relocations of the modules loaded when all the slots are
+   used are applied when they are loaded */
+#define LAZY_TEXT_SLOT_NUM 64
+
+typedef struct AOTLazyText {
+    /* the slot to look up the module, NULL if it isn't registered */
+    AOTLazyTextSlot *slot;
+    /* relocations sorted by the page where they are, the ones spanning
+       two pages are applied when the module is loaded */
+    AOTLazyRelocation *relocations;
+    uint32 relocation_count;
+    uint32 relocation_capacity;
+    /* the index of the first relocation of each page, with an extra
+       element for the end */
+    uint32 *page_relocation_index;
+    /* the LAZY_PAGE_XXX state of each page */
+    bh_atomic_32_t *page_state;
+    uint32 page_count;
+} AOTLazyText;
+
+/* The largest size patched by a relocation */
+#define LAZY_RELOCATION_MAX_SIZE 8
+
+static AOTLazyTextSlot lazy_text_slots[LAZY_TEXT_SLOT_NUM];
+static os_thread_local_attribute void *lazy_text_last_fault_addr = NULL;
+
+static AOTLazyTextSlot *
+reserve_lazy_text_slot(void)
+{
+    uint32 i, state;
+
+    for (i = 0; i < LAZY_TEXT_SLOT_NUM; i++) {
+        state = LAZY_SLOT_FREE;
+        if (BH_ATOMIC_32_COMPARE_EXCHANGE(lazy_text_slots[i].state, state,
+                                          LAZY_SLOT_RESERVED))
+            return &lazy_text_slots[i];
+    }
+    return NULL;
+}
+
+static void
+destroy_lazy_text(AOTModule *module)
+{
+    AOTLazyText *lazy_text = module->lazy_text;
+
+    if (lazy_text->slot)
+        BH_ATOMIC_32_STORE(lazy_text->slot->state, LAZY_SLOT_FREE);
+
+    if (lazy_text->relocations)
+        wasm_runtime_free(lazy_text->relocations);
+    if (lazy_text->page_relocation_index)
+        wasm_runtime_free(lazy_text->page_relocation_index);
+    if (lazy_text->page_state)
+        wasm_runtime_free(lazy_text->page_state);
+    wasm_runtime_free(lazy_text);
+    module->lazy_text = NULL;
+}
+
+static bool
+reserve_lazy_relocations(AOTLazyText *lazy_text, uint32 count,
+                         char *error_buf, uint32 error_buf_size)
+{
+    AOTLazyRelocation *relocations;
+    uint64 capacity = (uint64)lazy_text->relocation_count + count;
+
+    if (capacity <= lazy_text->relocation_capacity)
+        return true;
+
+    if (capacity >= UINT32_MAX
+        || !(relocations = loader_malloc(sizeof(AOTLazyRelocation) * capacity,
+                                         error_buf, error_buf_size)))
+        return false;
+
+    if (lazy_text->relocations) {
+        bh_memcpy_s(relocations,
+                    (uint32)(sizeof(AOTLazyRelocation) * capacity),
+                    lazy_text->relocations,
+                    (uint32)(sizeof(AOTLazyRelocation)
+                             * lazy_text->relocation_count));
+        wasm_runtime_free(lazy_text->relocations);
+    }
+    lazy_text->relocations = relocations;
+    lazy_text->relocation_capacity = (uint32)capacity;
+    return true;
+}
+
+static uint32
+get_lazy_text_page(const AOTModule *module, uint64 offset)
+{
+    uint8 *addr = (uint8 *)module->code + offset;
+    return (uint32)((uint64)(addr - module->mapped_text)
+                    / (uint64)os_getpagesize());
+}
+
+static bool
+apply_lazy_relocation(AOTModule *module, const AOTLazyRelocation *relocation,
+                      char *error_buf, uint32 error_buf_size)
+{
+    return apply_relocation(module, module->code, module->code_size,
+                            relocation->offset, relocation->addend,
+                            relocation->type, relocation->symbol_addr,
+                            relocation->symbol_index, error_buf,
+                            error_buf_size);
+}
+
+/* Apply the relocations which span two pages and, if no slot is left to
+   register the module, all the others, sort the remaining ones by page,
+   make the pages which don't need to be patched executable and the others
+   inaccessible until they are accessed for the first time */
+static bool
+init_lazy_text_pages(AOTModule *module, char *error_buf,
+                     uint32 error_buf_size)
+{
+    AOTLazyText *lazy_text = module->lazy_text;
+    AOTLazyRelocation *relocations = NULL;
+    AOTLazyTextSlot *slot;
+    uint32 page_size = os_getpagesize();
+    uint32 page_count, i, j, first, last, eager_count = 0;
+    uint32 *page_relocation_index;
+    uint64 size;
+
+    page_count = (module->mapped_text_size + page_size - 1) / page_size;
+    lazy_text->page_count = page_count;
+
+    size = sizeof(uint32) * ((uint64)page_count + 1);
+    if (!(page_relocation_index =
+              loader_malloc(size, error_buf, error_buf_size)))
+        return false;
+    lazy_text->page_relocation_index = page_relocation_index;
+
+    if (!(lazy_text->page_state =
+              loader_malloc(sizeof(bh_atomic_32_t) * (uint64)page_count,
+                            error_buf, error_buf_size)))
+        return false;
+
+    if (!(slot = reserve_lazy_text_slot()))
+        LOG_VERBOSE("Too many modules with deferred text relocations, "
+                    "apply the relocations now.\n");
+
+    /* The text is still writable */
+    for (i = 0, j = 0; i < lazy_text->relocation_count; i++) {
+        first = get_lazy_text_page(module, lazy_text->relocations[i].offset);
+        last = get_lazy_text_page(module, lazy_text->relocations[i].offset
+                                              + LAZY_RELOCATION_MAX_SIZE - 1);
+        if (!slot || first != last) {
+            if (!apply_lazy_relocation(module, &lazy_text->relocations[i],
+                                       error_buf, error_buf_size))
+                goto fail;
+            eager_count++;
+        }
+        else {
+            lazy_text->relocations[j++] = lazy_text->relocations[i];
+        }
+    }
+    lazy_text->relocation_count = j;
+
+    if (lazy_text->relocation_count > 0) {
+        size = sizeof(AOTLazyRelocation) * (uint64)lazy_text->relocation_count;
+        if (!(relocations = loader_malloc(size, error_buf, error_buf_size)))
+            goto fail;
+    }
+
+    /* Counting sort by the page where the relocations are */
+    for (i = 0; i < lazy_text->relocation_count; i++)
+        page_relocation_index[get_lazy_text_page(
+                                  module, lazy_text->relocations[i].offset)
+                              + 1]++;
+    for (i = 0; i < page_count; i++)
+        page_relocation_index[i + 1] += page_relocation_index[i];
+    for (i = 0; i < lazy_text->relocation_count; i++) {
+        j = get_lazy_text_page(module, lazy_text->relocations[i].offset);
+        relocations[page_relocation_index[j]++] = lazy_text->relocations[i];
+    }
+    for (i = page_count; i > 0; i--)
+        page_relocation_index[i] = page_relocation_index[i - 1];
+    page_relocation_index[0] = 0;
+
+    if (lazy_text->relocations)
+        wasm_runtime_free(lazy_text->relocations);
+    lazy_text->relocations = relocations;
+    lazy_text->relocation_capacity = lazy_text->relocation_count;
+
+    for (i = 0; i < page_count; i++)
+        lazy_text->page_state[i] =
+            page_relocation_index[i + 1] > page_relocation_index[i]
+                ? LAZY_PAGE_PENDING
+                : LAZY_PAGE_READY;
+
+    /* The plt table may have been written */
+    os_icache_flush(module->mapped_text, module->mapped_text_size);
+
+    for (i = 0; i < page_count; i = j) {
+        bool ready = lazy_text->page_state[i] == LAZY_PAGE_READY;
+
+        for (j = i + 1; j < page_count
+                        && (lazy_text->page_state[j] == LAZY_PAGE_READY)
+                               == ready;
+             j++)
+            ;
+        os_mprotect(module->mapped_text + (uint64)page_size * i,
+                    (uint64)page_size * (j - i),
+                    ready ? MMAP_PROT_READ | MMAP_PROT_EXEC : MMAP_PROT_NONE);
+    }
+
+    if (slot) {
+        slot->text_start = module->mapped_text;
+        slot->text_end = module->mapped_text + module->mapped_text_size;
+        slot->module = module;
+        lazy_text->slot = slot;
+        BH_ATOMIC_32_STORE(slot->state, LAZY_SLOT_ACTIVE);
+    }
+
+    LOG_VERBOSE("Defer %u text relocations to their first accessed pages, "
+                "apply %u now.\n",
+                lazy_text->relocation_count, eager_count);
+    return true;
+
+fail:
+    if (slot)
+        BH_ATOMIC_32_STORE(slot->state, LAZY_SLOT_FREE);
+    return false;
+}
+
+/* Called by the signal handler with the page in the patching state, so
+   no lock is taken and nothing is logged, a relocation which fails to
+   be applied leaves the access to be handled as a crash */
+static bool
+apply_lazy_text_page(AOTModule *module, uint32 page)
+{
+    AOTLazyText *lazy_text = module->lazy_text;
+    uint32 page_size = os_getpagesize();
+    uint8 *page_start = module->mapped_text + (uint64)page_size * page;
+    uint32 i = lazy_text->page_relocation_index[page];
+    uint32 end = lazy_text->page_relocation_index[page + 1];
+    char error_buf[128];
+
+    os_mprotect(page_start, page_size, MMAP_PROT_READ | MMAP_PROT_WRITE);
+
+    for (; i < end; i++) {
+        if (!apply_lazy_relocation(module, lazy_text->relocations + i,
+                                   error_buf, sizeof(error_buf))) {
+            /* Leave the page inaccessible, the access faults again and
+               is handled as a crash */
+            os_mprotect(page_start, page_size, MMAP_PROT_NONE);
+            BH_ATOMIC_32_STORE(lazy_text->page_state[page], LAZY_PAGE_READY);
+            return false;
+        }
+    }
+
+    os_icache_flush(page_start, page_size);
+    os_mprotect(page_start, page_size, MMAP_PROT_READ | MMAP_PROT_EXEC);
+    BH_ATOMIC_32_STORE(lazy_text->page_state[page], LAZY_PAGE_READY);
+    return true;
+}
+
+bool
+aot_apply_lazy_text_relocations(void *addr)
+{
+    AOTLazyTextSlot *slot;
+    AOTLazyText *lazy_text;
+    uint32 i, page, state;
+
+    for (i = 0; i < LAZY_TEXT_SLOT_NUM; i++) {
+        slot = &lazy_text_slots[i];
+        if (BH_ATOMIC_32_LOAD(slot->state) != LAZY_SLOT_ACTIVE
+            || (uint8 *)addr < slot->text_start
+            || (uint8 *)addr >= slot->text_end)
+            continue;
+
+        lazy_text = slot->module->lazy_text;
+        page = (uint32)((uint64)((uint8 *)addr - slot->text_start)
+                        / (uint64)os_getpagesize());
+        state = LAZY_PAGE_PENDING;
+        if (BH_ATOMIC_32_COMPARE_EXCHANGE(lazy_text->page_state[page], state,
+                                          LAZY_PAGE_PATCHING)) {
+            lazy_text_last_fault_addr = NULL;
+            return apply_lazy_text_page(slot->module, page);
+        }
+        if (state == LAZY_PAGE_PATCHING) {
+            /* Another thread is patching the page, restart the access
+               until it is done */
+            lazy_text_last_fault_addr = NULL;
+            return true;
+        }
+        /* The page may have been patched by another thread after the
+           access faulted, restart the access unless it faults again */
+        if (lazy_text_last_fault_addr == addr) {
+            lazy_text_last_fault_addr = NULL;
+            return false;
+        }
+        lazy_text_last_fault_addr = addr;
+        return true;
+    }
+    return false;
+}
+#endif /* end of AOT_LAZY_TEXT_RELOCATION */
+
 static bool
 do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
                    char *error_buf, uint32 error_buf_size)
@@ -3203,6 +3576,14 @@ do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
         return false;
     }
 
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    if (module->lazy_text && !is_literal
+        && !reserve_lazy_relocations(module->lazy_text,
+                                     group->relocation_count, error_buf,
+                                     error_buf_size))
+        return false;
+#endif
+
     for (i = 0; i < group->relocation_count; i++, relocation++) {
         int32 symbol_index = -1;
         symbol_len = (uint32)strlen(relocation->symbol_name);
@@ -3396,6 +3777,26 @@ do_text_relocation(AOTModule *module, AOTRelocationGroup *group,
         if (symbol != symbol_buf)
             wasm_runtime_free(symbol);
 
+#ifdef AOT_LAZY_TEXT_RELOCATION
+        if (module->lazy_text && !is_literal) {
+            AOTLazyText *lazy_text = module->lazy_text;
+            AOTLazyRelocation *lazy_relocation =
+                lazy_text->relocations + lazy_text->relocation_count++;
+
+            if (relocation->relocation_offset >= aot_text_size) {
+                set_error_buf(error_buf, error_buf_size,
+                              "invalid relocation offset");
+                return false;
+            }
+            lazy_relocation->offset = relocation->relocation_offset;
+            lazy_relocation->addend = (int64)relocation->relocation_addend;
+            lazy_relocation->type = relocation->relocation_type;
+            lazy_relocation->symbol_addr = symbol_addr;
+            lazy_relocation->symbol_index = symbol_index;
+            continue;
+        }
+#endif
+
         if (!apply_relocation(
                 module, aot_text, aot_text_size, relocation->relocation_offset,
                 relocation->relocation_addend, relocation->relocation_type,
@@ -3923,7 +4324,19 @@ load_relocation_section(const uint8 *buf, const uint8 *buf_end,
     /* Set read only for AOT code and some data sections */
     map_prot = MMAP_PROT_READ | MMAP_PROT_EXEC;
 
-    if (module->code) {
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    if (module->lazy_text) {
+        if (!init_lazy_text_pages(module, error_buf, error_buf_size))
+            goto fail;
+    }
+    else
+#endif
+    if (module->mapped_text) {
+        /* The pages which were not patched are still shared with the
+           page cache of the AOT file */
+        os_mprotect(module->mapped_text, module->mapped_text_size, map_prot);
+    }
+    else if (module->code) {
         /* The layout is: literal size + literal + code (with plt table) */
         uint8 *mmap_addr = module->literal - sizeof(uint32);
         uint32 total_size =
@@ -3986,6 +4399,79 @@ has_module_memory64(AOTModule *module)
 }
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Write the active memory init data into a memory image when it is
+   large enough to be worth mapping */
+static void
+create_memory_image(AOTModule *module)
+{
+    AOTMemory *memory;
+    AOTMemInitData *data_seg;
+    WASMMemoryImage *image;
+    uint64 memory_size, base_offset, data_end = 0, data_size = 0;
+    uint8 offset_type;
+    uint32 i;
+
+    /* Imported and shared memories are initialized by other instances */
+    if (module->import_memory_count > 0 || module->memory_count == 0
+        || (module->memories[0].flags & SHARED_MEMORY_FLAG))
+        return;
+
+    memory = &module->memories[0];
+    memory_size = (uint64)memory->num_bytes_per_page * memory->init_page_count;
+    offset_type = (memory->flags & MEMORY64_FLAG) ? INIT_EXPR_TYPE_I64_CONST
+                                                  : INIT_EXPR_TYPE_I32_CONST;
+
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+
+        /* The offsets of the segments must be known before instantiation,
+           and the out of bounds segments are reported by instantiation */
+        if (data_seg->offset.init_expr_type != offset_type)
+            return;
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->offset.u.unary.v.i64
+                          : (uint32)data_seg->offset.u.unary.v.i32;
+        if (base_offset > memory_size
+            || data_seg->byte_count > memory_size - base_offset)
+            return;
+
+        if (base_offset + data_seg->byte_count > data_end)
+            data_end = base_offset + data_seg->byte_count;
+        data_size += data_seg->byte_count;
+    }
+
+    if (data_size < WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+        || !(image = wasm_memory_image_create(data_end)))
+        return;
+
+    /* Later segments overwrite the earlier ones like on instantiation */
+    for (i = 0; i < module->mem_init_data_count; i++) {
+        data_seg = module->mem_init_data_list[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->offset.u.unary.v.i64
+                          : (uint32)data_seg->offset.u.unary.v.i32;
+        if (!wasm_memory_image_write(image, base_offset, data_seg->bytes,
+                                     data_seg->byte_count)) {
+            LOG_WARNING("write memory image failed");
+            wasm_memory_image_destroy(image);
+            return;
+        }
+    }
+
+    module->memory_image = image;
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
+
 static bool
 load_from_sections(AOTModule *module, AOTSection *sections,
                    bool is_load_from_file_buf, bool no_resolve, char *error_buf,
@@ -4030,9 +4516,11 @@ load_from_sections(AOTModule *module, AOTSection *sections,
                 /* try to merge .data and .text, with exceptions:
                  * 1. XIP mode
                  * 2. pre-mmapped module load from aot_load_from_sections()
-                 * 3. nuttx & esp-idf: have separate region for MMAP_PROT_EXEC
+                 * 3. text section mapped from the AOT file in place
+                 * 4. nuttx & esp-idf: have separate region for MMAP_PROT_EXEC
                  */
-                if (!module->is_indirect_mode && is_load_from_file_buf)
+                if (!module->is_indirect_mode && is_load_from_file_buf
+                    && !module->mapped_text)
                     if (!try_merge_data_and_text(&buf, &buf_end, module,
                                                  error_buf, error_buf_size))
                         LOG_WARNING("merge .data and .text sections failed");
@@ -4172,6 +4660,10 @@ load_from_sections(AOTModule *module, AOTSection *sections,
         }
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    create_memory_image(module);
+#endif
+
     /* Flush data cache before executing AOT code,
      * otherwise unpredictable behavior can occur. */
     os_dcache_flush();
@@ -4313,10 +4805,67 @@ fail:
     return false;
 }
 
+#ifdef OS_ENABLE_FILE_MAPPING
+/* Map the text section from the AOT file privately instead of copying
+   it, so that the pages untouched by the relocations stay shared with
+   the page cache of the file and with other processes loading it */
+static bool
+map_text_section(AOTModule *module, os_file_handle file, AOTSection *section,
+                 char *error_buf, uint32 error_buf_size)
+{
+    uint64 page_size = (uint64)os_getpagesize();
+    uint64 offset = (uint64)(section->section_body - module->mapped_file);
+    uint64 map_offset = offset & ~(page_size - 1);
+    uint64 text_size = section->section_body_size;
+    uint64 map_size;
+    uint8 *mapped_text;
+
+    if (!module->is_indirect_mode) {
+        text_size += aot_get_plt_table_size();
+        text_size = (text_size + 3) & ~((uint64)3);
+    }
+    map_size = offset - map_offset + text_size;
+
+    /* The plt table is written after the text section, which overlaps
+       the following sections in the mapping and must not go past the
+       last page of the file, copy the text section instead */
+    if (map_offset + map_size
+        > align_uint64(module->mapped_file_size, page_size)) {
+        LOG_VERBOSE("Text section can't be mapped from the AOT file, "
+                    "copy it instead.\n");
+        return true;
+    }
+
+    if (map_size >= UINT32_MAX
+        || !(mapped_text = loader_mmap_file((uint32)map_size, file,
+                                            map_offset, error_buf,
+                                            error_buf_size))) {
+        return false;
+    }
+
+    module->mapped_text = mapped_text;
+    module->mapped_text_size = (uint32)map_size;
+
+#if defined(AOT_LAZY_TEXT_RELOCATION) && WASM_ENABLE_DEBUG_AOT == 0
+    if (!(module->lazy_text = loader_malloc(sizeof(AOTLazyText), error_buf,
+                                            error_buf_size)))
+        return false;
+#endif
+
+    section->section_body = mapped_text + (offset - map_offset);
+    if (text_size > section->section_body_size) {
+        memset((uint8 *)section->section_body + section->section_body_size, 0,
+               (uint32)text_size - section->section_body_size);
+        section->section_body_size = (uint32)text_size;
+    }
+    return true;
+}
+#endif /* end of OS_ENABLE_FILE_MAPPING */
+
 static bool
 create_sections(AOTModule *module, const uint8 *buf, uint32 size,
-                AOTSection **p_section_list, char *error_buf,
-                uint32 error_buf_size)
+                os_file_handle file, AOTSection **p_section_list,
+                char *error_buf, uint32 error_buf_size)
 {
     AOTSection *section_list = NULL, *section_list_end = NULL, *section;
     const uint8 *p = buf, *p_end = buf + size;
@@ -4356,7 +4905,16 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
             section->section_body_size = section_size;
 
             if (section_type == AOT_SECTION_TYPE_TEXT) {
-                if ((section_size > 0) && !module->is_indirect_mode) {
+#ifdef OS_ENABLE_FILE_MAPPING
+                if ((section_size > 0) && module->mapped_file
+                    && !map_text_section(module, file, section, error_buf,
+                                         error_buf_size)) {
+                    wasm_runtime_free(section);
+                    goto fail;
+                }
+#endif
+                if ((section_size > 0) && !module->is_indirect_mode
+                    && !module->mapped_text) {
                     total_size =
                         (uint64)section_size + aot_get_plt_table_size();
                     total_size = (total_size + 3) & ~((uint64)3);
@@ -4410,6 +4968,7 @@ create_sections(AOTModule *module, const uint8 *buf, uint32 size,
     }
 
     *p_section_list = section_list;
+    (void)file;
     return true;
 fail:
     if (section_list)
@@ -4429,8 +4988,8 @@ aot_compatible_version(uint32 version)
 
 static bool
 load(const uint8 *buf, uint32 size, AOTModule *module,
-     bool wasm_binary_freeable, bool no_resolve, char *error_buf,
-     uint32 error_buf_size)
+     bool wasm_binary_freeable, bool no_resolve, os_file_handle file,
+     char *error_buf, uint32 error_buf_size)
 {
     const uint8 *buf_end = buf + size;
     const uint8 *p = buf, *p_end = buf_end;
@@ -4452,7 +5011,7 @@ load(const uint8 *buf, uint32 size, AOTModule *module,
 
     module->package_version = version;
 
-    if (!create_sections(module, buf, size, &section_list, error_buf,
+    if (!create_sections(module, buf, size, file, &section_list, error_buf,
                          error_buf_size))
         return false;
 
@@ -4464,6 +5023,7 @@ load(const uint8 *buf, uint32 size, AOTModule *module,
         destroy_sections(section_list,
                          module->is_indirect_mode
                                  || module->merged_data_text_sections
+                                 || module->mapped_text
                              ? false
                              : true);
         /* aot_unload() won't destroy aot text again */
@@ -4506,7 +5066,7 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
 
     os_thread_jit_write_protect_np(false); /* Make memory writable */
     if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
-              error_buf, error_buf_size)) {
+              os_get_invalid_handle(), error_buf, error_buf_size)) {
         aot_unload(module);
         return NULL;
     }
@@ -4524,6 +5084,76 @@ aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
     return module;
 }
 
+#ifdef OS_ENABLE_FILE_MAPPING
+AOTModule *
+aot_load_from_mapped_file(const char *file_path, const LoadArgs *args,
+                          char *error_buf, uint32 error_buf_size)
+{
+    AOTModule *module;
+    os_file_handle file;
+    uint64 file_size = 0;
+    uint8 *mapped_file;
+    bool ret;
+
+    file = os_file_open_for_mapping(file_path, &file_size);
+    if (file == os_get_invalid_handle()) {
+        set_error_buf_v(error_buf, error_buf_size, "open file %s failed",
+                        file_path);
+        return NULL;
+    }
+
+    if (file_size == 0 || file_size >= UINT32_MAX) {
+        set_error_buf(error_buf, error_buf_size, "invalid file size");
+        os_file_close_for_mapping(file);
+        return NULL;
+    }
+
+    /* The loader doesn't write the file buffer, and the strings and the
+       data segments are referred to in the mapping after loading */
+    if (!(mapped_file = os_mmap_file(NULL, (size_t)file_size,
+                                     MMAP_PROT_READ,
+                                     MMAP_MAP_NONE, file, 0))) {
+        set_error_buf(error_buf, error_buf_size, "map file failed");
+        os_file_close_for_mapping(file);
+        return NULL;
+    }
+
+    if (!(module = create_module(args->name, error_buf, error_buf_size))) {
+        os_munmap(mapped_file, (size_t)file_size);
+        os_file_close_for_mapping(file);
+        return NULL;
+    }
+
+    module->mapped_file = mapped_file;
+    module->mapped_file_size = file_size;
+
+    os_thread_jit_write_protect_np(false); /* Make memory writable */
+    ret = load(mapped_file, (uint32)file_size, module, false, args->no_resolve,
+               file, error_buf, error_buf_size);
+    /* The mappings remain valid after the file is closed */
+    os_file_close_for_mapping(file);
+    if (!ret) {
+        aot_unload(module);
+        return NULL;
+    }
+    os_thread_jit_write_protect_np(true); /* Make memory executable */
+    /* The code pages whose relocations are deferred are inaccessible,
+       they are flushed when they are patched */
+    if (!module->lazy_text)
+        os_icache_flush(module->code, module->code_size);
+
+#if WASM_ENABLE_AOT_VALIDATOR != 0
+    if (!aot_module_validate(module, error_buf, error_buf_size)) {
+        aot_unload(module);
+        return NULL;
+    }
+#endif /* WASM_ENABLE_AOT_VALIDATOR != 0 */
+
+    LOG_VERBOSE("Load module from mapped file success.\n");
+    return module;
+}
+#endif /* end of OS_ENABLE_FILE_MAPPING */
+
 void
 aot_unload(AOTModule *module)
 {
@@ -4537,6 +5167,11 @@ aot_unload(AOTModule *module)
         destroy_mem_init_data_list(module, module->mem_init_data_list,
                                    module->mem_init_data_count);
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    if (module->memory_image)
+        wasm_memory_image_destroy(module->memory_image);
+#endif
+
     if (module->native_symbol_list)
         wasm_runtime_free(module->native_symbol_list);
 
@@ -4623,7 +5258,7 @@ aot_unload(AOTModule *module)
 #endif
 
     if (module->code && !module->is_indirect_mode
-        && !module->merged_data_text_sections) {
+        && !module->merged_data_text_sections && !module->mapped_text) {
         /* The layout is: literal size + literal + code (with plt table) */
         uint8 *mmap_addr = module->literal - sizeof(uint32);
         uint32 total_size =
@@ -4666,6 +5301,14 @@ aot_unload(AOTModule *module)
         os_munmap(module->merged_data_text_sections,
                   module->merged_data_text_sections_size);
 
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    if (module->lazy_text)
+        destroy_lazy_text(module);
+#endif
+
+    if (module->mapped_text)
+        os_munmap(module->mapped_text, module->mapped_text_size);
+
 #if WASM_ENABLE_DEBUG_AOT != 0
     jit_code_entry_destroy(module->elf_hdr);
 #endif
@@ -4716,6 +5359,10 @@ aot_unload(AOTModule *module)
 #endif
 #endif
 
+    /* The strings and data segments may refer to the mapped file */
+    if (module->mapped_file)
+        os_munmap(module->mapped_file, (size_t)module->mapped_file_size);
+
     wasm_runtime_free(module);
 }
 
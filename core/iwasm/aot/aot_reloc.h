@@ -154,6 +154,7 @@ typedef struct {
     REG_SYM(wasm_externref_obj_to_internal_obj), \
     REG_SYM(wasm_internal_obj_to_externref_obj), \
     REG_SYM(wasm_obj_is_type_of),          \
+    REG_SYM(wasm_obj_write_barrier),       \
     REG_SYM(wasm_struct_obj_new),
 #else
 #define REG_GC_SYM()
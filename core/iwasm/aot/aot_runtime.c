@@ -13,6 +13,12 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "../common/wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+#include "../common/wasm_instance_snapshot.h"
+#endif
+#if WASM_ENABLE_INSTANCE_RESET != 0
+#include "../common/wasm_instance_reset.h"
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "../libraries/thread-mgr/thread_manager.h"
 #endif
@@ -972,8 +978,8 @@ static AOTMemoryInstance *
 memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                    AOTModule *module, AOTMemoryInstance *memory_inst,
                    AOTMemory *memory, uint32 memory_idx, uint32 heap_size,
-                   uint32 max_memory_pages, char *error_buf,
-                   uint32 error_buf_size)
+                   uint32 max_memory_pages, bool *p_image_mapped,
+                   char *error_buf, uint32 error_buf_size)
 {
     void *heap_handle;
     uint32 num_bytes_per_page = memory->num_bytes_per_page;
@@ -1140,6 +1146,23 @@ memory_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     memory_inst->memory_data = p;
     memory_inst->memory_data_end = p + memory_data_size;
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* Map the memory init data before the app heap is initialized, as the
+       last page of the image may be shared with the app heap */
+    if (p_image_mapped && module->memory_image
+        && module->memory_image->size <= memory_data_size
+        && (heap_size == 0 || module->memory_image->data_end <= heap_offset)) {
+        if (!wasm_memory_image_map(memory_inst, module->memory_image)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "map memory image failed");
+            goto fail1;
+        }
+        *p_image_mapped = true;
+    }
+#else
+    (void)p_image_mapped;
+#endif
+
     /* Initialize heap info */
     memory_inst->heap_data = p + heap_offset;
     memory_inst->heap_data_end = p + heap_offset + heap_size;
@@ -1220,7 +1243,7 @@ aot_get_memory_with_idx(AOTModuleInstance *module_inst, uint32 mem_idx)
 static bool
 memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
                      AOTModule *module, uint32 heap_size,
-                     uint32 max_memory_pages, char *error_buf,
+                     uint32 max_memory_pages, bool init_data, char *error_buf,
                      uint32 error_buf_size)
 {
     uint32 global_index, global_data_offset, length;
@@ -1230,6 +1253,8 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     uint64 total_size;
     mem_offset_t base_offset;
     uint8 offset_flag;
+    /* Whether the memory init data is mapped from the memory image */
+    bool image_mapped = false;
 
     module_inst->memory_count = memory_count;
     total_size = sizeof(AOTMemoryInstance *) * (uint64)memory_count;
@@ -1242,7 +1267,9 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
     for (i = 0; i < memory_count; i++, memories++) {
         memory_inst = memory_instantiate(
             module_inst, parent, module, memories, &module->memories[i], i,
-            heap_size, max_memory_pages, error_buf, error_buf_size);
+            heap_size, max_memory_pages,
+            i == 0 && init_data && !parent ? &image_mapped : NULL, error_buf,
+            error_buf_size);
         if (!memory_inst) {
             return false;
         }
@@ -1252,8 +1279,10 @@ memories_instantiate(AOTModuleInstance *module_inst, AOTModuleInstance *parent,
 
     /* Get default memory instance */
     memory_inst = aot_get_default_memory(module_inst);
-    if (!memory_inst) {
-        /* Ignore setting memory init data if no memory inst is created */
+    if (!memory_inst || !init_data || image_mapped) {
+        /* Ignore setting memory init data if no memory inst is created,
+           or if the memory data is restored from the snapshot or mapped
+           from the memory image */
         return true;
     }
 
@@ -1916,6 +1945,11 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     const bool is_sub_inst = parent != NULL;
 #if WASM_ENABLE_MULTI_MODULE != 0
     bool ret = false;
+#endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    const WASMInstanceSnapshot *snapshot = is_sub_inst ? NULL : args->snapshot;
+#else
+    const void *snapshot = NULL;
 #endif
     uint32 stack_size = args->v1.default_stack_size;
     uint32 heap_size = args->v1.host_managed_heap_size;
@@ -2066,7 +2100,8 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
 
     /* Initialize memory space */
     if (!memories_instantiate(module_inst, parent, module, heap_size,
-                              max_memory_pages, error_buf, error_buf_size))
+                              max_memory_pages, !snapshot, error_buf,
+                              error_buf_size))
         goto fail;
 
     /* Initialize function pointers */
@@ -2298,11 +2333,23 @@ aot_instantiate(AOTModule *module, AOTModuleInstance *parent,
     }
 #endif
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
-                                            exec_env_main)) {
-        set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
-        goto fail;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* The snapshot holds the state after the post instantiation functions
+       were executed, don't execute them again */
+    if (snapshot) {
+        if (!wasm_instance_snapshot_restore(
+                (WASMModuleInstanceCommon *)module_inst, snapshot, error_buf,
+                error_buf_size))
+            goto fail;
     }
+    else
+#endif
+        if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
+                                                exec_env_main)) {
+            set_error_buf(error_buf, error_buf_size,
+                          module_inst->cur_exception);
+            goto fail;
+        }
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
     wasm_runtime_dump_module_inst_mem_consumption(
@@ -2428,6 +2475,9 @@ aot_deinstantiate(AOTModuleInstance *module_inst, bool is_sub_inst)
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap_delete(common->elem_dropped);
 #endif
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    wasm_instance_reset_destroy((WASMModuleInstanceCommon *)module_inst);
+#endif
 
     wasm_runtime_free(module_inst);
 }
@@ -5328,7 +5378,9 @@ aot_global_traverse_gc_rootset(AOTModuleInstance *module_inst, void *heap)
         if (wasm_is_type_reftype(import_global->type.val_type)) {
             gc_obj = GET_REF_FROM_ADDR((uint32 *)global_data);
             if (wasm_obj_is_created_from_heap(gc_obj)) {
-                if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                if (0
+                    != mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                   global_data))
                     return false;
             }
         }
@@ -5339,7 +5391,9 @@ aot_global_traverse_gc_rootset(AOTModuleInstance *module_inst, void *heap)
         if (wasm_is_type_reftype(global->type.val_type)) {
             gc_obj = GET_REF_FROM_ADDR((uint32 *)global_data);
             if (wasm_obj_is_created_from_heap(gc_obj)) {
-                if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                if (0
+                    != mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                   global_data))
                     return false;
             }
         }
@@ -5363,7 +5417,9 @@ aot_table_traverse_gc_rootset(WASMModuleInstance *module_inst, void *heap)
         for (j = 0; j < table->cur_size; j++) {
             gc_obj = table_elems[j];
             if (wasm_obj_is_created_from_heap(gc_obj)) {
-                if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                if (0
+                    != mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                   &table_elems[j]))
                     return false;
             }
         }
@@ -5381,7 +5437,7 @@ local_object_refs_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
     for (r = exec_env->cur_local_object_ref; r; r = r->prev) {
         gc_obj = r->val;
         if (wasm_obj_is_created_from_heap(gc_obj)) {
-            if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+            if (0 != mem_allocator_add_root_slot((mem_allocator_t)heap, &r->val))
                 return false;
         }
     }
@@ -5407,7 +5463,8 @@ aot_frame_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
             if (frame_local_flags.local_ref_flags[i]) {
                 gc_obj = GET_REF_FROM_ADDR(frame->lp + i);
                 if (wasm_obj_is_created_from_heap(gc_obj)) {
-                    if (mem_allocator_add_root((mem_allocator_t)heap, gc_obj)) {
+                    if (mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                    frame->lp + i)) {
                         return false;
                     }
                 }
@@ -5425,7 +5482,8 @@ aot_frame_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
             if (frame_ref[i]) {
                 gc_obj = GET_REF_FROM_ADDR(frame->lp + i);
                 if (wasm_obj_is_created_from_heap(gc_obj)) {
-                    if (mem_allocator_add_root((mem_allocator_t)heap, gc_obj)) {
+                    if (mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                    frame->lp + i)) {
                         return false;
                     }
                 }
@@ -35,6 +35,9 @@ extern "C" {
  * and not at the beginning of each function call */
 #define WASM_FEATURE_FRAME_PER_FUNCTION (1 << 12)
 #define WASM_FEATURE_FRAME_NO_FUNC_IDX (1 << 13)
+/* Write barrier is called after a reference is stored into a GC object,
+ * which is required by the incremental marking of GC heap */
+#define WASM_FEATURE_GC_WRITE_BARRIER (1 << 14)
 
 typedef enum AOTSectionType {
     AOT_SECTION_TYPE_TARGET_INFO = 0,
@@ -356,6 +359,24 @@ typedef struct AOTModule {
     uint8 *merged_data_text_sections;
     uint32 merged_data_text_sections_size;
 
+    /* The AOT file mapped into memory privately when the module is loaded
+       by aot_load_from_mapped_file(), and the text section mapped from
+       the file separately, so that the pages of the text section which
+       aren't modified by relocations are shared with other processes */
+    uint8 *mapped_file;
+    uint64 mapped_file_size;
+    uint8 *mapped_text;
+    uint32 mapped_text_size;
+    /* The text relocations deferred until the pages they patch are
+       executed for the first time, NULL if they are applied at loading */
+    struct AOTLazyText *lazy_text;
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* The memory init data prepared for being mapped on instantiation,
+       NULL if it is copied instead */
+    struct WASMMemoryImage *memory_image;
+#endif
+
 #if WASM_ENABLE_AOT_STACK_FRAME != 0
     uint32 feature_flags;
 #endif
@@ -506,6 +527,43 @@ AOTModule *
 aot_load_from_aot_file(const uint8 *buf, uint32 size, const LoadArgs *args,
                        char *error_buf, uint32 error_buf_size);
 
+#if defined(OS_ENABLE_FILE_MAPPING) && defined(OS_ENABLE_HW_BOUND_CHECK)
+/* The relocations to the text section mapped from the AOT file are
+   applied to a page when it is executed for the first time, which is
+   caught by the signal handler of the runtime */
+#define AOT_LAZY_TEXT_RELOCATION 1
+
+/**
+ * Apply the deferred text relocations to the page of a module loaded
+ * by aot_load_from_mapped_file(), called when the page is accessed for
+ * the first time
+ *
+ * @param addr the faulting address
+ *
+ * @return true if the address is in a page whose relocations are now
+ *         applied and the access can be restarted, false otherwise
+ */
+bool
+aot_apply_lazy_text_relocations(void *addr);
+#endif
+
+#ifdef OS_ENABLE_FILE_MAPPING
+/**
+ * Load a AOT module by mapping the AOT file into memory privately
+ * instead of reading it, the text section is used from the mapping
+ * in place and only the pages patched by relocations are copied
+ *
+ * @param file_path the path of the AOT file
+ * @param error_buf output of the error info
+ * @param error_buf_size the size of the error string
+ *
+ * @return return AOT module loaded, NULL if failed
+ */
+AOTModule *
+aot_load_from_mapped_file(const char *file_path, const LoadArgs *args,
+                          char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Load a AOT module from a specified AOT section list.
  *
@@ -992,3 +992,20 @@ wasm_runtime_set_wasm_object_extra_info_flag(WASMObjectRef obj, bool set)
         obj->header &= ~WASM_OBJ_EXTRA_INFO_FLAG;
     }
 }
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+bool
+wasm_runtime_is_gc_compaction_allowed(WASMExecEnv *exec_env)
+{
+    /* The AOT/JIT code may keep the object references in registers and
+       native stack across function calls, only the references in the
+       interpreter frames can be updated after the objects are moved */
+#if WASM_ENABLE_INTERP != 0
+    if (exec_env->module_inst->module_type == Wasm_Module_Bytecode) {
+        return wasm_runtime_get_running_mode(exec_env->module_inst)
+               == Mode_Interp;
+    }
+#endif
+    return false;
+}
+#endif
@@ -143,6 +143,11 @@ wasm_struct_obj_set_field(WASMStructObjectRef struct_obj, uint32 field_idx,
     else {
         bh_assert(0);
     }
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (wasm_is_type_reftype(field->field_type))
+        mem_allocator_write_barrier((WASMObjectRef)struct_obj);
+#endif
 }
 
 void
@@ -268,8 +273,37 @@ wasm_array_obj_new(WASMExecEnv *exec_env, WASMRttTypeRef rtt_type,
                    uint32 length, WASMValue *init_value)
 {
     void *heap_handle = get_gc_heap_handle(exec_env);
-    return wasm_array_obj_new_internal(heap_handle, rtt_type, length,
-                                       init_value);
+    WASMArrayType *array_type = (WASMArrayType *)rtt_type->defined_type;
+    WASMArrayObjectRef array_obj;
+    WASMLocalObjectRef local_ref;
+    WASMValue elem_value;
+    uint32 i;
+
+    if (!init_value || !wasm_is_type_reftype(array_type->elem_type)
+        || !wasm_obj_is_created_from_heap(init_value->gc_obj)) {
+        return wasm_array_obj_new_internal(heap_handle, rtt_type, length,
+                                           init_value);
+    }
+
+    /* Lock the init object in case it is reclaimed or moved when
+       allocating the array below */
+    wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
+    local_ref.val = init_value->gc_obj;
+
+    if (!(array_obj = wasm_array_obj_new_internal(heap_handle, rtt_type,
+                                                  length, NULL))) {
+        wasm_runtime_pop_local_obj_ref(exec_env);
+        return NULL;
+    }
+
+    elem_value.gc_obj = local_ref.val;
+    for (i = 0; i < length; i++) {
+        uint32 *elem_addr = (uint32 *)array_obj->elem_data + REF_CELL_NUM * i;
+        PUT_REF_TO_ADDR(elem_addr, elem_value.gc_obj);
+    }
+
+    wasm_runtime_pop_local_obj_ref(exec_env);
+    return array_obj;
 }
 
 void
@@ -293,6 +327,12 @@ wasm_array_obj_set_elem(WASMArrayObjectRef array_obj, uint32 elem_idx,
             PUT_I64_TO_ADDR((uint32 *)elem_data, value->i64);
             break;
     }
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* the barrier only checks the object header, which is cheaper than
+       checking whether the element type is a reference type */
+    mem_allocator_write_barrier((WASMObjectRef)array_obj);
+#endif
 }
 
 void
@@ -347,6 +387,10 @@ wasm_array_obj_fill(const WASMArrayObjectRef array_obj, uint32 elem_idx,
         }
         elem_data += elem_size;
     }
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    mem_allocator_write_barrier((WASMObjectRef)array_obj);
+#endif
 }
 
 void
@@ -358,6 +402,10 @@ wasm_array_obj_copy(WASMArrayObjectRef dst_obj, uint32 dst_idx,
     uint32 elem_size = 1 << wasm_array_obj_elem_size_log(dst_obj);
 
     bh_memmove_s(dst_data, elem_size * len, src_data, elem_size * len);
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    mem_allocator_write_barrier((WASMObjectRef)dst_obj);
+#endif
 }
 
 uint32
@@ -448,7 +496,8 @@ wasm_externref_obj_new(WASMExecEnv *exec_env, const void *host_obj)
     }
 
     externref_obj->header = WASM_OBJ_EXTERNREF_OBJ_FLAG;
-    externref_obj->internal_obj = (WASMObjectRef)anyref_obj;
+    /* anyref_obj may have been moved if the heap was compacted */
+    externref_obj->internal_obj = local_ref.val;
 
     wasm_runtime_pop_local_obj_ref(exec_env);
     return externref_obj;
@@ -482,15 +531,23 @@ wasm_internal_obj_to_externref_obj(WASMExecEnv *exec_env,
 {
     void *heap_handle = get_gc_heap_handle(exec_env);
     WASMExternrefObjectRef externref_obj;
+    WASMLocalObjectRef local_ref;
+
+    /* Lock internal_obj in case it is reclaimed or moved when allocating
+       memory below */
+    wasm_runtime_push_local_obj_ref(exec_env, &local_ref);
+    local_ref.val = internal_obj;
 
     if (!(externref_obj =
               gc_obj_malloc(heap_handle, sizeof(WASMExternrefObject)))) {
+        wasm_runtime_pop_local_obj_ref(exec_env);
         return NULL;
     }
 
     externref_obj->header = WASM_OBJ_EXTERNREF_OBJ_FLAG;
-    externref_obj->internal_obj = internal_obj;
+    externref_obj->internal_obj = local_ref.val;
 
+    wasm_runtime_pop_local_obj_ref(exec_env);
     return externref_obj;
 }
 
@@ -679,6 +736,16 @@ wasm_obj_is_instance_of(WASMObjectRef obj, uint32 type_idx, WASMType **types,
     return (type_sub == type_parent) ? true : false;
 }
 
+void
+wasm_obj_write_barrier(WASMObjectRef obj)
+{
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    mem_allocator_write_barrier(obj);
+#else
+    (void)obj;
+#endif
+}
+
 bool
 wasm_obj_is_type_of(WASMObjectRef obj, int32 heap_type)
 {
@@ -325,6 +325,14 @@ wasm_obj_is_instance_of(WASMObjectRef obj, uint32 type_idx, WASMType **types,
 bool
 wasm_obj_is_type_of(WASMObjectRef obj, int32 heap_type);
 
+/**
+ * Write barrier called by the AOT/JIT code after a reference is stored
+ * into a struct or array object, it does nothing unless incremental
+ * marking is enabled
+ */
+void
+wasm_obj_write_barrier(WASMObjectRef obj);
+
 bool
 wasm_obj_equal(WASMObjectRef obj1, WASMObjectRef obj2);
 
@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_instance_reset.h"
+#include "wasm_memory.h"
+#include "mem_alloc.h"
+#include "../interpreter/wasm_runtime.h"
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+
+#if WASM_ENABLE_GC != 0
+#error "Instance reset doesn't support GC: the tables and globals may \
+hold references to GC objects"
+#endif
+
+/* The max length of the data written to a memory image at a time */
+#define RESET_IMAGE_WRITE_MAX_SIZE (64 * 1024 * 1024)
+
+typedef struct ResetMemory {
+    uint8 *memory_data;
+    uint64 data_size;
+    uint32 cur_page_count;
+    /* The linear memory data is saved to a memory image when possible,
+       which is mapped copy-on-write over the linear memory on reset: the
+       pages written since the last reset are dropped and the other pages
+       are left untouched. Otherwise the data is copied to data_copy. */
+    WASMMemoryImage *image;
+    uint8 *data_copy;
+    /* The heap structure of the host managed heap, its pool is in the
+       linear memory and is reset together with the linear memory data */
+    uint8 *heap_state;
+} ResetMemory;
+
+typedef struct ResetTable {
+    uint32 cur_size;
+    table_elem_type_t *elems;
+} ResetTable;
+
+struct WASMInstanceResetState {
+    uint32 memory_count;
+    uint32 table_count;
+    uint32 global_data_size;
+    uint32 data_dropped_size;
+    uint32 elem_dropped_size;
+    ResetMemory *memories;
+    ResetTable *tables;
+    uint8 *global_data;
+    uint8 *data_dropped;
+    uint8 *elem_dropped;
+};
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL)
+        snprintf(error_buf, error_buf_size, "%s", string);
+}
+
+static void *
+runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX || !(mem = wasm_runtime_malloc((uint32)size))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
+static WASMModuleInstanceExtraCommon *
+get_extra_common(WASMModuleInstance *module_inst)
+{
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        return &module_inst->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        return &((AOTModuleInstanceExtra *)module_inst->e)->common;
+#endif
+    bh_assert(0);
+    return NULL;
+}
+
+static void
+get_dropped_bitmaps(WASMModuleInstanceExtraCommon *common,
+                    bh_bitmap **p_data_dropped, bh_bitmap **p_elem_dropped)
+{
+    *p_data_dropped = *p_elem_dropped = NULL;
+#if WASM_ENABLE_BULK_MEMORY != 0
+    *p_data_dropped = common->data_dropped;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    *p_elem_dropped = common->elem_dropped;
+#endif
+    (void)common;
+}
+
+static uint32
+get_bitmap_size(const bh_bitmap *bitmap)
+{
+    return bitmap ? (uint32)(bitmap->end_index - bitmap->begin_index + 7) / 8
+                  : 0;
+}
+
+static bool
+is_zero_page(const uint8 *page, uint32 page_size)
+{
+    const uint64 *p = (const uint64 *)page;
+    const uint64 *p_end = (const uint64 *)(page + page_size);
+
+    while (p < p_end) {
+        if (*p++ != 0)
+            return false;
+    }
+    return true;
+}
+
+/* Create a memory image of the linear memory data, return NULL if memory
+   images aren't supported or the data can't be mapped by pages */
+static WASMMemoryImage *
+create_memory_image(const uint8 *data, uint64 data_size)
+{
+    WASMMemoryImage *image;
+    uint32 page_size = (uint32)os_getpagesize();
+    uint64 offset = 0, end;
+
+    if (data_size % page_size != 0 || (uintptr_t)data % page_size != 0
+        || !(image = wasm_memory_image_create(data_size)))
+        return NULL;
+
+    /* Only the runs of non-zero pages are written, the holes of the image
+       read as zero and don't take memory */
+    while (offset < data_size) {
+        if (is_zero_page(data + offset, page_size)) {
+            offset += page_size;
+            continue;
+        }
+
+        end = offset + page_size;
+        while (end < data_size && end - offset < RESET_IMAGE_WRITE_MAX_SIZE
+               && !is_zero_page(data + end, page_size))
+            end += page_size;
+
+        if (!wasm_memory_image_write(image, offset, data + offset,
+                                     (uint32)(end - offset))) {
+            wasm_memory_image_destroy(image);
+            return NULL;
+        }
+        offset = end;
+    }
+
+    return image;
+}
+
+static void
+destroy_state(WASMInstanceResetState *state)
+{
+    ResetMemory *memory;
+    uint32 i;
+
+    if (state->memories) {
+        for (i = 0; i < state->memory_count; i++) {
+            memory = &state->memories[i];
+            if (memory->image)
+                wasm_memory_image_destroy(memory->image);
+            if (memory->data_copy)
+                wasm_runtime_free(memory->data_copy);
+            if (memory->heap_state)
+                wasm_runtime_free(memory->heap_state);
+        }
+        wasm_runtime_free(state->memories);
+    }
+
+    if (state->tables) {
+        for (i = 0; i < state->table_count; i++) {
+            if (state->tables[i].elems)
+                wasm_runtime_free(state->tables[i].elems);
+        }
+        wasm_runtime_free(state->tables);
+    }
+
+    if (state->global_data)
+        wasm_runtime_free(state->global_data);
+    if (state->data_dropped)
+        wasm_runtime_free(state->data_dropped);
+    if (state->elem_dropped)
+        wasm_runtime_free(state->elem_dropped);
+    wasm_runtime_free(state);
+}
+
+static bool
+save_memory(WASMMemoryInstance *memory, ResetMemory *saved, char *error_buf,
+            uint32 error_buf_size)
+{
+    if (memory->is_shared_memory) {
+        set_error_buf(error_buf, error_buf_size,
+                      "reset of shared memory isn't supported");
+        return false;
+    }
+
+    saved->memory_data = memory->memory_data;
+    saved->data_size = memory->memory_data ? memory->memory_data_size : 0;
+    saved->cur_page_count = memory->cur_page_count;
+
+    if (saved->data_size > 0
+        && !(saved->image =
+                 create_memory_image(memory->memory_data, saved->data_size))) {
+        if (!(saved->data_copy = runtime_malloc(saved->data_size, error_buf,
+                                                error_buf_size)))
+            return false;
+        bh_memcpy_s(saved->data_copy, (uint32)saved->data_size,
+                    memory->memory_data, (uint32)saved->data_size);
+    }
+
+    if (memory->heap_handle) {
+        if (!(saved->heap_state =
+                  runtime_malloc(mem_allocator_get_heap_struct_size(),
+                                 error_buf, error_buf_size)))
+            return false;
+        if (!mem_allocator_save_state(memory->heap_handle,
+                                      saved->heap_state)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "save host managed heap failed");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+wasm_instance_reset_save(WASMModuleInstanceCommon *module_inst_comm,
+                         char *error_buf, uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    WASMInstanceResetState *state;
+    WASMTableInstance *table;
+    bh_bitmap *data_dropped, *elem_dropped;
+    uint32 i;
+
+    if (!(state = runtime_malloc(sizeof(WASMInstanceResetState), error_buf,
+                                 error_buf_size)))
+        return false;
+
+    state->memory_count = module_inst->memory_count;
+    if (state->memory_count > 0
+        && !(state->memories = runtime_malloc(
+                 (uint64)sizeof(ResetMemory) * state->memory_count, error_buf,
+                 error_buf_size)))
+        goto fail;
+
+    for (i = 0; i < state->memory_count; i++) {
+        if (!save_memory(module_inst->memories[i], &state->memories[i],
+                         error_buf, error_buf_size))
+            goto fail;
+    }
+
+    state->table_count = module_inst->table_count;
+    if (state->table_count > 0
+        && !(state->tables = runtime_malloc(
+                 (uint64)sizeof(ResetTable) * state->table_count, error_buf,
+                 error_buf_size)))
+        goto fail;
+
+    for (i = 0; i < state->table_count; i++) {
+        table = module_inst->tables[i];
+        state->tables[i].cur_size = table->cur_size;
+        if (table->cur_size == 0)
+            continue;
+
+        if (!(state->tables[i].elems = runtime_malloc(
+                  (uint64)sizeof(table_elem_type_t) * table->cur_size,
+                  error_buf, error_buf_size)))
+            goto fail;
+        bh_memcpy_s(state->tables[i].elems,
+                    (uint32)sizeof(table_elem_type_t) * table->cur_size,
+                    table->elems,
+                    (uint32)sizeof(table_elem_type_t) * table->cur_size);
+    }
+
+    state->global_data_size = module_inst->global_data_size;
+    if (state->global_data_size > 0) {
+        if (!(state->global_data = runtime_malloc(
+                  state->global_data_size, error_buf, error_buf_size)))
+            goto fail;
+        bh_memcpy_s(state->global_data, state->global_data_size,
+                    module_inst->global_data, state->global_data_size);
+    }
+
+    get_dropped_bitmaps(common, &data_dropped, &elem_dropped);
+
+    state->data_dropped_size = get_bitmap_size(data_dropped);
+    if (state->data_dropped_size > 0) {
+        if (!(state->data_dropped = runtime_malloc(
+                  state->data_dropped_size, error_buf, error_buf_size)))
+            goto fail;
+        bh_memcpy_s(state->data_dropped, state->data_dropped_size,
+                    data_dropped->map, state->data_dropped_size);
+    }
+
+    state->elem_dropped_size = get_bitmap_size(elem_dropped);
+    if (state->elem_dropped_size > 0) {
+        if (!(state->elem_dropped = runtime_malloc(
+                  state->elem_dropped_size, error_buf, error_buf_size)))
+            goto fail;
+        bh_memcpy_s(state->elem_dropped, state->elem_dropped_size,
+                    elem_dropped->map, state->elem_dropped_size);
+    }
+
+    if (common->reset_state)
+        destroy_state(common->reset_state);
+    common->reset_state = state;
+    return true;
+
+fail:
+    destroy_state(state);
+    return false;
+}
+
+static bool
+restore_memory(WASMMemoryInstance *memory, const ResetMemory *saved,
+               char *error_buf, uint32 error_buf_size)
+{
+    /* Shrink the linear memory enlarged after the state was saved */
+    if (memory->cur_page_count > saved->cur_page_count
+        && !wasm_shrink_linear_memory(memory, saved->cur_page_count)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "linear memory enlarged after the state was saved "
+                      "can't be shrunk");
+        return false;
+    }
+
+    if (memory->memory_data != saved->memory_data
+        || memory->cur_page_count != saved->cur_page_count) {
+        set_error_buf(error_buf, error_buf_size,
+                      "linear memory doesn't match the state saved");
+        return false;
+    }
+
+    if (saved->image) {
+        if (!wasm_memory_image_map(memory, saved->image)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "map memory image failed");
+            return false;
+        }
+    }
+    else if (saved->data_size > 0) {
+        bh_memcpy_s(memory->memory_data, (uint32)saved->data_size,
+                    saved->data_copy, (uint32)saved->data_size);
+    }
+
+    if (saved->heap_state
+        && !mem_allocator_restore_state(memory->heap_handle,
+                                        saved->heap_state)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "restore host managed heap failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+wasm_instance_reset_restore(WASMModuleInstanceCommon *module_inst_comm,
+                            char *error_buf, uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMModuleInstanceExtraCommon *common = get_extra_common(module_inst);
+    const WASMInstanceResetState *state = common->reset_state;
+    WASMTableInstance *table;
+    bh_bitmap *data_dropped, *elem_dropped;
+    uint32 i;
+
+    if (!state) {
+        set_error_buf(error_buf, error_buf_size,
+                      "no state is saved to reset the instance to");
+        return false;
+    }
+
+    for (i = 0; i < state->memory_count; i++) {
+        if (!restore_memory(module_inst->memories[i], &state->memories[i],
+                            error_buf, error_buf_size))
+            return false;
+    }
+
+    for (i = 0; i < state->table_count; i++) {
+        table = module_inst->tables[i];
+        table->cur_size = state->tables[i].cur_size;
+        if (table->cur_size > 0) {
+            bh_memcpy_s(table->elems,
+                        (uint32)sizeof(table_elem_type_t) * table->max_size,
+                        state->tables[i].elems,
+                        (uint32)sizeof(table_elem_type_t) * table->cur_size);
+        }
+    }
+
+    if (state->global_data_size > 0) {
+        bh_memcpy_s(module_inst->global_data, module_inst->global_data_size,
+                    state->global_data, state->global_data_size);
+    }
+
+    get_dropped_bitmaps(common, &data_dropped, &elem_dropped);
+    if (state->data_dropped_size > 0) {
+        bh_memcpy_s(data_dropped->map, state->data_dropped_size,
+                    state->data_dropped, state->data_dropped_size);
+    }
+    if (state->elem_dropped_size > 0) {
+        bh_memcpy_s(elem_dropped->map, state->elem_dropped_size,
+                    state->elem_dropped, state->elem_dropped_size);
+    }
+
+    wasm_runtime_clear_exception(module_inst_comm);
+    return true;
+}
+
+void
+wasm_instance_reset_destroy(WASMModuleInstanceCommon *module_inst_comm)
+{
+    WASMModuleInstanceExtraCommon *common =
+        get_extra_common((WASMModuleInstance *)module_inst_comm);
+
+    if (common->reset_state) {
+        destroy_state(common->reset_state);
+        common->reset_state = NULL;
+    }
+}
+
+#endif /* end of WASM_ENABLE_INSTANCE_RESET != 0 */
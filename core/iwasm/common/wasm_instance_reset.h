@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_INSTANCE_RESET_H
+#define _WASM_INSTANCE_RESET_H
+
+#include "bh_common.h"
+#include "wasm_runtime_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+
+typedef struct WASMInstanceResetState WASMInstanceResetState;
+
+/**
+ * Save the linear memories, the host managed heaps, the globals, the
+ * tables and the dropped data/element segments of the module instance
+ * as the state to reset it to, the state saved before is replaced
+ */
+bool
+wasm_instance_reset_save(WASMModuleInstanceCommon *module_inst,
+                         char *error_buf, uint32 error_buf_size);
+
+/**
+ * Reset the module instance to the state saved by wasm_instance_reset_save
+ */
+bool
+wasm_instance_reset_restore(WASMModuleInstanceCommon *module_inst,
+                            char *error_buf, uint32 error_buf_size);
+
+/**
+ * Free the state saved, it is called when the module instance is
+ * deinstantiated
+ */
+void
+wasm_instance_reset_destroy(WASMModuleInstanceCommon *module_inst);
+
+#endif /* end of WASM_ENABLE_INSTANCE_RESET != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_INSTANCE_RESET_H */
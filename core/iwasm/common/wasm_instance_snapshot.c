@@ -0,0 +1,634 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_instance_snapshot.h"
+#include "wasm_memory.h"
+#include "../interpreter/wasm_runtime.h"
+#if WASM_ENABLE_AOT != 0
+#include "../aot/aot_runtime.h"
+#endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+
+#if WASM_ENABLE_GC != 0
+#error "Instance snapshot doesn't support GC: the tables and globals may \
+hold references to GC objects"
+#endif
+
+#define SNAPSHOT_MAGIC 0x50414e53 /* "SNAP" */
+#define SNAPSHOT_VERSION 1
+
+/* The linear memory data is aligned to the maximum page size of the
+   supported platforms in the snapshot file, so that it can be mapped */
+#define SNAPSHOT_DATA_ALIGN 65536
+
+/* When the linear memory is reserved with mmap, the linear memory data
+   is mapped from the snapshot file copy-on-write: the pages are only read
+   in when they are accessed, and are shared by the page cache between the
+   restored instances until they are written */
+#if defined(OS_ENABLE_FILE_MAPPING) && defined(OS_ENABLE_HW_BOUND_CHECK) \
+    && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define SNAPSHOT_MAP_MEMORY 1
+#endif
+
+/*
+ * The layout of the snapshot file:
+ *   +----------------------------------+
+ *   | SnapshotHeader                   |
+ *   +----------------------------------+ <-- instance state
+ *   | SnapshotMemory[memory_count]     |
+ *   | global data                      |
+ *   | (SnapshotTable, elems)[tables]   |
+ *   | data_dropped bitmap              |
+ *   | elem_dropped bitmap              |
+ *   +----------------------------------+ <-- aligned to SNAPSHOT_DATA_ALIGN
+ *   | linear memory data[memory_count] |
+ *   +----------------------------------+
+ */
+typedef struct SnapshotHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 module_type;
+    uint32 memory_count;
+    uint32 global_data_size;
+    uint32 table_count;
+    uint32 data_seg_count;
+    uint32 elem_seg_count;
+    uint64 state_size;
+} SnapshotHeader;
+
+typedef struct SnapshotMemory {
+    uint32 num_bytes_per_page;
+    uint32 cur_page_count;
+    uint64 data_size;
+    uint64 data_offset;
+} SnapshotMemory;
+
+/* Followed by cur_size elements in the file */
+typedef struct SnapshotTable {
+    uint32 elem_type;
+    uint32 elem_size;
+    uint32 max_size;
+    uint32 cur_size;
+} SnapshotTable;
+
+struct WASMInstanceSnapshot {
+    FILE *fp;
+#ifdef SNAPSHOT_MAP_MEMORY
+    os_file_handle file;
+    uint64 file_size;
+#endif
+    SnapshotHeader header;
+    uint8 *state;
+    SnapshotMemory *memories;
+    uint8 *global_data;
+    uint8 *tables;
+    uint8 *data_dropped;
+    uint8 *elem_dropped;
+};
+
+static void
+set_error_buf(char *error_buf, uint32 error_buf_size, const char *string)
+{
+    if (error_buf != NULL)
+        snprintf(error_buf, error_buf_size, "%s", string);
+}
+
+static void
+set_error_buf_v(char *error_buf, uint32 error_buf_size, const char *format,
+                ...)
+{
+    va_list args;
+
+    if (error_buf != NULL) {
+        va_start(args, format);
+        vsnprintf(error_buf, error_buf_size, format, args);
+        va_end(args);
+    }
+}
+
+static void *
+runtime_malloc(uint64 size, char *error_buf, uint32 error_buf_size)
+{
+    void *mem;
+
+    if (size >= UINT32_MAX || !(mem = wasm_runtime_malloc((uint32)size))) {
+        set_error_buf(error_buf, error_buf_size, "allocate memory failed");
+        return NULL;
+    }
+
+    memset(mem, 0, (uint32)size);
+    return mem;
+}
+
+static void
+get_dropped_bitmaps(WASMModuleInstance *module_inst, bh_bitmap **p_data_dropped,
+                    bh_bitmap **p_elem_dropped)
+{
+    WASMModuleInstanceExtraCommon *common = NULL;
+
+#if WASM_ENABLE_INTERP != 0
+    if (module_inst->module_type == Wasm_Module_Bytecode)
+        common = &module_inst->e->common;
+#endif
+#if WASM_ENABLE_AOT != 0
+    if (module_inst->module_type == Wasm_Module_AoT)
+        common = &((AOTModuleInstanceExtra *)module_inst->e)->common;
+#endif
+    bh_assert(common);
+
+    *p_data_dropped = *p_elem_dropped = NULL;
+#if WASM_ENABLE_BULK_MEMORY != 0
+    *p_data_dropped = common->data_dropped;
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    *p_elem_dropped = common->elem_dropped;
+#endif
+    (void)common;
+}
+
+static uint32
+get_bitmap_bit_count(const bh_bitmap *bitmap)
+{
+    return bitmap ? (uint32)(bitmap->end_index - bitmap->begin_index) : 0;
+}
+
+static uint32
+get_bitmap_size(uint32 bit_count)
+{
+    return (bit_count + 7) / 8;
+}
+
+static bool
+write_padding(FILE *fp, uint64 size)
+{
+    static const uint8 zeros[4096] = { 0 };
+    uint64 n;
+
+    while (size > 0) {
+        n = size < sizeof(zeros) ? size : sizeof(zeros);
+        if (fwrite(zeros, 1, (size_t)n, fp) != (size_t)n)
+            return false;
+        size -= n;
+    }
+    return true;
+}
+
+static bool
+write_snapshot(FILE *fp, WASMModuleInstance *module_inst,
+               const SnapshotHeader *header, const SnapshotMemory *memories,
+               bh_bitmap *data_dropped, bh_bitmap *elem_dropped)
+{
+    WASMTableInstance *table;
+    SnapshotTable snapshot_table;
+    uint64 offset, size;
+    uint32 i;
+
+    if (fwrite(header, sizeof(SnapshotHeader), 1, fp) != 1
+        || (header->memory_count > 0
+            && fwrite(memories, sizeof(SnapshotMemory), header->memory_count,
+                      fp)
+                   != header->memory_count)
+        || fwrite(module_inst->global_data, 1, header->global_data_size, fp)
+               != header->global_data_size)
+        return false;
+
+    for (i = 0; i < header->table_count; i++) {
+        table = module_inst->tables[i];
+        snapshot_table.elem_type = table->elem_type;
+        snapshot_table.elem_size = (uint32)sizeof(table_elem_type_t);
+        snapshot_table.max_size = table->max_size;
+        snapshot_table.cur_size = table->cur_size;
+        if (fwrite(&snapshot_table, sizeof(SnapshotTable), 1, fp) != 1
+            || fwrite(table->elems, sizeof(table_elem_type_t), table->cur_size,
+                      fp)
+                   != table->cur_size)
+            return false;
+    }
+
+    size = get_bitmap_size(header->data_seg_count);
+    if (size > 0 && fwrite(data_dropped->map, 1, (size_t)size, fp) != size)
+        return false;
+
+    size = get_bitmap_size(header->elem_seg_count);
+    if (size > 0 && fwrite(elem_dropped->map, 1, (size_t)size, fp) != size)
+        return false;
+
+    offset = sizeof(SnapshotHeader) + header->state_size;
+    for (i = 0; i < header->memory_count; i++) {
+        if (memories[i].data_size == 0)
+            continue;
+
+        if (!write_padding(fp, memories[i].data_offset - offset)
+            || fwrite(module_inst->memories[i]->memory_data, 1,
+                      (size_t)memories[i].data_size, fp)
+                   != memories[i].data_size)
+            return false;
+        offset = memories[i].data_offset + memories[i].data_size;
+    }
+
+    return true;
+}
+
+bool
+wasm_instance_snapshot_save(WASMModuleInstanceCommon *module_inst_comm,
+                            const char *file_path, char *error_buf,
+                            uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMMemoryInstance *memory;
+    SnapshotHeader header = { 0 };
+    SnapshotMemory *memories = NULL;
+    bh_bitmap *data_dropped, *elem_dropped;
+    char *temp_path = NULL;
+    uint64 state_size, data_offset, size;
+    uint32 i;
+    FILE *fp;
+    bool ret = false;
+
+    get_dropped_bitmaps(module_inst, &data_dropped, &elem_dropped);
+
+    header.magic = SNAPSHOT_MAGIC;
+    header.version = SNAPSHOT_VERSION;
+    header.module_type = module_inst->module_type;
+    header.memory_count = module_inst->memory_count;
+    header.global_data_size = module_inst->global_data_size;
+    header.table_count = module_inst->table_count;
+    header.data_seg_count = get_bitmap_bit_count(data_dropped);
+    header.elem_seg_count = get_bitmap_bit_count(elem_dropped);
+
+    state_size = (uint64)sizeof(SnapshotMemory) * header.memory_count
+                 + header.global_data_size
+                 + get_bitmap_size(header.data_seg_count)
+                 + get_bitmap_size(header.elem_seg_count);
+    for (i = 0; i < header.table_count; i++) {
+        state_size += sizeof(SnapshotTable)
+                      + (uint64)sizeof(table_elem_type_t)
+                            * module_inst->tables[i]->cur_size;
+    }
+    header.state_size = state_size;
+
+    if (header.memory_count > 0
+        && !(memories = runtime_malloc(
+                 (uint64)sizeof(SnapshotMemory) * header.memory_count,
+                 error_buf, error_buf_size)))
+        return false;
+
+    data_offset = sizeof(SnapshotHeader) + state_size;
+    for (i = 0; i < header.memory_count; i++) {
+        memory = module_inst->memories[i];
+
+        if (memory->is_shared_memory) {
+            set_error_buf(error_buf, error_buf_size,
+                          "snapshot of shared memory isn't supported");
+            goto fail;
+        }
+        /* The state of the host managed heap is kept outside of the
+           linear memory */
+        if (memory->heap_handle) {
+            set_error_buf(error_buf, error_buf_size,
+                          "snapshot of instance with host managed heap "
+                          "isn't supported");
+            goto fail;
+        }
+
+        data_offset = align_uint64(data_offset, SNAPSHOT_DATA_ALIGN);
+        memories[i].num_bytes_per_page = memory->num_bytes_per_page;
+        memories[i].cur_page_count = memory->cur_page_count;
+        memories[i].data_size = memory->memory_data ? memory->memory_data_size
+                                                    : 0;
+        memories[i].data_offset = data_offset;
+        data_offset += memories[i].data_size;
+    }
+
+    /* Write to a temporary file and rename it: the restored instances may
+       still map the pages of the old snapshot file which weren't written
+       by them, so the file must not be modified in place */
+    size = strlen(file_path) + 40;
+    if (!(temp_path = runtime_malloc(size, error_buf, error_buf_size)))
+        goto fail;
+    snprintf(temp_path, (size_t)size, "%s.%llx-%llx.tmp", file_path,
+             (unsigned long long)os_time_get_boot_us(),
+             (unsigned long long)(uintptr_t)os_self_thread());
+
+    if (!(fp = fopen(temp_path, "wb"))) {
+        set_error_buf_v(error_buf, error_buf_size,
+                        "create snapshot file %s failed", temp_path);
+        goto fail;
+    }
+
+    ret = write_snapshot(fp, module_inst, &header, memories, data_dropped,
+                         elem_dropped);
+    ret = (fclose(fp) == 0) && ret;
+
+    if (!ret || rename(temp_path, file_path) != 0) {
+        set_error_buf_v(error_buf, error_buf_size,
+                        "write snapshot file %s failed", file_path);
+        (void)unlink(temp_path);
+        ret = false;
+    }
+
+fail:
+    if (temp_path)
+        wasm_runtime_free(temp_path);
+    if (memories)
+        wasm_runtime_free(memories);
+    return ret;
+}
+
+static bool
+parse_state(WASMInstanceSnapshot *snapshot, char *error_buf,
+            uint32 error_buf_size)
+{
+    SnapshotHeader *header = &snapshot->header;
+    SnapshotTable table;
+    uint8 *p = snapshot->state, *p_end = p + header->state_size;
+    uint64 size;
+    uint32 i;
+
+    size = (uint64)sizeof(SnapshotMemory) * header->memory_count;
+    if (size > (uint64)(p_end - p))
+        goto fail;
+    snapshot->memories = (SnapshotMemory *)p;
+    p += size;
+
+    if (header->global_data_size > (uint64)(p_end - p))
+        goto fail;
+    snapshot->global_data = p;
+    p += header->global_data_size;
+
+    snapshot->tables = p;
+    for (i = 0; i < header->table_count; i++) {
+        if (sizeof(SnapshotTable) > (uint64)(p_end - p))
+            goto fail;
+        bh_memcpy_s(&table, sizeof(SnapshotTable), p, sizeof(SnapshotTable));
+        p += sizeof(SnapshotTable);
+
+        size = (uint64)table.elem_size * table.cur_size;
+        if (table.elem_size != sizeof(table_elem_type_t)
+            || table.cur_size > table.max_size || size > (uint64)(p_end - p))
+            goto fail;
+        p += size;
+    }
+
+    snapshot->data_dropped = p;
+    p += get_bitmap_size(header->data_seg_count);
+    snapshot->elem_dropped = p;
+    p += get_bitmap_size(header->elem_seg_count);
+    if (p != p_end)
+        goto fail;
+
+    for (i = 0; i < header->memory_count; i++) {
+        if (snapshot->memories[i].data_offset % SNAPSHOT_DATA_ALIGN != 0
+            || snapshot->memories[i].data_offset
+                   < sizeof(SnapshotHeader) + header->state_size)
+            goto fail;
+#ifdef SNAPSHOT_MAP_MEMORY
+        /* Accessing a mapped page beyond the end of the file raises
+           SIGBUS, so check the size of the file before mapping */
+        if (snapshot->memories[i].data_size > snapshot->file_size
+            || snapshot->memories[i].data_offset
+                   > snapshot->file_size - snapshot->memories[i].data_size)
+            goto fail;
+#endif
+    }
+
+    return true;
+
+fail:
+    set_error_buf(error_buf, error_buf_size, "invalid snapshot file");
+    return false;
+}
+
+WASMInstanceSnapshot *
+wasm_instance_snapshot_open(const char *file_path, char *error_buf,
+                            uint32 error_buf_size)
+{
+    WASMInstanceSnapshot *snapshot;
+    SnapshotHeader *header;
+
+    if (!(snapshot = runtime_malloc(sizeof(WASMInstanceSnapshot), error_buf,
+                                    error_buf_size)))
+        return NULL;
+
+#ifdef SNAPSHOT_MAP_MEMORY
+    snapshot->file =
+        os_file_open_for_mapping(file_path, &snapshot->file_size);
+    if (snapshot->file == os_get_invalid_handle()) {
+        set_error_buf_v(error_buf, error_buf_size,
+                        "open snapshot file %s failed", file_path);
+        goto fail;
+    }
+#endif
+
+    if (!(snapshot->fp = fopen(file_path, "rb"))) {
+        set_error_buf_v(error_buf, error_buf_size,
+                        "open snapshot file %s failed", file_path);
+        goto fail;
+    }
+
+    header = &snapshot->header;
+    if (fread(header, sizeof(SnapshotHeader), 1, snapshot->fp) != 1
+        || header->magic != SNAPSHOT_MAGIC) {
+        set_error_buf(error_buf, error_buf_size, "invalid snapshot file");
+        goto fail;
+    }
+
+    if (header->version != SNAPSHOT_VERSION) {
+        set_error_buf(error_buf, error_buf_size,
+                      "unsupported snapshot file version");
+        goto fail;
+    }
+
+    if (header->state_size > 0) {
+        if (!(snapshot->state = runtime_malloc(header->state_size, error_buf,
+                                               error_buf_size)))
+            goto fail;
+
+        if (fread(snapshot->state, 1, (size_t)header->state_size,
+                  snapshot->fp)
+            != header->state_size) {
+            set_error_buf(error_buf, error_buf_size, "invalid snapshot file");
+            goto fail;
+        }
+    }
+
+    if (!parse_state(snapshot, error_buf, error_buf_size))
+        goto fail;
+
+    return snapshot;
+
+fail:
+    wasm_instance_snapshot_close(snapshot);
+    return NULL;
+}
+
+void
+wasm_instance_snapshot_close(WASMInstanceSnapshot *snapshot)
+{
+#ifdef SNAPSHOT_MAP_MEMORY
+    if (snapshot->file != os_get_invalid_handle())
+        os_file_close_for_mapping(snapshot->file);
+#endif
+    if (snapshot->fp)
+        fclose(snapshot->fp);
+    if (snapshot->state)
+        wasm_runtime_free(snapshot->state);
+    wasm_runtime_free(snapshot);
+}
+
+static bool
+restore_memory(WASMModuleInstance *module_inst, uint32 memidx,
+               const WASMInstanceSnapshot *snapshot, char *error_buf,
+               uint32 error_buf_size)
+{
+    WASMMemoryInstance *memory = module_inst->memories[memidx];
+    const SnapshotMemory *snapshot_memory = &snapshot->memories[memidx];
+    uint64 data_size = snapshot_memory->data_size;
+#ifdef SNAPSHOT_MAP_MEMORY
+    uint64 page_size = (uint64)os_getpagesize();
+#endif
+
+    if (memory->heap_handle) {
+        set_error_buf(error_buf, error_buf_size,
+                      "restore of instance with host managed heap "
+                      "isn't supported");
+        return false;
+    }
+
+    if (memory->is_shared_memory
+        || snapshot_memory->num_bytes_per_page != memory->num_bytes_per_page
+        || snapshot_memory->cur_page_count < memory->cur_page_count) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot doesn't match the module instance");
+        return false;
+    }
+
+    /* Grow the linear memory to the size when the snapshot was taken */
+    if (snapshot_memory->cur_page_count > memory->cur_page_count
+        && !wasm_enlarge_memory_with_idx(
+            module_inst,
+            snapshot_memory->cur_page_count - memory->cur_page_count,
+            memidx)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "enlarge linear memory failed");
+        return false;
+    }
+
+    if (data_size == 0)
+        return true;
+
+    if (!memory->memory_data || data_size > memory->memory_data_size) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot doesn't match the module instance");
+        return false;
+    }
+
+#ifdef SNAPSHOT_MAP_MEMORY
+    /* The pages of the linear memory are replaced with a private mapping
+       of the file, they are unmapped together with the reserved space of
+       the linear memory. The pooled linear memories are discarded and
+       reused instead of unmapped, so their content is read instead. */
+    if (data_size % page_size == 0
+        && (uintptr_t)memory->memory_data % page_size == 0
+        && !wasm_linear_memory_pool_contains(memory->memory_data)) {
+        if (os_mmap_file(memory->memory_data, (size_t)data_size,
+                         MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_FIXED,
+                         snapshot->file, snapshot_memory->data_offset)
+            != memory->memory_data) {
+            set_error_buf(error_buf, error_buf_size,
+                          "map snapshot file failed");
+            return false;
+        }
+        return true;
+    }
+#endif
+
+    if (fseek(snapshot->fp, (long)snapshot_memory->data_offset, SEEK_SET) != 0
+        || fread(memory->memory_data, 1, (size_t)data_size, snapshot->fp)
+               != data_size) {
+        set_error_buf(error_buf, error_buf_size, "read snapshot file failed");
+        return false;
+    }
+
+    return true;
+}
+
+bool
+wasm_instance_snapshot_restore(WASMModuleInstanceCommon *module_inst_comm,
+                               const WASMInstanceSnapshot *snapshot,
+                               char *error_buf, uint32 error_buf_size)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    const SnapshotHeader *header = &snapshot->header;
+    WASMTableInstance *table;
+    SnapshotTable snapshot_table;
+    bh_bitmap *data_dropped, *elem_dropped;
+    const uint8 *p;
+    uint32 i;
+
+    get_dropped_bitmaps(module_inst, &data_dropped, &elem_dropped);
+
+    if (header->module_type != module_inst->module_type
+        || header->memory_count != module_inst->memory_count
+        || header->global_data_size != module_inst->global_data_size
+        || header->table_count != module_inst->table_count
+        || header->data_seg_count != get_bitmap_bit_count(data_dropped)
+        || header->elem_seg_count != get_bitmap_bit_count(elem_dropped)) {
+        set_error_buf(error_buf, error_buf_size,
+                      "snapshot doesn't match the module instance");
+        return false;
+    }
+
+    for (i = 0, p = snapshot->tables; i < header->table_count; i++) {
+        table = module_inst->tables[i];
+        bh_memcpy_s(&snapshot_table, sizeof(SnapshotTable), p,
+                    sizeof(SnapshotTable));
+        p += sizeof(SnapshotTable);
+
+        if (snapshot_table.elem_type != table->elem_type
+            || snapshot_table.max_size != table->max_size) {
+            set_error_buf(error_buf, error_buf_size,
+                          "snapshot doesn't match the module instance");
+            return false;
+        }
+
+        table->cur_size = snapshot_table.cur_size;
+        if (snapshot_table.cur_size > 0) {
+            bh_memcpy_s(table->elems,
+                        (uint32)sizeof(table_elem_type_t) * table->max_size,
+                        p,
+                        (uint32)sizeof(table_elem_type_t)
+                            * snapshot_table.cur_size);
+        }
+        p += sizeof(table_elem_type_t) * snapshot_table.cur_size;
+    }
+
+    for (i = 0; i < header->memory_count; i++) {
+        if (!restore_memory(module_inst, i, snapshot, error_buf,
+                            error_buf_size))
+            return false;
+    }
+
+    if (header->global_data_size > 0) {
+        bh_memcpy_s(module_inst->global_data, module_inst->global_data_size,
+                    snapshot->global_data, header->global_data_size);
+    }
+
+    if (header->data_seg_count > 0) {
+        bh_memcpy_s(data_dropped->map, get_bitmap_size(header->data_seg_count),
+                    snapshot->data_dropped,
+                    get_bitmap_size(header->data_seg_count));
+    }
+    if (header->elem_seg_count > 0) {
+        bh_memcpy_s(elem_dropped->map, get_bitmap_size(header->elem_seg_count),
+                    snapshot->elem_dropped,
+                    get_bitmap_size(header->elem_seg_count));
+    }
+
+    return true;
+}
+
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_INSTANCE_SNAPSHOT_H
+#define _WASM_INSTANCE_SNAPSHOT_H
+
+#include "bh_common.h"
+#include "wasm_runtime_common.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+
+typedef struct WASMInstanceSnapshot WASMInstanceSnapshot;
+
+/**
+ * Save the linear memories, the globals, the tables and the dropped
+ * data/element segments of the module instance to the snapshot file
+ */
+bool
+wasm_instance_snapshot_save(WASMModuleInstanceCommon *module_inst,
+                            const char *file_path, char *error_buf,
+                            uint32 error_buf_size);
+
+/**
+ * Open the snapshot file and read its header and instance state except
+ * the linear memory data, which is read or mapped when restoring
+ */
+WASMInstanceSnapshot *
+wasm_instance_snapshot_open(const char *file_path, char *error_buf,
+                            uint32 error_buf_size);
+
+void
+wasm_instance_snapshot_close(WASMInstanceSnapshot *snapshot);
+
+/**
+ * Restore the state of a newly created module instance from the snapshot,
+ * it is called by the instantiation instead of initializing the linear
+ * memories with the data segments and executing the start function
+ */
+bool
+wasm_instance_snapshot_restore(WASMModuleInstanceCommon *module_inst,
+                               const WASMInstanceSnapshot *snapshot,
+                               char *error_buf, uint32 error_buf_size);
+
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_INSTANCE_SNAPSHOT_H */
@@ -69,6 +69,38 @@ static void (*free_func)(
 
 static unsigned int global_pool_size;
 
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MEM_DISCARD) \
+    && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define WASM_ENABLE_LINEAR_MEMORY_POOL 1
+
+/* Reserved address range of a linear memory in the pool, its first
+   rw_size bytes are readable and writable, the rest is inaccessible */
+typedef struct LinearMemorySlot {
+    uint8 *base;
+    uint64 rw_size;
+#if WASM_ENABLE_MEMORY_IMAGE != 0 || WASM_ENABLE_INSTANCE_RESET != 0
+    /* Size of the memory image mapped at the beginning of the slot,
+       discarding its pages would bring back the content of the image */
+    uint64 image_size;
+#endif
+    struct LinearMemorySlot *next_free;
+} LinearMemorySlot;
+
+/* The slots are sorted by base address */
+static LinearMemorySlot *linear_memory_slots = NULL;
+static uint32 linear_memory_slot_count = 0;
+static LinearMemorySlot *linear_memory_free_slots = NULL;
+static korp_mutex linear_memory_pool_lock;
+#endif
+
+#if WASM_ENABLE_LAZY_LINEAR_MEMORY != 0
+/* The pages of linear memories are backed by physical memory only when
+   they are touched, growing a memory doesn't reserve swap space */
+#define LINEAR_MEMORY_MAP_FLAGS MMAP_MAP_NORESERVE
+#else
+#define LINEAR_MEMORY_MAP_FLAGS MMAP_MAP_NONE
+#endif
+
 static uint64
 align_as_and_cast(uint64 size, uint64 alignment)
 {
@@ -83,6 +115,10 @@ wasm_memory_init_with_pool(void *mem, unsigned int bytes)
     mem_allocator_t allocator = mem_allocator_create(mem, bytes);
 
     if (allocator) {
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+        if (!mem_allocator_enable_thread_cache(allocator))
+            LOG_WARNING("Enable thread caches of the global heap failed.\n");
+#endif
         memory_mode = MEMORY_MODE_POOL;
         pool_allocator = allocator;
         global_pool_size = bytes;
@@ -1571,8 +1607,8 @@ wasm_mremap_linear_memory(void *mapped_mem, uint64 old_size, uint64 new_size,
         new_mem = os_mremap(mapped_mem, old_size, new_size);
     }
     else {
-        new_mem = os_mmap(NULL, new_size, MMAP_PROT_NONE, MMAP_MAP_NONE,
-                          os_get_invalid_handle());
+        new_mem = os_mmap(NULL, new_size, MMAP_PROT_NONE,
+                          LINEAR_MEMORY_MAP_FLAGS, os_get_invalid_handle());
     }
     if (!new_mem) {
         return NULL;
@@ -1947,6 +1983,105 @@ wasm_memory_get_base_address(WASMMemoryInstance *memory)
     return memory->memory_data;
 }
 
+uint64
+wasm_memory_get_resident_size(WASMMemoryInstance *memory)
+{
+    uint64 resident_size;
+
+    SHARED_MEMORY_LOCK(memory);
+    /* all pages are considered resident if it can't be queried */
+    resident_size = memory->memory_data_size;
+#if defined(OS_ENABLE_MEM_RESIDENT_INFO) && WASM_MEM_ALLOC_WITH_USAGE == 0
+    if (memory->memory_data && memory->memory_data_size > 0
+        && os_mem_get_resident_size(memory->memory_data,
+                                    (size_t)memory->memory_data_size,
+                                    &resident_size)
+               != 0) {
+        resident_size = memory->memory_data_size;
+    }
+#endif
+    SHARED_MEMORY_UNLOCK(memory);
+
+    return resident_size;
+}
+
+static uint64
+get_linear_memory_reserved_size(const WASMMemoryInstance *memory)
+{
+    if (!memory->memory_data)
+        return 0;
+
+#if WASM_MEM_ALLOC_WITH_USAGE != 0
+    return memory->memory_data_size;
+#elif defined(OS_ENABLE_HW_BOUND_CHECK)
+    return 8 * (uint64)BH_GB;
+#else
+#if WASM_ENABLE_SHARED_MEMORY != 0
+    if (memory->is_shared_memory)
+        return (uint64)memory->num_bytes_per_page * memory->max_page_count;
+#endif
+    return memory->memory_data_size;
+#endif
+}
+
+bool
+wasm_runtime_get_module_inst_mem_usage(
+    WASMModuleInstanceCommon *module_inst_comm, module_inst_mem_usage_t *usage)
+{
+    WASMModuleInstance *module_inst = (WASMModuleInstance *)module_inst_comm;
+    WASMMemoryInstance *memory;
+    mem_alloc_info_t heap_info;
+    uint64 memory_data_size, peak_size;
+#if WASM_ENABLE_GC != 0
+    void *gc_heap_handle;
+#endif
+    uint32 i;
+
+    if (module_inst_comm->module_type != Wasm_Module_Bytecode
+        && module_inst_comm->module_type != Wasm_Module_AoT)
+        return false;
+
+    memset(usage, 0, sizeof(module_inst_mem_usage_t));
+
+    for (i = 0; i < module_inst->memory_count; i++) {
+        memory = module_inst->memories[i];
+        memory_data_size = GET_LINEAR_MEMORY_SIZE(memory);
+        peak_size = (uint64)memory->num_bytes_per_page
+                    * memory->peak_page_count;
+
+        usage->linear_memory_size += memory_data_size;
+        usage->linear_memory_peak_size +=
+            peak_size > memory_data_size ? peak_size : memory_data_size;
+        usage->linear_memory_committed_size +=
+            wasm_memory_get_resident_size(memory);
+        usage->linear_memory_reserved_size +=
+            get_linear_memory_reserved_size(memory);
+
+        if (memory->heap_handle
+            && mem_allocator_get_alloc_info(memory->heap_handle, &heap_info)) {
+            usage->app_heap_size += heap_info.total_size;
+            usage->app_heap_used_size +=
+                heap_info.total_size - heap_info.total_free_size;
+            usage->app_heap_peak_used_size += heap_info.highmark_size;
+        }
+    }
+
+#if WASM_ENABLE_GC != 0
+    if ((gc_heap_handle = wasm_runtime_get_gc_heap_handle(module_inst_comm))
+        && mem_allocator_get_alloc_info(gc_heap_handle, &heap_info)) {
+        usage->gc_heap_size = heap_info.total_size;
+        usage->gc_heap_used_size =
+            heap_info.total_size - heap_info.total_free_size;
+        usage->gc_heap_peak_used_size = heap_info.highmark_size;
+        mem_allocator_get_gc_stats(
+            gc_heap_handle, &usage->gc_count, &usage->gc_pause_count,
+            &usage->gc_max_pause_time, &usage->gc_total_pause_time);
+    }
+#endif
+
+    return true;
+}
+
 bool
 wasm_memory_enlarge(WASMMemoryInstance *memory, uint64 inc_page_count)
 {
@@ -1966,14 +2101,363 @@ wasm_memory_enlarge(WASMMemoryInstance *memory, uint64 inc_page_count)
     return ret;
 }
 
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+static int
+linear_memory_slot_cmp(const void *a, const void *b)
+{
+    uint8 *base_a = ((const LinearMemorySlot *)a)->base;
+    uint8 *base_b = ((const LinearMemorySlot *)b)->base;
+
+    return base_a < base_b ? -1 : (base_a > base_b ? 1 : 0);
+}
+
+static LinearMemorySlot *
+linear_memory_pool_lookup(const uint8 *data)
+{
+    LinearMemorySlot key = { 0 };
+
+    if (!linear_memory_slots)
+        return NULL;
+
+    key.base = (uint8 *)data;
+    return bsearch(&key, linear_memory_slots, linear_memory_slot_count,
+                   sizeof(LinearMemorySlot), linear_memory_slot_cmp);
+}
+
+static uint8 *
+linear_memory_pool_acquire(uint64 commit_size)
+{
+    LinearMemorySlot *slot;
+    int ret = 0;
+
+    if (!linear_memory_slots)
+        return NULL;
+
+    os_mutex_lock(&linear_memory_pool_lock);
+    if ((slot = linear_memory_free_slots)) {
+        linear_memory_free_slots = slot->next_free;
+        slot->next_free = NULL;
+    }
+    os_mutex_unlock(&linear_memory_pool_lock);
+
+    if (!slot)
+        return NULL;
+
+    /* The slot was discarded when it was released, only adjust the
+       accessible range to the size of the new linear memory */
+    if (commit_size > slot->rw_size) {
+        ret = os_mprotect(slot->base + slot->rw_size,
+                          commit_size - slot->rw_size,
+                          MMAP_PROT_READ | MMAP_PROT_WRITE);
+    }
+    else if (commit_size < slot->rw_size) {
+        ret = os_mprotect(slot->base + commit_size,
+                          slot->rw_size - commit_size, MMAP_PROT_NONE);
+    }
+
+    if (ret != 0) {
+        os_mutex_lock(&linear_memory_pool_lock);
+        slot->next_free = linear_memory_free_slots;
+        linear_memory_free_slots = slot;
+        os_mutex_unlock(&linear_memory_pool_lock);
+        return NULL;
+    }
+
+    slot->rw_size = commit_size;
+    return slot->base;
+}
+
+static void
+linear_memory_pool_release(LinearMemorySlot *slot, uint64 memory_data_size)
+{
+    uint64 discard_offset = 0;
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0 || WASM_ENABLE_INSTANCE_RESET != 0
+    if (slot->image_size > 0) {
+        /* Replace the mapping of the memory image with anonymous pages,
+           the slot is left out of the pool if it fails */
+        if (os_mmap(slot->base, slot->image_size,
+                    MMAP_PROT_READ | MMAP_PROT_WRITE,
+                    MMAP_MAP_FIXED | LINEAR_MEMORY_MAP_FLAGS,
+                    os_get_invalid_handle())
+            != slot->base) {
+            LOG_WARNING("reset memory image of linear memory pool slot "
+                        "failed");
+            return;
+        }
+        discard_offset = slot->image_size;
+        slot->image_size = 0;
+    }
+#endif
+
+    /* Drop the pages so that the next instance gets a zeroed memory
+       without paying for a new mapping */
+    if (memory_data_size > discard_offset
+        && os_mem_discard(slot->base + discard_offset,
+                          memory_data_size - discard_offset)
+               != 0) {
+        memset(slot->base + discard_offset, 0,
+               memory_data_size - discard_offset);
+    }
+    slot->rw_size = memory_data_size;
+
+    os_mutex_lock(&linear_memory_pool_lock);
+    slot->next_free = linear_memory_free_slots;
+    linear_memory_free_slots = slot;
+    os_mutex_unlock(&linear_memory_pool_lock);
+}
+#endif /* end of WASM_ENABLE_LINEAR_MEMORY_POOL != 0 */
+
+bool
+wasm_linear_memory_pool_init(uint32 slot_count)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    uint64 map_size = 8 * (uint64)BH_GB, total_size;
+    uint32 i;
+
+    bh_assert(!linear_memory_slots);
+
+    if (slot_count == 0)
+        return true;
+
+    total_size = sizeof(LinearMemorySlot) * (uint64)slot_count;
+    if (total_size >= UINT32_MAX
+        || !(linear_memory_slots = wasm_runtime_malloc((uint32)total_size))) {
+        LOG_ERROR("allocate linear memory pool slots failed");
+        return false;
+    }
+    memset(linear_memory_slots, 0, (uint32)total_size);
+
+    if (os_mutex_init(&linear_memory_pool_lock) != 0) {
+        wasm_runtime_free(linear_memory_slots);
+        linear_memory_slots = NULL;
+        return false;
+    }
+
+    for (i = 0; i < slot_count; i++) {
+        if (!(linear_memory_slots[i].base =
+                  os_mmap(NULL, map_size, MMAP_PROT_NONE,
+                          LINEAR_MEMORY_MAP_FLAGS, os_get_invalid_handle()))) {
+            LOG_ERROR("reserve linear memory pool slot %" PRIu32 " failed", i);
+            linear_memory_slot_count = i;
+            wasm_linear_memory_pool_destroy();
+            return false;
+        }
+    }
+    linear_memory_slot_count = slot_count;
+
+    qsort(linear_memory_slots, slot_count, sizeof(LinearMemorySlot),
+          linear_memory_slot_cmp);
+    for (i = 0; i < slot_count; i++) {
+        linear_memory_slots[i].next_free =
+            i + 1 < slot_count ? &linear_memory_slots[i + 1] : NULL;
+    }
+    linear_memory_free_slots = linear_memory_slots;
+
+    LOG_VERBOSE("Reserved %" PRIu32 " linear memory pool slots.", slot_count);
+    return true;
+#else
+    if (slot_count > 0) {
+        LOG_WARNING("linear memory pool isn't supported by the current "
+                    "platform or build options, ignore it");
+    }
+    return true;
+#endif
+}
+
+void
+wasm_linear_memory_pool_destroy(void)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    uint32 i;
+
+    if (!linear_memory_slots)
+        return;
+
+    for (i = 0; i < linear_memory_slot_count; i++) {
+        if (linear_memory_slots[i].base)
+            os_munmap(linear_memory_slots[i].base, 8 * (uint64)BH_GB);
+    }
+    os_mutex_destroy(&linear_memory_pool_lock);
+    wasm_runtime_free(linear_memory_slots);
+    linear_memory_slots = NULL;
+    linear_memory_slot_count = 0;
+    linear_memory_free_slots = NULL;
+#endif
+}
+
+bool
+wasm_linear_memory_pool_contains(const uint8 *data)
+{
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    return linear_memory_pool_lookup(data) != NULL;
+#else
+    (void)data;
+    return false;
+#endif
+}
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0 || WASM_ENABLE_INSTANCE_RESET != 0
+#if defined(OS_ENABLE_MEMORY_FILE) && defined(OS_ENABLE_FILE_MAPPING) \
+    && defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+/* The image can only be mapped over the reserved space of the linear
+   memory, as a linear memory made up of several mappings can't be
+   remapped when it is enlarged */
+#define MEMORY_IMAGE_SUPPORTED 1
+#endif
+
+WASMMemoryImage *
+wasm_memory_image_create(uint64 data_end)
+{
+#ifdef MEMORY_IMAGE_SUPPORTED
+    WASMMemoryImage *image;
+    uint64 page_size = os_getpagesize();
+
+    if (!(image = wasm_runtime_malloc(sizeof(WASMMemoryImage)))) {
+        return NULL;
+    }
+
+    image->data_end = data_end;
+    image->size = align_as_and_cast(data_end, page_size);
+    image->file = os_memory_file_create("wasm-memory-image", image->size);
+    if (image->file == os_get_invalid_handle()) {
+        LOG_WARNING("create memory image failed");
+        wasm_runtime_free(image);
+        return NULL;
+    }
+
+    return image;
+#else
+    (void)data_end;
+    return NULL;
+#endif
+}
+
+bool
+wasm_memory_image_write(WASMMemoryImage *image, uint64 offset,
+                        const uint8 *data, uint32 length)
+{
+#ifdef MEMORY_IMAGE_SUPPORTED
+    bh_assert(offset + length <= image->data_end);
+    return length == 0
+           || os_memory_file_write(image->file, offset, data, length) == 0;
+#else
+    (void)image;
+    (void)offset;
+    (void)data;
+    (void)length;
+    return false;
+#endif
+}
+
+void
+wasm_memory_image_destroy(WASMMemoryImage *image)
+{
+#ifdef MEMORY_IMAGE_SUPPORTED
+    os_file_close_for_mapping(image->file);
+#endif
+    wasm_runtime_free(image);
+}
+
+bool
+wasm_memory_image_map(WASMMemoryInstance *memory,
+                      const WASMMemoryImage *image)
+{
+#ifdef MEMORY_IMAGE_SUPPORTED
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    LinearMemorySlot *slot;
+#endif
+
+    bh_assert(memory->memory_data);
+    bh_assert(image->size <= memory->memory_data_size);
+
+    if (os_mmap_file(memory->memory_data, (size_t)image->size,
+                     MMAP_PROT_READ | MMAP_PROT_WRITE,
+                     MMAP_MAP_FIXED | LINEAR_MEMORY_MAP_FLAGS, image->file, 0)
+        != memory->memory_data) {
+        return false;
+    }
+
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    if ((slot = linear_memory_pool_lookup(memory->memory_data))
+        && slot->image_size < image->size) {
+        slot->image_size = image->size;
+    }
+#endif
+    return true;
+#else
+    (void)memory;
+    (void)image;
+    return false;
+#endif
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 \
+          || WASM_ENABLE_INSTANCE_RESET != 0 */
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+bool
+wasm_shrink_linear_memory(WASMMemoryInstance *memory, uint32 page_count)
+{
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+    uint64 total_size_old = memory->memory_data_size;
+    uint64 total_size_new = memory->num_bytes_per_page * (uint64)page_count;
+    uint8 *shrunk_data = memory->memory_data + total_size_new;
+
+    bh_assert(page_count <= memory->cur_page_count);
+
+    if (total_size_new == total_size_old)
+        return true;
+
+    if (memory->peak_page_count < memory->cur_page_count)
+        memory->peak_page_count = memory->cur_page_count;
+
+    /* Drop the pages so that they are zeroed if the linear memory is
+       enlarged again, the space stays reserved */
+#ifdef OS_ENABLE_MEM_DISCARD
+    if (os_mem_discard(shrunk_data, total_size_old - total_size_new) != 0)
+#endif
+        memset(shrunk_data, 0, total_size_old - total_size_new);
+
+    if (os_mprotect(shrunk_data, total_size_old - total_size_new,
+                    MMAP_PROT_NONE)
+        != 0) {
+        return false;
+    }
+#ifdef BH_PLATFORM_WINDOWS
+    os_mem_decommit(shrunk_data, total_size_old - total_size_new);
+#endif
+
+    memory->cur_page_count = page_count;
+    SET_LINEAR_MEMORY_SIZE(memory, total_size_new);
+    memory->memory_data_end = shrunk_data;
+
+    wasm_runtime_set_mem_bound_check_bytes(memory, total_size_new);
+    return true;
+#else
+    return memory->cur_page_count == page_count;
+#endif
+}
+#endif /* end of WASM_ENABLE_INSTANCE_RESET != 0 */
+
 void
 wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst)
 {
     uint64 map_size;
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    LinearMemorySlot *slot;
+#endif
 
     bh_assert(memory_inst);
     bh_assert(memory_inst->memory_data);
 
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+    if ((slot = linear_memory_pool_lookup(memory_inst->memory_data))) {
+        linear_memory_pool_release(slot, memory_inst->memory_data_size);
+        memory_inst->memory_data = NULL;
+        return;
+    }
+#endif
+
 #ifndef OS_ENABLE_HW_BOUND_CHECK
 #if WASM_ENABLE_SHARED_MEMORY != 0
     if (shared_memory_is_shared(memory_inst)) {
@@ -2053,7 +2537,16 @@ wasm_allocate_linear_memory(uint8 **data, bool is_shared_memory,
             return BHT_ERROR;
         }
 #else
-        if (!(*data = wasm_mmap_linear_memory(map_size, *memory_data_size))) {
+        *data = NULL;
+#if WASM_ENABLE_LINEAR_MEMORY_POOL != 0
+        /* Shared memories may outlive the instance, so they aren't
+           taken from the pool */
+        if (!is_shared_memory)
+            *data = linear_memory_pool_acquire(*memory_data_size);
+#endif
+        if (!*data
+            && !(*data =
+                     wasm_mmap_linear_memory(map_size, *memory_data_size))) {
             return BHT_ERROR;
         }
 #endif
@@ -141,6 +141,69 @@ void
 wasm_runtime_set_enlarge_mem_error_callback(
     const enlarge_memory_error_callback_t callback, void *user_data);
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0 || WASM_ENABLE_INSTANCE_RESET != 0
+/* The data segments of the default memory written once into an
+   in-memory file by the loader, which is mapped privately over the
+   linear memory on instantiation instead of copying the segments, or
+   the linear memory data saved as the reset point of an instance */
+typedef struct WASMMemoryImage {
+    os_file_handle file;
+    /* Size of the image, aligned to the page size */
+    uint64 size;
+    /* End offset of the last byte of the data segments */
+    uint64 data_end;
+} WASMMemoryImage;
+
+/**
+ * Create an empty memory image covering the range 0 to data_end of the
+ * linear memory, return NULL if memory images aren't supported
+ */
+WASMMemoryImage *
+wasm_memory_image_create(uint64 data_end);
+
+bool
+wasm_memory_image_write(WASMMemoryImage *image, uint64 offset,
+                        const uint8 *data, uint32 length);
+
+void
+wasm_memory_image_destroy(WASMMemoryImage *image);
+
+/**
+ * Map the image over the beginning of the linear memory, the pages are
+ * shared between the instances until they are written, and the pages
+ * written before are dropped
+ */
+bool
+wasm_memory_image_map(WASMMemoryInstance *memory,
+                      const WASMMemoryImage *image);
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 \
+          || WASM_ENABLE_INSTANCE_RESET != 0 */
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+/**
+ * Shrink the linear memory to page_count pages, the pages removed are
+ * discarded, return false if the linear memory isn't reserved with mmap
+ * and can't be shrunk in place
+ */
+bool
+wasm_shrink_linear_memory(WASMMemoryInstance *memory, uint32 page_count);
+#endif
+
+/**
+ * Reserve the address ranges of slot_count linear memories, the linear
+ * memories of the instances are then taken from the pool when possible
+ * and their pages are discarded instead of unmapped on deinstantiation
+ */
+bool
+wasm_linear_memory_pool_init(uint32 slot_count);
+
+void
+wasm_linear_memory_pool_destroy(void);
+
+/* Whether the linear memory data was allocated from the pool */
+bool
+wasm_linear_memory_pool_contains(const uint8 *data);
+
 void
 wasm_deallocate_linear_memory(WASMMemoryInstance *memory_inst);
 
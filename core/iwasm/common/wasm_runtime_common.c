@@ -31,6 +31,12 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+#include "wasm_instance_snapshot.h"
+#endif
+#if WASM_ENABLE_INSTANCE_RESET != 0
+#include "wasm_instance_reset.h"
+#endif
 #if WASM_ENABLE_FAST_JIT != 0
 #include "../fast-jit/jit_compiler.h"
 #endif
@@ -166,13 +172,21 @@ static JitCompOptions jit_options = { 0 };
 #if WASM_ENABLE_JIT != 0
 /* opt_level: 3, size_level: 3, segue-flags: 0,
    quick_invoke_c_api_import: false */
-static LLVMJITOptions llvm_jit_options = { 3, 3, 0, false };
+static LLVMJITOptions llvm_jit_options = { 3, 3, 0, false, NULL };
 #endif
 
 #if WASM_ENABLE_GC != 0
 static uint32 gc_heap_size_default = GC_HEAP_SIZE_DEFAULT;
 #endif
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+static const char *fast_interp_cache_dir = NULL;
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+static uint32 loader_thread_num = WASM_PARALLEL_LOADER_THREAD_NUM;
+#endif
+
 static RunningMode runtime_running_mode = Mode_Default;
 
 #ifdef OS_ENABLE_HW_BOUND_CHECK
@@ -224,7 +238,7 @@ is_sig_addr_in_guard_pages(void *sig_addr, WASMModuleInstance *module_inst)
 }
 
 #ifndef BH_PLATFORM_WINDOWS
-static void
+static bool
 runtime_signal_handler(void *sig_addr)
 {
     WASMModuleInstance *module_inst;
@@ -235,6 +249,13 @@ runtime_signal_handler(void *sig_addr)
     uint32 guard_page_count = STACK_OVERFLOW_CHECK_GUARD_PAGE_COUNT;
 #endif
 
+#if WASM_ENABLE_AOT != 0 && defined(AOT_LAZY_TEXT_RELOCATION)
+    /* The AOT code page whose relocations are deferred is executed
+       for the first time */
+    if (aot_apply_lazy_text_relocations(sig_addr))
+        return true;
+#endif
+
     /* Check whether current thread is running wasm function */
     if (exec_env_tls && exec_env_tls->handle == os_self_thread()
         && (jmpbuf_node = exec_env_tls->jmpbuf_stack_top)) {
@@ -267,6 +288,7 @@ runtime_signal_handler(void *sig_addr)
             os_longjmp(jmpbuf_node->jmpbuf, 1);
         }
     }
+    return false;
 }
 #else /* else of BH_PLATFORM_WINDOWS */
 
@@ -695,6 +717,7 @@ wasm_runtime_destroy_internal(void)
 #endif
 
     wasm_native_destroy();
+    wasm_linear_memory_pool_destroy();
     bh_platform_destroy();
 
     wasm_runtime_memory_destroy();
@@ -740,6 +763,22 @@ wasm_runtime_get_gc_heap_size_default(void)
 }
 #endif
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+const char *
+wasm_runtime_get_fast_interp_cache_dir(void)
+{
+    return fast_interp_cache_dir;
+}
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+uint32
+wasm_runtime_get_loader_thread_num(void)
+{
+    return loader_thread_num;
+}
+#endif
+
 static bool
 wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 {
@@ -754,6 +793,9 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
 
 #if WASM_ENABLE_FAST_JIT != 0
     jit_options.code_cache_size = init_args->fast_jit_code_cache_size;
+    jit_options.opt_level = init_args->fast_jit_opt_level;
+    jit_options.regalloc = init_args->fast_jit_regalloc;
+    jit_options.tierup_threshold = init_args->fast_jit_tierup_threshold;
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -767,6 +809,24 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
     llvm_jit_options.size_level = init_args->llvm_jit_size_level;
     llvm_jit_options.opt_level = init_args->llvm_jit_opt_level;
     llvm_jit_options.segue_flags = init_args->segue_flags;
+    llvm_jit_options.cache_dir = init_args->llvm_jit_cache_dir;
+#endif
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    fast_interp_cache_dir = init_args->fast_interp_cache_dir;
+#else
+    if (init_args->fast_interp_cache_dir)
+        LOG_WARNING("warning: to enable fast interpreter code cache, please "
+                    "recompile with -DWAMR_BUILD_FAST_INTERP_CACHE=1");
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    if (init_args->loader_thread_num > 0)
+        loader_thread_num = init_args->loader_thread_num;
+#else
+    if (init_args->loader_thread_num > 1)
+        LOG_WARNING("warning: to enable parallel loader, please recompile "
+                    "with -DWAMR_BUILD_PARALLEL_LOADER=1");
 #endif
 
 #if WASM_ENABLE_LINUX_PERF != 0
@@ -782,6 +842,12 @@ wasm_runtime_full_init_internal(RuntimeInitArgs *init_args)
         return false;
     }
 
+    if (!wasm_linear_memory_pool_init(
+            init_args->linear_memory_pool_slot_count)) {
+        wasm_runtime_destroy_internal();
+        return false;
+    }
+
 #if WASM_ENABLE_DEBUG_INTERP != 0
     if (strlen(init_args->ip_addr))
         if (!wasm_debug_engine_init(init_args->ip_addr,
@@ -1530,6 +1596,38 @@ wasm_runtime_load(uint8 *buf, uint32 size, char *error_buf,
     return wasm_runtime_load_ex(buf, size, &args, error_buf, error_buf_size);
 }
 
+WASMModuleCommon *
+wasm_runtime_load_from_mapped_file(const char *file_path, const LoadArgs *args,
+                                   char *error_buf, uint32 error_buf_size)
+{
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+    WASMModuleCommon *module_common;
+
+    if (!args) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: null load arguments");
+        return NULL;
+    }
+
+    module_common = (WASMModuleCommon *)aot_load_from_mapped_file(
+        file_path, args, error_buf, error_buf_size);
+    if (!module_common) {
+        LOG_DEBUG("WASM module load failed from mapped file");
+        return NULL;
+    }
+
+    return register_module_with_null_name(module_common, error_buf,
+                                          error_buf_size);
+#else
+    (void)file_path;
+    (void)args;
+    set_error_buf(error_buf, error_buf_size,
+                  "WASM module load failed: "
+                  "loading from mapped file isn't supported");
+    return NULL;
+#endif
+}
+
 WASMModuleCommon *
 wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
                                 char *error_buf, uint32 error_buf_size)
@@ -1570,6 +1668,58 @@ wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
 #endif
 }
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+wasm_module_stream_t
+wasm_runtime_stream_load_begin(const LoadArgs *args, char *error_buf,
+                               uint32 error_buf_size)
+{
+    if (!args) {
+        set_error_buf(error_buf, error_buf_size,
+                      "WASM module load failed: null load arguments");
+        return NULL;
+    }
+
+    return wasm_stream_load_begin(args, error_buf, error_buf_size);
+}
+
+bool
+wasm_runtime_stream_load_feed(wasm_module_stream_t stream, const uint8 *buf,
+                              uint32 size, char *error_buf,
+                              uint32 error_buf_size)
+{
+    return wasm_stream_load_feed(stream, buf, size, error_buf,
+                                 error_buf_size);
+}
+
+WASMModuleCommon *
+wasm_runtime_stream_load_finish(wasm_module_stream_t stream, char *error_buf,
+                                uint32 error_buf_size)
+{
+    WASMModule *module;
+
+    module = wasm_stream_load_finish(stream,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                                     true,
+#endif
+                                     error_buf, error_buf_size);
+    if (!module) {
+        LOG_DEBUG("WASM module load failed from stream");
+        return NULL;
+    }
+
+    /* The module refers to the sections received only */
+    module->is_binary_freeable = true;
+    return register_module_with_null_name((WASMModuleCommon *)module,
+                                          error_buf, error_buf_size);
+}
+
+void
+wasm_runtime_stream_load_abort(wasm_module_stream_t stream)
+{
+    wasm_stream_load_abort(stream);
+}
+#endif /* end of WASM_ENABLE_STREAM_LOADER != 0 */
+
 void
 wasm_runtime_unload(WASMModuleCommon *module)
 {
@@ -1804,6 +1954,61 @@ wasm_runtime_instantiate_ex2(WASMModuleCommon *module,
                                              error_buf, error_buf_size);
 }
 
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+bool
+wasm_runtime_snapshot_instance(WASMModuleInstanceCommon *module_inst,
+                               const char *file_path, char *error_buf,
+                               uint32 error_buf_size)
+{
+    return wasm_instance_snapshot_save(module_inst, file_path, error_buf,
+                                       error_buf_size);
+}
+
+WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(WASMModuleCommon *module,
+                                       const struct InstantiationArgs2 *args,
+                                       const char *file_path, char *error_buf,
+                                       uint32 error_buf_size)
+{
+    struct InstantiationArgs2 snapshot_args;
+    WASMInstanceSnapshot *snapshot;
+    WASMModuleInstanceCommon *module_inst;
+
+    if (args)
+        snapshot_args = *args;
+    else
+        wasm_runtime_instantiation_args_set_defaults(&snapshot_args);
+
+    if (!(snapshot = wasm_instance_snapshot_open(file_path, error_buf,
+                                                 error_buf_size)))
+        return NULL;
+
+    snapshot_args.snapshot = snapshot;
+    module_inst = wasm_runtime_instantiate_internal(
+        module, NULL, NULL, &snapshot_args, error_buf, error_buf_size);
+
+    wasm_instance_snapshot_close(snapshot);
+    return module_inst;
+}
+#endif /* end of WASM_ENABLE_INSTANCE_SNAPSHOT != 0 */
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+bool
+wasm_runtime_set_instance_reset_point(WASMModuleInstanceCommon *module_inst,
+                                      char *error_buf, uint32 error_buf_size)
+{
+    return wasm_instance_reset_save(module_inst, error_buf, error_buf_size);
+}
+
+bool
+wasm_runtime_reset_instance(WASMModuleInstanceCommon *module_inst,
+                            char *error_buf, uint32 error_buf_size)
+{
+    return wasm_instance_reset_restore(module_inst, error_buf,
+                                       error_buf_size);
+}
+#endif /* end of WASM_ENABLE_INSTANCE_RESET != 0 */
+
 void
 wasm_runtime_deinstantiate_internal(WASMModuleInstanceCommon *module_inst,
                                     bool is_sub_inst)
@@ -589,6 +589,7 @@ typedef struct LLVMJITOptions {
     uint32 size_level;
     uint32 segue_flags;
     bool quick_invoke_c_api_import;
+    const char *cache_dir;
 } LLVMJITOptions;
 #endif
 
@@ -617,6 +618,11 @@ struct InstantiationArgs2 {
 #if WASM_ENABLE_LIBC_WASI != 0
     WASIArguments wasi;
 #endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* Restore the main instance from the snapshot instead of initializing
+       the linear memory and executing the start function */
+    const struct WASMInstanceSnapshot *snapshot;
+#endif
 };
 
 void
@@ -642,6 +648,18 @@ uint32
 wasm_runtime_get_gc_heap_size_default(void);
 #endif
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+/* Internal API */
+const char *
+wasm_runtime_get_fast_interp_cache_dir(void);
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+/* Internal API */
+uint32
+wasm_runtime_get_loader_thread_num(void);
+#endif
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_full_init(RuntimeInitArgs *init_args);
@@ -671,11 +689,36 @@ WASM_RUNTIME_API_EXTERN WASMModuleCommon *
 wasm_runtime_load(uint8 *buf, uint32 size, char *error_buf,
                   uint32 error_buf_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleCommon *
+wasm_runtime_load_from_mapped_file(const char *file_path, const LoadArgs *args,
+                                   char *error_buf, uint32 error_buf_size);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN WASMModuleCommon *
 wasm_runtime_load_from_sections(WASMSection *section_list, bool is_aot,
                                 char *error_buf, uint32 error_buf_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN wasm_module_stream_t
+wasm_runtime_stream_load_begin(const LoadArgs *args, char *error_buf,
+                               uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_stream_load_feed(wasm_module_stream_t stream, const uint8 *buf,
+                              uint32 size, char *error_buf,
+                              uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleCommon *
+wasm_runtime_stream_load_finish(wasm_module_stream_t stream, char *error_buf,
+                                uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_stream_load_abort(wasm_module_stream_t stream);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN void
 wasm_runtime_unload(WASMModuleCommon *module);
@@ -781,6 +824,29 @@ wasm_runtime_instantiate_ex2(WASMModuleCommon *module,
                              const struct InstantiationArgs2 *args,
                              char *error_buf, uint32 error_buf_size);
 
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_snapshot_instance(WASMModuleInstanceCommon *module_inst,
+                               const char *file_path, char *error_buf,
+                               uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN WASMModuleInstanceCommon *
+wasm_runtime_instantiate_from_snapshot(WASMModuleCommon *module,
+                                       const struct InstantiationArgs2 *args,
+                                       const char *file_path, char *error_buf,
+                                       uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_set_instance_reset_point(WASMModuleInstanceCommon *module_inst,
+                                      char *error_buf, uint32 error_buf_size);
+
+/* See wasm_export.h for description */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_reset_instance(WASMModuleInstanceCommon *module_inst,
+                            char *error_buf, uint32 error_buf_size);
+
 /* See wasm_export.h for description */
 WASM_RUNTIME_API_EXTERN bool
 wasm_runtime_set_running_mode(wasm_module_inst_t module_inst,
@@ -43,6 +43,10 @@
 #include "aot_emit_stringref.h"
 #endif
 
+#if WASM_ENABLE_JIT != 0
+#include "aot_jit_cache.h"
+#endif
+
 #define CHECK_BUF(buf, buf_end, length)                             \
     do {                                                            \
         if (buf + length > buf_end) {                               \
@@ -679,6 +683,8 @@ aot_gen_commit_sp_ip(AOTCompFrame *frame, bool commit_sp, bool commit_ip)
                 value = I32_CONST((uint32)(uintptr_t)(ip - module->load_addr));
         }
         else {
+            /* The bytecode address is only valid in current process */
+            comp_ctx->jit_code_uncacheable = true;
             if (is_64bit)
                 value = I64_CONST((uint64)(uintptr_t)ip);
             else
@@ -4047,6 +4053,19 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
         }
     }
 
+    if (comp_ctx->compile_thread_num > 1 || comp_ctx->func_cache_dir) {
+        bh_print_time("Begin to compile llvm module in partitions");
+        if (!aot_compile_llvm_module_partitions(comp_ctx)) {
+            return false;
+        }
+        if (comp_ctx->partition_count > 0) {
+            /* The object files of the partitions are merged when
+               emitting the AOT file */
+            bh_print_time("Finish compiling llvm module in partitions");
+            return true;
+        }
+    }
+
     /* Run IR optimization before feeding in ORCJIT and AOT codegen */
     if (comp_ctx->optimize) {
         /* Run passes for AOT/JIT mode.
@@ -4070,6 +4089,17 @@ aot_compile_wasm(AOTCompContext *comp_ctx)
         LLVMOrcJITDylibRef orc_main_dylib;
         LLVMOrcThreadSafeModuleRef orc_thread_safe_module;
 
+#if WASM_ENABLE_JIT != 0
+        if (comp_ctx->jit_cache_dir) {
+            /* Compile the whole module ahead, so that the machine code
+               can be saved to the JIT code cache */
+            if (!comp_ctx->jit_code_uncacheable)
+                return aot_jit_cache_emit(comp_ctx);
+            LOG_VERBOSE("JIT code isn't cacheable since it refers to "
+                        "addresses of current process");
+        }
+#endif
+
         orc_main_dylib = LLVMOrcLLLazyJITGetMainJITDylib(comp_ctx->orc_jit);
         if (!orc_main_dylib) {
             aot_set_last_error(
@@ -65,12 +65,21 @@ struct AOTObjectData {
     void *text_hot;
     uint32 text_hot_size;
 
+    /* offsets of text, text_unlikely and text_hot in the text section
+       of the AOT file */
+    uint32 text_base;
+    uint32 text_unlikely_base;
+    uint32 text_hot_base;
+
     /* literal data and size */
     void *literal;
     uint32 literal_size;
 
     AOTObjectDataSection *data_sections;
     uint32 data_sections_count;
+    /* offsets of the data sections in the merged data sections with
+       the same names, only used by the objects of partitions */
+    uint32 *data_section_bases;
 
     AOTObjectFunc *funcs;
     uint32 func_count;
@@ -82,6 +91,13 @@ struct AOTObjectData {
     const char *stack_sizes_section_name;
     uint32 stack_sizes_offset;
     uint32 *stack_sizes;
+
+    /* objects of the partitions of the module when it is compiled in
+       multiple threads, which are merged into this object */
+    AOTObjectData **partitions;
+    uint32 partition_count;
+    /* buffer of the merged text sections */
+    uint8 *text_buf;
 };
 
 #if 0
@@ -3273,6 +3289,11 @@ aot_resolve_text(AOTObjectData *obj_data)
         LLVMDisposeSectionIterator(sec_itr);
     }
 
+    /* text_unlikely and text_hot are emitted after text */
+    obj_data->text_base = 0;
+    obj_data->text_unlikely_base = align_uint(obj_data->text_size, 4);
+    obj_data->text_hot_base = obj_data->text_unlikely_base
+                              + align_uint(obj_data->text_unlikely_size, 4);
     return true;
 }
 
@@ -3741,28 +3762,55 @@ fail:
     return false;
 }
 
+/*
+ * Get the offset of the function symbol in the text section of the AOT file,
+ * *p_text_offset isn't set if the function isn't defined in the object,
+ * which happens when it is defined in another partition of the module.
+ */
 static bool
-aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+get_func_text_offset(AOTObjectData *obj_data, LLVMSymbolIteratorRef sym_itr,
+                     uint64 *p_text_offset)
+{
+    LLVMSectionIteratorRef contain_section;
+    char *contain_section_name;
+
+    if (!(contain_section =
+              LLVMObjectFileCopySectionIterator(obj_data->binary))) {
+        aot_set_last_error("llvm get section iterator failed.");
+        return false;
+    }
+    LLVMMoveToContainingSection(contain_section, sym_itr);
+    if (LLVMObjectFileIsSectionIteratorAtEnd(obj_data->binary,
+                                             contain_section)) {
+        LLVMDisposeSectionIterator(contain_section);
+        return true;
+    }
+    contain_section_name = (char *)LLVMGetSectionName(contain_section);
+
+    if (!strcmp(contain_section_name, ".text.unlikely.")
+        || !strcmp(contain_section_name, ".ltext.unlikely.")) {
+        *p_text_offset =
+            obj_data->text_unlikely_base + LLVMGetSymbolAddress(sym_itr);
+    }
+    else if (!strcmp(contain_section_name, ".text.hot.")
+             || !strcmp(contain_section_name, ".ltext.hot.")) {
+        *p_text_offset = obj_data->text_hot_base + LLVMGetSymbolAddress(sym_itr);
+    }
+    else {
+        *p_text_offset = obj_data->text_base + LLVMGetSymbolAddress(sym_itr);
+    }
+    LLVMDisposeSectionIterator(contain_section);
+    return true;
+}
+
+static bool
+aot_resolve_function_offsets(AOTObjectData *obj_data, AOTObjectFunc *funcs,
+                             uint32 func_count)
 {
     AOTObjectFunc *func;
     LLVMSymbolIteratorRef sym_itr;
     char *name, *prefix = AOT_FUNC_PREFIX;
-    uint32 func_index, total_size;
-
-    /* allocate memory for aot function */
-    obj_data->func_count = comp_ctx->comp_data->func_count;
-    if (obj_data->func_count) {
-        if ((comp_ctx->enable_stack_bound_check
-             || comp_ctx->enable_stack_estimation)
-            && !aot_resolve_stack_sizes(comp_ctx, obj_data))
-            return false;
-        total_size = (uint32)sizeof(AOTObjectFunc) * obj_data->func_count;
-        if (!(obj_data->funcs = wasm_runtime_malloc(total_size))) {
-            aot_set_last_error("allocate memory for functions failed.");
-            return false;
-        }
-        memset(obj_data->funcs, 0, total_size);
-    }
+    uint32 func_index;
 
     if (!(sym_itr = LLVMObjectFileCopySymbolIterator(obj_data->binary))) {
         aot_set_last_error("llvm get symbol iterator failed.");
@@ -3774,78 +3822,31 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
         if (name && str_starts_with(name, prefix)) {
             /* symbol aot_func#n */
             func_index = (uint32)atoi(name + strlen(prefix));
-            if (func_index < obj_data->func_count) {
-                LLVMSectionIteratorRef contain_section;
-                char *contain_section_name;
-
-                func = obj_data->funcs + func_index;
-                func->func_name = name;
+            if (func_index < func_count) {
+                uint64 text_offset = (uint64)-1;
 
-                if (!(contain_section = LLVMObjectFileCopySectionIterator(
-                          obj_data->binary))) {
-                    aot_set_last_error("llvm get section iterator failed.");
+                if (!get_func_text_offset(obj_data, sym_itr, &text_offset)) {
                     LLVMDisposeSymbolIterator(sym_itr);
                     return false;
                 }
-                LLVMMoveToContainingSection(contain_section, sym_itr);
-                contain_section_name =
-                    (char *)LLVMGetSectionName(contain_section);
-                LLVMDisposeSectionIterator(contain_section);
-
-                if (!strcmp(contain_section_name, ".text.unlikely.")
-                    || !strcmp(contain_section_name, ".ltext.unlikely.")) {
-                    func->text_offset = align_uint(obj_data->text_size, 4)
-                                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else if (!strcmp(contain_section_name, ".text.hot.")
-                         || !strcmp(contain_section_name, ".ltext.hot.")) {
-                    func->text_offset =
-                        align_uint(obj_data->text_size, 4)
-                        + align_uint(obj_data->text_unlikely_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else {
-                    func->text_offset = LLVMGetSymbolAddress(sym_itr);
+                if (text_offset != (uint64)-1) {
+                    func = funcs + func_index;
+                    func->func_name = name;
+                    func->text_offset = text_offset;
                 }
             }
         }
         else if (name && str_starts_with(name, AOT_FUNC_INTERNAL_PREFIX)) {
             /* symbol aot_func_internal#n */
             func_index = (uint32)atoi(name + strlen(AOT_FUNC_INTERNAL_PREFIX));
-            if (func_index < obj_data->func_count) {
-                LLVMSectionIteratorRef contain_section;
-                char *contain_section_name;
-
-                func = obj_data->funcs + func_index;
-
-                if (!(contain_section = LLVMObjectFileCopySectionIterator(
-                          obj_data->binary))) {
-                    aot_set_last_error("llvm get section iterator failed.");
+            if (func_index < func_count) {
+                func = funcs + func_index;
+                if (!get_func_text_offset(
+                        obj_data, sym_itr,
+                        &func->text_offset_of_aot_func_internal)) {
                     LLVMDisposeSymbolIterator(sym_itr);
                     return false;
                 }
-                LLVMMoveToContainingSection(contain_section, sym_itr);
-                contain_section_name =
-                    (char *)LLVMGetSectionName(contain_section);
-                LLVMDisposeSectionIterator(contain_section);
-
-                if (!strcmp(contain_section_name, ".text.unlikely.")
-                    || !strcmp(contain_section_name, ".ltext.unlikely.")) {
-                    func->text_offset_of_aot_func_internal =
-                        align_uint(obj_data->text_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else if (!strcmp(contain_section_name, ".text.hot.")
-                         || !strcmp(contain_section_name, ".ltext.hot.")) {
-                    func->text_offset_of_aot_func_internal =
-                        align_uint(obj_data->text_size, 4)
-                        + align_uint(obj_data->text_unlikely_size, 4)
-                        + LLVMGetSymbolAddress(sym_itr);
-                }
-                else {
-                    func->text_offset_of_aot_func_internal =
-                        LLVMGetSymbolAddress(sym_itr);
-                }
             }
         }
         LLVMMoveToNextSymbol(sym_itr);
@@ -3855,6 +3856,30 @@ aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
     return true;
 }
 
+static bool
+aot_resolve_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    uint32 total_size;
+
+    /* allocate memory for aot function */
+    obj_data->func_count = comp_ctx->comp_data->func_count;
+    if (obj_data->func_count) {
+        if ((comp_ctx->enable_stack_bound_check
+             || comp_ctx->enable_stack_estimation)
+            && !aot_resolve_stack_sizes(comp_ctx, obj_data))
+            return false;
+        total_size = (uint32)sizeof(AOTObjectFunc) * obj_data->func_count;
+        if (!(obj_data->funcs = wasm_runtime_malloc(total_size))) {
+            aot_set_last_error("allocate memory for functions failed.");
+            return false;
+        }
+        memset(obj_data->funcs, 0, total_size);
+    }
+
+    return aot_resolve_function_offsets(obj_data, obj_data->funcs,
+                                        obj_data->func_count);
+}
+
 static bool
 get_relocations_count(LLVMSectionIteratorRef sec_itr, uint32 *p_count)
 {
@@ -3877,6 +3902,23 @@ get_relocations_count(LLVMSectionIteratorRef sec_itr, uint32 *p_count)
     return true;
 }
 
+/* Get the offset of the data section of a partition in the merged data
+   section, return 0 if the object isn't a partition */
+static uint32
+get_data_section_base(const AOTObjectData *obj_data, const char *name)
+{
+    uint32 i;
+
+    if (!obj_data->data_section_bases)
+        return 0;
+
+    for (i = 0; i < obj_data->data_sections_count; i++) {
+        if (!strcmp(obj_data->data_sections[i].name, name))
+            return obj_data->data_section_bases[i];
+    }
+    return 0;
+}
+
 static bool
 aot_resolve_object_relocation_group(AOTObjectData *obj_data,
                                     AOTRelocationGroup *group,
@@ -3889,6 +3931,27 @@ aot_resolve_object_relocation_group(AOTObjectData *obj_data,
     bool is_binary_little_endian = is_little_endian_binary(obj_data);
     bool has_addend = str_starts_with(group->section_name, ".rela");
     uint8 *rela_content = NULL;
+    uint64 offset_base;
+
+    if (!strcmp(group->section_name, ".rela.text.unlikely.")
+        || !strcmp(group->section_name, ".rel.text.unlikely.")) {
+        offset_base = obj_data->text_unlikely_base;
+    }
+    else if (!strcmp(group->section_name, ".rela.text.hot.")
+             || !strcmp(group->section_name, ".rel.text.hot.")) {
+        offset_base = obj_data->text_hot_base;
+    }
+    else if (!strcmp(group->section_name, ".rela.text")
+             || !strcmp(group->section_name, ".rel.text")
+             || !strcmp(group->section_name, ".rela.ltext")
+             || !strcmp(group->section_name, ".rel.ltext")) {
+        offset_base = obj_data->text_base;
+    }
+    else {
+        /* relocations of a data section */
+        offset_base = get_data_section_base(
+            obj_data, group->section_name + (has_addend ? 5 : 4));
+    }
 
     /* calculate relocations count and allocate memory */
     if (!get_relocations_count(rel_sec, &group->relocation_count))
@@ -3959,27 +4022,7 @@ aot_resolve_object_relocation_group(AOTObjectData *obj_data,
         relocation->relocation_type = (uint32)type;
         relocation->symbol_name =
             LLVMGetSymbolNameAndUnDecorate(rel_sym, obj_data->target_info);
-        relocation->relocation_offset = offset;
-        if (!strcmp(group->section_name, ".rela.text.unlikely.")
-            || !strcmp(group->section_name, ".rel.text.unlikely.")) {
-            relocation->relocation_offset += align_uint(obj_data->text_size, 4);
-        }
-        else if (!strcmp(group->section_name, ".rela.text.hot.")
-                 || !strcmp(group->section_name, ".rel.text.hot.")) {
-            relocation->relocation_offset +=
-                align_uint(obj_data->text_size, 4)
-                + align_uint(obj_data->text_unlikely_size, 4);
-        }
-        if (!strcmp(relocation->symbol_name, ".text.unlikely.")) {
-            relocation->symbol_name = ".text";
-            relocation->relocation_addend += align_uint(obj_data->text_size, 4);
-        }
-        if (!strcmp(relocation->symbol_name, ".text.hot.")) {
-            relocation->symbol_name = ".text";
-            relocation->relocation_addend +=
-                align_uint(obj_data->text_size, 4)
-                + align_uint(obj_data->text_unlikely_size, 4);
-        }
+        relocation->relocation_offset = offset_base + offset;
 
         /*
          * Note: aot_stack_sizes_section_name section only contains
@@ -4090,6 +4133,26 @@ aot_resolve_object_relocation_group(AOTObjectData *obj_data,
             LLVMDisposeSectionIterator(contain_section);
         }
 
+        /* text_unlikely and text_hot are merged into text, and the
+           sections of a partition are placed at some offsets in the
+           merged sections */
+        if (!strcmp(relocation->symbol_name, ".text.unlikely.")) {
+            relocation->symbol_name = ".text";
+            relocation->relocation_addend += obj_data->text_unlikely_base;
+        }
+        else if (!strcmp(relocation->symbol_name, ".text.hot.")) {
+            relocation->symbol_name = ".text";
+            relocation->relocation_addend += obj_data->text_hot_base;
+        }
+        else if (!strcmp(relocation->symbol_name, ".text")
+                 || !strcmp(relocation->symbol_name, ".ltext")) {
+            relocation->relocation_addend += obj_data->text_base;
+        }
+        else {
+            relocation->relocation_addend +=
+                get_data_section_base(obj_data, relocation->symbol_name);
+        }
+
         LLVMDisposeSymbolIterator(rel_sym);
         LLVMMoveToNextRelocation(rel_itr);
         relocation++;
@@ -4356,9 +4419,424 @@ aot_obj_data_destroy(AOTObjectData *obj_data)
         destroy_relocation_symbol_list(&obj_data->symbol_list);
     if (obj_data->stack_sizes)
         wasm_runtime_free(obj_data->stack_sizes);
+    if (obj_data->data_section_bases)
+        wasm_runtime_free(obj_data->data_section_bases);
+    if (obj_data->text_buf)
+        wasm_runtime_free(obj_data->text_buf);
+    /* the merged object refers to the symbol and section names of
+       the partitions, destroy them at last */
+    if (obj_data->partitions) {
+        uint32 i;
+        for (i = 0; i < obj_data->partition_count; i++)
+            aot_obj_data_destroy(obj_data->partitions[i]);
+        wasm_runtime_free(obj_data->partitions);
+    }
     wasm_runtime_free(obj_data);
 }
 
+static void
+init_feature_flags(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    /* Create wasm feature flags form compile options */
+    obj_data->target_info.feature_flags = 0;
+    if (comp_ctx->enable_simd) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_SIMD_128BIT;
+    }
+    if (comp_ctx->enable_bulk_memory) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_BULK_MEMORY;
+    }
+    if (comp_ctx->enable_thread_mgr) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_MULTI_THREAD;
+    }
+    if (comp_ctx->enable_ref_types) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_REF_TYPES;
+    }
+    if (comp_ctx->enable_gc) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_GARBAGE_COLLECTION;
+    }
+    if (comp_ctx->enable_gc_write_barrier) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_GC_WRITE_BARRIER;
+    }
+    if (comp_ctx->aux_stack_frame_type == AOT_STACK_FRAME_TYPE_TINY) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_TINY_STACK_FRAME;
+    }
+    if (comp_ctx->call_stack_features.frame_per_function) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_PER_FUNCTION;
+    }
+    if (!comp_ctx->call_stack_features.func_idx) {
+        obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_NO_FUNC_IDX;
+    }
+}
+
+/* Alignment of the sections of a partition in the merged sections, it
+   shouldn't be less than the alignment of the sections in the object */
+#define PARTITION_SECTION_ALIGN 64
+
+static AOTObjectData *
+create_partition_obj_data(AOTCompContext *comp_ctx,
+                          LLVMMemoryBufferRef mem_buf)
+{
+    char *err = NULL;
+    AOTObjectData *obj_data;
+
+    if (!(obj_data = wasm_runtime_malloc(sizeof(AOTObjectData)))) {
+        LLVMDisposeMemoryBuffer(mem_buf);
+        aot_set_last_error("allocate memory failed.");
+        return NULL;
+    }
+    memset(obj_data, 0, sizeof(AOTObjectData));
+    obj_data->comp_ctx = comp_ctx;
+    obj_data->mem_buf = mem_buf;
+
+    if (!(obj_data->binary = LLVMCreateBinary(obj_data->mem_buf, NULL, &err))) {
+        if (err) {
+            LLVMDisposeMessage(err);
+            err = NULL;
+        }
+        aot_set_last_error("llvm create binary failed.");
+        goto fail;
+    }
+
+    if (!aot_resolve_target_info(comp_ctx, obj_data)
+        || !aot_resolve_text(obj_data)
+        || !aot_resolve_object_data_sections(obj_data))
+        goto fail;
+
+    if (obj_data->data_sections_count > 0) {
+        uint32 size = (uint32)sizeof(uint32) * obj_data->data_sections_count;
+        if (!(obj_data->data_section_bases = wasm_runtime_malloc(size))) {
+            aot_set_last_error("allocate memory failed.");
+            goto fail;
+        }
+        memset(obj_data->data_section_bases, 0, size);
+    }
+
+    return obj_data;
+
+fail:
+    aot_obj_data_destroy(obj_data);
+    return NULL;
+}
+
+/* Merge the text sections of the partitions, text, text_unlikely and
+   text_hot of the partitions are merged respectively */
+static bool
+merge_partition_texts(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    uint32 text_size = 0, text_unlikely_size = 0, text_hot_size = 0;
+    uint32 text_unlikely_base, text_hot_base, total_size, i;
+    uint64 total_size64;
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        part->text_base = text_size;
+        part->text_unlikely_base = text_unlikely_size;
+        part->text_hot_base = text_hot_size;
+        text_size += align_uint(part->text_size, PARTITION_SECTION_ALIGN);
+        text_unlikely_size +=
+            align_uint(part->text_unlikely_size, PARTITION_SECTION_ALIGN);
+        text_hot_size += align_uint(part->text_hot_size, PARTITION_SECTION_ALIGN);
+    }
+
+    total_size64 = (uint64)text_size + text_unlikely_size + text_hot_size;
+    if (total_size64 == 0 || total_size64 >= UINT32_MAX) {
+        aot_set_last_error("invalid text size of partitions.");
+        return false;
+    }
+    total_size = (uint32)total_size64;
+
+    if (!(obj_data->text_buf = wasm_runtime_malloc(total_size))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    memset(obj_data->text_buf, 0, total_size);
+
+    obj_data->text = obj_data->text_buf;
+    obj_data->text_size = text_size;
+    obj_data->text_unlikely = obj_data->text_buf + text_size;
+    obj_data->text_unlikely_size = text_unlikely_size;
+    obj_data->text_hot = obj_data->text_buf + text_size + text_unlikely_size;
+    obj_data->text_hot_size = text_hot_size;
+
+    /* the layout is the same as the one of a single object, see
+       aot_resolve_text */
+    text_unlikely_base = align_uint(text_size, 4);
+    text_hot_base = text_unlikely_base + align_uint(text_unlikely_size, 4);
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        if (part->text_size > 0)
+            bh_memcpy_s((uint8 *)obj_data->text + part->text_base,
+                        text_size - part->text_base, part->text,
+                        part->text_size);
+        if (part->text_unlikely_size > 0)
+            bh_memcpy_s((uint8 *)obj_data->text_unlikely
+                            + part->text_unlikely_base,
+                        text_unlikely_size - part->text_unlikely_base,
+                        part->text_unlikely, part->text_unlikely_size);
+        if (part->text_hot_size > 0)
+            bh_memcpy_s((uint8 *)obj_data->text_hot + part->text_hot_base,
+                        text_hot_size - part->text_hot_base, part->text_hot,
+                        part->text_hot_size);
+        part->text_unlikely_base += text_unlikely_base;
+        part->text_hot_base += text_hot_base;
+    }
+
+    return true;
+}
+
+/* Merge the data sections with the same name of the partitions */
+static bool
+merge_partition_data_sections(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    AOTObjectDataSection *data_section, *merged;
+    uint32 max_count = 0, count = 0, size, i, j, k;
+
+    for (i = 0; i < obj_data->partition_count; i++)
+        max_count += obj_data->partitions[i]->data_sections_count;
+
+    if (max_count == 0)
+        return true;
+
+    size = (uint32)sizeof(AOTObjectDataSection) * max_count;
+    if (!(obj_data->data_sections = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory for data sections failed.");
+        return false;
+    }
+    memset(obj_data->data_sections, 0, size);
+
+    /* calculate the offsets of the data sections in the merged ones */
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->data_sections_count; j++) {
+            data_section = part->data_sections + j;
+            for (k = 0; k < count; k++) {
+                if (!strcmp(obj_data->data_sections[k].name,
+                            data_section->name))
+                    break;
+            }
+            merged = obj_data->data_sections + k;
+            if (k == count) {
+                merged->name = data_section->name;
+                count++;
+            }
+            part->data_section_bases[j] =
+                align_uint(merged->size, PARTITION_SECTION_ALIGN);
+            merged->size = part->data_section_bases[j] + data_section->size;
+        }
+    }
+    obj_data->data_sections_count = count;
+
+    for (k = 0; k < count; k++) {
+        merged = obj_data->data_sections + k;
+        if (merged->size == 0)
+            continue;
+        if (!(merged->data = wasm_runtime_malloc(merged->size))) {
+            aot_set_last_error("allocate memory for data section failed.");
+            return false;
+        }
+        memset(merged->data, 0, merged->size);
+        merged->is_data_allocated = true;
+    }
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->data_sections_count; j++) {
+            data_section = part->data_sections + j;
+            if (data_section->size == 0)
+                continue;
+            for (k = 0; k < count; k++) {
+                if (!strcmp(obj_data->data_sections[k].name,
+                            data_section->name))
+                    break;
+            }
+            merged = obj_data->data_sections + k;
+            bh_memcpy_s(merged->data + part->data_section_bases[j],
+                        merged->size - part->data_section_bases[j],
+                        data_section->data, data_section->size);
+        }
+    }
+
+    return true;
+}
+
+static bool
+resolve_partition_functions(AOTCompContext *comp_ctx, AOTObjectData *obj_data)
+{
+    AOTObjectData *part = obj_data->partitions[0];
+    uint32 total_size, i;
+
+    obj_data->func_count = comp_ctx->comp_data->func_count;
+    if (obj_data->func_count == 0)
+        return true;
+
+    /* the stack sizes table is defined in the first partition, and the
+       others refer to it by the section name */
+    if (comp_ctx->enable_stack_bound_check
+        || comp_ctx->enable_stack_estimation) {
+        part->func_count = obj_data->func_count;
+        if (!aot_resolve_stack_sizes(comp_ctx, part))
+            return false;
+        obj_data->stack_sizes_section_name = part->stack_sizes_section_name;
+        obj_data->stack_sizes_offset =
+            get_data_section_base(part, part->stack_sizes_section_name)
+            + part->stack_sizes_offset;
+        obj_data->stack_sizes = part->stack_sizes;
+        part->stack_sizes = NULL;
+    }
+
+    total_size = (uint32)sizeof(AOTObjectFunc) * obj_data->func_count;
+    if (!(obj_data->funcs = wasm_runtime_malloc(total_size))) {
+        aot_set_last_error("allocate memory for functions failed.");
+        return false;
+    }
+    memset(obj_data->funcs, 0, total_size);
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        if (!aot_resolve_function_offsets(obj_data->partitions[i],
+                                          obj_data->funcs,
+                                          obj_data->func_count))
+            return false;
+    }
+
+    return true;
+}
+
+/* Merge the relocation groups with the same name of the partitions */
+static bool
+merge_partition_relocation_groups(AOTObjectData *obj_data)
+{
+    AOTObjectData *part;
+    AOTRelocationGroup *group, *merged;
+    uint32 max_count = 0, count = 0, size, i, j, k;
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        if (!aot_resolve_object_relocation_groups(obj_data->partitions[i]))
+            return false;
+        max_count += obj_data->partitions[i]->relocation_group_count;
+    }
+
+    if (max_count == 0)
+        return true;
+
+    size = (uint32)sizeof(AOTRelocationGroup) * max_count;
+    if (!(obj_data->relocation_groups = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory for relocation groups failed.");
+        return false;
+    }
+    memset(obj_data->relocation_groups, 0, size);
+
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->relocation_group_count; j++) {
+            group = part->relocation_groups + j;
+            for (k = 0; k < count; k++) {
+                if (!strcmp(obj_data->relocation_groups[k].section_name,
+                            group->section_name))
+                    break;
+            }
+            merged = obj_data->relocation_groups + k;
+            if (k == count) {
+                merged->section_name = group->section_name;
+                count++;
+            }
+            merged->relocation_count += group->relocation_count;
+        }
+    }
+    obj_data->relocation_group_count = count;
+
+    for (k = 0; k < count; k++) {
+        merged = obj_data->relocation_groups + k;
+        size = (uint32)sizeof(AOTRelocation) * merged->relocation_count;
+        if (!(merged->relocations = wasm_runtime_malloc(size))) {
+            aot_set_last_error("allocate memory for relocations failed.");
+            return false;
+        }
+        /* used as the count of the copied relocations */
+        merged->relocation_count = 0;
+    }
+
+    /* the symbol names are owned by the partitions */
+    for (i = 0; i < obj_data->partition_count; i++) {
+        part = obj_data->partitions[i];
+        for (j = 0; j < part->relocation_group_count; j++) {
+            group = part->relocation_groups + j;
+            for (k = 0; k < count; k++) {
+                if (!strcmp(obj_data->relocation_groups[k].section_name,
+                            group->section_name))
+                    break;
+            }
+            merged = obj_data->relocation_groups + k;
+            size = (uint32)sizeof(AOTRelocation) * group->relocation_count;
+            bh_memcpy_s(merged->relocations + merged->relocation_count, size,
+                        group->relocations, size);
+            merged->relocation_count += group->relocation_count;
+        }
+    }
+
+    for (k = 0; k < count; k++) {
+        merged = obj_data->relocation_groups + k;
+        for (j = 0; j < merged->relocation_count; j++)
+            merged->relocations[j].is_symbol_name_allocated = false;
+    }
+
+    return true;
+}
+
+/* Create the object data from the object files of the partitions of the
+   module, which are compiled in multiple threads, see
+   aot_compile_llvm_module_partitions */
+static AOTObjectData *
+aot_obj_data_create_from_partitions(AOTCompContext *comp_ctx)
+{
+    AOTObjectData *obj_data;
+    LLVMMemoryBufferRef mem_buf;
+    uint32 size, i;
+
+    bh_print_time("Begin to resolve object files of partitions");
+
+    if (!(obj_data = wasm_runtime_malloc(sizeof(AOTObjectData)))) {
+        aot_set_last_error("allocate memory failed.");
+        return NULL;
+    }
+    memset(obj_data, 0, sizeof(AOTObjectData));
+    obj_data->comp_ctx = comp_ctx;
+
+    size = (uint32)sizeof(AOTObjectData *) * comp_ctx->partition_count;
+    if (!(obj_data->partitions = wasm_runtime_malloc(size))) {
+        aot_set_last_error("allocate memory failed.");
+        goto fail;
+    }
+    memset(obj_data->partitions, 0, size);
+
+    for (i = 0; i < comp_ctx->partition_count; i++) {
+        /* the memory buffer is owned by the object data from now on */
+        mem_buf = comp_ctx->partition_objs[i];
+        comp_ctx->partition_objs[i] = NULL;
+        if (!(obj_data->partitions[i] =
+                  create_partition_obj_data(comp_ctx, mem_buf)))
+            goto fail;
+        obj_data->partition_count++;
+    }
+
+    obj_data->target_info = obj_data->partitions[0]->target_info;
+    init_feature_flags(comp_ctx, obj_data);
+
+    if (!merge_partition_texts(obj_data)
+        || !merge_partition_data_sections(obj_data)
+        || !resolve_partition_functions(comp_ctx, obj_data)
+        || !merge_partition_relocation_groups(obj_data))
+        goto fail;
+
+    return obj_data;
+
+fail:
+    aot_obj_data_destroy(obj_data);
+    return NULL;
+}
+
 AOTObjectData *
 aot_obj_data_create(AOTCompContext *comp_ctx)
 {
@@ -4366,6 +4844,9 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
     AOTObjectData *obj_data;
     LLVMTargetRef target = LLVMGetTargetMachineTarget(comp_ctx->target_machine);
 
+    if (comp_ctx->partition_count > 0)
+        return aot_obj_data_create_from_partitions(comp_ctx);
+
     bh_print_time("Begin to emit object file to buffer");
 
     if (!(obj_data = wasm_runtime_malloc(sizeof(AOTObjectData)))) {
@@ -4487,32 +4968,7 @@ aot_obj_data_create(AOTCompContext *comp_ctx)
         goto fail;
     }
 
-    /* Create wasm feature flags form compile options */
-    obj_data->target_info.feature_flags = 0;
-    if (comp_ctx->enable_simd) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_SIMD_128BIT;
-    }
-    if (comp_ctx->enable_bulk_memory) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_BULK_MEMORY;
-    }
-    if (comp_ctx->enable_thread_mgr) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_MULTI_THREAD;
-    }
-    if (comp_ctx->enable_ref_types) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_REF_TYPES;
-    }
-    if (comp_ctx->enable_gc) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_GARBAGE_COLLECTION;
-    }
-    if (comp_ctx->aux_stack_frame_type == AOT_STACK_FRAME_TYPE_TINY) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_TINY_STACK_FRAME;
-    }
-    if (comp_ctx->call_stack_features.frame_per_function) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_PER_FUNCTION;
-    }
-    if (!comp_ctx->call_stack_features.func_idx) {
-        obj_data->target_info.feature_flags |= WASM_FEATURE_FRAME_NO_FUNC_IDX;
-    }
+    init_feature_flags(comp_ctx, obj_data);
 
     bh_print_time("Begin to resolve object file info");
 
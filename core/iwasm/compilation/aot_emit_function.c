@@ -181,17 +181,11 @@ call_aot_invoke_native_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func = I64_CONST((uint64)(uintptr_t)llvm_jit_invoke_native))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_runtime_func(
+                  comp_ctx, "llvm_jit_invoke_native",
+                  (void *)llvm_jit_invoke_native, func_type)))
             return false;
-        }
     }
     else if (comp_ctx->is_indirect_mode) {
         int32 func_index;
@@ -991,20 +985,14 @@ alloc_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-                aot_set_last_error("create LLVM function type failed.");
-                return false;
-            }
-
 #if WASM_ENABLE_JIT != 0 \
     && (WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_MEMORY_PROFILING != 0)
             /* JIT mode, call the function directly */
-            if (!(func = I64_CONST(
-                      (uint64)(uintptr_t)llvm_jit_frame_update_profile_info))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_runtime_func(
+                      comp_ctx, "llvm_jit_frame_update_profile_info",
+                      (void *)llvm_jit_frame_update_profile_info,
+                      func_type)))
                 return false;
-            }
 #endif
         }
         else if (comp_ctx->is_indirect_mode) {
@@ -1079,20 +1067,14 @@ free_frame_for_aot_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-                aot_set_last_error("create LLVM function type failed.");
-                return false;
-            }
-
 #if WASM_ENABLE_JIT != 0 \
     && (WASM_ENABLE_PERF_PROFILING != 0 || WASM_ENABLE_MEMORY_PROFILING != 0)
             /* JIT mode, call the function directly */
-            if (!(func = I64_CONST(
-                      (uint64)(uintptr_t)llvm_jit_frame_update_profile_info))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_runtime_func(
+                      comp_ctx, "llvm_jit_frame_update_profile_info",
+                      (void *)llvm_jit_frame_update_profile_info,
+                      func_type)))
                 return false;
-            }
 #endif
         }
         else if (comp_ctx->is_indirect_mode) {
@@ -1185,18 +1167,11 @@ check_app_addr_and_convert(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func =
-                  I64_CONST((uint64)(uintptr_t)jit_check_app_addr_and_convert))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_runtime_func(
+                  comp_ctx, "jit_check_app_addr_and_convert",
+                  (void *)jit_check_app_addr_and_convert, func_type)))
             return false;
-        }
     }
     else if (comp_ctx->is_indirect_mode) {
         int32 func_index;
@@ -1952,17 +1927,11 @@ call_aot_call_indirect_func(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
 
     /* prepare function pointer */
     if (comp_ctx->is_jit_mode) {
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("create LLVM function type failed.");
-            return false;
-        }
-
         /* JIT mode, call the function directly */
-        if (!(func = I64_CONST((uint64)(uintptr_t)llvm_jit_call_indirect))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_runtime_func(
+                  comp_ctx, "llvm_jit_call_indirect",
+                  (void *)llvm_jit_call_indirect, func_type)))
             return false;
-        }
     }
     else if (comp_ctx->is_indirect_mode) {
         int32 func_index;
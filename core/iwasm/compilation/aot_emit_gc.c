@@ -295,6 +295,33 @@ fail:
     return false;
 }
 
+/* Call wasm_obj_write_barrier() after a reference is stored into the
+   struct or array object, which is required by incremental marking */
+static bool
+aot_call_wasm_obj_write_barrier(AOTCompContext *comp_ctx,
+                                AOTFuncContext *func_ctx, LLVMValueRef gc_obj)
+{
+    LLVMValueRef param_values[1], func, value;
+    LLVMTypeRef param_types[1], ret_type, func_type, func_ptr_type;
+
+    param_types[0] = GC_REF_TYPE;
+    ret_type = VOID_TYPE;
+
+    GET_AOT_FUNCTION(wasm_obj_write_barrier, 1);
+
+    /* Call function wasm_obj_write_barrier() */
+    param_values[0] = gc_obj;
+    if (!LLVMBuildCall2(comp_ctx->builder, func_type, func, param_values, 1,
+                        "")) {
+        aot_set_last_error("llvm build call failed.");
+        goto fail;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
 static void
 get_struct_field_data_types(const AOTCompContext *comp_ctx, uint8 field_type,
                             LLVMTypeRef *p_field_data_type,
@@ -707,6 +734,10 @@ aot_compile_op_struct_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
                                   field_value, field_type))
         goto fail;
 
+    if (comp_ctx->enable_gc_write_barrier && wasm_is_type_reftype(field_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, struct_obj))
+        goto fail;
+
     return true;
 fail:
     return false;
@@ -1446,6 +1477,11 @@ aot_compile_op_array_set(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
+    if (comp_ctx->enable_gc_write_barrier
+        && wasm_is_type_reftype(array_elem_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, array_obj))
+        goto fail;
+
     return true;
 fail:
     return false;
@@ -1559,6 +1595,13 @@ aot_compile_op_array_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx,
         goto fail;
     }
 
+    /* No allocation happens in the fill loop, so it is fine to call the
+       write barrier once before the elements are stored */
+    if (comp_ctx->enable_gc_write_barrier
+        && wasm_is_type_reftype(array_elem_type)
+        && !aot_call_wasm_obj_write_barrier(comp_ctx, func_ctx, array_obj))
+        goto fail;
+
     BUILD_BR(fill_loop_header);
     SET_BUILDER_POS(fill_loop_header);
 
@@ -1410,15 +1410,10 @@ aot_compile_op_memory_grow(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
 
     if (comp_ctx->is_jit_mode) {
         /* JIT mode, call the function directly */
-        if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
-            aot_set_last_error("llvm add pointer type failed.");
-            return false;
-        }
-        if (!(value = I64_CONST((uint64)(uintptr_t)wasm_enlarge_memory))
-            || !(func = LLVMConstIntToPtr(value, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_runtime_func(
+                  comp_ctx, "wasm_enlarge_memory",
+                  (void *)wasm_enlarge_memory, func_type)))
             return false;
-        }
     }
     else if (comp_ctx->is_indirect_mode) {
         if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
@@ -1823,11 +1818,9 @@ aot_compile_op_memory_copy(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
         }
 
         if (comp_ctx->is_jit_mode) {
-            if (!(func = I64_CONST((uint64)(uintptr_t)aot_memmove))
-                || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-                aot_set_last_error("create LLVM value failed.");
+            if (!(func = aot_get_jit_runtime_func(
+                      comp_ctx, "aot_memmove", (void *)aot_memmove, func_type)))
                 return false;
-            }
         }
         else {
             int32 func_index;
@@ -1904,11 +1897,9 @@ aot_compile_op_memory_fill(AOTCompContext *comp_ctx, AOTFuncContext *func_ctx)
     }
 
     if (comp_ctx->is_jit_mode) {
-        if (!(func = I64_CONST((uint64)(uintptr_t)jit_memset))
-            || !(func = LLVMConstIntToPtr(func, func_ptr_type))) {
-            aot_set_last_error("create LLVM value failed.");
+        if (!(func = aot_get_jit_runtime_func(
+                  comp_ctx, "jit_memset", (void *)jit_memset, func_type)))
             return false;
-        }
     }
     else if (comp_ctx->is_indirect_mode) {
         int32 func_index;
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot_func_cache.h"
+#include "../interpreter/wasm.h"
+#include "../../shared/utils/bh_leb128.h"
+
+/* "WFNC" */
+#define FUNC_CACHE_MAGIC 0x434e4657
+/* Bump it when the layout of the cache file or the way to generate the
+   object files of the functions changes */
+#define FUNC_CACHE_VERSION 2
+
+typedef struct FuncCacheHeader {
+    uint32 magic;
+    uint32 version;
+    uint8 key[BH_SHA256_DIGEST_SIZE];
+    uint8 content_digest[BH_SHA256_DIGEST_SIZE];
+    uint64 object_size;
+    uint64 stack_usage_size;
+} FuncCacheHeader;
+
+/* Add the target and the options which the generated code depends on */
+static bool
+update_config_digest(AOTCompContext *comp_ctx, BHSha256Context *ctx)
+{
+    uint32 values[] = {
+        FUNC_CACHE_VERSION,
+        AOT_CURRENT_VERSION,
+        comp_ctx->stack_usage_file != NULL,
+    };
+
+    bh_sha256_update(ctx, values, sizeof(values));
+    return aot_update_options_digest(comp_ctx, ctx);
+}
+
+/* Add the parts of the module which the code of all the functions may
+   depend on, i.e. all the sections except the code section, the custom
+   sections and the contents of the data segments */
+static bool
+update_module_digest(AOTCompContext *comp_ctx, BHSha256Context *ctx)
+{
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    const WASMModule *module = comp_data->wasm_module;
+    const uint8 *p = module->load_addr, *p_end = p + module->load_size;
+    uint64 section_size;
+    uint8 section_type;
+    size_t offset;
+    uint32 i;
+
+    /* skip the magic number and the version */
+    if (module->load_size < 8)
+        goto fail;
+    p += 8;
+
+    while (p < p_end) {
+        section_type = *p++;
+        offset = 0;
+        if (bh_leb_read(p, p_end, 32, false, &section_size, &offset)
+                != BH_LEB_READ_SUCCESS
+            || section_size > (uint64)(p_end - p - offset))
+            goto fail;
+        p += offset;
+
+        if (section_type != SECTION_TYPE_USER
+            && section_type != SECTION_TYPE_CODE
+            && section_type != SECTION_TYPE_DATA) {
+            bh_sha256_update(ctx, &section_type, sizeof(uint8));
+            bh_sha256_update(ctx, &section_size, sizeof(uint64));
+            bh_sha256_update(ctx, p, (size_t)section_size);
+        }
+        p += section_size;
+    }
+
+    /* The code refers to the data segments by index */
+    bh_sha256_update(ctx, &comp_data->mem_init_data_count, sizeof(uint32));
+    for (i = 0; i < comp_data->mem_init_data_count; i++) {
+#if WASM_ENABLE_BULK_MEMORY != 0
+        const AOTMemInitData *data_seg = comp_data->mem_init_data_list[i];
+        bh_sha256_update(ctx, &data_seg->is_passive, sizeof(bool));
+        bh_sha256_update(ctx, &data_seg->memory_index, sizeof(uint32));
+#endif
+    }
+
+#if WASM_ENABLE_WAMR_COMPILER != 0
+    bh_sha256_update(ctx, &module->is_simd_used, sizeof(bool));
+    bh_sha256_update(ctx, &module->is_ref_types_used, sizeof(bool));
+    bh_sha256_update(ctx, &module->is_bulk_memory_used, sizeof(bool));
+#endif
+
+    return true;
+
+fail:
+    aot_set_last_error("resolve sections of wasm module failed.");
+    return false;
+}
+
+bool
+aot_func_cache_get_keys(AOTCompContext *comp_ctx, uint8 *keys)
+{
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    BHSha256Context base_ctx, ctx;
+    uint32 i;
+
+    /* The digest of the options and the module is shared by all the
+       functions, and each function adds its own code to a copy of it */
+    bh_sha256_init(&base_ctx);
+    if (!update_config_digest(comp_ctx, &base_ctx)
+        || !update_module_digest(comp_ctx, &base_ctx))
+        return false;
+
+    for (i = 0; i < comp_data->func_count; i++) {
+        const AOTFunc *func = comp_data->funcs[i];
+
+        ctx = base_ctx;
+        /* The symbols of the function are named by the function index */
+        bh_sha256_update(&ctx, &i, sizeof(uint32));
+#if WASM_ENABLE_BRANCH_HINTS != 0
+        {
+            struct WASMCompilationHint *hint =
+                comp_data->function_hints ? comp_data->function_hints[i]
+                                          : NULL;
+
+            /* The body begins with the local declarations */
+            bh_sha256_update(
+                &ctx, func->code_body_begin,
+                (size_t)(func->code + func->code_size - func->code_body_begin));
+
+            for (; hint; hint = hint->next) {
+                if (hint->type == WASM_COMPILATION_BRANCH_HINT) {
+                    struct WASMCompilationHintBranchHint *branch_hint =
+                        (struct WASMCompilationHintBranchHint *)hint;
+                    bh_sha256_update(&ctx, &branch_hint->offset,
+                                     sizeof(uint32));
+                    bh_sha256_update(&ctx, &branch_hint->is_likely,
+                                     sizeof(bool));
+                }
+            }
+        }
+#else
+        bh_sha256_update(&ctx, &func->local_count, sizeof(uint32));
+        bh_sha256_update(&ctx, func->local_types_wp, func->local_count);
+        bh_sha256_update(&ctx, func->code, func->code_size);
+#endif
+        bh_sha256_final(&ctx, keys + (size_t)i * BH_SHA256_DIGEST_SIZE);
+    }
+
+    return true;
+}
+
+static bool
+get_cache_file_path(AOTCompContext *comp_ctx, const uint8 *key, char *buf,
+                    uint32 buf_size)
+{
+    char key_hex[BH_SHA256_HEX_SIZE];
+    int len;
+
+    bh_sha256_to_hex(key, key_hex);
+    len = snprintf(buf, buf_size, "%s/%s.wfunc", comp_ctx->func_cache_dir,
+                   key_hex);
+
+    if (len < 0 || (uint32)len >= buf_size) {
+        LOG_WARNING("function object cache path is too long: %s",
+                    comp_ctx->func_cache_dir);
+        return false;
+    }
+    return true;
+}
+
+bool
+aot_func_cache_load(AOTCompContext *comp_ctx, const uint8 *key,
+                    LLVMMemoryBufferRef *p_obj_buf,
+                    LLVMMemoryBufferRef *p_stack_usage_buf)
+{
+    char file_path[1024], *err_msg = NULL;
+    LLVMMemoryBufferRef file_buf = NULL, obj_buf, stack_usage_buf;
+    FuncCacheHeader header;
+    uint8 content_digest[BH_SHA256_DIGEST_SIZE];
+    const uint8 *data;
+    size_t size;
+
+    if (!get_cache_file_path(comp_ctx, key, file_path, sizeof(file_path)))
+        return false;
+
+    if (LLVMCreateMemoryBufferWithContentsOfFile(file_path, &file_buf,
+                                                 &err_msg)) {
+        LLVMDisposeMessage(err_msg);
+        return false;
+    }
+
+    data = (const uint8 *)LLVMGetBufferStart(file_buf);
+    size = LLVMGetBufferSize(file_buf);
+    if (size < sizeof(FuncCacheHeader))
+        goto invalid;
+
+    bh_memcpy_s(&header, sizeof(FuncCacheHeader), data,
+                sizeof(FuncCacheHeader));
+    if (header.magic != FUNC_CACHE_MAGIC
+        || header.version != FUNC_CACHE_VERSION
+        || memcmp(header.key, key, BH_SHA256_DIGEST_SIZE)
+        || header.object_size > size - sizeof(FuncCacheHeader)
+        || header.stack_usage_size
+               != size - sizeof(FuncCacheHeader) - header.object_size)
+        goto invalid;
+
+    bh_sha256(data + sizeof(FuncCacheHeader), size - sizeof(FuncCacheHeader),
+              content_digest);
+    if (memcmp(header.content_digest, content_digest, BH_SHA256_DIGEST_SIZE))
+        goto invalid;
+
+    /* Copy the contents so that the object is suitably aligned */
+    data += sizeof(FuncCacheHeader);
+    obj_buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+        (const char *)data, (size_t)header.object_size, file_path);
+    stack_usage_buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+        (const char *)data + header.object_size,
+        (size_t)header.stack_usage_size, file_path);
+    LLVMDisposeMemoryBuffer(file_buf);
+    if (!obj_buf || !stack_usage_buf) {
+        if (obj_buf)
+            LLVMDisposeMemoryBuffer(obj_buf);
+        if (stack_usage_buf)
+            LLVMDisposeMemoryBuffer(stack_usage_buf);
+        LOG_WARNING("failed to create memory buffer for %s", file_path);
+        return false;
+    }
+
+    *p_obj_buf = obj_buf;
+    *p_stack_usage_buf = stack_usage_buf;
+    return true;
+
+invalid:
+    LOG_WARNING("ignore invalid function object cache %s", file_path);
+    LLVMDisposeMemoryBuffer(file_buf);
+    return false;
+}
+
+void
+aot_func_cache_save(AOTCompContext *comp_ctx, const uint8 *key,
+                    const uint8 *obj, uint64 obj_size, const char *stack_usage,
+                    uint64 stack_usage_size)
+{
+    char file_path[1024];
+    FuncCacheHeader header = { 0 };
+    BHSha256Context ctx;
+    BHCacheFileChunk chunks[3];
+
+    if (!get_cache_file_path(comp_ctx, key, file_path, sizeof(file_path)))
+        return;
+
+    header.magic = FUNC_CACHE_MAGIC;
+    header.version = FUNC_CACHE_VERSION;
+    bh_memcpy_s(header.key, sizeof(header.key), key, BH_SHA256_DIGEST_SIZE);
+    header.object_size = obj_size;
+    header.stack_usage_size = stack_usage_size;
+
+    bh_sha256_init(&ctx);
+    bh_sha256_update(&ctx, obj, (size_t)obj_size);
+    bh_sha256_update(&ctx, stack_usage, (size_t)stack_usage_size);
+    bh_sha256_final(&ctx, header.content_digest);
+
+    chunks[0].data = &header;
+    chunks[0].size = sizeof(FuncCacheHeader);
+    chunks[1].data = obj;
+    chunks[1].size = obj_size;
+    chunks[2].data = stack_usage;
+    chunks[2].size = stack_usage_size;
+
+    if (!bh_cache_file_write(file_path, chunks, 3))
+        LOG_WARNING("failed to write function object cache file %s",
+                    file_path);
+}
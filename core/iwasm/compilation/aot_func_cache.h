@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _AOT_FUNC_CACHE_H_
+#define _AOT_FUNC_CACHE_H_
+
+#include "aot_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Calculate the keys of the defined functions in the function object
+ * cache, the key of a function covers its code, the parts of the module
+ * other than the code and the data segments, the target and the options
+ *
+ * @param comp_ctx the compilation context
+ * @param keys the buffer to return the keys, which are SHA-256 digests of
+ *        BH_SHA256_DIGEST_SIZE bytes each, its length must be the count of
+ *        the defined functions times BH_SHA256_DIGEST_SIZE
+ *
+ * @return true if success, false otherwise
+ */
+bool
+aot_func_cache_get_keys(AOTCompContext *comp_ctx, uint8 *keys);
+
+/**
+ * Look up the compiled function in the function object cache
+ *
+ * @param comp_ctx the compilation context
+ * @param key the key of the function, a digest of BH_SHA256_DIGEST_SIZE bytes
+ * @param p_obj_buf return the object file of the function
+ * @param p_stack_usage_buf return the stack usage lines of the function
+ *
+ * @return true if the function is found, false otherwise
+ */
+bool
+aot_func_cache_load(AOTCompContext *comp_ctx, const uint8 *key,
+                    LLVMMemoryBufferRef *p_obj_buf,
+                    LLVMMemoryBufferRef *p_stack_usage_buf);
+
+/**
+ * Save the compiled function to the function object cache, note that
+ * failing to save it isn't treated as an error
+ */
+void
+aot_func_cache_save(AOTCompContext *comp_ctx, const uint8 *key,
+                    const uint8 *obj, uint64 obj_size, const char *stack_usage,
+                    uint64 stack_usage_size);
+
+#ifdef __cplusplus
+} /* end of extern "C" */
+#endif
+
+#endif /* end of _AOT_FUNC_CACHE_H_ */
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "aot_jit_cache.h"
+#include "aot_orc_extra.h"
+#include "../aot/aot_runtime.h"
+#include "../interpreter/wasm_runtime.h"
+#if WASM_ENABLE_SHARED_MEMORY != 0
+#include "../common/wasm_shared_memory.h"
+#endif
+
+#if WASM_ENABLE_JIT != 0
+
+/* "WJIT" */
+#define JIT_CACHE_MAGIC 0x54494a57
+/* Bump it when the layout of the cache file changes */
+#define JIT_CACHE_VERSION 2
+
+typedef struct JitCacheHeader {
+    uint32 magic;
+    uint32 version;
+    uint8 module_digest[BH_SHA256_DIGEST_SIZE];
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+    uint8 object_digest[BH_SHA256_DIGEST_SIZE];
+    uint64 object_size;
+} JitCacheHeader;
+
+typedef struct JitRuntimeSymbol {
+    const char *name;
+    void *func;
+} JitRuntimeSymbol;
+
+/* The runtime functions which may be called by the cached code, the names
+   are the ones passed to aot_get_jit_runtime_func by the code generator */
+static const JitRuntimeSymbol jit_runtime_symbols[] = {
+    { "jit_set_exception_with_id", (void *)jit_set_exception_with_id },
+    { "jit_check_app_addr_and_convert",
+      (void *)jit_check_app_addr_and_convert },
+    { "llvm_jit_call_indirect", (void *)llvm_jit_call_indirect },
+    { "llvm_jit_invoke_native", (void *)llvm_jit_invoke_native },
+    { "wasm_enlarge_memory", (void *)wasm_enlarge_memory },
+    { "wasm_runtime_quick_invoke_c_api_native",
+      (void *)wasm_runtime_quick_invoke_c_api_native },
+    { "aot_memmove", (void *)aot_memmove },
+    { "jit_memset", (void *)memset },
+#if WASM_ENABLE_BULK_MEMORY != 0
+    { "llvm_jit_memory_init", (void *)llvm_jit_memory_init },
+    { "llvm_jit_data_drop", (void *)llvm_jit_data_drop },
+#endif
+#if WASM_ENABLE_REF_TYPES != 0
+    { "llvm_jit_drop_table_seg", (void *)llvm_jit_drop_table_seg },
+    { "llvm_jit_table_init", (void *)llvm_jit_table_init },
+    { "llvm_jit_table_copy", (void *)llvm_jit_table_copy },
+    { "llvm_jit_table_fill", (void *)llvm_jit_table_fill },
+    { "llvm_jit_table_grow", (void *)llvm_jit_table_grow },
+#endif
+#if WASM_ENABLE_SHARED_MEMORY != 0
+    { "wasm_runtime_atomic_wait", (void *)wasm_runtime_atomic_wait },
+    { "wasm_runtime_atomic_notify", (void *)wasm_runtime_atomic_notify },
+#endif
+#if WASM_ENABLE_SHARED_HEAP != 0
+    { "wasm_runtime_check_and_update_last_used_shared_heap",
+      (void *)wasm_runtime_check_and_update_last_used_shared_heap },
+#endif
+};
+
+bool
+aot_jit_cache_is_runtime_symbol(const char *name)
+{
+    uint32 i;
+
+    for (i = 0; i < sizeof(jit_runtime_symbols) / sizeof(JitRuntimeSymbol);
+         i++) {
+        if (!strcmp(jit_runtime_symbols[i].name, name))
+            return true;
+    }
+    return false;
+}
+
+bool
+aot_jit_cache_define_runtime_symbols(AOTCompContext *comp_ctx)
+{
+    uint32 count = sizeof(jit_runtime_symbols) / sizeof(JitRuntimeSymbol);
+    uint32 i;
+    LLVMOrcCSymbolMapPairs symbols;
+    LLVMOrcMaterializationUnitRef mu;
+    LLVMOrcJITDylibRef main_dylib;
+    LLVMErrorRef err;
+
+    if (!(symbols = wasm_runtime_malloc(sizeof(*symbols) * count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        symbols[i].Name = LLVMOrcLLLazyJITMangleAndIntern(
+            comp_ctx->orc_jit, jit_runtime_symbols[i].name);
+        symbols[i].Sym.Address =
+            (LLVMOrcExecutorAddress)(uintptr_t)jit_runtime_symbols[i].func;
+        symbols[i].Sym.Flags.GenericFlags =
+            LLVMJITSymbolGenericFlagsExported
+            | LLVMJITSymbolGenericFlagsCallable;
+        symbols[i].Sym.Flags.TargetFlags = 0;
+    }
+
+    /* Ownership transfer: symbol names -> materialization unit */
+    mu = LLVMOrcAbsoluteSymbols(symbols, count);
+    wasm_runtime_free(symbols);
+
+    main_dylib = LLVMOrcLLLazyJITGetMainJITDylib(comp_ctx->orc_jit);
+    if ((err = LLVMOrcJITDylibDefine(main_dylib, mu))) {
+        LLVMOrcDisposeMaterializationUnit(mu);
+        aot_handle_llvm_errmsg("failed to define jit runtime symbols", err);
+        return false;
+    }
+    return true;
+}
+
+/* Digest everything besides the wasm binary that the generated code
+   depends on: the data layout of the runtime, the target and the options */
+static bool
+get_config_digest(AOTCompContext *comp_ctx, uint8 *digest)
+{
+    uint32 values[] = {
+        JIT_CACHE_VERSION,
+        (uint32)sizeof(WASMModuleInstance),
+        (uint32)sizeof(WASMModuleInstanceExtra),
+        (uint32)sizeof(WASMMemoryInstance),
+        (uint32)sizeof(WASMExecEnv),
+    };
+    BHSha256Context ctx;
+
+    bh_sha256_init(&ctx);
+    bh_sha256_update(&ctx, values, sizeof(values));
+    if (!aot_update_options_digest(comp_ctx, &ctx))
+        return false;
+    bh_sha256_final(&ctx, digest);
+    return true;
+}
+
+static bool
+get_cache_file_path(AOTCompContext *comp_ctx, const uint8 *config_digest,
+                    char *buf, uint32 buf_size)
+{
+    char module_hex[BH_SHA256_HEX_SIZE], config_hex[BH_SHA256_HEX_SIZE];
+    int len;
+
+    bh_sha256_to_hex(comp_ctx->jit_cache_module_digest, module_hex);
+    bh_sha256_to_hex(config_digest, config_hex);
+    len = snprintf(buf, buf_size, "%s/%s-%s.wjit", comp_ctx->jit_cache_dir,
+                   module_hex, config_hex);
+
+    if (len < 0 || (uint32)len >= buf_size) {
+        LOG_WARNING("JIT code cache path is too long: %s",
+                    comp_ctx->jit_cache_dir);
+        return false;
+    }
+    return true;
+}
+
+static bool
+add_object_file(AOTCompContext *comp_ctx, LLVMMemoryBufferRef obj_buf)
+{
+    LLVMOrcJITDylibRef main_dylib;
+    LLVMErrorRef err;
+
+    main_dylib = LLVMOrcLLLazyJITGetMainJITDylib(comp_ctx->orc_jit);
+    if (!main_dylib) {
+        LLVMDisposeMemoryBuffer(obj_buf);
+        aot_set_last_error("failed to get orc orc_jit main dynamic library");
+        return false;
+    }
+
+    /* Ownership transfer: obj_buf -> orc_jit */
+    if ((err = LLVMOrcLLLazyJITAddObjectFile(comp_ctx->orc_jit, main_dylib,
+                                             obj_buf))) {
+        aot_handle_llvm_errmsg("failed to add object file", err);
+        return false;
+    }
+    return true;
+}
+
+bool
+aot_jit_cache_load(AOTCompContext *comp_ctx)
+{
+    char file_path[1024], *err_msg = NULL;
+    LLVMMemoryBufferRef file_buf = NULL, obj_buf = NULL;
+    JitCacheHeader header;
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+    uint8 object_digest[BH_SHA256_DIGEST_SIZE];
+    const uint8 *data;
+    size_t size;
+
+    if (!comp_ctx->jit_cache_dir)
+        return false;
+
+    if (!get_config_digest(comp_ctx, config_digest)
+        || !get_cache_file_path(comp_ctx, config_digest, file_path,
+                                sizeof(file_path)))
+        return false;
+
+    /* The file is mapped into memory if it is large enough */
+    if (LLVMCreateMemoryBufferWithContentsOfFile(file_path, &file_buf,
+                                                 &err_msg)) {
+        LOG_VERBOSE("JIT code cache miss: %s", file_path);
+        LLVMDisposeMessage(err_msg);
+        return false;
+    }
+
+    data = (const uint8 *)LLVMGetBufferStart(file_buf);
+    size = LLVMGetBufferSize(file_buf);
+    if (size < sizeof(JitCacheHeader))
+        goto invalid;
+
+    bh_memcpy_s(&header, sizeof(JitCacheHeader), data, sizeof(JitCacheHeader));
+    if (header.magic != JIT_CACHE_MAGIC || header.version != JIT_CACHE_VERSION
+        || memcmp(header.module_digest, comp_ctx->jit_cache_module_digest,
+                  BH_SHA256_DIGEST_SIZE)
+        || memcmp(header.config_digest, config_digest, BH_SHA256_DIGEST_SIZE)
+        || header.object_size != size - sizeof(JitCacheHeader))
+        goto invalid;
+
+    bh_sha256(data + sizeof(JitCacheHeader), (size_t)header.object_size,
+              object_digest);
+    if (memcmp(header.object_digest, object_digest, BH_SHA256_DIGEST_SIZE))
+        goto invalid;
+
+    /* Copy the object so that it is suitably aligned for the linker */
+    obj_buf = LLVMCreateMemoryBufferWithMemoryRangeCopy(
+        (const char *)data + sizeof(JitCacheHeader),
+        (size_t)header.object_size, file_path);
+    LLVMDisposeMemoryBuffer(file_buf);
+    if (!obj_buf) {
+        LOG_WARNING("failed to create memory buffer for %s", file_path);
+        return false;
+    }
+
+    if (!add_object_file(comp_ctx, obj_buf)) {
+        LOG_WARNING("failed to load JIT code cache %s: %s", file_path,
+                    aot_get_last_error());
+        return false;
+    }
+
+    LOG_VERBOSE("JIT code cache hit: %s", file_path);
+    return true;
+
+invalid:
+    LOG_WARNING("ignore invalid JIT code cache %s", file_path);
+    LLVMDisposeMemoryBuffer(file_buf);
+    return false;
+}
+
+static void
+save_cache_file(AOTCompContext *comp_ctx, const uint8 *config_digest,
+                LLVMMemoryBufferRef obj_buf)
+{
+    char file_path[1024];
+    const uint8 *data = (const uint8 *)LLVMGetBufferStart(obj_buf);
+    size_t size = LLVMGetBufferSize(obj_buf);
+    JitCacheHeader header = { 0 };
+    BHCacheFileChunk chunks[2];
+
+    if (!get_cache_file_path(comp_ctx, config_digest, file_path,
+                             sizeof(file_path)))
+        return;
+
+    header.magic = JIT_CACHE_MAGIC;
+    header.version = JIT_CACHE_VERSION;
+    bh_memcpy_s(header.module_digest, sizeof(header.module_digest),
+                comp_ctx->jit_cache_module_digest, BH_SHA256_DIGEST_SIZE);
+    bh_memcpy_s(header.config_digest, sizeof(header.config_digest),
+                config_digest, BH_SHA256_DIGEST_SIZE);
+    bh_sha256(data, size, header.object_digest);
+    header.object_size = (uint64)size;
+
+    chunks[0].data = &header;
+    chunks[0].size = sizeof(JitCacheHeader);
+    chunks[1].data = data;
+    chunks[1].size = (uint64)size;
+
+    if (!bh_cache_file_write(file_path, chunks, 2)) {
+        LOG_WARNING("failed to write JIT code cache file %s", file_path);
+        return;
+    }
+
+    LOG_VERBOSE("JIT code cache saved: %s", file_path);
+}
+
+bool
+aot_jit_cache_emit(AOTCompContext *comp_ctx)
+{
+    LLVMMemoryBufferRef obj_buf = NULL;
+    char *err_msg = NULL;
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+
+    if (!get_config_digest(comp_ctx, config_digest))
+        return false;
+
+    bh_print_time("Begin to emit object file for JIT code cache");
+
+    if (LLVMTargetMachineEmitToMemoryBuffer(comp_ctx->target_machine,
+                                            comp_ctx->module, LLVMObjectFile,
+                                            &err_msg, &obj_buf)
+        != 0) {
+        if (err_msg) {
+            aot_set_last_error_v("emit object file failed: %s", err_msg);
+            LLVMDisposeMessage(err_msg);
+        }
+        else {
+            aot_set_last_error("emit object file failed.");
+        }
+        return false;
+    }
+
+    save_cache_file(comp_ctx, config_digest, obj_buf);
+
+    return add_object_file(comp_ctx, obj_buf);
+}
+
+#endif /* end of WASM_ENABLE_JIT != 0 */
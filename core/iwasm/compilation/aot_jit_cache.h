@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _AOT_JIT_CACHE_H_
+#define _AOT_JIT_CACHE_H_
+
+#include "aot_compiler.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Whether the runtime function can be referenced by name from the code
+ * saved to the JIT code cache
+ */
+bool
+aot_jit_cache_is_runtime_symbol(const char *name);
+
+/**
+ * Define the runtime functions referenced by name from the JITed code
+ * in the main JITDylib of the JIT
+ */
+bool
+aot_jit_cache_define_runtime_symbols(AOTCompContext *comp_ctx);
+
+/**
+ * Look up the machine code of the module in the JIT code cache, and add
+ * it to the JIT if it is found and valid
+ *
+ * @param comp_ctx the compilation context
+ *
+ * @return true if the cached code was added to the JIT, false otherwise,
+ *         in which case the module should be compiled as usual
+ */
+bool
+aot_jit_cache_load(AOTCompContext *comp_ctx);
+
+/**
+ * Compile the LLVM module into an object file, save it to the JIT code
+ * cache and add it to the JIT
+ *
+ * @param comp_ctx the compilation context
+ *
+ * @return true if success, false otherwise, note that failing to save
+ *         the object file to the cache isn't treated as an error
+ */
+bool
+aot_jit_cache_emit(AOTCompContext *comp_ctx);
+
+#ifdef __cplusplus
+} /* end of extern "C" */
+#endif
+
+#endif /* end of _AOT_JIT_CACHE_H_ */
@@ -11,6 +11,10 @@
 #include "../aot/aot_runtime.h"
 #include "../aot/aot_intrinsic.h"
 #include "../interpreter/wasm_runtime.h"
+#include "../../version.h"
+#if WASM_ENABLE_JIT != 0
+#include "aot_jit_cache.h"
+#endif
 
 #if WASM_ENABLE_DEBUG_AOT != 0
 #include "debug/dwarf_extractor.h"
@@ -2631,6 +2635,45 @@ aot_compiler_destroy(void)
     LLVMShutdown();
 }
 
+/* Whether the functions can be compiled into the object files of multiple
+   partitions, which are merged by the AOT file emitter relying on the
+   relocation addends of ELF */
+static bool
+can_compile_in_partitions(const AOTCompContext *comp_ctx,
+                          const aot_comp_option_t option, const char *triple)
+{
+    if (option->output_format != AOT_FORMAT_FILE) {
+        LOG_WARNING("Compiling in partitions is only supported when "
+                    "emitting AOT file");
+        return false;
+    }
+    if (strcmp(comp_ctx->target_arch, "x86_64")
+        && strncmp(comp_ctx->target_arch, "aarch64", 7)) {
+        LOG_WARNING("Compiling in partitions isn't supported for target %s",
+                    comp_ctx->target_arch);
+        return false;
+    }
+    if (strstr(triple, "windows") || strstr(triple, "darwin")
+        || strstr(triple, "apple")) {
+        LOG_WARNING("Compiling in partitions is only supported for ELF "
+                    "targets");
+        return false;
+    }
+    if (comp_ctx->enable_llvm_pgo || comp_ctx->use_prof_file
+        || comp_ctx->external_llc_compiler
+        || comp_ctx->external_asm_compiler) {
+        LOG_WARNING("Compiling in partitions isn't supported with PGO or "
+                    "external compilers");
+        return false;
+    }
+#if WASM_ENABLE_DEBUG_AOT != 0
+    LOG_WARNING("Compiling in partitions isn't supported with debug AOT");
+    return false;
+#else
+    return true;
+#endif
+}
+
 AOTCompContext *
 aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
 {
@@ -2794,6 +2837,9 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
     if (option->enable_gc)
         comp_ctx->enable_gc = true;
 
+    if (option->enable_gc_write_barrier)
+        comp_ctx->enable_gc_write_barrier = true;
+
     if (option->enable_shared_heap)
         comp_ctx->enable_shared_heap = true;
 
@@ -2839,6 +2885,27 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
         /* Create LLJIT Instance */
         if (!orc_jit_create(comp_ctx))
             goto fail;
+
+#if WASM_ENABLE_JIT != 0
+        if (option->jit_cache_dir) {
+            if (comp_ctx->enable_stack_bound_check
+                || comp_ctx->enable_stack_estimation) {
+                /* The stack sizes are reported when the JIT compiles the
+                   functions, which doesn't happen for the cached code */
+                LOG_WARNING("JIT code cache is disabled since the native "
+                            "stack sizes of functions are required");
+            }
+            else {
+                comp_ctx->jit_cache_dir = option->jit_cache_dir;
+                bh_memcpy_s(comp_ctx->jit_cache_module_digest,
+                            sizeof(comp_ctx->jit_cache_module_digest),
+                            option->jit_cache_module_digest,
+                            sizeof(comp_ctx->jit_cache_module_digest));
+                if (!aot_jit_cache_define_runtime_symbols(comp_ctx))
+                    goto fail;
+            }
+        }
+#endif
     }
     else {
         /* Create LLVM target machine */
@@ -3300,6 +3367,24 @@ aot_create_comp_context(const AOTCompData *comp_data, aot_comp_option_t option)
                 comp_ctx->enable_segue_v128_store = true;
         }
     }
+
+    if (!comp_ctx->is_jit_mode
+        && (option->compile_thread_num > 1 || option->func_cache_dir)) {
+        if (!can_compile_in_partitions(comp_ctx, option, triple)) {
+            LOG_WARNING("Fallback to compiling the module in single thread "
+                        "without function object cache");
+        }
+        else {
+            comp_ctx->compile_thread_num = option->compile_thread_num;
+            /* The indices of the native symbols depend on the order in
+               which they are used by all the functions */
+            if (option->func_cache_dir && comp_ctx->is_indirect_mode)
+                LOG_WARNING("Function object cache isn't supported in "
+                            "indirect mode");
+            else
+                comp_ctx->func_cache_dir = option->func_cache_dir;
+        }
+    }
     LLVMDisposeMessage(triple);
 
 #if WASM_ENABLE_WAMR_COMPILER != 0
@@ -3467,6 +3552,15 @@ aot_destroy_comp_context(AOTCompContext *comp_ctx)
         (void)unlink(comp_ctx->stack_usage_temp_file);
     }
 
+    if (comp_ctx->partition_objs) {
+        uint32 i;
+        for (i = 0; i < comp_ctx->partition_count; i++) {
+            if (comp_ctx->partition_objs[i])
+                LLVMDisposeMemoryBuffer(comp_ctx->partition_objs[i]);
+        }
+        wasm_runtime_free(comp_ctx->partition_objs);
+    }
+
     if (comp_ctx->target_machine)
         LLVMDisposeTargetMachine(comp_ctx->target_machine);
 
@@ -4112,6 +4206,43 @@ fail:
     return NULL;
 }
 
+LLVMValueRef
+aot_get_jit_runtime_func(AOTCompContext *comp_ctx, const char *name,
+                         void *func_ptr, LLVMTypeRef func_type)
+{
+    LLVMTypeRef func_ptr_type;
+    LLVMValueRef func, value;
+
+#if WASM_ENABLE_JIT != 0
+    if (comp_ctx->jit_cache_dir) {
+        if (aot_jit_cache_is_runtime_symbol(name)) {
+            /* Resolved to the runtime function by the JIT linker */
+            if (!(func = LLVMGetNamedFunction(comp_ctx->module, name))
+                && !(func = LLVMAddFunction(comp_ctx->module, name,
+                                            func_type))) {
+                aot_set_last_error("add LLVM function failed.");
+                return NULL;
+            }
+            return func;
+        }
+        comp_ctx->jit_code_uncacheable = true;
+    }
+#endif
+
+    if (!(func_ptr_type = LLVMPointerType(func_type, 0))) {
+        aot_set_last_error("create LLVM function type failed.");
+        return NULL;
+    }
+
+    if (!(value = I64_CONST((uint64)(uintptr_t)func_ptr))
+        || !(func = LLVMConstIntToPtr(value, func_ptr_type))) {
+        aot_set_last_error("create LLVM value failed.");
+        return NULL;
+    }
+
+    return func;
+}
+
 LLVMValueRef
 aot_load_const_from_table(AOTCompContext *comp_ctx, LLVMValueRef base,
                           const WASMValue *value, uint8 value_type)
@@ -4205,3 +4336,103 @@ aot_set_cond_br_weights(AOTCompContext *comp_ctx, LLVMValueRef cond_br,
 
     return true;
 }
+
+bool
+aot_update_options_digest(AOTCompContext *comp_ctx, BHSha256Context *ctx)
+{
+    uint32 values[] = {
+        WAMR_VERSION_MAJOR,
+        WAMR_VERSION_MINOR,
+        WAMR_VERSION_PATCH,
+        LLVM_VERSION_MAJOR,
+        LLVM_VERSION_MINOR,
+        LLVM_VERSION_PATCH,
+        comp_ctx->pointer_size,
+        comp_ctx->opt_level,
+        comp_ctx->size_level,
+        (uint32)comp_ctx->aux_stack_frame_type,
+    };
+    bool flags[] = {
+        comp_ctx->is_jit_mode,
+        comp_ctx->is_indirect_mode,
+        comp_ctx->enable_bulk_memory,
+        comp_ctx->enable_bulk_memory_opt,
+        comp_ctx->enable_bound_check,
+        comp_ctx->enable_stack_bound_check,
+        comp_ctx->enable_stack_estimation,
+        comp_ctx->enable_simd,
+        comp_ctx->enable_aux_stack_check,
+        comp_ctx->call_stack_features.ip,
+        comp_ctx->call_stack_features.func_idx,
+        comp_ctx->call_stack_features.trap_ip,
+        comp_ctx->call_stack_features.values,
+        comp_ctx->call_stack_features.frame_per_function,
+        comp_ctx->enable_perf_profiling,
+        comp_ctx->enable_memory_profiling,
+        comp_ctx->enable_thread_mgr,
+        comp_ctx->enable_tail_call,
+        comp_ctx->enable_ref_types,
+        comp_ctx->enable_call_indirect_overlong,
+        comp_ctx->disable_llvm_intrinsics,
+        comp_ctx->disable_llvm_jump_tables,
+        comp_ctx->disable_llvm_lto,
+        comp_ctx->enable_llvm_pgo,
+        comp_ctx->enable_extended_const,
+        comp_ctx->quick_invoke_c_api_import,
+        comp_ctx->enable_segue_i32_load,
+        comp_ctx->enable_segue_i64_load,
+        comp_ctx->enable_segue_f32_load,
+        comp_ctx->enable_segue_f64_load,
+        comp_ctx->enable_segue_v128_load,
+        comp_ctx->enable_segue_i32_store,
+        comp_ctx->enable_segue_i64_store,
+        comp_ctx->enable_segue_f32_store,
+        comp_ctx->enable_segue_f64_store,
+        comp_ctx->enable_segue_v128_store,
+        comp_ctx->optimize,
+        comp_ctx->emit_frame_pointer,
+        comp_ctx->enable_gc,
+        comp_ctx->enable_gc_write_barrier,
+        comp_ctx->enable_shared_heap,
+        comp_ctx->enable_shared_chain,
+    };
+    const AOTCompData *comp_data = comp_ctx->comp_data;
+    char *triple, *cpu, *features;
+    uint32 i;
+    bool ret = false;
+
+    triple = LLVMGetTargetMachineTriple(comp_ctx->target_machine);
+    cpu = LLVMGetTargetMachineCPU(comp_ctx->target_machine);
+    features = LLVMGetTargetMachineFeatureString(comp_ctx->target_machine);
+    if (!triple || !cpu || !features) {
+        aot_set_last_error("get target machine information failed.");
+        goto fail;
+    }
+
+    bh_sha256_update(ctx, values, sizeof(values));
+    bh_sha256_update(ctx, flags, sizeof(flags));
+    /* The intrinsic compatibility flags */
+    bh_sha256_update(ctx, comp_ctx->flags, sizeof(comp_ctx->flags));
+    bh_sha256_update_str(ctx, triple);
+    bh_sha256_update_str(ctx, cpu);
+    bh_sha256_update_str(ctx, features);
+    bh_sha256_update_str(ctx, comp_ctx->llvm_passes);
+    bh_sha256_update_str(ctx, comp_ctx->builtin_intrinsics);
+    /* The signatures of the native functions which the imports are
+       resolved to, the app addresses of the arguments are converted to
+       native addresses by the caller according to them. A signature is
+       never empty, so a NULL one, i.e. an unresolved import, is added as
+       an empty string */
+    for (i = 0; i < comp_data->import_func_count; i++)
+        bh_sha256_update_str(ctx, comp_data->import_funcs[i].signature);
+    ret = true;
+
+fail:
+    if (triple)
+        LLVMDisposeMessage(triple);
+    if (cpu)
+        LLVMDisposeMessage(cpu);
+    if (features)
+        LLVMDisposeMessage(features);
+    return ret;
+}
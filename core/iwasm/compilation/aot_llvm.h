@@ -36,6 +36,7 @@
 
 #include "aot_orc_extra.h"
 #include "aot_comp_option.h"
+#include "../../shared/utils/bh_code_cache.h"
 
 #if defined(_WIN32) || defined(_WIN32_)
 #include <io.h>
@@ -405,6 +406,13 @@ typedef struct AOTCompContext {
     LLVMOrcLLLazyJITRef orc_jit;
     LLVMOrcThreadSafeContextRef orc_thread_safe_context;
 
+    /* JIT code cache directory, NULL if the cache is disabled */
+    const char *jit_cache_dir;
+    uint8 jit_cache_module_digest[BH_SHA256_DIGEST_SIZE];
+    /* Whether the generated code refers to addresses of the current
+       process, so it can't be saved to the JIT code cache */
+    bool jit_code_uncacheable;
+
     LLVMModuleRef module;
 
     bool is_jit_mode;
@@ -502,6 +510,9 @@ typedef struct AOTCompContext {
     /* Enable GC */
     bool enable_gc;
 
+    /* Call the write barrier after storing a reference into a GC object */
+    bool enable_gc_write_barrier;
+
     bool enable_shared_heap;
     bool enable_shared_chain;
 
@@ -552,6 +563,16 @@ typedef struct AOTCompContext {
     const char *llvm_passes;
     const char *builtin_intrinsics;
 
+    /* Number of threads to optimize and compile the functions in */
+    uint32 compile_thread_num;
+    /* Directory of the cache of the object files of the functions, which
+       is used to recompile the changed functions only */
+    const char *func_cache_dir;
+    /* Object files of the partitions of the module compiled in multiple
+       threads, which are merged when emitting the AOT file */
+    LLVMMemoryBufferRef *partition_objs;
+    uint32 partition_count;
+
     /* Current frame information for translation */
     AOTCompFrame *aot_frame;
 } AOTCompContext;
@@ -647,6 +668,16 @@ LLVMValueRef
 aot_get_func_from_table(const AOTCompContext *comp_ctx, LLVMValueRef base,
                         LLVMTypeRef func_type, int32 index);
 
+/**
+ * Get the callee of a runtime function called by the JITed code, the
+ * function is referenced by name when the JIT code cache is enabled so
+ * that the cached code doesn't refer to addresses of the current process,
+ * otherwise it is referenced by its address directly.
+ */
+LLVMValueRef
+aot_get_jit_runtime_func(AOTCompContext *comp_ctx, const char *name,
+                         void *func_ptr, LLVMTypeRef func_type);
+
 LLVMValueRef
 aot_load_const_from_table(AOTCompContext *comp_ctx, LLVMValueRef base,
                           const WASMValue *value, uint8 value_type);
@@ -657,6 +688,21 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+/**
+ * Split the functions of the LLVM module into partitions, and optimize and
+ * compile them into object files in multiple threads. When the function
+ * object cache is enabled, each function is placed in its own partition,
+ * and only the ones not found in the cache are compiled
+ *
+ * @param comp_ctx the compilation context
+ *
+ * @return true if success, false otherwise, note that the module isn't
+ *         split when it isn't supported, in which case partition_count
+ *         of comp_ctx is 0 and the module should be compiled as usual
+ */
+bool
+aot_compile_llvm_module_partitions(AOTCompContext *comp_ctx);
+
 void
 aot_handle_llvm_errmsg(const char *string, LLVMErrorRef err);
 
@@ -674,6 +720,14 @@ unsigned int
 aot_estimate_stack_usage_for_function_call(const AOTCompContext *comp_ctx,
                                            const AOTFuncType *callee_func_type);
 
+/**
+ * Add the runtime version, the target, the compilation options and the
+ * signatures of the resolved imports, which the generated code depends on,
+ * to the digest keying the cached code
+ */
+bool
+aot_update_options_digest(AOTCompContext *comp_ctx, BHSha256Context *ctx);
+
 #ifdef __cplusplus
 } /* end of extern "C" */
 #endif
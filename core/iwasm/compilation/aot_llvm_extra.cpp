@@ -59,10 +59,27 @@
 #include <llvm/Analysis/AliasAnalysis.h>
 #endif
 #include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ADT/SetVector.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/LegacyPassManager.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
+#include <llvm/Support/TargetRegistry.h>
+#endif
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
+#include <atomic>
 #include <cstring>
+#include <set>
+#include <thread>
 #include "../aot/aot_runtime.h"
 #include "aot_llvm.h"
+#include "aot_func_cache.h"
 
 using namespace llvm;
 using namespace llvm::orc;
@@ -82,6 +99,9 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str);
 void
 aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module);
 
+bool
+aot_compile_llvm_module_partitions(AOTCompContext *comp_ctx);
+
 LLVM_C_EXTERN_C_END
 
 ExitOnError ExitOnErr;
@@ -189,11 +209,10 @@ aot_check_simd_compatibility(const char *arch_c_str, const char *cpu_c_str)
 #endif /* WASM_ENABLE_SIMD */
 }
 
-void
-aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
+static void
+apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, TargetMachine *TM,
+                            Module *M)
 {
-    TargetMachine *TM =
-        reinterpret_cast<TargetMachine *>(comp_ctx->target_machine);
     PipelineTuningOptions PTO;
     PTO.LoopVectorization = true;
     PTO.SLPVectorization = true;
@@ -308,7 +327,6 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     disable_llvm_lto = true;
 #endif
 
-    Module *M = reinterpret_cast<Module *>(module);
     if (disable_llvm_lto) {
         for (Function &F : *M) {
             F.addFnAttr("disable-tail-calls", "true");
@@ -400,6 +418,14 @@ aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
     MPM.run(*M, MAM);
 }
 
+void
+aot_apply_llvm_new_pass_manager(AOTCompContext *comp_ctx, LLVMModuleRef module)
+{
+    apply_llvm_new_pass_manager(
+        comp_ctx, reinterpret_cast<TargetMachine *>(comp_ctx->target_machine),
+        reinterpret_cast<Module *>(module));
+}
+
 char *
 aot_compress_aot_func_names(AOTCompContext *comp_ctx, uint32 *p_size)
 {
@@ -433,3 +459,507 @@ aot_compress_aot_func_names(AOTCompContext *comp_ctx, uint32 *p_size)
     *p_size = compressed_str_len;
     return compressed_str;
 }
+
+/* Get the partition which the definition of a global value is placed in */
+static uint32
+get_global_partition(const DenseMap<const GlobalValue *, uint32> &FuncParts,
+                     const GlobalValue *GV)
+{
+    auto It = FuncParts.find(GV);
+    /* The globals other than the wasm functions are placed in the first
+       partition */
+    return It != FuncParts.end() ? It->second : 0;
+}
+
+/* Collect the partitions which use the value */
+static void
+collect_user_partitions(const DenseMap<const GlobalValue *, uint32> &FuncParts,
+                        const Value *V, std::set<uint32> &Parts)
+{
+    for (const User *U : V->users()) {
+        if (auto *I = dyn_cast<Instruction>(U))
+            Parts.insert(get_global_partition(FuncParts, I->getFunction()));
+        else if (auto *GV = dyn_cast<GlobalValue>(U))
+            Parts.insert(get_global_partition(FuncParts, GV));
+        else
+            collect_user_partitions(FuncParts, U, Parts);
+    }
+}
+
+/* Collect the global values referred to by the constant */
+static void
+collect_referred_globals(const Constant *C,
+                         SmallPtrSetImpl<const Constant *> &Visited,
+                         SetVector<GlobalValue *> &Globals)
+{
+    if (!Visited.insert(C).second)
+        return;
+
+    if (auto *GV = dyn_cast<GlobalValue>(C)) {
+        Globals.insert(const_cast<GlobalValue *>(GV));
+        return;
+    }
+
+    for (const Use &Op : C->operands()) {
+        if (auto *OpC = dyn_cast<Constant>(Op))
+            collect_referred_globals(OpC, Visited, Globals);
+    }
+}
+
+/* Create a module with the definitions of the global values, the other
+   global values referred to by them are declared in the module. It only
+   visits the definitions, so it is much cheaper than cloning the whole
+   module for each partition when there are many partitions */
+static std::unique_ptr<Module>
+extract_partition_module(Module &M, ArrayRef<GlobalValue *> Defs)
+{
+    auto NewM =
+        std::make_unique<Module>(M.getModuleIdentifier(), M.getContext());
+    SmallPtrSet<const Constant *, 32> Visited;
+    SetVector<GlobalValue *> Referred;
+    std::vector<GlobalValue *> NewDefs;
+    ValueToValueMapTy VMap;
+
+    NewM->setSourceFileName(M.getSourceFileName());
+    NewM->setDataLayout(M.getDataLayout());
+    NewM->setTargetTriple(M.getTargetTriple());
+    NewM->setModuleInlineAsm(M.getModuleInlineAsm());
+    if (NamedMDNode *Flags = M.getModuleFlagsMetadata()) {
+        NamedMDNode *NewFlags = NewM->getOrInsertModuleFlagsMetadata();
+        for (MDNode *Op : Flags->operands())
+            NewFlags->addOperand(Op);
+    }
+
+    /* Create the definitions and collect the global values referred to */
+    for (GlobalValue *GV : Defs) {
+        GlobalValue *NewGV;
+
+        if (auto *F = dyn_cast<Function>(GV)) {
+            Function *NewF = Function::Create(
+                F->getFunctionType(), F->getLinkage(), F->getAddressSpace(),
+                F->getName(), NewM.get());
+            NewF->copyAttributesFrom(F);
+            for (const Instruction &I : instructions(F)) {
+                for (const Use &Op : I.operands()) {
+                    if (auto *C = dyn_cast<Constant>(Op))
+                        collect_referred_globals(C, Visited, Referred);
+                }
+            }
+            NewGV = NewF;
+        }
+        else if (auto *GVar = dyn_cast<GlobalVariable>(GV)) {
+            GlobalVariable *NewGVar = new GlobalVariable(
+                *NewM, GVar->getValueType(), GVar->isConstant(),
+                GVar->getLinkage(), nullptr, GVar->getName(), nullptr,
+                GVar->getThreadLocalMode(), GVar->getAddressSpace());
+            NewGVar->copyAttributesFrom(GVar);
+            if (GVar->hasInitializer())
+                collect_referred_globals(GVar->getInitializer(), Visited,
+                                         Referred);
+            NewGV = NewGVar;
+        }
+        else {
+            auto *GA = cast<GlobalAlias>(GV);
+            GlobalAlias *NewGA = GlobalAlias::create(
+                GA->getValueType(), GA->getAddressSpace(), GA->getLinkage(),
+                GA->getName(), NewM.get());
+            NewGA->copyAttributesFrom(GA);
+            collect_referred_globals(GA->getAliasee(), Visited, Referred);
+            NewGV = NewGA;
+        }
+
+        VMap[GV] = NewGV;
+        NewDefs.push_back(NewGV);
+    }
+
+    /* Declare the global values defined in other partitions, the local
+       ones have been changed to external ones by the caller */
+    for (GlobalValue *GV : Referred) {
+        GlobalValue *Decl;
+
+        if (VMap.count(GV))
+            continue;
+
+        if (auto *F = dyn_cast<Function>(GV)) {
+            Function *NewF = Function::Create(
+                F->getFunctionType(), GlobalValue::ExternalLinkage,
+                F->getAddressSpace(), F->getName(), NewM.get());
+            NewF->copyAttributesFrom(F);
+            Decl = NewF;
+        }
+        else if (auto *GVar = dyn_cast<GlobalVariable>(GV)) {
+            GlobalVariable *NewGVar = new GlobalVariable(
+                *NewM, GVar->getValueType(), GVar->isConstant(),
+                GlobalValue::ExternalLinkage, nullptr, GVar->getName(),
+                nullptr, GVar->getThreadLocalMode(), GVar->getAddressSpace());
+            NewGVar->copyAttributesFrom(GVar);
+            Decl = NewGVar;
+        }
+        else {
+            GlobalVariable *NewGVar = new GlobalVariable(
+                *NewM, GV->getValueType(), false, GlobalValue::ExternalLinkage,
+                nullptr, GV->getName(), nullptr, GV->getThreadLocalMode(),
+                GV->getAddressSpace());
+            NewGVar->setVisibility(GV->getVisibility());
+            Decl = NewGVar;
+        }
+
+        VMap[GV] = Decl;
+    }
+
+    for (uint32 i = 0; i < Defs.size(); i++) {
+        if (auto *F = dyn_cast<Function>(Defs[i])) {
+            Function *NewF = cast<Function>(NewDefs[i]);
+            Function::arg_iterator DestArg = NewF->arg_begin();
+            SmallVector<ReturnInst *, 8> Returns;
+
+            for (const Argument &Arg : F->args()) {
+                DestArg->setName(Arg.getName());
+                VMap[&Arg] = &*DestArg++;
+            }
+            CloneFunctionInto(NewF, F, VMap,
+#if LLVM_VERSION_MAJOR >= 13
+                              CloneFunctionChangeType::DifferentModule,
+#else
+                              true,
+#endif
+                              Returns);
+        }
+        else if (auto *GVar = dyn_cast<GlobalVariable>(Defs[i])) {
+            if (GVar->hasInitializer())
+                cast<GlobalVariable>(NewDefs[i])
+                    ->setInitializer(MapValue(GVar->getInitializer(), VMap));
+        }
+        else {
+            auto *GA = cast<GlobalAlias>(Defs[i]);
+            cast<GlobalAlias>(NewDefs[i])
+                ->setAliasee(MapValue(GA->getAliasee(), VMap));
+        }
+    }
+
+    /* CloneFunctionInto adds llvm.dbg.cu even if there is no debug info,
+       which makes the bitcode reader warn about the missing debug info
+       version */
+    if (NamedMDNode *CUs = NewM->getNamedMetadata("llvm.dbg.cu")) {
+        if (CUs->getNumOperands() == 0)
+            NewM->eraseNamedMetadata(CUs);
+    }
+
+    return NewM;
+}
+
+struct PartitionResult {
+    std::unique_ptr<MemoryBuffer> Object;
+    std::string StackUsage;
+    std::string Error;
+};
+
+/* Optimize the partition and compile it into an object file, it runs in a
+   separate thread with its own LLVMContext and TargetMachine */
+static void
+compile_partition_object(AOTCompContext *comp_ctx, StringRef Bitcode,
+                         StringRef StackUsageFile, PartitionResult &Result)
+{
+    TargetMachine *MainTM =
+        reinterpret_cast<TargetMachine *>(comp_ctx->target_machine);
+    TargetOptions Options = MainTM->Options;
+    LLVMContext Context;
+    SmallVector<char, 0> ObjBuf;
+    raw_svector_ostream ObjStream(ObjBuf);
+    legacy::PassManager CodeGenPasses;
+
+    Options.StackUsageOutput = StackUsageFile.str();
+    std::unique_ptr<TargetMachine> TM(MainTM->getTarget().createTargetMachine(
+#if LLVM_VERSION_MAJOR >= 21
+        MainTM->getTargetTriple(),
+#else
+        MainTM->getTargetTriple().str(),
+#endif
+        MainTM->getTargetCPU(), MainTM->getTargetFeatureString(), Options,
+        MainTM->getRelocationModel(), MainTM->getCodeModel(),
+        MainTM->getOptLevel()));
+    if (!TM) {
+        Result.Error = "create target machine failed";
+        return;
+    }
+#if LLVM_VERSION_MAJOR >= 18
+    /* Same as LLVMCreateTargetMachineWithOpts */
+    TM->setLargeDataThreshold(UINT64_MAX);
+#endif
+
+    Expected<std::unique_ptr<Module>> M =
+        parseBitcodeFile(MemoryBufferRef(Bitcode, "partition"), Context);
+    if (!M) {
+        Result.Error = toString(M.takeError());
+        return;
+    }
+
+    if (comp_ctx->optimize)
+        apply_llvm_new_pass_manager(comp_ctx, TM.get(), M->get());
+
+    if (TM->addPassesToEmitFile(CodeGenPasses, ObjStream, nullptr,
+#if LLVM_VERSION_MAJOR >= 18
+                                CodeGenFileType::ObjectFile
+#else
+                                CGFT_ObjectFile
+#endif
+                                )) {
+        Result.Error = "target machine can't emit object file";
+        return;
+    }
+    CodeGenPasses.run(**M);
+
+    Result.Object = MemoryBuffer::getMemBufferCopy(
+        StringRef(ObjBuf.data(), ObjBuf.size()), "partition");
+}
+
+static void
+compile_partition(AOTCompContext *comp_ctx, StringRef Bitcode,
+                  PartitionResult &Result)
+{
+    SmallString<128> StackUsageFile;
+
+    if (!comp_ctx->stack_usage_file) {
+        compile_partition_object(comp_ctx, Bitcode, "", Result);
+        return;
+    }
+
+    /* The stack usage of the partitions are written to their own files
+       and then concatenated, see aot_compile_llvm_module_partitions */
+    if (sys::fs::createTemporaryFile("wamrc-su", "su", StackUsageFile)) {
+        Result.Error = "create temp file failed";
+        return;
+    }
+
+    compile_partition_object(comp_ctx, Bitcode, StackUsageFile, Result);
+    if (Result.Error.empty()) {
+        ErrorOr<std::unique_ptr<MemoryBuffer>> Buf =
+            MemoryBuffer::getFile(StackUsageFile);
+        if (Buf)
+            Result.StackUsage = std::string((*Buf)->getBuffer());
+        else
+            Result.Error = "read stack usage file failed";
+    }
+    sys::fs::remove(StackUsageFile);
+}
+
+bool
+aot_compile_llvm_module_partitions(AOTCompContext *comp_ctx)
+{
+    Module *M = reinterpret_cast<Module *>(comp_ctx->module);
+    DenseMap<const GlobalValue *, uint32> FuncParts;
+    std::vector<std::vector<GlobalValue *>> PartDefs;
+    std::vector<uint64> FuncWeights;
+    std::vector<uint8> Keys;
+    std::vector<SmallVector<char, 0>> Bitcodes;
+    std::vector<PartitionResult> Results;
+    std::vector<uint32> Tasks;
+    std::vector<std::thread> Threads;
+    std::vector<GlobalValue *> SharedGlobals;
+    std::atomic<uint32> NextTask(0);
+    uint32 func_count = comp_ctx->func_ctx_count, part_count, part, i;
+    uint32 thread_num;
+    uint64 total_weight = 0, weight = 0;
+    bool use_func_cache = comp_ctx->func_cache_dir != NULL;
+
+    if (func_count == 0)
+        return true;
+
+    if (use_func_cache) {
+        /* Each function is placed in its own partition so that its object
+           file can be cached and reused when the function isn't changed,
+           the first partition holds the other global values */
+        part_count = func_count + 1;
+        for (i = 0; i < func_count; i++) {
+            AOTFuncContext *func_ctx = comp_ctx->func_ctxes[i];
+
+            FuncParts[reinterpret_cast<GlobalValue *>(func_ctx->func)] = i + 1;
+            if (func_ctx->precheck_func)
+                FuncParts[reinterpret_cast<GlobalValue *>(
+                    func_ctx->precheck_func)] = i + 1;
+        }
+    }
+    else {
+        part_count = std::min(comp_ctx->compile_thread_num, func_count);
+        if (part_count <= 1)
+            return true;
+
+        /* Split the functions into consecutive ranges with similar amount
+           of IR instructions, so the output only depends on the thread
+           count */
+        for (i = 0; i < func_count; i++) {
+            AOTFuncContext *func_ctx = comp_ctx->func_ctxes[i];
+            Function *F = reinterpret_cast<Function *>(func_ctx->func);
+            Function *PrecheckF =
+                reinterpret_cast<Function *>(func_ctx->precheck_func);
+
+            weight = F->getInstructionCount() + 1;
+            if (PrecheckF && PrecheckF != F)
+                weight += PrecheckF->getInstructionCount();
+            FuncWeights.push_back(weight);
+            total_weight += weight;
+        }
+
+        weight = 0;
+        part = 0;
+        for (i = 0; i < func_count; i++) {
+            AOTFuncContext *func_ctx = comp_ctx->func_ctxes[i];
+
+            FuncParts[reinterpret_cast<GlobalValue *>(func_ctx->func)] = part;
+            if (func_ctx->precheck_func)
+                FuncParts[reinterpret_cast<GlobalValue *>(
+                    func_ctx->precheck_func)] = part;
+
+            weight += FuncWeights[i];
+            if (part + 1 < part_count
+                && weight * part_count >= total_weight * (part + 1))
+                part++;
+        }
+        part_count = part + 1;
+        if (part_count <= 1)
+            return true;
+    }
+
+    /* The local globals used by other partitions must be exported, only
+       the stack sizes table is supported since the AOT loader resolves
+       it by the section name, see aot_resolve_object_relocation_group */
+    for (GlobalValue &GV : M->global_values()) {
+        std::set<uint32> Parts;
+
+        if (GV.isDeclaration() || !GV.hasLocalLinkage())
+            continue;
+
+        collect_user_partitions(FuncParts, &GV, Parts);
+        Parts.insert(get_global_partition(FuncParts, &GV));
+        if (Parts.size() <= 1)
+            continue;
+
+        if (&GV != reinterpret_cast<GlobalValue *>(comp_ctx->stack_sizes)) {
+            LOG_WARNING("Global %s is shared by the functions, fallback to "
+                        "compiling the whole module",
+                        GV.getName().str().c_str());
+            return true;
+        }
+        SharedGlobals.push_back(&GV);
+    }
+
+    for (GlobalValue *GV : SharedGlobals) {
+        GV->setLinkage(GlobalValue::ExternalLinkage);
+        GV->setVisibility(GlobalValue::HiddenVisibility);
+    }
+
+    PartDefs.resize(part_count);
+    for (GlobalValue &GV : M->global_values()) {
+        if (!GV.isDeclaration())
+            PartDefs[get_global_partition(FuncParts, &GV)].push_back(&GV);
+    }
+
+    Results.resize(part_count);
+    Tasks.push_back(0);
+    if (use_func_cache) {
+        Keys.resize((size_t)func_count * BH_SHA256_DIGEST_SIZE);
+        if (!aot_func_cache_get_keys(comp_ctx, Keys.data()))
+            return false;
+
+        for (i = 0; i < func_count; i++) {
+            LLVMMemoryBufferRef obj_buf, stack_usage_buf;
+
+            if (aot_func_cache_load(comp_ctx, &Keys[i * BH_SHA256_DIGEST_SIZE],
+                                    &obj_buf, &stack_usage_buf)) {
+                Results[i + 1].Object.reset(
+                    reinterpret_cast<MemoryBuffer *>(obj_buf));
+                Results[i + 1].StackUsage = std::string(
+                    reinterpret_cast<MemoryBuffer *>(stack_usage_buf)
+                        ->getBuffer());
+                LLVMDisposeMemoryBuffer(stack_usage_buf);
+            }
+            else {
+                Tasks.push_back(i + 1);
+            }
+        }
+        LOG_VERBOSE("Function object cache: %" PRIu32 " hit, %" PRIu32
+                    " miss",
+                    func_count + 1 - (uint32)Tasks.size(),
+                    (uint32)Tasks.size() - 1);
+    }
+    else {
+        for (part = 1; part < part_count; part++)
+            Tasks.push_back(part);
+    }
+
+    /* Pass the partitions to the threads in bitcode, since LLVMContext
+       can't be shared by multiple threads */
+    Bitcodes.resize(part_count);
+    for (uint32 task : Tasks) {
+        std::unique_ptr<Module> Part =
+            extract_partition_module(*M, PartDefs[task]);
+        raw_svector_ostream BitcodeStream(Bitcodes[task]);
+
+        WriteBitcodeToFile(*Part, BitcodeStream);
+    }
+
+    LOG_VERBOSE("Compile %" PRIu32 " of %" PRIu32 " partitions",
+                (uint32)Tasks.size(), part_count);
+
+    auto CompileTasks = [&]() {
+        uint32 task_idx;
+        while ((task_idx = NextTask++) < Tasks.size()) {
+            uint32 task = Tasks[task_idx];
+            compile_partition(comp_ctx,
+                              StringRef(Bitcodes[task].data(),
+                                        Bitcodes[task].size()),
+                              Results[task]);
+        }
+    };
+
+    thread_num = std::min(std::max(comp_ctx->compile_thread_num, 1u),
+                          (uint32)Tasks.size());
+    for (i = 0; i < thread_num; i++)
+        Threads.emplace_back(CompileTasks);
+    for (std::thread &Thread : Threads)
+        Thread.join();
+
+    for (uint32 task : Tasks) {
+        if (!Results[task].Error.empty()) {
+            aot_set_last_error_v("compile partition %" PRIu32 " failed: %s",
+                                 task, Results[task].Error.c_str());
+            return false;
+        }
+        if (use_func_cache && task > 0)
+            aot_func_cache_save(
+                comp_ctx, &Keys[(task - 1) * BH_SHA256_DIGEST_SIZE],
+                reinterpret_cast<const uint8 *>(
+                    Results[task].Object->getBufferStart()),
+                Results[task].Object->getBufferSize(),
+                Results[task].StackUsage.data(),
+                Results[task].StackUsage.size());
+    }
+
+    /* Concatenate the stack usage of the partitions, which is read when
+       emitting the stack sizes table */
+    if (comp_ctx->stack_usage_file) {
+        std::error_code EC;
+        raw_fd_ostream StackUsageStream(comp_ctx->stack_usage_file, EC,
+                                        sys::fs::OF_Text);
+        if (EC) {
+            aot_set_last_error("open stack usage file failed.");
+            return false;
+        }
+        for (part = 0; part < part_count; part++)
+            StackUsageStream << Results[part].StackUsage;
+    }
+
+    if (!(comp_ctx->partition_objs = (LLVMMemoryBufferRef *)wasm_runtime_malloc(
+              sizeof(LLVMMemoryBufferRef) * part_count))) {
+        aot_set_last_error("allocate memory failed.");
+        return false;
+    }
+    for (part = 0; part < part_count; part++) {
+        comp_ctx->partition_objs[part] =
+            reinterpret_cast<LLVMMemoryBufferRef>(
+                Results[part].Object.release());
+    }
+    comp_ctx->partition_count = part_count;
+
+    return true;
+}
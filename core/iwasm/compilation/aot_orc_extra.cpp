@@ -25,6 +25,7 @@
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/Support/CBindingWrapping.h"
+#include "llvm/Support/MemoryBuffer.h"
 
 #include "aot_orc_extra.h"
 #include "aot.h"
@@ -290,6 +291,14 @@ LLVMOrcLLLazyJITAddLLVMIRModule(LLVMOrcLLLazyJITRef J, LLVMOrcJITDylibRef JD,
     return wrap(unwrap(J)->addLazyIRModule(*unwrap(JD), std::move(*TmpTSM)));
 }
 
+LLVMErrorRef
+LLVMOrcLLLazyJITAddObjectFile(LLVMOrcLLLazyJITRef J, LLVMOrcJITDylibRef JD,
+                              LLVMMemoryBufferRef ObjBuffer)
+{
+    return wrap(unwrap(J)->addObjectFile(
+        *unwrap(JD), std::unique_ptr<MemoryBuffer>(unwrap(ObjBuffer))));
+}
+
 LLVMErrorRef
 LLVMOrcLLLazyJITLookup(LLVMOrcLLLazyJITRef J, LLVMOrcExecutorAddress *Result,
                        const char *Name)
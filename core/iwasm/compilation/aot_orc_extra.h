@@ -48,6 +48,10 @@ LLVMErrorRef
 LLVMOrcLLLazyJITAddLLVMIRModule(LLVMOrcLLLazyJITRef J, LLVMOrcJITDylibRef JD,
                                 LLVMOrcThreadSafeModuleRef TSM);
 
+LLVMErrorRef
+LLVMOrcLLLazyJITAddObjectFile(LLVMOrcLLLazyJITRef J, LLVMOrcJITDylibRef JD,
+                              LLVMMemoryBufferRef ObjBuffer);
+
 LLVMErrorRef
 LLVMOrcLLLazyJITLookup(LLVMOrcLLLazyJITRef J, LLVMOrcExecutorAddress *Result,
                        const char *Name);
@@ -0,0 +1,2803 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "jit_codegen.h"
+#include "jit_codecache.h"
+#include "jit_compiler.h"
+#include "jit_frontend.h"
+#include "jit_dump.h"
+
+#include <asmjit/core.h>
+#include <asmjit/a64.h>
+
+#define CODEGEN_CHECK_ARGS 1
+#define CODEGEN_DUMP 0
+
+#if WASM_ENABLE_LAZY_JIT != 0 && WASM_ENABLE_JIT != 0
+#error "Multi-tier JIT isn't supported by the aarch64 codegen yet"
+#endif
+
+using namespace asmjit;
+
+static char *code_block_switch_to_jitted_from_interp = NULL;
+static char *code_block_return_to_interp_from_jitted = NULL;
+#if WASM_ENABLE_LAZY_JIT != 0
+static char *code_block_compile_fast_jit_and_then_call = NULL;
+#endif
+
+/*
+ * Registers used by the jitted code:
+ *   x27:      exec_env
+ *   x28:      frame pointer of the wasm function
+ *   w16:      the cmp register, only the condition flags are used
+ *   x16, x17: scratch registers (IP0 and IP1 of AAPCS64)
+ *   v30, v31: scratch floating-point registers
+ *   x18:      platform register, never touched
+ *   x29, x30: frame record and link register of the native stack
+ *
+ * The jitted functions pass the action in w0, the func_idx and the
+ * integer return value in x2, and the float return value in v0.
+ */
+#define REG_W0_IDX 0
+#define REG_X0_IDX 0
+#define REG_RET_IDX 2
+#define REG_I32_FREE_IDX 16
+#define REG_I64_FREE_IDX 16
+#define REG_I64_FREE2_IDX 17
+#define REG_EXEC_ENV_IDX 27
+#define REG_FP_IDX 28
+#define REG_F32_FREE_IDX 31
+#define REG_F64_FREE_IDX 31
+#define REG_FLOAT_FREE2_IDX 30
+
+/* clang-format off */
+a64::Gp regs_i32[] = {
+    a64::w0,  a64::w1,  a64::w2,  a64::w3,  a64::w4,  a64::w5,
+    a64::w6,  a64::w7,  a64::w8,  a64::w9,  a64::w10, a64::w11,
+    a64::w12, a64::w13, a64::w14, a64::w15, a64::w16, a64::w17,
+    a64::w18, a64::w19, a64::w20, a64::w21, a64::w22, a64::w23,
+    a64::w24, a64::w25, a64::w26, a64::w27, a64::w28, a64::w29,
+    a64::w30
+};
+
+a64::Gp regs_i64[] = {
+    a64::x0,  a64::x1,  a64::x2,  a64::x3,  a64::x4,  a64::x5,
+    a64::x6,  a64::x7,  a64::x8,  a64::x9,  a64::x10, a64::x11,
+    a64::x12, a64::x13, a64::x14, a64::x15, a64::x16, a64::x17,
+    a64::x18, a64::x19, a64::x20, a64::x21, a64::x22, a64::x23,
+    a64::x24, a64::x25, a64::x26, a64::x27, a64::x28, a64::x29,
+    a64::x30
+};
+
+a64::Vec regs_f32[] = {
+    a64::s0,  a64::s1,  a64::s2,  a64::s3,  a64::s4,  a64::s5,
+    a64::s6,  a64::s7,  a64::s8,  a64::s9,  a64::s10, a64::s11,
+    a64::s12, a64::s13, a64::s14, a64::s15, a64::s16, a64::s17,
+    a64::s18, a64::s19, a64::s20, a64::s21, a64::s22, a64::s23,
+    a64::s24, a64::s25, a64::s26, a64::s27, a64::s28, a64::s29,
+    a64::s30, a64::s31
+};
+
+a64::Vec regs_f64[] = {
+    a64::d0,  a64::d1,  a64::d2,  a64::d3,  a64::d4,  a64::d5,
+    a64::d6,  a64::d7,  a64::d8,  a64::d9,  a64::d10, a64::d11,
+    a64::d12, a64::d13, a64::d14, a64::d15, a64::d16, a64::d17,
+    a64::d18, a64::d19, a64::d20, a64::d21, a64::d22, a64::d23,
+    a64::d24, a64::d25, a64::d26, a64::d27, a64::d28, a64::d29,
+    a64::d30, a64::d31
+};
+/* clang-format on */
+
+int
+jit_codegen_interp_jitted_glue(void *exec_env, JitInterpSwitchInfo *info,
+                               uint32 func_idx, void *target)
+{
+    typedef int32 (*F)(const void *exec_env, void *info, uint32 func_idx,
+                       const void *target);
+    union {
+        F f;
+        void *v;
+    } u;
+
+    u.v = code_block_switch_to_jitted_from_interp;
+    return u.f(exec_env, info, func_idx, target);
+}
+
+#define PRINT_LINE() LOG_VERBOSE("<Line:%d>\n", __LINE__)
+
+#if CODEGEN_DUMP != 0
+#define GOTO_FAIL     \
+    do {              \
+        PRINT_LINE(); \
+        goto fail;    \
+    } while (0)
+#else
+#define GOTO_FAIL goto fail
+#endif
+
+#if CODEGEN_CHECK_ARGS == 0
+
+#define CHECK_EQKIND(reg0, reg1) (void)0
+#define CHECK_CONST(reg0) (void)0
+#define CHECK_NCONST(reg0) (void)0
+#define CHECK_KIND(reg0, type) (void)0
+#define CHECK_REG_NO(no, kind) (void)0
+#else
+
+/* Check if two register's kind is equal */
+#define CHECK_EQKIND(reg0, reg1)                        \
+    do {                                                \
+        if (jit_reg_kind(reg0) != jit_reg_kind(reg1)) { \
+            PRINT_LINE();                               \
+            LOG_VERBOSE("reg type not equal:\n");       \
+            jit_dump_reg(cc, reg0);                     \
+            jit_dump_reg(cc, reg1);                     \
+            GOTO_FAIL;                                  \
+        }                                               \
+    } while (0)
+
+/* Check if a register is an const */
+#define CHECK_CONST(reg0)                       \
+    do {                                        \
+        if (!jit_reg_is_const(reg0)) {          \
+            PRINT_LINE();                       \
+            LOG_VERBOSE("reg is not const:\n"); \
+            jit_dump_reg(cc, reg0);             \
+            GOTO_FAIL;                          \
+        }                                       \
+    } while (0)
+
+/* Check if a register is not an const */
+#define CHECK_NCONST(reg0)                  \
+    do {                                    \
+        if (jit_reg_is_const(reg0)) {       \
+            PRINT_LINE();                   \
+            LOG_VERBOSE("reg is const:\n"); \
+            jit_dump_reg(cc, reg0);         \
+            GOTO_FAIL;                      \
+        }                                   \
+    } while (0)
+
+/* Check if a register is a special type */
+#define CHECK_KIND(reg0, type)                                  \
+    do {                                                        \
+        if (jit_reg_kind(reg0) != type) {                       \
+            PRINT_LINE();                                       \
+            LOG_VERBOSE("invalid reg type %d, expected is: %d", \
+                        jit_reg_kind(reg0), type);              \
+            jit_dump_reg(cc, reg0);                             \
+            GOTO_FAIL;                                          \
+        }                                                       \
+    } while (0)
+
+#define CHECK_I32_REG_NO(no)                                      \
+    do {                                                          \
+        if ((uint32)no >= sizeof(regs_i32) / sizeof(regs_i32[0])) \
+            GOTO_FAIL;                                            \
+    } while (0)
+
+#define CHECK_I64_REG_NO(no)                                      \
+    do {                                                          \
+        if ((uint32)no >= sizeof(regs_i64) / sizeof(regs_i64[0])) \
+            GOTO_FAIL;                                            \
+    } while (0)
+
+#define CHECK_F32_REG_NO(no)                                      \
+    do {                                                          \
+        if ((uint32)no >= sizeof(regs_f32) / sizeof(regs_f32[0])) \
+            GOTO_FAIL;                                            \
+    } while (0)
+
+#define CHECK_F64_REG_NO(no)                                      \
+    do {                                                          \
+        if ((uint32)no >= sizeof(regs_f64) / sizeof(regs_f64[0])) \
+            GOTO_FAIL;                                            \
+    } while (0)
+
+/* Check if a register number is valid */
+#define CHECK_REG_NO(no, kind)                                           \
+    do {                                                                 \
+        if (kind == JIT_REG_KIND_I32 || kind == JIT_REG_KIND_I64) {      \
+            CHECK_I32_REG_NO(no);                                        \
+            CHECK_I64_REG_NO(no);                                        \
+        }                                                                \
+        else if (kind == JIT_REG_KIND_F32 || kind == JIT_REG_KIND_F64) { \
+            CHECK_F32_REG_NO(no);                                        \
+            CHECK_F64_REG_NO(no);                                        \
+        }                                                                \
+        else                                                             \
+            GOTO_FAIL;                                                   \
+    } while (0)
+
+#endif /* end of CODEGEN_CHECK_ARGS == 0 */
+
+/* Check the register number of an operand if it isn't a const */
+#define CHECK_OPND(reg0)                                        \
+    do {                                                        \
+        if (!jit_reg_is_const(reg0))                            \
+            CHECK_REG_NO(jit_reg_no(reg0), jit_reg_kind(reg0)); \
+    } while (0)
+
+/* Load one operand from insn and check none */
+#define LOAD_1ARG() r0 = *jit_insn_opnd(insn, 0)
+
+/* Load two operands from insn and check if r0 is non-const */
+#define LOAD_2ARGS()              \
+    r0 = *jit_insn_opnd(insn, 0); \
+    r1 = *jit_insn_opnd(insn, 1); \
+    CHECK_NCONST(r0)
+
+/* Load three operands from insn and check if r0 is non-const */
+#define LOAD_3ARGS()              \
+    r0 = *jit_insn_opnd(insn, 0); \
+    r1 = *jit_insn_opnd(insn, 1); \
+    r2 = *jit_insn_opnd(insn, 2); \
+    CHECK_NCONST(r0)
+
+/* Load three operands from insn and check none */
+#define LOAD_3ARGS_NO_ASSIGN()    \
+    r0 = *jit_insn_opnd(insn, 0); \
+    r1 = *jit_insn_opnd(insn, 1); \
+    r2 = *jit_insn_opnd(insn, 2);
+
+/* Load four operands from insn and check if r0 is non-const */
+#define LOAD_4ARGS()              \
+    r0 = *jit_insn_opnd(insn, 0); \
+    r1 = *jit_insn_opnd(insn, 1); \
+    r2 = *jit_insn_opnd(insn, 2); \
+    r3 = *jit_insn_opnd(insn, 3); \
+    CHECK_NCONST(r0)
+
+class JitErrorHandler : public ErrorHandler
+{
+  public:
+    Error err;
+
+    JitErrorHandler()
+      : err(kErrorOk)
+    {}
+
+    void handleError(Error e, const char *msg, BaseEmitter *base) override
+    {
+        (void)msg;
+        (void)base;
+        this->err = e;
+    }
+};
+
+/* Alu opcode */
+typedef enum { ADD, SUB, MUL, DIV_S, REM_S, DIV_U, REM_U } ALU_OP;
+/* Bit opcode */
+typedef enum { OR, XOR, AND } BIT_OP;
+/* Shift opcode */
+typedef enum { SHL, SHRS, SHRU, ROTL, ROTR } SHIFT_OP;
+/* Bitcount opcode */
+typedef enum { CLZ, CTZ, POPCNT } BITCOUNT_OP;
+/* Condition opcode */
+typedef enum { EQ, NE, GTS, GES, LTS, LES, GTU, GEU, LTU, LEU } COND_OP;
+
+/*
+ * The condition codes of COND_OP. After fcmp, an unordered result sets
+ * NZCV to 0011, so gt and ge are false for NaN operands, while their
+ * complements le and lt are true: each code here is the exact negation
+ * of its not_cond() pair for both integer and floating-point compares.
+ */
+static const arm::CondCode cond_codes[] = {
+    arm::CondCode::kEQ, arm::CondCode::kNE, arm::CondCode::kGT,
+    arm::CondCode::kGE, arm::CondCode::kLT, arm::CondCode::kLE,
+    arm::CondCode::kHI, arm::CondCode::kHS, arm::CondCode::kLO,
+    arm::CondCode::kLS
+};
+
+static COND_OP
+not_cond(COND_OP op)
+{
+    COND_OP not_list[] = { NE, EQ, LES, LTS, GES, GTS, LEU, LTU, GEU, GTU };
+
+    bh_assert(op <= LEU);
+    return not_list[op];
+}
+
+static bool
+label_is_neighboring(JitCompContext *cc, int32 label_prev, int32 label_succ)
+{
+    return (label_prev == 0 && label_succ == 2)
+           || (label_prev >= 2 && label_succ == label_prev + 1)
+           || (label_prev == (int32)jit_cc_label_num(cc) - 1
+               && label_succ == 1);
+}
+
+/**
+ * Encode jumping to a label unless the label is the next block
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param labels the asmjit labels of the jit labels
+ * @param label_src the index of src label
+ * @param label_dst the index of dst label
+ * @param is_last_insn if current insn is the last insn of current block
+ */
+static void
+jmp_to_label(JitCompContext *cc, a64::Assembler &a, Label *labels,
+             int32 label_src, int32 label_dst, bool is_last_insn)
+{
+    if (!(is_last_insn && label_is_neighboring(cc, label_src, label_dst)))
+        a.b(labels[label_dst]);
+}
+
+/**
+ * Check whether an immediate can be encoded as the bitmask immediate of
+ * the logical insns (and, orr, eor and tst), i.e. a rotated run of ones
+ * replicated in elements of 2, 4, 8, 16, 32 or 64 bits
+ *
+ * @param imm the immediate
+ * @param bits the register width, 32 or 64
+ *
+ * @return true if it can be encoded, false otherwise
+ */
+static bool
+is_logical_imm(uint64 imm, uint32 bits)
+{
+    uint64 mask = bits == 64 ? ~(uint64)0 : ((uint64)1 << bits) - 1;
+    uint64 elem, elem_mask;
+    uint32 size, i;
+
+    imm &= mask;
+    if (imm == 0 || imm == mask)
+        return false;
+
+    /* Find the smallest element size which the immediate replicates */
+    for (size = 2; size < bits; size <<= 1) {
+        elem_mask = ((uint64)1 << size) - 1;
+        elem = imm & elem_mask;
+        for (i = size; i < bits; i += size) {
+            if (((imm >> i) & elem_mask) != elem)
+                break;
+        }
+        if (i >= bits)
+            break;
+    }
+    elem_mask = size == 64 ? ~(uint64)0 : ((uint64)1 << size) - 1;
+    elem = imm & elem_mask;
+
+    /* A rotated run of ones wraps around bit 0 if bit 0 is set, its
+       complement is then a run of ones that doesn't wrap */
+    if (elem & 1)
+        elem = ~elem & elem_mask;
+    while (!(elem & 1))
+        elem >>= 1;
+    return (elem & (elem + 1)) == 0;
+}
+
+/* Whether the immediate can be encoded by the add, sub and cmp insns */
+static bool
+is_arith_imm(int64 imm)
+{
+    return imm >= 0 && imm < 4096;
+}
+
+/**
+ * Encode moving an immediate into a general purpose register with
+ * a movz/movn and movk sequence
+ *
+ * @param a the assembler to emit the code
+ * @param reg the dst register, w or x register
+ * @param data the immediate
+ * @param bits the register width, 32 or 64
+ */
+static void
+mov_imm_to_gp(a64::Assembler &a, const a64::Gp &reg, uint64 data, uint32 bits)
+{
+    uint32 chunk_num = bits / 16, zero_num = 0, ones_num = 0, i;
+    uint16 chunk, skipped;
+    bool first = true;
+
+    for (i = 0; i < chunk_num; i++) {
+        chunk = (uint16)(data >> (i * 16));
+        if (chunk == 0)
+            zero_num++;
+        else if (chunk == 0xFFFF)
+            ones_num++;
+    }
+
+    /* Start with movn if there are more all-ones chunks than zero chunks,
+       e.g. for small negative numbers */
+    skipped = ones_num > zero_num ? 0xFFFF : 0;
+
+    for (i = 0; i < chunk_num; i++) {
+        chunk = (uint16)(data >> (i * 16));
+        if (chunk == skipped)
+            continue;
+        if (first) {
+            if (skipped)
+                a.movn(reg, Imm((uint16)~chunk), arm::lsl(i * 16));
+            else
+                a.movz(reg, Imm(chunk), arm::lsl(i * 16));
+            first = false;
+        }
+        else {
+            a.movk(reg, Imm(chunk), arm::lsl(i * 16));
+        }
+    }
+
+    if (first) {
+        /* All chunks are zero or all-ones */
+        if (skipped)
+            a.movn(reg, Imm(0));
+        else
+            a.movz(reg, Imm(0));
+    }
+}
+
+static void
+mov_imm_to_r_i32(a64::Assembler &a, int32 reg_no, int32 data)
+{
+    mov_imm_to_gp(a, regs_i32[reg_no], (uint32)data, 32);
+}
+
+static void
+mov_imm_to_r_i64(a64::Assembler &a, int32 reg_no, int64 data)
+{
+    mov_imm_to_gp(a, regs_i64[reg_no], (uint64)data, 64);
+}
+
+static void
+mov_imm_to_r_f32(a64::Assembler &a, int32 reg_no, float32 data)
+{
+    union {
+        float32 f;
+        uint32 i;
+    } u;
+
+    u.f = data;
+    mov_imm_to_r_i32(a, REG_I32_FREE_IDX, (int32)u.i);
+    a.fmov(regs_f32[reg_no], regs_i32[REG_I32_FREE_IDX]);
+}
+
+static void
+mov_imm_to_r_f64(a64::Assembler &a, int32 reg_no, float64 data)
+{
+    union {
+        float64 f;
+        uint64 i;
+    } u;
+
+    u.f = data;
+    mov_imm_to_r_i64(a, REG_I64_FREE_IDX, (int64)u.i);
+    a.fmov(regs_f64[reg_no], regs_i64[REG_I64_FREE_IDX]);
+}
+
+/**
+ * Get the register of an integer operand, the const operand is loaded
+ * into the scratch register first
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r the operand, I32 or I64 kind
+ * @param reg_no_scratch the scratch register to hold the const
+ *
+ * @return the w register of I32 operand or x register of I64 operand
+ */
+static a64::Gp
+gp_opnd(JitCompContext *cc, a64::Assembler &a, JitReg r, int32 reg_no_scratch)
+{
+    if (jit_reg_kind(r) == JIT_REG_KIND_I32) {
+        if (!jit_reg_is_const(r))
+            return regs_i32[jit_reg_no(r)];
+        mov_imm_to_r_i32(a, reg_no_scratch, jit_cc_get_const_I32(cc, r));
+        return regs_i32[reg_no_scratch];
+    }
+
+    bh_assert(jit_reg_kind(r) == JIT_REG_KIND_I64);
+    if (!jit_reg_is_const(r))
+        return regs_i64[jit_reg_no(r)];
+    mov_imm_to_r_i64(a, reg_no_scratch, jit_cc_get_const_I64(cc, r));
+    return regs_i64[reg_no_scratch];
+}
+
+/**
+ * Get the register of a float operand, the const operand is loaded
+ * into the scratch register first, note that x16 is clobbered then
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r the operand, F32 or F64 kind
+ * @param reg_no_scratch the scratch register to hold the const
+ *
+ * @return the s register of F32 operand or d register of F64 operand
+ */
+static a64::Vec
+fp_opnd(JitCompContext *cc, a64::Assembler &a, JitReg r, int32 reg_no_scratch)
+{
+    if (jit_reg_kind(r) == JIT_REG_KIND_F32) {
+        if (!jit_reg_is_const(r))
+            return regs_f32[jit_reg_no(r)];
+        mov_imm_to_r_f32(a, reg_no_scratch, jit_cc_get_const_F32(cc, r));
+        return regs_f32[reg_no_scratch];
+    }
+
+    bh_assert(jit_reg_kind(r) == JIT_REG_KIND_F64);
+    if (!jit_reg_is_const(r))
+        return regs_f64[jit_reg_no(r)];
+    mov_imm_to_r_f64(a, reg_no_scratch, jit_cc_get_const_F64(cc, r));
+    return regs_f64[reg_no_scratch];
+}
+
+/**
+ * Get the memory operand of [base + offset], x17 is clobbered if the
+ * offset can't be encoded as the scaled 12-bit immediate offset
+ *
+ * @param a the assembler to emit the code
+ * @param base the base register
+ * @param offset the offset
+ * @param bytes the byte number of the accessed data
+ *
+ * @return the memory operand
+ */
+static a64::Mem
+mem_base_offset(a64::Assembler &a, const a64::Gp &base, int64 offset,
+                uint32 bytes)
+{
+    if (offset >= 0 && offset % bytes == 0 && offset / bytes < 4096)
+        return a64::ptr(base, (int32)offset);
+
+    mov_imm_to_r_i64(a, REG_I64_FREE2_IDX, offset);
+    return a64::ptr(base, regs_i64[REG_I64_FREE2_IDX]);
+}
+
+/**
+ * Get the memory operand of the LD/ST insns, x17 may be clobbered
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r1 the base, I32 const or I64 register
+ * @param r2 the offset, I32 const or I64 register
+ * @param bytes the byte number of the accessed data
+ * @param m return the memory operand
+ *
+ * @return true if success, false if failed
+ */
+static bool
+get_mem_opnd(JitCompContext *cc, a64::Assembler &a, JitReg r1, JitReg r2,
+             uint32 bytes, a64::Mem &m)
+{
+    int64 base = 0, offset = 0;
+
+    if (jit_reg_is_const(r1)) {
+        CHECK_KIND(r1, JIT_REG_KIND_I32);
+        base = jit_cc_get_const_I32(cc, r1);
+    }
+    else {
+        CHECK_KIND(r1, JIT_REG_KIND_I64);
+        CHECK_I64_REG_NO(jit_reg_no(r1));
+    }
+    if (jit_reg_is_const(r2)) {
+        CHECK_KIND(r2, JIT_REG_KIND_I32);
+        offset = jit_cc_get_const_I32(cc, r2);
+    }
+    else {
+        CHECK_KIND(r2, JIT_REG_KIND_I64);
+        CHECK_I64_REG_NO(jit_reg_no(r2));
+    }
+
+    if (jit_reg_is_const(r1)) {
+        if (jit_reg_is_const(r2)) {
+            mov_imm_to_r_i64(a, REG_I64_FREE2_IDX, base + offset);
+            m = a64::ptr(regs_i64[REG_I64_FREE2_IDX]);
+        }
+        else {
+            mov_imm_to_r_i64(a, REG_I64_FREE2_IDX, base);
+            m = a64::ptr(regs_i64[REG_I64_FREE2_IDX],
+                         regs_i64[jit_reg_no(r2)]);
+        }
+    }
+    else if (jit_reg_is_const(r2)) {
+        m = mem_base_offset(a, regs_i64[jit_reg_no(r1)], offset, bytes);
+    }
+    else {
+        m = a64::ptr(regs_i64[jit_reg_no(r1)], regs_i64[jit_reg_no(r2)]);
+    }
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode computing the address of the LD/ST insns into x17, which is
+ * required by the load-acquire/store-release insns
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r1 the base, I32 const or I64 register
+ * @param r2 the offset, I32 const or I64 register
+ *
+ * @return true if success, false if failed
+ */
+static bool
+get_addr_to_ip1(JitCompContext *cc, a64::Assembler &a, JitReg r1, JitReg r2)
+{
+    const a64::Gp &addr = regs_i64[REG_I64_FREE2_IDX];
+    int64 offset;
+
+    if (jit_reg_is_const(r1)) {
+        CHECK_KIND(r1, JIT_REG_KIND_I32);
+        if (jit_reg_is_const(r2)) {
+            CHECK_KIND(r2, JIT_REG_KIND_I32);
+            offset = jit_cc_get_const_I32(cc, r2);
+            mov_imm_to_r_i64(a, REG_I64_FREE2_IDX,
+                             jit_cc_get_const_I32(cc, r1) + offset);
+        }
+        else {
+            CHECK_KIND(r2, JIT_REG_KIND_I64);
+            CHECK_I64_REG_NO(jit_reg_no(r2));
+            mov_imm_to_r_i64(a, REG_I64_FREE2_IDX,
+                             jit_cc_get_const_I32(cc, r1));
+            a.add(addr, addr, regs_i64[jit_reg_no(r2)]);
+        }
+    }
+    else {
+        CHECK_KIND(r1, JIT_REG_KIND_I64);
+        CHECK_I64_REG_NO(jit_reg_no(r1));
+        if (jit_reg_is_const(r2)) {
+            CHECK_KIND(r2, JIT_REG_KIND_I32);
+            offset = jit_cc_get_const_I32(cc, r2);
+            if (is_arith_imm(offset)) {
+                a.add(addr, regs_i64[jit_reg_no(r1)], Imm(offset));
+            }
+            else {
+                mov_imm_to_r_i64(a, REG_I64_FREE2_IDX, offset);
+                a.add(addr, regs_i64[jit_reg_no(r1)], addr);
+            }
+        }
+        else {
+            CHECK_KIND(r2, JIT_REG_KIND_I64);
+            CHECK_I64_REG_NO(jit_reg_no(r2));
+            a.add(addr, regs_i64[jit_reg_no(r1)], regs_i64[jit_reg_no(r2)]);
+        }
+    }
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn mov: MOV r0, r1
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_mov(JitCompContext *cc, a64::Assembler &a, JitReg r0, JitReg r1)
+{
+    int32 reg_no_dst = jit_reg_no(r0), reg_no_src;
+
+    CHECK_NCONST(r0);
+    CHECK_EQKIND(r0, r1);
+    CHECK_REG_NO(reg_no_dst, jit_reg_kind(r0));
+    CHECK_OPND(r1);
+
+    if (jit_reg_is_const(r1)) {
+        switch (jit_reg_kind(r0)) {
+            case JIT_REG_KIND_I32:
+                mov_imm_to_r_i32(a, reg_no_dst, jit_cc_get_const_I32(cc, r1));
+                break;
+            case JIT_REG_KIND_I64:
+                mov_imm_to_r_i64(a, reg_no_dst, jit_cc_get_const_I64(cc, r1));
+                break;
+            case JIT_REG_KIND_F32:
+                mov_imm_to_r_f32(a, reg_no_dst, jit_cc_get_const_F32(cc, r1));
+                break;
+            case JIT_REG_KIND_F64:
+                mov_imm_to_r_f64(a, reg_no_dst, jit_cc_get_const_F64(cc, r1));
+                break;
+            default:
+                LOG_VERBOSE("Invalid reg type of mov: %d\n",
+                            jit_reg_kind(r0));
+                GOTO_FAIL;
+        }
+        return true;
+    }
+
+    reg_no_src = jit_reg_no(r1);
+    if (reg_no_dst == reg_no_src)
+        return true;
+
+    switch (jit_reg_kind(r0)) {
+        case JIT_REG_KIND_I32:
+            a.mov(regs_i32[reg_no_dst], regs_i32[reg_no_src]);
+            break;
+        case JIT_REG_KIND_I64:
+            a.mov(regs_i64[reg_no_dst], regs_i64[reg_no_src]);
+            break;
+        case JIT_REG_KIND_F32:
+            a.fmov(regs_f32[reg_no_dst], regs_f32[reg_no_src]);
+            break;
+        case JIT_REG_KIND_F64:
+            a.fmov(regs_f64[reg_no_dst], regs_f64[reg_no_src]);
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of mov: %d\n", jit_reg_kind(r0));
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn neg: NEG r0, r1
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_neg(JitCompContext *cc, a64::Assembler &a, JitReg r0, JitReg r1)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+
+    CHECK_EQKIND(r0, r1);
+    CHECK_REG_NO(reg_no_dst, jit_reg_kind(r0));
+    CHECK_OPND(r1);
+
+    switch (jit_reg_kind(r0)) {
+        case JIT_REG_KIND_I32:
+            a.neg(regs_i32[reg_no_dst], gp_opnd(cc, a, r1, REG_I32_FREE_IDX));
+            break;
+        case JIT_REG_KIND_I64:
+            a.neg(regs_i64[reg_no_dst], gp_opnd(cc, a, r1, REG_I64_FREE_IDX));
+            break;
+        case JIT_REG_KIND_F32:
+            a.fneg(regs_f32[reg_no_dst], fp_opnd(cc, a, r1, REG_F32_FREE_IDX));
+            break;
+        case JIT_REG_KIND_F64:
+            a.fneg(regs_f64[reg_no_dst], fp_opnd(cc, a, r1, REG_F64_FREE_IDX));
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of neg: %d\n", jit_reg_kind(r0));
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn convert: I32TOI8 r0, r1, or I32TOI16, I32TOF32, F32TOF64, etc.
+ * Note that the range of the float to integer conversions has been checked
+ * by the frontend.
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param opcode the opcode of the insn
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_convert(JitCompContext *cc, a64::Assembler &a, uint32 opcode, JitReg r0,
+              JitReg r1)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind_src = jit_reg_kind(r1);
+    a64::Gp gp_src;
+    a64::Vec fp_src;
+
+    CHECK_REG_NO(reg_no_dst, jit_reg_kind(r0));
+    CHECK_OPND(r1);
+
+    if (kind_src == JIT_REG_KIND_I32 || kind_src == JIT_REG_KIND_I64)
+        gp_src = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+    else
+        fp_src = fp_opnd(cc, a, r1, REG_F64_FREE_IDX);
+
+    switch (opcode) {
+        case JIT_OP_I8TOI32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.sxtb(regs_i32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I8TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.sxtb(regs_i64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I16TOI32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.sxth(regs_i32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I16TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.sxth(regs_i64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I32TOI8:
+        case JIT_OP_I32TOU8:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.uxtb(regs_i32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I32TOI16:
+        case JIT_OP_I32TOU16:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.uxth(regs_i32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I32TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.sxtw(regs_i64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_U32TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            /* writing the w register clears the upper 32 bits */
+            a.mov(regs_i32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I64TOI8:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.uxtb(regs_i32[reg_no_dst], gp_src.w());
+            break;
+        case JIT_OP_I64TOI16:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.uxth(regs_i32[reg_no_dst], gp_src.w());
+            break;
+        case JIT_OP_I64TOI32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.mov(regs_i32[reg_no_dst], gp_src.w());
+            break;
+        case JIT_OP_I32TOF32:
+            CHECK_KIND(r0, JIT_REG_KIND_F32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.scvtf(regs_f32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_U32TOF32:
+            CHECK_KIND(r0, JIT_REG_KIND_F32);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.ucvtf(regs_f32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I32TOF64:
+            CHECK_KIND(r0, JIT_REG_KIND_F64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.scvtf(regs_f64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_U32TOF64:
+            CHECK_KIND(r0, JIT_REG_KIND_F64);
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.ucvtf(regs_f64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I64TOF32:
+            CHECK_KIND(r0, JIT_REG_KIND_F32);
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.scvtf(regs_f32[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_I64TOF64:
+            CHECK_KIND(r0, JIT_REG_KIND_F64);
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.scvtf(regs_f64[reg_no_dst], gp_src);
+            break;
+        case JIT_OP_F32TOI32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_F32);
+            a.fcvtzs(regs_i32[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F32TOU32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_F32);
+            a.fcvtzu(regs_i32[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F32TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_F32);
+            a.fcvtzs(regs_i64[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F32TOF64:
+            CHECK_KIND(r0, JIT_REG_KIND_F64);
+            CHECK_KIND(r1, JIT_REG_KIND_F32);
+            a.fcvt(regs_f64[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F64TOI32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_F64);
+            a.fcvtzs(regs_i32[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F64TOU32:
+            CHECK_KIND(r0, JIT_REG_KIND_I32);
+            CHECK_KIND(r1, JIT_REG_KIND_F64);
+            a.fcvtzu(regs_i32[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F64TOI64:
+            CHECK_KIND(r0, JIT_REG_KIND_I64);
+            CHECK_KIND(r1, JIT_REG_KIND_F64);
+            a.fcvtzs(regs_i64[reg_no_dst], fp_src);
+            break;
+        case JIT_OP_F64TOF32:
+            CHECK_KIND(r0, JIT_REG_KIND_F32);
+            CHECK_KIND(r1, JIT_REG_KIND_F64);
+            a.fcvt(regs_f32[reg_no_dst], fp_src);
+            break;
+        default:
+            bh_assert(0);
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn cast: I32CASTF32 r0, r1, or I64CASTF64, F32CASTI32 and
+ * F64CASTI64, which reinterpret the bits of the src operand
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_cast(JitCompContext *cc, a64::Assembler &a, JitReg r0, JitReg r1)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+
+    CHECK_REG_NO(reg_no_dst, jit_reg_kind(r0));
+    CHECK_OPND(r1);
+
+    switch (jit_reg_kind(r0)) {
+        case JIT_REG_KIND_F32:
+            CHECK_KIND(r1, JIT_REG_KIND_I32);
+            a.fmov(regs_f32[reg_no_dst], gp_opnd(cc, a, r1, REG_I32_FREE_IDX));
+            break;
+        case JIT_REG_KIND_F64:
+            CHECK_KIND(r1, JIT_REG_KIND_I64);
+            a.fmov(regs_f64[reg_no_dst], gp_opnd(cc, a, r1, REG_I64_FREE_IDX));
+            break;
+        case JIT_REG_KIND_I32:
+            CHECK_KIND(r1, JIT_REG_KIND_F32);
+            a.fmov(regs_i32[reg_no_dst], fp_opnd(cc, a, r1, REG_F32_FREE_IDX));
+            break;
+        case JIT_REG_KIND_I64:
+            CHECK_KIND(r1, JIT_REG_KIND_F64);
+            a.fmov(regs_i64[reg_no_dst], fp_opnd(cc, a, r1, REG_F64_FREE_IDX));
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of cast: %d\n", jit_reg_kind(r0));
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn alu: ADD/SUB/MUL/DIV/REM r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param op the opcode of alu operations
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the first src operand info
+ * @param r2 src jit register that contains the second src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_alu(JitCompContext *cc, a64::Assembler &a, ALU_OP op, JitReg r0,
+          JitReg r1, JitReg r2)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind = jit_reg_kind(r0);
+    a64::Gp dst, lhs, rhs, tmp;
+    a64::Vec fp_dst, fp_lhs, fp_rhs;
+    int64 imm;
+
+    CHECK_EQKIND(r0, r1);
+    CHECK_EQKIND(r0, r2);
+    CHECK_REG_NO(reg_no_dst, kind);
+    CHECK_OPND(r1);
+    CHECK_OPND(r2);
+
+    if (kind == JIT_REG_KIND_F32 || kind == JIT_REG_KIND_F64) {
+        fp_dst = kind == JIT_REG_KIND_F32 ? regs_f32[reg_no_dst]
+                                          : regs_f64[reg_no_dst];
+        fp_lhs = fp_opnd(cc, a, r1, REG_F64_FREE_IDX);
+        fp_rhs = fp_opnd(cc, a, r2, REG_FLOAT_FREE2_IDX);
+
+        switch (op) {
+            case ADD:
+                a.fadd(fp_dst, fp_lhs, fp_rhs);
+                break;
+            case SUB:
+                a.fsub(fp_dst, fp_lhs, fp_rhs);
+                break;
+            case MUL:
+                a.fmul(fp_dst, fp_lhs, fp_rhs);
+                break;
+            case DIV_S:
+                a.fdiv(fp_dst, fp_lhs, fp_rhs);
+                break;
+            default:
+                bh_assert(0);
+                GOTO_FAIL;
+        }
+        return true;
+    }
+
+    if (kind != JIT_REG_KIND_I32 && kind != JIT_REG_KIND_I64) {
+        LOG_VERBOSE("Invalid reg type of alu: %d\n", kind);
+        GOTO_FAIL;
+    }
+
+    dst = kind == JIT_REG_KIND_I32 ? regs_i32[reg_no_dst]
+                                   : regs_i64[reg_no_dst];
+
+    /* Commutative operations take the const as the second operand */
+    if ((op == ADD || op == MUL) && jit_reg_is_const(r1)
+        && !jit_reg_is_const(r2)) {
+        JitReg r_tmp = r1;
+        r1 = r2;
+        r2 = r_tmp;
+    }
+
+    lhs = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+
+    if ((op == ADD || op == SUB) && jit_reg_is_const(r2)) {
+        imm = kind == JIT_REG_KIND_I32 ? jit_cc_get_const_I32(cc, r2)
+                                       : jit_cc_get_const_I64(cc, r2);
+        if (is_arith_imm(imm)) {
+            if (op == ADD)
+                a.add(dst, lhs, Imm(imm));
+            else
+                a.sub(dst, lhs, Imm(imm));
+            return true;
+        }
+        if (imm != INT64_MIN && is_arith_imm(-imm)) {
+            if (op == ADD)
+                a.sub(dst, lhs, Imm(-imm));
+            else
+                a.add(dst, lhs, Imm(-imm));
+            return true;
+        }
+    }
+
+    rhs = gp_opnd(cc, a, r2, REG_I64_FREE2_IDX);
+
+    switch (op) {
+        case ADD:
+            a.add(dst, lhs, rhs);
+            break;
+        case SUB:
+            a.sub(dst, lhs, rhs);
+            break;
+        case MUL:
+            a.mul(dst, lhs, rhs);
+            break;
+        case DIV_S:
+            a.sdiv(dst, lhs, rhs);
+            break;
+        case DIV_U:
+            a.udiv(dst, lhs, rhs);
+            break;
+        case REM_S:
+        case REM_U:
+            /* rem = lhs - (lhs / rhs) * rhs, use a scratch register which
+               doesn't hold the operands to keep the quotient, or dst if
+               both scratch registers are used, which is then not any of
+               the operands */
+            if (!jit_reg_is_const(r1))
+                tmp = kind == JIT_REG_KIND_I32 ? regs_i32[REG_I32_FREE_IDX]
+                                               : regs_i64[REG_I64_FREE_IDX];
+            else if (!jit_reg_is_const(r2))
+                tmp = kind == JIT_REG_KIND_I32 ? regs_i32[REG_I64_FREE2_IDX]
+                                               : regs_i64[REG_I64_FREE2_IDX];
+            else
+                tmp = dst;
+            if (op == REM_S)
+                a.sdiv(tmp, lhs, rhs);
+            else
+                a.udiv(tmp, lhs, rhs);
+            a.msub(dst, tmp, rhs, lhs);
+            break;
+        default:
+            bh_assert(0);
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn bit: AND/OR/XOR r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param op the opcode of bit operations
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the first src operand info
+ * @param r2 src jit register that contains the second src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_bit(JitCompContext *cc, a64::Assembler &a, BIT_OP op, JitReg r0,
+          JitReg r1, JitReg r2)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind = jit_reg_kind(r0);
+    uint32 bits = kind == JIT_REG_KIND_I32 ? 32 : 64;
+    a64::Gp dst, lhs;
+    uint64 imm;
+
+    CHECK_EQKIND(r0, r1);
+    CHECK_EQKIND(r0, r2);
+    CHECK_REG_NO(reg_no_dst, kind);
+    CHECK_OPND(r1);
+    CHECK_OPND(r2);
+
+    if (kind != JIT_REG_KIND_I32 && kind != JIT_REG_KIND_I64) {
+        LOG_VERBOSE("Invalid reg type of bit: %d\n", kind);
+        GOTO_FAIL;
+    }
+
+    dst = kind == JIT_REG_KIND_I32 ? regs_i32[reg_no_dst]
+                                   : regs_i64[reg_no_dst];
+
+    if (jit_reg_is_const(r1) && !jit_reg_is_const(r2)) {
+        JitReg r_tmp = r1;
+        r1 = r2;
+        r2 = r_tmp;
+    }
+
+    lhs = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+
+    if (jit_reg_is_const(r2)) {
+        imm = kind == JIT_REG_KIND_I32
+                  ? (uint64)(uint32)jit_cc_get_const_I32(cc, r2)
+                  : (uint64)jit_cc_get_const_I64(cc, r2);
+        if (is_logical_imm(imm, bits)) {
+            if (op == AND)
+                a.and_(dst, lhs, Imm(imm));
+            else if (op == OR)
+                a.orr(dst, lhs, Imm(imm));
+            else
+                a.eor(dst, lhs, Imm(imm));
+            return true;
+        }
+    }
+
+    if (op == AND)
+        a.and_(dst, lhs, gp_opnd(cc, a, r2, REG_I64_FREE2_IDX));
+    else if (op == OR)
+        a.orr(dst, lhs, gp_opnd(cc, a, r2, REG_I64_FREE2_IDX));
+    else
+        a.eor(dst, lhs, gp_opnd(cc, a, r2, REG_I64_FREE2_IDX));
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn shift: SHL/SHRS/SHRU/ROTL/ROTR r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param op the opcode of shift operations
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the first src operand info
+ * @param r2 src jit register that contains the second src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_shift(JitCompContext *cc, a64::Assembler &a, SHIFT_OP op, JitReg r0,
+            JitReg r1, JitReg r2)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind = jit_reg_kind(r0);
+    uint32 bits = kind == JIT_REG_KIND_I32 ? 32 : 64;
+    a64::Gp dst, src, count;
+    uint32 n;
+
+    CHECK_EQKIND(r0, r1);
+    CHECK_EQKIND(r0, r2);
+    CHECK_REG_NO(reg_no_dst, kind);
+    CHECK_OPND(r1);
+    CHECK_OPND(r2);
+
+    if (kind != JIT_REG_KIND_I32 && kind != JIT_REG_KIND_I64) {
+        LOG_VERBOSE("Invalid reg type of shift: %d\n", kind);
+        GOTO_FAIL;
+    }
+
+    dst = kind == JIT_REG_KIND_I32 ? regs_i32[reg_no_dst]
+                                   : regs_i64[reg_no_dst];
+    src = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+
+    if (jit_reg_is_const(r2)) {
+        n = (uint32)(kind == JIT_REG_KIND_I32 ? jit_cc_get_const_I32(cc, r2)
+                                              : jit_cc_get_const_I64(cc, r2))
+            & (bits - 1);
+        if (op == ROTL)
+            n = (bits - n) & (bits - 1);
+
+        if (n == 0) {
+            if (dst.id() != src.id())
+                a.mov(dst, src);
+            return true;
+        }
+
+        switch (op) {
+            case SHL:
+                a.lsl(dst, src, Imm(n));
+                break;
+            case SHRS:
+                a.asr(dst, src, Imm(n));
+                break;
+            case SHRU:
+                a.lsr(dst, src, Imm(n));
+                break;
+            case ROTL:
+            case ROTR:
+                a.ror(dst, src, Imm(n));
+                break;
+            default:
+                bh_assert(0);
+                GOTO_FAIL;
+        }
+        return true;
+    }
+
+    count = gp_opnd(cc, a, r2, REG_I64_FREE2_IDX);
+
+    /* The variable shift insns take the count modulo the width */
+    switch (op) {
+        case SHL:
+            a.lslv(dst, src, count);
+            break;
+        case SHRS:
+            a.asrv(dst, src, count);
+            break;
+        case SHRU:
+            a.lsrv(dst, src, count);
+            break;
+        case ROTL:
+        {
+            /* rotl(x, n) = rotr(x, -n) */
+            a64::Gp neg_count = kind == JIT_REG_KIND_I32
+                                    ? regs_i32[REG_I64_FREE2_IDX]
+                                    : regs_i64[REG_I64_FREE2_IDX];
+            a.neg(neg_count, count);
+            a.rorv(dst, src, neg_count);
+            break;
+        }
+        case ROTR:
+            a.rorv(dst, src, count);
+            break;
+        default:
+            bh_assert(0);
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn bitcount: CLZ/CTZ/POPCNT r0, r1
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param op the opcode of bit operations
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_bitcount(JitCompContext *cc, a64::Assembler &a, BITCOUNT_OP op,
+               JitReg r0, JitReg r1)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind = jit_reg_kind(r0);
+    bool is_i32 = kind == JIT_REG_KIND_I32;
+    a64::Gp dst, src, t0, t1;
+
+    CHECK_EQKIND(r0, r1);
+    CHECK_REG_NO(reg_no_dst, kind);
+    CHECK_OPND(r1);
+
+    if (kind != JIT_REG_KIND_I32 && kind != JIT_REG_KIND_I64) {
+        LOG_VERBOSE("Invalid reg type of bitcount: %d\n", kind);
+        GOTO_FAIL;
+    }
+
+    dst = is_i32 ? regs_i32[reg_no_dst] : regs_i64[reg_no_dst];
+    t0 = is_i32 ? regs_i32[REG_I64_FREE_IDX] : regs_i64[REG_I64_FREE_IDX];
+    t1 = is_i32 ? regs_i32[REG_I64_FREE2_IDX] : regs_i64[REG_I64_FREE2_IDX];
+    src = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+
+    switch (op) {
+        case CLZ:
+            a.clz(dst, src);
+            break;
+        case CTZ:
+            a.rbit(t1, src);
+            a.clz(dst, t1);
+            break;
+        case POPCNT:
+        {
+            /* The SWAR population count, src may be t0 and isn't used
+               after the first subtraction */
+            uint64 m1 = is_i32 ? 0x55555555 : 0x5555555555555555ULL;
+            uint64 m2 = is_i32 ? 0x33333333 : 0x3333333333333333ULL;
+            uint64 m4 = is_i32 ? 0x0F0F0F0F : 0x0F0F0F0F0F0F0F0FULL;
+            uint64 h01 = is_i32 ? 0x01010101 : 0x0101010101010101ULL;
+
+            a.lsr(t1, src, Imm(1));
+            a.and_(t1, t1, Imm(m1));
+            a.sub(t1, src, t1);
+            a.lsr(t0, t1, Imm(2));
+            a.and_(t0, t0, Imm(m2));
+            a.and_(t1, t1, Imm(m2));
+            a.add(t1, t1, t0);
+            a.lsr(t0, t1, Imm(4));
+            a.add(t1, t1, t0);
+            a.and_(t1, t1, Imm(m4));
+            mov_imm_to_gp(a, t0, h01, is_i32 ? 32 : 64);
+            a.mul(t1, t1, t0);
+            a.lsr(dst, t1, Imm(is_i32 ? 24 : 56));
+            break;
+        }
+        default:
+            bh_assert(0);
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn cmp: CMP r0, r1, r2, only the condition flags are set
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 src jit register that contains the first src operand info
+ * @param r2 src jit register that contains the second src operand info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_cmp(JitCompContext *cc, a64::Assembler &a, JitReg r0, JitReg r1,
+          JitReg r2)
+{
+    uint32 kind = jit_reg_kind(r1);
+    a64::Gp lhs;
+    int64 imm;
+
+    CHECK_KIND(r0, JIT_REG_KIND_I32);
+    CHECK_EQKIND(r1, r2);
+    CHECK_OPND(r1);
+    CHECK_OPND(r2);
+
+    switch (kind) {
+        case JIT_REG_KIND_I32:
+        case JIT_REG_KIND_I64:
+            lhs = gp_opnd(cc, a, r1, REG_I64_FREE_IDX);
+            if (jit_reg_is_const(r2)) {
+                imm = kind == JIT_REG_KIND_I32 ? jit_cc_get_const_I32(cc, r2)
+                                               : jit_cc_get_const_I64(cc, r2);
+                if (is_arith_imm(imm)) {
+                    a.cmp(lhs, Imm(imm));
+                    break;
+                }
+                if (imm != INT64_MIN && is_arith_imm(-imm)) {
+                    a.cmn(lhs, Imm(-imm));
+                    break;
+                }
+            }
+            a.cmp(lhs, gp_opnd(cc, a, r2, REG_I64_FREE2_IDX));
+            break;
+        case JIT_REG_KIND_F32:
+        case JIT_REG_KIND_F64:
+            a.fcmp(fp_opnd(cc, a, r1, REG_F64_FREE_IDX),
+                   fp_opnd(cc, a, r2, REG_FLOAT_FREE2_IDX));
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of cmp: %d\n", kind);
+            GOTO_FAIL;
+    }
+
+    cc->last_cmp_on_fp =
+        (kind == JIT_REG_KIND_F32 || kind == JIT_REG_KIND_F64) ? true : false;
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn select: SELECTcc r0, r1, r2, r3, i.e. r0 = cc ? r2 : r3,
+ * note that loading the consts doesn't change the condition flags
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param op the condition opcode
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 the cmp register
+ * @param r2 the value if the condition is true
+ * @param r3 the value if the condition is false, or 0 to keep r0
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_select(JitCompContext *cc, a64::Assembler &a, COND_OP op, JitReg r0,
+             JitReg r1, JitReg r2, JitReg r3)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    uint32 kind = jit_reg_kind(r0);
+
+    CHECK_KIND(r1, JIT_REG_KIND_I32);
+    CHECK_EQKIND(r0, r2);
+    CHECK_REG_NO(reg_no_dst, kind);
+    CHECK_OPND(r2);
+
+    if (!r3)
+        r3 = r0;
+    CHECK_EQKIND(r0, r3);
+    CHECK_OPND(r3);
+
+    switch (kind) {
+        case JIT_REG_KIND_I32:
+            a.csel(regs_i32[reg_no_dst], gp_opnd(cc, a, r2, REG_I64_FREE_IDX),
+                   gp_opnd(cc, a, r3, REG_I64_FREE2_IDX), Imm(cond_codes[op]));
+            break;
+        case JIT_REG_KIND_I64:
+            a.csel(regs_i64[reg_no_dst], gp_opnd(cc, a, r2, REG_I64_FREE_IDX),
+                   gp_opnd(cc, a, r3, REG_I64_FREE2_IDX), Imm(cond_codes[op]));
+            break;
+        case JIT_REG_KIND_F32:
+            a.fcsel(regs_f32[reg_no_dst], fp_opnd(cc, a, r2, REG_F32_FREE_IDX),
+                    fp_opnd(cc, a, r3, REG_FLOAT_FREE2_IDX),
+                    Imm(cond_codes[op]));
+            break;
+        case JIT_REG_KIND_F64:
+            a.fcsel(regs_f64[reg_no_dst], fp_opnd(cc, a, r2, REG_F64_FREE_IDX),
+                    fp_opnd(cc, a, r3, REG_FLOAT_FREE2_IDX),
+                    Imm(cond_codes[op]));
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of select: %d\n", kind);
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn ld: LD_type r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param bytes the byte number of the loaded data
+ * @param is_signed whether the data is sign-extended
+ * @param r0 dst jit register that contains the dst operand info
+ * @param r1 the base, I32 const or I64 register
+ * @param r2 the offset, I32 const or I64 register
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_ld(JitCompContext *cc, a64::Assembler &a, uint32 bytes, bool is_signed,
+         JitReg r0, JitReg r1, JitReg r2)
+{
+    int32 reg_no_dst = jit_reg_no(r0);
+    a64::Mem m;
+
+    CHECK_REG_NO(reg_no_dst, jit_reg_kind(r0));
+    if (!get_mem_opnd(cc, a, r1, r2, bytes, m))
+        GOTO_FAIL;
+
+    switch (jit_reg_kind(r0)) {
+        case JIT_REG_KIND_I32:
+        {
+            const a64::Gp &dst = regs_i32[reg_no_dst];
+            if (bytes == 1)
+                is_signed ? a.ldrsb(dst, m) : a.ldrb(dst, m);
+            else if (bytes == 2)
+                is_signed ? a.ldrsh(dst, m) : a.ldrh(dst, m);
+            else if (bytes == 4)
+                a.ldr(dst, m);
+            else
+                GOTO_FAIL;
+            break;
+        }
+        case JIT_REG_KIND_I64:
+        {
+            /* Loading into the w register zero-extends to 64 bits */
+            const a64::Gp &dst = regs_i64[reg_no_dst];
+            const a64::Gp &dst_w = regs_i32[reg_no_dst];
+            if (bytes == 1)
+                is_signed ? a.ldrsb(dst, m) : a.ldrb(dst_w, m);
+            else if (bytes == 2)
+                is_signed ? a.ldrsh(dst, m) : a.ldrh(dst_w, m);
+            else if (bytes == 4)
+                is_signed ? a.ldrsw(dst, m) : a.ldr(dst_w, m);
+            else if (bytes == 8)
+                a.ldr(dst, m);
+            else
+                GOTO_FAIL;
+            break;
+        }
+        case JIT_REG_KIND_F32:
+            a.ldr(regs_f32[reg_no_dst], m);
+            break;
+        case JIT_REG_KIND_F64:
+            a.ldr(regs_f64[reg_no_dst], m);
+            break;
+        default:
+            LOG_VERBOSE("Invalid reg type of ld: %d\n", jit_reg_kind(r0));
+            GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn st: ST_type r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param bytes the byte number of the stored data
+ * @param atomic whether it's atomic store, which is encoded as the
+ *        store-release insn
+ * @param r0 src jit register that contains the src operand info
+ * @param r1 the base, I32 const or I64 register
+ * @param r2 the offset, I32 const or I64 register
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_st(JitCompContext *cc, a64::Assembler &a, uint32 bytes, bool atomic,
+         JitReg r0, JitReg r1, JitReg r2)
+{
+    uint32 kind = jit_reg_kind(r0);
+    a64::Mem m;
+
+    CHECK_OPND(r0);
+
+    if (kind == JIT_REG_KIND_I32 || kind == JIT_REG_KIND_I64) {
+        a64::Gp src = gp_opnd(cc, a, r0, REG_I64_FREE_IDX);
+
+        if (atomic) {
+            if (!get_addr_to_ip1(cc, a, r1, r2))
+                GOTO_FAIL;
+            m = a64::ptr(regs_i64[REG_I64_FREE2_IDX]);
+            if (bytes == 1)
+                a.stlrb(src.w(), m);
+            else if (bytes == 2)
+                a.stlrh(src.w(), m);
+            else if (bytes == 4)
+                a.stlr(src.w(), m);
+            else
+                a.stlr(src, m);
+            return true;
+        }
+
+        if (!get_mem_opnd(cc, a, r1, r2, bytes, m))
+            GOTO_FAIL;
+        if (bytes == 1)
+            a.strb(src.w(), m);
+        else if (bytes == 2)
+            a.strh(src.w(), m);
+        else if (bytes == 4)
+            a.str(src.w(), m);
+        else
+            a.str(src, m);
+    }
+    else if (kind == JIT_REG_KIND_F32 || kind == JIT_REG_KIND_F64) {
+        a64::Vec src = fp_opnd(cc, a, r0, REG_F64_FREE_IDX);
+
+        bh_assert(!atomic);
+        if (!get_mem_opnd(cc, a, r1, r2, bytes, m))
+            GOTO_FAIL;
+        a.str(src, m);
+    }
+    else {
+        LOG_VERBOSE("Invalid reg type of st: %d\n", kind);
+        GOTO_FAIL;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode insn branch: Bcc r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param labels the asmjit labels of the jit labels
+ * @param label_src the index of src label
+ * @param op the condition opcode
+ * @param r0 the cmp register
+ * @param r1 the label to jump to if the condition is true
+ * @param r2 the label to jump to if the condition is false, may be 0
+ * @param is_last_insn if current insn is the last insn of current block
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_branch(JitCompContext *cc, a64::Assembler &a, Label *labels,
+             int32 label_src, COND_OP op, JitReg r0, JitReg r1, JitReg r2,
+             bool is_last_insn)
+{
+    int32 label_dst;
+
+    CHECK_NCONST(r0);
+    CHECK_KIND(r0, JIT_REG_KIND_I32);
+    CHECK_KIND(r1, JIT_REG_KIND_L32);
+
+    CHECK_REG_NO(jit_reg_no(r0), jit_reg_kind(r0));
+
+    /* Jump to the false label with the negated condition if the true
+       label is the next block, see cond_codes for the fp compares */
+    label_dst = jit_reg_no(r1);
+    if (r2 && label_dst < (int32)jit_cc_label_num(cc) - 1 && is_last_insn
+        && label_is_neighboring(cc, label_src, label_dst)) {
+        JitReg r_tmp;
+
+        r_tmp = r1;
+        r1 = r2;
+        r2 = r_tmp;
+        op = not_cond(op);
+    }
+
+    a.b(cond_codes[op], labels[jit_reg_no(r1)]);
+
+    if (r2) {
+        CHECK_KIND(r2, JIT_REG_KIND_L32);
+        jmp_to_label(cc, a, labels, label_src, jit_reg_no(r2), is_last_insn);
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode lookupswitch insn, LOOKUPSWITCH opnd
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param labels the asmjit labels of the jit labels
+ * @param label_src the index of src label
+ * @param opnd the lookup switch operand
+ * @param is_last_insn if current insn is the last insn of current block
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_lookupswitch(JitCompContext *cc, a64::Assembler &a, Label *labels,
+                   int32 label_src, const JitOpndLookupSwitch *opnd,
+                   bool is_last_insn)
+{
+    JitReg r0 = opnd->value;
+    const a64::Gp &ip0 = regs_i64[REG_I64_FREE_IDX];
+    const a64::Gp &ip1 = regs_i64[REG_I64_FREE2_IDX];
+    a64::Gp key;
+    uint32 i;
+    int32 value;
+
+    CHECK_KIND(r0, JIT_REG_KIND_I32);
+    CHECK_KIND(opnd->default_target, JIT_REG_KIND_L32);
+
+    if (jit_reg_is_const(r0)) {
+        value = jit_cc_get_const_I32(cc, r0);
+        for (i = 0; i < opnd->match_pairs_num; i++)
+            if (value == opnd->match_pairs[i].value) {
+                jmp_to_label(cc, a, labels, label_src,
+                             jit_reg_no(opnd->match_pairs[i].target),
+                             is_last_insn);
+                return true;
+            }
+
+        if (opnd->default_target)
+            jmp_to_label(cc, a, labels, label_src,
+                         jit_reg_no(opnd->default_target), is_last_insn);
+        return true;
+    }
+
+    CHECK_I32_REG_NO(jit_reg_no(r0));
+    key = regs_i32[jit_reg_no(r0)];
+
+    if (opnd->match_pairs_num < 10) {
+        /* For small count of branches, it is better to compare
+           the key with branch value and jump one by one */
+        for (i = 0; i < opnd->match_pairs_num; i++) {
+            value = opnd->match_pairs[i].value;
+            if (is_arith_imm(value))
+                a.cmp(key, Imm(value));
+            else if (is_arith_imm(-(int64)value))
+                a.cmn(key, Imm(-(int64)value));
+            else {
+                mov_imm_to_r_i32(a, REG_I32_FREE_IDX, value);
+                a.cmp(key, regs_i32[REG_I32_FREE_IDX]);
+            }
+            a.b(arm::CondCode::kEQ,
+                labels[jit_reg_no(opnd->match_pairs[i].target)]);
+        }
+
+        if (opnd->default_target)
+            jmp_to_label(cc, a, labels, label_src,
+                         jit_reg_no(opnd->default_target), is_last_insn);
+    }
+    else {
+        /* For bigger count of branches, use the table of the offsets
+           of the targets relative to the table */
+        Label table = a.newLabel();
+
+        if (is_arith_imm(opnd->match_pairs_num))
+            a.cmp(key, Imm(opnd->match_pairs_num));
+        else {
+            mov_imm_to_r_i32(a, REG_I32_FREE_IDX,
+                             (int32)opnd->match_pairs_num);
+            a.cmp(key, regs_i32[REG_I32_FREE_IDX]);
+        }
+        /* Jump to default label if key >= br_count */
+        a.b(arm::CondCode::kHS, labels[jit_reg_no(opnd->default_target)]);
+
+        a.adr(ip1, table);
+        /* zero-extend the key to ip0 */
+        a.mov(regs_i32[REG_I32_FREE_IDX], key);
+        a.ldrsw(ip0, a64::ptr(ip1, ip0, arm::lsl(2)));
+        a.add(ip1, ip1, ip0);
+        a.br(ip1);
+
+        a.bind(table);
+        for (i = 0; i < opnd->match_pairs_num; i++)
+            a.embedLabelDelta(labels[jit_reg_no(opnd->match_pairs[i].target)],
+                              table, 4);
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Encode callnative insn, CALLNATIVE r0, r1, ...
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param insn current insn info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_callnative(JitCompContext *cc, a64::Assembler &a, JitInsn *insn)
+{
+    void (*func_ptr)(void);
+    JitReg ret_reg, func_reg, arg_reg;
+    uint32 i, opnd_num;
+    int32 integer_reg_index = 0, floatpoint_reg_index = 0;
+
+    ret_reg = *(jit_insn_opndv(insn, 0));
+    func_reg = *(jit_insn_opndv(insn, 1));
+    CHECK_KIND(func_reg, JIT_REG_KIND_I64);
+    CHECK_CONST(func_reg);
+
+    func_ptr = (void (*)(void))jit_cc_get_const_I64(cc, func_reg);
+
+    opnd_num = jit_insn_opndv_num(insn);
+    for (i = 0; i < opnd_num - 2; i++) {
+        /*TODO: if arguments number is greater than 8 */
+        bh_assert(integer_reg_index < 8);
+        bh_assert(floatpoint_reg_index < 8);
+
+        arg_reg = *(jit_insn_opndv(insn, i + 2));
+        CHECK_OPND(arg_reg);
+        switch (jit_reg_kind(arg_reg)) {
+            case JIT_REG_KIND_I32:
+            {
+                int32 reg_no = integer_reg_index++;
+                if (jit_reg_is_const(arg_reg))
+                    mov_imm_to_r_i64(a, reg_no,
+                                     (int64)jit_cc_get_const_I32(cc, arg_reg));
+                else
+                    a.sxtw(regs_i64[reg_no], regs_i32[jit_reg_no(arg_reg)]);
+                break;
+            }
+            case JIT_REG_KIND_I64:
+            {
+                int32 reg_no = integer_reg_index++;
+                if (jit_reg_is_const(arg_reg))
+                    mov_imm_to_r_i64(a, reg_no,
+                                     jit_cc_get_const_I64(cc, arg_reg));
+                else if (jit_reg_no(arg_reg) != reg_no)
+                    a.mov(regs_i64[reg_no], regs_i64[jit_reg_no(arg_reg)]);
+                break;
+            }
+            case JIT_REG_KIND_F32:
+            {
+                int32 reg_no = floatpoint_reg_index++;
+                if (jit_reg_is_const(arg_reg))
+                    mov_imm_to_r_f32(a, reg_no,
+                                     jit_cc_get_const_F32(cc, arg_reg));
+                else if (jit_reg_no(arg_reg) != reg_no)
+                    a.fmov(regs_f32[reg_no], regs_f32[jit_reg_no(arg_reg)]);
+                break;
+            }
+            case JIT_REG_KIND_F64:
+            {
+                int32 reg_no = floatpoint_reg_index++;
+                if (jit_reg_is_const(arg_reg))
+                    mov_imm_to_r_f64(a, reg_no,
+                                     jit_cc_get_const_F64(cc, arg_reg));
+                else if (jit_reg_no(arg_reg) != reg_no)
+                    a.fmov(regs_f64[reg_no], regs_f64[jit_reg_no(arg_reg)]);
+                break;
+            }
+            default:
+            {
+                bh_assert(0);
+                goto fail;
+            }
+        }
+    }
+
+    mov_imm_to_r_i64(a, REG_I64_FREE_IDX, (int64)(uintptr_t)func_ptr);
+    a.blr(regs_i64[REG_I64_FREE_IDX]);
+
+    if (ret_reg) {
+        uint32 ret_reg_no = jit_reg_no(ret_reg);
+        if (jit_reg_kind(ret_reg) == JIT_REG_KIND_I64) {
+            CHECK_I64_REG_NO(ret_reg_no);
+            /* mov res, x0 */
+            if (ret_reg_no != REG_X0_IDX)
+                a.mov(regs_i64[ret_reg_no], regs_i64[REG_X0_IDX]);
+        }
+        else if (jit_reg_kind(ret_reg) == JIT_REG_KIND_F64) {
+            CHECK_F64_REG_NO(ret_reg_no);
+            /* mov res, d0 */
+            if (ret_reg_no != 0)
+                a.fmov(regs_f64[ret_reg_no], regs_f64[0]);
+        }
+        else {
+            bh_assert((jit_reg_kind(ret_reg) == JIT_REG_KIND_I32
+                       && ret_reg_no == REG_W0_IDX)
+                      || (jit_reg_kind(ret_reg) == JIT_REG_KIND_F32
+                          && ret_reg_no == 0));
+        }
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Get the hard register which passes the return value of the jitted
+ * functions
+ *
+ * @param kind the kind of the return value
+ *
+ * @return the hard register, 0 if the kind is invalid
+ */
+static JitReg
+get_jitted_ret_hreg(uint32 kind)
+{
+    switch (kind) {
+        case JIT_REG_KIND_I32:
+        case JIT_REG_KIND_I64:
+            return jit_reg_new(kind, REG_RET_IDX);
+        case JIT_REG_KIND_F32:
+        case JIT_REG_KIND_F64:
+            return jit_reg_new(kind, 0);
+        default:
+            bh_assert(0);
+            return 0;
+    }
+}
+
+/**
+ * Encode callbc insn, CALLBC r0, r1, r2
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param insn current insn info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_callbc(JitCompContext *cc, a64::Assembler &a, JitInsn *insn)
+{
+    JitReg ret_reg = *(jit_insn_opnd(insn, 0));
+    JitReg func_reg = *(jit_insn_opnd(insn, 2));
+    JitReg func_idx = *(jit_insn_opnd(insn, 3));
+    JitReg src_reg;
+    int32 func_reg_no;
+    Label label_ret = a.newLabel();
+    a64::Mem m;
+
+    CHECK_KIND(func_reg, JIT_REG_KIND_I64);
+    func_reg_no = jit_reg_no(func_reg);
+    CHECK_I64_REG_NO(func_reg_no);
+
+    /* x2 = func_idx, zero-extended */
+    CHECK_KIND(func_idx, JIT_REG_KIND_I32);
+    if (jit_reg_is_const(func_idx)) {
+        mov_imm_to_r_i32(a, REG_RET_IDX, jit_cc_get_const_I32(cc, func_idx));
+    }
+    else {
+        CHECK_I32_REG_NO(jit_reg_no(func_idx));
+        a.mov(regs_i32[REG_RET_IDX], regs_i32[jit_reg_no(func_idx)]);
+    }
+
+    /* Store the address to return to in the wasm frame, where the
+       callee's RETURNBC jumps back */
+    a.adr(regs_i64[REG_I64_FREE_IDX], label_ret);
+    m = mem_base_offset(a, regs_i64[REG_FP_IDX],
+                        cc->jitted_return_address_offset, 8);
+    a.str(regs_i64[REG_I64_FREE_IDX], m);
+    a.br(regs_i64[func_reg_no]);
+    a.bind(label_ret);
+
+    if (ret_reg) {
+        if (!(src_reg = get_jitted_ret_hreg(jit_reg_kind(ret_reg))))
+            return false;
+        if (!lower_mov(cc, a, ret_reg, src_reg))
+            return false;
+    }
+    return true;
+fail:
+    return false;
+}
+
+static bool
+lower_returnbc(JitCompContext *cc, a64::Assembler &a, JitInsn *insn)
+{
+    JitReg act_reg = *(jit_insn_opnd(insn, 0));
+    JitReg ret_reg = *(jit_insn_opnd(insn, 1));
+    JitReg dst_reg;
+    a64::Mem m;
+    int32 act;
+
+    CHECK_CONST(act_reg);
+    CHECK_KIND(act_reg, JIT_REG_KIND_I32);
+
+    act = jit_cc_get_const_I32(cc, act_reg);
+
+    if (ret_reg) {
+        if (!(dst_reg = get_jitted_ret_hreg(jit_reg_kind(ret_reg))))
+            return false;
+        if (!lower_mov(cc, a, dst_reg, ret_reg))
+            return false;
+    }
+
+    /* w0 = act */
+    mov_imm_to_r_i32(a, REG_W0_IDX, act);
+    /* jump to the return address stored by the caller */
+    m = mem_base_offset(a, regs_i64[REG_FP_IDX],
+                        cc->jitted_return_address_offset, 8);
+    a.ldr(regs_i64[REG_I64_FREE_IDX], m);
+    a.br(regs_i64[REG_I64_FREE_IDX]);
+    return true;
+fail:
+    return false;
+}
+
+static bool
+lower_return(JitCompContext *cc, a64::Assembler &a, JitInsn *insn)
+{
+    JitReg act_reg = *(jit_insn_opnd(insn, 0));
+    int32 act;
+
+    CHECK_CONST(act_reg);
+    CHECK_KIND(act_reg, JIT_REG_KIND_I32);
+
+    act = jit_cc_get_const_I32(cc, act_reg);
+
+    /* w0 = act */
+    mov_imm_to_r_i32(a, REG_W0_IDX, act);
+    mov_imm_to_r_i64(a, REG_I64_FREE_IDX,
+                     (int64)(uintptr_t)code_block_return_to_interp_from_jitted);
+    a.br(regs_i64[REG_I64_FREE_IDX]);
+    return true;
+fail:
+    return false;
+}
+
+/**
+ * Copy the generated code into the code cache and make it visible to
+ * the instruction fetch
+ *
+ * @param code the code holder
+ *
+ * @return the code in the code cache, NULL if failed
+ */
+static char *
+commit_code(CodeHolder &code, uint32 *p_code_size)
+{
+    char *code_buf = (char *)code.sectionById(0)->buffer().data();
+    uint32 code_size = code.sectionById(0)->buffer().size();
+    char *stream;
+
+    if (!(stream = (char *)jit_code_cache_alloc(code_size)))
+        return NULL;
+
+    bh_memcpy_s(stream, code_size, code_buf, code_size);
+    /* The instruction and data caches aren't coherent on aarch64 */
+    __builtin___clear_cache(stream, stream + code_size);
+
+    if (p_code_size)
+        *p_code_size = code_size;
+    return stream;
+}
+
+#if WASM_ENABLE_FAST_JIT_DUMP != 0
+static void
+dump_native(char *data, uint32 length)
+{
+    uint32 *insns = (uint32 *)data;
+    uint32 i;
+
+    /* There is no aarch64 disassembler linked, dump the raw insns */
+    for (i = 0; i < length / 4; i++)
+        os_printf("%012" PRIxPTR "  %08" PRIx32 "\n", (uintptr_t)(insns + i),
+                  insns[i]);
+}
+#endif
+
+bool
+jit_codegen_gen_native(JitCompContext *cc)
+{
+    JitBasicBlock *block;
+    JitInsn *insn;
+    JitReg r0, r1, r2, r3;
+    uint32 label_index, label_num, i, code_size;
+    Label *labels = NULL;
+    bool return_value = false, is_last_insn;
+    void **jitted_addr;
+    char *stream;
+
+    JitErrorHandler err_handler;
+    Environment env(Arch::kAArch64);
+    CodeHolder code;
+    code.init(env);
+    code.setErrorHandler(&err_handler);
+    a64::Assembler a(&code);
+
+    label_num = jit_cc_label_num(cc);
+
+    if (!(labels = (Label *)jit_calloc(((uint32)sizeof(Label)) * label_num))) {
+        jit_set_last_error(cc, "allocate memory failed");
+        goto fail;
+    }
+
+    /* Use the asmjit labels for the branches, they are resolved when
+       the blocks are bound, so no jmp info list is needed to patch the
+       jumps later */
+    for (i = 0; i < label_num; i++)
+        labels[i] = a.newLabel();
+
+    for (i = 0; i < label_num; i++) {
+        if (i == 0)
+            label_index = 0;
+        else if (i == label_num - 1)
+            label_index = 1;
+        else
+            label_index = i + 1;
+
+        a.bind(labels[label_index]);
+
+        block = *jit_annl_basic_block(
+            cc, jit_reg_new(JIT_REG_KIND_L32, label_index));
+
+#if CODEGEN_DUMP != 0
+        os_printf("\nL%d:\n\n", label_index);
+#endif
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            is_last_insn = (insn->next == block) ? true : false;
+
+#if CODEGEN_DUMP != 0
+            os_printf("\n");
+            jit_dump_insn(cc, insn);
+#endif
+            switch (insn->opcode) {
+                case JIT_OP_MOV:
+                    LOAD_2ARGS();
+                    if (!lower_mov(cc, a, r0, r1))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_I8TOI32:
+                case JIT_OP_I8TOI64:
+                case JIT_OP_I16TOI32:
+                case JIT_OP_I16TOI64:
+                case JIT_OP_I32TOI8:
+                case JIT_OP_I32TOU8:
+                case JIT_OP_I32TOI16:
+                case JIT_OP_I32TOU16:
+                case JIT_OP_I32TOI64:
+                case JIT_OP_U32TOI64:
+                case JIT_OP_I32TOF32:
+                case JIT_OP_U32TOF32:
+                case JIT_OP_I32TOF64:
+                case JIT_OP_U32TOF64:
+                case JIT_OP_I64TOI8:
+                case JIT_OP_I64TOI16:
+                case JIT_OP_I64TOI32:
+                case JIT_OP_I64TOF32:
+                case JIT_OP_I64TOF64:
+                case JIT_OP_F32TOI32:
+                case JIT_OP_F32TOI64:
+                case JIT_OP_F32TOF64:
+                case JIT_OP_F32TOU32:
+                case JIT_OP_F64TOI32:
+                case JIT_OP_F64TOI64:
+                case JIT_OP_F64TOF32:
+                case JIT_OP_F64TOU32:
+                    LOAD_2ARGS();
+                    if (!lower_convert(cc, a, insn->opcode, r0, r1))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_NEG:
+                    LOAD_2ARGS();
+                    if (!lower_neg(cc, a, r0, r1))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_ADD:
+                case JIT_OP_SUB:
+                case JIT_OP_MUL:
+                case JIT_OP_DIV_S:
+                case JIT_OP_REM_S:
+                case JIT_OP_DIV_U:
+                case JIT_OP_REM_U:
+                    LOAD_3ARGS();
+                    if (!lower_alu(cc, a,
+                                   (ALU_OP)(ADD + (insn->opcode - JIT_OP_ADD)),
+                                   r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_SHL:
+                case JIT_OP_SHRS:
+                case JIT_OP_SHRU:
+                case JIT_OP_ROTL:
+                case JIT_OP_ROTR:
+                    LOAD_3ARGS();
+                    if (!lower_shift(
+                            cc, a,
+                            (SHIFT_OP)(SHL + (insn->opcode - JIT_OP_SHL)), r0,
+                            r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_OR:
+                case JIT_OP_XOR:
+                case JIT_OP_AND:
+                    LOAD_3ARGS();
+                    if (!lower_bit(cc, a,
+                                   (BIT_OP)(OR + (insn->opcode - JIT_OP_OR)),
+                                   r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_CLZ:
+                case JIT_OP_CTZ:
+                case JIT_OP_POPCNT:
+                    LOAD_2ARGS();
+                    if (!lower_bitcount(
+                            cc, a,
+                            (BITCOUNT_OP)(CLZ + (insn->opcode - JIT_OP_CLZ)),
+                            r0, r1))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_CMP:
+                    LOAD_3ARGS();
+                    if (!lower_cmp(cc, a, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_SELECTEQ:
+                case JIT_OP_SELECTNE:
+                case JIT_OP_SELECTGTS:
+                case JIT_OP_SELECTGES:
+                case JIT_OP_SELECTLTS:
+                case JIT_OP_SELECTLES:
+                case JIT_OP_SELECTGTU:
+                case JIT_OP_SELECTGEU:
+                case JIT_OP_SELECTLTU:
+                case JIT_OP_SELECTLEU:
+                    LOAD_4ARGS();
+                    if (!lower_select(
+                            cc, a,
+                            (COND_OP)(EQ + (insn->opcode - JIT_OP_SELECTEQ)),
+                            r0, r1, r2, r3))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_LDEXECENV:
+                    LOAD_1ARG();
+                    CHECK_KIND(r0, JIT_REG_KIND_I32);
+                    /* TODO */
+                    break;
+
+                case JIT_OP_LDJITINFO:
+                    LOAD_1ARG();
+                    CHECK_KIND(r0, JIT_REG_KIND_I32);
+                    /* TODO */
+                    break;
+
+                case JIT_OP_LDI8:
+                case JIT_OP_LDU8:
+                case JIT_OP_LDI16:
+                case JIT_OP_LDU16:
+                case JIT_OP_LDI32:
+                case JIT_OP_LDU32:
+                {
+                    /* LDI8, LDU8, LDI16, LDU16, LDI32, LDU32 */
+                    uint32 n = insn->opcode - JIT_OP_LDI8;
+                    LOAD_3ARGS();
+                    bh_assert(jit_reg_kind(r0) == JIT_REG_KIND_I32
+                              || jit_reg_kind(r0) == JIT_REG_KIND_I64);
+                    if (!lower_ld(cc, a, 1 << (n / 2), !(n & 1), r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+                }
+
+                case JIT_OP_LDI64:
+                case JIT_OP_LDU64:
+                case JIT_OP_LDPTR:
+                    LOAD_3ARGS();
+                    CHECK_KIND(r0, JIT_REG_KIND_I64);
+                    if (!lower_ld(cc, a, 8, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_LDF32:
+                    LOAD_3ARGS();
+                    CHECK_KIND(r0, JIT_REG_KIND_F32);
+                    if (!lower_ld(cc, a, 4, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_LDF64:
+                    LOAD_3ARGS();
+                    CHECK_KIND(r0, JIT_REG_KIND_F64);
+                    if (!lower_ld(cc, a, 8, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STI8:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_I32);
+                    if (!lower_st(cc, a, 1, insn->flags_u8 & 0x1, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STI16:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_I32);
+                    if (!lower_st(cc, a, 2, insn->flags_u8 & 0x1, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STI32:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_I32);
+                    if (!lower_st(cc, a, 4, insn->flags_u8 & 0x1, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STI64:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_I64);
+                    if (!lower_st(cc, a, 8, insn->flags_u8 & 0x1, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STPTR:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_I64);
+                    if (!lower_st(cc, a, 8, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STF32:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_F32);
+                    if (!lower_st(cc, a, 4, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_STF64:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    CHECK_KIND(r0, JIT_REG_KIND_F64);
+                    if (!lower_st(cc, a, 8, false, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_JMP:
+                    LOAD_1ARG();
+                    CHECK_KIND(r0, JIT_REG_KIND_L32);
+                    jmp_to_label(cc, a, labels, label_index, jit_reg_no(r0),
+                                 is_last_insn);
+                    break;
+
+                case JIT_OP_BEQ:
+                case JIT_OP_BNE:
+                case JIT_OP_BGTS:
+                case JIT_OP_BGES:
+                case JIT_OP_BLTS:
+                case JIT_OP_BLES:
+                case JIT_OP_BGTU:
+                case JIT_OP_BGEU:
+                case JIT_OP_BLTU:
+                case JIT_OP_BLEU:
+                    LOAD_3ARGS();
+                    if (!lower_branch(
+                            cc, a, labels, label_index,
+                            (COND_OP)(EQ + (insn->opcode - JIT_OP_BEQ)), r0, r1,
+                            r2, is_last_insn))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_LOOKUPSWITCH:
+                {
+                    JitOpndLookupSwitch *opnd = jit_insn_opndls(insn);
+                    if (!lower_lookupswitch(cc, a, labels, label_index, opnd,
+                                            is_last_insn))
+                        GOTO_FAIL;
+                    break;
+                }
+
+                case JIT_OP_CALLNATIVE:
+                    if (!lower_callnative(cc, a, insn))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_CALLBC:
+                    if (!lower_callbc(cc, a, insn))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_RETURNBC:
+                    if (!lower_returnbc(cc, a, insn))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_RETURN:
+                    if (!lower_return(cc, a, insn))
+                        GOTO_FAIL;
+                    break;
+
+                case JIT_OP_I32CASTF32:
+                case JIT_OP_I64CASTF64:
+                case JIT_OP_F32CASTI32:
+                case JIT_OP_F64CASTI64:
+                    LOAD_2ARGS();
+                    if (!lower_cast(cc, a, r0, r1))
+                        GOTO_FAIL;
+                    break;
+
+                default:
+                    jit_set_last_error_v(cc, "unsupported JIT opcode 0x%2x",
+                                         insn->opcode);
+                    GOTO_FAIL;
+            }
+
+            if (err_handler.err) {
+                jit_set_last_error_v(cc,
+                                     "failed to generate native code for JIT "
+                                     "opcode 0x%02x, ErrorCode is %u",
+                                     insn->opcode, err_handler.err);
+                GOTO_FAIL;
+            }
+        }
+    }
+
+    if (!(stream = commit_code(code, &code_size))) {
+        jit_set_last_error(cc, "allocate memory failed");
+        goto fail;
+    }
+
+    cc->jitted_addr_begin = stream;
+    cc->jitted_addr_end = stream + code_size;
+
+    for (i = 0; i < label_num; i++) {
+        jitted_addr =
+            jit_annl_jitted_addr(cc, jit_reg_new(JIT_REG_KIND_L32, i));
+        *jitted_addr = stream + code.labelOffset(labels[i]);
+    }
+
+#if CODEGEN_DUMP != 0
+    dump_native(stream, code_size);
+#endif
+
+    return_value = true;
+
+fail:
+
+    jit_free(labels);
+    return return_value;
+}
+
+bool
+jit_codegen_lower(JitCompContext *cc)
+{
+    (void)cc;
+    return true;
+}
+
+void
+jit_codegen_free_native(JitCompContext *cc)
+{
+    (void)cc;
+}
+
+void
+jit_codegen_dump_native(void *begin_addr, void *end_addr)
+{
+#if WASM_ENABLE_FAST_JIT_DUMP != 0
+    os_printf("\n");
+    dump_native((char *)begin_addr, (char *)end_addr - (char *)begin_addr);
+    os_printf("\n");
+#else
+    (void)begin_addr;
+    (void)end_addr;
+#endif
+}
+
+/* The size of the native stack frame of the switch_to_jitted block:
+   x29, x30, x19 ~ x28, d8 ~ d15 and info, aligned to 16 bytes */
+#define SWITCH_FRAME_SIZE 176
+#define SWITCH_FRAME_INFO_OFFSET 160
+
+bool
+jit_codegen_init()
+{
+    const JitHardRegInfo *hreg_info = jit_codegen_get_hreg_info();
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    char *stream;
+
+    JitErrorHandler err_handler;
+    Environment env(Arch::kAArch64);
+    CodeHolder code;
+    code.init(env);
+    code.setErrorHandler(&err_handler);
+    a64::Assembler a(&code);
+
+    /* Initialize code_block_switch_to_jitted_from_interp, which is called
+       with x0 = exec_env, x1 = info, w2 = func_idx and x3 = target */
+
+    /* push the frame record and callee-save registers */
+    a.stp(a64::x29, a64::x30, a64::ptr_pre(a64::sp, -SWITCH_FRAME_SIZE));
+    a.mov(a64::x29, a64::sp);
+    a.stp(a64::x19, a64::x20, a64::ptr(a64::sp, 16));
+    a.stp(a64::x21, a64::x22, a64::ptr(a64::sp, 32));
+    a.stp(a64::x23, a64::x24, a64::ptr(a64::sp, 48));
+    a.stp(a64::x25, a64::x26, a64::ptr(a64::sp, 64));
+    a.stp(a64::x27, a64::x28, a64::ptr(a64::sp, 80));
+    a.stp(a64::d8, a64::d9, a64::ptr(a64::sp, 96));
+    a.stp(a64::d10, a64::d11, a64::ptr(a64::sp, 112));
+    a.stp(a64::d12, a64::d13, a64::ptr(a64::sp, 128));
+    a.stp(a64::d14, a64::d15, a64::ptr(a64::sp, 144));
+    /* push info */
+    a.str(a64::x1, a64::ptr(a64::sp, SWITCH_FRAME_INFO_OFFSET));
+
+    /* exec_env_reg = exec_env */
+    a.mov(regs_i64[hreg_info->exec_env_hreg_index], a64::x0);
+    /* fp_reg = info->frame */
+    a.ldr(regs_i64[hreg_info->fp_hreg_index],
+          a64::ptr(a64::x1, offsetof(JitInterpSwitchInfo, frame)));
+    /* x2 = func_idx, zero-extend it as the upper bits of the uint32
+       argument are unspecified */
+    a.mov(a64::w2, a64::w2);
+    /* jmp target */
+    a.br(a64::x3);
+
+    if (err_handler.err)
+        return false;
+
+    if (!(stream = commit_code(code, NULL)))
+        return false;
+    code_block_switch_to_jitted_from_interp = stream;
+
+    /* Initialize code_block_return_to_interp_from_jitted, w0 is the
+       action and must be kept */
+
+    a.setOffset(0);
+
+    /* pop info */
+    a.ldr(a64::x1, a64::ptr(a64::sp, SWITCH_FRAME_INFO_OFFSET));
+    /* info->frame = fp_reg */
+    a.str(regs_i64[hreg_info->fp_hreg_index],
+          a64::ptr(a64::x1, offsetof(JitInterpSwitchInfo, frame)));
+    /* info->out.ret.ival[0, 1] = x2 */
+    a.str(a64::x2,
+          a64::ptr(a64::x1, offsetof(JitInterpSwitchInfo, out.ret.ival)));
+    /* info->out.ret.fval[0, 1] = d0 */
+    a.str(a64::d0,
+          a64::ptr(a64::x1, offsetof(JitInterpSwitchInfo, out.ret.fval)));
+
+    /* pop callee-save registers and the frame record */
+    a.ldp(a64::d14, a64::d15, a64::ptr(a64::sp, 144));
+    a.ldp(a64::d12, a64::d13, a64::ptr(a64::sp, 128));
+    a.ldp(a64::d10, a64::d11, a64::ptr(a64::sp, 112));
+    a.ldp(a64::d8, a64::d9, a64::ptr(a64::sp, 96));
+    a.ldp(a64::x27, a64::x28, a64::ptr(a64::sp, 80));
+    a.ldp(a64::x25, a64::x26, a64::ptr(a64::sp, 64));
+    a.ldp(a64::x23, a64::x24, a64::ptr(a64::sp, 48));
+    a.ldp(a64::x21, a64::x22, a64::ptr(a64::sp, 32));
+    a.ldp(a64::x19, a64::x20, a64::ptr(a64::sp, 16));
+    a.ldp(a64::x29, a64::x30, a64::ptr_post(a64::sp, SWITCH_FRAME_SIZE));
+    a.ret(a64::x30);
+
+    if (err_handler.err)
+        goto fail1;
+
+    if (!(stream = commit_code(code, NULL)))
+        goto fail1;
+    code_block_return_to_interp_from_jitted =
+        jit_globals->return_to_interp_from_jitted = stream;
+
+#if WASM_ENABLE_LAZY_JIT != 0
+    /* Initialize code_block_compile_fast_jit_and_then_call */
+
+    a.setOffset(0);
+
+    {
+        Label label_compiled = a.newLabel();
+
+        /* Use x19, x20, x21 to save func_idx, module_inst and module,
+           as they are callee-save registers, and they are free here
+           since the caller has spilled the registers of jitted code */
+
+        /* Backup func_idx: w19 = w2 = func_idx, note that x2 has
+           been prepared in the caller:
+             callbc or code_block_switch_to_jitted_from_interp */
+        a.mov(a64::w19, a64::w2);
+        /* x20 = module_inst = exec_env->module_inst */
+        a.ldr(a64::x20, a64::ptr(regs_i64[hreg_info->exec_env_hreg_index],
+                                 (uint32)offsetof(WASMExecEnv, module_inst)));
+        /* x0 = x21 = module_inst->module */
+        a.ldr(a64::x21,
+              a64::ptr(a64::x20, (uint32)offsetof(WASMModuleInstance, module)));
+        a.mov(a64::x0, a64::x21);
+        /* w1 = func_idx */
+        a.mov(a64::w1, a64::w19);
+        /* Call jit_compiler_compile(module, func_idx) */
+        mov_imm_to_r_i64(a, REG_I64_FREE_IDX,
+                         (int64)(uintptr_t)jit_compiler_compile);
+        a.blr(regs_i64[REG_I64_FREE_IDX]);
+
+        /* Did jit_compiler_compile return false? If no, jump to
+           `Load compiled func ptr and call it` */
+        a.tst(a64::w0, Imm(0xFF));
+        a.b(arm::CondCode::kNE, label_compiled);
+
+        /* If yes, call jit_set_exception_with_id to throw exception,
+           and then set w0 to JIT_INTERP_ACTION_THROWN, and jump to
+           code_block_return_to_interp_from_jitted to return */
+
+        /* x0 = module_inst */
+        a.mov(a64::x0, a64::x20);
+        /* w1 = EXCE_FAILED_TO_COMPILE_FAST_JIT_FUNC */
+        mov_imm_to_r_i32(a, 1, EXCE_FAILED_TO_COMPILE_FAST_JIT_FUNC);
+        /* Call jit_set_exception_with_id */
+        mov_imm_to_r_i64(a, REG_I64_FREE_IDX,
+                         (int64)(uintptr_t)jit_set_exception_with_id);
+        a.blr(regs_i64[REG_I64_FREE_IDX]);
+        /* Return to the caller */
+        mov_imm_to_r_i32(a, REG_W0_IDX, JIT_INTERP_ACTION_THROWN);
+        mov_imm_to_r_i64(
+            a, REG_I64_FREE_IDX,
+            (int64)(uintptr_t)code_block_return_to_interp_from_jitted);
+        a.br(regs_i64[REG_I64_FREE_IDX]);
+
+        /* Load compiled func ptr and call it */
+        a.bind(label_compiled);
+        /* w16 = module->import_function_count */
+        a.ldr(a64::w16,
+              a64::ptr(a64::x21,
+                       (uint32)offsetof(WASMModule, import_function_count)));
+        /* w19 = w19 - module->import_function_count */
+        a.sub(a64::w19, a64::w19, a64::w16);
+        /* x16 = module->fast_jit_func_ptrs */
+        a.ldr(a64::x16,
+              a64::ptr(a64::x21,
+                       (uint32)offsetof(WASMModule, fast_jit_func_ptrs)));
+        /* x16 = fast_jit_func_ptrs[x19] */
+        a.ldr(a64::x16, a64::ptr(a64::x16, a64::x19, arm::lsl(3)));
+        a.br(a64::x16);
+    }
+
+    if (err_handler.err)
+        goto fail2;
+
+    if (!(stream = commit_code(code, NULL)))
+        goto fail2;
+    code_block_compile_fast_jit_and_then_call =
+        jit_globals->compile_fast_jit_and_then_call = stream;
+#endif /* end of WASM_ENABLE_LAZY_JIT != 0 */
+
+    return true;
+
+#if WASM_ENABLE_LAZY_JIT != 0
+fail2:
+    jit_code_cache_free(code_block_return_to_interp_from_jitted);
+#endif
+fail1:
+    jit_code_cache_free(code_block_switch_to_jitted_from_interp);
+    return false;
+}
+
+void
+jit_codegen_destroy()
+{
+#if WASM_ENABLE_LAZY_JIT != 0
+    jit_code_cache_free(code_block_compile_fast_jit_and_then_call);
+#endif
+    jit_code_cache_free(code_block_return_to_interp_from_jitted);
+    jit_code_cache_free(code_block_switch_to_jitted_from_interp);
+}
+
+/* clang-format off */
+static const uint8 hreg_info_I32[3][31] = {
+    /* w0 ~ w30 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+      1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 }, /* fixed, w16 is cmp */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+      1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* caller_saved_native */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 }  /* caller_saved_jitted */
+};
+
+/* x0 ~ x7 are fixed and used to pass the native arguments, x27 is
+   exec_env, x28 is the frame pointer */
+static const uint8 hreg_info_I64[3][31] = {
+    /* x0 ~ x30 */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 1 }, /* fixed */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+      1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* caller_saved_native */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+      0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0 }  /* caller_saved_jitted */
+};
+
+/* AAPCS64: the lower 64 bits of v8 ~ v15 are callee-saved, v30 and v31
+   are kept as scratch registers */
+static const uint8 hreg_info_F32[3][32] = {
+    /* s0 ~ s31 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1 }, /* fixed */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }, /* caller_saved_native */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0 }  /* caller_saved_jitted */
+};
+
+static const uint8 hreg_info_F64[3][32] = {
+    /* d0 ~ d31 */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 1 }, /* fixed */
+    { 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0,
+      1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 }, /* caller_saved_native */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0 }  /* caller_saved_jitted */
+};
+
+static const JitHardRegInfo g_hreg_info = {
+    {
+        { 0, NULL, NULL, NULL }, /* VOID */
+
+        { sizeof(hreg_info_I32[0]), /* I32 */
+          hreg_info_I32[0],
+          hreg_info_I32[1],
+          hreg_info_I32[2] },
+
+        { sizeof(hreg_info_I64[0]), /* I64 */
+          hreg_info_I64[0],
+          hreg_info_I64[1],
+          hreg_info_I64[2] },
+
+        { sizeof(hreg_info_F32[0]), /* F32 */
+          hreg_info_F32[0],
+          hreg_info_F32[1],
+          hreg_info_F32[2] },
+
+        { sizeof(hreg_info_F64[0]), /* F64 */
+          hreg_info_F64[0],
+          hreg_info_F64[1],
+          hreg_info_F64[2] },
+
+        { 0, NULL, NULL, NULL }, /* V64 */
+        { 0, NULL, NULL, NULL }, /* V128 */
+        { 0, NULL, NULL, NULL }  /* V256 */
+    },
+    /* frame pointer hreg index: x28 */
+    REG_FP_IDX,
+    /* exec_env hreg index: x27 */
+    REG_EXEC_ENV_IDX,
+    /* cmp hreg index: w16 */
+    16
+};
+/* clang-format on */
+
+const JitHardRegInfo *
+jit_codegen_get_hreg_info()
+{
+    return &g_hreg_info;
+}
+
+JitReg
+jit_codegen_get_hreg_by_name(const char *name)
+{
+    char *end;
+    unsigned long no;
+
+    /* The names are w0 ~ w30, x0 ~ x30, s0 ~ s31 and d0 ~ d31 */
+    if (!name[0] || name[1] < '0' || name[1] > '9')
+        return 0;
+    no = strtoul(name + 1, &end, 10);
+    if (*end != '\0')
+        return 0;
+
+    switch (name[0]) {
+        case 'w':
+            if (no < sizeof(regs_i32) / sizeof(regs_i32[0]))
+                return jit_reg_new(JIT_REG_KIND_I32, no);
+            break;
+        case 'x':
+            if (no < sizeof(regs_i64) / sizeof(regs_i64[0]))
+                return jit_reg_new(JIT_REG_KIND_I64, no);
+            break;
+        case 's':
+            if (no < sizeof(regs_f32) / sizeof(regs_f32[0]))
+                return jit_reg_new(JIT_REG_KIND_F32, no);
+            break;
+        case 'd':
+            if (no < sizeof(regs_f64) / sizeof(regs_f64[0]))
+                return jit_reg_new(JIT_REG_KIND_F64, no);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
@@ -248,6 +248,9 @@ jit_codegen_interp_jitted_glue(void *exec_env, JitInterpSwitchInfo *info,
             CHECK_F32_REG_NO(no);                                        \
             CHECK_F64_REG_NO(no);                                        \
         }                                                                \
+        else if (kind == JIT_REG_KIND_V128) {                            \
+            CHECK_F64_REG_NO(no);                                        \
+        }                                                                \
         else                                                             \
             GOTO_FAIL;                                                   \
     } while (0)
@@ -722,7 +725,8 @@ mov_r_to_r(x86::Assembler &a, uint32 kind_dst, int32 reg_no_dst,
  * @param bytes_dst the bytes number of the data,
  *        could be 1(byte), 2(short), 4(int32), 8(int64),
  *        skipped by float and double
- * @param kind_dst the kind of data to move, could be I32, I64, F32 or F64
+ * @param kind_dst the kind of data to move, could be I32, I64, F32, F64
+ *        or V128
  * @param is_signed whether the data is signed or unsigned
  * @param reg_no_dst the index of dest register
  * @param m_src the memory operand which contains the source data
@@ -786,6 +790,12 @@ mov_m_to_r(x86::Assembler &a, uint32 bytes_dst, uint32 kind_dst, bool is_signed,
     else if (kind_dst == JIT_REG_KIND_F64) {
         a.movsd(regs_float[reg_no_dst], m_src);
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (kind_dst == JIT_REG_KIND_V128) {
+        bh_assert(bytes_dst == 16);
+        a.movdqu(regs_float[reg_no_dst], m_src);
+    }
+#endif
     return true;
 }
 
@@ -796,7 +806,8 @@ mov_m_to_r(x86::Assembler &a, uint32 bytes_dst, uint32 kind_dst, bool is_signed,
  * @param bytes_dst the bytes number of the data,
  *        could be 1(byte), 2(short), 4(int32), 8(int64),
  *        skipped by float and double
- * @param kind_dst the kind of data to move, could be I32, I64, F32 or F64
+ * @param kind_dst the kind of data to move, could be I32, I64, F32, F64
+ *        or V128
  * @param is_signed whether the data is signed or unsigned
  * @param m_dst the dest memory operand
  * @param reg_no_src the index of dest register
@@ -850,6 +861,12 @@ mov_r_to_m(x86::Assembler &a, uint32 bytes_dst, uint32 kind_dst,
     else if (kind_dst == JIT_REG_KIND_F64) {
         a.movsd(m_dst, regs_float[reg_no_src]);
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (kind_dst == JIT_REG_KIND_V128) {
+        bh_assert(bytes_dst == 16);
+        a.movdqu(m_dst, regs_float[reg_no_src]);
+    }
+#endif
     return true;
 }
 
@@ -1443,6 +1460,26 @@ mov_r_to_r_f64(x86::Assembler &a, int32 reg_no_dst, int32 reg_no_src)
     return true;
 }
 
+#if WASM_ENABLE_SIMD != 0
+/**
+ * Encode moving 128-bit vector from src register to dst register
+ *
+ * @param a the assembler to emit the code
+ * @param reg_no_dst the no of dst register
+ * @param reg_no_src the no of src register
+ *
+ * @return true if success, false otherwise
+ */
+static bool
+mov_r_to_r_v128(x86::Assembler &a, int32 reg_no_dst, int32 reg_no_src)
+{
+    if (reg_no_dst != reg_no_src) {
+        a.movdqa(regs_float[reg_no_dst], regs_float[reg_no_src]);
+    }
+    return true;
+}
+#endif
+
 /* Let compiler do the conversation job as much as possible */
 
 /**
@@ -4840,6 +4877,16 @@ lower_mov(JitCompContext *cc, x86::Assembler &a, JitReg r0, JitReg r1)
         case JIT_REG_KIND_F64:
             MOV_R_R(F64, float64, f64);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case JIT_REG_KIND_V128:
+            /* There is no v128 constant, it is created by V128SPLAT */
+            CHECK_EQKIND(r0, r1);
+            CHECK_NCONST(r1);
+            CHECK_REG_NO(jit_reg_no(r0), jit_reg_kind(r0));
+            CHECK_REG_NO(jit_reg_no(r1), jit_reg_kind(r1));
+            mov_r_to_r_v128(a, jit_reg_no(r0), jit_reg_no(r1));
+            break;
+#endif
         default:
             LOG_VERBOSE("Invalid reg type of mov: %d\n", jit_reg_kind(r0));
             GOTO_FAIL;
@@ -6165,6 +6212,772 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_SIMD != 0
+/* Scratch register of the 128-bit vector operations */
+#define REG_V128_FREE_IDX REG_F64_FREE_IDX
+
+/* Instructions of each lane shape, 0 if the shape isn't supported */
+typedef uint32 V128InstIds[6];
+
+/* i8x16, i16x8, i32x4, i64x2, f32x4, f64x2 */
+static const V128InstIds v128_add_insts = {
+    x86::Inst::kIdPaddb, x86::Inst::kIdPaddw, x86::Inst::kIdPaddd,
+    x86::Inst::kIdPaddq, x86::Inst::kIdAddps, x86::Inst::kIdAddpd
+};
+static const V128InstIds v128_sub_insts = {
+    x86::Inst::kIdPsubb, x86::Inst::kIdPsubw, x86::Inst::kIdPsubd,
+    x86::Inst::kIdPsubq, x86::Inst::kIdSubps, x86::Inst::kIdSubpd
+};
+static const V128InstIds v128_mul_insts = {
+    0, x86::Inst::kIdPmullw, x86::Inst::kIdPmulld,
+    0, x86::Inst::kIdMulps,  x86::Inst::kIdMulpd
+};
+static const V128InstIds v128_div_insts = {
+    0, 0, 0, 0, x86::Inst::kIdDivps, x86::Inst::kIdDivpd
+};
+static const V128InstIds v128_add_sat_s_insts = {
+    x86::Inst::kIdPaddsb, x86::Inst::kIdPaddsw, 0, 0, 0, 0
+};
+static const V128InstIds v128_add_sat_u_insts = {
+    x86::Inst::kIdPaddusb, x86::Inst::kIdPaddusw, 0, 0, 0, 0
+};
+static const V128InstIds v128_sub_sat_s_insts = {
+    x86::Inst::kIdPsubsb, x86::Inst::kIdPsubsw, 0, 0, 0, 0
+};
+static const V128InstIds v128_sub_sat_u_insts = {
+    x86::Inst::kIdPsubusb, x86::Inst::kIdPsubusw, 0, 0, 0, 0
+};
+static const V128InstIds v128_min_s_insts = {
+    x86::Inst::kIdPminsb, x86::Inst::kIdPminsw, x86::Inst::kIdPminsd, 0, 0, 0
+};
+static const V128InstIds v128_min_u_insts = {
+    x86::Inst::kIdPminub, x86::Inst::kIdPminuw, x86::Inst::kIdPminud, 0, 0, 0
+};
+static const V128InstIds v128_max_s_insts = {
+    x86::Inst::kIdPmaxsb, x86::Inst::kIdPmaxsw, x86::Inst::kIdPmaxsd, 0, 0, 0
+};
+static const V128InstIds v128_max_u_insts = {
+    x86::Inst::kIdPmaxub, x86::Inst::kIdPmaxuw, x86::Inst::kIdPmaxud, 0, 0, 0
+};
+static const V128InstIds v128_avgr_u_insts = {
+    x86::Inst::kIdPavgb, x86::Inst::kIdPavgw, 0, 0, 0, 0
+};
+static const V128InstIds v128_shl_insts = {
+    0, x86::Inst::kIdPsllw, x86::Inst::kIdPslld, x86::Inst::kIdPsllq, 0, 0
+};
+static const V128InstIds v128_shr_s_insts = {
+    0, x86::Inst::kIdPsraw, x86::Inst::kIdPsrad, 0, 0, 0
+};
+static const V128InstIds v128_shr_u_insts = {
+    0, x86::Inst::kIdPsrlw, x86::Inst::kIdPsrld, x86::Inst::kIdPsrlq, 0, 0
+};
+static const V128InstIds v128_cmp_eq_insts = {
+    x86::Inst::kIdPcmpeqb, x86::Inst::kIdPcmpeqw, x86::Inst::kIdPcmpeqd,
+    x86::Inst::kIdPcmpeqq, 0,                     0
+};
+static const V128InstIds v128_cmp_gt_insts = {
+    x86::Inst::kIdPcmpgtb, x86::Inst::kIdPcmpgtw, x86::Inst::kIdPcmpgtd,
+    x86::Inst::kIdPcmpgtq, 0,                     0
+};
+
+/**
+ * Get the value of an I32 constant operand of a SIMD instruction,
+ * such as the lane shape or the lane index
+ */
+static int32
+v128_const_opnd(JitCompContext *cc, JitInsn *insn, unsigned n)
+{
+    JitReg reg = *jit_insn_opnd(insn, n);
+
+    bh_assert(jit_reg_is_const(reg) && jit_reg_kind(reg) == JIT_REG_KIND_I32);
+    return jit_cc_get_const_I32(cc, reg);
+}
+
+/**
+ * Encode dst = src1 op src2 with a two-operand SSE instruction
+ *
+ * @param a the assembler to emit the code
+ * @param inst_id the instruction id of the operation
+ * @param reg_no_dst the no of dst register
+ * @param reg_no1_src the no of the first src register
+ * @param reg_no2_src the no of the second src register
+ */
+static void
+v128_binary_r_r_r(x86::Assembler &a, uint32 inst_id, int32 reg_no_dst,
+                  int32 reg_no1_src, int32 reg_no2_src)
+{
+    if (reg_no_dst == reg_no2_src && reg_no_dst != reg_no1_src) {
+        /* dst will be overwritten before src2 is read, compute the
+           result in the scratch register */
+        a.movdqa(regs_float[REG_V128_FREE_IDX], regs_float[reg_no1_src]);
+        a.emit(inst_id, regs_float[REG_V128_FREE_IDX],
+               regs_float[reg_no2_src]);
+        a.movdqa(regs_float[reg_no_dst], regs_float[REG_V128_FREE_IDX]);
+    }
+    else {
+        mov_r_to_r_v128(a, reg_no_dst, reg_no1_src);
+        a.emit(inst_id, regs_float[reg_no_dst], regs_float[reg_no2_src]);
+    }
+}
+
+/**
+ * Load an integer scalar operand into a general purpose register,
+ * constant is moved into the free register
+ *
+ * @return the no of the register holding the scalar
+ */
+static int32
+v128_load_int_scalar(JitCompContext *cc, x86::Assembler &a, JitReg reg)
+{
+    if (!jit_reg_is_const(reg))
+        return jit_reg_no(reg);
+
+    if (jit_reg_kind(reg) == JIT_REG_KIND_I32)
+        mov_imm_to_r_i32(a, REG_I32_FREE_IDX, jit_cc_get_const_I32(cc, reg));
+    else
+        mov_imm_to_r_i64(a, REG_I64_FREE_IDX, jit_cc_get_const_I64(cc, reg));
+    /* REG_I32_FREE_IDX == REG_I64_FREE_IDX */
+    return REG_I64_FREE_IDX;
+}
+
+/**
+ * Load a float scalar operand into a xmm register, constant is moved
+ * into the scratch register
+ *
+ * @return the no of the register holding the scalar
+ */
+static int32
+v128_load_float_scalar(JitCompContext *cc, x86::Assembler &a, JitReg reg)
+{
+    if (!jit_reg_is_const(reg))
+        return jit_reg_no(reg);
+
+    if (jit_reg_kind(reg) == JIT_REG_KIND_F32)
+        mov_imm_to_r_f32(a, REG_V128_FREE_IDX, jit_cc_get_const_F32(cc, reg));
+    else
+        mov_imm_to_r_f64(a, REG_V128_FREE_IDX, jit_cc_get_const_F64(cc, reg));
+    return REG_V128_FREE_IDX;
+}
+
+/**
+ * Encode insn V128SPLAT r0, r1, shape
+ */
+static bool
+lower_v128_splat(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    JitReg r0 = *jit_insn_opnd(insn, 0), r1 = *jit_insn_opnd(insn, 1);
+    int32 shape = v128_const_opnd(cc, insn, 2);
+    x86::Xmm dst = regs_float[jit_reg_no(r0)];
+    int32 reg_no_src;
+
+    if (shape <= JIT_V128_I64X2 && jit_reg_is_const(r1)) {
+        int64 value = jit_reg_kind(r1) == JIT_REG_KIND_I32
+                          ? jit_cc_get_const_I32(cc, r1)
+                          : jit_cc_get_const_I64(cc, r1);
+        /* All zeros is common for v128.const and load zero */
+        if (value == 0) {
+            a.pxor(dst, dst);
+            return true;
+        }
+    }
+
+    switch (shape) {
+        case JIT_V128_I8X16:
+            reg_no_src = v128_load_int_scalar(cc, a, r1);
+            a.movd(dst, regs_i32[reg_no_src]);
+            a.pxor(regs_float[REG_V128_FREE_IDX],
+                   regs_float[REG_V128_FREE_IDX]);
+            a.pshufb(dst, regs_float[REG_V128_FREE_IDX]);
+            break;
+        case JIT_V128_I16X8:
+            reg_no_src = v128_load_int_scalar(cc, a, r1);
+            a.movd(dst, regs_i32[reg_no_src]);
+            a.pshuflw(dst, dst, Imm(0));
+            a.pshufd(dst, dst, Imm(0));
+            break;
+        case JIT_V128_I32X4:
+            reg_no_src = v128_load_int_scalar(cc, a, r1);
+            a.movd(dst, regs_i32[reg_no_src]);
+            a.pshufd(dst, dst, Imm(0));
+            break;
+        case JIT_V128_I64X2:
+            reg_no_src = v128_load_int_scalar(cc, a, r1);
+            a.movq(dst, regs_i64[reg_no_src]);
+            a.punpcklqdq(dst, dst);
+            break;
+        case JIT_V128_F32X4:
+            reg_no_src = v128_load_float_scalar(cc, a, r1);
+            a.pshufd(dst, regs_float[reg_no_src], Imm(0));
+            break;
+        case JIT_V128_F64X2:
+            reg_no_src = v128_load_float_scalar(cc, a, r1);
+            a.pshufd(dst, regs_float[reg_no_src], Imm(0x44));
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Encode insn V128EXTRACT r0, r1, lane, shape, is_signed
+ */
+static bool
+lower_v128_extract(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    JitReg r0 = *jit_insn_opnd(insn, 0), r1 = *jit_insn_opnd(insn, 1);
+    int32 lane = v128_const_opnd(cc, insn, 2);
+    int32 shape = v128_const_opnd(cc, insn, 3);
+    bool is_signed = v128_const_opnd(cc, insn, 4) ? true : false;
+    int32 reg_no_dst = jit_reg_no(r0);
+    x86::Xmm src = regs_float[jit_reg_no(r1)];
+
+    switch (shape) {
+        case JIT_V128_I8X16:
+            a.pextrb(regs_i32[reg_no_dst], src, Imm(lane));
+            if (is_signed)
+                a.movsx(regs_i32[reg_no_dst], regs_i8[reg_no_dst]);
+            break;
+        case JIT_V128_I16X8:
+            a.pextrw(regs_i32[reg_no_dst], src, Imm(lane));
+            if (is_signed)
+                a.movsx(regs_i32[reg_no_dst], regs_i16[reg_no_dst]);
+            break;
+        case JIT_V128_I32X4:
+            a.pextrd(regs_i32[reg_no_dst], src, Imm(lane));
+            break;
+        case JIT_V128_I64X2:
+            a.pextrq(regs_i64[reg_no_dst], src, Imm(lane));
+            break;
+        case JIT_V128_F32X4:
+            /* Only the lowest lane of the dst register is meaningful */
+            a.pshufd(regs_float[reg_no_dst], src, Imm(lane));
+            break;
+        case JIT_V128_F64X2:
+            a.pshufd(regs_float[reg_no_dst], src, Imm(lane ? 0xEE : 0x44));
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Encode insn V128REPLACE r0, r1, r2, lane, shape
+ */
+static bool
+lower_v128_replace(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    JitReg r0 = *jit_insn_opnd(insn, 0), r1 = *jit_insn_opnd(insn, 1);
+    JitReg r2 = *jit_insn_opnd(insn, 2);
+    int32 lane = v128_const_opnd(cc, insn, 3);
+    int32 shape = v128_const_opnd(cc, insn, 4);
+    x86::Xmm dst = regs_float[jit_reg_no(r0)];
+    int32 reg_no_src;
+
+    /* Load the scalar first as it may use the scratch registers, the
+       xmm registers of F32/F64 and V128 never overlap */
+    if (shape <= JIT_V128_I64X2)
+        reg_no_src = v128_load_int_scalar(cc, a, r2);
+    else
+        reg_no_src = v128_load_float_scalar(cc, a, r2);
+
+    mov_r_to_r_v128(a, jit_reg_no(r0), jit_reg_no(r1));
+
+    switch (shape) {
+        case JIT_V128_I8X16:
+            a.pinsrb(dst, regs_i32[reg_no_src], Imm(lane));
+            break;
+        case JIT_V128_I16X8:
+            a.pinsrw(dst, regs_i32[reg_no_src], Imm(lane));
+            break;
+        case JIT_V128_I32X4:
+            a.pinsrd(dst, regs_i32[reg_no_src], Imm(lane));
+            break;
+        case JIT_V128_I64X2:
+            a.pinsrq(dst, regs_i64[reg_no_src], Imm(lane));
+            break;
+        case JIT_V128_F32X4:
+            a.insertps(dst, regs_float[reg_no_src], Imm(lane << 4));
+            break;
+        case JIT_V128_F64X2:
+            if (lane == 0)
+                a.movsd(dst, regs_float[reg_no_src]);
+            else
+                a.movlhps(dst, regs_float[reg_no_src]);
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Encode insn V128NEG/V128ABS/V128SQRT r0, r1, shape
+ */
+static bool
+lower_v128_unary(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    int32 reg_no_dst = jit_reg_no(*jit_insn_opnd(insn, 0));
+    int32 reg_no_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+    int32 shape = v128_const_opnd(cc, insn, 2);
+    x86::Xmm tmp = regs_float[REG_V128_FREE_IDX];
+    x86::Xmm src = regs_float[reg_no_src];
+
+    switch (insn->opcode) {
+        case JIT_OP_V128NEG:
+            if (shape <= JIT_V128_I64X2) {
+                /* tmp = 0 - src */
+                a.pxor(tmp, tmp);
+                a.emit(v128_sub_insts[shape], tmp, src);
+            }
+            else {
+                /* flip the sign bits */
+                a.pcmpeqd(tmp, tmp);
+                if (shape == JIT_V128_F32X4) {
+                    a.pslld(tmp, Imm(31));
+                    a.xorps(tmp, src);
+                }
+                else {
+                    a.psllq(tmp, Imm(63));
+                    a.xorpd(tmp, src);
+                }
+            }
+            break;
+        case JIT_OP_V128ABS:
+            switch (shape) {
+                case JIT_V128_I8X16:
+                    a.pabsb(regs_float[reg_no_dst], src);
+                    return true;
+                case JIT_V128_I16X8:
+                    a.pabsw(regs_float[reg_no_dst], src);
+                    return true;
+                case JIT_V128_I32X4:
+                    a.pabsd(regs_float[reg_no_dst], src);
+                    return true;
+                case JIT_V128_I64X2:
+                    /* dst = (src ^ sign_mask) - sign_mask */
+                    a.pxor(tmp, tmp);
+                    a.pcmpgtq(tmp, src);
+                    mov_r_to_r_v128(a, reg_no_dst, reg_no_src);
+                    a.pxor(regs_float[reg_no_dst], tmp);
+                    a.psubq(regs_float[reg_no_dst], tmp);
+                    return true;
+                case JIT_V128_F32X4:
+                    /* clear the sign bits */
+                    a.pcmpeqd(tmp, tmp);
+                    a.psrld(tmp, Imm(1));
+                    a.andps(tmp, src);
+                    break;
+                case JIT_V128_F64X2:
+                    a.pcmpeqd(tmp, tmp);
+                    a.psrlq(tmp, Imm(1));
+                    a.andpd(tmp, src);
+                    break;
+                default:
+                    bh_assert(0);
+                    return false;
+            }
+            break;
+        case JIT_OP_V128SQRT:
+            if (shape == JIT_V128_F32X4)
+                a.sqrtps(regs_float[reg_no_dst], src);
+            else
+                a.sqrtpd(regs_float[reg_no_dst], src);
+            return true;
+        default:
+            bh_assert(0);
+            return false;
+    }
+
+    a.movdqa(regs_float[reg_no_dst], tmp);
+    return true;
+}
+
+/**
+ * Encode the SIMD arithmetic insns of format OP r0, r1, r2, shape
+ */
+static bool
+lower_v128_binary(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    int32 reg_no_dst = jit_reg_no(*jit_insn_opnd(insn, 0));
+    int32 reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+    int32 reg_no2_src = jit_reg_no(*jit_insn_opnd(insn, 2));
+    int32 shape = v128_const_opnd(cc, insn, 3);
+    const uint32 *inst_ids;
+
+    switch (insn->opcode) {
+        case JIT_OP_V128ADD:
+            inst_ids = v128_add_insts;
+            break;
+        case JIT_OP_V128SUB:
+            inst_ids = v128_sub_insts;
+            break;
+        case JIT_OP_V128MUL:
+            inst_ids = v128_mul_insts;
+            break;
+        case JIT_OP_V128DIV:
+            inst_ids = v128_div_insts;
+            break;
+        case JIT_OP_V128ADDSATS:
+            inst_ids = v128_add_sat_s_insts;
+            break;
+        case JIT_OP_V128ADDSATU:
+            inst_ids = v128_add_sat_u_insts;
+            break;
+        case JIT_OP_V128SUBSATS:
+            inst_ids = v128_sub_sat_s_insts;
+            break;
+        case JIT_OP_V128SUBSATU:
+            inst_ids = v128_sub_sat_u_insts;
+            break;
+        case JIT_OP_V128MINS:
+            inst_ids = v128_min_s_insts;
+            break;
+        case JIT_OP_V128MINU:
+            inst_ids = v128_min_u_insts;
+            break;
+        case JIT_OP_V128MAXS:
+            inst_ids = v128_max_s_insts;
+            break;
+        case JIT_OP_V128MAXU:
+            inst_ids = v128_max_u_insts;
+            break;
+        case JIT_OP_V128AVGRU:
+            inst_ids = v128_avgr_u_insts;
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+
+    if (!inst_ids[shape]) {
+        jit_set_last_error_v(cc, "unsupported lane shape %d of opcode %d",
+                             shape, insn->opcode);
+        return false;
+    }
+
+    v128_binary_r_r_r(a, inst_ids[shape], reg_no_dst, reg_no1_src,
+                      reg_no2_src);
+    return true;
+}
+
+/**
+ * Encode insn V128SHL/V128SHRS/V128SHRU r0, r1, r2, shape
+ */
+static bool
+lower_v128_shift(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    int32 reg_no_dst = jit_reg_no(*jit_insn_opnd(insn, 0));
+    int32 reg_no_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+    JitReg r2 = *jit_insn_opnd(insn, 2);
+    int32 shape = v128_const_opnd(cc, insn, 3);
+    /* The shift count is taken modulo the lane width */
+    int32 mask = (8 << shape) - 1;
+    const uint32 *inst_ids;
+
+    switch (insn->opcode) {
+        case JIT_OP_V128SHL:
+            inst_ids = v128_shl_insts;
+            break;
+        case JIT_OP_V128SHRS:
+            inst_ids = v128_shr_s_insts;
+            break;
+        case JIT_OP_V128SHRU:
+            inst_ids = v128_shr_u_insts;
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+
+    if (!inst_ids[shape]) {
+        jit_set_last_error_v(cc, "unsupported lane shape %d of opcode %d",
+                             shape, insn->opcode);
+        return false;
+    }
+
+    if (jit_reg_is_const(r2)) {
+        mov_r_to_r_v128(a, reg_no_dst, reg_no_src);
+        a.emit(inst_ids[shape], regs_float[reg_no_dst],
+               Imm(jit_cc_get_const_I32(cc, r2) & mask));
+    }
+    else {
+        a.mov(regs_i32[REG_I32_FREE_IDX], regs_i32[jit_reg_no(r2)]);
+        a.and_(regs_i32[REG_I32_FREE_IDX], Imm(mask));
+        a.movd(regs_float[REG_V128_FREE_IDX], regs_i32[REG_I32_FREE_IDX]);
+        mov_r_to_r_v128(a, reg_no_dst, reg_no_src);
+        a.emit(inst_ids[shape], regs_float[reg_no_dst],
+               regs_float[REG_V128_FREE_IDX]);
+    }
+    return true;
+}
+
+/**
+ * Encode insn V128CMP r0, r1, r2, cond, shape
+ */
+static bool
+lower_v128_cmp(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    int32 reg_no_dst = jit_reg_no(*jit_insn_opnd(insn, 0));
+    x86::Xmm src1 = regs_float[jit_reg_no(*jit_insn_opnd(insn, 1))];
+    x86::Xmm src2 = regs_float[jit_reg_no(*jit_insn_opnd(insn, 2))];
+    int32 cond = v128_const_opnd(cc, insn, 3);
+    int32 shape = v128_const_opnd(cc, insn, 4);
+    x86::Xmm tmp = regs_float[REG_V128_FREE_IDX];
+    bool invert = false;
+
+    if (shape >= JIT_V128_F32X4) {
+        /* predicate of cmpps/cmppd: 0 eq, 1 lt, 2 le, 4 neq */
+        uint32 inst_id = shape == JIT_V128_F32X4 ? x86::Inst::kIdCmpps
+                                                 : x86::Inst::kIdCmppd;
+        x86::Xmm lhs = src1, rhs = src2;
+        int32 pred;
+
+        switch (cond) {
+            case JIT_V128_CMP_EQ:
+                pred = 0;
+                break;
+            case JIT_V128_CMP_NE:
+                pred = 4;
+                break;
+            case JIT_V128_CMP_LTS:
+                pred = 1;
+                break;
+            case JIT_V128_CMP_LES:
+                pred = 2;
+                break;
+            case JIT_V128_CMP_GTS:
+                lhs = src2;
+                rhs = src1;
+                pred = 1;
+                break;
+            case JIT_V128_CMP_GES:
+                lhs = src2;
+                rhs = src1;
+                pred = 2;
+                break;
+            default:
+                bh_assert(0);
+                return false;
+        }
+        a.movdqa(tmp, lhs);
+        a.emit(inst_id, tmp, rhs, Imm(pred));
+    }
+    else {
+        switch (cond) {
+            case JIT_V128_CMP_EQ:
+            case JIT_V128_CMP_NE:
+                a.movdqa(tmp, src1);
+                a.emit(v128_cmp_eq_insts[shape], tmp, src2);
+                invert = cond == JIT_V128_CMP_NE;
+                break;
+            case JIT_V128_CMP_GTS:
+            case JIT_V128_CMP_LES:
+                a.movdqa(tmp, src1);
+                a.emit(v128_cmp_gt_insts[shape], tmp, src2);
+                invert = cond == JIT_V128_CMP_LES;
+                break;
+            case JIT_V128_CMP_LTS:
+            case JIT_V128_CMP_GES:
+                a.movdqa(tmp, src2);
+                a.emit(v128_cmp_gt_insts[shape], tmp, src1);
+                invert = cond == JIT_V128_CMP_GES;
+                break;
+            case JIT_V128_CMP_GEU:
+            case JIT_V128_CMP_LTU:
+                /* src1 >= src2 iff max(src1, src2) == src1 */
+                if (!v128_max_u_insts[shape])
+                    goto unsupported;
+                a.movdqa(tmp, src1);
+                a.emit(v128_max_u_insts[shape], tmp, src2);
+                a.emit(v128_cmp_eq_insts[shape], tmp, src1);
+                invert = cond == JIT_V128_CMP_LTU;
+                break;
+            case JIT_V128_CMP_LEU:
+            case JIT_V128_CMP_GTU:
+                /* src1 <= src2 iff min(src1, src2) == src1 */
+                if (!v128_min_u_insts[shape])
+                    goto unsupported;
+                a.movdqa(tmp, src1);
+                a.emit(v128_min_u_insts[shape], tmp, src2);
+                a.emit(v128_cmp_eq_insts[shape], tmp, src1);
+                invert = cond == JIT_V128_CMP_GTU;
+                break;
+            default:
+                bh_assert(0);
+                return false;
+        }
+    }
+
+    if (invert) {
+        /* the sources have been read, dst can be clobbered now */
+        a.pcmpeqd(regs_float[reg_no_dst], regs_float[reg_no_dst]);
+        a.pxor(regs_float[reg_no_dst], tmp);
+    }
+    else {
+        a.movdqa(regs_float[reg_no_dst], tmp);
+    }
+    return true;
+
+unsupported:
+    jit_set_last_error_v(cc, "unsupported lane shape %d of opcode %d", shape,
+                         insn->opcode);
+    return false;
+}
+
+/**
+ * Encode the 128-bit SIMD insns
+ *
+ * @param cc the compiler context
+ * @param a the assembler to emit the code
+ * @param insn current insn info
+ *
+ * @return true if success, false if failed
+ */
+static bool
+lower_simd(JitCompContext *cc, x86::Assembler &a, JitInsn *insn)
+{
+    JitReg r0 = *jit_insn_opnd(insn, 0);
+    int32 reg_no_dst = jit_reg_no(r0), reg_no1_src, reg_no2_src;
+    x86::Xmm tmp = regs_float[REG_V128_FREE_IDX];
+
+    CHECK_NCONST(r0);
+
+    switch (insn->opcode) {
+        case JIT_OP_V128SPLAT:
+            return lower_v128_splat(cc, a, insn);
+        case JIT_OP_V128EXTRACT:
+            return lower_v128_extract(cc, a, insn);
+        case JIT_OP_V128REPLACE:
+            return lower_v128_replace(cc, a, insn);
+        case JIT_OP_V128NOT:
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            a.pcmpeqd(tmp, tmp);
+            a.pxor(tmp, regs_float[reg_no1_src]);
+            a.movdqa(regs_float[reg_no_dst], tmp);
+            return true;
+        case JIT_OP_V128AND:
+        case JIT_OP_V128OR:
+        case JIT_OP_V128XOR:
+        {
+            uint32 inst_id = x86::Inst::kIdPxor;
+
+            if (insn->opcode == JIT_OP_V128AND)
+                inst_id = x86::Inst::kIdPand;
+            else if (insn->opcode == JIT_OP_V128OR)
+                inst_id = x86::Inst::kIdPor;
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            reg_no2_src = jit_reg_no(*jit_insn_opnd(insn, 2));
+            v128_binary_r_r_r(a, inst_id, reg_no_dst, reg_no1_src,
+                              reg_no2_src);
+            return true;
+        }
+        case JIT_OP_V128ANDNOT:
+            /* src1 & ~src2, pandn inverts its dst operand */
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            reg_no2_src = jit_reg_no(*jit_insn_opnd(insn, 2));
+            a.movdqa(tmp, regs_float[reg_no2_src]);
+            a.pandn(tmp, regs_float[reg_no1_src]);
+            a.movdqa(regs_float[reg_no_dst], tmp);
+            return true;
+        case JIT_OP_V128BITSELECT:
+        {
+            /* dst = ((src1 ^ src2) & mask) ^ src2 */
+            x86::Xmm src2 = regs_float[jit_reg_no(*jit_insn_opnd(insn, 2))];
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            a.movdqa(tmp, regs_float[reg_no1_src]);
+            a.pxor(tmp, src2);
+            a.pand(tmp, regs_float[jit_reg_no(*jit_insn_opnd(insn, 3))]);
+            a.pxor(tmp, src2);
+            a.movdqa(regs_float[reg_no_dst], tmp);
+            return true;
+        }
+        case JIT_OP_V128ANYTRUE:
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            /* xor must be done before ptest as it changes the flags */
+            a.xor_(regs_i32[reg_no_dst], regs_i32[reg_no_dst]);
+            a.ptest(regs_float[reg_no1_src], regs_float[reg_no1_src]);
+            a.setne(regs_i8[reg_no_dst]);
+            return true;
+        case JIT_OP_V128ALLTRUE:
+        {
+            int32 shape = v128_const_opnd(cc, insn, 2);
+            reg_no1_src = jit_reg_no(*jit_insn_opnd(insn, 1));
+            /* tmp lanes are all ones where the src lanes are zero */
+            a.pxor(tmp, tmp);
+            a.emit(v128_cmp_eq_insts[shape], tmp, regs_float[reg_no1_src]);
+            a.xor_(regs_i32[reg_no_dst], regs_i32[reg_no_dst]);
+            a.ptest(tmp, tmp);
+            a.sete(regs_i8[reg_no_dst]);
+            return true;
+        }
+        case JIT_OP_V128NEG:
+        case JIT_OP_V128ABS:
+        case JIT_OP_V128SQRT:
+            return lower_v128_unary(cc, a, insn);
+        case JIT_OP_V128SHL:
+        case JIT_OP_V128SHRS:
+        case JIT_OP_V128SHRU:
+            return lower_v128_shift(cc, a, insn);
+        case JIT_OP_V128CMP:
+            return lower_v128_cmp(cc, a, insn);
+        default:
+            return lower_v128_binary(cc, a, insn);
+    }
+fail:
+    return false;
+}
+
+/**
+ * Encode insn STV128 r0, r1, r2, the v128 value is never a constant
+ */
+static bool
+lower_stv128(JitCompContext *cc, x86::Assembler &a, JitReg r0, JitReg r1,
+             JitReg r2)
+{
+    int32 reg_no_src, reg_no_base = 0, reg_no_offset = 0;
+    int32 base = 0, offset = 0;
+
+    CHECK_NCONST(r0);
+    CHECK_KIND(r0, JIT_REG_KIND_V128);
+    reg_no_src = jit_reg_no(r0);
+    CHECK_REG_NO(reg_no_src, jit_reg_kind(r0));
+
+    if (jit_reg_is_const(r1))
+        base = jit_cc_get_const_I32(cc, r1);
+    else {
+        reg_no_base = jit_reg_no(r1);
+        CHECK_REG_NO(reg_no_base, jit_reg_kind(r1));
+    }
+    if (jit_reg_is_const(r2))
+        offset = jit_cc_get_const_I32(cc, r2);
+    else {
+        reg_no_offset = jit_reg_no(r2);
+        CHECK_REG_NO(reg_no_offset, jit_reg_kind(r2));
+    }
+
+    if (jit_reg_is_const(r1)) {
+        if (jit_reg_is_const(r2))
+            return st_r_to_base_imm_offset_imm(a, 16, JIT_REG_KIND_V128,
+                                               reg_no_src, base, offset,
+                                               false);
+        return st_r_to_base_imm_offset_r(a, 16, JIT_REG_KIND_V128, reg_no_src,
+                                         base, reg_no_offset, false);
+    }
+    if (jit_reg_is_const(r2))
+        return st_r_to_base_r_offset_imm(a, 16, JIT_REG_KIND_V128, reg_no_src,
+                                         reg_no_base, offset, false);
+    return st_r_to_base_r_offset_r(a, 16, JIT_REG_KIND_V128, reg_no_src,
+                                   reg_no_base, reg_no_offset, false);
+fail:
+    return false;
+}
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 /**
  * Replace all the jmp address pre-saved when the code cache hasn't been
  * allocated with actual address after code cache allocated
@@ -7944,6 +8757,13 @@ jit_codegen_gen_native(JitCompContext *cc)
                     LD_R_R_R(F64, 8, false);
                     break;
 
+#if WASM_ENABLE_SIMD != 0
+                case JIT_OP_LDV128:
+                    LOAD_3ARGS();
+                    LD_R_R_R(V128, 16, false);
+                    break;
+#endif
+
                 case JIT_OP_STI8:
                     LOAD_3ARGS_NO_ASSIGN();
                     atomic = insn->flags_u8 & 0x1;
@@ -7983,6 +8803,14 @@ jit_codegen_gen_native(JitCompContext *cc)
                     ST_R_R_R(F64, float64, 8, false);
                     break;
 
+#if WASM_ENABLE_SIMD != 0
+                case JIT_OP_STV128:
+                    LOAD_3ARGS_NO_ASSIGN();
+                    if (!lower_stv128(cc, a, r0, r1, r2))
+                        GOTO_FAIL;
+                    break;
+#endif
+
                 case JIT_OP_JMP:
                     LOAD_1ARG();
                     CHECK_KIND(r0, JIT_REG_KIND_L32);
@@ -8307,6 +9135,43 @@ jit_codegen_gen_native(JitCompContext *cc)
 
 #endif
 
+#if WASM_ENABLE_SIMD != 0
+                case JIT_OP_V128SPLAT:
+                case JIT_OP_V128EXTRACT:
+                case JIT_OP_V128REPLACE:
+                case JIT_OP_V128NOT:
+                case JIT_OP_V128AND:
+                case JIT_OP_V128ANDNOT:
+                case JIT_OP_V128OR:
+                case JIT_OP_V128XOR:
+                case JIT_OP_V128BITSELECT:
+                case JIT_OP_V128ANYTRUE:
+                case JIT_OP_V128ALLTRUE:
+                case JIT_OP_V128NEG:
+                case JIT_OP_V128ABS:
+                case JIT_OP_V128SQRT:
+                case JIT_OP_V128ADD:
+                case JIT_OP_V128SUB:
+                case JIT_OP_V128MUL:
+                case JIT_OP_V128DIV:
+                case JIT_OP_V128ADDSATS:
+                case JIT_OP_V128ADDSATU:
+                case JIT_OP_V128SUBSATS:
+                case JIT_OP_V128SUBSATU:
+                case JIT_OP_V128MINS:
+                case JIT_OP_V128MINU:
+                case JIT_OP_V128MAXS:
+                case JIT_OP_V128MAXU:
+                case JIT_OP_V128AVGRU:
+                case JIT_OP_V128SHL:
+                case JIT_OP_V128SHRS:
+                case JIT_OP_V128SHRU:
+                case JIT_OP_V128CMP:
+                    if (!lower_simd(cc, a, insn))
+                        GOTO_FAIL;
+                    break;
+#endif
+
                 default:
                     jit_set_last_error_v(cc, "unsupported JIT opcode 0x%2x",
                                          insn->opcode);
@@ -9160,6 +10025,19 @@ jit_codegen_init()
     code.setErrorHandler(&err_handler);
     x86::Assembler a(&code);
 
+#if WASM_ENABLE_SIMD != 0
+    {
+        /* The v128 lowering uses SSE4.1, and pcmpgtq of SSE4.2 for
+           i64x2.gt_s and its variants */
+        const CpuFeatures::X86 &features = CpuInfo::host().features().x86();
+        jit_globals->simd_supported =
+            features.hasSSE4_1() && features.hasSSE4_2();
+        if (!jit_globals->simd_supported)
+            LOG_VERBOSE("JIT: SSE4.1/SSE4.2 not supported by host CPU, "
+                        "functions using v128 won't be compiled\n");
+    }
+#endif
+
     /* Initialize code_block_switch_to_jitted_from_interp */
 
     /* push callee-save registers */
@@ -9400,8 +10278,13 @@ static const uint8 hreg_info_I64[3][16] = {
 /* System V AMD64 ABI Calling Conversion. [XYZ]MM0-7 */
 static uint8 hreg_info_F32[3][16] = {
     /* xmm0 ~ xmm15 */
+#if WASM_ENABLE_SIMD == 0
     { 0, 0, 0, 0, 0, 0, 0, 0,
       1, 1, 1, 1, 1, 1, 1, 1 },
+#else
+    { 0, 0, 0, 0, 0, 0, 1, 1,
+      1, 1, 1, 1, 1, 1, 1, 1 }, /* xmm6, xmm7 are used by V128 */
+#endif
     { 1, 1, 1, 1, 1, 1, 1, 1,
       1, 1, 1, 1, 1, 1, 1, 0 }, /* caller_saved_native */
     { 1, 1, 1, 1, 1, 1, 1, 1,
@@ -9411,14 +10294,33 @@ static uint8 hreg_info_F32[3][16] = {
 /* System V AMD64 ABI Calling Conversion. [XYZ]MM0-7 */
 static uint8 hreg_info_F64[3][16] = {
     /* xmm0 ~ xmm15 */
+#if WASM_ENABLE_SIMD == 0
     { 1, 1, 1, 1, 1, 1, 1, 1,
       0, 0, 0, 0, 0, 0, 0, 1 },
+#else
+    { 1, 1, 1, 1, 1, 1, 1, 1,
+      0, 0, 0, 0, 1, 1, 1, 1 }, /* xmm12 ~ xmm14 are used by V128 */
+#endif
     { 1, 1, 1, 1, 1, 1, 1, 1,
       1, 1, 1, 1, 1, 1, 1, 0 }, /* caller_saved_native */
     { 1, 1, 1, 1, 1, 1, 1, 1,
       1, 1, 1, 1, 1, 1, 1, 0 }, /* caller_saved_jitted */
 };
 
+#if WASM_ENABLE_SIMD != 0
+/* The xmm registers are shared by F32, F64 and V128, each kind owns a
+   disjoint subset of them, and xmm15 is kept as scratch register */
+static uint8 hreg_info_V128[3][16] = {
+    /* xmm0 ~ xmm15 */
+    { 1, 1, 1, 1, 1, 1, 0, 0,
+      1, 1, 1, 1, 0, 0, 0, 1 },
+    { 1, 1, 1, 1, 1, 1, 1, 1,
+      1, 1, 1, 1, 1, 1, 1, 0 }, /* caller_saved_native */
+    { 1, 1, 1, 1, 1, 1, 1, 1,
+      1, 1, 1, 1, 1, 1, 1, 0 }, /* caller_saved_jitted */
+};
+#endif
+
 static const JitHardRegInfo g_hreg_info = {
     {
         { 0, NULL, NULL, NULL }, /* VOID */
@@ -9443,9 +10345,16 @@ static const JitHardRegInfo g_hreg_info = {
           hreg_info_F64[1],
           hreg_info_F64[2] },
 
-        { 0, NULL, NULL, NULL }, /* V8 */
-        { 0, NULL, NULL, NULL }, /* V16 */
-        { 0, NULL, NULL, NULL }  /* V32 */
+        { 0, NULL, NULL, NULL }, /* V64 */
+#if WASM_ENABLE_SIMD != 0
+        { sizeof(hreg_info_V128[0]), /* V128 */
+          hreg_info_V128[0],
+          hreg_info_V128[1],
+          hreg_info_V128[2] },
+#else
+        { 0, NULL, NULL, NULL }, /* V128 */
+#endif
+        { 0, NULL, NULL, NULL }  /* V256 */
     },
     /* frame pointer hreg index: rbp */
     0,
@@ -9482,6 +10391,15 @@ static const char *reg_names_f64[] = {
     "xmm12_f64", "xmm13_f64", "xmm14_f64", "xmm15_f64"
 };
 
+#if WASM_ENABLE_SIMD != 0
+static const char *reg_names_v128[] = {
+    "xmm0_v128",  "xmm1_v128",  "xmm2_v128",  "xmm3_v128",
+    "xmm4_v128",  "xmm5_v128",  "xmm6_v128",  "xmm7_v128",
+    "xmm8_v128",  "xmm9_v128",  "xmm10_v128", "xmm11_v128",
+    "xmm12_v128", "xmm13_v128", "xmm14_v128", "xmm15_v128"
+};
+#endif
+
 JitReg
 jit_codegen_get_hreg_by_name(const char *name)
 {
@@ -9497,6 +10415,13 @@ jit_codegen_get_hreg_by_name(const char *name)
             if (!strcmp(reg_names_i64[i], name))
                 return jit_reg_new(JIT_REG_KIND_I64, i);
     }
+#if WASM_ENABLE_SIMD != 0
+    else if (!strncmp(name, "xmm", 3) && strstr(name, "_v128")) {
+        for (i = 0; i < sizeof(reg_names_v128) / sizeof(char *); i++)
+            if (!strcmp(reg_names_v128[i], name))
+                return jit_reg_new(JIT_REG_KIND_V128, i);
+    }
+#endif
     else if (!strncmp(name, "xmm", 3)) {
         if (!strstr(name, "_f64")) {
             for (i = 0; i < sizeof(reg_names_f32) / sizeof(char *); i++)
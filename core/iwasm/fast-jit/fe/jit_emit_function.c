@@ -51,6 +51,13 @@ pre_call(JitCompContext *cc, const WASMType *func_type)
                 outs_off -= 8;
                 GEN_INSN(STF64, value, cc->fp_reg, NEW_CONST(I32, outs_off));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                POP_V128(value);
+                outs_off -= 16;
+                GEN_INSN(STV128, value, cc->fp_reg, NEW_CONST(I32, outs_off));
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -132,6 +139,17 @@ post_return(JitCompContext *cc, const WASMType *func_type, JitReg first_res,
                 PUSH_F64(value);
                 n += 2;
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* v128 result is never returned in register */
+                bh_assert(!(i == 0 && first_res));
+                value = jit_cc_new_reg_V128(cc);
+                GEN_INSN(LDV128, value, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                PUSH_V128(value);
+                n += 4;
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -189,6 +207,20 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_SIMD != 0
+static bool
+func_type_has_v128(const WASMType *func_type)
+{
+    uint32 i;
+
+    for (i = 0; i < func_type->param_count + func_type->result_count; i++) {
+        if (func_type->types[i] == VALUE_TYPE_V128)
+            return true;
+    }
+    return false;
+}
+#endif
+
 static JitReg
 create_first_res_reg(JitCompContext *cc, const WASMType *func_type)
 {
@@ -206,6 +238,11 @@ create_first_res_reg(JitCompContext *cc, const WASMType *func_type)
                 return jit_cc_new_reg_F32(cc);
             case VALUE_TYPE_F64:
                 return jit_cc_new_reg_F64(cc);
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* v128 result is returned through the frame */
+                return 0;
+#endif
             default:
                 bh_assert(0);
                 return 0;
@@ -251,7 +288,12 @@ jit_compile_op_call(JitCompContext *cc, uint32 func_idx, bool tail_call)
             || func_type->param_count >= 5 /* registered as normal mode, but
                                               jit_emit_callnative only supports
                                               maximum 6 registers now
-                                              (include exec_nev) */) {
+                                              (include exec_nev) */
+#if WASM_ENABLE_SIMD != 0
+            || func_type_has_v128(func_type) /* v128 can't be passed
+                                                in registers */
+#endif
+        ) {
             JitReg arg_regs[3];
 
             if (!pre_call(cc, func_type)) {
@@ -675,6 +717,14 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
                 GEN_INSN(STF64, res, cc->fp_reg,
                          NEW_CONST(I32, offset_of_local(n)));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                res = jit_cc_new_reg_V128(cc);
+                GEN_INSN(LDV128, res, argv, NEW_CONST(I32, 0));
+                GEN_INSN(STV128, res, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -729,6 +779,11 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
             case VALUE_TYPE_F64:
                 res = jit_cc_new_reg_F64(cc);
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* the callee stores v128 result into the frame */
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -760,6 +815,10 @@ jit_compile_op_call_indirect(JitCompContext *cc, uint32 type_idx,
                 GEN_INSN(STF64, res, cc->fp_reg,
                          NEW_CONST(I32, offset_of_local(n)));
                 break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                break;
+#endif
             default:
                 bh_assert(0);
                 goto fail;
@@ -830,26 +889,40 @@ fail:
 }
 #endif
 
-#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+    || defined(BUILD_TARGET_AARCH64)
 static bool
 emit_callnative(JitCompContext *cc, JitReg native_func_reg, JitReg res,
                 JitReg *params, uint32 param_count)
 {
     JitInsn *insn;
+#if defined(BUILD_TARGET_AARCH64)
+    char *i32_arg_names[] = { "w0", "w1", "w2", "w3", "w4", "w5" };
+    char *i64_arg_names[] = { "x0", "x1", "x2", "x3", "x4", "x5" };
+    char *f32_arg_names[] = { "s0", "s1", "s2", "s3", "s4", "s5" };
+    char *f64_arg_names[] = { "d0", "d1", "d2", "d3", "d4", "d5" };
+    JitReg eax_hreg = jit_codegen_get_hreg_by_name("w0");
+    JitReg xmm0_hreg = jit_codegen_get_hreg_by_name("s0");
+#else
     char *i32_arg_names[] = { "edi", "esi", "edx", "ecx" };
     char *i64_arg_names[] = { "rdi", "rsi", "rdx", "rcx", "r8", "r9" };
     char *f32_arg_names[] = { "xmm0", "xmm1", "xmm2", "xmm3", "xmm4", "xmm5" };
     char *f64_arg_names[] = { "xmm0_f64", "xmm1_f64", "xmm2_f64",
                               "xmm3_f64", "xmm4_f64", "xmm5_f64" };
-    JitReg i32_arg_regs[4], i64_arg_regs[6];
-    JitReg f32_arg_regs[6], f64_arg_regs[6], res_reg = 0;
     JitReg eax_hreg = jit_codegen_get_hreg_by_name("eax");
     JitReg xmm0_hreg = jit_codegen_get_hreg_by_name("xmm0");
+#endif
+    /* The number of i32 registers which are also used to pass the
+       arguments, their i64 forms are fixed registers of the codegen */
+    const uint32 i32_arg_reg_num =
+        sizeof(i32_arg_names) / sizeof(i32_arg_names[0]);
+    JitReg i32_arg_regs[6], i64_arg_regs[6];
+    JitReg f32_arg_regs[6], f64_arg_regs[6], res_reg = 0;
     uint32 i, i64_reg_idx, float_reg_idx, lock_i32_reg_num;
 
     bh_assert(param_count <= 6);
 
-    for (i = 0; i < 4; i++) {
+    for (i = 0; i < i32_arg_reg_num; i++) {
         i32_arg_regs[i] = jit_codegen_get_hreg_by_name(i32_arg_names[i]);
     }
 
@@ -859,7 +932,8 @@ emit_callnative(JitCompContext *cc, JitReg native_func_reg, JitReg res,
         f64_arg_regs[i] = jit_codegen_get_hreg_by_name(f64_arg_names[i]);
     }
 
-    lock_i32_reg_num = param_count < 4 ? param_count : 4;
+    lock_i32_reg_num =
+        param_count < i32_arg_reg_num ? param_count : i32_arg_reg_num;
 
     /*
      * Lock i32 registers so that they won't be allocated for the operand
@@ -572,6 +572,220 @@ fail:
     return false;
 }
 
+#if WASM_ENABLE_SIMD != 0
+bool
+jit_compile_op_v128_load(JitCompContext *cc, uint32 align, uint32 offset)
+{
+    JitReg addr, offset1, value, memory_data;
+
+    POP_I32(addr);
+
+    offset1 = check_and_seek(cc, addr, offset, 16);
+    if (!offset1) {
+        goto fail;
+    }
+
+    memory_data = get_memory_data_reg(cc->jit_frame, 0);
+
+    value = jit_cc_new_reg_V128(cc);
+    GEN_INSN(LDV128, value, memory_data, offset1);
+
+    PUSH_V128(value);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_store(JitCompContext *cc, uint32 align, uint32 offset)
+{
+    JitReg value, addr, offset1, memory_data;
+
+    POP_V128(value);
+    POP_I32(addr);
+
+    offset1 = check_and_seek(cc, addr, offset, 16);
+    if (!offset1) {
+        goto fail;
+    }
+
+    memory_data = get_memory_data_reg(cc->jit_frame, 0);
+
+    GEN_INSN(STV128, value, memory_data, offset1);
+
+    return true;
+fail:
+    return false;
+}
+
+static JitV128Shape
+v128_shape_of_bytes(uint32 bytes)
+{
+    switch (bytes) {
+        case 1:
+            return JIT_V128_I8X16;
+        case 2:
+            return JIT_V128_I16X8;
+        case 4:
+            return JIT_V128_I32X4;
+        default:
+            bh_assert(bytes == 8);
+            return JIT_V128_I64X2;
+    }
+}
+
+/* Load a lane sized scalar, i8/i16/i32 are zero extended to i32 */
+static JitReg
+v128_load_lane_value(JitCompContext *cc, uint32 offset, uint32 bytes)
+{
+    JitReg addr, offset1, value, memory_data;
+
+    POP_I32(addr);
+
+    offset1 = check_and_seek(cc, addr, offset, bytes);
+    if (!offset1) {
+        goto fail;
+    }
+
+    memory_data = get_memory_data_reg(cc->jit_frame, 0);
+
+    switch (bytes) {
+        case 1:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDU8, value, memory_data, offset1);
+            break;
+        case 2:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDU16, value, memory_data, offset1);
+            break;
+        case 4:
+            value = jit_cc_new_reg_I32(cc);
+            GEN_INSN(LDI32, value, memory_data, offset1);
+            break;
+        case 8:
+            value = jit_cc_new_reg_I64(cc);
+            GEN_INSN(LDI64, value, memory_data, offset1);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    return value;
+fail:
+    return 0;
+}
+
+bool
+jit_compile_op_v128_load_splat(JitCompContext *cc, uint32 align,
+                               uint32 offset, uint32 bytes)
+{
+    JitReg value, res;
+
+    if (!(value = v128_load_lane_value(cc, offset, bytes)))
+        goto fail;
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SPLAT, res, value,
+             NEW_CONST(I32, v128_shape_of_bytes(bytes)));
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_load_zero(JitCompContext *cc, uint32 align, uint32 offset,
+                              uint32 bytes)
+{
+    JitReg value, zero, res;
+    JitV128Shape shape = v128_shape_of_bytes(bytes);
+
+    bh_assert(bytes == 4 || bytes == 8);
+
+    if (!(value = v128_load_lane_value(cc, offset, bytes)))
+        goto fail;
+
+    zero = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SPLAT, zero, NEW_CONST(I64, 0),
+             NEW_CONST(I32, JIT_V128_I64X2));
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128REPLACE, res, zero, value, NEW_CONST(I32, 0),
+             NEW_CONST(I32, shape));
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_load_lane(JitCompContext *cc, uint32 align, uint32 offset,
+                              uint32 bytes, uint8 lane_id)
+{
+    JitReg vector, value, res;
+
+    POP_V128(vector);
+
+    if (!(value = v128_load_lane_value(cc, offset, bytes)))
+        goto fail;
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128REPLACE, res, vector, value, NEW_CONST(I32, lane_id),
+             NEW_CONST(I32, v128_shape_of_bytes(bytes)));
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_op_v128_store_lane(JitCompContext *cc, uint32 align,
+                               uint32 offset, uint32 bytes, uint8 lane_id)
+{
+    JitReg vector, value, addr, offset1, memory_data;
+    JitV128Shape shape = v128_shape_of_bytes(bytes);
+
+    POP_V128(vector);
+    POP_I32(addr);
+
+    value = bytes == 8 ? jit_cc_new_reg_I64(cc) : jit_cc_new_reg_I32(cc);
+    GEN_INSN(V128EXTRACT, value, vector, NEW_CONST(I32, lane_id),
+             NEW_CONST(I32, shape), NEW_CONST(I32, false));
+
+    offset1 = check_and_seek(cc, addr, offset, bytes);
+    if (!offset1) {
+        goto fail;
+    }
+
+    memory_data = get_memory_data_reg(cc->jit_frame, 0);
+
+    switch (bytes) {
+        case 1:
+            GEN_INSN(STI8, value, memory_data, offset1);
+            break;
+        case 2:
+            GEN_INSN(STI16, value, memory_data, offset1);
+            break;
+        case 4:
+            GEN_INSN(STI32, value, memory_data, offset1);
+            break;
+        case 8:
+            GEN_INSN(STI64, value, memory_data, offset1);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    return true;
+fail:
+    return false;
+}
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
 bool
 jit_compile_op_memory_size(JitCompContext *cc, uint32 mem_idx)
 {
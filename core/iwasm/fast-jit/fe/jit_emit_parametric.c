@@ -66,6 +66,11 @@ pop_value_from_wasm_stack(JitCompContext *cc, bool is_32bit, JitReg *p_value,
         case VALUE_TYPE_F64:
             value = pop_f64(cc->jit_frame);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            value = pop_v128(cc->jit_frame);
+            break;
+#endif
         default:
             bh_assert(0);
             return false;
@@ -116,6 +121,25 @@ jit_compile_op_select(JitCompContext *cc, bool is_select_32)
         case VALUE_TYPE_F64:
             selected = jit_cc_new_reg_F64(cc);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+        {
+            JitReg mask_i32 = jit_cc_new_reg_I32(cc);
+            JitReg mask = jit_cc_new_reg_V128(cc);
+
+            /* There is no conditional move for vectors, select the lanes
+               with a mask of all ones or all zeros instead */
+            selected = jit_cc_new_reg_V128(cc);
+            GEN_INSN(CMP, cc->cmp_reg, cond, NEW_CONST(I32, 0));
+            GEN_INSN(SELECTNE, mask_i32, cc->cmp_reg, NEW_CONST(I32, -1),
+                     NEW_CONST(I32, 0));
+            GEN_INSN(V128SPLAT, mask, mask_i32,
+                     NEW_CONST(I32, JIT_V128_I32X4));
+            GEN_INSN(V128BITSELECT, selected, val1, val2, mask);
+            PUSH(selected, val1_type);
+            return true;
+        }
+#endif
         default:
             bh_assert(0);
             return false;
@@ -0,0 +1,1056 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "jit_emit_simd.h"
+#include "jit_emit_function.h"
+#include "jit_emit_memory.h"
+#include "../jit_frontend.h"
+#include "../../interpreter/wasm_opcode.h"
+
+#if WASM_ENABLE_SIMD != 0
+
+#define V128_SHAPE(shape) NEW_CONST(I32, shape)
+
+static inline bool
+is_float_shape(JitV128Shape shape)
+{
+    return shape == JIT_V128_F32X4 || shape == JIT_V128_F64X2;
+}
+
+bool
+jit_compile_simd_v128_const(JitCompContext *cc, const uint8 *imm_bytes)
+{
+    JitReg res, res1;
+    int64 lo, hi;
+
+    bh_memcpy_s(&lo, sizeof(int64), imm_bytes, sizeof(int64));
+    bh_memcpy_s(&hi, sizeof(int64), imm_bytes + 8, sizeof(int64));
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SPLAT, res, NEW_CONST(I64, lo), V128_SHAPE(JIT_V128_I64X2));
+    if (hi != lo) {
+        res1 = jit_cc_new_reg_V128(cc);
+        GEN_INSN(V128REPLACE, res1, res, NEW_CONST(I64, hi), NEW_CONST(I32, 1),
+                 V128_SHAPE(JIT_V128_I64X2));
+        res = res1;
+    }
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+static bool
+pop_lane_scalar(JitCompContext *cc, JitV128Shape shape, JitReg *p_value)
+{
+    JitReg value;
+
+    switch (shape) {
+        case JIT_V128_I8X16:
+        case JIT_V128_I16X8:
+        case JIT_V128_I32X4:
+            POP_I32(value);
+            break;
+        case JIT_V128_I64X2:
+            POP_I64(value);
+            break;
+        case JIT_V128_F32X4:
+            POP_F32(value);
+            break;
+        case JIT_V128_F64X2:
+            POP_F64(value);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    *p_value = value;
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_splat(JitCompContext *cc, JitV128Shape shape)
+{
+    JitReg value, res;
+
+    if (!pop_lane_scalar(cc, shape, &value))
+        goto fail;
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SPLAT, res, value, V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_extract_lane(JitCompContext *cc, JitV128Shape shape,
+                              uint8 lane_id, bool is_signed)
+{
+    JitReg vector, res;
+
+    POP_V128(vector);
+
+    switch (shape) {
+        case JIT_V128_I8X16:
+        case JIT_V128_I16X8:
+        case JIT_V128_I32X4:
+            res = jit_cc_new_reg_I32(cc);
+            GEN_INSN(V128EXTRACT, res, vector, NEW_CONST(I32, lane_id),
+                     V128_SHAPE(shape), NEW_CONST(I32, is_signed));
+            PUSH_I32(res);
+            break;
+        case JIT_V128_I64X2:
+            res = jit_cc_new_reg_I64(cc);
+            GEN_INSN(V128EXTRACT, res, vector, NEW_CONST(I32, lane_id),
+                     V128_SHAPE(shape), NEW_CONST(I32, is_signed));
+            PUSH_I64(res);
+            break;
+        case JIT_V128_F32X4:
+            res = jit_cc_new_reg_F32(cc);
+            GEN_INSN(V128EXTRACT, res, vector, NEW_CONST(I32, lane_id),
+                     V128_SHAPE(shape), NEW_CONST(I32, is_signed));
+            PUSH_F32(res);
+            break;
+        case JIT_V128_F64X2:
+            res = jit_cc_new_reg_F64(cc);
+            GEN_INSN(V128EXTRACT, res, vector, NEW_CONST(I32, lane_id),
+                     V128_SHAPE(shape), NEW_CONST(I32, is_signed));
+            PUSH_F64(res);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_replace_lane(JitCompContext *cc, JitV128Shape shape,
+                              uint8 lane_id)
+{
+    JitReg vector, value, res;
+
+    if (!pop_lane_scalar(cc, shape, &value))
+        goto fail;
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128REPLACE, res, vector, value, NEW_CONST(I32, lane_id),
+             V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_v128_bitwise(JitCompContext *cc, V128Bitwise bitwise_op)
+{
+    JitReg v1, v2, mask, res;
+
+    res = jit_cc_new_reg_V128(cc);
+
+    switch (bitwise_op) {
+        case V128_NOT:
+            POP_V128(v1);
+            GEN_INSN(V128NOT, res, v1);
+            break;
+        case V128_AND:
+            POP_V128(v2);
+            POP_V128(v1);
+            GEN_INSN(V128AND, res, v1, v2);
+            break;
+        case V128_ANDNOT:
+            POP_V128(v2);
+            POP_V128(v1);
+            GEN_INSN(V128ANDNOT, res, v1, v2);
+            break;
+        case V128_OR:
+            POP_V128(v2);
+            POP_V128(v1);
+            GEN_INSN(V128OR, res, v1, v2);
+            break;
+        case V128_XOR:
+            POP_V128(v2);
+            POP_V128(v1);
+            GEN_INSN(V128XOR, res, v1, v2);
+            break;
+        case V128_BITSELECT:
+            POP_V128(mask);
+            POP_V128(v2);
+            POP_V128(v1);
+            GEN_INSN(V128BITSELECT, res, v1, v2, mask);
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_v128_any_true(JitCompContext *cc)
+{
+    JitReg vector, res;
+
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_I32(cc);
+    GEN_INSN(V128ANYTRUE, res, vector);
+    PUSH_I32(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_all_true(JitCompContext *cc, JitV128Shape shape)
+{
+    JitReg vector, res;
+
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_I32(cc);
+    GEN_INSN(V128ALLTRUE, res, vector, V128_SHAPE(shape));
+    PUSH_I32(res);
+    return true;
+fail:
+    return false;
+}
+
+static bool
+simd_compare(JitCompContext *cc, JitV128Shape shape, JitV128Cond cond)
+{
+    JitReg v1, v2, res;
+
+    POP_V128(v2);
+    POP_V128(v1);
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128CMP, res, v1, v2, NEW_CONST(I32, cond), V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_int_compare(JitCompContext *cc, JitV128Shape shape,
+                             IntCond cond)
+{
+    bh_assert(!is_float_shape(shape));
+    bh_assert(cond >= INT_EQ && cond <= INT_GE_U);
+
+    /* IntCond and JitV128Cond list the conditions in the same order,
+       except that there is no EQZ for vectors */
+    return simd_compare(cc, shape, (JitV128Cond)(cond - INT_EQ));
+}
+
+bool
+jit_compile_simd_float_compare(JitCompContext *cc, JitV128Shape shape,
+                               FloatCond cond)
+{
+    JitV128Cond v128_cond;
+
+    bh_assert(is_float_shape(shape));
+
+    switch (cond) {
+        case FLOAT_EQ:
+            v128_cond = JIT_V128_CMP_EQ;
+            break;
+        case FLOAT_NE:
+            v128_cond = JIT_V128_CMP_NE;
+            break;
+        case FLOAT_LT:
+            v128_cond = JIT_V128_CMP_LTS;
+            break;
+        case FLOAT_GT:
+            v128_cond = JIT_V128_CMP_GTS;
+            break;
+        case FLOAT_LE:
+            v128_cond = JIT_V128_CMP_LES;
+            break;
+        case FLOAT_GE:
+            v128_cond = JIT_V128_CMP_GES;
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+
+    return simd_compare(cc, shape, v128_cond);
+}
+
+bool
+jit_compile_simd_arithmetic(JitCompContext *cc, JitV128Shape shape,
+                            V128Arithmetic arith_op, bool is_signed)
+{
+    JitReg v1, v2, res;
+
+    res = jit_cc_new_reg_V128(cc);
+
+    if (arith_op == V128_NEG) {
+        POP_V128(v1);
+        GEN_INSN(V128NEG, res, v1, V128_SHAPE(shape));
+        PUSH_V128(res);
+        return true;
+    }
+
+    POP_V128(v2);
+    POP_V128(v1);
+
+    switch (arith_op) {
+        case V128_ADD:
+            GEN_INSN(V128ADD, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_SUB:
+            GEN_INSN(V128SUB, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_MUL:
+            GEN_INSN(V128MUL, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_DIV:
+            bh_assert(is_float_shape(shape));
+            GEN_INSN(V128DIV, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_MIN:
+            /* Only integer lanes, float min/max need NaN propagation */
+            bh_assert(!is_float_shape(shape));
+            if (is_signed)
+                GEN_INSN(V128MINS, res, v1, v2, V128_SHAPE(shape));
+            else
+                GEN_INSN(V128MINU, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_MAX:
+            bh_assert(!is_float_shape(shape));
+            if (is_signed)
+                GEN_INSN(V128MAXS, res, v1, v2, V128_SHAPE(shape));
+            else
+                GEN_INSN(V128MAXU, res, v1, v2, V128_SHAPE(shape));
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_sat_arithmetic(JitCompContext *cc, JitV128Shape shape,
+                                V128Arithmetic arith_op, bool is_signed)
+{
+    JitReg v1, v2, res;
+
+    bh_assert(shape == JIT_V128_I8X16 || shape == JIT_V128_I16X8);
+
+    POP_V128(v2);
+    POP_V128(v1);
+
+    res = jit_cc_new_reg_V128(cc);
+
+    switch (arith_op) {
+        case V128_ADD:
+            if (is_signed)
+                GEN_INSN(V128ADDSATS, res, v1, v2, V128_SHAPE(shape));
+            else
+                GEN_INSN(V128ADDSATU, res, v1, v2, V128_SHAPE(shape));
+            break;
+        case V128_SUB:
+            if (is_signed)
+                GEN_INSN(V128SUBSATS, res, v1, v2, V128_SHAPE(shape));
+            else
+                GEN_INSN(V128SUBSATU, res, v1, v2, V128_SHAPE(shape));
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_avgr_u(JitCompContext *cc, JitV128Shape shape)
+{
+    JitReg v1, v2, res;
+
+    bh_assert(shape == JIT_V128_I8X16 || shape == JIT_V128_I16X8);
+
+    POP_V128(v2);
+    POP_V128(v1);
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128AVGRU, res, v1, v2, V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_abs(JitCompContext *cc, JitV128Shape shape)
+{
+    JitReg vector, res;
+
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128ABS, res, vector, V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_sqrt(JitCompContext *cc, JitV128Shape shape)
+{
+    JitReg vector, res;
+
+    bh_assert(is_float_shape(shape));
+
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SQRT, res, vector, V128_SHAPE(shape));
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_shift(JitCompContext *cc, JitV128Shape shape,
+                       IntShift shift_op)
+{
+    JitReg vector, count, res;
+
+    bh_assert(!is_float_shape(shape));
+
+    POP_I32(count);
+    POP_V128(vector);
+
+    res = jit_cc_new_reg_V128(cc);
+
+    /* The shift count is taken modulo the lane width by the backend */
+    switch (shift_op) {
+        case INT_SHL:
+            GEN_INSN(V128SHL, res, vector, count, V128_SHAPE(shape));
+            break;
+        case INT_SHR_S:
+            GEN_INSN(V128SHRS, res, vector, count, V128_SHAPE(shape));
+            break;
+        case INT_SHR_U:
+            GEN_INSN(V128SHRU, res, vector, count, V128_SHAPE(shape));
+            break;
+        default:
+            bh_assert(0);
+            goto fail;
+    }
+
+    PUSH_V128(res);
+    return true;
+fail:
+    return false;
+}
+
+/* Native implementations of the SIMD instructions which have no IR
+   instruction, see jit_compile_simd_native_op */
+
+static int32
+sat_i8(int32 v)
+{
+    return v < INT8_MIN ? INT8_MIN : (v > INT8_MAX ? INT8_MAX : v);
+}
+
+static int32
+sat_u8(int32 v)
+{
+    return v < 0 ? 0 : (v > UINT8_MAX ? UINT8_MAX : v);
+}
+
+static int32
+sat_i16(int32 v)
+{
+    return v < INT16_MIN ? INT16_MIN : (v > INT16_MAX ? INT16_MAX : v);
+}
+
+static int32
+sat_u16(int32 v)
+{
+    return v < 0 ? 0 : (v > UINT16_MAX ? UINT16_MAX : v);
+}
+
+static float64
+simd_fmin(float64 a, float64 b)
+{
+    if (isnan(a) || isnan(b))
+        return (float64)NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? a : b;
+    else
+        return a > b ? b : a;
+}
+
+static float64
+simd_fmax(float64 a, float64 b)
+{
+    if (isnan(a) || isnan(b))
+        return (float64)NAN;
+    else if (a == 0 && a == b)
+        return signbit(a) ? b : a;
+    else
+        return a > b ? a : b;
+}
+
+static int32
+simd_trunc_sat_i32(float64 v, bool is_signed)
+{
+    if (isnan(v))
+        return 0;
+    if (is_signed) {
+        if (v <= (float64)INT32_MIN)
+            return INT32_MIN;
+        if (v >= (float64)INT32_MAX)
+            return INT32_MAX;
+        return (int32)v;
+    }
+    if (v <= 0)
+        return 0;
+    if (v >= (float64)UINT32_MAX)
+        return (int32)UINT32_MAX;
+    return (int32)(uint32)v;
+}
+
+/* Sign or zero extend lane i of the vector with 8, 16 or 32-bit lanes */
+static int64
+simd_lane(const V128 *v, uint32 lane_bytes, uint32 i, bool is_signed)
+{
+    switch (lane_bytes) {
+        case 1:
+            return is_signed ? (int64)v->i8x16[i] : (int64)(uint8)v->i8x16[i];
+        case 2:
+            return is_signed ? (int64)v->i16x8[i]
+                             : (int64)(uint16)v->i16x8[i];
+        default:
+            return is_signed ? (int64)v->i32x4[i]
+                             : (int64)(uint32)v->i32x4[i];
+    }
+}
+
+static void
+simd_set_lane(V128 *v, uint32 lane_bytes, uint32 i, int64 value)
+{
+    switch (lane_bytes) {
+        case 2:
+            v->i16x8[i] = (int16)value;
+            break;
+        case 4:
+            v->i32x4[i] = (int32)value;
+            break;
+        default:
+            v->i64x2[i] = value;
+            break;
+    }
+}
+
+typedef enum SIMDNativeOpKind {
+    SIMD_NATIVE_UNARY,   /* v128 -> v128 */
+    SIMD_NATIVE_BINARY,  /* v128 v128 -> v128 */
+    SIMD_NATIVE_SHIFT,   /* v128 i32 -> v128 */
+    SIMD_NATIVE_BITMASK, /* v128 -> i32 */
+} SIMDNativeOpKind;
+
+static SIMDNativeOpKind
+simd_native_op_kind(uint8 opcode)
+{
+    switch (opcode) {
+        case SIMD_v8x16_shuffle:
+        case SIMD_v8x16_swizzle:
+        case SIMD_i8x16_narrow_i16x8_s:
+        case SIMD_i8x16_narrow_i16x8_u:
+        case SIMD_i16x8_narrow_i32x4_s:
+        case SIMD_i16x8_narrow_i32x4_u:
+        case SIMD_i16x8_q15mulr_sat_s:
+        case SIMD_i16x8_extmul_low_i8x16_s:
+        case SIMD_i16x8_extmul_high_i8x16_s:
+        case SIMD_i16x8_extmul_low_i8x16_u:
+        case SIMD_i16x8_extmul_high_i8x16_u:
+        case SIMD_i32x4_dot_i16x8_s:
+        case SIMD_i32x4_extmul_low_i16x8_s:
+        case SIMD_i32x4_extmul_high_i16x8_s:
+        case SIMD_i32x4_extmul_low_i16x8_u:
+        case SIMD_i32x4_extmul_high_i16x8_u:
+        case SIMD_i64x2_mul:
+        case SIMD_i64x2_extmul_low_i32x4_s:
+        case SIMD_i64x2_extmul_high_i32x4_s:
+        case SIMD_i64x2_extmul_low_i32x4_u:
+        case SIMD_i64x2_extmul_high_i32x4_u:
+        case SIMD_f32x4_min:
+        case SIMD_f32x4_max:
+        case SIMD_f32x4_pmin:
+        case SIMD_f32x4_pmax:
+        case SIMD_f64x2_min:
+        case SIMD_f64x2_max:
+        case SIMD_f64x2_pmin:
+        case SIMD_f64x2_pmax:
+            return SIMD_NATIVE_BINARY;
+        case SIMD_i8x16_shl:
+        case SIMD_i8x16_shr_s:
+        case SIMD_i8x16_shr_u:
+        case SIMD_i64x2_shr_s:
+            return SIMD_NATIVE_SHIFT;
+        case SIMD_i8x16_bitmask:
+        case SIMD_i16x8_bitmask:
+        case SIMD_i32x4_bitmask:
+        case SIMD_i64x2_bitmask:
+            return SIMD_NATIVE_BITMASK;
+        default:
+            return SIMD_NATIVE_UNARY;
+    }
+}
+
+/* Sign or zero extend half of the lanes of v into a vector with lanes
+   twice as wide, or multiply the extended lanes of v and v2 if v2 isn't
+   NULL */
+static void
+simd_extend(V128 *res, const V128 *v, const V128 *v2, uint32 lane_bytes,
+            bool high, bool is_signed)
+{
+    uint32 lane_num = 8 / lane_bytes, i, j;
+
+    for (i = 0; i < lane_num; i++) {
+        j = high ? i + lane_num : i;
+        if (v2)
+            /* Multiply as unsigned to wrap the u32 * u32 products */
+            simd_set_lane(
+                res, lane_bytes * 2, i,
+                (int64)((uint64)simd_lane(v, lane_bytes, j, is_signed)
+                        * (uint64)simd_lane(v2, lane_bytes, j, is_signed)));
+        else
+            simd_set_lane(res, lane_bytes * 2, i,
+                          simd_lane(v, lane_bytes, j, is_signed));
+    }
+}
+
+static void
+simd_native_op(uint8 *stack, uint32 opcode, uint64 imm_lo, uint64 imm_hi)
+{
+    SIMDNativeOpKind kind = simd_native_op_kind((uint8)opcode);
+    V128 v1, v2, res;
+    uint8 imm[16];
+    int32 count = 0, mask = 0;
+    uint32 i;
+
+    bh_memcpy_s(imm, sizeof(uint64), &imm_lo, sizeof(uint64));
+    bh_memcpy_s(imm + 8, sizeof(uint64), &imm_hi, sizeof(uint64));
+
+    bh_memcpy_s(&v1, sizeof(V128), stack, sizeof(V128));
+    if (kind == SIMD_NATIVE_BINARY)
+        bh_memcpy_s(&v2, sizeof(V128), stack + sizeof(V128), sizeof(V128));
+    else if (kind == SIMD_NATIVE_SHIFT)
+        bh_memcpy_s(&count, sizeof(int32), stack + sizeof(V128),
+                    sizeof(int32));
+    memset(&res, 0, sizeof(V128));
+
+    switch (opcode) {
+        case SIMD_v8x16_shuffle:
+            for (i = 0; i < 16; i++)
+                res.i8x16[i] =
+                    imm[i] < 16 ? v1.i8x16[imm[i]] : v2.i8x16[imm[i] - 16];
+            break;
+        case SIMD_v8x16_swizzle:
+            for (i = 0; i < 16; i++)
+                res.i8x16[i] = (uint8)v2.i8x16[i] < 16
+                                   ? v1.i8x16[(uint8)v2.i8x16[i]]
+                                   : 0;
+            break;
+
+        case SIMD_i8x16_narrow_i16x8_s:
+        case SIMD_i8x16_narrow_i16x8_u:
+            for (i = 0; i < 16; i++) {
+                int32 v = i < 8 ? v1.i16x8[i] : v2.i16x8[i - 8];
+                res.i8x16[i] = (int8)(opcode == SIMD_i8x16_narrow_i16x8_s
+                                          ? sat_i8(v)
+                                          : sat_u8(v));
+            }
+            break;
+        case SIMD_i16x8_narrow_i32x4_s:
+        case SIMD_i16x8_narrow_i32x4_u:
+            for (i = 0; i < 8; i++) {
+                int32 v = i < 4 ? v1.i32x4[i] : v2.i32x4[i - 4];
+                res.i16x8[i] = (int16)(opcode == SIMD_i16x8_narrow_i32x4_s
+                                           ? sat_i16(v)
+                                           : sat_u16(v));
+            }
+            break;
+
+        case SIMD_i16x8_extend_low_i8x16_s:
+        case SIMD_i16x8_extend_high_i8x16_s:
+        case SIMD_i16x8_extend_low_i8x16_u:
+        case SIMD_i16x8_extend_high_i8x16_u:
+            simd_extend(&res, &v1, NULL, 1,
+                        opcode == SIMD_i16x8_extend_high_i8x16_s
+                            || opcode == SIMD_i16x8_extend_high_i8x16_u,
+                        opcode <= SIMD_i16x8_extend_high_i8x16_s);
+            break;
+        case SIMD_i32x4_extend_low_i16x8_s:
+        case SIMD_i32x4_extend_high_i16x8_s:
+        case SIMD_i32x4_extend_low_i16x8_u:
+        case SIMD_i32x4_extend_high_i16x8_u:
+            simd_extend(&res, &v1, NULL, 2,
+                        opcode == SIMD_i32x4_extend_high_i16x8_s
+                            || opcode == SIMD_i32x4_extend_high_i16x8_u,
+                        opcode <= SIMD_i32x4_extend_high_i16x8_s);
+            break;
+        case SIMD_i64x2_extend_low_i32x4_s:
+        case SIMD_i64x2_extend_high_i32x4_s:
+        case SIMD_i64x2_extend_low_i32x4_u:
+        case SIMD_i64x2_extend_high_i32x4_u:
+            simd_extend(&res, &v1, NULL, 4,
+                        opcode == SIMD_i64x2_extend_high_i32x4_s
+                            || opcode == SIMD_i64x2_extend_high_i32x4_u,
+                        opcode <= SIMD_i64x2_extend_high_i32x4_s);
+            break;
+
+        case SIMD_i16x8_extmul_low_i8x16_s:
+        case SIMD_i16x8_extmul_high_i8x16_s:
+        case SIMD_i16x8_extmul_low_i8x16_u:
+        case SIMD_i16x8_extmul_high_i8x16_u:
+            simd_extend(&res, &v1, &v2, 1,
+                        opcode == SIMD_i16x8_extmul_high_i8x16_s
+                            || opcode == SIMD_i16x8_extmul_high_i8x16_u,
+                        opcode <= SIMD_i16x8_extmul_high_i8x16_s);
+            break;
+        case SIMD_i32x4_extmul_low_i16x8_s:
+        case SIMD_i32x4_extmul_high_i16x8_s:
+        case SIMD_i32x4_extmul_low_i16x8_u:
+        case SIMD_i32x4_extmul_high_i16x8_u:
+            simd_extend(&res, &v1, &v2, 2,
+                        opcode == SIMD_i32x4_extmul_high_i16x8_s
+                            || opcode == SIMD_i32x4_extmul_high_i16x8_u,
+                        opcode <= SIMD_i32x4_extmul_high_i16x8_s);
+            break;
+        case SIMD_i64x2_extmul_low_i32x4_s:
+        case SIMD_i64x2_extmul_high_i32x4_s:
+        case SIMD_i64x2_extmul_low_i32x4_u:
+        case SIMD_i64x2_extmul_high_i32x4_u:
+            simd_extend(&res, &v1, &v2, 4,
+                        opcode == SIMD_i64x2_extmul_high_i32x4_s
+                            || opcode == SIMD_i64x2_extmul_high_i32x4_u,
+                        opcode <= SIMD_i64x2_extmul_high_i32x4_s);
+            break;
+
+        case SIMD_i16x8_extadd_pairwise_i8x16_s:
+        case SIMD_i16x8_extadd_pairwise_i8x16_u:
+            for (i = 0; i < 8; i++)
+                res.i16x8[i] = (int16)(
+                    simd_lane(&v1, 1, i * 2,
+                              opcode == SIMD_i16x8_extadd_pairwise_i8x16_s)
+                    + simd_lane(&v1, 1, i * 2 + 1,
+                                opcode == SIMD_i16x8_extadd_pairwise_i8x16_s));
+            break;
+        case SIMD_i32x4_extadd_pairwise_i16x8_s:
+        case SIMD_i32x4_extadd_pairwise_i16x8_u:
+            for (i = 0; i < 4; i++)
+                res.i32x4[i] = (int32)(
+                    simd_lane(&v1, 2, i * 2,
+                              opcode == SIMD_i32x4_extadd_pairwise_i16x8_s)
+                    + simd_lane(&v1, 2, i * 2 + 1,
+                                opcode == SIMD_i32x4_extadd_pairwise_i16x8_s));
+            break;
+
+        case SIMD_i16x8_q15mulr_sat_s:
+            for (i = 0; i < 8; i++)
+                res.i16x8[i] = (int16)sat_i16(
+                    ((int32)v1.i16x8[i] * v2.i16x8[i] + 0x4000) >> 15);
+            break;
+        case SIMD_i32x4_dot_i16x8_s:
+            for (i = 0; i < 4; i++)
+                res.i32x4[i] = (int32)(uint32)(
+                    (int64)v1.i16x8[i * 2] * v2.i16x8[i * 2]
+                    + (int64)v1.i16x8[i * 2 + 1] * v2.i16x8[i * 2 + 1]);
+            break;
+        case SIMD_i64x2_mul:
+            for (i = 0; i < 2; i++)
+                res.i64x2[i] =
+                    (int64)((uint64)v1.i64x2[i] * (uint64)v2.i64x2[i]);
+            break;
+
+        case SIMD_i8x16_popcnt:
+            for (i = 0; i < 16; i++) {
+                uint8 b = (uint8)v1.i8x16[i], n = 0;
+                for (; b; b &= (uint8)(b - 1))
+                    n++;
+                res.i8x16[i] = (int8)n;
+            }
+            break;
+
+        case SIMD_i8x16_shl:
+            for (i = 0; i < 16; i++)
+                res.i8x16[i] = (int8)((uint8)v1.i8x16[i] << (count & 7));
+            break;
+        case SIMD_i8x16_shr_s:
+            for (i = 0; i < 16; i++)
+                res.i8x16[i] = (int8)(v1.i8x16[i] >> (count & 7));
+            break;
+        case SIMD_i8x16_shr_u:
+            for (i = 0; i < 16; i++)
+                res.i8x16[i] = (int8)((uint8)v1.i8x16[i] >> (count & 7));
+            break;
+        case SIMD_i64x2_shr_s:
+            for (i = 0; i < 2; i++)
+                res.i64x2[i] = v1.i64x2[i] >> (count & 63);
+            break;
+
+        case SIMD_i8x16_bitmask:
+            for (i = 0; i < 16; i++)
+                mask |= (v1.i8x16[i] < 0 ? 1 : 0) << i;
+            break;
+        case SIMD_i16x8_bitmask:
+            for (i = 0; i < 8; i++)
+                mask |= (v1.i16x8[i] < 0 ? 1 : 0) << i;
+            break;
+        case SIMD_i32x4_bitmask:
+            for (i = 0; i < 4; i++)
+                mask |= (v1.i32x4[i] < 0 ? 1 : 0) << i;
+            break;
+        case SIMD_i64x2_bitmask:
+            for (i = 0; i < 2; i++)
+                mask |= (v1.i64x2[i] < 0 ? 1 : 0) << i;
+            break;
+
+        case SIMD_f32x4_ceil:
+        case SIMD_f32x4_floor:
+        case SIMD_f32x4_trunc:
+        case SIMD_f32x4_nearest:
+            for (i = 0; i < 4; i++) {
+                float32 f = v1.f32x4[i];
+                res.f32x4[i] = opcode == SIMD_f32x4_ceil    ? ceilf(f)
+                               : opcode == SIMD_f32x4_floor ? floorf(f)
+                               : opcode == SIMD_f32x4_trunc ? truncf(f)
+                                                            : rintf(f);
+            }
+            break;
+        case SIMD_f64x2_ceil:
+        case SIMD_f64x2_floor:
+        case SIMD_f64x2_trunc:
+        case SIMD_f64x2_nearest:
+            for (i = 0; i < 2; i++) {
+                float64 f = v1.f64x2[i];
+                res.f64x2[i] = opcode == SIMD_f64x2_ceil    ? ceil(f)
+                               : opcode == SIMD_f64x2_floor ? floor(f)
+                               : opcode == SIMD_f64x2_trunc ? trunc(f)
+                                                            : rint(f);
+            }
+            break;
+
+        case SIMD_f32x4_min:
+        case SIMD_f32x4_max:
+            for (i = 0; i < 4; i++)
+                res.f32x4[i] =
+                    (float32)(opcode == SIMD_f32x4_min
+                                  ? simd_fmin(v1.f32x4[i], v2.f32x4[i])
+                                  : simd_fmax(v1.f32x4[i], v2.f32x4[i]));
+            break;
+        case SIMD_f64x2_min:
+        case SIMD_f64x2_max:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] = opcode == SIMD_f64x2_min
+                                   ? simd_fmin(v1.f64x2[i], v2.f64x2[i])
+                                   : simd_fmax(v1.f64x2[i], v2.f64x2[i]);
+            break;
+        case SIMD_f32x4_pmin:
+            for (i = 0; i < 4; i++)
+                res.f32x4[i] =
+                    v2.f32x4[i] < v1.f32x4[i] ? v2.f32x4[i] : v1.f32x4[i];
+            break;
+        case SIMD_f32x4_pmax:
+            for (i = 0; i < 4; i++)
+                res.f32x4[i] =
+                    v1.f32x4[i] < v2.f32x4[i] ? v2.f32x4[i] : v1.f32x4[i];
+            break;
+        case SIMD_f64x2_pmin:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] =
+                    v2.f64x2[i] < v1.f64x2[i] ? v2.f64x2[i] : v1.f64x2[i];
+            break;
+        case SIMD_f64x2_pmax:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] =
+                    v1.f64x2[i] < v2.f64x2[i] ? v2.f64x2[i] : v1.f64x2[i];
+            break;
+
+        case SIMD_f32x4_convert_i32x4_s:
+            for (i = 0; i < 4; i++)
+                res.f32x4[i] = (float32)v1.i32x4[i];
+            break;
+        case SIMD_f32x4_convert_i32x4_u:
+            for (i = 0; i < 4; i++)
+                res.f32x4[i] = (float32)(uint32)v1.i32x4[i];
+            break;
+        case SIMD_f64x2_convert_low_i32x4_s:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] = (float64)v1.i32x4[i];
+            break;
+        case SIMD_f64x2_convert_low_i32x4_u:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] = (float64)(uint32)v1.i32x4[i];
+            break;
+        case SIMD_f32x4_demote_f64x2_zero:
+            for (i = 0; i < 2; i++)
+                res.f32x4[i] = (float32)v1.f64x2[i];
+            break;
+        case SIMD_f64x2_promote_low_f32x4_zero:
+            for (i = 0; i < 2; i++)
+                res.f64x2[i] = (float64)v1.f32x4[i];
+            break;
+        case SIMD_i32x4_trunc_sat_f32x4_s:
+        case SIMD_i32x4_trunc_sat_f32x4_u:
+            for (i = 0; i < 4; i++)
+                res.i32x4[i] = simd_trunc_sat_i32(
+                    v1.f32x4[i], opcode == SIMD_i32x4_trunc_sat_f32x4_s);
+            break;
+        case SIMD_i32x4_trunc_sat_f64x2_s_zero:
+        case SIMD_i32x4_trunc_sat_f64x2_u_zero:
+            for (i = 0; i < 2; i++)
+                res.i32x4[i] = simd_trunc_sat_i32(
+                    v1.f64x2[i], opcode == SIMD_i32x4_trunc_sat_f64x2_s_zero);
+            break;
+
+        default:
+            bh_assert(0);
+            break;
+    }
+
+    if (kind == SIMD_NATIVE_BITMASK)
+        bh_memcpy_s(stack, sizeof(int32), &mask, sizeof(int32));
+    else
+        bh_memcpy_s(stack, sizeof(V128), &res, sizeof(V128));
+}
+
+bool
+jit_compile_simd_native_op(JitCompContext *cc, uint8 opcode,
+                           const uint8 *imm_bytes)
+{
+    SIMDNativeOpKind kind = simd_native_op_kind(opcode);
+    JitReg v1, v2 = 0, count = 0, stack, res, args[4];
+    int64 imm_lo = 0, imm_hi = 0;
+    uint32 offset;
+
+    if (imm_bytes) {
+        bh_memcpy_s(&imm_lo, sizeof(int64), imm_bytes, sizeof(int64));
+        bh_memcpy_s(&imm_hi, sizeof(int64), imm_bytes + 8, sizeof(int64));
+    }
+
+    if (kind == SIMD_NATIVE_BINARY)
+        POP_V128(v2);
+    else if (kind == SIMD_NATIVE_SHIFT)
+        POP_I32(count);
+    POP_V128(v1);
+
+    /* The operands are popped, pass their operand stack slots to the
+       native function, which overwrites them with the result */
+    offset = offset_of_local((uint32)(cc->jit_frame->sp - cc->jit_frame->lp));
+    GEN_INSN(STV128, v1, cc->fp_reg, NEW_CONST(I32, offset));
+    if (v2)
+        GEN_INSN(STV128, v2, cc->fp_reg,
+                 NEW_CONST(I32, offset + sizeof(V128)));
+    else if (count)
+        GEN_INSN(STI32, count, cc->fp_reg,
+                 NEW_CONST(I32, offset + sizeof(V128)));
+
+    stack = jit_cc_new_reg_ptr(cc);
+    GEN_INSN(ADD, stack, cc->fp_reg, NEW_CONST(PTR, offset));
+
+    args[0] = stack;
+    args[1] = NEW_CONST(I32, opcode);
+    args[2] = NEW_CONST(I64, imm_lo);
+    args[3] = NEW_CONST(I64, imm_hi);
+    if (!jit_emit_callnative(cc, simd_native_op, 0, args, 4))
+        goto fail;
+
+    if (kind == SIMD_NATIVE_BITMASK) {
+        res = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDI32, res, cc->fp_reg, NEW_CONST(I32, offset));
+        PUSH_I32(res);
+    }
+    else {
+        res = jit_cc_new_reg_V128(cc);
+        GEN_INSN(LDV128, res, cc->fp_reg, NEW_CONST(I32, offset));
+        PUSH_V128(res);
+    }
+    return true;
+fail:
+    return false;
+}
+
+bool
+jit_compile_simd_load_extend(JitCompContext *cc, uint8 opcode, uint32 align,
+                             uint32 offset)
+{
+    JitReg value, vector;
+    uint8 extend_opcode;
+
+    switch (opcode) {
+        case SIMD_v128_load8x8_s:
+            extend_opcode = SIMD_i16x8_extend_low_i8x16_s;
+            break;
+        case SIMD_v128_load8x8_u:
+            extend_opcode = SIMD_i16x8_extend_low_i8x16_u;
+            break;
+        case SIMD_v128_load16x4_s:
+            extend_opcode = SIMD_i32x4_extend_low_i16x8_s;
+            break;
+        case SIMD_v128_load16x4_u:
+            extend_opcode = SIMD_i32x4_extend_low_i16x8_u;
+            break;
+        case SIMD_v128_load32x2_s:
+            extend_opcode = SIMD_i64x2_extend_low_i32x4_s;
+            break;
+        case SIMD_v128_load32x2_u:
+            extend_opcode = SIMD_i64x2_extend_low_i32x4_u;
+            break;
+        default:
+            bh_assert(0);
+            return false;
+    }
+
+    /* Load the 64 bits as i64, move them to the low half of a vector and
+       extend its lanes */
+    if (!jit_compile_op_i64_load(cc, align, offset, 8, false, false))
+        return false;
+
+    POP_I64(value);
+    vector = jit_cc_new_reg_V128(cc);
+    GEN_INSN(V128SPLAT, vector, value, V128_SHAPE(JIT_V128_I64X2));
+    PUSH_V128(vector);
+
+    return jit_compile_simd_native_op(cc, extend_opcode, NULL);
+fail:
+    return false;
+}
+
+#endif /* end of WASM_ENABLE_SIMD != 0 */
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _JIT_EMIT_SIMD_H_
+#define _JIT_EMIT_SIMD_H_
+
+#include "../jit_compiler.h"
+#include "../jit_frontend.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_SIMD != 0
+bool
+jit_compile_simd_v128_const(JitCompContext *cc, const uint8 *imm_bytes);
+
+bool
+jit_compile_simd_splat(JitCompContext *cc, JitV128Shape shape);
+
+bool
+jit_compile_simd_extract_lane(JitCompContext *cc, JitV128Shape shape,
+                              uint8 lane_id, bool is_signed);
+
+bool
+jit_compile_simd_replace_lane(JitCompContext *cc, JitV128Shape shape,
+                              uint8 lane_id);
+
+bool
+jit_compile_simd_v128_bitwise(JitCompContext *cc, V128Bitwise bitwise_op);
+
+bool
+jit_compile_simd_v128_any_true(JitCompContext *cc);
+
+bool
+jit_compile_simd_all_true(JitCompContext *cc, JitV128Shape shape);
+
+bool
+jit_compile_simd_int_compare(JitCompContext *cc, JitV128Shape shape,
+                             IntCond cond);
+
+bool
+jit_compile_simd_float_compare(JitCompContext *cc, JitV128Shape shape,
+                               FloatCond cond);
+
+bool
+jit_compile_simd_arithmetic(JitCompContext *cc, JitV128Shape shape,
+                            V128Arithmetic arith_op, bool is_signed);
+
+bool
+jit_compile_simd_sat_arithmetic(JitCompContext *cc, JitV128Shape shape,
+                                V128Arithmetic arith_op, bool is_signed);
+
+bool
+jit_compile_simd_avgr_u(JitCompContext *cc, JitV128Shape shape);
+
+bool
+jit_compile_simd_abs(JitCompContext *cc, JitV128Shape shape);
+
+bool
+jit_compile_simd_sqrt(JitCompContext *cc, JitV128Shape shape);
+
+bool
+jit_compile_simd_shift(JitCompContext *cc, JitV128Shape shape,
+                       IntShift shift_op);
+
+/**
+ * Compile a SIMD instruction which has no IR instruction into a call to
+ * a native function, the instructions handled are shuffle, swizzle,
+ * narrow, extend, extmul, extadd_pairwise, dot, q15mulr_sat, popcnt,
+ * bitmask, i8x16 and i64x2.shr_s shifts, i64x2.mul, float rounding,
+ * min/max, pmin/pmax and the conversions.
+ *
+ * @param cc the compilation context
+ * @param opcode the SIMD opcode
+ * @param imm_bytes the lane indexes of i8x16.shuffle, NULL for others
+ *
+ * @return true if success, false otherwise
+ */
+bool
+jit_compile_simd_native_op(JitCompContext *cc, uint8 opcode,
+                           const uint8 *imm_bytes);
+
+bool
+jit_compile_simd_load_extend(JitCompContext *cc, uint8 opcode, uint32 align,
+                             uint32 offset);
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
+#ifdef __cplusplus
+} /* end of extern "C" */
+#endif
+
+#endif /* end of _JIT_EMIT_SIMD_H_ */
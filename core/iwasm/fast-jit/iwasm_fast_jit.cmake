@@ -17,7 +17,8 @@ endif ()
 include_directories (${IWASM_FAST_JIT_DIR})
 enable_language(CXX)
 
-if (WAMR_BUILD_TARGET STREQUAL "X86_64" OR WAMR_BUILD_TARGET STREQUAL "AMD_64")
+if (WAMR_BUILD_TARGET STREQUAL "X86_64" OR WAMR_BUILD_TARGET STREQUAL "AMD_64"
+    OR WAMR_BUILD_TARGET MATCHES "AARCH64.*")
     include(FetchContent)
     if (NOT WAMR_BUILD_PLATFORM STREQUAL "linux-sgx")
         FetchContent_Declare(
@@ -47,16 +48,26 @@ if (WAMR_BUILD_TARGET STREQUAL "X86_64" OR WAMR_BUILD_TARGET STREQUAL "AMD_64")
         add_definitions(-DASMJIT_NO_VALIDATION)
         add_definitions(-DASMJIT_NO_INTROSPECTION)
         add_definitions(-DASMJIT_NO_INTRINSICS)
-        add_definitions(-DASMJIT_NO_AARCH64)
         add_definitions(-DASMJIT_NO_AARCH32)
         include_directories("${asmjit_SOURCE_DIR}/src")
         add_subdirectory(${asmjit_SOURCE_DIR} ${asmjit_BINARY_DIR} EXCLUDE_FROM_ALL)
-        file (GLOB_RECURSE cpp_source_asmjit
-            ${asmjit_SOURCE_DIR}/src/asmjit/core/*.cpp
-            ${asmjit_SOURCE_DIR}/src/asmjit/x86/*.cpp
-        )
+        if (WAMR_BUILD_TARGET MATCHES "AARCH64.*")
+            add_definitions(-DASMJIT_NO_X86)
+            file (GLOB_RECURSE cpp_source_asmjit
+                ${asmjit_SOURCE_DIR}/src/asmjit/core/*.cpp
+                ${asmjit_SOURCE_DIR}/src/asmjit/arm/*.cpp
+            )
+        else ()
+            add_definitions(-DASMJIT_NO_AARCH64)
+            file (GLOB_RECURSE cpp_source_asmjit
+                ${asmjit_SOURCE_DIR}/src/asmjit/core/*.cpp
+                ${asmjit_SOURCE_DIR}/src/asmjit/x86/*.cpp
+            )
+        endif ()
     endif ()
-    if (WAMR_BUILD_FAST_JIT_DUMP EQUAL 1)
+    # zydis is an x86 disassembler, the AArch64 codegen dumps raw words
+    if (WAMR_BUILD_FAST_JIT_DUMP EQUAL 1
+        AND NOT WAMR_BUILD_TARGET MATCHES "AARCH64.*")
         FetchContent_Declare(
             zycore
             GIT_REPOSITORY https://github.com/zyantific/zycore-c.git
@@ -96,6 +107,8 @@ file (GLOB c_source_jit ${IWASM_FAST_JIT_DIR}/*.c ${IWASM_FAST_JIT_DIR}/fe/*.c)
 
 if (WAMR_BUILD_TARGET STREQUAL "X86_64" OR WAMR_BUILD_TARGET STREQUAL "AMD_64")
   file (GLOB_RECURSE cpp_source_jit_cg ${IWASM_FAST_JIT_DIR}/cg/x86-64/*.cpp)
+elseif (WAMR_BUILD_TARGET MATCHES "AARCH64.*")
+  file (GLOB_RECURSE cpp_source_jit_cg ${IWASM_FAST_JIT_DIR}/cg/aarch64/*.cpp)
 else ()
   message (FATAL_ERROR "Fast JIT codegen for target ${WAMR_BUILD_TARGET} isn't implemented")
 endif ()
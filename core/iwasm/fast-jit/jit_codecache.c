@@ -53,6 +53,51 @@ jit_code_cache_free(void *ptr)
         mem_allocator_free(code_cache_pool_allocator, ptr);
 }
 
+#if WASM_ENABLE_LAZY_JIT != 0
+static bool
+register_osr_entries(JitCompContext *cc)
+{
+    WASMFunction *func = cc->cur_wasm_func;
+    WASMFastJITOSREntry *osr_entries = NULL;
+    JitLoopEntry *loop_entry;
+    uint32 count = 0;
+
+    for (loop_entry = cc->loop_entries; loop_entry;
+         loop_entry = loop_entry->next) {
+        if (*jit_annl_basic_block(cc, loop_entry->label))
+            count++;
+    }
+
+    if (count > 0) {
+        if (!(osr_entries = jit_malloc(sizeof(WASMFastJITOSREntry) * count))) {
+            jit_set_last_error(cc, "allocate memory failed");
+            return false;
+        }
+
+        count = 0;
+        for (loop_entry = cc->loop_entries; loop_entry;
+             loop_entry = loop_entry->next) {
+            if (*jit_annl_basic_block(cc, loop_entry->label)) {
+                osr_entries[count].ip =
+                    *jit_annl_begin_bcip(cc, loop_entry->label);
+                osr_entries[count].jitted_addr =
+                    *jit_annl_jitted_addr(cc, loop_entry->label);
+                count++;
+            }
+        }
+    }
+
+    func->fast_jit_osr_entry_count = count;
+    func->fast_jit_frame_size = cc->total_frame_size;
+    /* Publish the entries after the count and the frame size, the
+       interpreter reads them after an acquire load of the entries */
+    if (osr_entries)
+        __atomic_store_n(&func->fast_jit_osr_entries, osr_entries,
+                         __ATOMIC_RELEASE);
+    return true;
+}
+#endif
+
 bool
 jit_pass_register_jitted_code(JitCompContext *cc)
 {
@@ -61,6 +106,11 @@ jit_pass_register_jitted_code(JitCompContext *cc)
     WASMFunction *func = cc->cur_wasm_func;
     uint32 jit_func_idx = cc->cur_wasm_func_idx - module->import_function_count;
 
+#if WASM_ENABLE_LAZY_JIT != 0
+    if (!register_osr_entries(cc))
+        return false;
+#endif
+
 #if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_JIT != 0 \
     && WASM_ENABLE_LAZY_JIT != 0
     os_mutex_lock(&module->instance_list_lock);
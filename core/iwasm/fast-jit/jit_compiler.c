@@ -26,7 +26,13 @@ static JitCompilerPass compiler_passes[] = {
     REG_PASS(lower_cg),
     REG_PASS(regalloc),
     REG_PASS(codegen),
-    REG_PASS(register_jitted_code)
+    REG_PASS(register_jitted_code),
+    REG_PASS(const_prop),
+    REG_PASS(copy_prop),
+    REG_PASS(cse),
+    REG_PASS(bounds_check_elim),
+    REG_PASS(dce),
+    REG_PASS(regalloc_linear_scan)
 #undef REG_PASS
 };
 
@@ -37,12 +43,33 @@ static JitCompilerPass compiler_passes[] = {
 static const uint8 compiler_passes_without_dump[] = {
     3, 4, 5, 6, 7, 0
 };
+
+/* Passes with optimizations of opt level 1 and 2 */
+static const uint8 compiler_passes_o1_without_dump[] = {
+    3, 8, 9, 12, 4, 5, 6, 7, 0
+};
+
+static const uint8 compiler_passes_o2_without_dump[] = {
+    3, 8, 9, 10, 11, 12, 4, 5, 6, 7, 0
+};
 #else
 static const uint8 compiler_passes_with_dump[] = {
     3, 2, 1, 4, 1, 5, 1, 6, 1, 7, 0
 };
+
+static const uint8 compiler_passes_o1_with_dump[] = {
+    3, 2, 1, 8, 9, 12, 1, 4, 1, 5, 1, 6, 1, 7, 0
+};
+
+static const uint8 compiler_passes_o2_with_dump[] = {
+    3, 2, 1, 8, 9, 10, 11, 12, 1, 4, 1, 5, 1, 6, 1, 7, 0
+};
 #endif
 
+/* Pass sequence with the regalloc pass replaced by the linear scan one,
+   which must be long enough for all sequences above */
+static uint8 compiler_passes_linear_scan[24];
+
 /* The exported global data of JIT compiler */
 static JitGlobals jit_globals = {
 #if WASM_ENABLE_FAST_JIT_DUMP == 0
@@ -83,9 +110,45 @@ jit_compiler_init(const JitCompOptions *options)
     uint32 code_cache_size = options->code_cache_size > 0
                                  ? options->code_cache_size
                                  : FAST_JIT_DEFAULT_CODE_CACHE_SIZE;
+    uint32 opt_level = options->opt_level;
+
+    LOG_VERBOSE("JIT: compiler init with code cache size: %u, opt level: %u, "
+                "regalloc: %u, tier-up threshold: %u\n",
+                code_cache_size, opt_level, options->regalloc,
+                options->tierup_threshold);
 
-    LOG_VERBOSE("JIT: compiler init with code cache size: %u\n",
-                code_cache_size);
+#if WASM_ENABLE_FAST_JIT_DUMP == 0
+    if (opt_level >= 2)
+        jit_globals.passes = compiler_passes_o2_without_dump;
+    else if (opt_level == 1)
+        jit_globals.passes = compiler_passes_o1_without_dump;
+    else
+        jit_globals.passes = compiler_passes_without_dump;
+#else
+    if (opt_level >= 2)
+        jit_globals.passes = compiler_passes_o2_with_dump;
+    else if (opt_level == 1)
+        jit_globals.passes = compiler_passes_o1_with_dump;
+    else
+        jit_globals.passes = compiler_passes_with_dump;
+#endif
+
+    if (options->regalloc == JIT_REGALLOC_LINEAR_SCAN) {
+        uint32 i;
+
+        for (i = 0; jit_globals.passes[i]; i++) {
+            bh_assert(i + 1 < sizeof(compiler_passes_linear_scan));
+            /* Pass 5 is regalloc, 13 is regalloc_linear_scan */
+            compiler_passes_linear_scan[i] =
+                jit_globals.passes[i] == 5 ? 13 : jit_globals.passes[i];
+        }
+        compiler_passes_linear_scan[i] = 0;
+        jit_globals.passes = compiler_passes_linear_scan;
+    }
+
+#if WASM_ENABLE_LAZY_JIT != 0
+    jit_globals.tierup_threshold = options->tierup_threshold;
+#endif
 
     if (!jit_code_cache_init(code_cache_size))
         return false;
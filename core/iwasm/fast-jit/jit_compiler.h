@@ -20,6 +20,14 @@ typedef struct JitGlobals {
     char *return_to_interp_from_jitted;
 #if WASM_ENABLE_LAZY_JIT != 0
     char *compile_fast_jit_and_then_call;
+    /* Number of calls and loop iterations of a function run by the
+       interpreter before it is compiled, 0 means compiling eagerly */
+    uint32 tierup_threshold;
+#endif
+#if WASM_ENABLE_SIMD != 0
+    /* Whether the host CPU supports the vector instructions which the
+       codegen lowers v128 operations to, set by jit_codegen_init */
+    bool simd_supported;
 #endif
 } JitGlobals;
 
@@ -66,10 +74,25 @@ typedef struct JitInterpSwitchInfo {
     } out;
 } JitInterpSwitchInfo;
 
+/**
+ * Register allocators of the Fast JIT compiler.
+ */
+typedef enum JitRegallocKind {
+    JIT_REGALLOC_LOCAL = 0,  /* local allocation per basic block */
+    JIT_REGALLOC_LINEAR_SCAN /* global linear scan allocation */
+} JitRegallocKind;
+
 /* Jit compiler options */
 typedef struct JitCompOptions {
     uint32 code_cache_size;
+    /* 0: no optimization, 1: constant/copy propagation and dead code
+       elimination, 2: plus CSE and boundary check elimination */
     uint32 opt_level;
+    /* The register allocator, see JitRegallocKind */
+    uint32 regalloc;
+    /* Hotness threshold of the interpreter to tier up a function to
+       the jitted code, 0 means compiling the functions eagerly */
+    uint32 tierup_threshold;
 } JitCompOptions;
 
 bool
@@ -143,6 +166,14 @@ jit_pass_lower_cg(JitCompContext *cc);
 bool
 jit_pass_regalloc(JitCompContext *cc);
 
+/**
+ * Allocate registers with linear scan over the live intervals of the
+ * whole function, registers live across basic blocks may stay in hard
+ * registers instead of being spilled at block boundaries.
+ */
+bool
+jit_pass_regalloc_linear_scan(JitCompContext *cc);
+
 /**
  * Native code generation.
  */
@@ -155,6 +186,38 @@ jit_pass_codegen(JitCompContext *cc);
 bool
 jit_pass_register_jitted_code(JitCompContext *cc);
 
+/**
+ * Propagate constants into their uses and fold the instructions whose
+ * operands are all constants.
+ */
+bool
+jit_pass_const_prop(JitCompContext *cc);
+
+/**
+ * Replace uses of copied registers with the copy sources.
+ */
+bool
+jit_pass_copy_prop(JitCompContext *cc);
+
+/**
+ * Eliminate common subexpressions in basic blocks.
+ */
+bool
+jit_pass_cse(JitCompContext *cc);
+
+/**
+ * Eliminate linear memory boundary checks dominated by an equal or
+ * wider check on the same address in a basic block.
+ */
+bool
+jit_pass_bounds_check_elim(JitCompContext *cc);
+
+/**
+ * Remove instructions whose results are never used.
+ */
+bool
+jit_pass_dce(JitCompContext *cc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -52,6 +52,11 @@ jit_dump_reg(JitCompContext *cc, JitReg reg)
                 os_printf("D%d", no);
             break;
 
+        case JIT_REG_KIND_V128:
+            bh_assert(!jit_reg_is_const(reg));
+            os_printf("V%d", no);
+            break;
+
         case JIT_REG_KIND_L32:
             os_printf("L%d", no);
             break;
@@ -314,15 +319,21 @@ jit_pass_dump(JitCompContext *cc)
     const char *pass_name =
         pass_no > 0 ? jit_compiler_get_pass_name(passes[pass_no - 1]) : "NULL";
 
-#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64) \
+    || defined(BUILD_TARGET_AARCH64)
     if (!strcmp(pass_name, "lower_cg"))
-        /* Ignore lower codegen pass as it does nothing in x86-64 */
+        /* Ignore lower codegen pass as it does nothing in x86-64 and
+           aarch64 */
         return true;
 #endif
 
     os_printf("JIT.COMPILER.DUMP: PASS_NO=%d PREV_PASS=%s\n\n", pass_no,
               pass_name);
 
+    if (!strncmp(pass_name, "regalloc", strlen("regalloc")))
+        os_printf("JIT.COMPILER.REGALLOC: SPILLS=%u RELOADS=%u\n\n",
+                  cc->spill_insn_num, cc->reload_insn_num);
+
     jit_dump_cc(cc);
 
     os_printf("\n");
@@ -14,6 +14,7 @@
 #include "fe/jit_emit_memory.h"
 #include "fe/jit_emit_numberic.h"
 #include "fe/jit_emit_parametric.h"
+#include "fe/jit_emit_simd.h"
 #include "fe/jit_emit_table.h"
 #include "fe/jit_emit_variable.h"
 #include "../interpreter/wasm_interp.h"
@@ -844,6 +845,22 @@ gen_load_f64(JitFrame *frame, unsigned n)
     return frame->lp[n].reg;
 }
 
+#if WASM_ENABLE_SIMD != 0
+JitReg
+gen_load_v128(JitFrame *frame, unsigned n)
+{
+    if (!frame->lp[n].reg) {
+        JitCompContext *cc = frame->cc;
+        frame->lp[n].reg = frame->lp[n + 1].reg = frame->lp[n + 2].reg =
+            frame->lp[n + 3].reg = jit_cc_new_reg_V128(cc);
+        GEN_INSN(LDV128, frame->lp[n].reg, cc->fp_reg,
+                 NEW_CONST(I32, offset_of_local(n)));
+    }
+
+    return frame->lp[n].reg;
+}
+#endif
+
 void
 gen_commit_values(JitFrame *frame, JitValueSlot *begin, JitValueSlot *end)
 {
@@ -880,6 +897,16 @@ gen_commit_values(JitFrame *frame, JitValueSlot *begin, JitValueSlot *end)
                          NEW_CONST(I32, offset_of_local(n)));
                 (++p)->dirty = 0;
                 break;
+
+#if WASM_ENABLE_SIMD != 0
+            case JIT_REG_KIND_V128:
+                GEN_INSN(STV128, p->reg, cc->fp_reg,
+                         NEW_CONST(I32, offset_of_local(n)));
+                (++p)->dirty = 0;
+                (++p)->dirty = 0;
+                (++p)->dirty = 0;
+                break;
+#endif
         }
     }
 }
@@ -2577,6 +2604,496 @@ jit_compile_func(JitCompContext *cc)
             }
 #endif /* end of WASM_ENABLE_SHARED_MEMORY */
 
+#if WASM_ENABLE_SIMD != 0
+            case WASM_OP_SIMD_PREFIX:
+            {
+                uint32 opcode1;
+                uint8 lane_id;
+                JitV128Shape shape;
+
+                if (!jit_compiler_get_jit_globals()->simd_supported) {
+                    jit_set_last_error(cc, "SIMD not supported by host CPU");
+                    return false;
+                }
+
+                read_leb_uint32(frame_ip, frame_ip_end, opcode1);
+                /* opcode1 was checked in loader and is no larger than
+                   UINT8_MAX */
+                opcode = (uint8)opcode1;
+
+                switch (opcode) {
+                    case SIMD_v128_load:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        if (!jit_compile_op_v128_load(cc, align, offset))
+                            return false;
+                        break;
+
+                    case SIMD_v128_store:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        if (!jit_compile_op_v128_store(cc, align, offset))
+                            return false;
+                        break;
+
+                    case SIMD_v128_load8_splat:
+                    case SIMD_v128_load16_splat:
+                    case SIMD_v128_load32_splat:
+                    case SIMD_v128_load64_splat:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        bytes = 1 << (opcode - SIMD_v128_load8_splat);
+                        if (!jit_compile_op_v128_load_splat(cc, align, offset,
+                                                            bytes))
+                            return false;
+                        break;
+
+                    case SIMD_v128_load32_zero:
+                    case SIMD_v128_load64_zero:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        bytes = opcode == SIMD_v128_load32_zero ? 4 : 8;
+                        if (!jit_compile_op_v128_load_zero(cc, align, offset,
+                                                           bytes))
+                            return false;
+                        break;
+
+                    case SIMD_v128_load8_lane:
+                    case SIMD_v128_load16_lane:
+                    case SIMD_v128_load32_lane:
+                    case SIMD_v128_load64_lane:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane_id = *frame_ip++;
+                        bytes = 1 << (opcode - SIMD_v128_load8_lane);
+                        if (!jit_compile_op_v128_load_lane(cc, align, offset,
+                                                           bytes, lane_id))
+                            return false;
+                        break;
+
+                    case SIMD_v128_store8_lane:
+                    case SIMD_v128_store16_lane:
+                    case SIMD_v128_store32_lane:
+                    case SIMD_v128_store64_lane:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        lane_id = *frame_ip++;
+                        bytes = 1 << (opcode - SIMD_v128_store8_lane);
+                        if (!jit_compile_op_v128_store_lane(cc, align, offset,
+                                                            bytes, lane_id))
+                            return false;
+                        break;
+
+                    case SIMD_v128_const:
+                        if (!jit_compile_simd_v128_const(cc, frame_ip))
+                            return false;
+                        frame_ip += 16;
+                        break;
+
+                    case SIMD_i8x16_splat:
+                    case SIMD_i16x8_splat:
+                    case SIMD_i32x4_splat:
+                    case SIMD_i64x2_splat:
+                    case SIMD_f32x4_splat:
+                    case SIMD_f64x2_splat:
+                        shape = JIT_V128_I8X16 + opcode - SIMD_i8x16_splat;
+                        if (!jit_compile_simd_splat(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_extract_lane_s:
+                    case SIMD_i8x16_extract_lane_u:
+                        lane_id = *frame_ip++;
+                        if (!jit_compile_simd_extract_lane(
+                                cc, JIT_V128_I8X16, lane_id,
+                                opcode == SIMD_i8x16_extract_lane_s))
+                            return false;
+                        break;
+
+                    case SIMD_i16x8_extract_lane_s:
+                    case SIMD_i16x8_extract_lane_u:
+                        lane_id = *frame_ip++;
+                        if (!jit_compile_simd_extract_lane(
+                                cc, JIT_V128_I16X8, lane_id,
+                                opcode == SIMD_i16x8_extract_lane_s))
+                            return false;
+                        break;
+
+                    case SIMD_i32x4_extract_lane:
+                    case SIMD_i64x2_extract_lane:
+                    case SIMD_f32x4_extract_lane:
+                    case SIMD_f64x2_extract_lane:
+                        lane_id = *frame_ip++;
+                        shape = JIT_V128_I32X4
+                                + (opcode - SIMD_i32x4_extract_lane) / 2;
+                        if (!jit_compile_simd_extract_lane(cc, shape, lane_id,
+                                                           false))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_replace_lane:
+                    case SIMD_i16x8_replace_lane:
+                        lane_id = *frame_ip++;
+                        shape = opcode == SIMD_i8x16_replace_lane
+                                    ? JIT_V128_I8X16
+                                    : JIT_V128_I16X8;
+                        if (!jit_compile_simd_replace_lane(cc, shape, lane_id))
+                            return false;
+                        break;
+
+                    case SIMD_i32x4_replace_lane:
+                    case SIMD_i64x2_replace_lane:
+                    case SIMD_f32x4_replace_lane:
+                    case SIMD_f64x2_replace_lane:
+                        lane_id = *frame_ip++;
+                        shape = JIT_V128_I32X4
+                                + (opcode - SIMD_i32x4_replace_lane) / 2;
+                        if (!jit_compile_simd_replace_lane(cc, shape, lane_id))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_eq:
+                    case SIMD_i8x16_ne:
+                    case SIMD_i8x16_lt_s:
+                    case SIMD_i8x16_lt_u:
+                    case SIMD_i8x16_gt_s:
+                    case SIMD_i8x16_gt_u:
+                    case SIMD_i8x16_le_s:
+                    case SIMD_i8x16_le_u:
+                    case SIMD_i8x16_ge_s:
+                    case SIMD_i8x16_ge_u:
+                        if (!jit_compile_simd_int_compare(
+                                cc, JIT_V128_I8X16,
+                                INT_EQ + opcode - SIMD_i8x16_eq))
+                            return false;
+                        break;
+
+                    case SIMD_i16x8_eq:
+                    case SIMD_i16x8_ne:
+                    case SIMD_i16x8_lt_s:
+                    case SIMD_i16x8_lt_u:
+                    case SIMD_i16x8_gt_s:
+                    case SIMD_i16x8_gt_u:
+                    case SIMD_i16x8_le_s:
+                    case SIMD_i16x8_le_u:
+                    case SIMD_i16x8_ge_s:
+                    case SIMD_i16x8_ge_u:
+                        if (!jit_compile_simd_int_compare(
+                                cc, JIT_V128_I16X8,
+                                INT_EQ + opcode - SIMD_i16x8_eq))
+                            return false;
+                        break;
+
+                    case SIMD_i32x4_eq:
+                    case SIMD_i32x4_ne:
+                    case SIMD_i32x4_lt_s:
+                    case SIMD_i32x4_lt_u:
+                    case SIMD_i32x4_gt_s:
+                    case SIMD_i32x4_gt_u:
+                    case SIMD_i32x4_le_s:
+                    case SIMD_i32x4_le_u:
+                    case SIMD_i32x4_ge_s:
+                    case SIMD_i32x4_ge_u:
+                        if (!jit_compile_simd_int_compare(
+                                cc, JIT_V128_I32X4,
+                                INT_EQ + opcode - SIMD_i32x4_eq))
+                            return false;
+                        break;
+
+                    case SIMD_i64x2_eq:
+                    case SIMD_i64x2_ne:
+                    case SIMD_i64x2_lt_s:
+                    case SIMD_i64x2_gt_s:
+                    case SIMD_i64x2_le_s:
+                    case SIMD_i64x2_ge_s:
+                    {
+                        IntCond i64x2_conds[] = { INT_EQ,   INT_NE,
+                                                  INT_LT_S, INT_GT_S,
+                                                  INT_LE_S, INT_GE_S };
+
+                        if (!jit_compile_simd_int_compare(
+                                cc, JIT_V128_I64X2,
+                                i64x2_conds[opcode - SIMD_i64x2_eq]))
+                            return false;
+                        break;
+                    }
+
+                    case SIMD_f32x4_eq:
+                    case SIMD_f32x4_ne:
+                    case SIMD_f32x4_lt:
+                    case SIMD_f32x4_gt:
+                    case SIMD_f32x4_le:
+                    case SIMD_f32x4_ge:
+                        if (!jit_compile_simd_float_compare(
+                                cc, JIT_V128_F32X4,
+                                FLOAT_EQ + opcode - SIMD_f32x4_eq))
+                            return false;
+                        break;
+
+                    case SIMD_f64x2_eq:
+                    case SIMD_f64x2_ne:
+                    case SIMD_f64x2_lt:
+                    case SIMD_f64x2_gt:
+                    case SIMD_f64x2_le:
+                    case SIMD_f64x2_ge:
+                        if (!jit_compile_simd_float_compare(
+                                cc, JIT_V128_F64X2,
+                                FLOAT_EQ + opcode - SIMD_f64x2_eq))
+                            return false;
+                        break;
+
+                    case SIMD_v128_not:
+                    case SIMD_v128_and:
+                    case SIMD_v128_andnot:
+                    case SIMD_v128_or:
+                    case SIMD_v128_xor:
+                    case SIMD_v128_bitselect:
+                        if (!jit_compile_simd_v128_bitwise(
+                                cc, V128_NOT + opcode - SIMD_v128_not))
+                            return false;
+                        break;
+
+                    case SIMD_v128_any_true:
+                        if (!jit_compile_simd_v128_any_true(cc))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_all_true:
+                    case SIMD_i16x8_all_true:
+                    case SIMD_i32x4_all_true:
+                    case SIMD_i64x2_all_true:
+                        shape = JIT_V128_I8X16
+                                + (opcode - SIMD_i8x16_all_true) / 0x20;
+                        if (!jit_compile_simd_all_true(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_abs:
+                    case SIMD_i16x8_abs:
+                    case SIMD_i32x4_abs:
+                    case SIMD_i64x2_abs:
+                        shape = JIT_V128_I8X16
+                                + (opcode - SIMD_i8x16_abs) / 0x20;
+                        if (!jit_compile_simd_abs(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_f32x4_abs:
+                    case SIMD_f64x2_abs:
+                        shape = opcode == SIMD_f32x4_abs ? JIT_V128_F32X4
+                                                         : JIT_V128_F64X2;
+                        if (!jit_compile_simd_abs(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_neg:
+                    case SIMD_i16x8_neg:
+                    case SIMD_i32x4_neg:
+                    case SIMD_i64x2_neg:
+                        shape = JIT_V128_I8X16
+                                + (opcode - SIMD_i8x16_neg) / 0x20;
+                        if (!jit_compile_simd_arithmetic(cc, shape, V128_NEG,
+                                                         false))
+                            return false;
+                        break;
+
+                    case SIMD_f32x4_neg:
+                    case SIMD_f64x2_neg:
+                        shape = opcode == SIMD_f32x4_neg ? JIT_V128_F32X4
+                                                         : JIT_V128_F64X2;
+                        if (!jit_compile_simd_arithmetic(cc, shape, V128_NEG,
+                                                         false))
+                            return false;
+                        break;
+
+                    case SIMD_f32x4_sqrt:
+                    case SIMD_f64x2_sqrt:
+                        shape = opcode == SIMD_f32x4_sqrt ? JIT_V128_F32X4
+                                                          : JIT_V128_F64X2;
+                        if (!jit_compile_simd_sqrt(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_add:
+                    case SIMD_i16x8_add:
+                    case SIMD_i32x4_add:
+                    case SIMD_i64x2_add:
+                        shape = JIT_V128_I8X16
+                                + (opcode - SIMD_i8x16_add) / 0x20;
+                        if (!jit_compile_simd_arithmetic(cc, shape, V128_ADD,
+                                                         false))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_sub:
+                    case SIMD_i16x8_sub:
+                    case SIMD_i32x4_sub:
+                    case SIMD_i64x2_sub:
+                        shape = JIT_V128_I8X16
+                                + (opcode - SIMD_i8x16_sub) / 0x20;
+                        if (!jit_compile_simd_arithmetic(cc, shape, V128_SUB,
+                                                         false))
+                            return false;
+                        break;
+
+                    case SIMD_i16x8_mul:
+                    case SIMD_i32x4_mul:
+                        shape = opcode == SIMD_i16x8_mul ? JIT_V128_I16X8
+                                                         : JIT_V128_I32X4;
+                        if (!jit_compile_simd_arithmetic(cc, shape, V128_MUL,
+                                                         false))
+                            return false;
+                        break;
+
+                    case SIMD_f32x4_add:
+                    case SIMD_f32x4_sub:
+                    case SIMD_f32x4_mul:
+                    case SIMD_f32x4_div:
+                        if (!jit_compile_simd_arithmetic(
+                                cc, JIT_V128_F32X4,
+                                V128_ADD + opcode - SIMD_f32x4_add, false))
+                            return false;
+                        break;
+
+                    case SIMD_f64x2_add:
+                    case SIMD_f64x2_sub:
+                    case SIMD_f64x2_mul:
+                    case SIMD_f64x2_div:
+                        if (!jit_compile_simd_arithmetic(
+                                cc, JIT_V128_F64X2,
+                                V128_ADD + opcode - SIMD_f64x2_add, false))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_add_sat_s:
+                    case SIMD_i8x16_add_sat_u:
+                    case SIMD_i16x8_add_sat_s:
+                    case SIMD_i16x8_add_sat_u:
+                        shape = opcode <= SIMD_i8x16_add_sat_u
+                                    ? JIT_V128_I8X16
+                                    : JIT_V128_I16X8;
+                        sign = (opcode == SIMD_i8x16_add_sat_s
+                                || opcode == SIMD_i16x8_add_sat_s);
+                        if (!jit_compile_simd_sat_arithmetic(cc, shape,
+                                                             V128_ADD, sign))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_sub_sat_s:
+                    case SIMD_i8x16_sub_sat_u:
+                    case SIMD_i16x8_sub_sat_s:
+                    case SIMD_i16x8_sub_sat_u:
+                        shape = opcode <= SIMD_i8x16_sub_sat_u
+                                    ? JIT_V128_I8X16
+                                    : JIT_V128_I16X8;
+                        sign = (opcode == SIMD_i8x16_sub_sat_s
+                                || opcode == SIMD_i16x8_sub_sat_s);
+                        if (!jit_compile_simd_sat_arithmetic(cc, shape,
+                                                             V128_SUB, sign))
+                            return false;
+                        break;
+
+                    case SIMD_i8x16_min_s:
+                    case SIMD_i8x16_min_u:
+                    case SIMD_i8x16_max_s:
+                    case SIMD_i8x16_max_u:
+                    case SIMD_i16x8_min_s:
+                    case SIMD_i16x8_min_u:
+                    case SIMD_i16x8_max_s:
+                    case SIMD_i16x8_max_u:
+                    case SIMD_i32x4_min_s:
+                    case SIMD_i32x4_min_u:
+                    case SIMD_i32x4_max_s:
+                    case SIMD_i32x4_max_u:
+                    {
+                        uint8 op_idx;
+
+                        if (opcode <= SIMD_i8x16_max_u) {
+                            shape = JIT_V128_I8X16;
+                            op_idx = opcode - SIMD_i8x16_min_s;
+                        }
+                        else if (opcode <= SIMD_i16x8_max_u) {
+                            shape = JIT_V128_I16X8;
+                            op_idx = opcode - SIMD_i16x8_min_s;
+                        }
+                        else {
+                            shape = JIT_V128_I32X4;
+                            op_idx = opcode - SIMD_i32x4_min_s;
+                        }
+                        /* min_s, min_u, max_s, max_u */
+                        if (!jit_compile_simd_arithmetic(
+                                cc, shape, op_idx < 2 ? V128_MIN : V128_MAX,
+                                (op_idx & 1) == 0))
+                            return false;
+                        break;
+                    }
+
+                    case SIMD_i8x16_avgr_u:
+                    case SIMD_i16x8_avgr_u:
+                        shape = opcode == SIMD_i8x16_avgr_u ? JIT_V128_I8X16
+                                                            : JIT_V128_I16X8;
+                        if (!jit_compile_simd_avgr_u(cc, shape))
+                            return false;
+                        break;
+
+                    case SIMD_i16x8_shl:
+                    case SIMD_i16x8_shr_s:
+                    case SIMD_i16x8_shr_u:
+                        if (!jit_compile_simd_shift(
+                                cc, JIT_V128_I16X8,
+                                INT_SHL + opcode - SIMD_i16x8_shl))
+                            return false;
+                        break;
+
+                    case SIMD_i32x4_shl:
+                    case SIMD_i32x4_shr_s:
+                    case SIMD_i32x4_shr_u:
+                        if (!jit_compile_simd_shift(
+                                cc, JIT_V128_I32X4,
+                                INT_SHL + opcode - SIMD_i32x4_shl))
+                            return false;
+                        break;
+
+                    case SIMD_i64x2_shl:
+                    case SIMD_i64x2_shr_u:
+                        /* There is no 64-bit arithmetic right shift in SSE */
+                        if (!jit_compile_simd_shift(
+                                cc, JIT_V128_I64X2,
+                                opcode == SIMD_i64x2_shl ? INT_SHL
+                                                         : INT_SHR_U))
+                            return false;
+                        break;
+
+                    case SIMD_v128_load8x8_s:
+                    case SIMD_v128_load8x8_u:
+                    case SIMD_v128_load16x4_s:
+                    case SIMD_v128_load16x4_u:
+                    case SIMD_v128_load32x2_s:
+                    case SIMD_v128_load32x2_u:
+                        read_leb_uint32(frame_ip, frame_ip_end, align);
+                        read_leb_uint32(frame_ip, frame_ip_end, offset);
+                        if (!jit_compile_simd_load_extend(cc, opcode, align,
+                                                          offset))
+                            return false;
+                        break;
+
+                    case SIMD_v8x16_shuffle:
+                        if (!jit_compile_simd_native_op(cc, opcode, frame_ip))
+                            return false;
+                        frame_ip += 16;
+                        break;
+
+                    default:
+                        /* The others have no IR instruction and are run by
+                           a native function */
+                        if (!jit_compile_simd_native_op(cc, opcode, NULL))
+                            return false;
+                        break;
+                }
+                break;
+            }
+#endif /* end of WASM_ENABLE_SIMD != 0 */
+
             default:
                 jit_set_last_error(cc, "unsupported opcode");
                 return false;
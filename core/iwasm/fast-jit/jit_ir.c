@@ -493,6 +493,14 @@ jit_cc_destroy(JitCompContext *cc)
         jit_free(cc->incoming_insns_for_exec_bbs);
     }
 
+#if WASM_ENABLE_LAZY_JIT != 0
+    while (cc->loop_entries) {
+        JitLoopEntry *loop_entry = cc->loop_entries;
+        cc->loop_entries = loop_entry->next;
+        jit_free(loop_entry);
+    }
+#endif
+
     /* Release entry and exit blocks.  */
     if (0 != cc->entry_label)
         jit_basic_block_delete(jit_cc_entry_basic_block(cc));
@@ -1308,6 +1316,11 @@ jit_cc_pop_value(JitCompContext *cc, uint8 type, JitReg *p_value)
         case VALUE_TYPE_F64:
             value = pop_f64(cc->jit_frame);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            value = pop_v128(cc->jit_frame);
+            break;
+#endif
         default:
             bh_assert(0);
             break;
@@ -1355,6 +1368,11 @@ jit_cc_push_value(JitCompContext *cc, uint8 type, JitReg value)
         case VALUE_TYPE_F64:
             push_f64(cc->jit_frame, value);
             break;
+#if WASM_ENABLE_SIMD != 0
+        case VALUE_TYPE_V128:
+            push_v128(cc->jit_frame, value);
+            break;
+#endif
     }
 
     return true;
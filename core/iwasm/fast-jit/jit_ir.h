@@ -118,6 +118,37 @@ typedef enum JitRegKind {
     JIT_REG_KIND_NUM          /* number of register kinds */
 } JitRegKind;
 
+#if WASM_ENABLE_SIMD != 0
+/**
+ * Lane shapes of the 128-bit SIMD instructions, passed to them as an
+ * I32 constant operand.
+ */
+typedef enum JitV128Shape {
+    JIT_V128_I8X16 = 0,
+    JIT_V128_I16X8,
+    JIT_V128_I32X4,
+    JIT_V128_I64X2,
+    JIT_V128_F32X4,
+    JIT_V128_F64X2,
+} JitV128Shape;
+
+/**
+ * Conditions of the V128CMP instruction.
+ */
+typedef enum JitV128Cond {
+    JIT_V128_CMP_EQ = 0,
+    JIT_V128_CMP_NE,
+    JIT_V128_CMP_LTS,
+    JIT_V128_CMP_LTU,
+    JIT_V128_CMP_GTS,
+    JIT_V128_CMP_GTU,
+    JIT_V128_CMP_LES,
+    JIT_V128_CMP_LEU,
+    JIT_V128_CMP_GES,
+    JIT_V128_CMP_GEU,
+} JitV128Cond;
+#endif
+
 #if UINTPTR_MAX == UINT64_MAX
 #define JIT_REG_KIND_PTR JIT_REG_KIND_I64
 #else
@@ -942,6 +973,14 @@ typedef struct JitIncomingInsn {
     uint32 opnd_idx;
 } JitIncomingInsn, *JitIncomingInsnList;
 
+#if WASM_ENABLE_LAZY_JIT != 0
+typedef struct JitLoopEntry {
+    struct JitLoopEntry *next;
+    /* The label of the basic block of the loop body */
+    JitReg label;
+} JitLoopEntry;
+#endif
+
 typedef struct JitBlock {
     struct JitBlock *next;
     struct JitBlock *prev;
@@ -1059,6 +1098,11 @@ typedef struct JitCompContext {
     /* The spill cache size */
     uint32 spill_cache_size;
 
+    /* Number of the spill and reload instructions inserted by the pass
+       regalloc, which are reported by the pass dump. */
+    uint32 spill_insn_num;
+    uint32 reload_insn_num;
+
     /* The offset of jitted_return_address in the frame, which is set by
        the pass frontend and used by the pass codegen. */
     uint32 jitted_return_address_offset;
@@ -1069,6 +1113,12 @@ typedef struct JitCompContext {
     void *jitted_addr_begin;
     void *jitted_addr_end;
 
+#if WASM_ENABLE_LAZY_JIT != 0
+    /* Loop bodies recorded by the pass frontend, whose jitted code can
+       be entered by the interpreter with on-stack replacement */
+    JitLoopEntry *loop_entries;
+#endif
+
     char last_error[128];
 
     /* Below fields are all private.  Don't access them directly. */
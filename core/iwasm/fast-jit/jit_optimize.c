@@ -0,0 +1,975 @@
+/*
+ * Copyright (C) 2021 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "jit_utils.h"
+#include "jit_compiler.h"
+
+/**
+ * The IR generated by the frontend is not in global SSA form: the
+ * values of locals and operand stack slots are committed to the
+ * interpreter frame at the end of each basic block and re-loaded at
+ * the beginning of the next one, and some registers (e.g. the cached
+ * memory and table information) are defined several times. So the
+ * passes below only work on the "local SSA" registers, i.e. virtual
+ * registers that are defined exactly once and referred to in one
+ * basic block only, which covers nearly all of the temporary values
+ * created when translating wasm opcodes.
+ */
+
+/* The block field of a register referred to in more than one block. */
+#define REG_IN_MULTI_BLOCKS ((uint32)-1)
+
+typedef struct RegInfo {
+    /* Number of the instructions defining the register.  */
+    uint32 def_num;
+
+    /* Number of the uses of the register.  */
+    uint32 use_num;
+
+    /* Label no of the block referring to the register plus one, 0 if
+       not referred to yet, REG_IN_MULTI_BLOCKS if referred to in more
+       than one block or used before being defined.  */
+    uint32 block;
+
+    /* The register replacing this register, 0 if none.  */
+    JitReg subst;
+} RegInfo;
+
+typedef struct OptContext {
+    JitCompContext *cc;
+
+    /* Register information of each kind.  */
+    RegInfo *regs[JIT_REG_KIND_L32];
+
+    /* Number of the registers of each kind.  */
+    uint32 reg_num[JIT_REG_KIND_L32];
+} OptContext;
+
+static RegInfo *
+get_reg_info(OptContext *ctx, JitReg reg)
+{
+    unsigned kind = jit_reg_kind(reg);
+    unsigned no = jit_reg_no(reg);
+
+    if (!jit_reg_is_variable(reg) || kind >= JIT_REG_KIND_L32
+        || no >= ctx->reg_num[kind])
+        return NULL;
+
+    return &ctx->regs[kind][no];
+}
+
+static void
+record_reg_ref(RegInfo *info, uint32 block, bool is_def)
+{
+    if (info->block == 0)
+        info->block = block;
+    else if (info->block != block)
+        info->block = REG_IN_MULTI_BLOCKS;
+
+    if (is_def)
+        info->def_num++;
+    else {
+        if (info->def_num == 0)
+            /* Used before defined in this block, the value must come
+               from another block or from a previous iteration.  */
+            info->block = REG_IN_MULTI_BLOCKS;
+        info->use_num++;
+    }
+}
+
+static bool
+has_reg_opnds(JitInsn *insn)
+{
+#if WASM_ENABLE_SHARED_MEMORY != 0
+    /* fence insn doesn't have any operand, hence, no regs involved */
+    if (insn->opcode == JIT_OP_FENCE)
+        return false;
+#endif
+    return true;
+}
+
+/**
+ * Collect the def/use information of all registers and record the
+ * defining instructions in the def_insn annotation.
+ */
+static bool
+opt_ctx_init(OptContext *ctx, JitCompContext *cc)
+{
+    JitBasicBlock *block;
+    JitInsn *insn;
+    JitRegVec regvec;
+    JitReg *regp;
+    RegInfo *info;
+    unsigned label_index, end_label_index, kind, first_use, i;
+    uint64 size;
+
+    memset(ctx, 0, sizeof(OptContext));
+    ctx->cc = cc;
+
+    for (kind = 0; kind < JIT_REG_KIND_L32; kind++) {
+        ctx->reg_num[kind] = jit_cc_reg_num(cc, kind);
+        size = (uint64)sizeof(RegInfo) * ctx->reg_num[kind];
+        if (size == 0)
+            continue;
+        if (size > UINT32_MAX
+            || !(ctx->regs[kind] = jit_calloc((uint32)size))) {
+            jit_set_last_error(cc, "allocate memory failed");
+            return false;
+        }
+    }
+
+    if (!jit_annr_is_enabled_def_insn(cc) && !jit_annr_enable_def_insn(cc)) {
+        jit_set_last_error(cc, "enable def_insn annotation failed");
+        return false;
+    }
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        JIT_FOREACH_INSN(block, insn)
+        {
+            if (!has_reg_opnds(insn))
+                continue;
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            {
+                if ((info = get_reg_info(ctx, *regp)))
+                    record_reg_ref(info, label_index + 1, false);
+            }
+
+            JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+            {
+                if ((info = get_reg_info(ctx, *regp))) {
+                    record_reg_ref(info, label_index + 1, true);
+                    *(jit_annr_def_insn(cc, *regp)) = insn;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static void
+opt_ctx_destroy(OptContext *ctx)
+{
+    unsigned kind;
+
+    for (kind = 0; kind < JIT_REG_KIND_L32; kind++)
+        if (ctx->regs[kind])
+            jit_free(ctx->regs[kind]);
+}
+
+/**
+ * Whether the register is a virtual register defined exactly once
+ * and referred to in one basic block only, so that its value never
+ * changes after the definition.
+ */
+static bool
+is_local_ssa_reg(OptContext *ctx, JitReg reg)
+{
+    RegInfo *info = get_reg_info(ctx, reg);
+
+    return info && !jit_cc_is_hreg(ctx->cc, reg) && info->def_num == 1
+           && info->block != REG_IN_MULTI_BLOCKS;
+}
+
+static JitInsn *
+get_def_insn(OptContext *ctx, JitReg reg)
+{
+    return is_local_ssa_reg(ctx, reg) ? *(jit_annr_def_insn(ctx->cc, reg))
+                                      : NULL;
+}
+
+static void
+replace_use(OptContext *ctx, JitReg *regp, JitReg new_reg)
+{
+    RegInfo *info;
+
+    if ((info = get_reg_info(ctx, *regp)))
+        info->use_num--;
+    if ((info = get_reg_info(ctx, new_reg)))
+        info->use_num++;
+    *regp = new_reg;
+}
+
+/**
+ * Unlink and delete an instruction, and update the def/use counts of
+ * its operands.
+ */
+static void
+remove_insn(OptContext *ctx, JitInsn *insn)
+{
+    JitRegVec regvec = jit_insn_opnd_regs(insn);
+    unsigned first_use = jit_insn_opnd_first_use(insn), i;
+    JitReg *regp;
+    RegInfo *info;
+
+    JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+    {
+        if ((info = get_reg_info(ctx, *regp)))
+            info->use_num--;
+    }
+
+    JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+    {
+        if ((info = get_reg_info(ctx, *regp)))
+            info->def_num--;
+    }
+
+    jit_insn_unlink(insn);
+    jit_insn_delete(insn);
+}
+
+/**
+ * Replace an instruction with the given new one, which defines the
+ * same register.
+ */
+static void
+replace_insn(OptContext *ctx, JitInsn *insn, JitInsn *new_insn)
+{
+    JitReg dst = *(jit_insn_opnd(new_insn, 0));
+    RegInfo *info;
+
+    jit_insn_insert_before(insn, new_insn);
+    remove_insn(ctx, insn);
+
+    if ((info = get_reg_info(ctx, dst))) {
+        info->def_num++;
+        *(jit_annr_def_insn(ctx->cc, dst)) = new_insn;
+    }
+}
+
+static bool
+is_int_const(JitCompContext *cc, JitReg reg)
+{
+    if (jit_reg_is_kind(I32, reg))
+        return jit_reg_is_const(reg) && !jit_cc_get_const_I32_rel(cc, reg);
+
+    return jit_reg_is_kind(I64, reg) && jit_reg_is_const(reg);
+}
+
+static int64
+get_int_const(JitCompContext *cc, JitReg reg)
+{
+    return jit_reg_is_kind(I32, reg) ? jit_cc_get_const_I32(cc, reg)
+                                     : jit_cc_get_const_I64(cc, reg);
+}
+
+/**
+ * Whether the operand of the instruction can be a constant, which
+ * depends on what the codegen supports.
+ */
+static bool
+is_const_allowed(JitInsn *insn, unsigned opnd_idx)
+{
+    switch (insn->opcode) {
+        case JIT_OP_MOV:
+            return opnd_idx == 1;
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_AND:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_CMP:
+            return opnd_idx == 1 || opnd_idx == 2;
+        default:
+            return false;
+    }
+}
+
+static bool
+is_binary_foldable(uint16 opcode)
+{
+    switch (opcode) {
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_AND:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool
+is_unary_foldable(uint16 opcode)
+{
+    switch (opcode) {
+        case JIT_OP_NEG:
+        case JIT_OP_NOT:
+        case JIT_OP_I32TOI64:
+        case JIT_OP_U32TOI64:
+        case JIT_OP_I64TOI32:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static uint64
+fold_int_binary(uint16 opcode, uint64 a, uint64 b, bool is_i64)
+{
+    uint32 shift_mask = is_i64 ? 63 : 31;
+
+    if (!is_i64) {
+        a = (uint32)a;
+        b = (uint32)b;
+    }
+
+    switch (opcode) {
+        case JIT_OP_ADD:
+            return a + b;
+        case JIT_OP_SUB:
+            return a - b;
+        case JIT_OP_MUL:
+            return a * b;
+        case JIT_OP_AND:
+            return a & b;
+        case JIT_OP_OR:
+            return a | b;
+        case JIT_OP_XOR:
+            return a ^ b;
+        case JIT_OP_SHL:
+            return a << (b & shift_mask);
+        case JIT_OP_SHRS:
+            return is_i64 ? (uint64)((int64)a >> (b & shift_mask))
+                          : (uint64)(uint32)((int32)a >> (b & shift_mask));
+        case JIT_OP_SHRU:
+            return a >> (b & shift_mask);
+        default:
+            bh_assert(0);
+            return 0;
+    }
+}
+
+/**
+ * Fold an instruction whose operands are all constants into a MOV
+ * instruction.
+ *
+ * @return the instruction to continue the iteration with, NULL if
+ * failed
+ */
+static JitInsn *
+fold_insn(OptContext *ctx, JitInsn *insn)
+{
+    JitCompContext *cc = ctx->cc;
+    JitReg dst, r1, r2, c;
+    JitInsn *mov;
+    uint16 opcode = insn->opcode;
+    uint64 val;
+
+    if (is_binary_foldable(opcode)) {
+        dst = *(jit_insn_opnd(insn, 0));
+        r1 = *(jit_insn_opnd(insn, 1));
+        r2 = *(jit_insn_opnd(insn, 2));
+        if (!is_int_const(cc, r1) || !is_int_const(cc, r2)
+            || jit_reg_kind(dst) != jit_reg_kind(r1))
+            return insn;
+        val = fold_int_binary(opcode, (uint64)get_int_const(cc, r1),
+                              (uint64)get_int_const(cc, r2),
+                              jit_reg_is_kind(I64, dst));
+    }
+    else if (is_unary_foldable(opcode)) {
+        dst = *(jit_insn_opnd(insn, 0));
+        r1 = *(jit_insn_opnd(insn, 1));
+        if (!is_int_const(cc, r1))
+            return insn;
+        val = (uint64)get_int_const(cc, r1);
+        switch (opcode) {
+            case JIT_OP_NEG:
+                val = (uint64)0 - val;
+                break;
+            case JIT_OP_NOT:
+                val = ~val;
+                break;
+            case JIT_OP_U32TOI64:
+                val = (uint32)val;
+                break;
+            default:
+                /* I32TOI64 is done by get_int_const, and I64TOI32 is
+                   done when creating the I32 constant.  */
+                break;
+        }
+    }
+    else
+        return insn;
+
+    if (jit_reg_is_kind(I32, dst))
+        c = jit_cc_new_const_I32(cc, (int32)(uint32)val);
+    else if (jit_reg_is_kind(I64, dst))
+        c = jit_cc_new_const_I64(cc, (int64)val);
+    else
+        return insn;
+
+    if (!c || !(mov = jit_cc_new_insn(cc, MOV, dst, c))) {
+        jit_set_last_error(cc, "create folded insn failed");
+        return NULL;
+    }
+
+    replace_insn(ctx, insn, mov);
+    return mov;
+}
+
+bool
+jit_pass_const_prop(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn, *def_insn;
+    JitRegVec regvec;
+    JitReg *regp, src;
+    unsigned label_index, end_label_index, first_use, i;
+    bool ret = false;
+
+    if (!opt_ctx_init(&ctx, cc))
+        goto fail;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        JIT_FOREACH_INSN(block, insn)
+        {
+            if (!has_reg_opnds(insn))
+                continue;
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            {
+                if (!is_const_allowed(insn, i)
+                    || !(def_insn = get_def_insn(&ctx, *regp))
+                    || def_insn->opcode != JIT_OP_MOV)
+                    continue;
+
+                src = *(jit_insn_opnd(def_insn, 1));
+                if (is_int_const(cc, src))
+                    replace_use(&ctx, regp, src);
+            }
+
+            if (!(insn = fold_insn(&ctx, insn)))
+                goto fail;
+        }
+    }
+
+    ret = true;
+
+fail:
+    opt_ctx_destroy(&ctx);
+    return ret;
+}
+
+bool
+jit_pass_copy_prop(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn, *def_insn;
+    JitRegVec regvec;
+    JitReg *regp, src;
+    unsigned label_index, end_label_index, first_use, i;
+
+    if (!opt_ctx_init(&ctx, cc)) {
+        opt_ctx_destroy(&ctx);
+        return false;
+    }
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        JIT_FOREACH_INSN(block, insn)
+        {
+            if (!has_reg_opnds(insn))
+                continue;
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            {
+                /* The source of a local SSA copy is defined in the same
+                   block before the copy and never changes, so the uses
+                   of the copy can be replaced with it.  */
+                while ((def_insn = get_def_insn(&ctx, *regp))
+                       && def_insn->opcode == JIT_OP_MOV) {
+                    src = *(jit_insn_opnd(def_insn, 1));
+                    if (jit_reg_kind(src) != jit_reg_kind(*regp)
+                        || !is_local_ssa_reg(&ctx, src))
+                        break;
+                    replace_use(&ctx, regp, src);
+                }
+            }
+        }
+    }
+
+    opt_ctx_destroy(&ctx);
+    return true;
+}
+
+/**
+ * Whether the instruction computes its result from the operands only,
+ * without side effects or traps.
+ */
+static bool
+is_pure_insn(JitInsn *insn)
+{
+    uint16 opcode = insn->opcode;
+
+    if (opcode >= JIT_OP_I8TOI32 && opcode <= JIT_OP_F64CASTI64)
+        return true;
+
+    switch (opcode) {
+        case JIT_OP_NEG:
+        case JIT_OP_NOT:
+        case JIT_OP_ADD:
+        case JIT_OP_SUB:
+        case JIT_OP_MUL:
+        case JIT_OP_SHL:
+        case JIT_OP_SHRS:
+        case JIT_OP_SHRU:
+        case JIT_OP_ROTL:
+        case JIT_OP_ROTR:
+        case JIT_OP_OR:
+        case JIT_OP_XOR:
+        case JIT_OP_AND:
+        case JIT_OP_MAX:
+        case JIT_OP_MIN:
+        case JIT_OP_CLZ:
+        case JIT_OP_CTZ:
+        case JIT_OP_POPCNT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool
+is_cse_candidate(OptContext *ctx, JitInsn *insn)
+{
+    JitRegVec regvec;
+    JitReg *regp;
+    unsigned first_use, i;
+
+    if (!is_pure_insn(insn)
+        || !is_local_ssa_reg(ctx, *(jit_insn_opnd(insn, 0))))
+        return false;
+
+    regvec = jit_insn_opnd_regs(insn);
+    first_use = jit_insn_opnd_first_use(insn);
+
+    JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+    {
+        if (!jit_reg_is_const(*regp) && !is_local_ssa_reg(ctx, *regp))
+            return false;
+    }
+
+    return true;
+}
+
+bool
+jit_pass_cse(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn, **table = NULL;
+    JitRegVec regvec;
+    JitReg *regp, dst;
+    RegInfo *info;
+    unsigned label_index, end_label_index, first_use, i;
+    uint32 insn_num, table_size = 0, mask, idx;
+    bool ret = false;
+
+    if (!opt_ctx_init(&ctx, cc))
+        goto fail;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        insn_num = 0;
+        JIT_FOREACH_INSN(block, insn)
+        {
+            insn_num++;
+        }
+
+        /* Open addressing hash table of the candidates in the block,
+           whose size is at least twice of the instruction number.  */
+        if (table_size < insn_num * 2 || !table) {
+            if (table)
+                jit_free(table);
+            for (table_size = 16; table_size < insn_num * 2; table_size <<= 1)
+                ;
+            if (!(table = jit_calloc(sizeof(JitInsn *) * table_size))) {
+                jit_set_last_error(cc, "allocate memory failed");
+                goto fail;
+            }
+        }
+        else
+            memset(table, 0, sizeof(JitInsn *) * table_size);
+        mask = table_size - 1;
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            if (!has_reg_opnds(insn))
+                continue;
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            {
+                if ((info = get_reg_info(&ctx, *regp)) && info->subst)
+                    replace_use(&ctx, regp, info->subst);
+            }
+
+            if (!is_cse_candidate(&ctx, insn))
+                continue;
+
+            for (idx = jit_insn_hash(insn) & mask; table[idx];
+                 idx = (idx + 1) & mask) {
+                if (jit_insn_equal(table[idx], insn))
+                    break;
+            }
+
+            if (!table[idx]) {
+                table[idx] = insn;
+                continue;
+            }
+
+            /* The same value has been computed by an earlier instruction
+               in the block, reuse its result.  */
+            dst = *(jit_insn_opnd(insn, 0));
+            get_reg_info(&ctx, dst)->subst = *(jit_insn_opnd(table[idx], 0));
+            insn = insn->prev;
+            remove_insn(&ctx, insn->next);
+        }
+    }
+
+    ret = true;
+
+fail:
+    if (table)
+        jit_free(table);
+    opt_ctx_destroy(&ctx);
+    return ret;
+}
+
+#if UINTPTR_MAX == UINT64_MAX && !defined(OS_ENABLE_HW_BOUND_CHECK)
+
+/* Max number of the addresses tracked in a block.  */
+#define BOUNDS_CHECK_FACT_NUM 16
+
+/**
+ * The fact that (uint64)addr + end <= memory size holds, where addr is
+ * the wasm address register, until it is redefined.
+ */
+typedef struct BoundsCheckFact {
+    JitReg addr;
+    uint64 end;
+} BoundsCheckFact;
+
+static uint32
+get_bound_check_bytes(JitCompContext *cc, JitReg reg)
+{
+    JitMemRegs *mem_regs = cc->memory_regs;
+
+    if (reg == mem_regs->mem_bound_check_1byte)
+        return 1;
+    if (reg == mem_regs->mem_bound_check_2bytes)
+        return 2;
+    if (reg == mem_regs->mem_bound_check_4bytes)
+        return 4;
+    if (reg == mem_regs->mem_bound_check_8bytes)
+        return 8;
+    if (reg == mem_regs->mem_bound_check_16bytes)
+        return 16;
+    return 0;
+}
+
+static bool
+is_exception_branch(JitCompContext *cc, JitInsn *insn, uint16 opcode)
+{
+    return insn->opcode == opcode && *(jit_insn_opnd(insn, 0)) == cc->cmp_reg
+           && *(jit_insn_opnd(insn, 2)) == 0;
+}
+
+static bool
+insn_defines_reg(JitInsn *insn, JitReg reg)
+{
+    JitRegVec regvec;
+    JitReg *regp;
+    unsigned first_use, i;
+
+    if (!has_reg_opnds(insn))
+        return false;
+
+    regvec = jit_insn_opnd_regs(insn);
+    first_use = jit_insn_opnd_first_use(insn);
+    JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+    {
+        if (*regp == reg)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Match the boundary check generated by check_and_seek:
+ *
+ *   U32TOI64 addr, wasm_addr
+ *   ADD      offset1, offset, addr
+ *   CMP      cmp_reg, offset1, mem_bound_check_Nbytes
+ *   BGTU     cmp_reg, exception_label, 0
+ *
+ * and return the wasm address register and offset + N. The wasm address
+ * may be the register of a local, which is defined more than once, so
+ * it must not be redefined between the extension and the check.
+ */
+static bool
+match_bounds_check(OptContext *ctx, JitInsn *cmp, JitReg *p_addr,
+                   uint64 *p_end)
+{
+    JitCompContext *cc = ctx->cc;
+    JitInsn *add, *ext, *insn;
+    JitReg r1, r2, wasm_addr;
+    uint32 bytes;
+
+    if (cmp->opcode != JIT_OP_CMP || *(jit_insn_opnd(cmp, 0)) != cc->cmp_reg
+        || !(bytes = get_bound_check_bytes(cc, *(jit_insn_opnd(cmp, 2))))
+        || !is_exception_branch(cc, cmp->next, JIT_OP_BGTU)
+        || !(add = get_def_insn(ctx, *(jit_insn_opnd(cmp, 1))))
+        || add->opcode != JIT_OP_ADD)
+        return false;
+
+    r1 = *(jit_insn_opnd(add, 1));
+    r2 = *(jit_insn_opnd(add, 2));
+    if (jit_reg_is_const(r2)) {
+        JitReg t = r1;
+        r1 = r2;
+        r2 = t;
+    }
+
+    if (!jit_reg_is_kind(I64, r1) || !jit_reg_is_const(r1)
+        || !(ext = get_def_insn(ctx, r2)) || ext->opcode != JIT_OP_U32TOI64)
+        return false;
+
+    wasm_addr = *(jit_insn_opnd(ext, 1));
+    if (!jit_reg_is_variable(wasm_addr) || jit_cc_is_hreg(cc, wasm_addr))
+        return false;
+
+    /* ext defines a local SSA register used by add, so they are in the
+       block of cmp and precede it */
+    for (insn = ext->next; insn != cmp; insn = insn->next)
+        if (insn_defines_reg(insn, wasm_addr))
+            return false;
+
+    *p_addr = wasm_addr;
+    /* The offset is an unsigned 32-bit immediate */
+    *p_end = (uint64)jit_cc_get_const_I64(cc, r1) + bytes;
+    return true;
+}
+
+static bool
+is_page_count_check(JitCompContext *cc, JitInsn *cmp)
+{
+    JitReg r2 = *(jit_insn_opnd(cmp, 2));
+
+    return cmp->opcode == JIT_OP_CMP && *(jit_insn_opnd(cmp, 0)) == cc->cmp_reg
+           && *(jit_insn_opnd(cmp, 1)) == cc->memory_regs->cur_page_count
+           && jit_reg_is_kind(I32, r2) && jit_reg_is_const(r2)
+           && jit_cc_get_const_I32(cc, r2) == 0
+           && is_exception_branch(cc, cmp->next, JIT_OP_BEQ);
+}
+
+#endif /* end of UINTPTR_MAX == UINT64_MAX */
+
+bool
+jit_pass_bounds_check_elim(JitCompContext *cc)
+{
+#if UINTPTR_MAX == UINT64_MAX && !defined(OS_ENABLE_HW_BOUND_CHECK)
+    OptContext ctx;
+    BoundsCheckFact facts[BOUNDS_CHECK_FACT_NUM];
+    JitBasicBlock *block;
+    JitInsn *insn;
+    JitReg addr;
+    unsigned label_index, end_label_index, i;
+    uint32 fact_num, next_fact;
+    uint64 end;
+    bool page_count_checked;
+
+    /* Only the default memory is accessed by the frontend.  */
+    if (!cc->memory_regs)
+        return true;
+
+    if (!opt_ctx_init(&ctx, cc)) {
+        opt_ctx_destroy(&ctx);
+        return false;
+    }
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        fact_num = next_fact = 0;
+        page_count_checked = false;
+
+        JIT_FOREACH_INSN(block, insn)
+        {
+            /* A fact doesn't hold for the new value of a redefined
+               address register, e.g. the register of a local set by
+               local.set */
+            for (i = 0; i < fact_num;) {
+                if (insn_defines_reg(insn, facts[i].addr)) {
+                    facts[i] = facts[--fact_num];
+                    next_fact = 0;
+                }
+                else
+                    i++;
+            }
+
+            if (insn->opcode != JIT_OP_CMP)
+                continue;
+
+            /* The memory never shrinks, so once a check passed, the
+               same or a narrower check on the same address always
+               passes later in the block, even if the memory grows or
+               the bound registers are re-loaded.  */
+            if (is_page_count_check(cc, insn)) {
+                if (page_count_checked) {
+                    insn = insn->prev;
+                    remove_insn(&ctx, insn->next->next);
+                    remove_insn(&ctx, insn->next);
+                }
+                page_count_checked = true;
+                continue;
+            }
+
+            if (!match_bounds_check(&ctx, insn, &addr, &end))
+                continue;
+
+            for (i = 0; i < fact_num; i++)
+                if (facts[i].addr == addr)
+                    break;
+
+            if (i < fact_num && end <= facts[i].end) {
+                insn = insn->prev;
+                remove_insn(&ctx, insn->next->next);
+                remove_insn(&ctx, insn->next);
+                continue;
+            }
+
+            if (i == fact_num) {
+                if (fact_num < BOUNDS_CHECK_FACT_NUM)
+                    i = fact_num++;
+                else {
+                    i = next_fact;
+                    next_fact = (next_fact + 1) % BOUNDS_CHECK_FACT_NUM;
+                }
+                facts[i].addr = addr;
+            }
+            facts[i].end = end;
+        }
+    }
+
+    opt_ctx_destroy(&ctx);
+#endif
+    (void)cc;
+    return true;
+}
+
+/**
+ * Whether the instruction can be removed if its results are unused.
+ */
+static bool
+is_removable_insn(JitCompContext *cc, JitInsn *insn)
+{
+    uint16 opcode = insn->opcode;
+    JitReg base;
+    unsigned i;
+
+    if (is_pure_insn(insn) || opcode == JIT_OP_MOV || opcode == JIT_OP_LDPTR
+        || opcode == JIT_OP_LDJITINFO)
+        return true;
+
+    if (opcode < JIT_OP_LDI8 || opcode > JIT_OP_LDV256
+        /* Atomic loads have side effects */
+        || (insn->flags_u8 & 0x1))
+        return false;
+
+    /* Loads of the linear memory may trap with hardware boundary
+       check, keep them.  */
+    base = *(jit_insn_opnd(insn, 1));
+    if (cc->memory_regs) {
+        for (i = 0; i < cc->cur_wasm_module->import_memory_count
+                            + cc->cur_wasm_module->memory_count;
+             i++)
+            if (base == cc->memory_regs[i].memory_data)
+                return false;
+    }
+
+    return true;
+}
+
+static bool
+is_dead_insn(OptContext *ctx, JitInsn *insn)
+{
+    JitRegVec regvec;
+    JitReg *regp;
+    RegInfo *info;
+    unsigned first_use, i;
+
+    if (!has_reg_opnds(insn) || !is_removable_insn(ctx->cc, insn))
+        return false;
+
+    regvec = jit_insn_opnd_regs(insn);
+    first_use = jit_insn_opnd_first_use(insn);
+
+    JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+    {
+        if (!(info = get_reg_info(ctx, *regp))
+            || jit_cc_is_hreg(ctx->cc, *regp) || info->use_num > 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool
+jit_pass_dce(JitCompContext *cc)
+{
+    OptContext ctx;
+    JitBasicBlock *block;
+    JitInsn *insn;
+    unsigned label_index;
+    bool changed = true;
+
+    if (!opt_ctx_init(&ctx, cc)) {
+        opt_ctx_destroy(&ctx);
+        return false;
+    }
+
+    /* Visiting the instructions backward removes the chains in a
+       block at once, iterate until no chain across blocks remains.  */
+    while (changed) {
+        changed = false;
+        JIT_FOREACH_BLOCK_REVERSE_ENTRY_EXIT(cc, label_index, block)
+        {
+            JIT_FOREACH_INSN_REVERSE(block, insn)
+            {
+                if (is_dead_insn(&ctx, insn)) {
+                    insn = insn->next;
+                    remove_insn(&ctx, insn->prev);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    opt_ctx_destroy(&ctx);
+    return true;
+}
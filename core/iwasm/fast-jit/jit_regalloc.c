@@ -101,6 +101,10 @@ typedef struct VirtualReg {
     /* Distances from the beginning of basic block of all occurrences of the
        virtual register in the basic block.  */
     UintStack *distances;
+
+    /* Whether the virtual register is live across basic blocks, which is
+       only set by the linear scan allocator.  */
+    bool live_across_blocks;
 } VirtualReg;
 
 /**
@@ -139,6 +143,10 @@ typedef struct RegallocContext {
 
     /* The last define-released hard register.  */
     JitReg last_def_released_hreg;
+
+    /* Number of the spill and reload instructions inserted.  */
+    uint32 spill_insn_num;
+    uint32 reload_insn_num;
 } RegallocContext;
 
 /**
@@ -271,6 +279,22 @@ found:
     return jit_cc_new_const_I32(rc->cc, i);
 }
 
+/**
+ * Check whether the spill slot of the virtual register is kept during
+ * the whole function.  It's true for the registers live across basic
+ * blocks that aren't allocated a global hard register, whose values
+ * are passed between blocks through the spill slots.
+ *
+ * @param vr the VirtualReg structure of the virtual register
+ *
+ * @return true if the spill slot is kept
+ */
+static bool
+is_slot_kept(const VirtualReg *vr)
+{
+    return vr->live_across_blocks && !vr->global_hreg;
+}
+
 /**
  * Free a spill slot.
  *
@@ -388,7 +412,8 @@ check_vreg_definition(RegallocContext *rc, JitInsn *insn)
             continue;
 
         vr = rc_get_vr(rc, *regp);
-        bh_assert(vr->distances);
+        /* registers live across blocks may be defined in other blocks */
+        bh_assert(vr->distances || vr->live_across_blocks);
     }
 }
 #endif
@@ -512,8 +537,10 @@ reload_vreg(RegallocContext *rc, JitReg vreg, JitInsn *cur_insn)
         }
     }
 
-    if (insn)
+    if (insn) {
         jit_insn_insert_after(cur_insn, insn);
+        rc->reload_insn_num++;
+    }
 
     bh_assert(hr->vreg == vreg);
     hr->vreg = vr->hreg = 0;
@@ -571,8 +598,10 @@ spill_vreg(RegallocContext *rc, JitReg vreg, JitInsn *cur_insn)
             return NULL;
     }
 
-    if (insn)
+    if (insn) {
         jit_insn_insert_after(cur_insn, insn);
+        rc->spill_insn_num++;
+    }
 
     return insn;
 }
@@ -775,9 +804,12 @@ allocate_for_basic_block(RegallocContext *rc, JitBasicBlock *basic_block,
             /* Record the define-released hard register.  */
             rc->last_def_released_hreg = vr->hreg;
             /* Release the hreg and spill slot. */
-            rc_free_spill_slot(rc, vr->slot);
+            if (!is_slot_kept(vr)) {
+                rc_free_spill_slot(rc, vr->slot);
+                vr->slot = 0;
+            }
             (rc_get_hr(rc, vr->hreg))->vreg = 0;
-            vr->hreg = vr->slot = 0;
+            vr->hreg = 0;
         }
 
         if (insn->opcode == JIT_OP_CALLBC) {
@@ -793,6 +825,15 @@ allocate_for_basic_block(RegallocContext *rc, JitBasicBlock *basic_block,
                 return false;
         }
 
+        /* Allocate the uses with global hard registers first so that
+           they don't reload the other uses of the same instruction.  */
+        JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+        if (is_alloc_candidate(rc->cc, *regp)
+            && (rc_get_vr(rc, *regp))->global_hreg) {
+            if (!allocate_for_vreg(rc, *regp, insn, distance))
+                return false;
+        }
+
         JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
         if (is_alloc_candidate(rc->cc, *regp)) {
             if (!allocate_for_vreg(rc, *regp, insn, distance))
@@ -853,9 +894,820 @@ jit_pass_regalloc(JitCompContext *cc)
         /* TODO: generate necessary spills for live-in registers.  */
     }
 
+    cc->spill_insn_num = rc.spill_insn_num;
+    cc->reload_insn_num = rc.reload_insn_num;
+    retval = true;
+
+cleanup_and_return:
+    rc_destroy(&rc);
+
+    return retval;
+}
+
+/**
+ * Live interval of a virtual register, which covers all positions in
+ * the linear order of the instructions where the register is live.  The
+ * use and def positions of the n-th instruction are 2n and 2n + 1.
+ */
+typedef struct LiveInterval {
+    /* The virtual register.  */
+    JitReg vreg;
+
+    /* The first and last positions, end is 0 if the register doesn't
+       occur in the function.  */
+    uint32 start;
+    uint32 end;
+
+    /* The hard register allocated to the interval.  */
+    JitReg hreg;
+} LiveInterval;
+
+typedef struct LinearScanContext {
+    /* The regalloc context.  */
+    RegallocContext *rc;
+
+    /* Index of the first register of each kind in below arrays.  */
+    uint32 kind_base[JIT_REG_KIND_L32];
+
+    /* Total number of registers of all kinds.  */
+    uint32 reg_num;
+
+    /* Live intervals of the registers.  */
+    LiveInterval *intervals;
+
+    /* Label index plus 1 of the basic block in which each register
+       first occurs.  */
+    uint32 *first_block;
+
+    /* Index of each register in the live sets, -1 if the register is
+       local to a basic block.  */
+    int32 *set_index;
+
+    /* Registers of the live set members.  */
+    JitReg *set_regs;
+
+    /* Number of the members and words of each live set.  */
+    uint32 set_num;
+    uint32 set_words;
+
+    /* Live sets of each basic block, indexed by label.  */
+    uint32 *live_in;
+    uint32 *live_out;
+    uint32 *use;
+    uint32 *def;
+
+    /* The first and last positions of each basic block.  */
+    uint32 *block_start;
+    uint32 *block_end;
+
+    /* Positions of the CALLNATIVE and CALLBC instructions.  */
+    UintStack *native_calls;
+    UintStack *jitted_calls;
+
+    /* Pairs of the first and last positions of each hard register used
+       directly in a basic block, e.g. the result register of native
+       calls, which can't be allocated to others in the range.  */
+    UintStack **hreg_ranges[JIT_REG_KIND_L32];
+} LinearScanContext;
+
+#define LIVE_SET(lsc, sets, label) ((lsc)->sets + (label) * (lsc)->set_words)
+
+#define LIVE_SET_HAS(set, i) ((set)[(i) >> 5] & (1u << ((i)&31)))
+
+#define LIVE_SET_ADD(set, i) ((set)[(i) >> 5] |= (1u << ((i)&31)))
+
+static void
+lsc_destroy(LinearScanContext *lsc)
+{
+    unsigned i, j;
+
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++) {
+        if (lsc->hreg_ranges[i]) {
+            for (j = 0; j < jit_cc_hreg_num(lsc->rc->cc, i); j++)
+                uint_stack_delete(&lsc->hreg_ranges[i][j]);
+            jit_free(lsc->hreg_ranges[i]);
+        }
+    }
+
+    uint_stack_delete(&lsc->native_calls);
+    uint_stack_delete(&lsc->jitted_calls);
+    jit_free(lsc->block_start);
+    jit_free(lsc->block_end);
+    jit_free(lsc->live_in);
+    jit_free(lsc->live_out);
+    jit_free(lsc->use);
+    jit_free(lsc->def);
+    jit_free(lsc->set_regs);
+    jit_free(lsc->set_index);
+    jit_free(lsc->first_block);
+    jit_free(lsc->intervals);
+}
+
+static bool
+lsc_init(LinearScanContext *lsc, RegallocContext *rc)
+{
+    JitCompContext *cc = rc->cc;
+    unsigned label_num = jit_cc_label_num(cc);
+    unsigned i, j;
+
+    memset(lsc, 0, sizeof(*lsc));
+    lsc->rc = rc;
+
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++) {
+        const unsigned hreg_num = jit_cc_hreg_num(cc, i);
+
+        lsc->kind_base[i] = lsc->reg_num;
+        lsc->reg_num += jit_cc_reg_num(cc, i);
+
+        if (hreg_num > 0
+            && !(lsc->hreg_ranges[i] =
+                     jit_calloc(sizeof(UintStack *) * hreg_num)))
+            goto fail;
+    }
+
+    if (!(lsc->intervals = jit_calloc(sizeof(LiveInterval) * lsc->reg_num))
+        || !(lsc->first_block = jit_calloc(sizeof(uint32) * lsc->reg_num))
+        || !(lsc->set_index = jit_malloc(sizeof(int32) * lsc->reg_num))
+        || !(lsc->block_start = jit_calloc(sizeof(uint32) * label_num))
+        || !(lsc->block_end = jit_calloc(sizeof(uint32) * label_num)))
+        goto fail;
+
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++)
+        for (j = 0; j < jit_cc_reg_num(cc, i); j++)
+            lsc->intervals[lsc->kind_base[i] + j].vreg = jit_reg_new(i, j);
+
+    for (i = 0; i < lsc->reg_num; i++)
+        lsc->set_index[i] = -1;
+
+    return true;
+
+fail:
+    lsc_destroy(lsc);
+    return false;
+}
+
+/**
+ * Check whether the register takes part in the global liveness
+ * analysis, which must be an allocation candidate but not a hard
+ * register.
+ */
+static bool
+is_ls_candidate(JitCompContext *cc, JitReg reg)
+{
+    return is_alloc_candidate(cc, reg) && !jit_cc_is_hreg(cc, reg);
+}
+
+static uint32
+ls_reg_index(LinearScanContext *lsc, JitReg reg)
+{
+    return lsc->kind_base[jit_reg_kind(reg)] + jit_reg_no(reg);
+}
+
+static void
+extend_interval(LiveInterval *interval, uint32 pos)
+{
+    if (interval->end == 0) {
+        interval->start = interval->end = pos;
+    }
+    else {
+        if (pos < interval->start)
+            interval->start = pos;
+        if (pos > interval->end)
+            interval->end = pos;
+    }
+}
+
+/**
+ * Record an occurrence of the register at the position in the basic
+ * block, which extends the interval of a virtual register or the range
+ * of a hard register used directly in the block.
+ */
+static void
+record_occurrence(LinearScanContext *lsc, JitReg reg, unsigned label_index,
+                  uint32 pos, bool is_use, uint32 hreg_first[][64],
+                  uint32 hreg_last[][64])
+{
+    JitCompContext *cc = lsc->rc->cc;
+    unsigned kind, no;
+    uint32 index;
+
+    if (!is_alloc_candidate(cc, reg))
+        return;
+
+    kind = jit_reg_kind(reg);
+    no = jit_reg_no(reg);
+
+    if (jit_cc_is_hreg(cc, reg)) {
+        /* exec_env_reg is reserved in the whole function.  */
+        if (reg != cc->exec_env_reg) {
+            bh_assert(no < 64);
+            if (!hreg_first[kind][no])
+                hreg_first[kind][no] = pos;
+            hreg_last[kind][no] = pos;
+        }
+        return;
+    }
+
+    index = ls_reg_index(lsc, reg);
+    if (!lsc->first_block[index]) {
+        lsc->first_block[index] = label_index + 1;
+        /* Used before defined in the block.  */
+        if (is_use)
+            lsc->set_index[index] = 0;
+    }
+    else if (lsc->first_block[index] != label_index + 1)
+        lsc->set_index[index] = 0;
+
+    extend_interval(&lsc->intervals[index], pos);
+}
+
+/**
+ * Number the instructions in the order of the basic block labels, which
+ * is the order the allocation is done in, and collect the positions of
+ * calls, the ranges of the hard registers used directly and the local
+ * intervals.  Registers that occur in more than one basic block or are
+ * used before defined in a block are put into the live sets.
+ *
+ * @param lsc the linear scan context
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+number_instructions(LinearScanContext *lsc)
+{
+    JitCompContext *cc = lsc->rc->cc;
+    JitBasicBlock *basic_block;
+    JitInsn *insn;
+    unsigned label_index, end_label_index, i, j;
+    uint32 pos = 0, hreg_first[JIT_REG_KIND_L32][64];
+    uint32 hreg_last[JIT_REG_KIND_L32][64];
+    JitReg *regp;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, basic_block)
+    {
+        memset(hreg_first, 0, sizeof(hreg_first));
+
+        /* The block head takes a position so that blocks never share
+           positions with each other.  */
+        pos += 2;
+        lsc->block_start[label_index] = pos;
+
+        JIT_FOREACH_INSN(basic_block, insn)
+        {
+            JitRegVec regvec;
+            unsigned first_use;
+
+#if WASM_ENABLE_SHARED_MEMORY != 0
+            /* fence insn doesn't have any operand, hence, no regs involved */
+            if (insn->opcode == JIT_OP_FENCE) {
+                continue;
+            }
+#endif
+
+            if (pos >= UINT32_MAX - 4) {
+                jit_set_last_error(cc, "too many instructions to allocate");
+                return false;
+            }
+            pos += 2;
+
+            if (insn->opcode == JIT_OP_CALLNATIVE) {
+                if (!uint_stack_push(&lsc->native_calls, pos))
+                    goto fail;
+            }
+            else if (insn->opcode == JIT_OP_CALLBC) {
+                if (!uint_stack_push(&lsc->jitted_calls, pos))
+                    goto fail;
+            }
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            /* Visit the uses before the defs so that a register used and
+               defined by the same instruction is seen as used first.  */
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            record_occurrence(lsc, *regp, label_index, pos, true, hreg_first,
+                              hreg_last);
+
+            JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+            record_occurrence(lsc, *regp, label_index, pos + 1, false,
+                              hreg_first, hreg_last);
+        }
+
+        lsc->block_end[label_index] = pos + 1;
+
+        for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++)
+            for (j = 0; j < jit_cc_hreg_num(cc, i) && j < 64; j++)
+                if (hreg_first[i][j]
+                    && (!uint_stack_push(&lsc->hreg_ranges[i][j],
+                                         hreg_first[i][j])
+                        || !uint_stack_push(&lsc->hreg_ranges[i][j],
+                                            hreg_last[i][j])))
+                    goto fail;
+    }
+
+    return true;
+
+fail:
+    jit_set_last_error(cc, "allocate memory failed");
+    return false;
+}
+
+/**
+ * Compute the live-in and live-out sets of the basic blocks for the
+ * registers live across blocks, and extend their intervals to cover
+ * the blocks they are live through.
+ *
+ * @param lsc the linear scan context
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+compute_liveness(LinearScanContext *lsc)
+{
+    JitCompContext *cc = lsc->rc->cc;
+    unsigned label_num = jit_cc_label_num(cc);
+    JitBasicBlock *basic_block;
+    JitInsn *insn;
+    unsigned label_index, end_label_index, i, w;
+    uint32 index, set_size, *set_in, *set_out, *set_use, *set_def;
+    JitReg *regp;
+    bool changed;
+
+    for (index = 0; index < lsc->reg_num; index++)
+        if (lsc->set_index[index] == 0)
+            lsc->set_num++;
+
+    if (lsc->set_num == 0)
+        return true;
+
+    lsc->set_words = (lsc->set_num + 31) / 32;
+    set_size = sizeof(uint32) * lsc->set_words * label_num;
+
+    if (!(lsc->set_regs = jit_malloc(sizeof(JitReg) * lsc->set_num))
+        || !(lsc->live_in = jit_calloc(set_size))
+        || !(lsc->live_out = jit_calloc(set_size))
+        || !(lsc->use = jit_calloc(set_size))
+        || !(lsc->def = jit_calloc(set_size))) {
+        jit_set_last_error(cc, "allocate memory failed");
+        return false;
+    }
+
+    for (index = 0, i = 0; index < lsc->reg_num; index++)
+        if (lsc->set_index[index] == 0) {
+            lsc->set_regs[i] = lsc->intervals[index].vreg;
+            lsc->set_index[index] = i++;
+        }
+
+    /* Collect the upward-exposed uses and the definitions.  */
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, basic_block)
+    {
+        set_use = LIVE_SET(lsc, use, label_index);
+        set_def = LIVE_SET(lsc, def, label_index);
+
+        JIT_FOREACH_INSN(basic_block, insn)
+        {
+            JitRegVec regvec;
+            unsigned first_use;
+            int32 set_i;
+
+#if WASM_ENABLE_SHARED_MEMORY != 0
+            /* fence insn doesn't have any operand, hence, no regs involved */
+            if (insn->opcode == JIT_OP_FENCE) {
+                continue;
+            }
+#endif
+
+            regvec = jit_insn_opnd_regs(insn);
+            first_use = jit_insn_opnd_first_use(insn);
+
+            JIT_REG_VEC_FOREACH_USE(regvec, i, regp, first_use)
+            if (is_ls_candidate(cc, *regp)
+                && (set_i = lsc->set_index[ls_reg_index(lsc, *regp)]) >= 0
+                && !LIVE_SET_HAS(set_def, set_i))
+                LIVE_SET_ADD(set_use, set_i);
+
+            JIT_REG_VEC_FOREACH_DEF(regvec, i, regp, first_use)
+            if (is_ls_candidate(cc, *regp)
+                && (set_i = lsc->set_index[ls_reg_index(lsc, *regp)]) >= 0)
+                LIVE_SET_ADD(set_def, set_i);
+        }
+    }
+
+    /* Iterate to the fixed point, visiting blocks in reverse order
+       makes it converge faster as most edges are forward ones.  */
+    do {
+        changed = false;
+
+        for (label_index = label_num; label_index-- > 0;) {
+            JitRegVec succs;
+
+            if (!(basic_block = *(jit_annl_basic_block(
+                      cc, jit_reg_new(JIT_REG_KIND_L32, label_index)))))
+                continue;
+
+            set_in = LIVE_SET(lsc, live_in, label_index);
+            set_out = LIVE_SET(lsc, live_out, label_index);
+            set_use = LIVE_SET(lsc, use, label_index);
+            set_def = LIVE_SET(lsc, def, label_index);
+
+            succs = jit_basic_block_succs(basic_block);
+            JIT_REG_VEC_FOREACH(succs, i, regp)
+            if (jit_reg_is_kind(L32, *regp)) {
+                uint32 *succ_in = LIVE_SET(lsc, live_in, jit_reg_no(*regp));
+
+                for (w = 0; w < lsc->set_words; w++)
+                    set_out[w] |= succ_in[w];
+            }
+
+            for (w = 0; w < lsc->set_words; w++) {
+                uint32 new_in = set_use[w] | (set_out[w] & ~set_def[w]);
+
+                if (new_in != set_in[w]) {
+                    set_in[w] = new_in;
+                    changed = true;
+                }
+            }
+        }
+    } while (changed);
+
+    /* Extend the intervals to the boundaries of the blocks.  */
+    for (i = 0; i < lsc->set_num; i++) {
+        LiveInterval *interval =
+            &lsc->intervals[ls_reg_index(lsc, lsc->set_regs[i])];
+        bool is_live_across = false;
+
+        JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index,
+                                     basic_block)
+        {
+            set_in = LIVE_SET(lsc, live_in, label_index);
+            set_out = LIVE_SET(lsc, live_out, label_index);
+
+            if (LIVE_SET_HAS(set_in, i)) {
+                extend_interval(interval, lsc->block_start[label_index]);
+                is_live_across = true;
+            }
+            if (LIVE_SET_HAS(set_out, i)) {
+                extend_interval(interval, lsc->block_end[label_index]);
+                is_live_across = true;
+            }
+        }
+
+        /* The register occurs in several blocks but is defined before
+           used in each of them, e.g. the cached module instance, whose
+           union of the local intervals would be too long.  Leave it to
+           the local allocation in each block.  */
+        if (!is_live_across)
+            interval->end = 0;
+    }
+
+    return true;
+}
+
+/**
+ * Check whether the interval crosses any of the calls, i.e. it is live
+ * both before and after the call.
+ *
+ * @param calls the sorted use positions of the calls
+ * @param cursor the index of the first call after the previous interval
+ * start, the intervals must be visited in order of start positions
+ * @param interval the live interval
+ *
+ * @return true if the interval crosses a call
+ */
+static bool
+interval_crosses_call(const UintStack *calls, uint32 *cursor,
+                      const LiveInterval *interval)
+{
+    if (!calls)
+        return false;
+
+    while (*cursor < calls->top && calls->elem[*cursor] < interval->start)
+        (*cursor)++;
+
+    return *cursor < calls->top && calls->elem[*cursor] + 1 < interval->end;
+}
+
+/**
+ * Check whether the hard register is used directly in the interval.
+ *
+ * @param ranges the sorted ranges of the hard register
+ * @param cursor the index of the first range not ending before the
+ * previous interval start
+ * @param interval the live interval
+ *
+ * @return true if the hard register is used in the interval
+ */
+static bool
+hreg_used_in_interval(const UintStack *ranges, uint32 *cursor,
+                      const LiveInterval *interval)
+{
+    if (!ranges)
+        return false;
+
+    while (*cursor < ranges->top
+           && ranges->elem[*cursor + 1] < interval->start)
+        *cursor += 2;
+
+    return *cursor < ranges->top && ranges->elem[*cursor] <= interval->end;
+}
+
+static int
+compare_interval_start(const void *a, const void *b)
+{
+    const LiveInterval *interval_a = *(const LiveInterval **)a;
+    const LiveInterval *interval_b = *(const LiveInterval **)b;
+
+    if (interval_a->start != interval_b->start)
+        return interval_a->start < interval_b->start ? -1 : 1;
+    return interval_a->end < interval_b->end
+               ? -1
+               : (interval_a->end > interval_b->end ? 1 : 0);
+}
+
+/**
+ * Allocate hard registers to the live intervals with the linear scan
+ * algorithm, and set them as the global hard registers of the virtual
+ * registers.  Intervals that can't get a hard register are left to the
+ * local allocation, which spills them around their occurrences.
+ *
+ * @param lsc the linear scan context
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+scan_intervals(LinearScanContext *lsc)
+{
+    RegallocContext *rc = lsc->rc;
+    JitCompContext *cc = rc->cc;
+    LiveInterval **sorted = NULL, **active[JIT_REG_KIND_L32] = { 0 };
+    uint32 *range_cursors[JIT_REG_KIND_L32] = { 0 };
+    uint32 native_cursor = 0, jitted_cursor = 0;
+    uint32 interval_num = 0, index, i, j;
+    bool retval = false;
+
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++) {
+        const unsigned hreg_num = jit_cc_hreg_num(cc, i);
+
+        if (hreg_num > 0
+            && (!(active[i] = jit_calloc(sizeof(LiveInterval *) * hreg_num))
+                || !(range_cursors[i] = jit_calloc(sizeof(uint32) * hreg_num))))
+            goto fail;
+    }
+
+    if (!(sorted = jit_malloc(sizeof(LiveInterval *) * (lsc->reg_num + 1))))
+        goto fail;
+
+    for (index = 0; index < lsc->reg_num; index++)
+        if (lsc->intervals[index].end
+            && is_ls_candidate(cc, lsc->intervals[index].vreg))
+            sorted[interval_num++] = &lsc->intervals[index];
+
+    qsort(sorted, interval_num, sizeof(LiveInterval *), compare_interval_start);
+
+    for (i = 0; i < interval_num; i++) {
+        LiveInterval *interval = sorted[i], *victim = NULL;
+        const unsigned kind = jit_reg_kind(interval->vreg);
+        const unsigned hreg_num = jit_cc_hreg_num(cc, kind);
+        bool cross_native, cross_jitted;
+        JitReg hreg = 0;
+
+        if (hreg_num == 0)
+            continue;
+
+        cross_native =
+            interval_crosses_call(lsc->native_calls, &native_cursor, interval);
+        cross_jitted =
+            interval_crosses_call(lsc->jitted_calls, &jitted_cursor, interval);
+
+        for (j = 0; j < hreg_num; j++) {
+            const JitReg cur_hreg = jit_reg_new(kind, j);
+
+            /* Expire the interval ended before the current one.  */
+            if (active[kind][j] && active[kind][j]->end < interval->start)
+                active[kind][j] = NULL;
+
+            if (jit_cc_is_hreg_fixed(cc, cur_hreg)
+                || cur_hreg == cc->exec_env_reg
+                || (cross_native
+                    && jit_cc_is_hreg_caller_saved_native(cc, cur_hreg))
+                || (cross_jitted
+                    && jit_cc_is_hreg_caller_saved_jitted(cc, cur_hreg))
+                || hreg_used_in_interval(lsc->hreg_ranges[kind][j],
+                                         &range_cursors[kind][j], interval))
+                continue;
+
+            if (!active[kind][j]) {
+                if (!hreg)
+                    hreg = cur_hreg;
+            }
+            /* Candidate to spill: the active one ending the furthest.  */
+            else if (active[kind][j]->end > interval->end
+                     && (!victim || active[kind][j]->end > victim->end))
+                victim = active[kind][j];
+        }
+
+        if (!hreg && victim) {
+            /* Give the hard register of the victim to the current
+               interval, the victim is left to the local allocation.  */
+            hreg = victim->hreg;
+            victim->hreg = 0;
+        }
+
+        if (hreg) {
+            interval->hreg = hreg;
+            active[kind][jit_reg_no(hreg)] = interval;
+        }
+    }
+
+    for (i = 0; i < interval_num; i++)
+        rc_get_vr(rc, sorted[i]->vreg)->global_hreg = sorted[i]->hreg;
+
+    retval = true;
+
+fail:
+    if (!retval)
+        jit_set_last_error(cc, "allocate memory failed");
+
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++) {
+        jit_free(active[i]);
+        jit_free(range_cursors[i]);
+    }
+    jit_free(sorted);
+    return retval;
+}
+
+/**
+ * Prepare the state of the registers live out of the basic block before
+ * the local allocation: the ones with global hard registers are in their
+ * hard registers, and the others are in their spill slots.
+ *
+ * @param lsc the linear scan context
+ * @param label_index the label index of the basic block
+ */
+static void
+init_live_out_regs(LinearScanContext *lsc, unsigned label_index)
+{
+    RegallocContext *rc = lsc->rc;
+    uint32 *set_out, i;
+
+    if (!lsc->set_num)
+        return;
+
+    set_out = LIVE_SET(lsc, live_out, label_index);
+    for (i = 0; i < lsc->set_num; i++)
+        if (LIVE_SET_HAS(set_out, i)) {
+            const JitReg vreg = lsc->set_regs[i];
+            VirtualReg *vr = rc_get_vr(rc, vreg);
+
+            if (vr->global_hreg) {
+                vr->hreg = vr->global_hreg;
+                (rc_get_hr(rc, vr->hreg))->vreg = vreg;
+            }
+        }
+}
+
+/**
+ * Insert the spills and reloads at the beginning of the basic block
+ * for the registers live into it after the local allocation, so that
+ * the state at the block entry matches the one at the end of its
+ * predecessors, and release all hard registers except exec_env_reg.
+ *
+ * @param lsc the linear scan context
+ * @param basic_block the basic block
+ * @param label_index the label index of the basic block
+ *
+ * @return true if succeeds, false otherwise
+ */
+static bool
+fix_live_in_regs(LinearScanContext *lsc, JitBasicBlock *basic_block,
+                 unsigned label_index)
+{
+    RegallocContext *rc = lsc->rc;
+    JitCompContext *cc = rc->cc;
+    uint32 *set_in, i, j;
+
+    /* Reload the registers passed through the spill slots into the hard
+       registers allocated to them in the block.  The reloads are
+       inserted before the spills below as both are inserted at the
+       block beginning.  */
+    for (i = JIT_REG_KIND_VOID; i < JIT_REG_KIND_L32; i++)
+        for (j = 0; j < jit_cc_hreg_num(cc, i); j++) {
+            const JitReg vreg = rc->hregs[i][j].vreg;
+            VirtualReg *vr;
+
+            if (!vreg || vreg == cc->exec_env_reg)
+                continue;
+
+            vr = rc_get_vr(rc, vreg);
+            if (jit_cc_is_hreg(cc, vreg)) {
+                /* The hard register used directly has no value to pass,
+                   e.g. the argument registers locked by callnative.  */
+                rc_free_spill_slot(rc, vr->slot);
+                rc->hregs[i][j].vreg = 0;
+                vr->hreg = vr->slot = 0;
+            }
+            else if (!vr->global_hreg) {
+                bh_assert(is_slot_kept(vr));
+                if (!reload_vreg(rc, vreg, basic_block))
+                    return false;
+            }
+        }
+
+    if (!lsc->set_num)
+        return true;
+
+    /* Spill the registers with global hard registers that are reloaded
+       from their spill slots in the block, they are in the hard
+       registers at the block entry.  */
+    set_in = LIVE_SET(lsc, live_in, label_index);
+    for (i = 0; i < lsc->set_num; i++)
+        if (LIVE_SET_HAS(set_in, i)) {
+            const JitReg vreg = lsc->set_regs[i];
+            VirtualReg *vr = rc_get_vr(rc, vreg);
+
+            if (!vr->global_hreg)
+                continue;
+
+            if (vr->slot) {
+                vr->hreg = vr->global_hreg;
+                if (!spill_vreg(rc, vreg, basic_block))
+                    return false;
+                rc_free_spill_slot(rc, vr->slot);
+                vr->slot = 0;
+            }
+
+            if ((rc_get_hr(rc, vr->global_hreg))->vreg == vreg)
+                (rc_get_hr(rc, vr->global_hreg))->vreg = 0;
+            vr->hreg = 0;
+        }
+
+    return true;
+}
+
+bool
+jit_pass_regalloc_linear_scan(JitCompContext *cc)
+{
+    RegallocContext rc = { 0 };
+    LinearScanContext lsc;
+    unsigned label_index, end_label_index, i;
+    JitBasicBlock *basic_block;
+    VirtualReg *self_vr;
+    bool retval = false;
+
+    if (!rc_init(&rc, cc))
+        return false;
+
+    if (!lsc_init(&lsc, &rc)) {
+        rc_destroy(&rc);
+        return false;
+    }
+
+    if (!number_instructions(&lsc) || !compute_liveness(&lsc)
+        || !scan_intervals(&lsc))
+        goto cleanup_and_return;
+
+    /* Registers live across blocks without global hard registers pass
+       their values through the spill slots kept in the function.  */
+    for (i = 0; i < lsc.set_num; i++) {
+        VirtualReg *vr = rc_get_vr(&rc, lsc.set_regs[i]);
+
+        if (!lsc.intervals[ls_reg_index(&lsc, lsc.set_regs[i])].end)
+            continue;
+
+        vr->live_across_blocks = true;
+        if (!vr->global_hreg && !(vr->slot = rc_alloc_spill_slot(&rc, lsc.set_regs[i]))) {
+            jit_set_last_error(cc, "allocate spill slot failed");
+            goto cleanup_and_return;
+        }
+    }
+
+    self_vr = rc_get_vr(&rc, cc->exec_env_reg);
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, basic_block)
+    {
+        int distance;
+
+        self_vr->hreg = self_vr->global_hreg;
+        (rc_get_hr(&rc, cc->exec_env_reg))->vreg = cc->exec_env_reg;
+
+        init_live_out_regs(&lsc, label_index);
+
+        if ((distance = collect_distances(&rc, basic_block)) < 0)
+            goto cleanup_and_return;
+
+        if (!allocate_for_basic_block(&rc, basic_block, distance))
+            goto cleanup_and_return;
+
+        if (!fix_live_in_regs(&lsc, basic_block, label_index))
+            goto cleanup_and_return;
+    }
+
+    cc->spill_insn_num = rc.spill_insn_num;
+    cc->reload_insn_num = rc.reload_insn_num;
     retval = true;
 
 cleanup_and_return:
+    lsc_destroy(&lsc);
     rc_destroy(&rc);
 
     return retval;
@@ -69,6 +69,7 @@ typedef struct AOTCompOption {
     bool enable_ref_types;
     bool enable_call_indirect_overlong;
     bool enable_gc;
+    bool enable_gc_write_barrier;
     bool enable_aux_stack_check;
     bool enable_extended_const;
     bool enable_lime1;
@@ -96,6 +97,18 @@ typedef struct AOTCompOption {
     const char *stack_usage_file;
     const char *llvm_passes;
     const char *builtin_intrinsics;
+    /* JIT mode only: directory of the JIT code cache, and the SHA-256
+       digest (32 bytes) of the wasm binary which keys the cached code */
+    const char *jit_cache_dir;
+    const uint8_t *jit_cache_module_digest;
+    /* AOT mode only: number of threads to optimize and compile the
+       functions in, the functions are split into partitions which are
+       compiled into separate object files if it is larger than 1 */
+    uint32_t compile_thread_num;
+    /* AOT mode only: the directory of the cache of the object files of
+       the functions, the unchanged functions are loaded from the cache
+       instead of being optimized and compiled again */
+    const char *func_cache_dir;
 } AOTCompOption, *aot_comp_option_t;
 
 #ifdef __cplusplus
@@ -157,6 +157,10 @@ typedef struct WASMExecEnv *wasm_exec_env_t;
 struct WASMSharedHeap;
 typedef struct WASMSharedHeap *wasm_shared_heap_t;
 
+/* WASM module being loaded from a byte stream */
+struct WASMModuleStream;
+typedef struct WASMModuleStream *wasm_module_stream_t;
+
 /* Package Type */
 typedef enum {
     Wasm_Module_Bytecode = 0,
@@ -207,6 +211,35 @@ typedef struct mem_alloc_info_t {
     uint32_t highmark_size;
 } mem_alloc_info_t;
 
+/* Memory usage of a module instance, the sizes are in bytes */
+typedef struct module_inst_mem_usage_t {
+    /* Current and peak size of the linear memories */
+    uint64_t linear_memory_size;
+    uint64_t linear_memory_peak_size;
+    /* Size of the pages of the linear memories backed by physical memory,
+       and size of the address space reserved for the linear memories */
+    uint64_t linear_memory_committed_size;
+    uint64_t linear_memory_reserved_size;
+    /* Total, used and peak used size of the host managed heaps, which are
+       inside the linear memories */
+    uint32_t app_heap_size;
+    uint32_t app_heap_used_size;
+    uint32_t app_heap_peak_used_size;
+    /* Total, used and peak used size of the GC heap, the number of
+       collections, and the number of times and the max time in
+       microseconds the instance was paused by the collector, only
+       available when GC is enabled */
+    uint32_t gc_heap_size;
+    uint32_t gc_heap_used_size;
+    uint32_t gc_heap_peak_used_size;
+    uint32_t gc_count;
+    uint32_t gc_pause_count;
+    uint32_t gc_max_pause_time;
+    uint32_t __padding;
+    /* Total time in microseconds the instance was paused by the collector */
+    uint64_t gc_total_pause_time;
+} module_inst_mem_usage_t;
+
 /* Running mode of runtime and module instance*/
 typedef enum RunningMode {
     Mode_Interp = 1,
@@ -257,6 +290,44 @@ typedef struct RuntimeInitArgs {
      * - interpreter. TBD
      */
     bool enable_linux_perf;
+
+    /* Fast JIT optimization level, 0 to 2 */
+    uint32_t fast_jit_opt_level;
+
+    /* Fast JIT register allocator, 0: local, 1: linear scan */
+    uint32_t fast_jit_regalloc;
+
+    /* Number of calls and loop iterations after which a function run by
+       the interpreter is compiled by Fast JIT, 0 to compile all functions
+       in advance. Only available when lazy JIT is enabled. */
+    uint32_t fast_jit_tierup_threshold;
+
+    /* Directory where LLVM JIT saves the machine code of the loaded
+       modules and reloads it from when the same module is loaded again,
+       NULL to disable the cache. The string must be kept valid until
+       the runtime is destroyed. */
+    const char *llvm_jit_cache_dir;
+
+    /* Number of linear memories whose address space is reserved when the
+       runtime is initialized, 0 to disable the pool. The linear memories
+       of the instances are taken from the pool and their pages are
+       discarded and reused on deinstantiation, which makes instantiation
+       cheaper. Only available on Linux with hardware bound check. */
+    uint32_t linear_memory_pool_slot_count;
+
+    /* Directory where the fast interpreter saves the pre-compiled code of
+       the loaded modules and reloads it from when the same module is
+       loaded again, NULL to disable the cache. The functions loaded from
+       the cache aren't validated again, so the directory must be only
+       writable by trusted users. The string must be kept valid until the
+       runtime is destroyed. */
+    const char *fast_interp_cache_dir;
+
+    /* Number of threads (including the loading thread) that validate and
+       pre-compile the function bodies of a wasm module in parallel when it
+       is loaded, 0 to use the default value. Only available when parallel
+       loader is enabled. */
+    uint32_t loader_thread_num;
 } RuntimeInitArgs;
 
 #ifndef LOAD_ARGS_OPTION_DEFINED
@@ -275,6 +346,14 @@ typedef struct LoadArgs {
        wasm_runtime_load_ex has to be followed by a wasm_runtime_resolve_symbols
        call */
     bool no_resolve;
+    /* false by default, used by wasm loader only. If true, only the module
+       structure is validated when loading, each function body is validated
+       and prepared for the interpreter when the function is called the
+       first time, and an invalid function raises an exception when it is
+       called instead of failing the loading. It is ignored if
+       wasm_binary_freeable is true or WAMR_BUILD_LAZY_VALIDATION isn't
+       enabled */
+    bool lazy_validation;
     /* TODO: more fields? */
 } LoadArgs;
 #endif /* LOAD_ARGS_OPTION_DEFINED */
@@ -599,6 +678,31 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load_ex(uint8_t *buf, uint32_t size, const LoadArgs *args,
                      char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Load an AOT module by mapping the AOT file into memory privately instead
+ * of reading it into a buffer. The text section is used from the mapping
+ * in place, only the pages patched by relocations are copied, and the
+ * other pages are shared with the page cache and so with other processes
+ * which load the same file. When the hardware bound check is enabled, the
+ * relocations to a code page are applied when the page is executed for
+ * the first time, so the loading time and the memory consumption don't
+ * grow with the size of the code that isn't run. Files compiled by wamrc
+ * with "--xip" have much fewer relocations in their code.
+ *
+ * The mapping is owned by the module and is released by
+ * wasm_runtime_unload. Only supported for AOT files on Linux currently.
+ *
+ * @param file_path the path of the AOT file
+ * @param args the load arguments, wasm_binary_freeable is ignored
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return WASM module loaded, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_t
+wasm_runtime_load_from_mapped_file(const char *file_path, const LoadArgs *args,
+                                   char *error_buf, uint32_t error_buf_size);
+
 /**
  * Resolve symbols for a previously loaded WASM module. Only useful when the
  * module was loaded with LoadArgs::no_resolve set to true
@@ -619,6 +723,68 @@ WASM_RUNTIME_API_EXTERN wasm_module_t
 wasm_runtime_load_from_sections(wasm_section_list_t section_list, bool is_aot,
                                 char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Begin to load a WASM module from a byte stream, e.g. when it is being
+ * downloaded, so that the loading overlaps with the receiving. The chunks
+ * of the WASM binary are fed with wasm_runtime_stream_load_feed(), and each
+ * function body is validated and pre-compiled as soon as it is complete.
+ * The stream is then finished with wasm_runtime_stream_load_finish(), or
+ * aborted with wasm_runtime_stream_load_abort().
+ *
+ * Only WASM bytecode files are supported, and only available when
+ * WAMR_BUILD_STREAM_LOADER is enabled.
+ *
+ * @param args the load arguments, wasm_binary_freeable is ignored as the
+ *        chunks are copied
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the stream created, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_stream_t
+wasm_runtime_stream_load_begin(const LoadArgs *args, char *error_buf,
+                               uint32_t error_buf_size);
+
+/**
+ * Feed the next chunk of the WASM binary to a stream. The chunk can be of
+ * any size and can be freed after the call.
+ *
+ * @param stream the stream to feed
+ * @param buf the chunk
+ * @param size the size of the chunk
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return true if success, false otherwise, in which case the stream can
+ *         only be aborted
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_stream_load_feed(wasm_module_stream_t stream, const uint8_t *buf,
+                              uint32_t size, char *error_buf,
+                              uint32_t error_buf_size);
+
+/**
+ * Finish loading a WASM module from a stream after the whole WASM binary
+ * has been fed. The stream is destroyed whether it succeeds or not.
+ *
+ * @param stream the stream to finish
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return WASM module loaded, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_t
+wasm_runtime_stream_load_finish(wasm_module_stream_t stream, char *error_buf,
+                                uint32_t error_buf_size);
+
+/**
+ * Abort loading a WASM module from a stream and destroy the stream.
+ *
+ * @param stream the stream to abort
+ */
+WASM_RUNTIME_API_EXTERN void
+wasm_runtime_stream_load_abort(wasm_module_stream_t stream);
+
 /**
  * Unload a WASM module.
  *
@@ -807,6 +973,113 @@ wasm_runtime_instantiate_ex2(const wasm_module_t module,
                              const struct InstantiationArgs2 *args,
                              char *error_buf, uint32_t error_buf_size);
 
+/**
+ * Save the state of a module instance to a snapshot file, so that new
+ * instances of the same module can be created from the snapshot without
+ * initializing the linear memory with the data segments and executing the
+ * start function and the _initialize function again.
+ *
+ * The snapshot holds the linear memories, the globals, the tables and the
+ * dropped data/element segments. The state kept by the host, e.g. the WASI
+ * context and the native contexts, isn't saved, nor the state of the
+ * instances of the sub modules in multi-module mode. The instance must not
+ * have a host managed heap or a shared memory, and it must not be running
+ * in other threads when the snapshot is taken.
+ *
+ * Only available when WAMR_BUILD_INSTANCE_SNAPSHOT is enabled.
+ *
+ * @param module_inst the module instance to save, usually it has just been
+ *        instantiated and initialized by calling some of its functions
+ * @param file_path the path of the snapshot file, it is replaced if exists
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_snapshot_instance(wasm_module_inst_t module_inst,
+                               const char *file_path, char *error_buf,
+                               uint32_t error_buf_size);
+
+/**
+ * Instantiate a WASM module and restore its state from a snapshot file
+ * saved by wasm_runtime_snapshot_instance() from an instance of the same
+ * module.
+ *
+ * The data segments aren't copied to the linear memory and the start
+ * function and the _initialize function aren't executed. When the linear
+ * memory is reserved with mmap and the platform supports file mapping, the
+ * linear memory data is mapped from the snapshot file copy-on-write, so
+ * the pages are only read when they are accessed and are shared between
+ * the restored instances until they are written.
+ *
+ * Only available when WAMR_BUILD_INSTANCE_SNAPSHOT is enabled.
+ *
+ * @param module the WASM module to instantiate
+ * @param args the instantiation arguments, or NULL to use the defaults,
+ *        the host managed heap size must be 0
+ * @param file_path the path of the snapshot file
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return return the instantiated WASM module instance, NULL if failed
+ */
+WASM_RUNTIME_API_EXTERN wasm_module_inst_t
+wasm_runtime_instantiate_from_snapshot(const wasm_module_t module,
+                                       const struct InstantiationArgs2 *args,
+                                       const char *file_path, char *error_buf,
+                                       uint32_t error_buf_size);
+
+/**
+ * Save the current state of a module instance as its reset point, so that
+ * the instance can be reset to it with wasm_runtime_reset_instance() and
+ * reused, e.g. to serve the next request, instead of instantiating the
+ * module again. The reset point saved before is replaced.
+ *
+ * The state includes the linear memories, the host managed heaps, the
+ * globals, the tables and the dropped data/element segments. When the
+ * platform supports it, the linear memory data is saved to an in-memory
+ * file which is mapped copy-on-write over the linear memory on reset, so
+ * that only the pages written since the last reset are dropped. The state
+ * kept by the host, e.g. the WASI context and the native contexts, isn't
+ * saved. The instance must not have a shared memory, and it must not be
+ * running in other threads.
+ *
+ * Only available when WAMR_BUILD_INSTANCE_RESET is enabled.
+ *
+ * @param module_inst the module instance, usually it has just been
+ *        instantiated and initialized by calling some of its functions
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_set_instance_reset_point(wasm_module_inst_t module_inst,
+                                      char *error_buf,
+                                      uint32_t error_buf_size);
+
+/**
+ * Reset a module instance to the reset point saved by
+ * wasm_runtime_set_instance_reset_point(), and clear its exception.
+ *
+ * A linear memory enlarged after the reset point is shrunk back, which is
+ * only supported when the linear memory is reserved with mmap, i.e. when
+ * the hardware bound check is enabled. The instance must not be running.
+ *
+ * Only available when WAMR_BUILD_INSTANCE_RESET is enabled.
+ *
+ * @param module_inst the module instance to reset
+ * @param error_buf buffer to output the error info if failed
+ * @param error_buf_size the size of the error buffer
+ *
+ * @return true if success, false otherwise, the instance may have been
+ *         partially reset if failed and shouldn't be used anymore
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_reset_instance(wasm_module_inst_t module_inst, char *error_buf,
+                            uint32_t error_buf_size);
+
 /**
  * Set the running mode of a WASM module instance, override the
  * default running mode of the runtime. Note that it only makes sense when
@@ -1163,6 +1436,39 @@ wasm_memory_get_shared(const wasm_memory_inst_t memory_inst);
 WASM_RUNTIME_API_EXTERN void *
 wasm_memory_get_base_address(const wasm_memory_inst_t memory_inst);
 
+/**
+ * @brief Get the size of the pages of a memory instance which are backed
+ * by physical memory, the pages which have never been touched aren't
+ * counted when the platform can tell them
+ *
+ * @param memory_inst The memory instance
+ *
+ * @return The resident size in bytes, or the current size of the memory
+ * if the resident pages can't be queried on the platform
+ */
+WASM_RUNTIME_API_EXTERN uint64_t
+wasm_memory_get_resident_size(const wasm_memory_inst_t memory_inst);
+
+/**
+ * @brief Get the memory usage of a module instance: the linear memories,
+ * the host managed heaps and the GC heap
+ *
+ * The usage is read from the counters kept by the runtime and the
+ * allocators without walking through the heaps or taking their locks, so
+ * it is cheap enough to be polled periodically for many instances. Only
+ * the committed size queries the platform, its cost grows with the size
+ * of the linear memories. A memory imported or shared by several
+ * instances is counted in each of them.
+ *
+ * @param module_inst The module instance
+ * @param usage [out] The memory usage
+ *
+ * @return true if success, false otherwise
+ */
+WASM_RUNTIME_API_EXTERN bool
+wasm_runtime_get_module_inst_mem_usage(const wasm_module_inst_t module_inst,
+                                       module_inst_mem_usage_t *usage);
+
 /**
  * @brief Enlarge a memory instance by a number of pages
  *
@@ -25,5 +25,9 @@ file (GLOB_RECURSE source_all
     ${IWASM_INTERP_DIR}/${INTERPRETER}
 )
 
+if (WAMR_BUILD_FAST_INTERP EQUAL 1 AND WAMR_BUILD_FAST_INTERP_CACHE EQUAL 1)
+    list (APPEND source_all ${IWASM_INTERP_DIR}/wasm_fast_interp_cache.c)
+endif ()
+
 set (IWASM_INTERP_SOURCE ${source_all})
 
@@ -9,6 +9,10 @@
 #include "bh_platform.h"
 #include "bh_hashmap.h"
 #include "bh_assert.h"
+#include "bh_code_cache.h"
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+#include "bh_atomic.h"
+#endif
 #if WASM_ENABLE_GC != 0
 #include "gc_export.h"
 #endif
@@ -225,6 +229,9 @@ typedef void *table_elem_type_t;
 typedef struct WASMModule WASMModule;
 typedef struct WASMFunction WASMFunction;
 typedef struct WASMGlobal WASMGlobal;
+#if WASM_ENABLE_STREAM_LOADER != 0
+typedef struct WASMModuleStream WASMModuleStream;
+#endif
 #if WASM_ENABLE_TAGS != 0
 typedef struct WASMTag WASMTag;
 #endif
@@ -681,6 +688,24 @@ typedef struct WASMImport {
     } u;
 } WASMImport;
 
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+/* Loop header of the fast jit jitted code, from which the interpreter
+   can switch to the jitted code (on-stack replacement) */
+typedef struct WASMFastJITOSREntry {
+    /* The begin of the loop body in the bytecode */
+    uint8 *ip;
+    /* The jitted code address of the loop body */
+    void *jitted_addr;
+} WASMFastJITOSREntry;
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+/* The lazy validation states of a function */
+#define LAZY_FUNC_VALIDATED 0
+#define LAZY_FUNC_UNVALIDATED 1
+#define LAZY_FUNC_INVALID 2
+#endif
+
 struct WASMFunction {
 #if WASM_ENABLE_CUSTOM_NAME_SECTION != 0
     char *field_name;
@@ -714,6 +739,21 @@ struct WASMFunction {
     uint8 *consts;
     uint32 const_cell_num;
 #endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    /* the slots of code_compiled which hold the label addresses and the
+       addresses of code_compiled, they are relocated when the code is
+       saved to the fast interpreter code cache and freed after that */
+    uint32 *code_relocs;
+    uint32 code_reloc_count;
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    /* LAZY_FUNC_VALIDATED, LAZY_FUNC_UNVALIDATED or LAZY_FUNC_INVALID,
+       written with the lazy_validation_lock of the module held and read
+       atomically by the interpreter before calling the function */
+    bh_atomic_32_t lazy_state;
+    /* the error message if the function failed the lazy validation */
+    char *lazy_validation_error;
+#endif
 
 #if WASM_ENABLE_GC != 0
     /* the type index of this function's func_type */
@@ -750,6 +790,23 @@ struct WASMFunction {
        from the llvm jit jitted code */
     void *call_to_fast_jit_from_llvm_jit;
 #endif
+#if WASM_ENABLE_LAZY_JIT != 0
+    /* Number of calls and loop iterations run by the interpreter */
+    uint32 fast_jit_hotness;
+    /* Whether the tier-up compilation failed, the function is then
+       kept in the interpreter */
+    bool fast_jit_tierup_failed;
+#if WASM_ENABLE_SIMD != 0
+    /* Whether v128 values are used by the function, it can't be run by
+       the classic interpreter and is compiled before its first call */
+    bool has_v128;
+#endif
+    /* Frame size of the jitted code */
+    uint32 fast_jit_frame_size;
+    /* Loop headers of the jitted code for on-stack replacement */
+    uint32 fast_jit_osr_entry_count;
+    WASMFastJITOSREntry *fast_jit_osr_entries;
+#endif
 #endif
 
 #if WASM_ENABLE_BRANCH_HINTS != 0
@@ -1105,6 +1162,10 @@ struct WASMModule {
 #if WASM_ENABLE_JIT != 0
     struct AOTCompData *comp_data;
     struct AOTCompContext *comp_ctx;
+    /* whether the LLVM JIT code cache is enabled for the module, and the
+       SHA-256 digest of the wasm binary to key the cached code */
+    bool llvm_jit_cache_enabled;
+    uint8 llvm_jit_cache_digest[BH_SHA256_DIGEST_SIZE];
     /**
      * func pointers of LLVM JITed (un-imported) functions
      * for non Multi-Tier JIT mode:
@@ -1161,6 +1222,45 @@ struct WASMModule {
 
     /* Whether the underlying wasm binary buffer can be freed */
     bool is_binary_freeable;
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* The active data segments of the default memory prepared for being
+       mapped on instantiation, NULL if they are copied instead */
+    struct WASMMemoryImage *memory_image;
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    /* Whether the function bodies are validated and prepared when they
+       are called the first time, see LoadArgs::lazy_validation */
+    bool lazy_validation;
+    /* lock to validate the function bodies lazily */
+    korp_mutex lazy_validation_lock;
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    /* lock of the loader threads that prepare the function bodies,
+       NULL if they are prepared by the loading thread only */
+    korp_mutex *parallel_load_lock;
+#endif
+
+#if WASM_ENABLE_STREAM_LOADER != 0
+    /* sections received by the stream loader, which the function bodies
+       and the names refer to, NULL if the module isn't loaded from a
+       stream */
+    struct wasm_section_t *stream_sections;
+#endif
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    /* whether the fast interpreter code cache is enabled for the module,
+       and the SHA-256 digest of the wasm binary to key the cached code */
+    bool fast_interp_cache_enabled;
+    uint8 fast_interp_cache_digest[BH_SHA256_DIGEST_SIZE];
+    /* The cache file loaded, the code_compiled and consts of the
+       functions point into it, NULL if the cache isn't hit */
+    uint8 *fast_interp_cache_buf;
+    uint64 fast_interp_cache_buf_size;
+    bool fast_interp_cache_buf_mapped;
+#endif
 };
 
 typedef struct BlockType {
@@ -0,0 +1,655 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "wasm_fast_interp_cache.h"
+#include "wasm_opcode.h"
+#include "../common/wasm_runtime_common.h"
+#include "../../version.h"
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+
+#if WASM_ENABLE_GC != 0
+#error "Fast interpreter code cache doesn't support GC: the loader adds \
+the ref types used by the code to the module when pre-compiling it"
+#endif
+
+/* "WFIC" */
+#define FAST_INTERP_CACHE_MAGIC 0x43494657
+/* Bump it when the layout of the cache file or the format of the
+   pre-compiled code changes */
+#define FAST_INTERP_CACHE_VERSION 2
+
+/* module->possible_memory_grow */
+#define CACHE_FLAG_POSSIBLE_MEMORY_GROW 1
+
+/* The sizes of the index spaces of the module, which the pre-compiled
+   code refers to by index */
+typedef struct FastInterpCacheCounts {
+    uint32 type_count;
+    uint32 import_count;
+    uint32 import_function_count;
+    uint32 import_table_count;
+    uint32 import_memory_count;
+    uint32 import_global_count;
+    uint32 import_tag_count;
+    uint32 function_count;
+    uint32 table_count;
+    uint32 memory_count;
+    uint32 global_count;
+    uint32 tag_count;
+    uint32 export_count;
+    uint32 table_seg_count;
+    uint32 data_seg_count;
+} FastInterpCacheCounts;
+
+typedef struct FastInterpCacheHeader {
+    uint32 magic;
+    uint32 version;
+    uint8 module_digest[BH_SHA256_DIGEST_SIZE];
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+    /* digest of the data following the header */
+    uint8 data_digest[BH_SHA256_DIGEST_SIZE];
+    FastInterpCacheCounts counts;
+    uint32 flags;
+    uint64 data_size;
+} FastInterpCacheHeader;
+
+/* The offsets are relative to the start of the cache file */
+typedef struct FastInterpCacheFunc {
+    uint32 code_offset;
+    uint32 code_size;
+    uint32 consts_offset;
+    uint32 const_cell_num;
+    uint32 relocs_offset;
+    uint32 reloc_count;
+    uint32 max_stack_cell_num;
+    uint32 max_block_num;
+} FastInterpCacheFunc;
+
+/* The relocations are the positions of the slots in the code shifted
+   left by one bit, the lowest bit is set for a label slot, which holds
+   the opcode of the handler in the cache file, and cleared for a code
+   address slot, which holds its offset plus one in the cache file, or
+   zero for a NULL address */
+#define RELOC_POS(reloc) ((reloc) >> 1)
+#define RELOC_IS_LABEL(reloc) ((reloc) & 1)
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+void **
+wasm_interp_get_handle_table(void);
+
+/* The label emitted for an opcode, see emit_label in wasm_loader.c */
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
+typedef uintptr_t LabelValue;
+#else
+typedef uint32 LabelValue;
+#endif
+
+typedef struct LabelMapEntry {
+    LabelValue value;
+    uint32 opcode;
+} LabelMapEntry;
+
+static LabelValue
+get_label_value(void **handle_table, uint32 opcode)
+{
+#if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 && UINTPTR_MAX == UINT64_MAX
+    /* int32 relative offset in 64-bit target */
+    return (LabelValue)(int32)((uint8 *)handle_table[opcode]
+                               - (uint8 *)handle_table[0]);
+#else
+    return (LabelValue)(uintptr_t)handle_table[opcode];
+#endif
+}
+
+static int
+cmp_label_map_entry(const void *a, const void *b)
+{
+    LabelValue value1 = ((const LabelMapEntry *)a)->value;
+    LabelValue value2 = ((const LabelMapEntry *)b)->value;
+
+    return value1 < value2 ? -1 : (value1 > value2 ? 1 : 0);
+}
+
+static void
+init_label_map(LabelMapEntry *label_map)
+{
+    void **handle_table = wasm_interp_get_handle_table();
+    uint32 i;
+
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++) {
+        label_map[i].value = get_label_value(handle_table, i);
+        label_map[i].opcode = i;
+    }
+    qsort(label_map, WASM_INSTRUCTION_NUM, sizeof(LabelMapEntry),
+          cmp_label_map_entry);
+}
+
+/* Find an opcode whose handler is the label, the opcodes sharing the
+   same handler are interchangeable */
+static bool
+lookup_label_opcode(const LabelMapEntry *label_map, LabelValue value,
+                    uint32 *p_opcode)
+{
+    uint32 low = 0, high = WASM_INSTRUCTION_NUM, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (label_map[mid].value < value)
+            low = mid + 1;
+        else if (label_map[mid].value > value)
+            high = mid;
+        else {
+            *p_opcode = label_map[mid].opcode;
+            return true;
+        }
+    }
+    return false;
+}
+#endif /* end of WASM_ENABLE_LABELS_AS_VALUES != 0 */
+
+/* Digest everything besides the wasm binary that the pre-compiled code
+   depends on: the runtime version, the layout of the code and the
+   features validated by the loader */
+static void
+get_config_digest(uint8 *digest)
+{
+    uint32 values[] = {
+        FAST_INTERP_CACHE_VERSION,
+        WAMR_VERSION_MAJOR,
+        WAMR_VERSION_MINOR,
+        WAMR_VERSION_PATCH,
+        (uint32)sizeof(void *),
+        WASM_INSTRUCTION_NUM,
+        WASM_ENABLE_LABELS_AS_VALUES,
+        WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS,
+        WASM_ENABLE_SUPERINSTRUCTIONS,
+        WASM_ENABLE_SIMD,
+        WASM_ENABLE_SIMDE,
+        WASM_ENABLE_REF_TYPES,
+        WASM_ENABLE_BULK_MEMORY,
+        WASM_ENABLE_BULK_MEMORY_OPT,
+        WASM_ENABLE_CALL_INDIRECT_OVERLONG,
+        WASM_ENABLE_MEMORY64,
+        WASM_ENABLE_MULTI_MEMORY,
+        WASM_ENABLE_SHARED_MEMORY,
+        WASM_ENABLE_TAIL_CALL,
+        WASM_ENABLE_EXTENDED_CONST_EXPR,
+        WASM_ENABLE_EXCE_HANDLING,
+        WASM_ENABLE_BRANCH_HINTS,
+        WASM_ENABLE_MULTI_MODULE,
+        WASM_ENABLE_LIB_WASI_THREADS,
+        WASM_ENABLE_SHARED_HEAP,
+        WASM_ENABLE_DEBUG_INTERP,
+    };
+
+    bh_sha256(values, sizeof(values), digest);
+}
+
+static void
+get_module_counts(const WASMModule *module, FastInterpCacheCounts *counts)
+{
+    memset(counts, 0, sizeof(FastInterpCacheCounts));
+    counts->type_count = module->type_count;
+    counts->import_count = module->import_count;
+    counts->import_function_count = module->import_function_count;
+    counts->import_table_count = module->import_table_count;
+    counts->import_memory_count = module->import_memory_count;
+    counts->import_global_count = module->import_global_count;
+    counts->function_count = module->function_count;
+    counts->table_count = module->table_count;
+    counts->memory_count = module->memory_count;
+    counts->global_count = module->global_count;
+    counts->export_count = module->export_count;
+    counts->table_seg_count = module->table_seg_count;
+    counts->data_seg_count = module->data_seg_count;
+#if WASM_ENABLE_TAGS != 0
+    counts->import_tag_count = module->import_tag_count;
+    counts->tag_count = module->tag_count;
+#endif
+}
+
+static bool
+get_cache_file_path(const WASMModule *module, const char *cache_dir,
+                    const uint8 *config_digest, char *buf, uint32 buf_size)
+{
+    char module_hex[BH_SHA256_HEX_SIZE], config_hex[BH_SHA256_HEX_SIZE];
+    int len;
+
+    bh_sha256_to_hex(module->fast_interp_cache_digest, module_hex);
+    bh_sha256_to_hex(config_digest, config_hex);
+    len = snprintf(buf, buf_size, "%s/%s-%s.wfic", cache_dir, module_hex,
+                   config_hex);
+
+    if (len < 0 || (uint32)len >= buf_size) {
+        LOG_WARNING("fast interpreter code cache path is too long: %s",
+                    cache_dir);
+        return false;
+    }
+    return true;
+}
+
+static uint8 *
+read_cache_file(const char *file_path, uint64 *p_size, bool *p_mapped)
+{
+    uint8 *buf = NULL;
+    uint64 size = 0;
+#ifdef OS_ENABLE_FILE_MAPPING
+    os_file_handle file = os_file_open_for_mapping(file_path, &size);
+
+    if (file == os_get_invalid_handle())
+        return NULL;
+
+    /* Map the file privately and writable, only the pages relocated
+       are copied, the others are shared with the page cache */
+    if (size >= sizeof(FastInterpCacheHeader) && size < UINT32_MAX)
+        buf = os_mmap_file(NULL, (size_t)size,
+                           MMAP_PROT_READ | MMAP_PROT_WRITE, MMAP_MAP_NONE,
+                           file, 0);
+    os_file_close_for_mapping(file);
+    *p_mapped = true;
+#else
+    FILE *fp = fopen(file_path, "rb");
+    long file_size;
+
+    if (!fp)
+        return NULL;
+
+    if (fseek(fp, 0, SEEK_END) == 0 && (file_size = ftell(fp)) > 0
+        && (uint64)file_size >= sizeof(FastInterpCacheHeader)
+        && (uint64)file_size < UINT32_MAX && fseek(fp, 0, SEEK_SET) == 0
+        && (buf = wasm_runtime_malloc((uint32)file_size))) {
+        size = (uint64)file_size;
+        if (fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+            wasm_runtime_free(buf);
+            buf = NULL;
+        }
+    }
+    fclose(fp);
+    *p_mapped = false;
+#endif
+
+    if (buf)
+        *p_size = size;
+    else
+        LOG_WARNING("failed to read fast interpreter code cache %s",
+                    file_path);
+    return buf;
+}
+
+static void
+free_cache_buf(uint8 *buf, uint64 size, bool mapped)
+{
+#ifdef OS_ENABLE_FILE_MAPPING
+    if (mapped) {
+        os_munmap(buf, (size_t)size);
+        return;
+    }
+#endif
+    (void)size;
+    (void)mapped;
+    wasm_runtime_free(buf);
+}
+
+static bool
+check_cache_func(const FastInterpCacheFunc *cache_func, const uint8 *buf,
+                 uint64 size)
+{
+    const uint32 *relocs;
+    uint64 end;
+    uint32 i, pos, slot_size;
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    LabelValue label;
+#endif
+    uintptr_t offset;
+
+    end = (uint64)cache_func->code_offset + cache_func->code_size;
+    if ((cache_func->code_offset & 7) || end > size)
+        return false;
+    end = (uint64)cache_func->consts_offset
+          + (uint64)sizeof(uint32) * cache_func->const_cell_num;
+    if ((cache_func->consts_offset & 7) || end > size)
+        return false;
+    end = (uint64)cache_func->relocs_offset
+          + (uint64)sizeof(uint32) * cache_func->reloc_count;
+    if ((cache_func->relocs_offset & 3) || end > size)
+        return false;
+
+    relocs = (const uint32 *)(buf + cache_func->relocs_offset);
+    for (i = 0; i < cache_func->reloc_count; i++) {
+        pos = RELOC_POS(relocs[i]);
+        if (RELOC_IS_LABEL(relocs[i])) {
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+            slot_size = (uint32)sizeof(LabelValue);
+            if ((uint64)pos + slot_size > cache_func->code_size)
+                return false;
+            bh_memcpy_s(&label, slot_size,
+                        buf + cache_func->code_offset + pos, slot_size);
+            if (label >= WASM_INSTRUCTION_NUM)
+                return false;
+#else
+            return false;
+#endif
+        }
+        else {
+            slot_size = (uint32)sizeof(uintptr_t);
+            if ((uint64)pos + slot_size > cache_func->code_size)
+                return false;
+            bh_memcpy_s(&offset, slot_size,
+                        buf + cache_func->code_offset + pos, slot_size);
+            if (offset > (uintptr_t)cache_func->code_size + 1)
+                return false;
+        }
+    }
+    return true;
+}
+
+static void
+relocate_cache_func(const FastInterpCacheFunc *cache_func, uint8 *buf)
+{
+    const uint32 *relocs = (const uint32 *)(buf + cache_func->relocs_offset);
+    uint8 *code = buf + cache_func->code_offset, *addr;
+    uint32 i, pos;
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    void **handle_table = wasm_interp_get_handle_table();
+    LabelValue label;
+#endif
+    uintptr_t offset;
+
+    for (i = 0; i < cache_func->reloc_count; i++) {
+        pos = RELOC_POS(relocs[i]);
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+        if (RELOC_IS_LABEL(relocs[i])) {
+            bh_memcpy_s(&label, sizeof(LabelValue), code + pos,
+                        sizeof(LabelValue));
+            label = get_label_value(handle_table, (uint32)label);
+            bh_memcpy_s(code + pos, sizeof(LabelValue), &label,
+                        sizeof(LabelValue));
+            continue;
+        }
+#endif
+        bh_memcpy_s(&offset, sizeof(uintptr_t), code + pos,
+                    sizeof(uintptr_t));
+        addr = offset ? code + offset - 1 : NULL;
+        bh_memcpy_s(code + pos, sizeof(uint8 *), &addr, sizeof(uint8 *));
+    }
+}
+
+bool
+wasm_fast_interp_cache_load(WASMModule *module)
+{
+    const char *cache_dir = wasm_runtime_get_fast_interp_cache_dir();
+    char file_path[1024];
+    FastInterpCacheHeader header;
+    FastInterpCacheCounts counts;
+    FastInterpCacheFunc *cache_funcs;
+    WASMFunction *func;
+    uint8 *buf;
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+    uint8 data_digest[BH_SHA256_DIGEST_SIZE];
+    uint64 size = 0;
+    uint32 i;
+    bool mapped = false;
+
+    if (!cache_dir)
+        return false;
+
+    get_config_digest(config_digest);
+    if (!get_cache_file_path(module, cache_dir, config_digest, file_path,
+                             sizeof(file_path)))
+        return false;
+
+    if (!(buf = read_cache_file(file_path, &size, &mapped))) {
+        LOG_VERBOSE("fast interpreter code cache miss: %s", file_path);
+        return false;
+    }
+
+    /* The code loaded from the cache isn't validated again, so besides
+       the digests, check that the index spaces which the code refers to
+       are the same as the ones of the module being loaded */
+    get_module_counts(module, &counts);
+    bh_memcpy_s(&header, sizeof(FastInterpCacheHeader), buf,
+                sizeof(FastInterpCacheHeader));
+    if (header.magic != FAST_INTERP_CACHE_MAGIC
+        || header.version != FAST_INTERP_CACHE_VERSION
+        || memcmp(header.module_digest, module->fast_interp_cache_digest,
+                  BH_SHA256_DIGEST_SIZE)
+        || memcmp(header.config_digest, config_digest, BH_SHA256_DIGEST_SIZE)
+        || memcmp(&header.counts, &counts, sizeof(FastInterpCacheCounts))
+        || header.data_size != size - sizeof(FastInterpCacheHeader)
+        || (uint64)sizeof(FastInterpCacheFunc) * module->function_count
+               > header.data_size)
+        goto invalid;
+
+    bh_sha256(buf + sizeof(FastInterpCacheHeader), (size_t)header.data_size,
+              data_digest);
+    if (memcmp(header.data_digest, data_digest, BH_SHA256_DIGEST_SIZE))
+        goto invalid;
+
+    cache_funcs = (FastInterpCacheFunc *)(buf + sizeof(FastInterpCacheHeader));
+    for (i = 0; i < module->function_count; i++) {
+        if (!check_cache_func(&cache_funcs[i], buf, size))
+            goto invalid;
+    }
+
+    for (i = 0; i < module->function_count; i++) {
+        func = module->functions[i];
+        relocate_cache_func(&cache_funcs[i], buf);
+        func->code_compiled = buf + cache_funcs[i].code_offset;
+        func->code_compiled_size = cache_funcs[i].code_size;
+        func->consts = cache_funcs[i].const_cell_num > 0
+                           ? buf + cache_funcs[i].consts_offset
+                           : NULL;
+        func->const_cell_num = cache_funcs[i].const_cell_num;
+        func->max_stack_cell_num = cache_funcs[i].max_stack_cell_num;
+        func->max_block_num = cache_funcs[i].max_block_num;
+    }
+
+    if (header.flags & CACHE_FLAG_POSSIBLE_MEMORY_GROW)
+        module->possible_memory_grow = true;
+
+    module->fast_interp_cache_buf = buf;
+    module->fast_interp_cache_buf_size = size;
+    module->fast_interp_cache_buf_mapped = mapped;
+
+    LOG_VERBOSE("fast interpreter code cache hit: %s", file_path);
+    return true;
+
+invalid:
+    LOG_WARNING("ignore invalid fast interpreter code cache %s", file_path);
+    free_cache_buf(buf, size, mapped);
+    return false;
+}
+
+static void
+free_code_relocs(WASMModule *module)
+{
+    WASMFunction *func;
+    uint32 i;
+
+    for (i = 0; i < module->function_count; i++) {
+        func = module->functions[i];
+        if (func->code_relocs) {
+            wasm_runtime_free(func->code_relocs);
+            func->code_relocs = NULL;
+        }
+        func->code_reloc_count = 0;
+    }
+}
+
+/* Copy the code of the function to the cache file buffer and convert the
+   relocated slots to the values independent of the addresses */
+static bool
+emit_cache_func(const WASMFunction *func, const FastInterpCacheFunc *cache_func,
+                uint8 *buf, const void *label_map)
+{
+    uint8 *code = buf + cache_func->code_offset, *addr;
+    uint32 i, pos;
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    LabelValue label;
+    uint32 opcode;
+#endif
+    uintptr_t offset;
+
+    bh_memcpy_s(code, func->code_compiled_size, func->code_compiled,
+                func->code_compiled_size);
+    if (func->const_cell_num > 0)
+        bh_memcpy_s(buf + cache_func->consts_offset,
+                    (uint32)sizeof(uint32) * func->const_cell_num,
+                    func->consts, (uint32)sizeof(uint32) * func->const_cell_num);
+    if (func->code_reloc_count > 0)
+        bh_memcpy_s(buf + cache_func->relocs_offset,
+                    (uint32)sizeof(uint32) * func->code_reloc_count,
+                    func->code_relocs,
+                    (uint32)sizeof(uint32) * func->code_reloc_count);
+
+    for (i = 0; i < func->code_reloc_count; i++) {
+        pos = RELOC_POS(func->code_relocs[i]);
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+        if (RELOC_IS_LABEL(func->code_relocs[i])) {
+            bh_memcpy_s(&label, sizeof(LabelValue), code + pos,
+                        sizeof(LabelValue));
+            if (!lookup_label_opcode(label_map, label, &opcode))
+                return false;
+            label = (LabelValue)opcode;
+            bh_memcpy_s(code + pos, sizeof(LabelValue), &label,
+                        sizeof(LabelValue));
+            continue;
+        }
+#endif
+        bh_memcpy_s(&addr, sizeof(uint8 *), code + pos, sizeof(uint8 *));
+        if (addr && (addr < func->code_compiled
+                     || addr > func->code_compiled + func->code_compiled_size))
+            return false;
+        offset = addr ? (uintptr_t)(addr - func->code_compiled) + 1 : 0;
+        bh_memcpy_s(code + pos, sizeof(uintptr_t), &offset,
+                    sizeof(uintptr_t));
+    }
+
+    (void)label_map;
+    return true;
+}
+
+void
+wasm_fast_interp_cache_save(WASMModule *module)
+{
+    const char *cache_dir = wasm_runtime_get_fast_interp_cache_dir();
+    char file_path[1024];
+    FastInterpCacheHeader header = { 0 };
+    FastInterpCacheFunc *cache_funcs = NULL;
+    WASMFunction *func;
+    uint8 *buf = NULL;
+    uint8 config_digest[BH_SHA256_DIGEST_SIZE];
+    uint64 offset, total_size;
+    uint32 i;
+    BHCacheFileChunk chunk;
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    LabelMapEntry label_map[WASM_INSTRUCTION_NUM];
+#else
+    void *label_map = NULL;
+#endif
+
+    if (!cache_dir)
+        goto fail;
+
+    get_config_digest(config_digest);
+    if (!get_cache_file_path(module, cache_dir, config_digest, file_path,
+                             sizeof(file_path)))
+        goto fail;
+
+#if WASM_ENABLE_LABELS_AS_VALUES != 0
+    init_label_map(label_map);
+#endif
+
+    /* Lay out the functions after the header and the function table */
+    total_size = (uint64)sizeof(FastInterpCacheFunc) * module->function_count;
+    if (total_size >= UINT32_MAX
+        || !(cache_funcs = wasm_runtime_malloc((uint32)total_size + 1)))
+        goto fail;
+
+    offset = sizeof(FastInterpCacheHeader) + total_size;
+    for (i = 0; i < module->function_count; i++) {
+        func = module->functions[i];
+        offset = align_uint64(offset, 8);
+        cache_funcs[i].code_offset = (uint32)offset;
+        cache_funcs[i].code_size = func->code_compiled_size;
+        offset += func->code_compiled_size;
+        offset = align_uint64(offset, 8);
+        cache_funcs[i].consts_offset = (uint32)offset;
+        cache_funcs[i].const_cell_num = func->const_cell_num;
+        offset += (uint64)sizeof(uint32) * func->const_cell_num;
+        cache_funcs[i].relocs_offset = (uint32)offset;
+        cache_funcs[i].reloc_count = func->code_reloc_count;
+        offset += (uint64)sizeof(uint32) * func->code_reloc_count;
+        cache_funcs[i].max_stack_cell_num = func->max_stack_cell_num;
+        cache_funcs[i].max_block_num = func->max_block_num;
+        if (offset >= UINT32_MAX)
+            goto fail;
+    }
+    total_size = offset;
+
+    if (!(buf = wasm_runtime_malloc((uint32)total_size)))
+        goto fail;
+    memset(buf, 0, (uint32)total_size);
+
+    for (i = 0; i < module->function_count; i++) {
+        if (!emit_cache_func(module->functions[i], &cache_funcs[i], buf,
+                             label_map)) {
+            LOG_WARNING("failed to relocate the code of function %u for "
+                        "fast interpreter code cache",
+                        i);
+            goto fail;
+        }
+    }
+    bh_memcpy_s(buf + sizeof(FastInterpCacheHeader),
+                (uint32)(total_size - sizeof(FastInterpCacheHeader)),
+                cache_funcs,
+                (uint32)sizeof(FastInterpCacheFunc) * module->function_count);
+
+    header.magic = FAST_INTERP_CACHE_MAGIC;
+    header.version = FAST_INTERP_CACHE_VERSION;
+    bh_memcpy_s(header.module_digest, sizeof(header.module_digest),
+                module->fast_interp_cache_digest, BH_SHA256_DIGEST_SIZE);
+    bh_memcpy_s(header.config_digest, sizeof(header.config_digest),
+                config_digest, BH_SHA256_DIGEST_SIZE);
+    get_module_counts(module, &header.counts);
+    header.flags =
+        module->possible_memory_grow ? CACHE_FLAG_POSSIBLE_MEMORY_GROW : 0;
+    header.data_size = total_size - sizeof(FastInterpCacheHeader);
+    bh_sha256(buf + sizeof(FastInterpCacheHeader), (size_t)header.data_size,
+              header.data_digest);
+    bh_memcpy_s(buf, sizeof(FastInterpCacheHeader), &header,
+                sizeof(FastInterpCacheHeader));
+
+    chunk.data = buf;
+    chunk.size = total_size;
+    if (!bh_cache_file_write(file_path, &chunk, 1)) {
+        LOG_WARNING("failed to write fast interpreter code cache file %s",
+                    file_path);
+        goto fail;
+    }
+
+    LOG_VERBOSE("fast interpreter code cache saved: %s", file_path);
+
+fail:
+    if (buf)
+        wasm_runtime_free(buf);
+    if (cache_funcs)
+        wasm_runtime_free(cache_funcs);
+    free_code_relocs(module);
+}
+
+void
+wasm_fast_interp_cache_unload(WASMModule *module)
+{
+    if (module->fast_interp_cache_buf) {
+        free_cache_buf(module->fast_interp_cache_buf,
+                       module->fast_interp_cache_buf_size,
+                       module->fast_interp_cache_buf_mapped);
+        module->fast_interp_cache_buf = NULL;
+    }
+}
+
+#endif /* end of WASM_ENABLE_FAST_INTERP_CACHE != 0 */
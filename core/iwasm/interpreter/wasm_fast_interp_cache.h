@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _WASM_FAST_INTERP_CACHE_H
+#define _WASM_FAST_INTERP_CACHE_H
+
+#include "wasm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+
+/**
+ * Look up the pre-compiled code of the module in the fast interpreter
+ * code cache, and set the compiled code, the consts and the frame sizes
+ * of the functions if it is found and valid
+ *
+ * @param module the module whose sections have been loaded
+ *
+ * @return true if the cached code was loaded, false otherwise, in which
+ *         case the functions should be pre-compiled as usual
+ */
+bool
+wasm_fast_interp_cache_load(WASMModule *module);
+
+/**
+ * Save the pre-compiled code of the module to the fast interpreter code
+ * cache and free the relocations recorded by the loader, note that failing
+ * to save the code isn't treated as an error
+ */
+void
+wasm_fast_interp_cache_save(WASMModule *module);
+
+/**
+ * Release the cache file loaded by wasm_fast_interp_cache_load
+ */
+void
+wasm_fast_interp_cache_unload(WASMModule *module);
+
+#endif /* end of WASM_ENABLE_FAST_INTERP_CACHE != 0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _WASM_FAST_INTERP_CACHE_H */
@@ -1332,6 +1332,195 @@ fast_jit_invoke_native(WASMExecEnv *exec_env, uint32 func_idx,
 }
 #endif
 
+#if WASM_ENABLE_FAST_JIT != 0
+/*
+ * ASAN is not designed to work with custom stack unwind or other low-level
+ * things. Ignore a function that does some low-level magic. (e.g. walking
+ * through the thread's stack bypassing the frame boundaries)
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((no_sanitize_address))
+#endif
+static void
+fast_jit_switch_to_jitted(WASMModuleInstance *module_inst,
+                          WASMExecEnv *exec_env,
+                          WASMFunctionInstance *function,
+                          WASMInterpFrame *frame, WASMInterpFrame *ret_frame,
+                          void *jitted_addr)
+{
+    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
+    JitInterpSwitchInfo info;
+    WASMFuncType *func_type = function->u.func->func_type;
+    uint8 type = func_type->result_count
+                     ? func_type->types[func_type->param_count]
+                     : VALUE_TYPE_VOID;
+    uint32 func_idx = (uint32)(function - module_inst->e->functions);
+    int32 action;
+
+#if WASM_ENABLE_REF_TYPES != 0
+    if (type == VALUE_TYPE_EXTERNREF || type == VALUE_TYPE_FUNCREF)
+        type = VALUE_TYPE_I32;
+#endif
+
+    /* frame is passed to the jitted code, which is the caller's frame
+       when calling the function, and the function's own frame when
+       entering a loop body. The jitted code returns to ret_frame. */
+    info.out.ret.last_return_type = type;
+    info.frame = frame;
+    ret_frame->jitted_return_addr =
+        (uint8 *)jit_globals->return_to_interp_from_jitted;
+    action = jit_interp_switch_to_jitted(exec_env, &info, func_idx,
+                                         jitted_addr);
+    bh_assert(action == JIT_INTERP_ACTION_NORMAL
+              || (action == JIT_INTERP_ACTION_THROWN
+                  && wasm_copy_exception(
+                      (WASMModuleInstance *)exec_env->module_inst, NULL)));
+
+    /* Get the return values form info.out.ret */
+    if (func_type->result_count) {
+        switch (type) {
+            case VALUE_TYPE_I32:
+                *(ret_frame->sp - function->ret_cell_num) =
+                    info.out.ret.ival[0];
+                break;
+            case VALUE_TYPE_I64:
+                *(ret_frame->sp - function->ret_cell_num) =
+                    info.out.ret.ival[0];
+                *(ret_frame->sp - function->ret_cell_num + 1) =
+                    info.out.ret.ival[1];
+                break;
+            case VALUE_TYPE_F32:
+                *(ret_frame->sp - function->ret_cell_num) =
+                    info.out.ret.fval[0];
+                break;
+            case VALUE_TYPE_F64:
+                *(ret_frame->sp - function->ret_cell_num) =
+                    info.out.ret.fval[0];
+                *(ret_frame->sp - function->ret_cell_num + 1) =
+                    info.out.ret.fval[1];
+                break;
+#if WASM_ENABLE_SIMD != 0
+            case VALUE_TYPE_V128:
+                /* v128 results are always stored to the frame by the
+                   jitted code */
+                break;
+#endif
+            default:
+                bh_assert(0);
+                break;
+        }
+    }
+    (void)action;
+}
+
+static void
+fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
+                            WASMExecEnv *exec_env,
+                            WASMFunctionInstance *function,
+                            WASMInterpFrame *frame);
+
+#if WASM_ENABLE_LAZY_JIT != 0
+/**
+ * Whether the function is kept in the interpreter as it isn't hot enough
+ * to be compiled by Fast JIT. Functions using v128 values are never kept,
+ * as the classic interpreter doesn't support SIMD.
+ */
+static bool
+fast_jit_tierup_pending(WASMModuleInstance *module_inst,
+                        WASMFunctionInstance *function)
+{
+    uint32 func_idx = (uint32)(function - module_inst->e->functions);
+
+#if WASM_ENABLE_SIMD != 0
+    if (function->u.func->has_v128)
+        return false;
+#endif
+
+    return jit_compiler_get_jit_globals()->tierup_threshold > 0
+                   && !jit_compiler_is_compiled(module_inst->module, func_idx)
+               ? true
+               : false;
+}
+
+/**
+ * Count a call or a loop iteration of the function run by the interpreter
+ * and compile the function when the count reaches the tier-up threshold.
+ * Return true if the function is compiled and should run the jitted code.
+ */
+static bool
+fast_jit_tierup_check(WASMModuleInstance *module_inst,
+                      WASMFunctionInstance *function)
+{
+    WASMFunction *func = function->u.func;
+    uint32 func_idx = (uint32)(function - module_inst->e->functions);
+
+    if (!fast_jit_tierup_pending(module_inst, function))
+        return true;
+
+    /* The counter isn't atomic as a lost update only delays tier-up */
+    if (func->fast_jit_tierup_failed
+        || ++func->fast_jit_hotness
+               < jit_compiler_get_jit_globals()->tierup_threshold)
+        return false;
+
+    if (!jit_compiler_compile(module_inst->module, func_idx)) {
+        /* Don't try again, keep running the function in interpreter */
+        LOG_VERBOSE("Fast JIT: failed to tier up function %u\n", func_idx);
+        func->fast_jit_tierup_failed = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * On-stack replacement: switch the execution of the function's interpreter
+ * frame to its jitted code at the loop body beginning at ip, which takes the
+ * frame as its own frame and returns from it. Return false if the function
+ * isn't compiled yet or the loop body can't be entered.
+ */
+static bool
+fast_jit_osr_enter_loop(WASMModuleInstance *module_inst,
+                        WASMExecEnv *exec_env, WASMInterpFrame *frame,
+                        uint8 *ip)
+{
+    WASMFunctionInstance *function = frame->function;
+    WASMFunction *func = function->u.func;
+    WASMFastJITOSREntry *osr_entries;
+    void *jitted_addr = NULL;
+    uint32 i;
+
+    if (!fast_jit_tierup_check(module_inst, function))
+        return false;
+
+    /* Pairs with the release store of the compiler thread, the entry count
+       and the frame size are set before the entries are published */
+    osr_entries =
+        __atomic_load_n(&func->fast_jit_osr_entries, __ATOMIC_ACQUIRE);
+    if (!osr_entries)
+        return false;
+
+    for (i = 0; i < func->fast_jit_osr_entry_count; i++) {
+        if (osr_entries[i].ip == ip) {
+            jitted_addr = osr_entries[i].jitted_addr;
+            break;
+        }
+    }
+
+    /* The jitted frame may be larger than the interpreter frame, and the
+       outs area of the callees follows it */
+    if (!jitted_addr
+        || (uint8 *)frame + (uint64)func->fast_jit_frame_size * 2
+               > exec_env->wasm_stack.top_boundary)
+        return false;
+
+    exec_env->wasm_stack.top = (uint8 *)frame + func->fast_jit_frame_size;
+    fast_jit_switch_to_jitted(module_inst, exec_env, function, frame,
+                              frame->prev_frame, jitted_addr);
+    return true;
+}
+#endif /* end of WASM_ENABLE_LAZY_JIT != 0 */
+#endif /* end of WASM_ENABLE_FAST_JIT != 0 */
+
 #if WASM_ENABLE_MULTI_MODULE != 0
 static void
 wasm_interp_call_func_bytecode(WASMModuleInstance *module,
@@ -1611,6 +1800,14 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
 #if WASM_ENABLE_EXCE_HANDLING != 0
     int32_t exception_tag_index;
+#endif
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+    /* Whether to tier up the hot functions to the jitted code */
+    RunningMode running_mode =
+        wasm_runtime_get_running_mode((WASMModuleInstanceCommon *)module);
+    bool fast_jit_tierup =
+        (running_mode == Mode_Fast_JIT || running_mode == Mode_Multi_Tier_JIT)
+        && jit_compiler_get_jit_globals()->tierup_threshold > 0;
 #endif
     uint8 value_type;
 #if !defined(OS_ENABLE_HW_BOUND_CHECK) \
@@ -2237,6 +2434,27 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                     }
                     frame_ip = end_addr;
                 }
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+                else if (fast_jit_tierup
+                         && frame_ip == (frame_csp - 1)->begin_addr) {
+                    /* Back edge of a loop, continue executing the function
+                       in the jitted code if it is hot */
+                    SYNC_ALL_TO_FRAME();
+                    if (fast_jit_osr_enter_loop(module, exec_env, frame,
+                                                frame_ip)) {
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_BULK_MEMORY != 0
+                        if (memory)
+                            linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
+#endif
+                        if (wasm_copy_exception(module, NULL))
+                            goto got_exception;
+                        /* The jitted code has returned from the frame */
+                        goto return_func;
+                    }
+                }
+#endif
                 HANDLE_OP_END();
             }
 
@@ -6635,6 +6853,12 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
 
     call_func_from_entry:
     {
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        if (!wasm_ensure_func_validated(module, cur_func)) {
+            frame = prev_frame;
+            goto got_exception;
+        }
+#endif
         if (cur_func->is_import_func) {
 #if WASM_ENABLE_MULTI_MODULE != 0
             if (cur_func->import_func_inst) {
@@ -6758,6 +6982,40 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 goto got_exception;
             }
         }
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
+        else if (fast_jit_tierup && fast_jit_tierup_check(module, cur_func)) {
+            /* The function is hot and compiled, call its jitted code */
+            fast_jit_call_func_bytecode(module, exec_env, cur_func,
+                                        prev_frame);
+            if (!prev_frame->ip) {
+                /* Called from native. */
+                return;
+            }
+#if WASM_ENABLE_TAIL_CALL != 0 || WASM_ENABLE_GC != 0
+            if (is_return_call) {
+                /* the frame was freed before tail calling and
+                   the prev_frame was set as exec_env's cur_frame,
+                   so here we recover context from prev_frame */
+                RECOVER_CONTEXT(prev_frame);
+            }
+            else
+#endif
+            {
+                prev_frame = frame->prev_frame;
+                cur_func = frame->function;
+                UPDATE_ALL_FROM_FRAME();
+            }
+
+#if !defined(OS_ENABLE_HW_BOUND_CHECK)              \
+    || WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS == 0 \
+    || WASM_ENABLE_BULK_MEMORY != 0
+            if (memory)
+                linear_mem_size = GET_LINEAR_MEMORY_SIZE(memory);
+#endif
+            if (wasm_copy_exception(module, NULL))
+                goto got_exception;
+        }
+#endif
         else {
             WASMFunction *cur_wasm_func = cur_func->u.func;
             WASMFuncType *func_type = cur_wasm_func->func_type;
@@ -6919,7 +7177,8 @@ wasm_interp_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
             if (frame_ref[i]) {
                 gc_obj = GET_REF_FROM_ADDR(frame->lp + i);
                 if (wasm_obj_is_created_from_heap(gc_obj)) {
-                    if (mem_allocator_add_root((mem_allocator_t)heap, gc_obj)) {
+                    if (mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                    frame->lp + i)) {
                         return false;
                     }
                 }
@@ -6935,35 +7194,15 @@ wasm_interp_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
 #endif
 
 #if WASM_ENABLE_FAST_JIT != 0
-/*
- * ASAN is not designed to work with custom stack unwind or other low-level
- * things. Ignore a function that does some low-level magic. (e.g. walking
- * through the thread's stack bypassing the frame boundaries)
- */
-#if defined(__GNUC__) || defined(__clang__)
-__attribute__((no_sanitize_address))
-#endif
 static void
 fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
                             WASMExecEnv *exec_env,
                             WASMFunctionInstance *function,
                             WASMInterpFrame *frame)
 {
-    JitGlobals *jit_globals = jit_compiler_get_jit_globals();
-    JitInterpSwitchInfo info;
     WASMModule *module = module_inst->module;
-    WASMFuncType *func_type = function->u.func->func_type;
-    uint8 type = func_type->result_count
-                     ? func_type->types[func_type->param_count]
-                     : VALUE_TYPE_VOID;
     uint32 func_idx = (uint32)(function - module_inst->e->functions);
     uint32 func_idx_non_import = func_idx - module->import_function_count;
-    int32 action;
-
-#if WASM_ENABLE_REF_TYPES != 0
-    if (type == VALUE_TYPE_EXTERNREF || type == VALUE_TYPE_FUNCREF)
-        type = VALUE_TYPE_I32;
-#endif
 
 #if WASM_ENABLE_LAZY_JIT != 0
     if (!jit_compiler_compile(module, func_idx)) {
@@ -6974,44 +7213,9 @@ fast_jit_call_func_bytecode(WASMModuleInstance *module_inst,
     bh_assert(jit_compiler_is_compiled(module, func_idx));
 
     /* Switch to jitted code to call the jit function */
-    info.out.ret.last_return_type = type;
-    info.frame = frame;
-    frame->jitted_return_addr =
-        (uint8 *)jit_globals->return_to_interp_from_jitted;
-    action = jit_interp_switch_to_jitted(
-        exec_env, &info, func_idx,
+    fast_jit_switch_to_jitted(
+        module_inst, exec_env, function, frame, frame,
         module_inst->fast_jit_func_ptrs[func_idx_non_import]);
-    bh_assert(action == JIT_INTERP_ACTION_NORMAL
-              || (action == JIT_INTERP_ACTION_THROWN
-                  && wasm_copy_exception(
-                      (WASMModuleInstance *)exec_env->module_inst, NULL)));
-
-    /* Get the return values form info.out.ret */
-    if (func_type->result_count) {
-        switch (type) {
-            case VALUE_TYPE_I32:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.ival[0];
-                break;
-            case VALUE_TYPE_I64:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.ival[0];
-                *(frame->sp - function->ret_cell_num + 1) =
-                    info.out.ret.ival[1];
-                break;
-            case VALUE_TYPE_F32:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.fval[0];
-                break;
-            case VALUE_TYPE_F64:
-                *(frame->sp - function->ret_cell_num) = info.out.ret.fval[0];
-                *(frame->sp - function->ret_cell_num + 1) =
-                    info.out.ret.fval[1];
-                break;
-            default:
-                bh_assert(0);
-                break;
-        }
-    }
-    (void)action;
-    (void)func_idx;
 }
 #endif /* end of WASM_ENABLE_FAST_JIT != 0 */
 
@@ -7504,7 +7708,15 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
         }
 #if WASM_ENABLE_FAST_JIT != 0
         else if (running_mode == Mode_Fast_JIT) {
-            fast_jit_call_func_bytecode(module_inst, exec_env, function, frame);
+#if WASM_ENABLE_LAZY_JIT != 0
+            /* Interpret the function until it becomes hot */
+            if (fast_jit_tierup_pending(module_inst, function))
+                wasm_interp_call_func_bytecode(module_inst, exec_env,
+                                               function, frame);
+            else
+#endif
+                fast_jit_call_func_bytecode(module_inst, exec_env, function,
+                                            frame);
         }
 #endif
 #if WASM_ENABLE_JIT != 0
@@ -7524,6 +7736,11 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
                 llvm_jit_call_func_bytecode(module_inst, exec_env, function,
                                             argc, argv);
             }
+            else if (fast_jit_tierup_pending(module_inst, function)) {
+                /* Interpret the function until it becomes hot */
+                wasm_interp_call_func_bytecode(module_inst, exec_env,
+                                               function, frame);
+            }
             else {
                 fast_jit_call_func_bytecode(module_inst, exec_env, function,
                                             frame);
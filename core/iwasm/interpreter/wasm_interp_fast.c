@@ -1137,6 +1137,16 @@ sign_ext_32_64(int32 val)
     return val;
 }
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+/* The const cell num of a function validated lazily is only known after
+   the function instances were created, read it from the function */
+#define GET_FUNC_CONST_CELL_NUM(func_inst)                     \
+    ((func_inst)->is_import_func ? (func_inst)->const_cell_num \
+                                 : (func_inst)->u.func->const_cell_num)
+#else
+#define GET_FUNC_CONST_CELL_NUM(func_inst) ((func_inst)->const_cell_num)
+#endif
+
 static inline void
 word_copy(uint32 *dest, uint32 *src, unsigned num)
 {
@@ -1393,6 +1403,32 @@ wasm_interp_call_func_import(WASMModuleInstance *module_inst,
     } while (0)
 #endif
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#if WASM_ENABLE_THREAD_MGR != 0
+#define CHECK_SUSPEND_FLAGS_FOR_BR() CHECK_SUSPEND_FLAGS()
+#else
+#define CHECK_SUSPEND_FLAGS_FOR_BR() (void)0
+#endif
+
+/* br_if with the condition evaluated by the fused opcode, the br info
+   follows the operand offsets of the opcode */
+#define FUSED_BR_IF(operand_size)     \
+    do {                              \
+        CHECK_SUSPEND_FLAGS_FOR_BR(); \
+        frame_ip += operand_size;     \
+        if (cond)                     \
+            goto recover_br_info;     \
+        SKIP_BR_INFO();               \
+    } while (0)
+
+#define DEF_OP_CMP_BR_IF(src_type, cond_op)                         \
+    do {                                                            \
+        cond = (uint32)(GET_OPERAND(src_type, I32, 2)               \
+                            cond_op GET_OPERAND(src_type, I32, 0)); \
+        FUSED_BR_IF(4);                                             \
+    } while (0)
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS */
+
 #if WASM_ENABLE_OPCODE_COUNTER != 0
 typedef struct OpcodeInfo {
     char *name;
@@ -1413,11 +1449,13 @@ wasm_interp_dump_op_count()
 {
     uint32 i;
     uint64 total_count = 0;
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
+    /* Count all the dispatched opcodes, including the extended opcodes
+       emitted by the loader, e.g. the superinstructions */
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
         total_count += opcode_table[i].count;
 
     os_printf("total opcode count: %ld\n", total_count);
-    for (i = 0; i < WASM_OP_IMPDEP; i++)
+    for (i = 0; i < WASM_INSTRUCTION_NUM; i++)
         if (opcode_table[i].count > 0)
             os_printf("\t\t%s count:\t\t%ld,\t\t%.2f%%\n", opcode_table[i].name,
                       opcode_table[i].count,
@@ -1662,6 +1700,75 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 HANDLE_OP_END();
             }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+            HANDLE_OP(EXT_OP_I32_EQZ_BR_IF)
+            {
+                cond = (uint32)(GET_OPERAND(int32, I32, 0) == 0);
+                FUSED_BR_IF(2);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_EQ_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, ==);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_NE_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, !=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GT_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_LE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, <=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_S_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(int32, >=);
+                HANDLE_OP_END();
+            }
+
+            HANDLE_OP(EXT_OP_I32_GE_U_BR_IF)
+            {
+                DEF_OP_CMP_BR_IF(uint32, >=);
+                HANDLE_OP_END();
+            }
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS */
+
             HANDLE_OP(WASM_OP_BR_TABLE)
             {
                 uint32 arity, br_item_size;
@@ -7555,6 +7662,11 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         uint32 *lp_base = NULL, *lp = NULL;
         int i;
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        if (!wasm_ensure_func_validated(module, cur_func))
+            goto got_exception;
+#endif
+
         if (cur_func->param_cell_num > 0
             && !(lp_base = lp = wasm_runtime_malloc(cur_func->param_cell_num
                                                     * sizeof(uint32)))) {
@@ -7575,7 +7687,7 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
                 lp++;
             }
         }
-        frame->lp = frame->operand + cur_func->const_cell_num;
+        frame->lp = frame->operand + GET_FUNC_CONST_CELL_NUM(cur_func);
         if (lp - lp_base > 0) {
             word_copy(frame->lp, lp_base, lp - lp_base);
         }
@@ -7595,17 +7707,24 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
         WASMInterpFrame *outs_area = wasm_exec_env_wasm_stack_top(exec_env);
         int i;
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        if (!wasm_ensure_func_validated(module, cur_func))
+            goto got_exception;
+#endif
+
 #if WASM_ENABLE_MULTI_MODULE != 0
         if (cur_func->is_import_func) {
             outs_area->lp = outs_area->operand
                             + (cur_func->import_func_inst
-                                   ? cur_func->import_func_inst->const_cell_num
+                                   ? GET_FUNC_CONST_CELL_NUM(
+                                       cur_func->import_func_inst)
                                    : 0);
         }
         else
 #endif
         {
-            outs_area->lp = outs_area->operand + cur_func->const_cell_num;
+            outs_area->lp = outs_area->operand
+                            + GET_FUNC_CONST_CELL_NUM(cur_func);
         }
 
         if ((uint8 *)(outs_area->lp + cur_func->param_cell_num)
@@ -7719,7 +7838,8 @@ wasm_interp_call_func_bytecode(WASMModuleInstance *module,
             cell_num_of_local_stack = cur_func->param_cell_num
                                       + cur_func->local_cell_num
                                       + cur_wasm_func->max_stack_cell_num;
-            all_cell_num = cur_func->const_cell_num + cell_num_of_local_stack;
+            all_cell_num =
+                cur_wasm_func->const_cell_num + cell_num_of_local_stack;
 #if WASM_ENABLE_GC != 0
             /* area of frame_ref */
             all_cell_num += (cell_num_of_local_stack + 3) / 4;
@@ -7868,7 +7988,8 @@ wasm_interp_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
             if (frame_ref[i]) {
                 gc_obj = GET_REF_FROM_ADDR(frame->lp + i);
                 if (wasm_obj_is_created_from_heap(gc_obj)) {
-                    if (mem_allocator_add_root((mem_allocator_t)heap, gc_obj)) {
+                    if (mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                    frame->lp + i)) {
                         return false;
                     }
                 }
@@ -7927,6 +8048,11 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
 #endif
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (!wasm_ensure_func_validated(module_inst, function))
+        return;
+#endif
+
     if (!(frame =
               ALLOC_FRAME(exec_env, frame_size, (WASMInterpFrame *)prev_frame)))
         return;
@@ -7943,7 +8069,8 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
 #endif
     frame->ret_offset = 0;
 
-    if ((uint8 *)(outs_area->operand + function->const_cell_num + argc)
+    if ((uint8 *)(outs_area->operand + GET_FUNC_CONST_CELL_NUM(function)
+                  + argc)
         > exec_env->wasm_stack.top_boundary) {
         wasm_set_exception((WASMModuleInstance *)exec_env->module_inst,
                            "wasm operand stack overflow");
@@ -7951,7 +8078,8 @@ wasm_interp_call_wasm(WASMModuleInstance *module_inst, WASMExecEnv *exec_env,
     }
 
     if (argc > 0)
-        word_copy(outs_area->operand + function->const_cell_num, argv, argc);
+        word_copy(outs_area->operand + GET_FUNC_CONST_CELL_NUM(function), argv,
+                  argc);
 
     wasm_exec_env_set_cur_frame(exec_env, frame);
 
@@ -24,6 +24,10 @@
 #endif
 #if WASM_ENABLE_JIT != 0
 #include "../compilation/aot_llvm.h"
+#include "../compilation/aot_jit_cache.h"
+#endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+#include "wasm_fast_interp_cache.h"
 #endif
 
 #ifndef TRACE_WASM_LOADER
@@ -320,7 +324,7 @@ is_byte_a_type(uint8 type)
 
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
 static V128
 read_i8x16(uint8 *p_buf, char *error_buf, uint32 error_buf_size)
 {
@@ -334,7 +338,7 @@ read_i8x16(uint8 *p_buf, char *error_buf, uint32 error_buf_size)
     return result;
 }
 #endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) || \
-          (WASM_ENABLE_FAST_INTERP != 0) */
+          (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 static void *
@@ -826,7 +830,7 @@ load_init_expr(WASMModule *module, const uint8 **p_buf, const uint8 *buf_end,
                 break;
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
             /* v128.const */
             case INIT_EXPR_TYPE_V128_CONST:
             {
@@ -860,7 +864,7 @@ load_init_expr(WASMModule *module, const uint8 **p_buf, const uint8 *buf_end,
                 break;
             }
 #endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) || \
-          (WASM_ENABLE_FAST_INTERP != 0) */
+          (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 #if WASM_ENABLE_EXTENDED_CONST_EXPR != 0
             case INIT_EXPR_TYPE_I32_ADD:
@@ -3836,6 +3840,236 @@ init_function_local_offsets(WASMFunction *func, char *error_buf,
     return true;
 }
 
+/* Load the local declarations and the code body of a function from its
+   entry of the code section, and move *p_buf to the next entry */
+static bool
+load_function_body(const uint8 **p_buf, const uint8 *buf_code_end,
+                   WASMModule *module, uint32 func_idx,
+                   WASMFuncType *func_type, char *error_buf,
+                   uint32 error_buf_size)
+{
+    const uint8 *p_code = *p_buf, *p_code_end, *p_code_save;
+    uint64 total_size;
+    uint32 code_size, j, k, local_type_index;
+    uint32 local_count, local_set_count, sub_local_count, local_cell_num;
+    uint8 type;
+    WASMFunction *func;
+#if WASM_ENABLE_GC != 0
+    bool need_ref_type_map;
+    WASMRefType ref_type;
+    uint32 ref_type_map_count = 0, t = 0;
+#endif
+
+    read_leb_uint32(p_code, buf_code_end, code_size);
+    if (code_size == 0 || p_code + code_size > buf_code_end) {
+        set_error_buf(error_buf, error_buf_size, "invalid function code size");
+        return false;
+    }
+
+    /* Resolve local set count */
+    p_code_end = p_code + code_size;
+#if WASM_ENABLE_BRANCH_HINTS != 0
+    uint8 *p_body_start = (uint8 *)p_code;
+#endif
+    local_count = 0;
+    read_leb_uint32(p_code, buf_code_end, local_set_count);
+    p_code_save = p_code;
+
+    /* Calculate total local count */
+    for (j = 0; j < local_set_count; j++) {
+        read_leb_uint32(p_code, buf_code_end, sub_local_count);
+        if (sub_local_count > UINT32_MAX - local_count) {
+            set_error_buf(error_buf, error_buf_size, "too many locals");
+            return false;
+        }
+#if WASM_ENABLE_GC == 0
+        CHECK_BUF(p_code, buf_code_end, 1);
+        /* 0x7F/0x7E/0x7D/0x7C */
+        type = read_uint8(p_code);
+        local_count += sub_local_count;
+#if WASM_ENABLE_WAMR_COMPILER != 0
+        /* If any value's type is v128, mark the module as SIMD used */
+        if (type == VALUE_TYPE_V128)
+            module->is_simd_used = true;
+#endif
+#else
+        if (!resolve_value_type(&p_code, buf_code_end, module,
+                                module->type_count, &need_ref_type_map,
+                                &ref_type, false, error_buf, error_buf_size)) {
+            return false;
+        }
+        local_count += sub_local_count;
+        if (need_ref_type_map)
+            ref_type_map_count += sub_local_count;
+#endif
+    }
+
+    /* Code size in code entry can't be smaller than size of vec(locals)
+     * + expr(at least 1 for opcode end). And expressions are encoded by
+     * their instruction sequence terminated with an explicit 0x0B
+     * opcode for end. */
+    if (p_code_end <= p_code || *(p_code_end - 1) != WASM_OP_END) {
+        set_error_buf(
+            error_buf, error_buf_size,
+            "section size mismatch: function body END opcode expected");
+        return false;
+    }
+
+    /* Alloc memory, layout: function structure + local types */
+    code_size = (uint32)(p_code_end - p_code);
+
+    total_size = sizeof(WASMFunction) + (uint64)local_count;
+    if (!(func = loader_malloc(total_size, error_buf, error_buf_size))) {
+        return false;
+    }
+#if WASM_ENABLE_STREAM_LOADER != 0
+    if (module->functions[func_idx]) {
+        /* Replace the function declared by the stream loader before its
+           body was received, and keep the fields set since then */
+        bh_memcpy_s(func, (uint32)total_size, module->functions[func_idx],
+                    sizeof(WASMFunction));
+        wasm_runtime_free(module->functions[func_idx]);
+    }
+#endif
+    module->functions[func_idx] = func;
+#if WASM_ENABLE_GC != 0
+    if (ref_type_map_count > 0) {
+        if (ref_type_map_count > UINT16_MAX) {
+            set_error_buf(error_buf, error_buf_size,
+                          "ref type count too large");
+            return false;
+        }
+        total_size = sizeof(WASMRefTypeMap) * (uint64)ref_type_map_count;
+        if (!(func->local_ref_type_maps =
+                  loader_malloc(total_size, error_buf, error_buf_size))) {
+            return false;
+        }
+        func->local_ref_type_map_count = ref_type_map_count;
+    }
+#endif
+
+    /* Set function type, local count, code size and code body */
+    func->func_type = func_type;
+    func->local_count = local_count;
+    if (local_count > 0)
+        func->local_types = (uint8 *)func + sizeof(WASMFunction);
+    func->code_size = code_size;
+#if WASM_ENABLE_BRANCH_HINTS != 0
+    func->code_body_begin = p_body_start;
+#endif
+    /*
+     * we shall make a copy of code body [p_code, p_code + code_size]
+     * when we are worrying about inappropriate releasing behaviour.
+     * all code bodies are actually in a buffer which user allocates in
+     * their embedding environment and we don't have power over them.
+     * it will be like:
+     * code_body_cp = malloc(code_size);
+     * memcpy(code_body_cp, p_code, code_size);
+     * func->code = code_body_cp;
+     */
+    func->code = (uint8 *)p_code;
+
+    /* Load each local type */
+    p_code = p_code_save;
+    local_type_index = 0;
+    for (j = 0; j < local_set_count; j++) {
+        read_leb_uint32(p_code, buf_code_end, sub_local_count);
+        /* Note: sub_local_count is allowed to be 0 */
+        if (local_type_index > UINT32_MAX - sub_local_count
+            || local_type_index + sub_local_count > local_count) {
+            set_error_buf(error_buf, error_buf_size, "invalid local count");
+            return false;
+        }
+#if WASM_ENABLE_GC == 0
+        CHECK_BUF(p_code, buf_code_end, 1);
+        /* 0x7F/0x7E/0x7D/0x7C */
+        type = read_uint8(p_code);
+        if (!is_valid_value_type_for_interpreter(type)) {
+            if (type == VALUE_TYPE_V128)
+                set_error_buf(error_buf, error_buf_size,
+                              "v128 value type requires simd feature");
+            else if (type == VALUE_TYPE_FUNCREF
+                     || type == VALUE_TYPE_EXTERNREF)
+                set_error_buf(error_buf, error_buf_size,
+                              "ref value type requires "
+                              "reference types feature");
+            else
+                set_error_buf_v(error_buf, error_buf_size,
+                                "invalid local type 0x%02X", type);
+            return false;
+        }
+#else
+        if (!resolve_value_type(&p_code, buf_code_end, module,
+                                module->type_count, &need_ref_type_map,
+                                &ref_type, false, error_buf, error_buf_size)) {
+            return false;
+        }
+        if (need_ref_type_map) {
+            WASMRefType *ref_type_tmp;
+            if (!(ref_type_tmp = reftype_set_insert(module->ref_type_set,
+                                                    &ref_type, error_buf,
+                                                    error_buf_size))) {
+                return false;
+            }
+            for (k = 0; k < sub_local_count; k++) {
+                func->local_ref_type_maps[t + k].ref_type = ref_type_tmp;
+                func->local_ref_type_maps[t + k].index = local_type_index + k;
+            }
+            t += sub_local_count;
+        }
+        type = ref_type.ref_type;
+#endif
+        for (k = 0; k < sub_local_count; k++) {
+            func->local_types[local_type_index++] = type;
+        }
+#if WASM_ENABLE_WAMR_COMPILER != 0
+        if (type == VALUE_TYPE_V128)
+            module->is_simd_used = true;
+        else if (type == VALUE_TYPE_FUNCREF || type == VALUE_TYPE_EXTERNREF)
+            module->is_ref_types_used = true;
+#endif
+    }
+
+    bh_assert(local_type_index == func->local_count);
+#if WASM_ENABLE_GC != 0
+    bh_assert(t == func->local_ref_type_map_count);
+#if TRACE_WASM_LOADER != 0
+    os_printf("func %u, local types: [", func_idx);
+    k = 0;
+    for (j = 0; j < func->local_count; j++) {
+        WASMRefType *ref_type_tmp = NULL;
+        if (wasm_is_type_multi_byte_type(func->local_types[j])) {
+            bh_assert(j == func->local_ref_type_maps[k].index);
+            ref_type_tmp = func->local_ref_type_maps[k++].ref_type;
+        }
+        wasm_dump_value_type(func->local_types[j], ref_type_tmp);
+        if (j < func->local_count - 1)
+            os_printf(" ");
+    }
+    os_printf("]\n");
+#endif
+#endif
+
+    func->param_cell_num = func->func_type->param_cell_num;
+    func->ret_cell_num = func->func_type->ret_cell_num;
+    local_cell_num = wasm_get_cell_num(func->local_types, func->local_count);
+
+    if (local_cell_num > UINT16_MAX) {
+        set_error_buf(error_buf, error_buf_size, "local count too large");
+        return false;
+    }
+
+    func->local_cell_num = (uint16)local_cell_num;
+
+    if (!init_function_local_offsets(func, error_buf, error_buf_size))
+        return false;
+
+    *p_buf = p_code_end;
+    return true;
+fail:
+    return false;
+}
+
 static bool
 load_function_section(const uint8 *buf, const uint8 *buf_end,
                       const uint8 *buf_code, const uint8 *buf_code_end,
@@ -3843,17 +4077,12 @@ load_function_section(const uint8 *buf, const uint8 *buf_end,
                       uint32 error_buf_size)
 {
     const uint8 *p = buf, *p_end = buf_end;
-    const uint8 *p_code = buf_code, *p_code_end, *p_code_save;
+    const uint8 *p_code = buf_code;
     uint32 func_count;
     uint64 total_size;
-    uint32 code_count = 0, code_size, type_index, i, j, k, local_type_index;
-    uint32 local_count, local_set_count, sub_local_count, local_cell_num;
-    uint8 type;
-    WASMFunction *func;
+    uint32 code_count = 0, type_index, i;
 #if WASM_ENABLE_GC != 0
-    bool need_ref_type_map;
-    WASMRefType ref_type;
-    uint32 ref_type_map_count = 0, t = 0, type_index_org;
+    uint32 type_index_org;
 #endif
 
     read_leb_uint32(p, p_end, func_count);
@@ -3899,223 +4128,28 @@ load_function_section(const uint8 *buf, const uint8 *buf_end,
                 module->types, module->type_count, type_index);
 #endif
 
-            read_leb_uint32(p_code, buf_code_end, code_size);
-            if (code_size == 0 || p_code + code_size > buf_code_end) {
-                set_error_buf(error_buf, error_buf_size,
-                              "invalid function code size");
-                return false;
-            }
-
-            /* Resolve local set count */
-            p_code_end = p_code + code_size;
-#if WASM_ENABLE_BRANCH_HINTS != 0
-            uint8 *p_body_start = (uint8 *)p_code;
-#endif
-            local_count = 0;
-            read_leb_uint32(p_code, buf_code_end, local_set_count);
-            p_code_save = p_code;
-
-#if WASM_ENABLE_GC != 0
-            ref_type_map_count = 0;
-#endif
-
-            /* Calculate total local count */
-            for (j = 0; j < local_set_count; j++) {
-                read_leb_uint32(p_code, buf_code_end, sub_local_count);
-                if (sub_local_count > UINT32_MAX - local_count) {
-                    set_error_buf(error_buf, error_buf_size, "too many locals");
-                    return false;
-                }
-#if WASM_ENABLE_GC == 0
-                CHECK_BUF(p_code, buf_code_end, 1);
-                /* 0x7F/0x7E/0x7D/0x7C */
-                type = read_uint8(p_code);
-                local_count += sub_local_count;
-#if WASM_ENABLE_WAMR_COMPILER != 0
-                /* If any value's type is v128, mark the module as SIMD used */
-                if (type == VALUE_TYPE_V128)
-                    module->is_simd_used = true;
-#endif
-#else
-                if (!resolve_value_type(&p_code, buf_code_end, module,
-                                        module->type_count, &need_ref_type_map,
-                                        &ref_type, false, error_buf,
-                                        error_buf_size)) {
-                    return false;
-                }
-                local_count += sub_local_count;
-                if (need_ref_type_map)
-                    ref_type_map_count += sub_local_count;
-#endif
-            }
-
-            /* Code size in code entry can't be smaller than size of vec(locals)
-             * + expr(at least 1 for opcode end). And expressions are encoded by
-             * their instruction sequence terminated with an explicit 0x0B
-             * opcode for end. */
-            if (p_code_end <= p_code || *(p_code_end - 1) != WASM_OP_END) {
-                set_error_buf(
-                    error_buf, error_buf_size,
-                    "section size mismatch: function body END opcode expected");
-                return false;
-            }
-
-            /* Alloc memory, layout: function structure + local types */
-            code_size = (uint32)(p_code_end - p_code);
-
-            total_size = sizeof(WASMFunction) + (uint64)local_count;
-            if (!(func = module->functions[i] =
-                      loader_malloc(total_size, error_buf, error_buf_size))) {
-                return false;
-            }
-#if WASM_ENABLE_GC != 0
-            if (ref_type_map_count > 0) {
-                if (ref_type_map_count > UINT16_MAX) {
-                    set_error_buf(error_buf, error_buf_size,
-                                  "ref type count too large");
-                    return false;
-                }
-                total_size =
-                    sizeof(WASMRefTypeMap) * (uint64)ref_type_map_count;
-                if (!(func->local_ref_type_maps = loader_malloc(
-                          total_size, error_buf, error_buf_size))) {
+#if WASM_ENABLE_STREAM_LOADER != 0
+            if (module->stream_sections) {
+                /* The body is loaded when it is received, declare the
+                   function so that it can be referred to before that */
+                if (!(module->functions[i] = loader_malloc(
+                          sizeof(WASMFunction), error_buf, error_buf_size))) {
                     return false;
                 }
-                func->local_ref_type_map_count = ref_type_map_count;
+                module->functions[i]->func_type =
+                    (WASMFuncType *)module->types[type_index];
+                continue;
             }
 #endif
 
-            /* Set function type, local count, code size and code body */
-            func->func_type = (WASMFuncType *)module->types[type_index];
-            func->local_count = local_count;
-            if (local_count > 0)
-                func->local_types = (uint8 *)func + sizeof(WASMFunction);
-            func->code_size = code_size;
-#if WASM_ENABLE_BRANCH_HINTS != 0
-            func->code_body_begin = p_body_start;
-#endif
-            /*
-             * we shall make a copy of code body [p_code, p_code + code_size]
-             * when we are worrying about inappropriate releasing behaviour.
-             * all code bodies are actually in a buffer which user allocates in
-             * their embedding environment and we don't have power over them.
-             * it will be like:
-             * code_body_cp = malloc(code_size);
-             * memcpy(code_body_cp, p_code, code_size);
-             * func->code = code_body_cp;
-             */
-            func->code = (uint8 *)p_code;
-#if WASM_ENABLE_GC != 0
-            func->type_idx = type_index_org;
-#endif
-
-#if WASM_ENABLE_GC != 0
-            t = 0;
-#endif
-
-            /* Load each local type */
-            p_code = p_code_save;
-            local_type_index = 0;
-            for (j = 0; j < local_set_count; j++) {
-                read_leb_uint32(p_code, buf_code_end, sub_local_count);
-                /* Note: sub_local_count is allowed to be 0 */
-                if (local_type_index > UINT32_MAX - sub_local_count
-                    || local_type_index + sub_local_count > local_count) {
-                    set_error_buf(error_buf, error_buf_size,
-                                  "invalid local count");
-                    return false;
-                }
-#if WASM_ENABLE_GC == 0
-                CHECK_BUF(p_code, buf_code_end, 1);
-                /* 0x7F/0x7E/0x7D/0x7C */
-                type = read_uint8(p_code);
-                if (!is_valid_value_type_for_interpreter(type)) {
-                    if (type == VALUE_TYPE_V128)
-                        set_error_buf(error_buf, error_buf_size,
-                                      "v128 value type requires simd feature");
-                    else if (type == VALUE_TYPE_FUNCREF
-                             || type == VALUE_TYPE_EXTERNREF)
-                        set_error_buf(error_buf, error_buf_size,
-                                      "ref value type requires "
-                                      "reference types feature");
-                    else
-                        set_error_buf_v(error_buf, error_buf_size,
-                                        "invalid local type 0x%02X", type);
-                    return false;
-                }
-#else
-                if (!resolve_value_type(&p_code, buf_code_end, module,
-                                        module->type_count, &need_ref_type_map,
-                                        &ref_type, false, error_buf,
-                                        error_buf_size)) {
-                    return false;
-                }
-                if (need_ref_type_map) {
-                    WASMRefType *ref_type_tmp;
-                    if (!(ref_type_tmp = reftype_set_insert(
-                              module->ref_type_set, &ref_type, error_buf,
-                              error_buf_size))) {
-                        return false;
-                    }
-                    for (k = 0; k < sub_local_count; k++) {
-                        func->local_ref_type_maps[t + k].ref_type =
-                            ref_type_tmp;
-                        func->local_ref_type_maps[t + k].index =
-                            local_type_index + k;
-                    }
-                    t += sub_local_count;
-                }
-                type = ref_type.ref_type;
-#endif
-                for (k = 0; k < sub_local_count; k++) {
-                    func->local_types[local_type_index++] = type;
-                }
-#if WASM_ENABLE_WAMR_COMPILER != 0
-                if (type == VALUE_TYPE_V128)
-                    module->is_simd_used = true;
-                else if (type == VALUE_TYPE_FUNCREF
-                         || type == VALUE_TYPE_EXTERNREF)
-                    module->is_ref_types_used = true;
-#endif
+            if (!load_function_body(&p_code, buf_code_end, module, i,
+                                    (WASMFuncType *)module->types[type_index],
+                                    error_buf, error_buf_size)) {
+                return false;
             }
-
-            bh_assert(local_type_index == func->local_count);
 #if WASM_ENABLE_GC != 0
-            bh_assert(t == func->local_ref_type_map_count);
-#if TRACE_WASM_LOADER != 0
-            os_printf("func %u, local types: [", i);
-            k = 0;
-            for (j = 0; j < func->local_count; j++) {
-                WASMRefType *ref_type_tmp = NULL;
-                if (wasm_is_type_multi_byte_type(func->local_types[j])) {
-                    bh_assert(j == func->local_ref_type_maps[k].index);
-                    ref_type_tmp = func->local_ref_type_maps[k++].ref_type;
-                }
-                wasm_dump_value_type(func->local_types[j], ref_type_tmp);
-                if (j < func->local_count - 1)
-                    os_printf(" ");
-            }
-            os_printf("]\n");
-#endif
+            module->functions[i]->type_idx = type_index_org;
 #endif
-
-            func->param_cell_num = func->func_type->param_cell_num;
-            func->ret_cell_num = func->func_type->ret_cell_num;
-            local_cell_num =
-                wasm_get_cell_num(func->local_types, func->local_count);
-
-            if (local_cell_num > UINT16_MAX) {
-                set_error_buf(error_buf, error_buf_size,
-                              "local count too large");
-                return false;
-            }
-
-            func->local_cell_num = (uint16)local_cell_num;
-
-            if (!init_function_local_offsets(func, error_buf, error_buf_size))
-                return false;
-
-            p_code = p_code_end;
         }
     }
 
@@ -4512,7 +4546,7 @@ load_export_section(const uint8 *buf, const uint8 *buf_end, WASMModule *module,
                     }
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
                     /* TODO: check func type, if it has v128 param or result,
                              report error */
 #endif
@@ -5067,6 +5101,20 @@ check_data_count_consistency(bool has_datacount_section, int datacount_len,
     }
     return true;
 }
+
+/* Get the number of data segments which memory.init and data.drop may
+   refer to. The function bodies of a streamed module are validated
+   before its data section is received, while the data count section
+   they require is received earlier */
+static uint32
+get_data_seg_count(const WASMModule *module)
+{
+#if WASM_ENABLE_STREAM_LOADER != 0
+    if (module->stream_sections)
+        return module->data_seg_count1;
+#endif
+    return module->data_seg_count;
+}
 #endif
 
 static bool
@@ -5865,6 +5913,10 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.segue_flags = llvm_jit_options->segue_flags;
     option.quick_invoke_c_api_import =
         llvm_jit_options->quick_invoke_c_api_import;
+    if (module->llvm_jit_cache_enabled) {
+        option.jit_cache_dir = llvm_jit_options->cache_dir;
+        option.jit_cache_module_digest = module->llvm_jit_cache_digest;
+    }
 
 #if WASM_ENABLE_BULK_MEMORY != 0
     option.enable_bulk_memory = true;
@@ -5885,6 +5937,9 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.enable_ref_types = true;
 #elif WASM_ENABLE_GC != 0
     option.enable_gc = true;
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    option.enable_gc_write_barrier = true;
+#endif
 #endif
 #if WASM_ENABLE_CALL_INDIRECT_OVERLONG != 0
     option.enable_call_indirect_overlong = true;
@@ -5927,7 +5982,8 @@ init_llvm_jit_functions_stage2(WASMModule *module, char *error_buf,
     if (module->function_count == 0)
         return true;
 
-    if (!aot_compile_wasm(module->comp_ctx)) {
+    if (!aot_jit_cache_load(module->comp_ctx)
+        && !aot_compile_wasm(module->comp_ctx)) {
         aot_last_error = aot_get_last_error();
         bh_assert(aot_last_error != NULL);
         set_error_buf(error_buf, error_buf_size, aot_last_error);
@@ -6018,8 +6074,18 @@ orcjit_thread_callback(void *arg)
     uint32 i;
 
 #if WASM_ENABLE_FAST_JIT != 0
+#if WASM_ENABLE_LAZY_JIT != 0
+    /* Functions are compiled by the interpreter when they become hot
+       if the tier-up threshold is set */
+    bool compile_fast_jit =
+        jit_compiler_get_jit_globals()->tierup_threshold == 0 ? true : false;
+#else
+    bool compile_fast_jit = true;
+#endif
+
     /* Compile fast jit functions of this group */
-    for (i = group_idx; i < func_count; i += group_stride) {
+    for (i = group_idx; compile_fast_jit && i < func_count;
+         i += group_stride) {
         if (!jit_compiler_compile(module, i + module->import_function_count)) {
             LOG_ERROR("failed to compile fast jit function %u\n", i);
             break;
@@ -6248,158 +6314,130 @@ static void **handle_table;
 #endif
 
 static bool
-load_from_sections(WASMModule *module, WASMSection *sections,
-                   bool is_load_from_file_buf, bool wasm_binary_freeable,
-                   bool no_resolve, char *error_buf, uint32 error_buf_size)
+load_section(WASMModule *module, const WASMSection *section,
+             const uint8 *buf_code, const uint8 *buf_code_end,
+             const uint8 *buf_func, const uint8 *buf_func_end,
+             bool reuse_const_strings, bool clone_data_seg, bool no_resolve,
+             bool *p_has_datacount_section, char *error_buf,
+             uint32 error_buf_size)
 {
-    WASMExport *export;
-    WASMSection *section = sections;
-    const uint8 *buf, *buf_end, *buf_code = NULL, *buf_code_end = NULL,
-                                *buf_func = NULL, *buf_func_end = NULL;
-    WASMGlobal *aux_data_end_global = NULL, *aux_heap_base_global = NULL;
-    WASMGlobal *aux_stack_top_global = NULL, *global;
-    uint64 aux_data_end = (uint64)-1LL, aux_heap_base = (uint64)-1LL,
-           aux_stack_top = (uint64)-1LL;
-    uint32 global_index, func_index, i;
-    uint32 aux_data_end_global_index = (uint32)-1;
-    uint32 aux_heap_base_global_index = (uint32)-1;
-    WASMFuncType *func_type;
-    uint8 malloc_free_io_type = VALUE_TYPE_I32;
-    bool reuse_const_strings = is_load_from_file_buf && !wasm_binary_freeable;
-    bool clone_data_seg = is_load_from_file_buf && wasm_binary_freeable;
-#if WASM_ENABLE_BULK_MEMORY != 0
-    bool has_datacount_section = false;
+    const uint8 *buf = section->section_body;
+    const uint8 *buf_end = buf + section->section_body_size;
+
+    switch (section->section_type) {
+        case SECTION_TYPE_USER:
+            /* unsupported user section, ignore it. */
+            if (!load_user_section(buf, buf_end, module, reuse_const_strings,
+                                   error_buf, error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_TYPE:
+            if (!load_type_section(buf, buf_end, module, error_buf,
+                                   error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_IMPORT:
+            if (!load_import_section(buf, buf_end, module, reuse_const_strings,
+                                     no_resolve, error_buf, error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_FUNC:
+            if (!load_function_section(buf, buf_end, buf_code, buf_code_end,
+                                       module, error_buf, error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_TABLE:
+            if (!load_table_section(buf, buf_end, module, error_buf,
+                                    error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_MEMORY:
+            if (!load_memory_section(buf, buf_end, module, error_buf,
+                                     error_buf_size))
+                return false;
+            break;
+#if WASM_ENABLE_TAGS != 0
+        case SECTION_TYPE_TAG:
+            /* load tag declaration section */
+            if (!load_tag_section(buf, buf_end, buf_code, buf_code_end, module,
+                                  error_buf, error_buf_size))
+                return false;
+            break;
 #endif
-
-    /* Find code and function sections if have */
-    while (section) {
-        if (section->section_type == SECTION_TYPE_CODE) {
-            buf_code = section->section_body;
-            buf_code_end = buf_code + section->section_body_size;
-#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_DEBUG_AOT != 0
-            module->buf_code = (uint8 *)buf_code;
-            module->buf_code_size = section->section_body_size;
-#endif
-        }
-        else if (section->section_type == SECTION_TYPE_FUNC) {
-            buf_func = section->section_body;
-            buf_func_end = buf_func + section->section_body_size;
-        }
-        section = section->next;
-    }
-
-    section = sections;
-    while (section) {
-        buf = section->section_body;
-        buf_end = buf + section->section_body_size;
-        switch (section->section_type) {
-            case SECTION_TYPE_USER:
-                /* unsupported user section, ignore it. */
-                if (!load_user_section(buf, buf_end, module,
-                                       reuse_const_strings, error_buf,
-                                       error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_TYPE:
-                if (!load_type_section(buf, buf_end, module, error_buf,
-                                       error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_IMPORT:
-                if (!load_import_section(buf, buf_end, module,
-                                         reuse_const_strings, no_resolve,
-                                         error_buf, error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_FUNC:
-                if (!load_function_section(buf, buf_end, buf_code, buf_code_end,
-                                           module, error_buf, error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_TABLE:
-                if (!load_table_section(buf, buf_end, module, error_buf,
-                                        error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_MEMORY:
-                if (!load_memory_section(buf, buf_end, module, error_buf,
-                                         error_buf_size))
-                    return false;
-                break;
-#if WASM_ENABLE_TAGS != 0
-            case SECTION_TYPE_TAG:
-                /* load tag declaration section */
-                if (!load_tag_section(buf, buf_end, buf_code, buf_code_end,
-                                      module, error_buf, error_buf_size))
-                    return false;
-                break;
-#endif
-            case SECTION_TYPE_GLOBAL:
-                if (!load_global_section(buf, buf_end, module, error_buf,
-                                         error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_EXPORT:
-                if (!load_export_section(buf, buf_end, module,
-                                         reuse_const_strings, error_buf,
-                                         error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_START:
-                if (!load_start_section(buf, buf_end, module, error_buf,
-                                        error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_ELEM:
-                if (!load_table_segment_section(buf, buf_end, module, error_buf,
-                                                error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_CODE:
-                if (!load_code_section(buf, buf_end, buf_func, buf_func_end,
-                                       module, error_buf, error_buf_size))
-                    return false;
-                break;
-            case SECTION_TYPE_DATA:
-                if (!load_data_segment_section(buf, buf_end, module,
+        case SECTION_TYPE_GLOBAL:
+            if (!load_global_section(buf, buf_end, module, error_buf,
+                                     error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_EXPORT:
+            if (!load_export_section(buf, buf_end, module, reuse_const_strings,
+                                     error_buf, error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_START:
+            if (!load_start_section(buf, buf_end, module, error_buf,
+                                    error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_ELEM:
+            if (!load_table_segment_section(buf, buf_end, module, error_buf,
+                                            error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_CODE:
+            if (!load_code_section(buf, buf_end, buf_func, buf_func_end, module,
+                                   error_buf, error_buf_size))
+                return false;
+            break;
+        case SECTION_TYPE_DATA:
+            if (!load_data_segment_section(buf, buf_end, module,
 #if WASM_ENABLE_BULK_MEMORY != 0
-                                               has_datacount_section,
+                                           *p_has_datacount_section,
 #endif
-                                               clone_data_seg, error_buf,
-                                               error_buf_size))
-                    return false;
-                break;
+                                           clone_data_seg, error_buf,
+                                           error_buf_size))
+                return false;
+            break;
 #if WASM_ENABLE_BULK_MEMORY != 0
-            case SECTION_TYPE_DATACOUNT:
-                if (!load_datacount_section(buf, buf_end, module, error_buf,
-                                            error_buf_size))
-                    return false;
-                has_datacount_section = true;
-                break;
+        case SECTION_TYPE_DATACOUNT:
+            if (!load_datacount_section(buf, buf_end, module, error_buf,
+                                        error_buf_size))
+                return false;
+            *p_has_datacount_section = true;
+            break;
 #endif
 #if WASM_ENABLE_STRINGREF != 0
-            case SECTION_TYPE_STRINGREF:
-                if (!load_stringref_section(buf, buf_end, module,
-                                            reuse_const_strings, error_buf,
-                                            error_buf_size))
-                    return false;
-                break;
-#endif
-            default:
-                set_error_buf(error_buf, error_buf_size, "invalid section id");
+        case SECTION_TYPE_STRINGREF:
+            if (!load_stringref_section(buf, buf_end, module,
+                                        reuse_const_strings, error_buf,
+                                        error_buf_size))
                 return false;
-        }
-
-        section = section->next;
+            break;
+#endif
+        default:
+            set_error_buf(error_buf, error_buf_size, "invalid section id");
+            return false;
     }
 
-#if WASM_ENABLE_BULK_MEMORY != 0
-    if (!check_data_count_consistency(
-            has_datacount_section, module->data_seg_count1,
-            module->data_seg_count, error_buf, error_buf_size)) {
-        return false;
-    }
-#endif
+    (void)p_has_datacount_section;
+    return true;
+}
+
+/* Resolve the auxiliary data/stack/heap globals and the malloc/free
+   functions exported by the module */
+static void
+resolve_aux_globals_and_malloc_functions(WASMModule *module)
+{
+    WASMExport *export;
+    WASMGlobal *aux_data_end_global = NULL, *aux_heap_base_global = NULL;
+    WASMGlobal *aux_stack_top_global = NULL, *global;
+    uint64 aux_data_end = (uint64)-1LL, aux_heap_base = (uint64)-1LL,
+           aux_stack_top = (uint64)-1LL;
+    uint32 global_index, func_index, i;
+    uint32 aux_data_end_global_index = (uint32)-1;
+    uint32 aux_heap_base_global_index = (uint32)-1;
+    WASMFuncType *func_type;
+    uint8 malloc_free_io_type = VALUE_TYPE_I32;
 
     module->aux_data_end_global_index = (uint32)-1;
     module->aux_heap_base_global_index = (uint32)-1;
@@ -6618,15 +6656,238 @@ load_from_sections(WASMModule *module, WASMSection *sections,
             }
         }
     }
+}
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+typedef struct ParallelLoadContext {
+    WASMModule *module;
+    korp_mutex lock;
+    /* index of the next function to prepare */
+    uint32 next_func_idx;
+    /* the lowest index of the functions that failed to be prepared,
+       function_count if none failed */
+    uint32 failed_func_idx;
+    char error_buf[128];
+} ParallelLoadContext;
+
+static void *
+parallel_load_thread_callback(void *arg)
+{
+    ParallelLoadContext *ctx = (ParallelLoadContext *)arg;
+    WASMModule *module = ctx->module;
+    char error_buf[128];
+    uint32 i;
+
+    while (true) {
+        os_mutex_lock(&ctx->lock);
+        /* The functions after a failed one needn't be prepared, while
+           the ones before it still are, so that the error reported is
+           the same as that of loading them one by one */
+        if (ctx->next_func_idx >= ctx->failed_func_idx) {
+            os_mutex_unlock(&ctx->lock);
+            break;
+        }
+        i = ctx->next_func_idx++;
+        os_mutex_unlock(&ctx->lock);
+
+        if (!wasm_loader_prepare_bytecode(module, module->functions[i], i,
+                                          error_buf, sizeof(error_buf))) {
+            os_mutex_lock(&ctx->lock);
+            if (i < ctx->failed_func_idx) {
+                ctx->failed_func_idx = i;
+                bh_memcpy_s(ctx->error_buf, sizeof(ctx->error_buf), error_buf,
+                            sizeof(error_buf));
+            }
+            os_mutex_unlock(&ctx->lock);
+        }
+    }
+
+    return NULL;
+}
+
+static bool
+prepare_bytecode_in_parallel(WASMModule *module, uint32 thread_num,
+                             char *error_buf, uint32 error_buf_size)
+{
+    ParallelLoadContext ctx = { 0 };
+    korp_tid *tids;
+    uint32 created_num = 0, i;
+
+    if (!(tids = loader_malloc(sizeof(korp_tid) * (uint64)(thread_num - 1),
+                               error_buf, error_buf_size))) {
+        return false;
+    }
+
+    if (os_mutex_init(&ctx.lock) != 0) {
+        set_error_buf(error_buf, error_buf_size, "init mutex failed");
+        wasm_runtime_free(tids);
+        return false;
+    }
+
+    ctx.module = module;
+    ctx.failed_func_idx = module->function_count;
+    module->parallel_load_lock = &ctx.lock;
+
+    for (i = 0; i < thread_num - 1; i++) {
+        if (os_thread_create(&tids[i], parallel_load_thread_callback, &ctx,
+                             APP_THREAD_STACK_SIZE_DEFAULT)
+            != 0) {
+            /* Go on with the threads created */
+            LOG_WARNING("create parallel loader thread failed");
+            break;
+        }
+        created_num++;
+    }
+
+    LOG_VERBOSE("Prepare %u functions with %u threads",
+                module->function_count, created_num + 1);
+
+    /* The loading thread prepares the functions too */
+    parallel_load_thread_callback(&ctx);
+
+    for (i = 0; i < created_num; i++) {
+        os_thread_join(tids[i], NULL);
+    }
+
+    module->parallel_load_lock = NULL;
+    os_mutex_destroy(&ctx.lock);
+    wasm_runtime_free(tids);
+
+    if (ctx.failed_func_idx < module->function_count) {
+        if (error_buf != NULL)
+            snprintf(error_buf, error_buf_size, "%s", ctx.error_buf);
+        return false;
+    }
+    return true;
+}
+#endif /* end of WASM_ENABLE_PARALLEL_LOADER != 0 */
+
+static bool
+load_from_sections(WASMModule *module, WASMSection *sections,
+                   bool is_load_from_file_buf, bool wasm_binary_freeable,
+                   bool no_resolve, char *error_buf, uint32 error_buf_size)
+{
+    WASMSection *section = sections;
+    const uint8 *buf_code = NULL, *buf_code_end = NULL, *buf_func = NULL,
+                *buf_func_end = NULL;
+    uint32 i;
+    bool reuse_const_strings = is_load_from_file_buf && !wasm_binary_freeable;
+    bool clone_data_seg = is_load_from_file_buf && wasm_binary_freeable;
+    bool has_datacount_section = false;
+    bool prepare_bytecode = true;
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    bool prepare_bytecode_done = false;
+#endif
+
+    /* Find code and function sections if have */
+    while (section) {
+        if (section->section_type == SECTION_TYPE_CODE) {
+            buf_code = section->section_body;
+            buf_code_end = buf_code + section->section_body_size;
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_DEBUG_AOT != 0
+            module->buf_code = (uint8 *)buf_code;
+            module->buf_code_size = section->section_body_size;
+#endif
+        }
+        else if (section->section_type == SECTION_TYPE_FUNC) {
+            buf_func = section->section_body;
+            buf_func_end = buf_func + section->section_body_size;
+        }
+        section = section->next;
+    }
+
+    section = sections;
+#if WASM_ENABLE_STREAM_LOADER != 0
+    /* The sections before the code section of a streamed module were
+       loaded when the code section was received */
+    if (module->stream_sections && buf_code) {
+        while (section->section_type != SECTION_TYPE_CODE) {
+#if WASM_ENABLE_BULK_MEMORY != 0
+            if (section->section_type == SECTION_TYPE_DATACOUNT)
+                has_datacount_section = true;
+#endif
+            section = section->next;
+        }
+    }
+#endif
+    while (section) {
+        if (!load_section(module, section, buf_code, buf_code_end, buf_func,
+                          buf_func_end, reuse_const_strings, clone_data_seg,
+                          no_resolve, &has_datacount_section, error_buf,
+                          error_buf_size))
+            return false;
+        section = section->next;
+    }
+
+#if WASM_ENABLE_BULK_MEMORY != 0
+    if (!check_data_count_consistency(
+            has_datacount_section, module->data_seg_count1,
+            module->data_seg_count, error_buf, error_buf_size)) {
+        return false;
+    }
+#endif
+
+    resolve_aux_globals_and_malloc_functions(module);
 
 #if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_LABELS_AS_VALUES != 0
     handle_table = wasm_interp_get_handle_table();
 #endif
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    /* The functions loaded from the cache were validated when they
+       were pre-compiled and saved */
+    if (module->fast_interp_cache_enabled)
+        prepare_bytecode = !wasm_fast_interp_cache_load(module);
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (prepare_bytecode && module->lazy_validation) {
+        /* Leave the function bodies to wasm_loader_validate_func_lazily,
+           and as their opcodes aren't scanned, assume that the memory
+           may grow */
+        for (i = 0; i < module->function_count; i++)
+            module->functions[i]->lazy_state = LAZY_FUNC_UNVALIDATED;
+        module->possible_memory_grow = true;
+        prepare_bytecode = false;
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+        /* There is no code to save to the cache */
+        module->fast_interp_cache_enabled = false;
+#endif
+    }
+#endif
+
+#if WASM_ENABLE_STREAM_LOADER != 0
+    /* The function bodies of a streamed module were prepared when they
+       were received */
+    if (module->stream_sections)
+        prepare_bytecode = false;
+#endif
+
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    if (prepare_bytecode && module->function_count > 1
+        && wasm_runtime_get_loader_thread_num() > 1
+        && buf_code_end - buf_code >= WASM_PARALLEL_LOADER_MIN_CODE_SIZE) {
+        uint32 thread_num = wasm_runtime_get_loader_thread_num();
+
+        if (thread_num > module->function_count)
+            thread_num = module->function_count;
+        if (!prepare_bytecode_in_parallel(module, thread_num, error_buf,
+                                          error_buf_size)) {
+            return false;
+        }
+        /* Only the code section size is checked below */
+        prepare_bytecode_done = true;
+    }
+#endif
+
     for (i = 0; i < module->function_count; i++) {
         WASMFunction *func = module->functions[i];
-        if (!wasm_loader_prepare_bytecode(module, func, i, error_buf,
-                                          error_buf_size)) {
+        if (prepare_bytecode
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+            && !prepare_bytecode_done
+#endif
+            && !wasm_loader_prepare_bytecode(module, func, i, error_buf,
+                                             error_buf_size)) {
             return false;
         }
 
@@ -6638,12 +6899,16 @@ load_from_sections(WASMModule *module, WASMSection *sections,
         }
     }
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    if (prepare_bytecode && module->fast_interp_cache_enabled)
+        wasm_fast_interp_cache_save(module);
+#endif
+
     if (!module->possible_memory_grow) {
 #if WASM_ENABLE_SHRUNK_MEMORY != 0
-        if (aux_data_end_global && aux_heap_base_global
-            && aux_stack_top_global) {
+        if (module->aux_heap_base_global_index != (uint32)-1) {
             uint64 init_memory_size;
-            uint64 shrunk_memory_size = align_uint64(aux_heap_base, 8);
+            uint64 shrunk_memory_size = align_uint64(module->aux_heap_base, 8);
 
             /* Only resize(shrunk) the memory size if num_bytes_per_page is in
              * valid range of uint32 */
@@ -7044,6 +7309,19 @@ load(const uint8 *buf, uint32 size, WASMModule *module,
 
     module->package_version = version;
 
+#if WASM_ENABLE_JIT != 0
+    if (wasm_runtime_get_llvm_jit_options()->cache_dir) {
+        bh_sha256(buf, size, module->llvm_jit_cache_digest);
+        module->llvm_jit_cache_enabled = true;
+    }
+#endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    if (wasm_runtime_get_fast_interp_cache_dir()) {
+        bh_sha256(buf, size, module->fast_interp_cache_digest);
+        module->fast_interp_cache_enabled = true;
+    }
+#endif
+
     if (!create_sections(buf, size, &section_list, error_buf, error_buf_size)
         || !load_from_sections(module, section_list, true, wasm_binary_freeable,
                                no_resolve, error_buf, error_buf_size)) {
@@ -7088,145 +7366,618 @@ check_wasi_abi_compatibility(const WASMModule *module,
      *
      */
 
-    /* clang-format off */
-    /**
-     *
-     * |             | import_wasi_api True |                  | import_wasi_api False |                  |
-     * | ----------- | -------------------- | ---------------- | --------------------- | ---------------- |
-     * |             | \_initialize() Y     | \_initialize() N | \_initialize() Y      | \_initialize() N |
-     * | \_start() Y | N                    | COMMANDER        | N                     | COMMANDER        |
-     * | \_start() N | REACTOR              | N                | REACTOR               | OTHERS           |
-     */
-    /* clang-format on */
+    /* clang-format off */
+    /**
+     *
+     * |             | import_wasi_api True |                  | import_wasi_api False |                  |
+     * | ----------- | -------------------- | ---------------- | --------------------- | ---------------- |
+     * |             | \_initialize() Y     | \_initialize() N | \_initialize() Y      | \_initialize() N |
+     * | \_start() Y | N                    | COMMANDER        | N                     | COMMANDER        |
+     * | \_start() N | REACTOR              | N                | REACTOR               | OTHERS           |
+     */
+    /* clang-format on */
+
+    WASMExport *initialize = NULL, *memory = NULL, *start = NULL;
+    uint32 import_function_count = module->import_function_count;
+    WASMFuncType *func_type;
+
+    /* (func (export "_start") (...) */
+    start = wasm_loader_find_export(module, "", "_start", EXPORT_KIND_FUNC,
+                                    error_buf, error_buf_size);
+    if (start) {
+        if (start->index < import_function_count) {
+            set_error_buf(
+                error_buf, error_buf_size,
+                "the builtin _start function can not be an import function");
+            return false;
+        }
+
+        func_type =
+            module->functions[start->index - import_function_count]->func_type;
+        if (func_type->param_count || func_type->result_count) {
+            set_error_buf(error_buf, error_buf_size,
+                          "the signature of builtin _start function is wrong");
+            return false;
+        }
+    }
+    else {
+        /* (func (export "_initialize") (...) */
+        initialize =
+            wasm_loader_find_export(module, "", "_initialize", EXPORT_KIND_FUNC,
+                                    error_buf, error_buf_size);
+
+        if (initialize) {
+            if (initialize->index < import_function_count) {
+                set_error_buf(error_buf, error_buf_size,
+                              "the builtin _initialize function can not be an "
+                              "import function");
+                return false;
+            }
+
+            func_type =
+                module->functions[initialize->index - import_function_count]
+                    ->func_type;
+            if (func_type->param_count || func_type->result_count) {
+                set_error_buf(
+                    error_buf, error_buf_size,
+                    "the signature of builtin _initialize function is wrong");
+                return false;
+            }
+        }
+    }
+
+    /* filter out non-wasi compatible modules */
+    if (!module->import_wasi_api && !start && !initialize) {
+        return true;
+    }
+
+    /* should have one at least */
+    if (module->import_wasi_api && !start && !initialize) {
+        LOG_WARNING("warning: a module with WASI apis should be either "
+                    "a command or a reactor");
+    }
+
+    /*
+     * there is at least one of `_start` and `_initialize` in below cases.
+     * according to the assumption, they should be all wasi compatible
+     */
+
+#if WASM_ENABLE_MULTI_MODULE != 0
+    /* filter out commands (with `_start`) cases */
+    if (start && !main_module) {
+        set_error_buf(
+            error_buf, error_buf_size,
+            "a command (with _start function) can not be a sub-module");
+        return false;
+    }
+#endif
+
+    /*
+     * it is ok a reactor acts as a main module,
+     * so skip the check about (with `_initialize`)
+     */
+
+    memory = wasm_loader_find_export(module, "", "memory", EXPORT_KIND_MEMORY,
+                                     error_buf, error_buf_size);
+    if (!memory
+#if WASM_ENABLE_LIB_WASI_THREADS != 0
+        /*
+         * with wasi-threads, it's still an open question if a memory
+         * should be exported.
+         *
+         * https://github.com/WebAssembly/wasi-threads/issues/22
+         * https://github.com/WebAssembly/WASI/issues/502
+         *
+         * Note: this code assumes the number of memories is at most 1.
+         */
+        && module->import_memory_count == 0
+#endif
+    ) {
+        set_error_buf(error_buf, error_buf_size,
+                      "a module with WASI apis must export memory by default");
+        return false;
+    }
+
+    return true;
+}
+#endif
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Write the active data segments of the default memory into a memory
+   image when they are large enough to be worth mapping */
+static void
+create_memory_image(WASMModule *module)
+{
+    WASMMemory *memory;
+    WASMDataSeg *data_seg;
+    WASMMemoryImage *image;
+    uint64 memory_size, base_offset, data_end = 0, data_size = 0;
+    uint8 offset_type;
+    uint32 i;
+
+    /* Imported and shared memories are initialized by other instances */
+    if (module->import_memory_count > 0 || module->memory_count == 0
+        || (module->memories[0].flags & SHARED_MEMORY_FLAG))
+        return;
+
+    memory = &module->memories[0];
+    memory_size = (uint64)memory->num_bytes_per_page * memory->init_page_count;
+    offset_type = (memory->flags & MEMORY64_FLAG) ? INIT_EXPR_TYPE_I64_CONST
+                                                  : INIT_EXPR_TYPE_I32_CONST;
+
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+
+        /* The offsets of the segments must be known before instantiation,
+           and the out of bounds segments are reported by instantiation */
+        if (data_seg->base_offset.init_expr_type != offset_type)
+            return;
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->base_offset.u.unary.v.i64
+                          : (uint32)data_seg->base_offset.u.unary.v.i32;
+        if (base_offset > memory_size
+            || data_seg->data_length > memory_size - base_offset)
+            return;
+
+        if (base_offset + data_seg->data_length > data_end)
+            data_end = base_offset + data_seg->data_length;
+        data_size += data_seg->data_length;
+    }
+
+    if (data_size < WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+        || !(image = wasm_memory_image_create(data_end)))
+        return;
+
+    /* Later segments overwrite the earlier ones like on instantiation */
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->base_offset.u.unary.v.i64
+                          : (uint32)data_seg->base_offset.u.unary.v.i32;
+        if (!wasm_memory_image_write(image, base_offset, data_seg->data,
+                                     data_seg->data_length)) {
+            LOG_WARNING("write memory image failed");
+            wasm_memory_image_destroy(image);
+            return;
+        }
+    }
+
+    module->memory_image = image;
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
+
+WASMModule *
+wasm_loader_load(uint8 *buf, uint32 size,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                 bool main_module,
+#endif
+                 const LoadArgs *args, char *error_buf, uint32 error_buf_size)
+{
+    WASMModule *module = create_module(args->name, error_buf, error_buf_size);
+    if (!module) {
+        return NULL;
+    }
+
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_FAST_JIT != 0 \
+    || WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_JIT != 0
+    module->load_addr = (uint8 *)buf;
+    module->load_size = size;
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (args->lazy_validation) {
+        /* The function bodies are read from the wasm binary when they
+           are validated lazily */
+        if (args->wasm_binary_freeable) {
+            LOG_WARNING("Lazy validation is disabled as the wasm binary "
+                        "is freeable");
+        }
+        else if (os_mutex_init(&module->lazy_validation_lock) != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "init lazy validation lock failed");
+            goto fail;
+        }
+        else {
+            module->lazy_validation = true;
+        }
+    }
+#endif
+
+    if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
+              error_buf, error_buf_size)) {
+        goto fail;
+    }
+
+#if WASM_ENABLE_LIBC_WASI != 0
+    /* Check the WASI application ABI */
+    if (!check_wasi_abi_compatibility(module,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                                      main_module,
+#endif
+                                      error_buf, error_buf_size)) {
+        goto fail;
+    }
+#endif
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    create_memory_image(module);
+#endif
+
+    LOG_VERBOSE("Load module success.\n");
+    return module;
+
+fail:
+    wasm_loader_unload(module);
+    return NULL;
+}
+
+#if WASM_ENABLE_STREAM_LOADER != 0
+struct WASMModuleStream {
+    WASMModule *module;
+    /* The magic number and the version received */
+    uint8 header[8];
+    uint32 header_size;
+    bool no_resolve;
+    /* Whether a chunk failed to be loaded, after which the stream can
+       only be aborted */
+    bool failed;
+    /* The id and the LEB128 encoded size of the section whose header
+       is being received */
+    uint8 section_header[6];
+    uint32 section_header_size;
+    /* The index of the last non-custom section received, see
+       get_section_index */
+    uint8 last_section_index;
+    /* The section whose body is being received, NULL if it is the
+       header of the next section */
+    WASMSection *section;
+    uint32 section_received;
+    WASMSection *section_list_end;
+    /* Whether the sections before the code section are loaded */
+    bool code_section_started;
+    /* The offset of the next function body in the code section, and the
+       index of the function it belongs to */
+    uint32 code_offset;
+    uint32 code_func_idx;
+    /* The number of bytes received */
+    uint64 size;
+};
+
+/* Check whether the buffer starts with a complete LEB128 encoded 32-bit
+   integer, an overlong one is reported as complete so that reading it
+   fails with the usual error */
+static bool
+is_leb_complete(const uint8 *buf, const uint8 *buf_end)
+{
+    uint32 i;
+
+    for (i = 0; i < 5 && buf + i < buf_end; i++) {
+        if (!(buf[i] & 0x80))
+            return true;
+    }
+    return i == 5;
+}
+
+static bool
+stream_check_header(WASMModuleStream *stream, char *error_buf,
+                    uint32 error_buf_size)
+{
+    const uint8 *p = stream->header;
+    uint32 magic_number, version;
+
+    magic_number = read_uint32(p);
+    if (!is_little_endian())
+        exchange32((uint8 *)&magic_number);
+
+    if (magic_number != WASM_MAGIC_NUMBER) {
+        set_error_buf(error_buf, error_buf_size, "magic header not detected");
+        return false;
+    }
+
+    version = read_uint32(p);
+    if (!is_little_endian())
+        exchange32((uint8 *)&version);
+
+    if (version != WASM_CURRENT_VERSION) {
+        set_error_buf(error_buf, error_buf_size, "unknown binary version");
+        return false;
+    }
+
+    stream->module->package_version = version;
+    return true;
+}
+
+/* Create the section whose header has been received, its body is
+   allocated together with it so that its address doesn't change */
+static bool
+stream_create_section(WASMModuleStream *stream, char *error_buf,
+                      uint32 error_buf_size)
+{
+    WASMModule *module = stream->module;
+    const uint8 *p = stream->section_header;
+    const uint8 *p_end = p + stream->section_header_size;
+    WASMSection *section;
+    uint8 section_type, section_index;
+    uint32 section_size;
+
+    section_type = read_uint8(p);
+    section_index = get_section_index(section_type);
+    if (section_index == (uint8)-1) {
+        set_error_buf(error_buf, error_buf_size, "invalid section id");
+        return false;
+    }
+
+    if (section_type != SECTION_TYPE_USER) {
+        /* Custom sections may be inserted at any place, while other
+           sections must occur at most once and in prescribed order */
+        if (stream->last_section_index != (uint8)-1
+            && section_index <= stream->last_section_index) {
+            set_error_buf(error_buf, error_buf_size,
+                          "unexpected content after last section or "
+                          "junk after last section");
+            return false;
+        }
+        stream->last_section_index = section_index;
+    }
+
+    read_leb_uint32(p, p_end, section_size);
+
+    if (!(section = loader_malloc(sizeof(WASMSection) + (uint64)section_size,
+                                  error_buf, error_buf_size))) {
+        return false;
+    }
+    section->section_type = section_type;
+    section->section_body = (uint8 *)(section + 1);
+    section->section_body_size = section_size;
+
+    if (!module->stream_sections)
+        module->stream_sections = section;
+    else
+        stream->section_list_end->next = section;
+    stream->section_list_end = section;
+
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_FAST_JIT != 0 \
+    || WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_JIT != 0
+    if (section_type == SECTION_TYPE_CODE) {
+        /* Keep the offsets of the code relative to load_addr the same
+           as the ones in the wasm binary */
+        module->load_addr = section->section_body - stream->size;
+    }
+#endif
+
+    stream->section = section;
+    stream->section_received = 0;
+    stream->section_header_size = 0;
+    return true;
+fail:
+    return false;
+}
+
+/* Load the function bodies of the code section received so far, the
+   sections before it are loaded first so that they can be validated */
+static bool
+stream_load_code(WASMModuleStream *stream, char *error_buf,
+                 uint32 error_buf_size)
+{
+    WASMModule *module = stream->module;
+    WASMSection *code_section = stream->section, *section;
+    const uint8 *buf_code = code_section->section_body;
+    const uint8 *buf_code_end = buf_code + code_section->section_body_size;
+    const uint8 *p_received = buf_code + stream->section_received;
+    const uint8 *p = buf_code + stream->code_offset, *p_body;
+    bool section_received = p_received == buf_code_end;
+    bool has_datacount_section = false;
+    uint32 code_count, code_size;
+
+    if (!stream->code_section_started) {
+        /* The function section needs the count of the function bodies */
+        if (!section_received && !is_leb_complete(p, p_received))
+            return true;
+
+        for (section = module->stream_sections; section != code_section;
+             section = section->next) {
+            if (!load_section(module, section, buf_code, buf_code_end, NULL,
+                              NULL, true, false, stream->no_resolve,
+                              &has_datacount_section, error_buf,
+                              error_buf_size))
+                return false;
+        }
+
+        resolve_aux_globals_and_malloc_functions(module);
 
-    WASMExport *initialize = NULL, *memory = NULL, *start = NULL;
-    uint32 import_function_count = module->import_function_count;
-    WASMFuncType *func_type;
+#if WASM_ENABLE_FAST_INTERP != 0 && WASM_ENABLE_LABELS_AS_VALUES != 0
+        handle_table = wasm_interp_get_handle_table();
+#endif
 
-    /* (func (export "_start") (...) */
-    start = wasm_loader_find_export(module, "", "_start", EXPORT_KIND_FUNC,
-                                    error_buf, error_buf_size);
-    if (start) {
-        if (start->index < import_function_count) {
-            set_error_buf(
-                error_buf, error_buf_size,
-                "the builtin _start function can not be an import function");
+        read_leb_uint32(p, buf_code_end, code_count);
+        (void)code_count;
+        stream->code_offset = (uint32)(p - buf_code);
+        stream->code_section_started = true;
+    }
+
+    while (stream->code_func_idx < module->function_count) {
+        if (!section_received) {
+            /* Wait until the whole function body is received */
+            p_body = p;
+            if (!is_leb_complete(p_body, p_received))
+                break;
+            read_leb_uint32(p_body, p_received, code_size);
+            if ((uint64)code_size > (uint64)(p_received - p_body))
+                break;
+        }
+
+        if (!load_function_body(
+                &p, buf_code_end, module, stream->code_func_idx,
+                module->functions[stream->code_func_idx]->func_type,
+                error_buf, error_buf_size)) {
             return false;
         }
 
-        func_type =
-            module->functions[start->index - import_function_count]->func_type;
-        if (func_type->param_count || func_type->result_count) {
-            set_error_buf(error_buf, error_buf_size,
-                          "the signature of builtin _start function is wrong");
+        if (
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+            !module->lazy_validation &&
+#endif
+            !wasm_loader_prepare_bytecode(
+                module, module->functions[stream->code_func_idx],
+                stream->code_func_idx, error_buf, error_buf_size)) {
             return false;
         }
+
+        stream->code_func_idx++;
+        stream->code_offset = (uint32)(p - buf_code);
     }
-    else {
-        /* (func (export "_initialize") (...) */
-        initialize =
-            wasm_loader_find_export(module, "", "_initialize", EXPORT_KIND_FUNC,
-                                    error_buf, error_buf_size);
 
-        if (initialize) {
-            if (initialize->index < import_function_count) {
-                set_error_buf(error_buf, error_buf_size,
-                              "the builtin _initialize function can not be an "
-                              "import function");
-                return false;
-            }
+    return true;
+fail:
+    return false;
+}
 
-            func_type =
-                module->functions[initialize->index - import_function_count]
-                    ->func_type;
-            if (func_type->param_count || func_type->result_count) {
-                set_error_buf(
-                    error_buf, error_buf_size,
-                    "the signature of builtin _initialize function is wrong");
-                return false;
-            }
-        }
-    }
+WASMModuleStream *
+wasm_loader_stream_load_begin(const LoadArgs *args, char *error_buf,
+                              uint32 error_buf_size)
+{
+    WASMModuleStream *stream;
 
-    /* filter out non-wasi compatible modules */
-    if (!module->import_wasi_api && !start && !initialize) {
-        return true;
+    if (!(stream = loader_malloc(sizeof(WASMModuleStream), error_buf,
+                                 error_buf_size))) {
+        return NULL;
     }
 
-    /* should have one at least */
-    if (module->import_wasi_api && !start && !initialize) {
-        LOG_WARNING("warning: a module with WASI apis should be either "
-                    "a command or a reactor");
+    if (!(stream->module =
+              create_module(args->name, error_buf, error_buf_size))) {
+        wasm_runtime_free(stream);
+        return NULL;
     }
 
-    /*
-     * there is at least one of `_start` and `_initialize` in below cases.
-     * according to the assumption, they should be all wasi compatible
-     */
-
-#if WASM_ENABLE_MULTI_MODULE != 0
-    /* filter out commands (with `_start`) cases */
-    if (start && !main_module) {
-        set_error_buf(
-            error_buf, error_buf_size,
-            "a command (with _start function) can not be a sub-module");
-        return false;
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    /* The function bodies are kept in the sections received */
+    if (args->lazy_validation) {
+        if (os_mutex_init(&stream->module->lazy_validation_lock) != 0) {
+            set_error_buf(error_buf, error_buf_size,
+                          "init lazy validation lock failed");
+            wasm_loader_stream_load_abort(stream);
+            return NULL;
+        }
+        stream->module->lazy_validation = true;
     }
 #endif
 
-    /*
-     * it is ok a reactor acts as a main module,
-     * so skip the check about (with `_initialize`)
-     */
+    stream->no_resolve = args->no_resolve;
+    stream->last_section_index = (uint8)-1;
+    return stream;
+}
 
-    memory = wasm_loader_find_export(module, "", "memory", EXPORT_KIND_MEMORY,
-                                     error_buf, error_buf_size);
-    if (!memory
-#if WASM_ENABLE_LIB_WASI_THREADS != 0
-        /*
-         * with wasi-threads, it's still an open question if a memory
-         * should be exported.
-         *
-         * https://github.com/WebAssembly/wasi-threads/issues/22
-         * https://github.com/WebAssembly/WASI/issues/502
-         *
-         * Note: this code assumes the number of memories is at most 1.
-         */
-        && module->import_memory_count == 0
-#endif
-    ) {
+bool
+wasm_loader_stream_load_feed(WASMModuleStream *stream, const uint8 *buf,
+                             uint32 size, char *error_buf,
+                             uint32 error_buf_size)
+{
+    const uint8 *p = buf, *p_end = buf + size;
+    WASMSection *section;
+    uint32 n;
+
+    if (stream->failed) {
         set_error_buf(error_buf, error_buf_size,
-                      "a module with WASI apis must export memory by default");
+                      "the stream failed to be loaded");
         return false;
     }
 
+    while (p < p_end) {
+        if (stream->header_size < sizeof(stream->header)) {
+            n = (uint32)sizeof(stream->header) - stream->header_size;
+            if (n > (uint32)(p_end - p))
+                n = (uint32)(p_end - p);
+            bh_memcpy_s(stream->header + stream->header_size, n, p, n);
+            stream->header_size += n;
+            stream->size += n;
+            p += n;
+            if (stream->header_size == sizeof(stream->header)
+                && !stream_check_header(stream, error_buf, error_buf_size))
+                goto fail;
+            continue;
+        }
+
+        if (!stream->section) {
+            stream->section_header[stream->section_header_size++] = *p++;
+            stream->size++;
+            if (stream->section_header_size < 2
+                || !is_leb_complete(stream->section_header + 1,
+                                    stream->section_header
+                                        + stream->section_header_size))
+                continue;
+            if (!stream_create_section(stream, error_buf, error_buf_size))
+                goto fail;
+        }
+        else {
+            section = stream->section;
+            n = section->section_body_size - stream->section_received;
+            if (n > (uint32)(p_end - p))
+                n = (uint32)(p_end - p);
+            bh_memcpy_s(section->section_body + stream->section_received, n,
+                        p, n);
+            stream->section_received += n;
+            stream->size += n;
+            p += n;
+        }
+
+        section = stream->section;
+        if (section->section_type == SECTION_TYPE_CODE
+            && !stream_load_code(stream, error_buf, error_buf_size))
+            goto fail;
+        if (stream->section_received == section->section_body_size)
+            stream->section = NULL;
+    }
+
     return true;
+fail:
+    stream->failed = true;
+    return false;
 }
-#endif
 
 WASMModule *
-wasm_loader_load(uint8 *buf, uint32 size,
+wasm_loader_stream_load_finish(WASMModuleStream *stream,
 #if WASM_ENABLE_MULTI_MODULE != 0
-                 bool main_module,
+                               bool main_module,
 #endif
-                 const LoadArgs *args, char *error_buf, uint32 error_buf_size)
+                               char *error_buf, uint32 error_buf_size)
 {
-    WASMModule *module = create_module(args->name, error_buf, error_buf_size);
-    if (!module) {
-        return NULL;
+    WASMModule *module = stream->module;
+
+    if (stream->failed) {
+        set_error_buf(error_buf, error_buf_size,
+                      "the stream failed to be loaded");
+        goto fail;
     }
 
-#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_FAST_JIT != 0 \
-    || WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_JIT != 0
-    module->load_addr = (uint8 *)buf;
-    module->load_size = size;
-#endif
+    if (stream->header_size < sizeof(stream->header) || stream->section
+        || stream->section_header_size > 0) {
+        set_error_buf(error_buf, error_buf_size, "unexpected end");
+        goto fail;
+    }
 
-    if (!load(buf, size, module, args->wasm_binary_freeable, args->no_resolve,
-              error_buf, error_buf_size)) {
+    if (!load_from_sections(module, module->stream_sections, true, false,
+                            stream->no_resolve, error_buf, error_buf_size)) {
         goto fail;
     }
 
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_FAST_JIT != 0 \
+    || WASM_ENABLE_DUMP_CALL_STACK != 0 || WASM_ENABLE_JIT != 0
+    module->load_size = (uint32)stream->size;
+#endif
+
 #if WASM_ENABLE_LIBC_WASI != 0
     /* Check the WASI application ABI */
     if (!check_wasi_abi_compatibility(module,
@@ -7238,14 +7989,68 @@ wasm_loader_load(uint8 *buf, uint32 size,
     }
 #endif
 
-    LOG_VERBOSE("Load module success.\n");
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    create_memory_image(module);
+#endif
+
+    wasm_runtime_free(stream);
+    LOG_VERBOSE("Load module from stream success.\n");
     return module;
 
 fail:
-    wasm_loader_unload(module);
+    wasm_loader_stream_load_abort(stream);
     return NULL;
 }
 
+void
+wasm_loader_stream_load_abort(WASMModuleStream *stream)
+{
+    wasm_loader_unload(stream->module);
+    wasm_runtime_free(stream);
+}
+#endif /* end of WASM_ENABLE_STREAM_LOADER != 0 */
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+bool
+wasm_loader_validate_func_lazily(WASMModule *module, uint32 func_idx,
+                                 char *error_buf, uint32 error_buf_size)
+{
+    WASMFunction *func;
+    uint32 state;
+
+    bh_assert(func_idx < module->function_count);
+    func = module->functions[func_idx];
+
+    os_mutex_lock(&module->lazy_validation_lock);
+    state = BH_ATOMIC_32_LOAD(func->lazy_state);
+    if (state == LAZY_FUNC_UNVALIDATED) {
+        if (wasm_loader_prepare_bytecode(module, func, func_idx, error_buf,
+                                         error_buf_size)) {
+            state = LAZY_FUNC_VALIDATED;
+        }
+        else {
+            /* Keep the error message to report it again on the later
+               calls, the function can't be prepared twice as the
+               bytecode may have been rewritten */
+            func->lazy_validation_error = bh_strdup(error_buf);
+            state = LAZY_FUNC_INVALID;
+        }
+        /* Publish the prepared function to the threads which check
+           the state without holding the lock */
+        BH_ATOMIC_32_STORE(func->lazy_state, state);
+    }
+    else if (state == LAZY_FUNC_INVALID) {
+        snprintf(error_buf, error_buf_size, "%s",
+                 func->lazy_validation_error
+                     ? func->lazy_validation_error
+                     : "WASM module load failed: invalid function");
+    }
+    os_mutex_unlock(&module->lazy_validation_lock);
+
+    return state == LAZY_FUNC_VALIDATED;
+}
+#endif /* end of WASM_ENABLE_LAZY_VALIDATION != 0 */
+
 void
 wasm_loader_unload(WASMModule *module)
 {
@@ -7293,16 +8098,27 @@ wasm_loader_unload(WASMModule *module)
                 if (module->functions[i]->local_offsets)
                     wasm_runtime_free(module->functions[i]->local_offsets);
 #if WASM_ENABLE_FAST_INTERP != 0
-                if (module->functions[i]->code_compiled)
-                    wasm_runtime_free(module->functions[i]->code_compiled);
-                if (module->functions[i]->consts)
-                    wasm_runtime_free(module->functions[i]->consts);
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+                if (module->functions[i]->code_relocs)
+                    wasm_runtime_free(module->functions[i]->code_relocs);
+                /* They point into the cache file loaded */
+                if (!module->fast_interp_cache_buf)
+#endif
+                {
+                    if (module->functions[i]->code_compiled)
+                        wasm_runtime_free(module->functions[i]->code_compiled);
+                    if (module->functions[i]->consts)
+                        wasm_runtime_free(module->functions[i]->consts);
+                }
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
                 if (module->functions[i]->fast_jit_jitted_code) {
                     jit_code_cache_free(
                         module->functions[i]->fast_jit_jitted_code);
                 }
+#if WASM_ENABLE_LAZY_JIT != 0
+                jit_free(module->functions[i]->fast_jit_osr_entries);
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
                 if (module->functions[i]->call_to_fast_jit_from_llvm_jit) {
                     jit_code_cache_free(
@@ -7315,6 +8131,12 @@ wasm_loader_unload(WASMModule *module)
                     wasm_runtime_free(
                         module->functions[i]->local_ref_type_maps);
                 }
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+                if (module->functions[i]->lazy_validation_error) {
+                    wasm_runtime_free(
+                        module->functions[i]->lazy_validation_error);
+                }
 #endif
                 wasm_runtime_free(module->functions[i]);
             }
@@ -7322,6 +8144,15 @@ wasm_loader_unload(WASMModule *module)
         wasm_runtime_free(module->functions);
     }
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    wasm_fast_interp_cache_unload(module);
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (module->lazy_validation)
+        os_mutex_destroy(&module->lazy_validation_lock);
+#endif
+
     if (module->tables) {
 #if WASM_ENABLE_GC != 0
         for (i = 0; i < module->table_count; i++) {
@@ -7390,6 +8221,11 @@ wasm_loader_unload(WASMModule *module)
         wasm_runtime_free(module->data_segments);
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    if (module->memory_image)
+        wasm_memory_image_destroy(module->memory_image);
+#endif
+
     if (module->types) {
         for (i = 0; i < module->type_count; i++) {
             if (module->types[i])
@@ -7510,6 +8346,9 @@ wasm_loader_unload(WASMModule *module)
     }
     if (module->function_hints != NULL)
         wasm_runtime_free(module->function_hints);
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    destroy_sections(module->stream_sections);
 #endif
     wasm_runtime_free(module);
 }
@@ -8206,7 +9045,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
 
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
             case WASM_OP_SIMD_PREFIX:
             {
                 uint32 opcode1;
@@ -8300,7 +9139,7 @@ wasm_loader_find_block_addr(WASMExecEnv *exec_env, BlockAddr *block_addr_cache,
                 break;
             }
 #endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) || \
-          (WASM_ENABLE_FAST_INTERP != 0) */
+          (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -8452,6 +9291,12 @@ typedef struct WASMLoaderContext {
     uint32 csp_num;
     uint32 max_csp_num;
 
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0 \
+    && WASM_ENABLE_SIMD != 0
+    /* Whether a v128 value was pushed to the frame ref stack */
+    bool has_v128;
+#endif
+
 #if WASM_ENABLE_FAST_INTERP != 0
     /* frame offset stack */
     int16 *frame_offset;
@@ -8488,6 +9333,25 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* the last i32 comparison which may be fused with the br_if
+       following it, fusible_cmp_end is the wasm bytecode right after
+       the comparison */
+    uint8 *fusible_cmp_end;
+    uint8 fusible_cmp_opcode;
+    uint8 fusible_cmp_operand_num;
+    int16 fusible_cmp_operands[2];
+#endif
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    /* the slots of the processed code to relocate when it is saved to
+       the fast interpreter code cache, recorded in the second traverse */
+    bool record_code_relocs;
+    uint32 *code_relocs;
+    uint32 code_reloc_count;
+    uint32 code_reloc_max_count;
+#endif
 #endif
 } WASMLoaderContext;
 
@@ -8723,6 +9587,10 @@ wasm_loader_ctx_destroy(WASMLoaderContext *ctx)
             wasm_runtime_free(ctx->i32_consts);
         if (ctx->v128_consts)
             wasm_runtime_free(ctx->v128_consts);
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+        if (ctx->code_relocs)
+            wasm_runtime_free(ctx->code_relocs);
+#endif
 #endif
         wasm_runtime_free(ctx);
     }
@@ -8853,6 +9721,12 @@ wasm_loader_push_frame_ref(WASMLoaderContext *ctx, uint8 type, char *error_buf,
     if (!check_stack_push(ctx, type, error_buf, error_buf_size))
         return false;
 
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0 \
+    && WASM_ENABLE_SIMD != 0
+    if (type == VALUE_TYPE_V128)
+        ctx->has_v128 = true;
+#endif
+
 #if WASM_ENABLE_GC != 0
     if (wasm_is_type_multi_byte_type(type)) {
         WASMRefType *ref_type;
@@ -9317,10 +10191,18 @@ fail:
 
 #if WASM_ENABLE_FAST_INTERP != 0
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+#define record_code_reloc(ctx, is_label) \
+    wasm_loader_record_code_reloc(ctx, is_label)
+#else
+#define record_code_reloc(ctx, is_label) (void)0
+#endif
+
 #if WASM_ENABLE_LABELS_AS_VALUES != 0
 #if WASM_CPU_SUPPORTS_UNALIGNED_ADDR_ACCESS != 0
 #define emit_label(opcode)                                      \
     do {                                                        \
+        record_code_reloc(loader_ctx, true);                    \
         wasm_loader_emit_ptr(loader_ctx, handle_table[opcode]); \
         LOG_OP("\nemit_op [%02x]\t", opcode);                   \
     } while (0)
@@ -9336,6 +10218,7 @@ fail:
         int32 offset =                                                         \
             (int32)((uint8 *)handle_table[opcode] - (uint8 *)handle_table[0]); \
         /* emit int32 relative offset in 64-bit target */                      \
+        record_code_reloc(loader_ctx, true);                                   \
         wasm_loader_emit_uint32(loader_ctx, offset);                           \
         LOG_OP("\nemit_op [%02x]\t", opcode);                                  \
     } while (0)
@@ -9344,6 +10227,7 @@ fail:
     do {                                                             \
         uint32 label_addr = (uint32)(uintptr_t)handle_table[opcode]; \
         /* emit uint32 label address in 32-bit target */             \
+        record_code_reloc(loader_ctx, true);                         \
         wasm_loader_emit_uint32(loader_ctx, label_addr);             \
         LOG_OP("\nemit_op [%02x]\t", opcode);                        \
     } while (0)
@@ -9374,6 +10258,7 @@ fail:
                                      error_buf_size))                        \
             goto fail;                                                       \
         /* label address, to be patched */                                   \
+        record_code_reloc(loader_ctx, false);                                \
         wasm_loader_emit_ptr(loader_ctx, NULL);                              \
     } while (0)
 
@@ -9614,6 +10499,44 @@ wasm_loader_emit_ptr(WASMLoaderContext *ctx, void *value)
     }
 }
 
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+static uint32
+get_code_compiled_pos(WASMLoaderContext *ctx)
+{
+    return (uint32)(ctx->p_code_compiled
+                    - (ctx->p_code_compiled_end - ctx->code_compiled_peak_size));
+}
+
+/* Record that the slot to emit holds a label address or an address of
+   the processed code, if the relocations can't be recorded, the code
+   isn't saved to the cache */
+static void
+wasm_loader_record_code_reloc(WASMLoaderContext *ctx, bool is_label)
+{
+    uint32 *code_relocs, max_count;
+
+    if (!ctx->p_code_compiled || !ctx->record_code_relocs)
+        return;
+
+    if (ctx->code_reloc_count >= ctx->code_reloc_max_count) {
+        max_count = ctx->code_reloc_max_count > 0
+                        ? ctx->code_reloc_max_count * 2
+                        : 64;
+        if (max_count > UINT32_MAX / sizeof(uint32)
+            || !(code_relocs = wasm_runtime_realloc(
+                     ctx->code_relocs, max_count * (uint32)sizeof(uint32)))) {
+            ctx->record_code_relocs = false;
+            return;
+        }
+        ctx->code_relocs = code_relocs;
+        ctx->code_reloc_max_count = max_count;
+    }
+
+    ctx->code_relocs[ctx->code_reloc_count++] =
+        (get_code_compiled_pos(ctx) << 1) | (is_label ? 1 : 0);
+}
+#endif
+
 static void
 wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
 {
@@ -9624,6 +10547,13 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
             ctx->p_code_compiled--;
             bh_assert(((uintptr_t)ctx->p_code_compiled & 1) == 0);
         }
+#endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+        /* Drop the relocations of the slots deleted */
+        while (ctx->code_reloc_count > 0
+               && (ctx->code_relocs[ctx->code_reloc_count - 1] >> 1)
+                      >= get_code_compiled_pos(ctx))
+            ctx->code_reloc_count--;
 #endif
     }
     else {
@@ -9637,6 +10567,63 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
     }
 }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+/* Record the operand offsets of an i32 comparison before they are
+   popped, so that the comparison can be fused with the br_if right
+   after it */
+static void
+record_fusible_i32_cmp(WASMLoaderContext *ctx, uint8 opcode,
+                       uint8 operand_num, uint8 *p_next)
+{
+    BranchBlock *cur_block = ctx->frame_csp - 1;
+    int32 available_stack_cell =
+        (int32)(ctx->stack_cell_num - cur_block->stack_cell_num);
+
+    ctx->fusible_cmp_end = NULL;
+
+    /* The offsets of operands are only emitted when they are really
+       on the stack, e.g. not popped in the stack polymorphic state */
+    if (available_stack_cell < (int32)operand_num)
+        return;
+
+    /* The operand offsets are emitted from the stack top */
+    ctx->fusible_cmp_operands[0] = *(ctx->frame_offset - 1);
+    if (operand_num > 1)
+        ctx->fusible_cmp_operands[1] = *(ctx->frame_offset - 2);
+    ctx->fusible_cmp_opcode = opcode;
+    ctx->fusible_cmp_operand_num = operand_num;
+    ctx->fusible_cmp_end = p_next;
+}
+
+/* Replace the i32 comparison and the br_if right after it with one
+   EXT_OP_I32_XXX_BR_IF opcode, which tests the comparison result
+   directly instead of storing it to a slot and loading it again.
+   The br info of br_if is emitted after it as usual. */
+static bool
+fuse_i32_cmp_and_br_if(WASMLoaderContext *loader_ctx, uint8 *p_br_if)
+{
+    uint8 operand_num = loader_ctx->fusible_cmp_operand_num, i;
+
+    if (loader_ctx->fusible_cmp_end != p_br_if)
+        return false;
+
+    /* delete br_if, the operand and result offsets of the comparison
+       and the comparison itself */
+    skip_label();
+    wasm_loader_emit_backspace(loader_ctx,
+                               (uint32)sizeof(int16) * (operand_num + 1));
+    skip_label();
+
+    emit_label(EXT_OP_I32_EQZ_BR_IF
+               + (loader_ctx->fusible_cmp_opcode - WASM_OP_I32_EQZ));
+    for (i = 0; i < operand_num; i++)
+        emit_operand(loader_ctx, loader_ctx->fusible_cmp_operands[i]);
+
+    loader_ctx->fusible_cmp_end = NULL;
+    return true;
+}
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS */
+
 static bool
 preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                           uint32 local_index, uint32 local_type,
@@ -9887,6 +10874,7 @@ wasm_loader_emit_br_info(WASMLoaderContext *ctx, BranchBlock *frame_csp,
     }
 
     /* Part f */
+    record_code_reloc(ctx, false);
     if (frame_csp->label_type == LABEL_TYPE_LOOP) {
         wasm_loader_emit_ptr(ctx, frame_csp->code_compiled);
     }
@@ -10732,7 +11720,7 @@ check_memory_access_align(uint8 opcode, uint32 align, char *error_buf,
 
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
 static bool
 check_simd_memory_access_align(uint8 opcode, uint32 align, char *error_buf,
                                uint32 error_buf_size)
@@ -11783,6 +12771,9 @@ wasm_loader_prepare_bytecode(WASMModule *module, WASMFunction *func,
     loader_ctx->ref_type_set = module->ref_type_set;
     loader_ctx->ref_type_tmp = &wasm_ref_type;
 #endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    loader_ctx->record_code_relocs = module->fast_interp_cache_enabled;
+#endif
 
 #if WASM_ENABLE_FAST_INTERP != 0
     /* For the first traverse, the initial value of preserved_local_offset has
@@ -12688,7 +13679,15 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                bool cmp_fused = fuse_i32_cmp_and_br_if(loader_ctx, p - 1);
+#endif
                 POP_I32();
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                /* the fused opcode evaluates the condition itself */
+                if (cmp_fused)
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+#endif
 
                 if (!(frame_csp_tmp =
                           check_branch_block(loader_ctx, &p, p_end, opcode,
@@ -12790,8 +13789,27 @@ re_scan:
                                 br_table_cache->br_depths[j] = p_depth_begin[j];
                             }
                             br_table_cache->br_depths[i] = depth;
+#if WASM_ENABLE_LAZY_VALIDATION != 0 && defined(os_atomic_thread_fence)
+                            if (module->lazy_validation) {
+                                /* The list may be walked by functions
+                                   running in other threads, make the
+                                   node initialized before linking it */
+                                br_table_cache->next = bh_list_first_elem(
+                                    module->br_table_cache_list);
+                                os_atomic_thread_fence(
+                                    os_memory_order_release);
+                            }
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+                            if (module->parallel_load_lock)
+                                os_mutex_lock(module->parallel_load_lock);
+#endif
                             bh_list_insert(module->br_table_cache_list,
                                            br_table_cache);
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+                            if (module->parallel_load_lock)
+                                os_mutex_unlock(module->parallel_load_lock);
+#endif
                         }
                         else {
                             /* The depth can be stored in one byte, use the
@@ -13246,7 +14264,7 @@ re_scan:
                     }
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
                     else if (*(loader_ctx->frame_ref - 1) == VALUE_TYPE_V128) {
                         loader_ctx->frame_ref -= 4;
                         loader_ctx->stack_cell_num -= 4;
@@ -13343,7 +14361,7 @@ re_scan:
                             break;
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
                         case VALUE_TYPE_V128:
 #if WASM_ENABLE_SIMDE != 0
                             if (loader_ctx->p_code_compiled) {
@@ -13378,7 +14396,7 @@ re_scan:
 #endif /* end of WASM_ENABLE_FAST_INTERP */
                             break;
 #endif /* (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) || \
-          (WASM_ENABLE_FAST_INTERP != 0) */
+          (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0) */
 #endif /* WASM_ENABLE_SIMD != 0 */
                         default:
                         {
@@ -14486,6 +15504,9 @@ re_scan:
                 break;
 
             case WASM_OP_I32_EQZ:
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                record_fusible_i32_cmp(loader_ctx, opcode, 1, p);
+#endif
                 POP_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_I32);
                 break;
 
@@ -14499,6 +15520,9 @@ re_scan:
             case WASM_OP_I32_LE_U:
             case WASM_OP_I32_GE_S:
             case WASM_OP_I32_GE_U:
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                record_fusible_i32_cmp(loader_ctx, opcode, 2, p);
+#endif
                 POP2_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_I32);
                 break;
 
@@ -15745,7 +16769,7 @@ re_scan:
                         pb_read_leb_uint32(p, p_end, memidx);
                         check_memidx(module, memidx);
 
-                        if (data_seg_idx >= module->data_seg_count) {
+                        if (data_seg_idx >= get_data_seg_count(module)) {
                             set_error_buf_v(error_buf, error_buf_size,
                                             "unknown data segment %d",
                                             data_seg_idx);
@@ -15772,7 +16796,7 @@ re_scan:
 #if WASM_ENABLE_FAST_INTERP != 0
                         emit_uint32(loader_ctx, data_seg_idx);
 #endif
-                        if (data_seg_idx >= module->data_seg_count) {
+                        if (data_seg_idx >= get_data_seg_count(module)) {
                             set_error_buf(error_buf, error_buf_size,
                                           "unknown data segment");
                             goto fail;
@@ -16103,7 +17127,7 @@ re_scan:
 
 #if WASM_ENABLE_SIMD != 0
 #if (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) \
-    || (WASM_ENABLE_FAST_INTERP != 0)
+    || (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0)
             case WASM_OP_SIMD_PREFIX:
             {
                 uint32 opcode1;
@@ -16805,7 +17829,7 @@ re_scan:
                 break;
             }
 #endif /* end of (WASM_ENABLE_WAMR_COMPILER != 0) || (WASM_ENABLE_JIT != 0) || \
-          (WASM_ENABLE_FAST_INTERP != 0) */
+          (WASM_ENABLE_FAST_INTERP != 0) || (WASM_ENABLE_FAST_JIT != 0) */
 #endif /* end of WASM_ENABLE_SIMD */
 
 #if WASM_ENABLE_SHARED_MEMORY != 0
@@ -17016,10 +18040,26 @@ re_scan:
 
     func->max_stack_cell_num = loader_ctx->preserved_local_offset
                                - loader_ctx->start_dynamic_offset + 1;
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    if (loader_ctx->record_code_relocs) {
+        func->code_relocs = loader_ctx->code_relocs;
+        func->code_reloc_count = loader_ctx->code_reloc_count;
+        loader_ctx->code_relocs = NULL;
+    }
+    else {
+        /* Don't save the module whose code can't be relocated */
+        module->fast_interp_cache_enabled = false;
+    }
+#endif
 #else
     func->max_stack_cell_num = loader_ctx->max_stack_cell_num;
 #endif
     func->max_block_num = loader_ctx->max_csp_num;
+#if WASM_ENABLE_FAST_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0 \
+    && WASM_ENABLE_SIMD != 0
+    func->has_v128 = loader_ctx->has_v128;
+#endif
     return_value = true;
 
 fail:
@@ -51,6 +51,83 @@ wasm_loader_load_from_sections(WASMSection *section_list, char *error_buf,
 void
 wasm_loader_unload(WASMModule *module);
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+/**
+ * Begin to load a WASM module from a byte stream.
+ *
+ * @param args the load arguments, wasm_binary_freeable is ignored as the
+ *        stream loader keeps its own copy of the sections received
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return the stream created, NULL if failed
+ */
+WASMModuleStream *
+wasm_loader_stream_load_begin(const LoadArgs *args, char *error_buf,
+                              uint32 error_buf_size);
+
+/**
+ * Feed the next chunk of the WASM binary to a stream, the function bodies
+ * which are complete are validated and prepared immediately.
+ *
+ * @param stream the stream to feed
+ * @param buf the chunk, which can be freed after the call
+ * @param size the size of the chunk
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return true if success, false otherwise, in which case the stream
+ *         can only be aborted
+ */
+bool
+wasm_loader_stream_load_feed(WASMModuleStream *stream, const uint8 *buf,
+                             uint32 size, char *error_buf,
+                             uint32 error_buf_size);
+
+/**
+ * Finish loading a WASM module from a stream, the stream is destroyed
+ * whether it succeeds or not.
+ *
+ * @param stream the stream to finish
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return return module loaded, NULL if failed
+ */
+WASMModule *
+wasm_loader_stream_load_finish(WASMModuleStream *stream,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                               bool main_module,
+#endif
+                               char *error_buf, uint32 error_buf_size);
+
+/**
+ * Abort loading a WASM module from a stream and destroy the stream.
+ *
+ * @param stream the stream to abort
+ */
+void
+wasm_loader_stream_load_abort(WASMModuleStream *stream);
+#endif
+
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+/**
+ * Validate and prepare a function body of a module loaded with lazy
+ * validation if it hasn't been done, it is published to the other
+ * threads after that.
+ *
+ * @param module the module which defines the function
+ * @param func_idx the index of the function, excluding the import functions
+ * @param error_buf output of the exception info
+ * @param error_buf_size the size of the exception string
+ *
+ * @return true if the function is valid, false otherwise
+ */
+bool
+wasm_loader_validate_func_lazily(WASMModule *module, uint32 func_idx,
+                                 char *error_buf, uint32 error_buf_size);
+#endif
+
 /**
  * Find address of related else opcode and end opcode of opcode block/loop/if
  * according to the start address of opcode.
@@ -18,6 +18,7 @@
 #endif
 #if WASM_ENABLE_JIT != 0
 #include "../compilation/aot_llvm.h"
+#include "../compilation/aot_jit_cache.h"
 #endif
 
 /* Read a value of given type from the address pointed to by the given
@@ -2384,6 +2385,10 @@ init_llvm_jit_functions_stage1(WASMModule *module, char *error_buf,
     option.segue_flags = llvm_jit_options->segue_flags;
     option.quick_invoke_c_api_import =
         llvm_jit_options->quick_invoke_c_api_import;
+    if (module->llvm_jit_cache_enabled) {
+        option.jit_cache_dir = llvm_jit_options->cache_dir;
+        option.jit_cache_module_digest = module->llvm_jit_cache_digest;
+    }
 
 #if WASM_ENABLE_BULK_MEMORY != 0
     option.enable_bulk_memory = true;
@@ -2444,7 +2449,8 @@ init_llvm_jit_functions_stage2(WASMModule *module, char *error_buf,
     if (module->function_count == 0)
         return true;
 
-    if (!aot_compile_wasm(module->comp_ctx)) {
+    if (!aot_jit_cache_load(module->comp_ctx)
+        && !aot_compile_wasm(module->comp_ctx)) {
         aot_last_error = aot_get_last_error();
         bh_assert(aot_last_error != NULL);
         set_error_buf(error_buf, error_buf_size, aot_last_error);
@@ -2537,8 +2543,18 @@ orcjit_thread_callback(void *arg)
     uint32 i;
 
 #if WASM_ENABLE_FAST_JIT != 0
+#if WASM_ENABLE_LAZY_JIT != 0
+    /* Functions are compiled by the interpreter when they become hot
+       if the tier-up threshold is set */
+    bool compile_fast_jit =
+        jit_compiler_get_jit_globals()->tierup_threshold == 0 ? true : false;
+#else
+    bool compile_fast_jit = true;
+#endif
+
     /* Compile fast jit functions of this group */
-    for (i = group_idx; i < func_count; i += group_stride) {
+    for (i = group_idx; compile_fast_jit && i < func_count;
+         i += group_stride) {
         if (!jit_compiler_compile(module, i + module->import_function_count)) {
             LOG_ERROR("failed to compile fast jit function %u\n", i);
             break;
@@ -3491,6 +3507,13 @@ load(const uint8 *buf, uint32 size, WASMModule *module,
         return false;
     }
 
+#if WASM_ENABLE_JIT != 0
+    if (wasm_runtime_get_llvm_jit_options()->cache_dir) {
+        bh_sha256(buf, size, module->llvm_jit_cache_digest);
+        module->llvm_jit_cache_enabled = true;
+    }
+#endif
+
     if (!create_sections(buf, size, &section_list, error_buf, error_buf_size)
         || !load_from_sections(module, section_list, true, wasm_binary_freeable,
                                error_buf, error_buf_size)) {
@@ -3503,6 +3526,83 @@ load(const uint8 *buf, uint32 size, WASMModule *module,
     return true;
 }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+/* Write the active data segments of the default memory into a memory
+   image when they are large enough to be worth mapping */
+static void
+create_memory_image(WASMModule *module)
+{
+    WASMMemory *memory;
+    WASMDataSeg *data_seg;
+    WASMMemoryImage *image;
+    uint64 memory_size, base_offset, data_end = 0, data_size = 0;
+    uint8 offset_type;
+    uint32 i;
+
+    /* Imported and shared memories are initialized by other instances */
+    if (module->import_memory_count > 0 || module->memory_count == 0
+        || (module->memories[0].flags & SHARED_MEMORY_FLAG))
+        return;
+
+    memory = &module->memories[0];
+    memory_size = (uint64)memory->num_bytes_per_page * memory->init_page_count;
+    offset_type = (memory->flags & MEMORY64_FLAG) ? INIT_EXPR_TYPE_I64_CONST
+                                                  : INIT_EXPR_TYPE_I32_CONST;
+
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+
+        /* The offsets of the segments must be known before instantiation,
+           and the out of bounds segments are reported by instantiation */
+        if (data_seg->base_offset.init_expr_type != offset_type)
+            return;
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->base_offset.u.unary.v.i64
+                          : (uint32)data_seg->base_offset.u.unary.v.i32;
+        if (base_offset > memory_size
+            || data_seg->data_length > memory_size - base_offset)
+            return;
+
+        if (base_offset + data_seg->data_length > data_end)
+            data_end = base_offset + data_seg->data_length;
+        data_size += data_seg->data_length;
+    }
+
+    if (data_size < WASM_MEMORY_IMAGE_MIN_DATA_SIZE
+        || !(image = wasm_memory_image_create(data_end)))
+        return;
+
+    /* Later segments overwrite the earlier ones like on instantiation */
+    for (i = 0; i < module->data_seg_count; i++) {
+        data_seg = module->data_segments[i];
+#if WASM_ENABLE_BULK_MEMORY != 0
+        if (data_seg->is_passive)
+            continue;
+#endif
+        if (data_seg->memory_index != 0)
+            continue;
+
+        base_offset = offset_type == INIT_EXPR_TYPE_I64_CONST
+                          ? (uint64)data_seg->base_offset.u.unary.v.i64
+                          : (uint32)data_seg->base_offset.u.unary.v.i32;
+        if (!wasm_memory_image_write(image, base_offset, data_seg->data,
+                                     data_seg->data_length)) {
+            LOG_WARNING("write memory image failed");
+            wasm_memory_image_destroy(image);
+            return;
+        }
+    }
+
+    module->memory_image = image;
+}
+#endif /* end of WASM_ENABLE_MEMORY_IMAGE != 0 */
+
 WASMModule *
 wasm_loader_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -3530,6 +3630,10 @@ wasm_loader_load(uint8 *buf, uint32 size,
     (void)main_module;
 #endif
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    create_memory_image(module);
+#endif
+
     LOG_VERBOSE("Load module success.\n");
     return module;
 
@@ -3603,6 +3707,9 @@ wasm_loader_unload(WASMModule *module)
                     jit_code_cache_free(
                         module->functions[i]->fast_jit_jitted_code);
                 }
+#if WASM_ENABLE_LAZY_JIT != 0
+                jit_free(module->functions[i]->fast_jit_osr_entries);
+#endif
 #if WASM_ENABLE_JIT != 0 && WASM_ENABLE_LAZY_JIT != 0
                 if (module->functions[i]->call_to_fast_jit_from_llvm_jit) {
                     jit_code_cache_free(
@@ -3659,6 +3766,11 @@ wasm_loader_unload(WASMModule *module)
         wasm_runtime_free(module->data_segments);
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    if (module->memory_image)
+        wasm_memory_image_destroy(module->memory_image);
+#endif
+
     if (module->const_str_list) {
         StringNode *node = module->const_str_list, *node_next;
         while (node) {
@@ -4293,6 +4405,16 @@ typedef struct WASMLoaderContext {
      * than the final code_compiled_size, we record the peak size to ensure
      * there will not be invalid memory access during second traverse */
     uint32 code_compiled_peak_size;
+
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* the last i32 comparison which may be fused with the br_if
+       following it, fusible_cmp_end is the wasm bytecode right after
+       the comparison */
+    uint8 *fusible_cmp_end;
+    uint8 fusible_cmp_opcode;
+    uint8 fusible_cmp_operand_num;
+    int16 fusible_cmp_operands[2];
+#endif
 #endif
 } WASMLoaderContext;
 
@@ -4955,6 +5077,63 @@ wasm_loader_emit_backspace(WASMLoaderContext *ctx, uint32 size)
     }
 }
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+/* Record the operand offsets of an i32 comparison before they are
+   popped, so that the comparison can be fused with the br_if right
+   after it */
+static void
+record_fusible_i32_cmp(WASMLoaderContext *ctx, uint8 opcode,
+                       uint8 operand_num, uint8 *p_next)
+{
+    BranchBlock *cur_block = ctx->frame_csp - 1;
+    int32 available_stack_cell =
+        (int32)(ctx->stack_cell_num - cur_block->stack_cell_num);
+
+    ctx->fusible_cmp_end = NULL;
+
+    /* The offsets of operands are only emitted when they are really
+       on the stack, e.g. not popped in the stack polymorphic state */
+    if (available_stack_cell < (int32)operand_num)
+        return;
+
+    /* The operand offsets are emitted from the stack top */
+    ctx->fusible_cmp_operands[0] = *(ctx->frame_offset - 1);
+    if (operand_num > 1)
+        ctx->fusible_cmp_operands[1] = *(ctx->frame_offset - 2);
+    ctx->fusible_cmp_opcode = opcode;
+    ctx->fusible_cmp_operand_num = operand_num;
+    ctx->fusible_cmp_end = p_next;
+}
+
+/* Replace the i32 comparison and the br_if right after it with one
+   EXT_OP_I32_XXX_BR_IF opcode, which tests the comparison result
+   directly instead of storing it to a slot and loading it again.
+   The br info of br_if is emitted after it as usual. */
+static bool
+fuse_i32_cmp_and_br_if(WASMLoaderContext *loader_ctx, uint8 *p_br_if)
+{
+    uint8 operand_num = loader_ctx->fusible_cmp_operand_num, i;
+
+    if (loader_ctx->fusible_cmp_end != p_br_if)
+        return false;
+
+    /* delete br_if, the operand and result offsets of the comparison
+       and the comparison itself */
+    skip_label();
+    wasm_loader_emit_backspace(loader_ctx,
+                               (uint32)sizeof(int16) * (operand_num + 1));
+    skip_label();
+
+    emit_label(EXT_OP_I32_EQZ_BR_IF
+               + (loader_ctx->fusible_cmp_opcode - WASM_OP_I32_EQZ));
+    for (i = 0; i < operand_num; i++)
+        emit_operand(loader_ctx, loader_ctx->fusible_cmp_operands[i]);
+
+    loader_ctx->fusible_cmp_end = NULL;
+    return true;
+}
+#endif /* end of WASM_ENABLE_SUPERINSTRUCTIONS */
+
 static bool
 preserve_referenced_local(WASMLoaderContext *loader_ctx, uint8 opcode,
                           uint32 local_index, uint32 local_type,
@@ -6885,7 +7064,15 @@ re_scan:
 
             case WASM_OP_BR_IF:
             {
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                bool cmp_fused = fuse_i32_cmp_and_br_if(loader_ctx, p - 1);
+#endif
                 POP_I32();
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                /* the fused opcode evaluates the condition itself */
+                if (cmp_fused)
+                    wasm_loader_emit_backspace(loader_ctx, sizeof(int16));
+#endif
 
                 if (!(frame_csp_tmp =
                           check_branch_block(loader_ctx, &p, p_end, opcode,
@@ -8009,6 +8196,9 @@ re_scan:
                 break;
 
             case WASM_OP_I32_EQZ:
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                record_fusible_i32_cmp(loader_ctx, opcode, 1, p);
+#endif
                 POP_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_I32);
                 break;
 
@@ -8022,6 +8212,9 @@ re_scan:
             case WASM_OP_I32_LE_U:
             case WASM_OP_I32_GE_S:
             case WASM_OP_I32_GE_U:
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+                record_fusible_i32_cmp(loader_ctx, opcode, 2, p);
+#endif
                 POP2_AND_PUSH(VALUE_TYPE_I32, VALUE_TYPE_I32);
                 break;
 
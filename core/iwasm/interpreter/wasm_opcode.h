@@ -287,6 +287,21 @@ typedef enum WASMOpcode {
     WASM_OP_SELECT_128 = 0xe2,
 #endif
 
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+    /* i32 comparison fused with the br_if consuming its result */
+    EXT_OP_I32_EQZ_BR_IF = 0xe3,
+    EXT_OP_I32_EQ_BR_IF = 0xe4,
+    EXT_OP_I32_NE_BR_IF = 0xe5,
+    EXT_OP_I32_LT_S_BR_IF = 0xe6,
+    EXT_OP_I32_LT_U_BR_IF = 0xe7,
+    EXT_OP_I32_GT_S_BR_IF = 0xe8,
+    EXT_OP_I32_GT_U_BR_IF = 0xe9,
+    EXT_OP_I32_LE_S_BR_IF = 0xea,
+    EXT_OP_I32_LE_U_BR_IF = 0xeb,
+    EXT_OP_I32_GE_S_BR_IF = 0xec,
+    EXT_OP_I32_GE_U_BR_IF = 0xed,
+#endif
+
     /* Post-MVP extend op prefix */
     WASM_OP_GC_PREFIX = 0xfb,
     WASM_OP_MISC_PREFIX = 0xfc,
@@ -802,6 +817,24 @@ typedef enum WASMAtomicEXTOpcode {
 #else
 #define DEF_EXT_V128_HANDLE()
 #endif
+
+#if WASM_ENABLE_SUPERINSTRUCTIONS != 0
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()                      \
+    SET_GOTO_TABLE_ELEM(EXT_OP_I32_EQZ_BR_IF),      /* 0xe3 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_EQ_BR_IF),   /* 0xe4 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_NE_BR_IF),   /* 0xe5 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LT_S_BR_IF), /* 0xe6 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LT_U_BR_IF), /* 0xe7 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GT_S_BR_IF), /* 0xe8 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GT_U_BR_IF), /* 0xe9 */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LE_S_BR_IF), /* 0xea */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_LE_U_BR_IF), /* 0xeb */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GE_S_BR_IF), /* 0xec */ \
+        SET_GOTO_TABLE_ELEM(EXT_OP_I32_GE_U_BR_IF), /* 0xed */
+
+#else
+#define DEF_EXT_SUPERINSTRUCTION_HANDLE()
+#endif
 /*
  * Macro used to generate computed goto tables for the C interpreter.
  */
@@ -1034,6 +1067,7 @@ typedef enum WASMAtomicEXTOpcode {
         SET_GOTO_TABLE_ELEM(WASM_OP_SIMD_PREFIX),    /* 0xfd */ \
         SET_GOTO_TABLE_ELEM(WASM_OP_ATOMIC_PREFIX),  /* 0xfe */ \
         DEF_DEBUG_BREAK_HANDLE() DEF_EXT_V128_HANDLE()          \
+            DEF_EXT_SUPERINSTRUCTION_HANDLE()                   \
     };
 
 #ifdef __cplusplus
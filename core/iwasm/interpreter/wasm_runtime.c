@@ -18,6 +18,12 @@
 #if WASM_ENABLE_SHARED_MEMORY != 0
 #include "../common/wasm_shared_memory.h"
 #endif
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+#include "../common/wasm_instance_snapshot.h"
+#endif
+#if WASM_ENABLE_INSTANCE_RESET != 0
+#include "../common/wasm_instance_reset.h"
+#endif
 #if WASM_ENABLE_THREAD_MGR != 0
 #include "../libraries/thread-mgr/thread_manager.h"
 #endif
@@ -77,6 +83,43 @@ wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                                           error_buf_size);
 }
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModuleStream *
+wasm_stream_load_begin(const LoadArgs *args, char *error_buf,
+                       uint32 error_buf_size)
+{
+    return wasm_loader_stream_load_begin(args, error_buf, error_buf_size);
+}
+
+bool
+wasm_stream_load_feed(WASMModuleStream *stream, const uint8 *buf, uint32 size,
+                      char *error_buf, uint32 error_buf_size)
+{
+    return wasm_loader_stream_load_feed(stream, buf, size, error_buf,
+                                        error_buf_size);
+}
+
+WASMModule *
+wasm_stream_load_finish(WASMModuleStream *stream,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                        bool main_module,
+#endif
+                        char *error_buf, uint32 error_buf_size)
+{
+    return wasm_loader_stream_load_finish(stream,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                                          main_module,
+#endif
+                                          error_buf, error_buf_size);
+}
+
+void
+wasm_stream_load_abort(WASMModuleStream *stream)
+{
+    wasm_loader_stream_load_abort(stream);
+}
+#endif
+
 void
 wasm_unload(WASMModule *module)
 {
@@ -277,7 +320,7 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
                    WASMMemoryInstance *memory, uint32 memory_idx,
                    uint32 num_bytes_per_page, uint32 init_page_count,
                    uint32 max_page_count, uint32 heap_size, uint32 flags,
-                   char *error_buf, uint32 error_buf_size)
+                   bool *p_image_mapped, char *error_buf, uint32 error_buf_size)
 {
     WASMModule *module = module_inst->module;
     uint32 inc_page_count, global_idx, default_max_page;
@@ -455,6 +498,23 @@ memory_instantiate(WASMModuleInstance *module_inst, WASMModuleInstance *parent,
         memory->memory_data_end = memory->memory_data + memory_data_size;
     }
 
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+    /* Map the data segments before the app heap is initialized, as the
+       last page of the image may be shared with the app heap */
+    if (p_image_mapped && module->memory_image
+        && module->memory_image->size <= memory_data_size
+        && (heap_size == 0 || module->memory_image->data_end <= heap_offset)) {
+        if (!wasm_memory_image_map(memory, module->memory_image)) {
+            set_error_buf(error_buf, error_buf_size,
+                          "map memory image failed");
+            goto fail1;
+        }
+        *p_image_mapped = true;
+    }
+#else
+    (void)p_image_mapped;
+#endif
+
     /* Initialize heap */
     if (memory_idx == 0 && heap_size > 0) {
         uint32 heap_struct_size = mem_allocator_get_heap_struct_size();
@@ -501,8 +561,8 @@ fail1:
 static WASMMemoryInstance **
 memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
                      WASMModuleInstance *parent, uint32 heap_size,
-                     uint32 max_memory_pages, char *error_buf,
-                     uint32 error_buf_size)
+                     uint32 max_memory_pages, bool *p_image_mapped,
+                     char *error_buf, uint32 error_buf_size)
 {
     WASMImport *import;
     uint32 mem_index = 0, i,
@@ -554,7 +614,8 @@ memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
             if (!(memories[mem_index] = memory_instantiate(
                       module_inst, parent, memory, mem_index,
                       num_bytes_per_page, init_page_count, max_page_count,
-                      actual_heap_size, flags, error_buf, error_buf_size))) {
+                      actual_heap_size, flags, NULL, error_buf,
+                      error_buf_size))) {
                 memories_deinstantiate(module_inst, memories, memory_count);
                 return NULL;
             }
@@ -571,7 +632,8 @@ memories_instantiate(const WASMModule *module, WASMModuleInstance *module_inst,
                   module_inst, parent, memory, mem_index,
                   module->memories[i].num_bytes_per_page,
                   module->memories[i].init_page_count, max_page_count,
-                  heap_size, module->memories[i].flags, error_buf,
+                  heap_size, module->memories[i].flags,
+                  mem_index == 0 ? p_image_mapped : NULL, error_buf,
                   error_buf_size))) {
             memories_deinstantiate(module_inst, memories, memory_count);
             return NULL;
@@ -2178,7 +2240,10 @@ wasm_global_traverse_gc_rootset(WASMModuleInstance *module_inst, void *heap)
             gc_obj = GET_REF_FROM_ADDR(
                 (uint32 *)(global_data + global->data_offset));
             if (wasm_obj_is_created_from_heap(gc_obj)) {
-                if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                if (0
+                    != mem_allocator_add_root_slot(
+                        (mem_allocator_t)heap,
+                        global_data + global->data_offset))
                     return false;
             }
         }
@@ -2200,7 +2265,9 @@ wasm_table_traverse_gc_rootset(WASMModuleInstance *module_inst, void *heap)
         for (j = 0; j < table->cur_size; j++) {
             gc_obj = table_elems[j];
             if (wasm_obj_is_created_from_heap(gc_obj)) {
-                if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+                if (0
+                    != mem_allocator_add_root_slot((mem_allocator_t)heap,
+                                                   &table_elems[j]))
                     return false;
             }
         }
@@ -2218,7 +2285,7 @@ local_object_refs_traverse_gc_rootset(WASMExecEnv *exec_env, void *heap)
     for (r = exec_env->cur_local_object_ref; r; r = r->prev) {
         gc_obj = r->val;
         if (wasm_obj_is_created_from_heap(gc_obj)) {
-            if (0 != mem_allocator_add_root((mem_allocator_t)heap, gc_obj))
+            if (0 != mem_allocator_add_root_slot((mem_allocator_t)heap, &r->val))
                 return false;
         }
     }
@@ -2440,6 +2507,12 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
     bool ret = false;
 #endif
     const bool is_sub_inst = parent != NULL;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    const WASMInstanceSnapshot *snapshot = is_sub_inst ? NULL : args->snapshot;
+#endif
+    /* Whether the data segments of the default memory are mapped from
+       the memory image of the module */
+    bool memory_image_mapped = false, *p_memory_image_mapped = NULL;
     uint32 stack_size = args->v1.default_stack_size;
     uint32 heap_size = args->v1.host_managed_heap_size;
     uint32 max_memory_pages = args->v1.max_memory_pages;
@@ -2628,11 +2701,20 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
         get_export_count(module, EXPORT_KIND_GLOBAL);
 #endif
 
+    /* The data segments are only applied to the memories of the main
+       instance, and not when the memory data is restored from a snapshot */
+    if (!is_sub_inst
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        && !snapshot
+#endif
+    )
+        p_memory_image_mapped = &memory_image_mapped;
+
     /* Instantiate memories/tables/functions/tags */
     if ((module_inst->memory_count > 0
          && !(module_inst->memories = memories_instantiate(
                   module, module_inst, parent, heap_size, max_memory_pages,
-                  error_buf, error_buf_size)))
+                  p_memory_image_mapped, error_buf, error_buf_size)))
         || (module_inst->table_count > 0
             && !(module_inst->tables =
                      tables_instantiate(module, module_inst, first_table,
@@ -2795,6 +2877,16 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                initialized */
             continue;
 
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        if (snapshot)
+            /* The memory data is restored from the snapshot */
+            continue;
+#endif
+
+        if (memory_image_mapped && data_seg->memory_index == 0)
+            /* The memory data is mapped from the memory image */
+            continue;
+
         /* has check it in loader */
         memory = module_inst->memories[data_seg->memory_index];
         bh_assert(memory);
@@ -3330,11 +3422,23 @@ wasm_instantiate(WASMModule *module, WASMModuleInstance *parent,
                 &module_inst->e->functions[module->start_function];
     }
 
-    if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
-                                            exec_env_main)) {
-        set_error_buf(error_buf, error_buf_size, module_inst->cur_exception);
-        goto fail;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    /* The snapshot holds the state after the post instantiation functions
+       were executed, don't execute them again */
+    if (snapshot) {
+        if (!wasm_instance_snapshot_restore(
+                (WASMModuleInstanceCommon *)module_inst, snapshot, error_buf,
+                error_buf_size))
+            goto fail;
     }
+    else
+#endif
+        if (!execute_post_instantiate_functions(module_inst, is_sub_inst,
+                                                exec_env_main)) {
+            set_error_buf(error_buf, error_buf_size,
+                          module_inst->cur_exception);
+            goto fail;
+        }
 
 #if WASM_ENABLE_MEMORY_TRACING != 0
     wasm_runtime_dump_module_inst_mem_consumption(
@@ -3500,6 +3604,9 @@ wasm_deinstantiate(WASMModuleInstance *module_inst, bool is_sub_inst)
 #if WASM_ENABLE_REF_TYPES != 0
     bh_bitmap_delete(module_inst->e->common.elem_dropped);
 #endif
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    wasm_instance_reset_destroy((WASMModuleInstanceCommon *)module_inst);
+#endif
 
     wasm_runtime_free(module_inst);
 }
@@ -3523,6 +3630,42 @@ wasm_lookup_function(const WASMModuleInstance *module_inst, const char *name)
     return export_func_inst->function;
 }
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+bool
+wasm_validate_func_lazily(WASMModuleInstance *module_inst,
+                          WASMFunctionInstance *func)
+{
+    WASMModuleInstance *func_module_inst = module_inst;
+    uint32 func_idx;
+    char error_buf[128];
+
+    while (func->is_import_func) {
+#if WASM_ENABLE_MULTI_MODULE != 0
+        /* The function called is defined by the sub module */
+        if (func->import_func_inst) {
+            func_module_inst = func->import_module_inst;
+            func = func->import_func_inst;
+            continue;
+        }
+#endif
+        return true;
+    }
+
+    if (BH_ATOMIC_32_LOAD(func->u.func->lazy_state) == LAZY_FUNC_VALIDATED)
+        return true;
+
+    func_idx = (uint32)(func - func_module_inst->e->functions)
+               - func_module_inst->module->import_function_count;
+    if (!wasm_loader_validate_func_lazily(func_module_inst->module, func_idx,
+                                          error_buf, sizeof(error_buf))) {
+        wasm_set_exception(module_inst, error_buf);
+        return false;
+    }
+
+    return true;
+}
+#endif /* end of WASM_ENABLE_LAZY_VALIDATION != 0 */
+
 WASMMemoryInstance *
 wasm_lookup_memory(const WASMModuleInstance *module_inst, const char *name)
 {
@@ -124,9 +124,11 @@ struct WASMMemoryInstance {
          0: non-shared memory, > 0: shared memory */
     bh_atomic_16_t ref_count;
 
-    /* Four-byte paddings to ensure the layout of WASMMemoryInstance is the same
-     * in both 64-bit and 32-bit */
-    uint8 _paddings[4];
+    /* Page count of the memory before it was last shrunk, the peak page
+     * count is the larger one of it and cur_page_count. It also ensures
+     * the layout of WASMMemoryInstance is the same in both 64-bit and
+     * 32-bit */
+    uint32 peak_page_count;
 
     /* Number bytes per page */
     uint32 num_bytes_per_page;
@@ -334,6 +336,11 @@ typedef struct WASMModuleInstanceExtraCommon {
     /* The gc heap created */
     void *gc_heap_handle;
 #endif
+
+#if WASM_ENABLE_INSTANCE_RESET != 0
+    /* The state saved to reset the instance to */
+    struct WASMInstanceResetState *reset_state;
+#endif
 } WASMModuleInstanceExtraCommon;
 
 /* Extra info of WASM module instance for interpreter/jit mode */
@@ -530,6 +537,32 @@ wasm_get_func_code_end(WASMFunctionInstance *func)
 #endif
 }
 
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+/**
+ * Validate and prepare the function called if its module was loaded with
+ * lazy validation and it hasn't been called before.
+ *
+ * @param module_inst the module instance calling the function, the
+ *        exception is set to it if the function is invalid
+ * @param func the WASM function instance to call
+ *
+ * @return true if the function can be called, false otherwise
+ */
+bool
+wasm_validate_func_lazily(WASMModuleInstance *module_inst,
+                          WASMFunctionInstance *func);
+
+static inline bool
+wasm_ensure_func_validated(WASMModuleInstance *module_inst,
+                           WASMFunctionInstance *func)
+{
+    if (!func->is_import_func
+        && BH_ATOMIC_32_LOAD(func->u.func->lazy_state) == LAZY_FUNC_VALIDATED)
+        return true;
+    return wasm_validate_func_lazily(module_inst, func);
+}
+#endif
+
 WASMModule *
 wasm_load(uint8 *buf, uint32 size,
 #if WASM_ENABLE_MULTI_MODULE != 0
@@ -541,6 +574,26 @@ WASMModule *
 wasm_load_from_sections(WASMSection *section_list, char *error_buf,
                         uint32 error_buf_size);
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+WASMModuleStream *
+wasm_stream_load_begin(const LoadArgs *args, char *error_buf,
+                       uint32 error_buf_size);
+
+bool
+wasm_stream_load_feed(WASMModuleStream *stream, const uint8 *buf, uint32 size,
+                      char *error_buf, uint32 error_buf_size);
+
+WASMModule *
+wasm_stream_load_finish(WASMModuleStream *stream,
+#if WASM_ENABLE_MULTI_MODULE != 0
+                        bool main_module,
+#endif
+                        char *error_buf, uint32 error_buf_size);
+
+void
+wasm_stream_load_abort(WASMModuleStream *stream);
+#endif
+
 void
 wasm_unload(WASMModule *module);
 
@@ -4,6 +4,9 @@
  */
 
 #include "ems_gc_internal.h"
+#if GC_ENABLE_THREAD_CACHE != 0
+#include "bh_atomic.h"
+#endif
 
 #if WASM_ENABLE_GC != 0
 #define LOCK_HEAP(heap)                                                \
@@ -502,10 +505,55 @@ do_gc_heap(gc_heap_t *heap)
     if (time > heap->max_gc_time) {
         heap->max_gc_time = time;
     }
-    heap->total_gc_count += 1;
 #endif
     return ret;
 }
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+static void
+do_compact_heap(gc_heap_t *heap)
+{
+    if (heap->is_reclaim_enabled) {
+        UNLOCK_HEAP(heap);
+        gci_compact_heap(heap);
+        LOCK_HEAP(heap);
+    }
+}
+#endif
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/**
+ * Do an incremental marking step once enough bytes are allocated in
+ * the marking cycle, the heap lock must be held by the caller
+ *
+ * @param heap should be a valid heap
+ * @param size bytes to allocate
+ */
+static void
+do_gc_heap_step(gc_heap_t *heap, gc_size_t size)
+{
+    uint64 budget;
+
+    if (!heap->is_reclaim_enabled)
+        return;
+
+    if (heap->is_marking) {
+        budget = (uint64)heap->mark_budget
+                 + (uint64)size * GC_INCREMENTAL_MARK_RATIO;
+        heap->mark_budget = budget < heap->current_size
+                                ? (gc_size_t)budget
+                                : heap->current_size;
+        if (heap->mark_budget < GC_INCREMENTAL_MIN_STEP_SIZE)
+            return;
+    }
+
+    UNLOCK_HEAP(heap);
+    /* the marking cycle is rolled back if the step fails, and a full
+       collection is still tried when the free space runs low */
+    gci_gc_heap_step(heap);
+    LOCK_HEAP(heap);
+}
+#endif
 #endif
 
 /**
@@ -534,6 +582,10 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
     if (GC_SUCCESS != do_gc_heap(heap))
         return NULL;
 #else
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (heap->is_marking || gc_need_start_marking(heap))
+        do_gc_heap_step(heap, size);
+#endif
     if (heap->total_free_size < heap->gc_threshold) {
         if (GC_SUCCESS != do_gc_heap(heap))
             return NULL;
@@ -549,9 +601,426 @@ alloc_hmu_ex(gc_heap_t *heap, gc_size_t size)
 #endif
 #endif
 
+#if WASM_ENABLE_GC_COMPACTION != 0
+    {
+        hmu_t *ret = NULL;
+        if ((ret = alloc_hmu(heap, size)) || heap->total_free_size < size)
+            return ret;
+        /* there is enough free space but no free chunk is big enough,
+           compact the heap to merge the free chunks and try again */
+        do_compact_heap(heap);
+    }
+#endif
+
     return alloc_hmu(heap, size);
 }
 
+/**
+ * Free a VO chunk and merge it with its free neighbors
+ *
+ * @param heap should not be NULL and should be a valid heap, its lock
+ *        must be held by the caller
+ * @param hmu should be a VO chunk inside @heap which isn't freed
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+free_vo_hmu(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_uint8 *base_addr = heap->base_addr;
+    gc_uint8 *end_addr = base_addr + heap->current_size;
+    hmu_t *prev = NULL, *next = NULL;
+    gc_size_t size = hmu_get_size(hmu);
+
+    heap->total_free_size += size;
+
+#if GC_STAT_DATA != 0
+    heap->total_size_freed += size;
+#endif
+
+    if (!hmu_get_pinuse(hmu)) {
+        prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
+
+        if (hmu_is_in_heap(prev, base_addr, end_addr)
+            && hmu_get_ut(prev) == HMU_FC) {
+            size += hmu_get_size(prev);
+            hmu = prev;
+            if (!unlink_hmu(heap, prev))
+                return GC_ERROR;
+        }
+    }
+
+    next = (hmu_t *)((char *)hmu + size);
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        if (hmu_get_ut(next) == HMU_FC) {
+            size += hmu_get_size(next);
+            if (!unlink_hmu(heap, next))
+                return GC_ERROR;
+            next = (hmu_t *)((char *)hmu + size);
+        }
+    }
+
+    if (!gci_add_fc(heap, hmu, size))
+        return GC_ERROR;
+
+    if (hmu_is_in_heap(next, base_addr, end_addr)) {
+        hmu_unmark_pinuse(next);
+    }
+
+    return GC_SUCCESS;
+}
+
+#if GC_ENABLE_THREAD_CACHE != 0
+/* Index + 1 of the thread cache used by current thread, 0 if it isn't
+   assigned yet, the same index is used for all heaps */
+static os_thread_local_attribute uint32 thread_cache_idx = 0;
+
+static bh_atomic_32_t thread_cache_next_idx = 0;
+
+static gc_thread_cache_t *
+get_thread_cache(gc_heap_t *heap)
+{
+    if (thread_cache_idx == 0)
+        thread_cache_idx = BH_ATOMIC_32_FETCH_ADD(thread_cache_next_idx, 1)
+                               % GC_THREAD_CACHE_NUM
+                           + 1;
+    return heap->thread_caches + thread_cache_idx - 1;
+}
+
+/**
+ * Return the cached chunks of a size class except the first @keep_cnt
+ * ones back to the heap, both the lock of the thread cache and the lock
+ * of the heap must be held by the caller
+ */
+static int
+thread_cache_flush_bin(gc_heap_t *heap, gc_thread_cache_t *cache,
+                       uint32 bin_idx, uint32 keep_cnt)
+{
+    hmu_normal_node_t *node = cache->bins[bin_idx], *prev = NULL, *next;
+    uint32 i;
+
+    for (i = 0; i < keep_cnt && node; i++) {
+        prev = node;
+        node = get_hmu_normal_node_next(node);
+    }
+
+    if (prev)
+        set_hmu_normal_node_next(prev, NULL);
+    else
+        cache->bins[bin_idx] = NULL;
+    cache->cached_size -= (cache->bin_counts[bin_idx] - i) * (bin_idx << 3);
+    cache->bin_counts[bin_idx] = (uint16)i;
+
+    while (node) {
+        next = get_hmu_normal_node_next(node);
+        if (free_vo_hmu(heap, (hmu_t *)node) != GC_SUCCESS)
+            /* the heap is corrupted, the left chunks are leaked */
+            return GC_ERROR;
+        node = next;
+    }
+    return GC_SUCCESS;
+}
+
+static int
+thread_cache_flush(gc_heap_t *heap, gc_thread_cache_t *cache)
+{
+    uint32 i;
+    int ret = GC_SUCCESS;
+
+    LOCK_HEAP(heap);
+    for (i = 0; i < GC_THREAD_CACHE_BIN_CNT; i++) {
+        if (cache->bins[i]
+            && thread_cache_flush_bin(heap, cache, i, 0) != GC_SUCCESS)
+            ret = GC_ERROR;
+    }
+    UNLOCK_HEAP(heap);
+    return ret;
+}
+
+void
+gci_flush_thread_caches(gc_heap_t *heap)
+{
+    gc_thread_cache_t *cache;
+    uint32 i;
+
+    for (i = 0; i < GC_THREAD_CACHE_NUM; i++) {
+        cache = heap->thread_caches + i;
+        os_mutex_lock(&cache->lock);
+        if (cache->cached_size > 0)
+            thread_cache_flush(heap, cache);
+        os_mutex_unlock(&cache->lock);
+    }
+}
+
+gc_size_t
+gci_get_thread_cached_size(gc_heap_t *heap)
+{
+    gc_thread_cache_t *cache;
+    gc_size_t size = 0;
+    uint32 i;
+
+    for (i = 0; i < GC_THREAD_CACHE_NUM; i++) {
+        cache = heap->thread_caches + i;
+        os_mutex_lock(&cache->lock);
+        size += cache->cached_size;
+        os_mutex_unlock(&cache->lock);
+    }
+    return size;
+}
+
+/**
+ * Allocate a VO chunk from the thread cache of current thread, the size
+ * class is refilled with a batch of chunks from the heap if it is empty
+ *
+ * @param heap should not be NULL and should be a valid heap
+ * @param size should cover the header, be 8 bytes aligned, be cacheable
+ *        and be no less than GC_SMALLEST_SIZE
+ *
+ * @return hmu allocated if success, NULL if the heap can't provide
+ *         a chunk of the size
+ */
+static hmu_t *
+thread_cache_alloc(gc_heap_t *heap, gc_size_t size)
+{
+    gc_thread_cache_t *cache = get_thread_cache(heap);
+    hmu_normal_node_t *node;
+    hmu_t *hmu, *ret = NULL;
+    gc_size_t hmu_size;
+    uint32 bin_idx = size >> 3, i;
+
+    os_mutex_lock(&cache->lock);
+
+    if ((node = cache->bins[bin_idx])) {
+        cache->bins[bin_idx] = get_hmu_normal_node_next(node);
+        cache->bin_counts[bin_idx]--;
+        cache->cached_size -= size;
+        hmu_unfree_vo((hmu_t *)node);
+        os_mutex_unlock(&cache->lock);
+        return (hmu_t *)node;
+    }
+
+    LOCK_HEAP(heap);
+
+    for (i = 0; i < GC_THREAD_CACHE_REFILL_CNT; i++) {
+        if (ret && cache->cached_size + size > GC_THREAD_CACHE_MAX_SIZE)
+            break;
+
+        if (!(hmu = alloc_hmu(heap, size)))
+            break;
+
+        hmu_size = hmu_get_size(hmu);
+#if GC_STAT_DATA != 0
+        heap->total_size_allocated += hmu_size;
+#endif
+        hmu_set_ut(hmu, HMU_VO);
+        hmu_unfree_vo(hmu);
+
+        if (!ret) {
+            ret = hmu;
+            continue;
+        }
+
+        /* alloc_hmu may return a chunk a little bigger than required
+           to avoid leaving a fragment smaller than GC_SMALLEST_SIZE */
+        bin_idx = hmu_size >> 3;
+        if (!GC_THREAD_CACHE_IS_CACHEABLE(hmu_size)
+            || cache->bin_counts[bin_idx] >= GC_THREAD_CACHE_BIN_MAX) {
+            free_vo_hmu(heap, hmu);
+            break;
+        }
+
+        hmu_free_vo(hmu);
+        node = (hmu_normal_node_t *)hmu;
+        set_hmu_normal_node_next(node, cache->bins[bin_idx]);
+        cache->bins[bin_idx] = node;
+        cache->bin_counts[bin_idx]++;
+        cache->cached_size += hmu_size;
+    }
+
+    UNLOCK_HEAP(heap);
+    os_mutex_unlock(&cache->lock);
+    return ret;
+}
+
+/**
+ * Put a VO chunk into the thread cache of current thread instead of
+ * freeing it to the heap, part of the cached chunks are returned to the
+ * heap if the thread cache is full. The freed bit of the chunk is set
+ * while it is cached, so freeing it again is rejected, no matter which
+ * thread cache holds it
+ */
+static int
+thread_cache_free(gc_heap_t *heap, hmu_t *hmu)
+{
+    gc_thread_cache_t *cache;
+    hmu_normal_node_t *node = (hmu_normal_node_t *)hmu;
+    gc_size_t size = hmu_get_size(hmu);
+    uint32 bin_idx = size >> 3;
+    int ret = GC_SUCCESS;
+
+    if (hmu_get_ut(hmu) != HMU_VO)
+        return GC_ERROR;
+
+    cache = get_thread_cache(heap);
+    os_mutex_lock(&cache->lock);
+
+    if (hmu_is_vo_freed(hmu)) {
+        /* double free */
+        bh_assert(0);
+        os_mutex_unlock(&cache->lock);
+        return GC_ERROR;
+    }
+
+    if (cache->bin_counts[bin_idx] >= GC_THREAD_CACHE_BIN_MAX) {
+        LOCK_HEAP(heap);
+        ret = thread_cache_flush_bin(heap, cache, bin_idx,
+                                     GC_THREAD_CACHE_BIN_MAX / 2);
+        UNLOCK_HEAP(heap);
+    }
+    else if (cache->cached_size + size > GC_THREAD_CACHE_MAX_SIZE) {
+        ret = thread_cache_flush(heap, cache);
+    }
+
+    hmu_free_vo(hmu);
+    set_hmu_normal_node_next(node, cache->bins[bin_idx]);
+    cache->bins[bin_idx] = node;
+    cache->bin_counts[bin_idx]++;
+    cache->cached_size += size;
+
+    os_mutex_unlock(&cache->lock);
+    return ret;
+}
+#endif /* end of GC_ENABLE_THREAD_CACHE != 0 */
+
+#if GC_ENABLE_BUMP_ALLOC != 0
+/**
+ * Return the unused part of the bump allocation buffer back to the free
+ * chunks, the heap lock must be held by the caller
+ *
+ * @param heap should be a valid heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+bump_buffer_retire(gc_heap_t *heap)
+{
+    hmu_t *hmu = (hmu_t *)heap->bump_ptr;
+    gc_size_t size = (gc_size_t)(heap->bump_end - heap->bump_ptr);
+
+    heap->bump_ptr = heap->bump_end = NULL;
+
+    if (size == 0)
+        return GC_SUCCESS;
+
+    bh_assert(hmu_get_ut(hmu) == HMU_FM && hmu_get_size(hmu) == size);
+
+    /* the unused part has been counted as free space, and it is
+       added again by free_vo_hmu */
+    heap->total_free_size -= size;
+#if GC_STAT_DATA != 0
+    heap->total_size_freed -= size;
+#endif
+
+    hmu_set_ut(hmu, HMU_VO);
+    hmu_unfree_vo(hmu);
+    return free_vo_hmu(heap, hmu);
+}
+
+/**
+ * Carve a new bump allocation buffer from the free chunks, the heap lock
+ * must be held by the caller
+ *
+ * @param heap should be a valid heap
+ * @param size the size of the wo to allocate from the buffer
+ *
+ * @return true if the buffer has enough space for the wo, false if the
+ *         heap should be collected or no free chunk is big enough, in
+ *         which case the wo should be allocated with alloc_hmu_ex
+ */
+static bool
+bump_buffer_refill(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *hmu;
+    gc_size_t highmark_size = heap->highmark_size;
+
+    if (heap->total_free_size < heap->gc_threshold)
+        return false;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (heap->is_marking || gc_need_start_marking(heap)) {
+        do_gc_heap_step(heap, GC_BUMP_ALLOC_BUF_SIZE);
+        /* the heap lock was released during the step, and the buffer
+           may have been refilled by another thread */
+        if ((gc_size_t)(heap->bump_end - heap->bump_ptr) >= size)
+            return true;
+    }
+#endif
+
+    if (bump_buffer_retire(heap) != GC_SUCCESS
+        || !(hmu = alloc_hmu(heap, GC_BUMP_ALLOC_BUF_SIZE)))
+        return false;
+
+    /* the buffer is free space until the wos are allocated from it */
+    heap->total_free_size += hmu_get_size(hmu);
+    heap->highmark_size = highmark_size;
+
+    hmu_set_ut(hmu, HMU_FM);
+    heap->bump_ptr = (gc_uint8 *)hmu;
+    heap->bump_end = (gc_uint8 *)hmu + hmu_get_size(hmu);
+    return true;
+}
+
+/**
+ * Allocate a wo chunk from the bump allocation buffer, the heap lock
+ * must be held by the caller
+ *
+ * @param heap should be a valid heap
+ * @param size should cover the header and should be 8 bytes aligned
+ *
+ * @return hmu allocated if success, NULL otherwise
+ */
+static hmu_t *
+bump_alloc(gc_heap_t *heap, gc_size_t size)
+{
+    hmu_t *hmu, *rest;
+    gc_size_t left;
+
+    if (size < GC_SMALLEST_SIZE)
+        size = GC_SMALLEST_SIZE;
+
+    if ((gc_size_t)(heap->bump_end - heap->bump_ptr) < size
+        && !bump_buffer_refill(heap, size))
+        return NULL;
+
+    hmu = (hmu_t *)heap->bump_ptr;
+    left = (gc_size_t)(heap->bump_end - heap->bump_ptr);
+    bh_assert(left >= size);
+
+    if (left - size < GC_SMALLEST_SIZE) {
+        /* the rest is too small to be a chunk */
+        size = left;
+        heap->bump_ptr = heap->bump_end = NULL;
+    }
+    else {
+        heap->bump_ptr += size;
+        rest = (hmu_t *)heap->bump_ptr;
+        hmu_set_ut(rest, HMU_FM);
+        hmu_set_size(rest, left - size);
+        hmu_mark_pinuse(rest);
+    }
+
+    /* the first chunk of the buffer keeps its pinuse bit, and the
+       others follow an allocated chunk, see above */
+    hmu_set_size(hmu, size);
+
+    heap->total_free_size -= size;
+    if ((heap->current_size - heap->total_free_size) > heap->highmark_size)
+        heap->highmark_size = heap->current_size - heap->total_free_size;
+
+    return hmu;
+}
+#endif /* end of GC_ENABLE_BUMP_ALLOC != 0 */
+
 #if BH_ENABLE_GC_VERIFY == 0
 gc_object_t
 gc_alloc_vo(void *vheap, gc_size_t size)
@@ -580,6 +1049,26 @@ gc_alloc_vo_internal(void *vheap, gc_size_t size, const char *file, int line)
     }
 #endif
 
+#if GC_ENABLE_THREAD_CACHE != 0
+    if (heap->thread_caches && GC_THREAD_CACHE_IS_CACHEABLE(tot_size)) {
+        if ((hmu = thread_cache_alloc(
+                 heap, tot_size > GC_SMALLEST_SIZE ? tot_size
+                                                   : GC_SMALLEST_SIZE))) {
+            tot_size = hmu_get_size(hmu);
+#if BH_ENABLE_GC_VERIFY != 0
+            hmu_init_prefix_and_suffix(hmu, tot_size, file, line);
+#endif
+            ret = hmu_to_obj(hmu);
+            if (tot_size > tot_size_unaligned)
+                /* clear buffer appended by GC_ALIGN_8() */
+                memset((uint8 *)ret + size, 0, tot_size - tot_size_unaligned);
+            return ret;
+        }
+        /* the free chunks may be held by the thread caches */
+        gci_flush_thread_caches(heap);
+    }
+#endif
+
     LOCK_HEAP(heap);
 
     hmu = alloc_hmu_ex(heap, tot_size);
@@ -781,7 +1270,14 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 
     LOCK_HEAP(heap);
 
-    hmu = alloc_hmu_ex(heap, tot_size);
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* small wos are allocated from the bump allocation buffer, so that
+       the free lists aren't searched for each of them */
+    if (tot_size <= GC_BUMP_ALLOC_MAX_SIZE)
+        hmu = bump_alloc(heap, tot_size);
+    if (!hmu)
+#endif
+        hmu = alloc_hmu_ex(heap, tot_size);
     if (!hmu)
         goto finish;
 
@@ -801,8 +1297,13 @@ gc_alloc_wo_internal(void *vheap, gc_size_t size, const char *file, int line)
 #if GC_MANUALLY != 0
     hmu_mark_wo(hmu);
 #else
+    /* new wos are white, a wo allocated during the marking cycle is
+       marked when it is reached from the roots or from the marked wos */
     hmu_unmark_wo(hmu);
 #endif
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    hmu_ungray_wo(hmu);
+#endif
 
 #if BH_ENABLE_GC_VERIFY != 0
     hmu_init_prefix_and_suffix(hmu, tot_size, file, line);
@@ -844,9 +1345,6 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     gc_heap_t *heap = (gc_heap_t *)vheap;
     gc_uint8 *base_addr, *end_addr;
     hmu_t *hmu = NULL;
-    hmu_t *prev = NULL;
-    hmu_t *next = NULL;
-    gc_size_t size = 0;
     hmu_type_t ut;
     int ret = GC_SUCCESS;
 
@@ -866,6 +1364,16 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
     base_addr = heap->base_addr;
     end_addr = base_addr + heap->current_size;
 
+#if GC_ENABLE_THREAD_CACHE != 0
+    if (heap->thread_caches && hmu_is_in_heap(hmu, base_addr, end_addr)
+        && GC_THREAD_CACHE_IS_CACHEABLE(hmu_get_size(hmu))) {
+#if BH_ENABLE_GC_VERIFY != 0
+        hmu_verify(heap, hmu);
+#endif
+        return thread_cache_free(heap, hmu);
+    }
+#endif
+
     LOCK_HEAP(heap);
 
     if (hmu_is_in_heap(hmu, base_addr, end_addr)) {
@@ -880,55 +1388,13 @@ gc_free_vo_internal(void *vheap, gc_object_t obj, const char *file, int line)
                 goto out;
             }
 
-            size = hmu_get_size(hmu);
-
-            heap->total_free_size += size;
-
-#if GC_STAT_DATA != 0
-            heap->total_size_freed += size;
-#endif
-
-            if (!hmu_get_pinuse(hmu)) {
-                prev = (hmu_t *)((char *)hmu - *((int *)hmu - 1));
-
-                if (hmu_is_in_heap(prev, base_addr, end_addr)
-                    && hmu_get_ut(prev) == HMU_FC) {
-                    size += hmu_get_size(prev);
-                    hmu = prev;
-                    if (!unlink_hmu(heap, prev)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                }
-            }
-
-            next = (hmu_t *)((char *)hmu + size);
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                if (hmu_get_ut(next) == HMU_FC) {
-                    size += hmu_get_size(next);
-                    if (!unlink_hmu(heap, next)) {
-                        ret = GC_ERROR;
-                        goto out;
-                    }
-                    next = (hmu_t *)((char *)hmu + size);
-                }
-            }
-
-            if (!gci_add_fc(heap, hmu, size)) {
-                ret = GC_ERROR;
-                goto out;
-            }
-
-            if (hmu_is_in_heap(next, base_addr, end_addr)) {
-                hmu_unmark_pinuse(next);
-            }
+            ret = free_vo_hmu(heap, hmu);
+            goto out;
         }
         else {
             ret = GC_ERROR;
             goto out;
         }
-        ret = GC_SUCCESS;
-        goto out;
     }
 
 out:
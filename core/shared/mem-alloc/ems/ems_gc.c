@@ -5,6 +5,9 @@
 
 #include "ems_gc.h"
 #include "ems_gc_internal.h"
+#if WASM_ENABLE_GC_INCREMENTAL != 0 || WASM_ENABLE_GC_PARALLEL_MARKING != 0
+#include "bh_atomic.h"
+#endif
 
 #ifndef GB // Some platforms define already, causing build warnings.
 #define GB (1 << 30UL)
@@ -88,6 +91,11 @@ sweep_instance_heap(gc_heap_t *heap)
     }
     heap->kfc_tree_root->right = NULL;
     heap->root_set = NULL;
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* the unused part of the bump allocation buffer is merged with the
+       free space around it below */
+    heap->bump_ptr = heap->bump_end = NULL;
+#endif
 
     while (cur < end) {
         ut = hmu_get_ut(cur);
@@ -125,6 +133,9 @@ sweep_instance_heap(gc_heap_t *heap)
             if (ut == HMU_WO) {
                 /* unmark it */
                 hmu_unmark_wo(cur);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+                hmu_ungray_wo(cur);
+#endif
             }
         }
 
@@ -140,9 +151,9 @@ sweep_instance_heap(gc_heap_t *heap)
     }
 
     heap->total_free_size = tot_free;
+    heap->total_gc_count++;
 
 #if GC_STAT_DATA != 0
-    heap->total_gc_count++;
     if ((heap->current_size - tot_free) > heap->highmark_size)
         heap->highmark_size = heap->current_size - tot_free;
 
@@ -150,6 +161,413 @@ sweep_instance_heap(gc_heap_t *heap)
     gc_update_threshold(heap);
 }
 
+#if WASM_ENABLE_GC_COMPACTION != 0
+/**
+ * Get the size of the largest free chunk of the heap
+ *
+ * @param heap should be a valid instance heap
+ */
+static gc_size_t
+get_max_free_chunk_size(gc_heap_t *heap)
+{
+    hmu_tree_node_t *node = heap->kfc_tree_root->right;
+    int i;
+
+    if (node) {
+        /* the largest chunk is the rightmost node of the kfc tree */
+        while (node->right)
+            node = node->right;
+        return node->size;
+    }
+
+    for (i = HMU_NORMAL_NODE_CNT - 1; i > 0; i--) {
+        if (heap->kfc_normal_list[i].next)
+            return (gc_size_t)i << 3;
+    }
+
+    return 0;
+}
+
+/**
+ * Whether the free space of a swept heap is fragmented enough to
+ * compact the heap
+ */
+static bool
+need_compact_heap(gc_heap_t *heap)
+{
+    gc_size_t max_chunk_size;
+
+    if (heap->total_free_size == 0)
+        return false;
+
+    max_chunk_size = get_max_free_chunk_size(heap);
+    return (uint64)(heap->total_free_size - max_chunk_size) * 100
+           >= (uint64)heap->total_free_size * GC_COMPACTION_FRAGMENT_THRESHOLD;
+}
+
+/**
+ * Whether the wos can be moved, i.e. all the references to them can be
+ * found and updated by the rootset enumeration
+ */
+static bool
+is_compaction_allowed(gc_heap_t *heap)
+{
+#if WASM_ENABLE_THREAD_MGR == 0
+    return heap->exec_env && gct_vm_is_compaction_allowed(heap->exec_env);
+#else
+    /* TODO: the threads of the cluster may hold references in their
+       native stacks, compaction isn't supported in multi-threading */
+    (void)heap;
+    return false;
+#endif
+}
+
+/**
+ * Walk the heap and record the runs of wos to move: each wo is slid
+ * to the lowest address not used by the wos before it, and the vos in
+ * use are pinned since the references to them are unknown.
+ *
+ * @param heap the heap to compact, should be a valid instance heap
+ *        which has been swept, so that all wos are live
+ *
+ * @return GC_SUCCESS if success, in which case heap->compact_runs is
+ *         NULL if no wo needs to be moved, GC_ERROR otherwise
+ */
+static int
+plan_compaction(gc_heap_t *heap)
+{
+    hmu_t *cur = NULL, *end = NULL;
+    hmu_type_t ut;
+    gc_uint8 *dest = NULL;
+    gc_size_t size, run_count = 0, run_idx = 0;
+    gc_uint32 ref_num, ref_start_offset;
+    gc_uint16 *ref_list;
+    gc_compact_run_t *runs = NULL;
+    bool in_run, need_move = false, is_compact_mode;
+    int pass;
+
+    heap->compact_runs = NULL;
+    heap->compact_run_count = 0;
+
+    /* count the runs in the first pass and record them in the second */
+    for (pass = 0; pass < 2; pass++) {
+        cur = (hmu_t *)heap->base_addr;
+        end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+        dest = heap->base_addr;
+        in_run = false;
+
+        while (cur < end) {
+            ut = hmu_get_ut(cur);
+            size = hmu_get_size(cur);
+            bh_assert(size > 0);
+
+            if (ut == HMU_WO) {
+                if (pass == 0
+                    && !gct_vm_get_wasm_object_ref_list(
+                        hmu_to_obj(cur), &is_compact_mode, &ref_num,
+                        &ref_list, &ref_start_offset)) {
+                    /* check it before any wo is updated */
+                    LOG_ERROR("compaction failed because failed "
+                              "vm_get_wasm_object_ref_list");
+                    return GC_ERROR;
+                }
+
+                if (!in_run) {
+                    if (pass == 0) {
+                        run_count++;
+                    }
+                    else {
+                        runs[run_idx].old_addr = (gc_uint8 *)cur;
+                        runs[run_idx].new_addr = dest;
+                        run_idx++;
+                    }
+                    in_run = true;
+                }
+                if ((gc_uint8 *)cur != dest)
+                    need_move = true;
+                dest += size;
+            }
+            else {
+                in_run = false;
+                if (ut == HMU_VO && !hmu_is_vo_freed(cur))
+                    dest = (gc_uint8 *)cur + size;
+            }
+
+            cur = (hmu_t *)((char *)cur + size);
+        }
+
+        bh_assert(cur == end);
+
+        if (pass == 0) {
+            if (!need_move)
+                return GC_SUCCESS;
+
+            if (!(runs = BH_MALLOC(sizeof(gc_compact_run_t) * run_count))) {
+                LOG_ERROR("compaction failed because of run table "
+                          "allocation failed");
+                return GC_ERROR;
+            }
+        }
+    }
+
+    bh_assert(run_idx == run_count);
+    heap->compact_runs = runs;
+    heap->compact_run_count = run_count;
+    return GC_SUCCESS;
+}
+
+/**
+ * Get the new address of a wo in the compaction in progress
+ *
+ * @param heap the heap compacting
+ * @param obj the wo at its old address
+ *
+ * @return the wo at its new address
+ */
+static gc_object_t
+get_forwarded_obj(gc_heap_t *heap, gc_object_t obj)
+{
+    gc_compact_run_t *runs = heap->compact_runs;
+    gc_uint8 *hmu = (gc_uint8 *)obj_to_hmu(obj);
+    gc_size_t low = 0, high = heap->compact_run_count, mid;
+
+    if (hmu < heap->base_addr
+        || hmu >= heap->base_addr + heap->current_size) {
+        LOG_ERROR("Obj is not a object in current instance heap");
+        return obj;
+    }
+
+    /* find the last run starting at or before the wo */
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (runs[mid].old_addr <= hmu)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == 0) {
+        bh_assert(0);
+        return obj;
+    }
+
+    return (gc_object_t)(runs[low - 1].new_addr
+                         + ((gc_uint8 *)obj - runs[low - 1].old_addr));
+}
+
+/**
+ * Update the references in all wos to the new addresses, it must be
+ * done before the wos are moved
+ */
+static void
+update_wo_refs(gc_heap_t *heap)
+{
+    hmu_t *cur = NULL, *end = NULL;
+    gc_object_t obj = NULL, ref = NULL;
+    gc_uint32 ref_num = 0, ref_start_offset = 0, size, offset, j;
+    gc_uint16 *ref_list = NULL;
+    bool is_compact_mode = false;
+
+    cur = (hmu_t *)heap->base_addr;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    while (cur < end) {
+        size = hmu_get_size(cur);
+
+        if (hmu_get_ut(cur) == HMU_WO) {
+            obj = hmu_to_obj(cur);
+            /* it has been checked by plan_compaction */
+            gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                            &ref_list, &ref_start_offset);
+
+            for (j = 0; j < ref_num; j++) {
+                if (is_compact_mode)
+                    offset = ref_start_offset + j * sizeof(void *);
+                else
+                    offset = ref_list[j];
+                bh_assert(offset + sizeof(void *) < size);
+
+                ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+                if (ref == NULL_REF || ((uintptr_t)ref & 1))
+                    continue; /* null object or i31 object */
+                *(gc_object_t *)(((gc_uint8 *)obj) + offset) =
+                    get_forwarded_obj(heap, ref);
+            }
+        }
+
+        cur = (hmu_t *)((char *)cur + size);
+    }
+}
+
+/**
+ * Move the wos to their new addresses and rebuild the free chunks
+ * between the pinned vos
+ */
+static void
+move_wos(gc_heap_t *heap)
+{
+    hmu_t *cur = NULL, *end = NULL;
+    hmu_type_t ut;
+    gc_uint8 *dest = NULL;
+    gc_size_t size, tot_free = 0;
+    int i, lsize;
+
+    cur = (hmu_t *)heap->base_addr;
+    end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+    dest = heap->base_addr;
+
+    /* reset KFC */
+    lsize =
+        (int)(sizeof(heap->kfc_normal_list) / sizeof(heap->kfc_normal_list[0]));
+    for (i = 0; i < lsize; i++) {
+        heap->kfc_normal_list[i].next = NULL;
+    }
+    heap->kfc_tree_root->right = NULL;
+#if GC_ENABLE_BUMP_ALLOC != 0
+    heap->bump_ptr = heap->bump_end = NULL;
+#endif
+
+    while (cur < end) {
+        ut = hmu_get_ut(cur);
+        size = hmu_get_size(cur);
+
+        if (ut == HMU_WO) {
+            /* the destination never overlaps the blocks after cur */
+            if ((gc_uint8 *)cur != dest)
+                memmove(dest, cur, size);
+            /* the block before it is a wo or a pinned vo */
+            hmu_mark_pinuse((hmu_t *)dest);
+            dest += size;
+        }
+        else if (ut == HMU_VO && !hmu_is_vo_freed(cur)) {
+            if ((gc_uint8 *)cur != dest) {
+                tot_free += (gc_size_t)((gc_uint8 *)cur - dest);
+                gci_add_fc(heap, (hmu_t *)dest,
+                           (gc_size_t)((gc_uint8 *)cur - dest));
+                hmu_mark_pinuse((hmu_t *)dest);
+                hmu_unmark_pinuse(cur);
+            }
+            else {
+                hmu_mark_pinuse(cur);
+            }
+            dest = (gc_uint8 *)cur + size;
+        }
+
+        cur = (hmu_t *)((char *)cur + size);
+    }
+
+    bh_assert(cur == end);
+
+    if ((gc_uint8 *)end != dest) {
+        tot_free += (gc_size_t)((gc_uint8 *)end - dest);
+        gci_add_fc(heap, (hmu_t *)dest, (gc_size_t)((gc_uint8 *)end - dest));
+        hmu_mark_pinuse((hmu_t *)dest);
+    }
+
+    heap->total_free_size = tot_free;
+    gc_update_threshold(heap);
+}
+
+/**
+ * Compact GC instance heap
+ *
+ * @param heap the heap to compact, should be a valid instance heap which
+ *        has been swept, and its lock should be held by the caller
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+compact_instance_heap(gc_heap_t *heap)
+{
+    bool ret;
+    gc_size_t i;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* the marked wos and the wos to expand are recorded by address */
+    if (heap->is_marking)
+        return GC_SUCCESS;
+#endif
+
+    if (plan_compaction(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    if (!heap->compact_runs)
+        return GC_SUCCESS; /* no wo to move */
+
+    update_wo_refs(heap);
+
+    /* update the root slots to the new addresses */
+    heap->is_compacting = 1;
+#if WASM_ENABLE_THREAD_MGR == 0
+    ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
+#else
+    ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
+#endif
+    heap->is_compacting = 0;
+    /* the root slots are always updated successfully */
+    bh_assert(ret);
+    (void)ret;
+
+    /* the wos keep their order, so the nodes are still sorted */
+    for (i = 0; i < heap->extra_info_node_cnt; i++) {
+        heap->extra_info_nodes[i]->obj =
+            get_forwarded_obj(heap, heap->extra_info_nodes[i]->obj);
+    }
+
+    move_wos(heap);
+
+    BH_FREE(heap->compact_runs);
+    heap->compact_runs = NULL;
+    heap->compact_run_count = 0;
+    heap->total_compact_count++;
+
+    return GC_SUCCESS;
+}
+
+/**
+ * Compact the heap just swept if it is fragmented
+ */
+static void
+compact_instance_heap_if_fragmented(gc_heap_t *heap)
+{
+    if (is_compaction_allowed(heap) && need_compact_heap(heap)) {
+        LOG_VERBOSE("#compact instance heap %p", heap);
+        compact_instance_heap(heap);
+    }
+}
+#endif /* end of WASM_ENABLE_GC_COMPACTION != 0 */
+
+/**
+ * Push a marked wo to the to-expand list
+ *
+ * @param heap should be a valid instance heap
+ * @param obj should be a valid wo inside @heap
+ *
+ * @return GC_ERROR if there is no more resource for marking,
+ *         GC_SUCCESS if success
+ */
+static int
+push_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
+{
+    mark_node_t *mark_node = NULL, *new_node = NULL;
+
+    mark_node = (mark_node_t *)heap->root_set;
+    if (!mark_node || mark_node->idx == mark_node->cnt) {
+        new_node = alloc_mark_node();
+        if (!new_node) {
+            LOG_ERROR("can not add obj to mark node because of mark node "
+                      "allocation failed");
+            return GC_ERROR;
+        }
+        new_node->next = mark_node;
+        heap->root_set = new_node;
+        mark_node = new_node;
+    }
+
+    mark_node->set[mark_node->idx++] = obj;
+    return GC_SUCCESS;
+}
+
 /**
  * Add a to-expand node to the to-expand list
  *
@@ -162,7 +580,6 @@ sweep_instance_heap(gc_heap_t *heap)
 static int
 add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
 {
-    mark_node_t *mark_node = NULL, *new_node = NULL;
     hmu_t *hmu = NULL;
 
     bh_assert(obj);
@@ -177,20 +594,9 @@ add_wo_to_expand(gc_heap_t *heap, gc_object_t obj)
     if (hmu_is_wo_marked(hmu))
         return GC_SUCCESS; /* already marked*/
 
-    mark_node = (mark_node_t *)heap->root_set;
-    if (!mark_node || mark_node->idx == mark_node->cnt) {
-        new_node = alloc_mark_node();
-        if (!new_node) {
-            LOG_ERROR("can not add obj to mark node because of mark node "
-                      "allocation failed");
-            return GC_ERROR;
-        }
-        new_node->next = mark_node;
-        heap->root_set = new_node;
-        mark_node = new_node;
-    }
+    if (push_wo_to_expand(heap, obj) != GC_SUCCESS)
+        return GC_ERROR;
 
-    mark_node->set[mark_node->idx++] = obj;
     hmu_mark_wo(hmu);
     return GC_SUCCESS;
 }
@@ -233,6 +639,24 @@ gc_add_root(void *heap_p, gc_object_t obj)
     return GC_SUCCESS;
 }
 
+int
+gc_add_root_slot(void *heap_p, void *p_obj)
+{
+    gc_object_t obj;
+
+    bh_memcpy_s(&obj, sizeof(obj), p_obj, sizeof(obj));
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+    if (((gc_heap_t *)heap_p)->is_compacting) {
+        obj = get_forwarded_obj((gc_heap_t *)heap_p, obj);
+        bh_memcpy_s(p_obj, sizeof(obj), &obj, sizeof(obj));
+        return GC_SUCCESS;
+    }
+#endif
+
+    return gc_add_root(heap_p, obj);
+}
+
 /**
  * Unmark all marked objects to do rollback
  *
@@ -257,6 +681,9 @@ rollback_mark(gc_heap_t *heap)
     }
 
     heap->root_set = NULL;
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    heap->is_marking = 0;
+#endif
 
     /* then traverse the heap to unmark all marked wos*/
 
@@ -269,6 +696,9 @@ rollback_mark(gc_heap_t *heap)
 
         if (ut == HMU_WO && hmu_is_wo_marked(cur)) {
             hmu_unmark_wo(cur);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+            hmu_ungray_wo(cur);
+#endif
         }
 
         cur = (hmu_t *)((char *)cur + size);
@@ -278,38 +708,37 @@ rollback_mark(gc_heap_t *heap)
 }
 
 /**
- * Reclaim GC instance heap
+ * Enumerate the rootset and add the roots to the to-expand list
  *
- * @param heap the heap to reclaim, should be a valid instance heap
+ * @param heap the heap to mark, should be a valid instance heap whose
+ *        to-expand list is empty
  *
- * @return GC_SUCCESS if success, GC_ERROR otherwise
+ * @return GC_SUCCESS if success, GC_ERROR otherwise, and all marked
+ *         wos are unmarked if failed
  */
 static int
-reclaim_instance_heap(gc_heap_t *heap)
+mark_rootset(gc_heap_t *heap)
 {
+    bool ret;
+#if BH_ENABLE_GC_VERIFY != 0
     mark_node_t *mark_node = NULL;
-    int idx = 0, j = 0;
-    bool ret, is_compact_mode = false;
-    gc_object_t obj = NULL, ref = NULL;
+    gc_object_t obj = NULL;
     hmu_t *hmu = NULL;
-    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0;
-    gc_uint16 *ref_list = NULL;
-
-    bh_assert(gci_is_heap_valid(heap));
+    int idx = 0;
+#endif
 
-    heap->root_set = NULL;
+    bh_assert(!heap->root_set);
 
 #if WASM_ENABLE_THREAD_MGR == 0
-    if (!heap->exec_env)
-        return GC_SUCCESS;
     ret = gct_vm_begin_rootset_enumeration(heap->exec_env, heap);
 #else
-    if (!heap->cluster)
-        return GC_SUCCESS;
     ret = gct_vm_begin_rootset_enumeration(heap->cluster, heap);
 #endif
-    if (!ret)
+    if (!ret) {
+        rollback_mark(heap);
+        heap->is_fast_marking_failed = 0;
         return GC_ERROR;
+    }
 
 #if BH_ENABLE_GC_VERIFY != 0
     /* no matter whether the enumeration is successful or not, the data
@@ -347,93 +776,650 @@ reclaim_instance_heap(gc_heap_t *heap)
         return GC_ERROR;
     }
 
-    /* the algorithm we use to mark all objects */
-    /* 1. mark rootset and organize them into a mark_node list (last marked
-     * roots at list header, i.e. stack top) */
-    /* 2. in every iteration, we use the top node to expand*/
-    /* 3. execute step 2 till no expanding */
-    /* this is a BFS & DFS mixed algorithm, but more like DFS */
-    mark_node = (mark_node_t *)heap->root_set;
-    while (mark_node) {
-        heap->root_set = mark_node->next;
+    return GC_SUCCESS;
+}
 
-        /* note that mark_node->idx may change in each loop */
-        for (idx = 0; idx < (int)mark_node->idx; idx++) {
-            obj = mark_node->set[idx];
-            hmu = obj_to_hmu(obj);
-            size = hmu_get_size(hmu);
-
-            if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode,
-                                                 &ref_num, &ref_list,
-                                                 &ref_start_offset)) {
-                LOG_ERROR("mark process failed because failed "
-                          "vm_get_wasm_object_ref_list");
-                break;
+/**
+ * Expand the wos in the to-expand list, i.e. mark their successors and
+ * add them to the to-expand list, until the list is empty or @budget
+ * bytes of wos are expanded
+ *
+ * @param heap the heap to mark, should be a valid instance heap
+ * @param budget bytes of wos to expand at most
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise, the caller should
+ *         roll back the marking if failed
+ */
+static int
+expand_wos(gc_heap_t *heap, gc_uint64 budget)
+{
+    mark_node_t *mark_node = NULL;
+    int j = 0;
+    bool is_compact_mode = false;
+    gc_object_t obj = NULL, ref = NULL;
+    hmu_t *hmu = NULL;
+    gc_uint32 ref_num = 0, ref_start_offset = 0, size = 0, offset = 0;
+    gc_uint16 *ref_list = NULL;
+    gc_uint64 expanded = 0;
+
+    /* the algorithm we use to mark all objects */
+    /* 1. mark rootset and organize them into a mark_node list (last marked
+     * roots at list header, i.e. stack top) */
+    /* 2. in every iteration, we pop a wo from the top node to expand */
+    /* 3. execute step 2 till no expanding */
+    /* this is a DFS algorithm, and it can be suspended between two
+       iterations to do incremental marking */
+    while ((mark_node = (mark_node_t *)heap->root_set)) {
+        if (mark_node->idx == 0) {
+            /* obj's in mark_node are all expanded */
+            heap->root_set = mark_node->next;
+            free_mark_node(mark_node);
+            continue;
+        }
+
+        if (expanded >= budget)
+            break;
+
+        obj = mark_node->set[--mark_node->idx];
+        hmu = obj_to_hmu(obj);
+        size = hmu_get_size(hmu);
+        expanded += size;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+        /* the references stored into the wo by now are expanded below */
+        hmu_ungray_wo(hmu);
+#endif
+
+        if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                             &ref_list, &ref_start_offset)) {
+            LOG_ERROR("mark process failed because failed "
+                      "vm_get_wasm_object_ref_list");
+            return GC_ERROR;
+        }
+
+        if (ref_num >= 2U * GB) {
+            LOG_ERROR("Invalid ref_num returned");
+            return GC_ERROR;
+        }
+
+        for (j = 0; j < (int)ref_num; j++) {
+            if (is_compact_mode)
+                offset = ref_start_offset + j * sizeof(void *);
+            else
+                offset = ref_list[j];
+            bh_assert(offset + sizeof(void *) < size);
+
+            ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+            if (ref == NULL_REF || ((uintptr_t)ref & 1))
+                continue; /* null object or i31 object */
+            if (add_wo_to_expand(heap, ref) == GC_ERROR) {
+                LOG_ERROR("mark process failed");
+                return GC_ERROR;
             }
+        }
+    }
+
+    (void)size;
+
+    return GC_SUCCESS;
+}
+
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+struct gc_parallel_marking;
+
+/* A marker of the parallel marking. The wos to expand are pushed to
+   and popped from its local node, and the nodes filled are published
+   to its shared list, from which the idle markers steal wos */
+typedef struct gc_marker {
+    struct gc_parallel_marking *pm;
+    /* index of the marker, the marker 0 runs in the collecting thread */
+    uint32 idx;
+    mark_node_t *local_node;
+    /* published nodes, protected by lock */
+    mark_node_t *shared_nodes;
+    korp_mutex lock;
+    korp_tid tid;
+    bool is_thread_created;
+} gc_marker_t;
+
+typedef struct gc_parallel_marking {
+    gc_heap_t *heap;
+    gc_marker_t *markers;
+    uint32 marker_num;
+    /* number of markers which may still have wos to expand, the marking
+       is finished when it drops to zero */
+    bh_atomic_32_t busy_num;
+    /* number of markers looking for wos to steal */
+    bh_atomic_32_t idle_num;
+    /* whether a marker failed, e.g. failed to allocate a mark node */
+    bh_atomic_32_t is_failed;
+} gc_parallel_marking_t;
+
+/**
+ * Mark a wo atomically, since it may be reached by several markers
+ *
+ * @return true if the wo is marked by the caller, false if it has
+ *         been marked already
+ */
+static inline bool
+mark_wo_atomic(hmu_t *hmu)
+{
+    gc_uint32 mark_bit = (gc_uint32)1 << HMU_WO_MB_OFFSET;
+
+    if (hmu_is_wo_marked(hmu))
+        return false;
+    return !(BH_ATOMIC_32_FETCH_OR(hmu->header, mark_bit) & mark_bit);
+}
+
+/**
+ * Publish a mark node of a marker so that the others can steal it
+ */
+static void
+marker_publish_node(gc_marker_t *marker, mark_node_t *node)
+{
+    os_mutex_lock(&marker->lock);
+    node->next = marker->shared_nodes;
+    marker->shared_nodes = node;
+    os_mutex_unlock(&marker->lock);
+}
+
+/**
+ * Push a marked wo to the local node of a marker, the node is published
+ * if it is full, and the older half of it is published if some markers
+ * are idle and nothing of this marker is left for them to steal
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+marker_push_wo(gc_marker_t *marker, gc_object_t obj)
+{
+    mark_node_t *node = marker->local_node, *shared_node;
+    uint32 shared_cnt;
+
+    if (node && node->idx == node->cnt) {
+        marker_publish_node(marker, node);
+        node = marker->local_node = NULL;
+    }
+    else if (node && node->idx >= GC_PARALLEL_MARK_SHARE_MIN_CNT
+             && BH_ATOMIC_32_LOAD(marker->pm->idle_num) > 0
+             && !*(mark_node_t *volatile *)&marker->shared_nodes) {
+        /* the older wos are closer to the roots, which usually lead to
+           more wos to expand than the newer ones */
+        if (!(shared_node = alloc_mark_node()))
+            return GC_ERROR;
+        shared_cnt = node->idx / 2;
+        bh_memcpy_s(shared_node->set, sizeof(shared_node->set), node->set,
+                    sizeof(gc_object_t) * shared_cnt);
+        shared_node->idx = shared_cnt;
+        node->idx -= shared_cnt;
+        memmove(node->set, node->set + shared_cnt,
+                sizeof(gc_object_t) * node->idx);
+        marker_publish_node(marker, shared_node);
+    }
+
+    if (!node) {
+        if (!(node = alloc_mark_node()))
+            return GC_ERROR;
+        marker->local_node = node;
+    }
+
+    node->set[node->idx++] = obj;
+    return GC_SUCCESS;
+}
+
+/**
+ * Take a published node of the victim as the local node of a marker,
+ * the victim may be the marker itself
+ *
+ * @return true if a node is taken, false otherwise
+ */
+static bool
+marker_take_node(gc_marker_t *marker, gc_marker_t *victim)
+{
+    mark_node_t *node;
+
+    /* peek it without the lock first, it is checked again below */
+    if (!*(mark_node_t *volatile *)&victim->shared_nodes)
+        return false;
+
+    os_mutex_lock(&victim->lock);
+    if ((node = victim->shared_nodes))
+        victim->shared_nodes = node->next;
+    os_mutex_unlock(&victim->lock);
+
+    if (!node)
+        return false;
+
+    if (marker->local_node)
+        free_mark_node(marker->local_node);
+    node->next = NULL;
+    marker->local_node = node;
+    return true;
+}
 
-            if (ref_num >= 2U * GB) {
-                LOG_ERROR("Invalid ref_num returned");
-                break;
+/**
+ * Whether any other marker has published nodes, it is only a hint
+ * since the nodes may be taken by others at the same time
+ */
+static bool
+marker_can_steal(gc_marker_t *marker)
+{
+    gc_parallel_marking_t *pm = marker->pm;
+    uint32 i;
+
+    for (i = 1; i < pm->marker_num; i++) {
+        if (*(mark_node_t *volatile *)&pm->markers[(marker->idx + i)
+                                                   % pm->marker_num]
+                 .shared_nodes)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Take a published node of any other marker
+ */
+static bool
+marker_steal_node(gc_marker_t *marker)
+{
+    gc_parallel_marking_t *pm = marker->pm;
+    uint32 i;
+
+    for (i = 1; i < pm->marker_num; i++) {
+        if (marker_take_node(marker,
+                             &pm->markers[(marker->idx + i) % pm->marker_num]))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Pop a wo to expand from the local node of a marker, its own published
+ * nodes are taken back at first, and then the other markers' are stolen
+ */
+static bool
+marker_pop_wo(gc_marker_t *marker, gc_object_t *p_obj)
+{
+    mark_node_t *node;
+
+    for (;;) {
+        node = marker->local_node;
+        if (node && node->idx > 0) {
+            *p_obj = node->set[--node->idx];
+            return true;
+        }
+        if (!marker_take_node(marker, marker) && !marker_steal_node(marker))
+            return false;
+    }
+}
+
+/**
+ * Mark the successors of a wo and push them to the marker
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+marker_expand_wo(gc_marker_t *marker, gc_object_t obj)
+{
+    gc_heap_t *heap = marker->pm->heap;
+    bool is_compact_mode = false;
+    gc_object_t ref;
+    hmu_t *hmu;
+    gc_uint32 ref_num = 0, ref_start_offset = 0, offset, j;
+    gc_uint16 *ref_list = NULL;
+
+    /* the gray bit isn't cleared, the heap is swept after the marking */
+    if (!gct_vm_get_wasm_object_ref_list(obj, &is_compact_mode, &ref_num,
+                                         &ref_list, &ref_start_offset)) {
+        LOG_ERROR("mark process failed because failed "
+                  "vm_get_wasm_object_ref_list");
+        return GC_ERROR;
+    }
+
+    if (ref_num >= 2U * GB) {
+        LOG_ERROR("Invalid ref_num returned");
+        return GC_ERROR;
+    }
+
+    for (j = 0; j < ref_num; j++) {
+        if (is_compact_mode)
+            offset = ref_start_offset + j * sizeof(void *);
+        else
+            offset = ref_list[j];
+        bh_assert(offset + sizeof(void *) < hmu_get_size(obj_to_hmu(obj)));
+
+        ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
+        if (ref == NULL_REF || ((uintptr_t)ref & 1))
+            continue; /* null object or i31 object */
+
+        hmu = obj_to_hmu(ref);
+        bh_assert((gc_uint8 *)hmu >= heap->base_addr
+                  && (gc_uint8 *)hmu < heap->base_addr + heap->current_size);
+        bh_assert(hmu_get_ut(hmu) == HMU_WO);
+
+        if (mark_wo_atomic(hmu) && marker_push_wo(marker, ref) != GC_SUCCESS) {
+            LOG_ERROR("mark process failed");
+            return GC_ERROR;
+        }
+    }
+
+    (void)heap;
+    return GC_SUCCESS;
+}
+
+/**
+ * Expand the wos of a marker and steal wos from the others, until all
+ * markers run out of wos or any marker fails
+ */
+static void
+marker_expand_wos(gc_marker_t *marker)
+{
+    gc_parallel_marking_t *pm = marker->pm;
+    gc_object_t obj = NULL;
+
+    for (;;) {
+        while (marker_pop_wo(marker, &obj)) {
+            if (BH_ATOMIC_32_LOAD(pm->is_failed))
+                return;
+            if (marker_expand_wo(marker, obj) != GC_SUCCESS) {
+                BH_ATOMIC_32_STORE(pm->is_failed, 1);
+                return;
             }
+        }
 
-            if (is_compact_mode) {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_start_offset + j * sizeof(void *);
-                    bh_assert(offset + sizeof(void *) < size);
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("add_wo_to_expand failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
+        /* the marker has no wos now and only gets wos by stealing, so
+           all markers run out of wos if none of them is busy */
+        BH_ATOMIC_32_FETCH_ADD(pm->idle_num, 1);
+        BH_ATOMIC_32_FETCH_SUB(pm->busy_num, 1);
+        for (;;) {
+            if (BH_ATOMIC_32_LOAD(pm->busy_num) == 0
+                || BH_ATOMIC_32_LOAD(pm->is_failed))
+                return;
+
+            if (marker_can_steal(marker)) {
+                /* be busy before stealing so that the wos stolen are
+                   counted */
+                BH_ATOMIC_32_FETCH_ADD(pm->busy_num, 1);
+                if (marker_steal_node(marker))
                     break;
+                BH_ATOMIC_32_FETCH_SUB(pm->busy_num, 1);
             }
             else {
-                for (j = 0; j < (int)ref_num; j++) {
-                    offset = ref_list[j];
-                    bh_assert(offset + sizeof(void *) < size);
-
-                    ref = *(gc_object_t *)(((gc_uint8 *)obj) + offset);
-                    if (ref == NULL_REF || ((uintptr_t)ref & 1))
-                        continue; /* null object or i31 object */
-                    if (add_wo_to_expand(heap, ref) == GC_ERROR) {
-                        LOG_ERROR("mark process failed");
-                        break;
-                    }
-                }
-                if (j < (int)ref_num)
-                    break;
+                os_usleep(1);
             }
         }
-        if (idx < (int)mark_node->idx)
-            break; /* not yet done */
+        BH_ATOMIC_32_FETCH_SUB(pm->idle_num, 1);
+    }
+}
 
-        /* obj's in mark_node are all expanded */
-        free_mark_node(mark_node);
-        mark_node = heap->root_set;
+static void *
+marker_thread_routine(void *arg)
+{
+    marker_expand_wos((gc_marker_t *)arg);
+    return NULL;
+}
+
+/**
+ * Expand all wos in the to-expand list with the collecting thread and
+ * marker_num - 1 helper threads
+ *
+ * @param heap the heap to mark, should be a valid instance heap
+ * @param marker_num number of markers, should be larger than 1
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise, the caller should
+ *         roll back the marking if failed
+ */
+static int
+expand_wos_parallel(gc_heap_t *heap, uint32 marker_num)
+{
+    gc_parallel_marking_t pm = { 0 };
+    gc_marker_t *markers;
+    mark_node_t *node, *next;
+    uint32 i, lock_num;
+    int ret;
+
+    if (!(markers = BH_MALLOC(sizeof(gc_marker_t) * marker_num))) {
+        /* mark it in the collecting thread only */
+        return expand_wos(heap, UINT64_MAX);
     }
+    memset(markers, 0, sizeof(gc_marker_t) * marker_num);
 
-    if (mark_node) {
-        LOG_ERROR("mark process is not successfully finished");
+    for (lock_num = 0; lock_num < marker_num; lock_num++) {
+        if (os_mutex_init(&markers[lock_num].lock) != BHT_OK)
+            break;
+    }
+    if (lock_num < marker_num) {
+        for (i = 0; i < lock_num; i++)
+            os_mutex_destroy(&markers[i].lock);
+        BH_FREE(markers);
+        return expand_wos(heap, UINT64_MAX);
+    }
 
-        free_mark_node(mark_node);
+    pm.heap = heap;
+    pm.markers = markers;
+    pm.marker_num = marker_num;
+    pm.busy_num = marker_num;
+
+    /* deal the nodes of the to-expand list to the markers */
+    node = (mark_node_t *)heap->root_set;
+    for (i = 0; node; i = (i + 1) % marker_num, node = next) {
+        next = node->next;
+        node->next = markers[i].shared_nodes;
+        markers[i].shared_nodes = node;
+    }
+    heap->root_set = NULL;
+
+    for (i = 0; i < marker_num; i++) {
+        markers[i].pm = &pm;
+        markers[i].idx = i;
+    }
+
+    for (i = 1; i < marker_num; i++) {
+        if (os_thread_create(&markers[i].tid, marker_thread_routine,
+                             &markers[i], APP_THREAD_STACK_SIZE_DEFAULT)
+            == BHT_OK) {
+            markers[i].is_thread_created = true;
+        }
+        else {
+            /* its nodes are stolen by the other markers */
+            LOG_WARNING("create gc marker thread failed");
+            BH_ATOMIC_32_FETCH_SUB(pm.busy_num, 1);
+        }
+    }
+
+    marker_expand_wos(&markers[0]);
+
+    for (i = 1; i < marker_num; i++) {
+        if (markers[i].is_thread_created)
+            os_thread_join(markers[i].tid, NULL);
+    }
+
+    ret = BH_ATOMIC_32_LOAD(pm.is_failed) ? GC_ERROR : GC_SUCCESS;
+
+    /* the nodes are left only if the marking failed */
+    for (i = 0; i < marker_num; i++) {
+        if (markers[i].local_node)
+            free_mark_node(markers[i].local_node);
+        for (node = markers[i].shared_nodes; node; node = next) {
+            next = node->next;
+            free_mark_node(node);
+        }
+        os_mutex_destroy(&markers[i].lock);
+    }
+    BH_FREE(markers);
+
+    return ret;
+}
+#endif /* end of WASM_ENABLE_GC_PARALLEL_MARKING != 0 */
+
+/**
+ * Expand all wos in the to-expand list, in parallel if the heap is
+ * large enough and helper threads are enabled
+ *
+ * @param heap the heap to mark, should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise, the caller should
+ *         roll back the marking if failed
+ */
+static int
+expand_all_wos(gc_heap_t *heap)
+{
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+    if (BH_ATOMIC_32_IS_ATOMIC && heap->root_set
+        && heap->mark_helper_num > 0
+        && heap->current_size - heap->total_free_size
+               >= GC_PARALLEL_MARK_MIN_USED_SIZE)
+        return expand_wos_parallel(heap, heap->mark_helper_num + 1);
+#endif
+    return expand_wos(heap, UINT64_MAX);
+}
+
+/**
+ * Reclaim GC instance heap
+ *
+ * @param heap the heap to reclaim, should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+reclaim_instance_heap(gc_heap_t *heap)
+{
+    bh_assert(gci_is_heap_valid(heap));
+
+    heap->root_set = NULL;
+
+#if WASM_ENABLE_THREAD_MGR == 0
+    if (!heap->exec_env)
+        return GC_SUCCESS;
+#else
+    if (!heap->cluster)
+        return GC_SUCCESS;
+#endif
+
+    if (mark_rootset(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    if (expand_all_wos(heap) != GC_SUCCESS) {
+        LOG_ERROR("mark process is not successfully finished");
         /* roll back is required */
         rollback_mark(heap);
-
         return GC_ERROR;
     }
 
     /* now sweep */
     sweep_instance_heap(heap);
 
-    (void)size;
+#if WASM_ENABLE_GC_COMPACTION != 0
+    compact_instance_heap_if_fragmented(heap);
+#endif
 
     return GC_SUCCESS;
 }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Number of wos grayed by the write barrier, it is shared by all heaps
+   and is only used to check whether any wo was grayed in a cycle */
+static bh_atomic_32_t gc_write_barrier_count = 0;
+
+/**
+ * Start an incremental marking cycle, the roots are marked in this step
+ * and the others are marked in the later steps
+ *
+ * @param heap the heap to mark, should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+start_marking(gc_heap_t *heap)
+{
+    heap->root_set = NULL;
+
+#if WASM_ENABLE_THREAD_MGR == 0
+    if (!heap->exec_env)
+        return GC_SUCCESS;
+#else
+    if (!heap->cluster)
+        return GC_SUCCESS;
+#endif
+
+    if (mark_rootset(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    heap->is_marking = 1;
+    heap->mark_budget = 0;
+    heap->barrier_count_start = BH_ATOMIC_32_LOAD(gc_write_barrier_count);
+    return GC_SUCCESS;
+}
+
+/**
+ * Finish the incremental marking cycle and sweep the heap, the roots
+ * are enumerated again and the wos grayed by the write barrier are
+ * expanded again, since the mutator ran between the marking steps
+ *
+ * @param heap the heap to mark, should be a valid instance heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+static int
+finish_marking(gc_heap_t *heap)
+{
+    hmu_t *cur = NULL, *end = NULL;
+
+    if (expand_all_wos(heap) != GC_SUCCESS)
+        goto fail;
+
+    if (mark_rootset(heap) != GC_SUCCESS)
+        return GC_ERROR;
+
+    if (BH_ATOMIC_32_LOAD(gc_write_barrier_count)
+        != heap->barrier_count_start) {
+        cur = (hmu_t *)heap->base_addr;
+        end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+        while (cur < end) {
+            if (hmu_get_ut(cur) == HMU_WO && hmu_is_wo_gray(cur)) {
+                bh_assert(hmu_is_wo_marked(cur));
+                if (push_wo_to_expand(heap, hmu_to_obj(cur)) != GC_SUCCESS)
+                    goto fail;
+            }
+            cur = (hmu_t *)((char *)cur + hmu_get_size(cur));
+        }
+    }
+
+    if (expand_all_wos(heap) != GC_SUCCESS)
+        goto fail;
+
+    heap->is_marking = 0;
+    sweep_instance_heap(heap);
+#if WASM_ENABLE_GC_COMPACTION != 0
+    compact_instance_heap_if_fragmented(heap);
+#endif
+    return GC_SUCCESS;
+
+fail:
+    LOG_ERROR("mark process is not successfully finished");
+    rollback_mark(heap);
+    return GC_ERROR;
+}
+#endif /* end of WASM_ENABLE_GC_INCREMENTAL != 0 */
+
+/**
+ * Update the pause-time statistics of the heap
+ *
+ * @param heap the heap paused, its lock must be held by the caller
+ * @param start_time the time when the pause started, in microseconds
+ */
+static void
+update_pause_stat(gc_heap_t *heap, uint64 start_time)
+{
+    uint64 pause_time = os_time_get_boot_us() - start_time;
+
+    heap->total_pause_time += pause_time;
+    if (pause_time > heap->max_pause_time)
+        heap->max_pause_time = (gc_size_t)pause_time;
+    heap->pause_count++;
+}
+
 /**
  * Do GC on given heap
  *
@@ -446,11 +1432,14 @@ gci_gc_heap(void *h)
 {
     int ret = GC_ERROR;
     gc_heap_t *heap = (gc_heap_t *)h;
+    uint64 start_time;
 
     bh_assert(gci_is_heap_valid(heap));
 
     LOG_VERBOSE("#reclaim instance heap %p", heap);
 
+    start_time = os_time_get_boot_us();
+
     /* TODO: get exec_env of current thread when GC multi-threading
        is enabled, and pass it to runtime */
     gct_vm_gc_prepare(NULL);
@@ -458,9 +1447,17 @@ gci_gc_heap(void *h)
     gct_vm_mutex_lock(&heap->lock);
     heap->is_doing_reclaim = 1;
 
-    ret = reclaim_instance_heap(heap);
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    if (heap->is_marking)
+        /* finish the marking cycle in progress instead of starting
+           a new one */
+        ret = finish_marking(heap);
+    else
+#endif
+        ret = reclaim_instance_heap(heap);
 
     heap->is_doing_reclaim = 0;
+    update_pause_stat(heap, start_time);
     gct_vm_mutex_unlock(&heap->lock);
 
     /* TODO: get exec_env of current thread when GC multi-threading
@@ -481,6 +1478,120 @@ gci_gc_heap(void *h)
     return ret;
 }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+int
+gci_gc_heap_step(gc_heap_t *heap)
+{
+    int ret = GC_SUCCESS;
+    gc_size_t budget;
+    uint64 start_time;
+
+    bh_assert(gci_is_heap_valid(heap));
+
+    start_time = os_time_get_boot_us();
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_prepare(NULL);
+
+    gct_vm_mutex_lock(&heap->lock);
+    heap->is_doing_reclaim = 1;
+
+    if (!heap->is_marking) {
+        LOG_VERBOSE("#start marking instance heap %p", heap);
+        ret = start_marking(heap);
+    }
+    else {
+        budget = heap->mark_budget;
+        heap->mark_budget = 0;
+
+        if (expand_wos(heap, budget) != GC_SUCCESS) {
+            LOG_ERROR("mark process is not successfully finished");
+            rollback_mark(heap);
+            ret = GC_ERROR;
+        }
+        else if (!heap->root_set) {
+            LOG_VERBOSE("#finish marking instance heap %p", heap);
+            ret = finish_marking(heap);
+        }
+    }
+
+    heap->is_doing_reclaim = 0;
+    update_pause_stat(heap, start_time);
+    gct_vm_mutex_unlock(&heap->lock);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_finished(NULL);
+
+#if BH_ENABLE_GC_VERIFY != 0
+    if (!heap->is_marking)
+        gci_verify_heap(heap);
+#endif
+
+    return ret;
+}
+
+void
+gci_abort_marking(gc_heap_t *heap)
+{
+    if (heap->is_marking)
+        rollback_mark(heap);
+}
+
+void
+gc_write_barrier(gc_object_t obj)
+{
+    hmu_t *hmu = obj_to_hmu(obj);
+
+    /* only the wos marked in current cycle need to be expanded again,
+       the wos not marked yet will be expanded later if they are live */
+    if (hmu_is_wo_marked(hmu) && !hmu_is_wo_gray(hmu)) {
+        hmu_gray_wo(hmu);
+        BH_ATOMIC_32_FETCH_ADD(gc_write_barrier_count, 1);
+    }
+}
+#endif /* end of WASM_ENABLE_GC_INCREMENTAL != 0 */
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+int
+gci_compact_heap(gc_heap_t *heap)
+{
+    int ret = GC_SUCCESS;
+    uint64 start_time;
+
+    bh_assert(gci_is_heap_valid(heap));
+
+    start_time = os_time_get_boot_us();
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_prepare(NULL);
+
+    gct_vm_mutex_lock(&heap->lock);
+    heap->is_doing_reclaim = 1;
+
+    if (is_compaction_allowed(heap)) {
+        LOG_VERBOSE("#compact instance heap %p", heap);
+        ret = compact_instance_heap(heap);
+    }
+
+    heap->is_doing_reclaim = 0;
+    update_pause_stat(heap, start_time);
+    gct_vm_mutex_unlock(&heap->lock);
+
+    /* TODO: get exec_env of current thread when GC multi-threading
+       is enabled, and pass it to runtime */
+    gct_vm_gc_finished(NULL);
+
+#if BH_ENABLE_GC_VERIFY != 0
+    gci_verify_heap(heap);
+#endif
+
+    return ret;
+}
+#endif /* end of WASM_ENABLE_GC_COMPACTION != 0 */
+
 int
 gc_is_dead_object(void *obj)
 {
@@ -147,6 +147,34 @@ gc_enable_gc_reclaim(gc_handle_t handle, void *cluster);
 #endif
 #endif
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+/**
+ * Enable the per-thread caches of small chunks for a heap, which reduce
+ * the contention of the heap lock when multiple threads allocate and
+ * free memory from the heap. The caches are allocated from the heap
+ * itself, and the heap can't be migrated after that.
+ *
+ * @param handle handle of the heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_enable_thread_cache(gc_handle_t handle);
+#endif
+
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+/**
+ * Set the number of helper threads which mark the heap in parallel with
+ * the collecting thread when the heap is collected
+ *
+ * @param handle handle of the heap
+ * @param num number of helper threads, 0 to mark the heap in the
+ *        collecting thread only
+ */
+void
+gc_set_mark_helper_num(gc_handle_t handle, uint32 num);
+#endif
+
 /**
  * Return heap struct size
  */
@@ -175,6 +203,33 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size);
 bool
 gc_is_heap_corrupted(gc_handle_t handle);
 
+#if WASM_ENABLE_INSTANCE_RESET != 0
+/**
+ * Save the heap structure, so that the heap can be restored to current
+ * state together with a copy of its pool data
+ *
+ * @param handle handle of the heap
+ * @param buf the buffer to save the state, its size must be at least
+ *        gc_get_heap_struct_size()
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_save_heap_state(gc_handle_t handle, void *buf);
+
+/**
+ * Restore the heap structure saved by gc_save_heap_state, the pool data
+ * must have been restored to the state when it was saved
+ *
+ * @param handle handle of the heap
+ * @param buf the buffer of the saved state
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_restore_heap_state(gc_handle_t handle, const void *buf);
+#endif
+
 /**
  * Get Heap Stats
  *
@@ -257,9 +312,35 @@ gc_free_wo_internal(void *vheap, void *ptr, const char *file, int line);
 int
 gc_add_root(void *heap, gc_object_t obj);
 
+/**
+ * Add the gc object ref stored in a root slot to the rootset of a gc heap,
+ * if the heap is compacting, the slot is updated to the new address of
+ * the object instead.
+ *
+ * @param heap the heap to add the gc object to its rootset
+ * @param p_obj address of the root slot, which may be unaligned and
+ *        should hold a pointer to a valid WASM object managed by the heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gc_add_root_slot(void *heap, void *p_obj);
+
 int
 gci_gc_heap(void *heap);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/**
+ * Write barrier of incremental marking, it should be called when a
+ * reference is stored into a gc object, so that the object is expanded
+ * again if it has been marked in current marking cycle.
+ *
+ * @param obj the gc object written
+ */
+void
+gc_write_barrier(gc_object_t obj);
+#endif
+
 extra_info_node_t *
 gc_search_extra_info_node(gc_handle_t handle, gc_object_t obj,
                           gc_size_t *p_index);
@@ -308,6 +389,11 @@ wasm_runtime_get_wasm_object_extra_info_flag(gc_object_t obj);
 void
 wasm_runtime_set_wasm_object_extra_info_flag(gc_object_t obj, bool set);
 
+#if WASM_ENABLE_GC_COMPACTION != 0
+bool
+wasm_runtime_is_gc_compaction_allowed(void *exec_env);
+#endif
+
 void
 wasm_runtime_gc_prepare(void *exec_env);
 
@@ -328,11 +414,35 @@ typedef struct {
     int wo_free;
     int usage_sizes[GC_HEAP_STAT_SIZE];
     int free_sizes[GC_HEAP_STAT_SIZE];
+#if WASM_ENABLE_GC != 0
+    /* number of times the mutator was paused by the collector, and
+       the total and the max pause time in microseconds */
+    uint32 pause_count;
+    uint32 max_pause_time;
+    uint64 total_pause_time;
+#endif
 } gc_stat_t;
 
 void
 gc_show_stat(gc_handle_t handle);
 
+#if WASM_ENABLE_GC != 0
+/**
+ * Get the statistics of the collections of a heap, they are kept as
+ * counters and can be read without walking through the heap
+ *
+ * @param handle handle of the heap
+ * @param p_gc_count [out] number of collections
+ * @param p_pause_count [out] number of times the mutator was paused
+ * @param p_max_pause_time [out] max pause time in microseconds
+ * @param p_total_pause_time [out] total pause time in microseconds
+ */
+void
+gc_get_collection_stats(gc_handle_t handle, gc_uint32 *p_gc_count,
+                        gc_uint32 *p_pause_count, gc_uint32 *p_max_pause_time,
+                        gc_uint64 *p_total_pause_time);
+#endif
+
 #if WASM_ENABLE_GC != 0
 void
 gc_show_fragment(gc_handle_t handle);
@@ -143,6 +143,17 @@ hmu_verify(void *vheap, hmu_t *hmu);
 #define hmu_unmark_wo(hmu) CLRBIT((hmu)->header, HMU_WO_MB_OFFSET)
 #define hmu_is_wo_marked(hmu) GETBIT((hmu)->header, HMU_WO_MB_OFFSET)
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Gray bit of incremental marking, it is set by the write barrier when
+   a reference is stored into a marked wo, and the wo will be expanded
+   again before sweeping. Bit 27 isn't used by the hmu size. */
+#define HMU_WO_GB_OFFSET 27
+
+#define hmu_gray_wo(hmu) SETBIT((hmu)->header, HMU_WO_GB_OFFSET)
+#define hmu_ungray_wo(hmu) CLRBIT((hmu)->header, HMU_WO_GB_OFFSET)
+#define hmu_is_wo_gray(hmu) GETBIT((hmu)->header, HMU_WO_GB_OFFSET)
+#endif
+
 /**
  * The hmu size is divisible by 8, its lowest 3 bits are 0, so we only
  * store its higher bits of bit [29..3], and bit [2..0] are not stored.
@@ -156,6 +167,7 @@ hmu_verify(void *vheap, hmu_t *hmu);
 
 #define hmu_is_vo_freed(hmu) GETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 #define hmu_unfree_vo(hmu) CLRBIT((hmu)->header, HMU_VO_FB_OFFSET)
+#define hmu_free_vo(hmu) SETBIT((hmu)->header, HMU_VO_FB_OFFSET)
 
 #define hmu_get_size(hmu) \
     (GETBITS((hmu)->header, HMU_SIZE_OFFSET, HMU_SIZE_SIZE) << 3)
@@ -249,6 +261,78 @@ bh_static_assert(offsetof(hmu_tree_node_t, left) == 4);
                   == 0);                                                    \
     } while (0)
 
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0 && WASM_ENABLE_GC == 0 \
+    && defined(os_thread_local_attribute)
+#define GC_ENABLE_THREAD_CACHE 1
+#else
+#define GC_ENABLE_THREAD_CACHE 0
+#endif
+
+#if GC_ENABLE_THREAD_CACHE != 0
+/* Number of thread caches of a heap, the threads are assigned to
+   them in round-robin order */
+#ifndef GC_THREAD_CACHE_NUM
+#define GC_THREAD_CACHE_NUM 16
+#endif
+
+/* Number of size classes of a thread cache, chunks whose size is less
+   than (GC_THREAD_CACHE_BIN_CNT << 3) bytes are cached */
+#define GC_THREAD_CACHE_BIN_CNT HMU_NORMAL_NODE_CNT
+
+/* Max number of chunks cached in one size class */
+#ifndef GC_THREAD_CACHE_BIN_MAX
+#define GC_THREAD_CACHE_BIN_MAX 32
+#endif
+
+/* Number of chunks allocated from the heap at a time when a size class
+   of the thread cache is empty */
+#ifndef GC_THREAD_CACHE_REFILL_CNT
+#define GC_THREAD_CACHE_REFILL_CNT 8
+#endif
+
+/* Max total size of the chunks cached in one thread cache */
+#ifndef GC_THREAD_CACHE_MAX_SIZE
+#define GC_THREAD_CACHE_MAX_SIZE (32 * 1024)
+#endif
+
+#define GC_THREAD_CACHE_IS_CACHEABLE(size) \
+    (((size) >> 3) < GC_THREAD_CACHE_BIN_CNT)
+
+/**
+ * The cached chunks are kept as VO chunks with the freed bit set, so
+ * they are in use from the view of the heap and aren't merged with their
+ * neighbors, and they are linked with hmu_normal_node_t
+ */
+typedef struct gc_thread_cache {
+    korp_mutex lock;
+    hmu_normal_node_t *bins[GC_THREAD_CACHE_BIN_CNT];
+    uint16 bin_counts[GC_THREAD_CACHE_BIN_CNT];
+    gc_size_t cached_size;
+} gc_thread_cache_t;
+#endif /* end of GC_ENABLE_THREAD_CACHE != 0 */
+
+/* The bump allocation is disabled when a collection is done in every
+   allocation, since the wos allocated from the buffer don't trigger it */
+#if WASM_ENABLE_GC != 0 && WASM_ENABLE_GC_BUMP_ALLOC != 0 \
+    && GC_IN_EVERY_ALLOCATION == 0
+#define GC_ENABLE_BUMP_ALLOC 1
+#else
+#define GC_ENABLE_BUMP_ALLOC 0
+#endif
+
+#if GC_ENABLE_BUMP_ALLOC != 0
+/* Size of the buffer carved from the free chunks at a time, from which
+   the small wos are allocated by bumping a pointer */
+#ifndef GC_BUMP_ALLOC_BUF_SIZE
+#define GC_BUMP_ALLOC_BUF_SIZE (4 * 1024)
+#endif
+
+/* Max size of a wo (including the hmu header) allocated from the buffer */
+#ifndef GC_BUMP_ALLOC_MAX_SIZE
+#define GC_BUMP_ALLOC_MAX_SIZE HMU_FC_NORMAL_MAX_SIZE
+#endif
+#endif /* end of GC_ENABLE_BUMP_ALLOC != 0 */
+
 typedef struct gc_heap_struct {
     /* for double checking*/
     gc_handle_t heap_id;
@@ -296,6 +380,18 @@ typedef struct gc_heap_struct {
 
     /* Whether the heap can do reclaim */
     unsigned is_reclaim_enabled : 1;
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* whether an incremental marking cycle is in progress, the wos
+       to expand are kept in root_set between the marking steps */
+    unsigned is_marking : 1;
+#endif
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+    /* whether the heap is compacting, the root slots enumerated are
+       updated to the new addresses of the wos instead of being marked */
+    unsigned is_compacting : 1;
+#endif
 #endif
 
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
@@ -314,6 +410,37 @@ typedef struct gc_heap_struct {
     gc_size_t total_gc_count;
     gc_size_t total_gc_time;
     gc_size_t max_gc_time;
+    /* pause-time statistics of the collector, in microseconds */
+    gc_uint64 total_pause_time;
+    gc_size_t max_pause_time;
+    gc_size_t pause_count;
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* bytes of wos to expand in the next marking step, which grows
+       with the bytes allocated during the marking cycle */
+    gc_size_t mark_budget;
+    /* gc_write_barrier_count when the marking cycle started */
+    gc_uint32 barrier_count_start;
+#endif
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+    /* number of helper threads to mark the heap with the collecting
+       thread, 0 to mark it in the collecting thread only */
+    gc_size_t mark_helper_num;
+#endif
+#if WASM_ENABLE_GC_COMPACTION != 0
+    gc_size_t total_compact_count;
+    /* the relocation runs of the compaction in progress, sorted by
+       their old addresses */
+    struct gc_compact_run *compact_runs;
+    gc_size_t compact_run_count;
+#endif
+#if GC_ENABLE_BUMP_ALLOC != 0
+    /* the unused part of the bump allocation buffer, which is kept as
+       a HMU_FM chunk, so that it is free from the view of the sweeping
+       and the compaction but isn't merged with its neighbors, both are
+       NULL if there is no buffer */
+    gc_uint8 *bump_ptr;
+    gc_uint8 *bump_end;
+#endif
     /* Usually there won't be too many extra info node, so we try to use a fixed
      * array to store them, if the fixed array don't have enough space to store
      * the nodes, a new space will be allocated from heap */
@@ -329,12 +456,65 @@ typedef struct gc_heap_struct {
     gc_uint64 total_size_allocated;
     gc_uint64 total_size_freed;
 #endif
+#if GC_ENABLE_THREAD_CACHE != 0
+    /* array of GC_THREAD_CACHE_NUM thread caches allocated from the
+       heap itself, NULL if thread cache isn't enabled */
+    gc_thread_cache_t *thread_caches;
+#endif
 } gc_heap_t;
 
 #if WASM_ENABLE_GC != 0
 
 #define GC_DEFAULT_THRESHOLD_FACTOR 300
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Bytes of wos expanded by the marking steps for each byte allocated
+   during an incremental marking cycle */
+#ifndef GC_INCREMENTAL_MARK_RATIO
+#define GC_INCREMENTAL_MARK_RATIO 4
+#endif
+
+/* A marking step is delayed until it can expand this many bytes of wos,
+   to avoid pausing the mutator in every allocation */
+#ifndef GC_INCREMENTAL_MIN_STEP_SIZE
+#define GC_INCREMENTAL_MIN_STEP_SIZE (16 * 1024)
+#endif
+#endif
+
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+/* Default number of helper threads of the parallel marking */
+#ifndef GC_PARALLEL_MARK_HELPER_NUM
+#define GC_PARALLEL_MARK_HELPER_NUM 3
+#endif
+
+/* The heap is marked in parallel only if this many bytes are in use,
+   since creating the helper threads costs more than marking a small
+   heap */
+#ifndef GC_PARALLEL_MARK_MIN_USED_SIZE
+#define GC_PARALLEL_MARK_MIN_USED_SIZE (4 * 1024 * 1024)
+#endif
+
+/* A marker shares half of its wos to expand once it holds this many
+   wos and some markers are waiting for wos to steal */
+#ifndef GC_PARALLEL_MARK_SHARE_MIN_CNT
+#define GC_PARALLEL_MARK_SHARE_MIN_CNT 4
+#endif
+#endif
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+/* The heap is compacted after a collection if the percentage of free
+   space outside the largest free chunk reaches this value */
+#ifndef GC_COMPACTION_FRAGMENT_THRESHOLD
+#define GC_COMPACTION_FRAGMENT_THRESHOLD 50
+#endif
+
+/* A run of adjacent live wos which are moved by the same distance */
+typedef struct gc_compact_run {
+    gc_uint8 *old_addr;
+    gc_uint8 *new_addr;
+} gc_compact_run_t;
+#endif
+
 static inline void
 gc_update_threshold(gc_heap_t *heap)
 {
@@ -347,6 +527,21 @@ gc_update_threshold(gc_heap_t *heap)
     heap->gc_threshold = (uint32_t)result;
 }
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/* Whether to start an incremental marking cycle, it is started earlier
+   than a full collection, so that the used space can be marked before
+   the free space drops below gc_threshold */
+static inline bool
+gc_need_start_marking(gc_heap_t *heap)
+{
+    uint64 used_size = heap->current_size - heap->total_free_size;
+
+    return (uint64)heap->total_free_size
+           < (uint64)heap->gc_threshold
+                 + used_size / GC_INCREMENTAL_MARK_RATIO;
+}
+#endif
+
 #define gct_vm_mutex_init os_mutex_init
 #define gct_vm_mutex_destroy os_mutex_destroy
 #define gct_vm_mutex_lock os_mutex_lock
@@ -357,6 +552,7 @@ gc_update_threshold(gc_heap_t *heap)
 #define gct_vm_get_wasm_object_ref_list wasm_runtime_get_wasm_object_ref_list
 #define gct_vm_get_extra_info_flag wasm_runtime_get_wasm_object_extra_info_flag
 #define gct_vm_set_extra_info_flag wasm_runtime_set_wasm_object_extra_info_flag
+#define gct_vm_is_compaction_allowed wasm_runtime_is_gc_compaction_allowed
 
 #endif /* end of WAMS_ENABLE_GC != 0 */
 
@@ -370,6 +566,59 @@ gci_add_fc(gc_heap_t *heap, hmu_t *hmu, gc_size_t size);
 int
 gci_is_heap_valid(gc_heap_t *heap);
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+/**
+ * Do an incremental marking step on given heap: start a marking cycle
+ * if there is none, or expand heap->mark_budget bytes of wos, and finish
+ * the cycle and sweep the heap if there are no wos left to expand. The
+ * heap lock must not be held by the caller.
+ *
+ * @param heap should be a valid heap
+ *
+ * @return GC_SUCCESS if success, GC_ERROR otherwise
+ */
+int
+gci_gc_heap_step(gc_heap_t *heap);
+
+/**
+ * Abort the marking cycle in progress and unmark all wos, the heap lock
+ * must be held by the caller if the heap may be accessed by other threads
+ */
+void
+gci_abort_marking(gc_heap_t *heap);
+#endif
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+/**
+ * Compact given heap if it is allowed, i.e. slide all wos towards the
+ * heap start so that the free space is merged into one chunk, the heap
+ * lock must not be held by the caller
+ *
+ * @param heap should be a valid heap which has been swept
+ *
+ * @return GC_SUCCESS if success or the heap isn't compacted,
+ *         GC_ERROR otherwise
+ */
+int
+gci_compact_heap(gc_heap_t *heap);
+#endif
+
+#if GC_ENABLE_THREAD_CACHE != 0
+/**
+ * Return the chunks of all thread caches back to the heap, the
+ * heap lock must not be held by the caller
+ */
+void
+gci_flush_thread_caches(gc_heap_t *heap);
+
+/**
+ * Get the total size of the chunks held by all thread caches, which are
+ * in use from the view of the heap but free for its users
+ */
+gc_size_t
+gci_get_thread_cached_size(gc_heap_t *heap);
+#endif
+
 /**
  * Verify heap integrity
  */
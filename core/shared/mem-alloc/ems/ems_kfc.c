@@ -30,6 +30,9 @@ gc_init_internal(gc_heap_t *heap, char *base_addr, gc_size_t heap_max_size)
 #if WASM_ENABLE_GC != 0
     heap->gc_threshold_factor = GC_DEFAULT_THRESHOLD_FACTOR;
     gc_update_threshold(heap);
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+    heap->mark_helper_num = GC_PARALLEL_MARK_HELPER_NUM;
+#endif
 #endif
 
     root = heap->kfc_tree_root = (hmu_tree_node_t *)heap->kfc_tree_root_buf;
@@ -137,6 +140,11 @@ gc_destroy_with_pool(gc_handle_t handle)
 #if WASM_ENABLE_GC != 0
     gc_size_t i = 0;
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* free the to-expand list of the marking cycle in progress */
+    gci_abort_marking(heap);
+#endif
+
     if (heap->extra_info_node_cnt > 0) {
         for (i = 0; i < heap->extra_info_node_cnt; i++) {
             extra_info_node_t *node = heap->extra_info_nodes[i];
@@ -156,6 +164,19 @@ gc_destroy_with_pool(gc_handle_t handle)
     }
 #endif
 
+#if GC_ENABLE_THREAD_CACHE != 0
+    if (heap->thread_caches) {
+        gc_thread_cache_t *caches = heap->thread_caches;
+        gc_size_t j;
+
+        gci_flush_thread_caches(heap);
+        for (j = 0; j < GC_THREAD_CACHE_NUM; j++)
+            os_mutex_destroy(&caches[j].lock);
+        heap->thread_caches = NULL;
+        gc_free_vo(heap, caches);
+    }
+#endif
+
 #if BH_ENABLE_GC_VERIFY != 0
     hmu_t *cur = (hmu_t *)heap->base_addr;
     hmu_t *end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
@@ -197,6 +218,57 @@ gc_enable_gc_reclaim(gc_handle_t handle, void *cluster)
     heap->cluster = cluster;
 }
 #endif
+
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+void
+gc_set_mark_helper_num(gc_handle_t handle, uint32 num)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    os_mutex_lock(&heap->lock);
+    heap->mark_helper_num = num;
+    os_mutex_unlock(&heap->lock);
+}
+#endif
+#endif
+
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+int
+gc_enable_thread_cache(gc_handle_t handle)
+{
+#if GC_ENABLE_THREAD_CACHE != 0
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    gc_thread_cache_t *caches;
+    uint32 i;
+
+    if (heap->thread_caches)
+        return GC_SUCCESS;
+
+    caches = (gc_thread_cache_t *)gc_alloc_vo(
+        heap, sizeof(gc_thread_cache_t) * GC_THREAD_CACHE_NUM);
+    if (!caches) {
+        LOG_ERROR("[GC_ERROR]failed to allocate thread caches\n");
+        return GC_ERROR;
+    }
+
+    memset(caches, 0, sizeof(gc_thread_cache_t) * GC_THREAD_CACHE_NUM);
+    for (i = 0; i < GC_THREAD_CACHE_NUM; i++) {
+        if (os_mutex_init(&caches[i].lock) != BHT_OK) {
+            LOG_ERROR("[GC_ERROR]failed to init lock\n");
+            while (i > 0)
+                os_mutex_destroy(&caches[--i].lock);
+            gc_free_vo(heap, caches);
+            return GC_ERROR;
+        }
+    }
+
+    heap->thread_caches = caches;
+    return GC_SUCCESS;
+#else
+    (void)handle;
+    return GC_ERROR;
+#endif
+}
 #endif
 
 uint32
@@ -249,6 +321,15 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
         return GC_ERROR;
     }
 
+#if GC_ENABLE_THREAD_CACHE != 0
+    if (heap->thread_caches) {
+        /* the locks of thread caches are allocated from the heap and
+           can't be moved */
+        LOG_ERROR("[GC_ERROR]heap migrate with thread cache enabled\n");
+        return GC_ERROR;
+    }
+#endif
+
     heap_max_size = (uint32)(pool_buf_end - base_addr_new) & (uint32)~7;
 
     if (pool_buf_end < base_addr_new || heap_max_size < heap->current_size) {
@@ -259,6 +340,12 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     if (offset == 0)
         return 0;
 
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+    /* the to-expand list records the addresses of wos, roll back the
+       marking cycle in progress and start a new one later */
+    gci_abort_marking(heap);
+#endif
+
 #if BH_ENABLE_GC_CORRUPTION_CHECK != 0
     if (heap->is_heap_corrupted) {
         LOG_ERROR("[GC_ERROR]Heap is corrupted, heap migrate failed.\n");
@@ -280,6 +367,13 @@ gc_migrate(gc_handle_t handle, char *pool_buf_new, gc_size_t pool_buf_size)
     adjust_ptr(p_right, offset);
     adjust_ptr(p_parent, offset);
 
+#if GC_ENABLE_BUMP_ALLOC != 0
+    if (heap->bump_ptr) {
+        adjust_ptr(&heap->bump_ptr, offset);
+        adjust_ptr(&heap->bump_end, offset);
+    }
+#endif
+
     cur = (hmu_t *)heap->base_addr;
     end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
 
@@ -340,6 +434,45 @@ gc_is_heap_corrupted(gc_handle_t handle)
 #endif
 }
 
+#if WASM_ENABLE_INSTANCE_RESET != 0
+int
+gc_save_heap_state(gc_handle_t handle, void *buf)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    os_mutex_lock(&heap->lock);
+    bh_memcpy_s(buf, sizeof(gc_heap_t), heap, sizeof(gc_heap_t));
+    os_mutex_unlock(&heap->lock);
+    return GC_SUCCESS;
+}
+
+int
+gc_restore_heap_state(gc_handle_t handle, const void *buf)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+    const gc_heap_t *heap_saved = (const gc_heap_t *)buf;
+    uint32 lock_end = offsetof(gc_heap_t, lock) + sizeof(korp_mutex);
+
+    if (heap_saved->heap_id != heap->heap_id
+        || heap_saved->base_addr != heap->base_addr
+        || heap_saved->current_size != heap->current_size) {
+        LOG_ERROR("[GC_ERROR]heap restore from state of another heap\n");
+        return GC_ERROR;
+    }
+
+    /* the pool data must have been restored to the same state, copy all
+       the fields except the lock, which is held while copying */
+    os_mutex_lock(&heap->lock);
+    bh_memcpy_s(heap, offsetof(gc_heap_t, lock), heap_saved,
+                offsetof(gc_heap_t, lock));
+    bh_memcpy_s((uint8 *)heap + lock_end, sizeof(gc_heap_t) - lock_end,
+                (const uint8 *)heap_saved + lock_end,
+                sizeof(gc_heap_t) - lock_end);
+    os_mutex_unlock(&heap->lock);
+    return GC_SUCCESS;
+}
+#endif
+
 #if BH_ENABLE_GC_VERIFY != 0
 void
 gci_verify_heap(gc_heap_t *heap)
@@ -403,6 +536,12 @@ gc_heap_stat(void *heap_ptr, gc_stat_t *stat)
 
         cur = (hmu_t *)((char *)cur + size);
     }
+
+#if WASM_ENABLE_GC != 0
+    stat->pause_count = heap->pause_count;
+    stat->max_pause_time = heap->max_pause_time;
+    stat->total_pause_time = heap->total_pause_time;
+#endif
 }
 
 void
@@ -428,6 +567,12 @@ gc_print_stat(void *heap_ptr, int verbose)
 #else
     os_printf("# stat gc %" PRIu32 " free size %" PRIu32 " high %" PRIu32 "\n",
               heap->total_gc_count, heap->total_free_size, heap->highmark_size);
+    os_printf("# stat pause %" PRIu32 " total %" PRIu64 "us max %" PRIu32
+              "us\n",
+              stat.pause_count, stat.total_pause_time, stat.max_pause_time);
+#if WASM_ENABLE_GC_COMPACTION != 0
+    os_printf("# stat compaction %" PRIu32 "\n", heap->total_compact_count);
+#endif
 #endif
     if (verbose) {
         os_printf("usage sizes: \n");
@@ -461,6 +606,10 @@ gc_heap_stats(void *heap_arg, uint32 *stats, int size)
                 break;
             case GC_STAT_FREE:
                 stats[i] = heap->total_free_size;
+#if GC_ENABLE_THREAD_CACHE != 0
+                if (heap->thread_caches)
+                    stats[i] += gci_get_thread_cached_size(heap);
+#endif
                 break;
             case GC_STAT_HIGHMARK:
                 stats[i] = heap->highmark_size;
@@ -481,6 +630,23 @@ gc_heap_stats(void *heap_arg, uint32 *stats, int size)
     return heap;
 }
 
+#if WASM_ENABLE_GC != 0
+void
+gc_get_collection_stats(gc_handle_t handle, gc_uint32 *p_gc_count,
+                        gc_uint32 *p_pause_count, gc_uint32 *p_max_pause_time,
+                        gc_uint64 *p_total_pause_time)
+{
+    gc_heap_t *heap = (gc_heap_t *)handle;
+
+    /* the counters are read without the lock, a value may be one
+       collection behind when the heap is being collected */
+    *p_gc_count = heap->total_gc_count;
+    *p_pause_count = heap->pause_count;
+    *p_max_pause_time = heap->max_pause_time;
+    *p_total_pause_time = heap->total_pause_time;
+}
+#endif
+
 void
 gc_traverse_tree(hmu_tree_node_t *node, gc_size_t *stats, int *n)
 {
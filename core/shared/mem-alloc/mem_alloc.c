@@ -92,6 +92,20 @@ mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj)
 {
     return gc_add_root((gc_handle_t)allocator, (gc_object_t)obj);
 }
+
+int
+mem_allocator_add_root_slot(mem_allocator_t allocator, void *p_obj)
+{
+    return gc_add_root_slot((gc_handle_t)allocator, p_obj);
+}
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+void
+mem_allocator_write_barrier(WASMObjectRef obj)
+{
+    gc_write_barrier((gc_object_t)obj);
+}
+#endif
 #endif
 
 int
@@ -107,6 +121,28 @@ mem_allocator_is_heap_corrupted(mem_allocator_t allocator)
     return gc_is_heap_corrupted((gc_handle_t)allocator);
 }
 
+#if WASM_ENABLE_INSTANCE_RESET != 0
+bool
+mem_allocator_save_state(mem_allocator_t allocator, void *buf)
+{
+    return gc_save_heap_state((gc_handle_t)allocator, buf) == GC_SUCCESS;
+}
+
+bool
+mem_allocator_restore_state(mem_allocator_t allocator, const void *buf)
+{
+    return gc_restore_heap_state((gc_handle_t)allocator, buf) == GC_SUCCESS;
+}
+#endif
+
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+bool
+mem_allocator_enable_thread_cache(mem_allocator_t allocator)
+{
+    return gc_enable_thread_cache((gc_handle_t)allocator) == GC_SUCCESS;
+}
+#endif
+
 bool
 mem_allocator_get_alloc_info(mem_allocator_t allocator, void *mem_alloc_info)
 {
@@ -136,6 +172,15 @@ mem_allocator_dump_perf_profiling(mem_allocator_t allocator)
 }
 #endif
 
+void
+mem_allocator_get_gc_stats(mem_allocator_t allocator, uint32 *p_gc_count,
+                           uint32 *p_pause_count, uint32 *p_max_pause_time,
+                           uint64 *p_total_pause_time)
+{
+    gc_get_collection_stats((gc_handle_t)allocator, p_gc_count, p_pause_count,
+                            p_max_pause_time, p_total_pause_time);
+}
+
 #endif
 
 #else /* else of DEFAULT_MEM_ALLOCATOR */
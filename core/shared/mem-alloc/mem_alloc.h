@@ -53,6 +53,19 @@ mem_allocator_migrate(mem_allocator_t allocator, char *pool_buf_new,
 bool
 mem_allocator_is_heap_corrupted(mem_allocator_t allocator);
 
+#if WASM_ENABLE_INSTANCE_RESET != 0
+bool
+mem_allocator_save_state(mem_allocator_t allocator, void *buf);
+
+bool
+mem_allocator_restore_state(mem_allocator_t allocator, const void *buf);
+#endif
+
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+bool
+mem_allocator_enable_thread_cache(mem_allocator_t allocator);
+#endif
+
 #if WASM_ENABLE_GC != 0
 void *
 mem_allocator_malloc_with_gc(mem_allocator_t allocator, uint32_t size);
@@ -73,6 +86,16 @@ mem_allocator_enable_gc_reclaim(mem_allocator_t allocator, void *cluster);
 int
 mem_allocator_add_root(mem_allocator_t allocator, WASMObjectRef obj);
 
+/* Add the object stored in a root slot, the slot is updated instead
+   when the heap is compacting */
+int
+mem_allocator_add_root_slot(mem_allocator_t allocator, void *p_obj);
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+void
+mem_allocator_write_barrier(WASMObjectRef obj);
+#endif
+
 bool
 mem_allocator_set_gc_finalizer(mem_allocator_t allocator, void *obj,
                                gc_finalizer_t cb, void *data);
@@ -84,6 +107,11 @@ mem_allocator_unset_gc_finalizer(mem_allocator_t allocator, void *obj);
 void
 mem_allocator_dump_perf_profiling(mem_allocator_t allocator);
 #endif
+
+void
+mem_allocator_get_gc_stats(mem_allocator_t allocator, uint32 *p_gc_count,
+                           uint32 *p_pause_count, uint32 *p_max_pause_time,
+                           uint64 *p_total_pause_time);
 #endif /* end of WASM_ENABLE_GC != 0 */
 
 bool
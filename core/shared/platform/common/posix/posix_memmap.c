@@ -3,6 +3,11 @@
  * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
  */
 
+#ifndef _GNU_SOURCE
+#if !defined(__RTTHREAD__)
+#define _GNU_SOURCE
+#endif
+#endif
 #include "platform_api_vmcore.h"
 
 #if defined(__APPLE__) || defined(__MACH__)
@@ -50,15 +55,23 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     uint64 request_size, page_size;
     uint8 *addr = MAP_FAILED;
     uint32 i;
+#if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
+    bool extra_huge_page = false;
+#endif
 
     page_size = (uint64)getpagesize();
     request_size = (size + page_size - 1) & ~(page_size - 1);
 
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
-    /* huge page isn't supported on MacOS and NuttX */
-    if (request_size >= HUGE_PAGE_SIZE)
+    /* huge page isn't supported on MacOS and NuttX, a fixed mapping
+       must not exceed the requested range, and a no-reserve mapping is
+       backed by normal pages only when they are touched */
+    if (request_size >= HUGE_PAGE_SIZE
+        && !(flags & (MMAP_MAP_FIXED | MMAP_MAP_NORESERVE))) {
         /* apply one extra huge page */
         request_size += HUGE_PAGE_SIZE;
+        extra_huge_page = true;
+    }
 #endif
 
     if ((size_t)request_size < size) {
@@ -92,6 +105,11 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
     if (flags & MMAP_MAP_FIXED)
         map_flags |= MAP_FIXED;
 
+#ifdef MAP_NORESERVE
+    if (flags & MMAP_MAP_NORESERVE)
+        map_flags |= MAP_NORESERVE;
+#endif
+
 #if defined(BUILD_TARGET_RISCV64_LP64D) || defined(BUILD_TARGET_RISCV64_LP64)
     /* As AOT relocation in RISCV64 may require that the code/data mapped
      * is in range 0 to 2GB, we try to map the memory with hint address
@@ -171,7 +189,7 @@ os_mmap(void *hint, size_t size, int prot, int flags, os_file_handle file)
 
 #if !defined(__APPLE__) && !defined(__NuttX__) && defined(MADV_HUGEPAGE)
     /* huge page isn't supported on MacOS and NuttX */
-    if (request_size > HUGE_PAGE_SIZE) {
+    if (extra_huge_page && request_size > HUGE_PAGE_SIZE) {
         uintptr_t huge_start, huge_end;
         size_t prefix_size = 0, suffix_size = HUGE_PAGE_SIZE;
 
@@ -286,6 +304,155 @@ os_mprotect(void *addr, size_t size, int prot)
     return mprotect(addr, request_size, map_prot);
 }
 
+#ifdef OS_ENABLE_FILE_MAPPING
+os_file_handle
+os_file_open_for_mapping(const char *path, uint64 *p_size)
+{
+    struct stat stat_buf;
+    int fd;
+
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+        return -1;
+
+    if (fstat(fd, &stat_buf) != 0 || !S_ISREG(stat_buf.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    *p_size = (uint64)stat_buf.st_size;
+    return fd;
+}
+
+void
+os_file_close_for_mapping(os_file_handle file)
+{
+    close(file);
+}
+
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags,
+             os_file_handle file, uint64 offset)
+{
+    int map_prot = PROT_NONE;
+    int map_flags = MAP_PRIVATE;
+    void *addr;
+
+    if (prot & MMAP_PROT_READ)
+        map_prot |= PROT_READ;
+
+    if (prot & MMAP_PROT_WRITE)
+        map_prot |= PROT_WRITE;
+
+    if (prot & MMAP_PROT_EXEC)
+        map_prot |= PROT_EXEC;
+
+#if defined(BUILD_TARGET_X86_64) || defined(BUILD_TARGET_AMD_64)
+    if (flags & MMAP_MAP_32BIT)
+        map_flags |= MAP_32BIT;
+#endif
+
+    if (flags & MMAP_MAP_FIXED)
+        map_flags |= MAP_FIXED;
+
+#ifdef MAP_NORESERVE
+    if (flags & MMAP_MAP_NORESERVE)
+        map_flags |= MAP_NORESERVE;
+#endif
+
+    addr = mmap(hint, size, map_prot, map_flags, file, (off_t)offset);
+    if (addr == MAP_FAILED)
+        return NULL;
+
+#if BH_ENABLE_TRACE_MMAP != 0
+    total_size_mmapped += size;
+    os_printf("mmap file return: %p with size: %zu, total_size_mmapped: %zu, "
+              "total_size_munmapped: %zu\n",
+              addr, size, total_size_mmapped, total_size_munmapped);
+#endif
+    return addr;
+}
+#endif /* end of OS_ENABLE_FILE_MAPPING */
+
+#ifdef OS_ENABLE_MEMORY_FILE
+os_file_handle
+os_memory_file_create(const char *name, uint64 size)
+{
+    int fd;
+
+    if ((fd = memfd_create(name, MFD_CLOEXEC)) < 0)
+        return -1;
+
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int
+os_memory_file_write(os_file_handle file, uint64 offset, const void *buf,
+                     size_t size)
+{
+    const uint8 *p = buf;
+    ssize_t ret;
+
+    while (size > 0) {
+        if ((ret = pwrite(file, p, size, (off_t)offset)) < 0) {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        p += ret;
+        offset += (uint64)ret;
+        size -= (size_t)ret;
+    }
+
+    return 0;
+}
+#endif /* end of OS_ENABLE_MEMORY_FILE */
+
+#ifdef OS_ENABLE_MEM_DISCARD
+int
+os_mem_discard(void *addr, size_t size)
+{
+    return madvise(addr, size, MADV_DONTNEED);
+}
+#endif
+
+#ifdef OS_ENABLE_MEM_RESIDENT_INFO
+int
+os_mem_get_resident_size(void *addr, size_t size, uint64 *p_resident_size)
+{
+    /* query the residency of at most that many pages at a time */
+    unsigned char vec[1024];
+    uint64 page_size = (uint64)getpagesize();
+    uintptr_t start = (uintptr_t)addr & ~(uintptr_t)(page_size - 1);
+    uintptr_t end = (uintptr_t)addr + size;
+    uint64 page_count, resident_count = 0, i;
+    size_t chunk_size;
+
+    while (start < end) {
+        page_count = (end - start + page_size - 1) / page_size;
+        if (page_count > sizeof(vec))
+            page_count = sizeof(vec);
+        chunk_size = (size_t)(page_count * page_size);
+
+        if (mincore((void *)start, chunk_size, vec) != 0)
+            return -1;
+
+        for (i = 0; i < page_count; i++) {
+            if (vec[i] & 1)
+                resident_count++;
+        }
+        start += chunk_size;
+    }
+
+    *p_resident_size = resident_count * page_size;
+    return 0;
+}
+#endif
+
 void
 os_dcache_flush(void)
 {}
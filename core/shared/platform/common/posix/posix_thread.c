@@ -615,7 +615,11 @@ signal_callback(int sig_num, siginfo_t *sig_info, void *sig_ucontext)
 
     /* Try to handle signal with the registered signal handler */
     if (signal_handler && (sig_num == SIGSEGV || sig_num == SIGBUS)) {
-        signal_handler(sig_addr);
+        if (signal_handler(sig_addr)) {
+            /* Restart the faulting instruction, the signal mask is
+               restored when returning from the signal handler */
+            return;
+        }
     }
 
     if (sig_num == SIGSEGV)
@@ -133,6 +133,10 @@ enum {
     /* Don't interpret addr as a hint: place the mapping at exactly
        that address. */
     MMAP_MAP_FIXED = 2,
+    /* Don't reserve swap space for the writable pages of the mapping, and
+       map it with normal pages, so that only the pages touched are backed
+       by physical memory */
+    MMAP_MAP_NORESERVE = 4,
 };
 
 void *
@@ -142,6 +146,93 @@ os_munmap(void *addr, size_t size);
 int
 os_mprotect(void *addr, size_t size, int prot);
 
+#ifdef OS_ENABLE_FILE_MAPPING
+/**
+ * Open a file to map it into memory with os_mmap_file()
+ *
+ * @param path the path of the file
+ * @param p_size return the size of the file
+ *
+ * @return the handle of the file if success, os_get_invalid_handle()
+ *         otherwise
+ */
+os_file_handle
+os_file_open_for_mapping(const char *path, uint64 *p_size);
+
+/**
+ * Close a file opened by os_file_open_for_mapping(), the mappings
+ * created from it remain valid
+ */
+void
+os_file_close_for_mapping(os_file_handle file);
+
+/**
+ * Map a region of a file into memory privately: the pages are shared
+ * with the page cache of the file until they are written, and the
+ * written pages are copied and never written back to the file.
+ * The mapping is released with os_munmap().
+ *
+ * @param offset the offset of the region in the file, which must be
+ *        a multiple of the page size
+ */
+void *
+os_mmap_file(void *hint, size_t size, int prot, int flags,
+             os_file_handle file, uint64 offset);
+#endif
+
+#ifdef OS_ENABLE_MEMORY_FILE
+/**
+ * Create an anonymous file which lives in memory, its content is
+ * zero-initialized and it is mapped with os_mmap_file() and closed
+ * with os_file_close_for_mapping()
+ *
+ * @param name the name of the file, only used for debugging
+ * @param size the size of the file
+ *
+ * @return the handle of the file if success, os_get_invalid_handle()
+ *         otherwise
+ */
+os_file_handle
+os_memory_file_create(const char *name, uint64 size);
+
+/**
+ * Write data to a file created by os_memory_file_create()
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_memory_file_write(os_file_handle file, uint64 offset, const void *buf,
+                     size_t size);
+#endif
+
+#ifdef OS_ENABLE_MEM_DISCARD
+/**
+ * Release the physical pages of a region of a private anonymous mapping,
+ * the region keeps its protection and reads as zeros when it is accessed
+ * again
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_discard(void *addr, size_t size);
+#endif
+
+#ifdef OS_ENABLE_MEM_RESIDENT_INFO
+/**
+ * Get the size of the pages of a memory region which are backed by
+ * physical memory
+ *
+ * @param addr the start address of the region, which is rounded down to
+ *        the page size
+ * @param size the size of the region
+ * @param p_resident_size return the size of the resident pages
+ *
+ * @return 0 if success, -1 otherwise
+ */
+int
+os_mem_get_resident_size(void *addr, size_t size, uint64 *p_resident_size);
+#endif
+
 static inline void *
 os_mremap_slow(void *old_addr, size_t old_size, size_t new_size)
 {
@@ -95,7 +95,9 @@ typedef jmp_buf korp_jmpbuf;
 #define os_longjmp longjmp
 #define os_alloca alloca
 
-typedef void (*os_signal_handler)(void *sig_addr);
+/* Return true if the signal was handled and the faulting instruction
+   can be restarted */
+typedef bool (*os_signal_handler)(void *sig_addr);
 
 int
 os_thread_signal_init(os_signal_handler handler);
@@ -116,6 +118,19 @@ os_sigreturn();
 
 #define os_getpagesize getpagesize
 
+/* Files can be mapped into memory privately with os_mmap_file() */
+#define OS_ENABLE_FILE_MAPPING
+
+/* Pages of anonymous mappings can be released with os_mem_discard() */
+#define OS_ENABLE_MEM_DISCARD
+
+/* The resident pages of mappings can be counted with
+   os_mem_get_resident_size() */
+#define OS_ENABLE_MEM_RESIDENT_INFO
+
+/* In-memory files can be created with os_memory_file_create() */
+#define OS_ENABLE_MEMORY_FILE
+
 #if WASM_DISABLE_WAKEUP_BLOCKING_OP == 0
 #define OS_ENABLE_WAKEUP_BLOCKING_OP
 #endif
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "bh_code_cache.h"
+
+/* SHA-256, see FIPS 180-4 */
+
+static const uint32 sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void
+sha256_transform(uint32 *state, const uint8 *block)
+{
+    uint32 w[64], a, b, c, d, e, f, g, h, t1, t2;
+    uint32 i;
+
+    for (i = 0; i < 16; i++) {
+        w[i] = ((uint32)block[i * 4] << 24) | ((uint32)block[i * 4 + 1] << 16)
+               | ((uint32)block[i * 4 + 2] << 8) | (uint32)block[i * 4 + 3];
+    }
+    for (i = 16; i < 64; i++) {
+        w[i] = (ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10))
+               + w[i - 7]
+               + (ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18)
+                  ^ (w[i - 15] >> 3))
+               + w[i - 16];
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+
+    for (i = 0; i < 64; i++) {
+        t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25))
+             + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+        t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22))
+             + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void
+bh_sha256_init(BHSha256Context *ctx)
+{
+    ctx->state[0] = 0x6a09e667;
+    ctx->state[1] = 0xbb67ae85;
+    ctx->state[2] = 0x3c6ef372;
+    ctx->state[3] = 0xa54ff53a;
+    ctx->state[4] = 0x510e527f;
+    ctx->state[5] = 0x9b05688c;
+    ctx->state[6] = 0x1f83d9ab;
+    ctx->state[7] = 0x5be0cd19;
+    ctx->total_size = 0;
+    ctx->block_size = 0;
+}
+
+void
+bh_sha256_update(BHSha256Context *ctx, const void *data, size_t size)
+{
+    const uint8 *p = (const uint8 *)data, *p_end = p + size;
+    uint32 n;
+
+    ctx->total_size += size;
+
+    while (p < p_end) {
+        if (ctx->block_size == 0 && (size_t)(p_end - p) >= 64) {
+            /* Hash the full blocks in place */
+            sha256_transform(ctx->state, p);
+            p += 64;
+            continue;
+        }
+
+        n = 64 - ctx->block_size;
+        if ((size_t)(p_end - p) < n)
+            n = (uint32)(p_end - p);
+        bh_memcpy_s(ctx->block + ctx->block_size, 64 - ctx->block_size, p, n);
+        ctx->block_size += n;
+        p += n;
+
+        if (ctx->block_size == 64) {
+            sha256_transform(ctx->state, ctx->block);
+            ctx->block_size = 0;
+        }
+    }
+}
+
+void
+bh_sha256_update_str(BHSha256Context *ctx, const char *str)
+{
+    if (!str)
+        str = "";
+    bh_sha256_update(ctx, str, strlen(str) + 1);
+}
+
+void
+bh_sha256_final(BHSha256Context *ctx, uint8 *digest)
+{
+    uint64 bit_count = ctx->total_size * 8;
+    uint32 i;
+
+    /* Append the bit 1, pad with zeros and end the last block with the
+       message length in bits, in big endian */
+    ctx->block[ctx->block_size++] = 0x80;
+    if (ctx->block_size > 56) {
+        memset(ctx->block + ctx->block_size, 0, 64 - ctx->block_size);
+        sha256_transform(ctx->state, ctx->block);
+        ctx->block_size = 0;
+    }
+    memset(ctx->block + ctx->block_size, 0, 56 - ctx->block_size);
+    for (i = 0; i < 8; i++) {
+        ctx->block[56 + i] = (uint8)(bit_count >> (56 - i * 8));
+    }
+    sha256_transform(ctx->state, ctx->block);
+
+    for (i = 0; i < 8; i++) {
+        digest[i * 4] = (uint8)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8)ctx->state[i];
+    }
+}
+
+void
+bh_sha256(const void *data, size_t size, uint8 *digest)
+{
+    BHSha256Context ctx;
+
+    bh_sha256_init(&ctx);
+    bh_sha256_update(&ctx, data, size);
+    bh_sha256_final(&ctx, digest);
+}
+
+void
+bh_sha256_to_hex(const uint8 *digest, char *buf)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+    uint32 i;
+
+    for (i = 0; i < BH_SHA256_DIGEST_SIZE; i++) {
+        buf[i * 2] = hex_digits[digest[i] >> 4];
+        buf[i * 2 + 1] = hex_digits[digest[i] & 0xf];
+    }
+    buf[BH_SHA256_DIGEST_SIZE * 2] = '\0';
+}
+
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0 \
+    || WASM_ENABLE_FAST_INTERP_CACHE != 0
+bool
+bh_cache_file_write(const char *file_path, const BHCacheFileChunk *chunks,
+                    uint32 chunk_count)
+{
+    char temp_path[1024 + 40];
+    FILE *fp;
+    uint32 i;
+    int len;
+    bool ret = true;
+
+    len = snprintf(temp_path, sizeof(temp_path), "%s.%llx-%llx.tmp",
+                   file_path, (unsigned long long)os_time_get_boot_us(),
+                   (unsigned long long)(uintptr_t)os_self_thread());
+    if (len < 0 || (size_t)len >= sizeof(temp_path))
+        return false;
+
+    if (!(fp = fopen(temp_path, "wb")))
+        return false;
+
+    for (i = 0; i < chunk_count && ret; i++) {
+        if (chunks[i].size > 0)
+            ret = fwrite(chunks[i].data, 1, (size_t)chunks[i].size, fp)
+                  == (size_t)chunks[i].size;
+    }
+    ret = (fclose(fp) == 0) && ret;
+
+    if (!ret || rename(temp_path, file_path) != 0) {
+        (void)unlink(temp_path);
+        return false;
+    }
+    return true;
+}
+#endif
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#ifndef _BH_CODE_CACHE_H
+#define _BH_CODE_CACHE_H
+
+#include "bh_platform.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Helpers shared by the code caches saved to the file system: the cache
+   files are keyed and checked with SHA-256 digests, as a cache hit skips
+   the compilation and part of the validation of the module */
+
+#define BH_SHA256_DIGEST_SIZE 32
+
+/* Size of the hex string of a digest, including the terminating zero */
+#define BH_SHA256_HEX_SIZE (BH_SHA256_DIGEST_SIZE * 2 + 1)
+
+typedef struct BHSha256Context {
+    uint32 state[8];
+    uint64 total_size;
+    uint8 block[64];
+    uint32 block_size;
+} BHSha256Context;
+
+void
+bh_sha256_init(BHSha256Context *ctx);
+
+void
+bh_sha256_update(BHSha256Context *ctx, const void *data, size_t size);
+
+/**
+ * Add a string to the digest, including the terminating zero to separate
+ * the adjacent strings, NULL is taken as the empty string
+ */
+void
+bh_sha256_update_str(BHSha256Context *ctx, const char *str);
+
+void
+bh_sha256_final(BHSha256Context *ctx, uint8 *digest);
+
+void
+bh_sha256(const void *data, size_t size, uint8 *digest);
+
+/**
+ * Convert the digest to a lower case hex string of BH_SHA256_HEX_SIZE bytes
+ */
+void
+bh_sha256_to_hex(const uint8 *digest, char *buf);
+
+#if WASM_ENABLE_JIT != 0 || WASM_ENABLE_WAMR_COMPILER != 0 \
+    || WASM_ENABLE_FAST_INTERP_CACHE != 0
+typedef struct BHCacheFileChunk {
+    const void *data;
+    uint64 size;
+} BHCacheFileChunk;
+
+/**
+ * Write the chunks to the cache file, they are written to a temporary
+ * file which is then renamed, so that other processes never see a
+ * partially written cache file
+ *
+ * @param file_path the path of the cache file
+ * @param chunks the chunks to write one after another
+ * @param chunk_count the number of the chunks
+ *
+ * @return true if success, false otherwise
+ */
+bool
+bh_cache_file_write(const char *file_path, const BHCacheFileChunk *chunks,
+                    uint32 chunk_count);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of _BH_CODE_CACHE_H */
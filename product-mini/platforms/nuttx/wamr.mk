@@ -439,6 +439,7 @@ CSRCS += nuttx_platform.c \
          bh_assert.c \
          bh_bitmap.c \
          bh_common.c \
+         bh_code_cache.c \
          bh_hashmap.c \
          bh_list.c \
          bh_leb128.c \
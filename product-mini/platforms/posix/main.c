@@ -64,6 +64,14 @@ print_help(void)
 #if WASM_ENABLE_FAST_JIT != 0
     printf("  --jit-codecache-size=n   Set fast jit maximum code cache size in bytes,\n");
     printf("                           default is %u KB\n", FAST_JIT_DEFAULT_CODE_CACHE_SIZE / 1024);
+    printf("  --fast-jit-opt-level=n   Set fast jit optimization level (0 to 2), default is %u\n",
+           FAST_JIT_DEFAULT_OPT_LEVEL);
+    printf("  --fast-jit-regalloc=name Set fast jit register allocator, name can be:\n");
+    printf("                           local (default), linear-scan\n");
+    printf("  --fast-jit-tierup-threshold=n\n");
+    printf("                           Interpret a function until it is called or loops\n");
+    printf("                           n times and then compile it with fast jit,\n");
+    printf("                           default is 0 (compile all functions)\n");
 #endif
 #if WASM_ENABLE_GC != 0
     printf("  --gc-heap-size=n         Set maximum gc heap size in bytes,\n");
@@ -72,6 +80,9 @@ print_help(void)
 #if WASM_ENABLE_JIT != 0
     printf("  --llvm-jit-size-level=n  Set LLVM JIT size level, default is 3\n");
     printf("  --llvm-jit-opt-level=n   Set LLVM JIT optimization level, default is 3\n");
+    printf("  --llvm-jit-cache-dir=<dir>\n");
+    printf("                           Save the LLVM JIT compiled code to the directory and\n");
+    printf("                           reuse it when the same module is run again\n");
 #if defined(os_writegsbase)
     printf("  --enable-segue[=<flags>] Enable using segment register GS as the base address of\n");
     printf("                           linear memory, which may improve performance, flags can be:\n");
@@ -81,11 +92,38 @@ print_help(void)
     printf("                           and --enable-segue means all flags are added.\n");
 #endif
 #endif /* WASM_ENABLE_JIT != 0 */
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    printf("  --fast-interp-cache-dir=<dir>\n");
+    printf("                           Save the fast interpreter pre-compiled code to the directory\n");
+    printf("                           and reuse it when the same module is run again\n");
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    printf("  --lazy-validation        Validate the functions when they are called the first time\n");
+    printf("                           instead of when the module is loaded\n");
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    printf("  --loader-threads=n       Set the number of threads that validate and pre-compile\n");
+    printf("                           the functions when the module is loaded, default is %d\n",
+           WASM_PARALLEL_LOADER_THREAD_NUM);
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    printf("  --stream-load            Load the module by feeding the file chunk by chunk\n");
+#endif
 #if WASM_ENABLE_LINUX_PERF != 0
     printf("  --enable-linux-perf      Enable linux perf support. It works in aot and llvm-jit.\n");
 #endif
     printf("  --repl                   Start a very simple REPL (read-eval-print-loop) mode\n"
            "                           that runs commands in the form of \"FUNC ARG...\"\n");
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    printf("  --snapshot-out=<file>    Save the state of the module instance to the file after\n"
+           "                           it is instantiated and initialized\n");
+    printf("  --snapshot-in=<file>     Restore the module instance from the snapshot file\n"
+           "                           instead of initializing it\n");
+#endif
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+    printf("  --map-aot-file           Map the AOT file into memory instead of reading it, the\n"
+           "                           unpatched code pages are shared with other processes\n");
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     printf("  --disable-bounds-checks  Disable bounds checks for memory accesses\n");
 #endif
@@ -451,6 +489,50 @@ module_destroyer_callback(uint8 *buffer, uint32 size)
 }
 #endif /* WASM_ENABLE_MULTI_MODULE */
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+/* Load the module from the file chunk by chunk, like the way it is
+   loaded when being received from the network */
+static wasm_module_t
+load_module_from_stream(const char *file_name, const LoadArgs *load_args,
+                        char *error_buf, uint32 error_buf_size)
+{
+    static uint8 chunk[64 * 1024];
+    wasm_module_stream_t stream;
+    FILE *file;
+    size_t size;
+
+    if (!(file = fopen(file_name, "rb"))) {
+        snprintf(error_buf, error_buf_size, "open file %s failed", file_name);
+        return NULL;
+    }
+
+    if (!(stream = wasm_runtime_stream_load_begin(load_args, error_buf,
+                                                  error_buf_size))) {
+        fclose(file);
+        return NULL;
+    }
+
+    while ((size = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        if (!wasm_runtime_stream_load_feed(stream, chunk, (uint32)size,
+                                           error_buf, error_buf_size))
+            goto fail;
+    }
+
+    if (ferror(file)) {
+        snprintf(error_buf, error_buf_size, "read file %s failed", file_name);
+        goto fail;
+    }
+
+    fclose(file);
+    return wasm_runtime_stream_load_finish(stream, error_buf, error_buf_size);
+
+fail:
+    wasm_runtime_stream_load_abort(stream);
+    fclose(file);
+    return NULL;
+}
+#endif
+
 #if WASM_ENABLE_GLOBAL_HEAP_POOL != 0
 static char global_heap_buf[WASM_GLOBAL_HEAP_SIZE] = { 0 };
 #else
@@ -589,6 +671,9 @@ main(int argc, char *argv[])
 #endif
 #if WASM_ENABLE_FAST_JIT != 0
     uint32 jit_code_cache_size = FAST_JIT_DEFAULT_CODE_CACHE_SIZE;
+    uint32 fast_jit_opt_level = FAST_JIT_DEFAULT_OPT_LEVEL;
+    uint32 fast_jit_regalloc = 0;
+    uint32 fast_jit_tierup_threshold = 0;
 #endif
 #if WASM_ENABLE_GC != 0
     uint32 gc_heap_size = GC_HEAP_SIZE_DEFAULT;
@@ -596,8 +681,12 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_JIT != 0
     uint32 llvm_jit_size_level = 3;
     uint32 llvm_jit_opt_level = 3;
+    const char *llvm_jit_cache_dir = NULL;
     uint32 segue_flags = 0;
 #endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    const char *fast_interp_cache_dir = NULL;
+#endif
 #if WASM_ENABLE_LINUX_PERF != 0
     bool enable_linux_perf = false;
 #endif
@@ -611,7 +700,22 @@ main(int argc, char *argv[])
     int log_verbose_level = 2;
 #endif
     bool is_repl_mode = false;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    const char *snapshot_out = NULL, *snapshot_in = NULL;
+#endif
     bool is_xip_file = false;
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+    bool map_aot_file = false;
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    bool lazy_validation = false;
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    uint32 loader_thread_num = 0;
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    bool stream_load = false;
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = false;
 #endif
@@ -679,6 +783,23 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--repl")) {
             is_repl_mode = true;
         }
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        else if (!strncmp(argv[0], "--snapshot-out=", 15)) {
+            if (argv[0][15] == '\0')
+                return print_help();
+            snapshot_out = argv[0] + 15;
+        }
+        else if (!strncmp(argv[0], "--snapshot-in=", 14)) {
+            if (argv[0][14] == '\0')
+                return print_help();
+            snapshot_in = argv[0] + 14;
+        }
+#endif
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+        else if (!strcmp(argv[0], "--map-aot-file")) {
+            map_aot_file = true;
+        }
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
         else if (!strcmp(argv[0], "--disable-bounds-checks")) {
             disable_bounds_checks = true;
@@ -707,6 +828,29 @@ main(int argc, char *argv[])
                 return print_help();
             jit_code_cache_size = atoi(argv[0] + 21);
         }
+        else if (!strncmp(argv[0], "--fast-jit-opt-level=", 21)) {
+            if (argv[0][21] == '\0')
+                return print_help();
+            fast_jit_opt_level = atoi(argv[0] + 21);
+            if (fast_jit_opt_level > 2) {
+                printf("Fast JIT opt level shouldn't be greater than 2, "
+                       "setting it to 2\n");
+                fast_jit_opt_level = 2;
+            }
+        }
+        else if (!strncmp(argv[0], "--fast-jit-regalloc=", 20)) {
+            if (!strcmp(argv[0] + 20, "local"))
+                fast_jit_regalloc = 0;
+            else if (!strcmp(argv[0] + 20, "linear-scan"))
+                fast_jit_regalloc = 1;
+            else
+                return print_help();
+        }
+        else if (!strncmp(argv[0], "--fast-jit-tierup-threshold=", 28)) {
+            if (argv[0][28] == '\0')
+                return print_help();
+            fast_jit_tierup_threshold = atoi(argv[0] + 28);
+        }
 #endif
 #if WASM_ENABLE_GC != 0
         else if (!strncmp(argv[0], "--gc-heap-size=", 15)) {
@@ -746,6 +890,11 @@ main(int argc, char *argv[])
                 llvm_jit_opt_level = 3;
             }
         }
+        else if (!strncmp(argv[0], "--llvm-jit-cache-dir=", 21)) {
+            if (argv[0][21] == '\0')
+                return print_help();
+            llvm_jit_cache_dir = argv[0] + 21;
+        }
         else if (!strcmp(argv[0], "--enable-segue")) {
             /* all flags are enabled */
             segue_flags = 0x1F1F;
@@ -768,6 +917,30 @@ main(int argc, char *argv[])
             native_lib_list[native_lib_count++] = argv[0] + 13;
         }
 #endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+        else if (!strncmp(argv[0], "--fast-interp-cache-dir=", 24)) {
+            if (argv[0][24] == '\0')
+                return print_help();
+            fast_interp_cache_dir = argv[0] + 24;
+        }
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        else if (!strcmp(argv[0], "--lazy-validation")) {
+            lazy_validation = true;
+        }
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+        else if (!strncmp(argv[0], "--loader-threads=", 17)) {
+            if (argv[0][17] == '\0')
+                return print_help();
+            loader_thread_num = atoi(argv[0] + 17);
+        }
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+        else if (!strcmp(argv[0], "--stream-load")) {
+            stream_load = true;
+        }
+#endif
 #if WASM_ENABLE_LINUX_PERF != 0
         else if (!strncmp(argv[0], "--enable-linux-perf", 19)) {
             enable_linux_perf = true;
@@ -870,6 +1043,9 @@ main(int argc, char *argv[])
 
 #if WASM_ENABLE_FAST_JIT != 0
     init_args.fast_jit_code_cache_size = jit_code_cache_size;
+    init_args.fast_jit_opt_level = fast_jit_opt_level;
+    init_args.fast_jit_regalloc = fast_jit_regalloc;
+    init_args.fast_jit_tierup_threshold = fast_jit_tierup_threshold;
 #endif
 
 #if WASM_ENABLE_GC != 0
@@ -879,8 +1055,15 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_JIT != 0
     init_args.llvm_jit_size_level = llvm_jit_size_level;
     init_args.llvm_jit_opt_level = llvm_jit_opt_level;
+    init_args.llvm_jit_cache_dir = llvm_jit_cache_dir;
     init_args.segue_flags = segue_flags;
 #endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    init_args.fast_interp_cache_dir = fast_interp_cache_dir;
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    init_args.loader_thread_num = loader_thread_num;
+#endif
 #if WASM_ENABLE_LINUX_PERF != 0
     init_args.enable_linux_perf = enable_linux_perf;
 #endif
@@ -907,39 +1090,50 @@ main(int argc, char *argv[])
         native_lib_list, native_lib_count, native_lib_loaded_list);
 #endif
 
-    /* load WASM byte buffer from WASM bin file */
-    if (!(wasm_file_buf =
-              (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
-        goto fail1;
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+    /* The AOT file is mapped by the runtime when loading the module */
+    if (!map_aot_file)
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    /* The file is read chunk by chunk when loading the module */
+    if (!stream_load)
+#endif
+    {
+        /* load WASM byte buffer from WASM bin file */
+        if (!(wasm_file_buf =
+                  (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
+            goto fail1;
 
 #if WASM_ENABLE_AOT != 0
-    if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
-        uint8 *wasm_file_mapped;
-        uint8 *daddr;
-        int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
-        int map_flags = MMAP_MAP_32BIT;
-
-        if (!(wasm_file_mapped = os_mmap(NULL, (uint32)wasm_file_size, map_prot,
-                                         map_flags, os_get_invalid_handle()))) {
-            printf("mmap memory failed\n");
-            wasm_runtime_free(wasm_file_buf);
-            goto fail1;
-        }
+        if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
+            uint8 *wasm_file_mapped;
+            uint8 *daddr;
+            int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
+            int map_flags = MMAP_MAP_32BIT;
+
+            if (!(wasm_file_mapped =
+                      os_mmap(NULL, (uint32)wasm_file_size, map_prot,
+                              map_flags, os_get_invalid_handle()))) {
+                printf("mmap memory failed\n");
+                wasm_runtime_free(wasm_file_buf);
+                goto fail1;
+            }
 
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
-        daddr = os_get_dbus_mirror(wasm_file_mapped);
+            daddr = os_get_dbus_mirror(wasm_file_mapped);
 #else
-        daddr = wasm_file_mapped;
+            daddr = wasm_file_mapped;
 #endif
-        bh_memcpy_s(daddr, wasm_file_size, wasm_file_buf, wasm_file_size);
+            bh_memcpy_s(daddr, wasm_file_size, wasm_file_buf, wasm_file_size);
 #if (WASM_MEM_DUAL_BUS_MIRROR != 0)
-        os_dcache_flush();
+            os_dcache_flush();
 #endif
-        wasm_runtime_free(wasm_file_buf);
-        wasm_file_buf = wasm_file_mapped;
-        is_xip_file = true;
-    }
+            wasm_runtime_free(wasm_file_buf);
+            wasm_file_buf = wasm_file_mapped;
+            is_xip_file = true;
+        }
 #endif
+    }
 
 #if WASM_ENABLE_MULTI_MODULE != 0
     wasm_runtime_set_module_reader(module_reader_callback,
@@ -947,8 +1141,44 @@ main(int argc, char *argv[])
 #endif
 
     /* load WASM module */
-    if (!(wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
-                                          error_buf, sizeof(error_buf)))) {
+#if WASM_ENABLE_AOT != 0 && defined(OS_ENABLE_FILE_MAPPING)
+    if (map_aot_file) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+        wasm_module = wasm_runtime_load_from_mapped_file(
+            wasm_file, &load_args, error_buf, sizeof(error_buf));
+    }
+    else
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    if (stream_load) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        load_args.lazy_validation = lazy_validation;
+#endif
+        wasm_module = load_module_from_stream(wasm_file, &load_args, error_buf,
+                                              sizeof(error_buf));
+    }
+    else
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (lazy_validation) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+        load_args.lazy_validation = true;
+        wasm_module = wasm_runtime_load_ex(wasm_file_buf, wasm_file_size,
+                                           &load_args, error_buf,
+                                           sizeof(error_buf));
+    }
+    else
+#endif
+        wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
+                                        error_buf, sizeof(error_buf));
+    if (!wasm_module) {
         printf("%s\n", error_buf);
         goto fail2;
     }
@@ -975,14 +1205,29 @@ main(int argc, char *argv[])
 #endif
 
     /* instantiate the module */
-    wasm_module_inst = wasm_runtime_instantiate_ex2(
-        wasm_module, inst_args, error_buf, sizeof(error_buf));
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (snapshot_in)
+        wasm_module_inst = wasm_runtime_instantiate_from_snapshot(
+            wasm_module, inst_args, snapshot_in, error_buf, sizeof(error_buf));
+    else
+#endif
+        wasm_module_inst = wasm_runtime_instantiate_ex2(
+            wasm_module, inst_args, error_buf, sizeof(error_buf));
     wasm_runtime_instantiation_args_destroy(inst_args);
     if (!wasm_module_inst) {
         printf("%s\n", error_buf);
         goto fail3;
     }
 
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (snapshot_out
+        && !wasm_runtime_snapshot_instance(wasm_module_inst, snapshot_out,
+                                           error_buf, sizeof(error_buf))) {
+        printf("%s\n", error_buf);
+        goto fail4;
+    }
+#endif
+
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     if (disable_bounds_checks) {
         wasm_runtime_set_bounds_checks(wasm_module_inst, false);
@@ -1090,7 +1335,7 @@ fail6:
 #if WASM_ENABLE_THREAD_MGR != 0
 fail5:
 #endif
-#if WASM_ENABLE_DEBUG_INTERP != 0
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_INSTANCE_SNAPSHOT != 0
 fail4:
 #endif
     /* destroy the module instance */
@@ -1101,10 +1346,11 @@ fail3:
     wasm_runtime_unload(wasm_module);
 
 fail2:
-    /* free the file buffer */
-    if (!is_xip_file)
+    /* free the file buffer, which isn't read if the AOT file is mapped
+       by the runtime */
+    if (wasm_file_buf && !is_xip_file)
         wasm_runtime_free(wasm_file_buf);
-    else
+    else if (wasm_file_buf)
         os_munmap(wasm_file_buf, wasm_file_size);
 
 fail1:
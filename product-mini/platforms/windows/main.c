@@ -64,9 +64,35 @@ print_help(void)
 #if WASM_ENABLE_JIT != 0
     printf("  --llvm-jit-size-level=n  Set LLVM JIT size level, default is 3\n");
     printf("  --llvm-jit-opt-level=n   Set LLVM JIT optimization level, default is 3\n");
+    printf("  --llvm-jit-cache-dir=<dir>\n");
+    printf("                           Save the LLVM JIT compiled code to the directory and\n");
+    printf("                           reuse it when the same module is run again\n");
 #endif /* WASM_ENABLE_JIT != 0 */
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    printf("  --fast-interp-cache-dir=<dir>\n");
+    printf("                           Save the fast interpreter pre-compiled code to the directory\n");
+    printf("                           and reuse it when the same module is run again\n");
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    printf("  --lazy-validation        Validate the functions when they are called the first time\n");
+    printf("                           instead of when the module is loaded\n");
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    printf("  --loader-threads=n       Set the number of threads that validate and pre-compile\n");
+    printf("                           the functions when the module is loaded, default is %d\n",
+           WASM_PARALLEL_LOADER_THREAD_NUM);
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    printf("  --stream-load            Load the module by feeding the file chunk by chunk\n");
+#endif
     printf("  --repl                   Start a very simple REPL (read-eval-print-loop) mode\n"
            "                           that runs commands in the form of `FUNC ARG...`\n");
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    printf("  --snapshot-out=<file>    Save the state of the module instance to the file after\n"
+           "                           it is instantiated and initialized\n");
+    printf("  --snapshot-in=<file>     Restore the module instance from the snapshot file\n"
+           "                           instead of initializing it\n");
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     printf("  --disable-bounds-checks  Disable bounds checks for memory accesses\n");
 #endif
@@ -286,6 +312,50 @@ module_destroyer_callback(uint8 *buffer, uint32 size)
 }
 #endif /* WASM_ENABLE_MULTI_MODULE */
 
+#if WASM_ENABLE_STREAM_LOADER != 0
+/* Load the module from the file chunk by chunk, like the way it is
+   loaded when being received from the network */
+static wasm_module_t
+load_module_from_stream(const char *file_name, const LoadArgs *load_args,
+                        char *error_buf, uint32 error_buf_size)
+{
+    static uint8 chunk[64 * 1024];
+    wasm_module_stream_t stream;
+    FILE *file;
+    size_t size;
+
+    if (!(file = fopen(file_name, "rb"))) {
+        snprintf(error_buf, error_buf_size, "open file %s failed", file_name);
+        return NULL;
+    }
+
+    if (!(stream = wasm_runtime_stream_load_begin(load_args, error_buf,
+                                                  error_buf_size))) {
+        fclose(file);
+        return NULL;
+    }
+
+    while ((size = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        if (!wasm_runtime_stream_load_feed(stream, chunk, (uint32)size,
+                                           error_buf, error_buf_size))
+            goto fail;
+    }
+
+    if (ferror(file)) {
+        snprintf(error_buf, error_buf_size, "read file %s failed", file_name);
+        goto fail;
+    }
+
+    fclose(file);
+    return wasm_runtime_stream_load_finish(stream, error_buf, error_buf_size);
+
+fail:
+    wasm_runtime_stream_load_abort(stream);
+    fclose(file);
+    return NULL;
+}
+#endif
+
 int
 main(int argc, char *argv[])
 {
@@ -314,6 +384,19 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_JIT != 0
     uint32 llvm_jit_size_level = 3;
     uint32 llvm_jit_opt_level = 3;
+    const char *llvm_jit_cache_dir = NULL;
+#endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    const char *fast_interp_cache_dir = NULL;
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    bool lazy_validation = false;
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    uint32 loader_thread_num = 0;
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+    bool stream_load = false;
 #endif
     wasm_module_t wasm_module = NULL;
     wasm_module_inst_t wasm_module_inst = NULL;
@@ -325,6 +408,9 @@ main(int argc, char *argv[])
     int log_verbose_level = 2;
 #endif
     bool is_repl_mode = false;
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    const char *snapshot_out = NULL, *snapshot_in = NULL;
+#endif
     bool is_xip_file = false;
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     bool disable_bounds_checks = false;
@@ -380,6 +466,18 @@ main(int argc, char *argv[])
         else if (!strcmp(argv[0], "--repl")) {
             is_repl_mode = true;
         }
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+        else if (!strncmp(argv[0], "--snapshot-out=", 15)) {
+            if (argv[0][15] == '\0')
+                return print_help();
+            snapshot_out = argv[0] + 15;
+        }
+        else if (!strncmp(argv[0], "--snapshot-in=", 14)) {
+            if (argv[0][14] == '\0')
+                return print_help();
+            snapshot_in = argv[0] + 14;
+        }
+#endif
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
         else if (!strcmp(argv[0], "--disable-bounds-checks")) {
             disable_bounds_checks = true;
@@ -447,6 +545,35 @@ main(int argc, char *argv[])
                 llvm_jit_opt_level = 3;
             }
         }
+        else if (!strncmp(argv[0], "--llvm-jit-cache-dir=", 21)) {
+            if (argv[0][21] == '\0')
+                return print_help();
+            llvm_jit_cache_dir = argv[0] + 21;
+        }
+#endif
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+        else if (!strncmp(argv[0], "--fast-interp-cache-dir=", 24)) {
+            if (argv[0][24] == '\0')
+                return print_help();
+            fast_interp_cache_dir = argv[0] + 24;
+        }
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        else if (!strcmp(argv[0], "--lazy-validation")) {
+            lazy_validation = true;
+        }
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+        else if (!strncmp(argv[0], "--loader-threads=", 17)) {
+            if (argv[0][17] == '\0')
+                return print_help();
+            loader_thread_num = atoi(argv[0] + 17);
+        }
+#endif
+#if WASM_ENABLE_STREAM_LOADER != 0
+        else if (!strcmp(argv[0], "--stream-load")) {
+            stream_load = true;
+        }
 #endif
 #if WASM_ENABLE_MULTI_MODULE != 0
         else if (!strncmp(argv[0],
@@ -540,6 +667,14 @@ main(int argc, char *argv[])
 #if WASM_ENABLE_JIT != 0
     init_args.llvm_jit_size_level = llvm_jit_size_level;
     init_args.llvm_jit_opt_level = llvm_jit_opt_level;
+    init_args.llvm_jit_cache_dir = llvm_jit_cache_dir;
+#endif
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+    init_args.fast_interp_cache_dir = fast_interp_cache_dir;
+#endif
+#if WASM_ENABLE_PARALLEL_LOADER != 0
+    init_args.loader_thread_num = loader_thread_num;
 #endif
 
 #if WASM_ENABLE_DEBUG_INTERP != 0
@@ -560,31 +695,38 @@ main(int argc, char *argv[])
     bh_log_set_verbose_level(log_verbose_level);
 #endif
 
-    /* load WASM byte buffer from WASM bin file */
-    if (!(wasm_file_buf =
-              (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
-        goto fail1;
+#if WASM_ENABLE_STREAM_LOADER != 0
+    /* The file is read chunk by chunk when loading the module */
+    if (!stream_load)
+#endif
+    {
+        /* load WASM byte buffer from WASM bin file */
+        if (!(wasm_file_buf =
+                  (uint8 *)bh_read_file_to_buffer(wasm_file, &wasm_file_size)))
+            goto fail1;
 
 #if WASM_ENABLE_AOT != 0
-    if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
-        uint8 *wasm_file_mapped;
-        int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
-        int map_flags = MMAP_MAP_32BIT;
-
-        if (!(wasm_file_mapped = os_mmap(NULL, (uint32)wasm_file_size, map_prot,
-                                         map_flags, os_get_invalid_handle()))) {
-            printf("mmap memory failed\n");
+        if (wasm_runtime_is_xip_file(wasm_file_buf, wasm_file_size)) {
+            uint8 *wasm_file_mapped;
+            int map_prot = MMAP_PROT_READ | MMAP_PROT_WRITE | MMAP_PROT_EXEC;
+            int map_flags = MMAP_MAP_32BIT;
+
+            if (!(wasm_file_mapped =
+                      os_mmap(NULL, (uint32)wasm_file_size, map_prot,
+                              map_flags, os_get_invalid_handle()))) {
+                printf("mmap memory failed\n");
+                wasm_runtime_free(wasm_file_buf);
+                goto fail1;
+            }
+
+            bh_memcpy_s(wasm_file_mapped, wasm_file_size, wasm_file_buf,
+                        wasm_file_size);
             wasm_runtime_free(wasm_file_buf);
-            goto fail1;
+            wasm_file_buf = wasm_file_mapped;
+            is_xip_file = true;
         }
-
-        bh_memcpy_s(wasm_file_mapped, wasm_file_size, wasm_file_buf,
-                    wasm_file_size);
-        wasm_runtime_free(wasm_file_buf);
-        wasm_file_buf = wasm_file_mapped;
-        is_xip_file = true;
-    }
 #endif
+    }
 
 #if WASM_ENABLE_MULTI_MODULE != 0
     wasm_runtime_set_module_reader(module_reader_callback,
@@ -592,8 +734,34 @@ main(int argc, char *argv[])
 #endif
 
     /* load WASM module */
-    if (!(wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
-                                          error_buf, sizeof(error_buf)))) {
+#if WASM_ENABLE_STREAM_LOADER != 0
+    if (stream_load) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+        load_args.lazy_validation = lazy_validation;
+#endif
+        wasm_module = load_module_from_stream(wasm_file, &load_args, error_buf,
+                                              sizeof(error_buf));
+    }
+    else
+#endif
+#if WASM_ENABLE_LAZY_VALIDATION != 0
+    if (lazy_validation) {
+        LoadArgs load_args = { 0 };
+
+        load_args.name = "";
+        load_args.lazy_validation = true;
+        wasm_module = wasm_runtime_load_ex(wasm_file_buf, wasm_file_size,
+                                           &load_args, error_buf,
+                                           sizeof(error_buf));
+    }
+    else
+#endif
+        wasm_module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
+                                        error_buf, sizeof(error_buf));
+    if (!wasm_module) {
         printf("%s\n", error_buf);
         goto fail2;
     }
@@ -611,14 +779,29 @@ main(int argc, char *argv[])
 #endif
 
     /* instantiate the module */
-    wasm_module_inst = wasm_runtime_instantiate_ex2(
-        wasm_module, inst_args, error_buf, sizeof(error_buf));
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (snapshot_in)
+        wasm_module_inst = wasm_runtime_instantiate_from_snapshot(
+            wasm_module, inst_args, snapshot_in, error_buf, sizeof(error_buf));
+    else
+#endif
+        wasm_module_inst = wasm_runtime_instantiate_ex2(
+            wasm_module, inst_args, error_buf, sizeof(error_buf));
     wasm_runtime_instantiation_args_destroy(inst_args);
     if (!wasm_module_inst) {
         printf("%s\n", error_buf);
         goto fail3;
     }
 
+#if WASM_ENABLE_INSTANCE_SNAPSHOT != 0
+    if (snapshot_out
+        && !wasm_runtime_snapshot_instance(wasm_module_inst, snapshot_out,
+                                           error_buf, sizeof(error_buf))) {
+        printf("%s\n", error_buf);
+        goto fail4;
+    }
+#endif
+
 #if WASM_CONFIGURABLE_BOUNDS_CHECKS != 0
     if (disable_bounds_checks) {
         wasm_runtime_set_bounds_checks(wasm_module_inst, false);
@@ -697,7 +880,7 @@ fail6:
 
     /* fail5: label is used by posix/main.c */
 
-#if WASM_ENABLE_DEBUG_INTERP != 0
+#if WASM_ENABLE_DEBUG_INTERP != 0 || WASM_ENABLE_INSTANCE_SNAPSHOT != 0
 fail4:
 #endif
     /* destroy the module instance */
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdlib.h>
+
+#include "wasm_export.h"
+#include "wasm_runtime_common.h"
+#include "ems/ems_gc.h"
+#include "bh_read_file.h"
+#include "bh_getopt.h"
+
+/* The allocated size of a tree node, i.e. a struct with two refs and an
+   i32, including the hmu header */
+#define TREE_NODE_SIZE 32
+
+/* The tree fills this percent of the GC heap */
+#define TREE_HEAP_PERCENT 40
+
+static void
+print_usage(void)
+{
+    fprintf(stdout, "Options:\r\n");
+    fprintf(stdout, "  -f [path of tree.wasm, default ./tree.wasm] \n");
+    fprintf(stdout, "  -m [size of the GC heap in MB, default 64] \n");
+    fprintf(stdout, "  -r [number of collections per helper number, "
+                    "default 3] \n");
+}
+
+static bool
+call_func(wasm_exec_env_t exec_env, wasm_module_inst_t module_inst,
+          const char *name, uint32_t argc, uint32_t argv[])
+{
+    wasm_function_inst_t func =
+        wasm_runtime_lookup_function(module_inst, name);
+
+    if (!func || !wasm_runtime_call_wasm(exec_env, func, argc, argv)) {
+        printf("call %s failed: %s\n", name,
+               func ? wasm_runtime_get_exception(module_inst)
+                    : "function not found");
+        return false;
+    }
+    return true;
+}
+
+static uint32_t
+get_tree_sum(uint32_t depth)
+{
+    uint32_t sum = 0, d;
+
+    /* there are 2^(depth - d) nodes of depth d */
+    for (d = 1; d <= depth; d++)
+        sum += d << (depth - d);
+    return sum;
+}
+
+int
+main(int argc, char *argv_main[])
+{
+    static const uint32_t helper_nums[] = { 0, 1, 3, 7 };
+    char *buffer = NULL, error_buf[128];
+    char *wasm_path = "tree.wasm";
+    int opt, heap_size_mb = 64, round_num = 3, i, j, exit_code = 1;
+    uint32_t buf_size, gc_heap_size, depth = 0, argv[1];
+    uint64_t node_num, start_time, time, total_time, max_time;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env;
+    RuntimeInitArgs init_args;
+    void *heap;
+
+    while ((opt = getopt(argc, argv_main, "hf:m:r:")) != -1) {
+        switch (opt) {
+            case 'f':
+                wasm_path = optarg;
+                break;
+            case 'm':
+                heap_size_mb = atoi(optarg);
+                break;
+            case 'r':
+                round_num = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                print_usage();
+                return 0;
+        }
+    }
+    if (heap_size_mb <= 0 || heap_size_mb > 2048 || round_num <= 0) {
+        print_usage();
+        return 1;
+    }
+
+    gc_heap_size = (uint32_t)heap_size_mb * 1024 * 1024;
+    node_num =
+        (uint64_t)gc_heap_size * TREE_HEAP_PERCENT / 100 / TREE_NODE_SIZE;
+    while ((2ULL << depth) - 1 <= node_num)
+        depth++;
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.gc_heap_size = gc_heap_size;
+
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("Init runtime environment failed.\n");
+        return 1;
+    }
+
+    buffer = bh_read_file_to_buffer(wasm_path, &buf_size);
+    if (!buffer) {
+        printf("Open wasm app file [%s] failed.\n", wasm_path);
+        goto fail;
+    }
+
+    module = wasm_runtime_load((uint8_t *)buffer, buf_size, error_buf,
+                               sizeof(error_buf));
+    if (!module) {
+        printf("Load wasm module failed. error: %s\n", error_buf);
+        goto fail;
+    }
+
+    module_inst = wasm_runtime_instantiate(module, 64 * 1024, 0, error_buf,
+                                           sizeof(error_buf));
+    if (!module_inst) {
+        printf("Instantiate wasm module failed. error: %s\n", error_buf);
+        goto fail;
+    }
+
+    exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+    if (!exec_env) {
+        printf("Create exec env failed.\n");
+        goto fail;
+    }
+
+    argv[0] = depth;
+    if (!call_func(exec_env, module_inst, "build_tree", 1, argv))
+        goto fail;
+
+    heap = wasm_runtime_get_gc_heap_handle(module_inst);
+
+    for (i = 0; i < (int)(sizeof(helper_nums) / sizeof(uint32_t)); i++) {
+        gc_set_mark_helper_num(heap, helper_nums[i]);
+
+        total_time = max_time = 0;
+        for (j = 0; j < round_num; j++) {
+            start_time = os_time_get_boot_us();
+            if (gci_gc_heap(heap) != GC_SUCCESS) {
+                printf("collect the GC heap failed.\n");
+                goto fail;
+            }
+            time = os_time_get_boot_us() - start_time;
+
+            total_time += time;
+            if (time > max_time)
+                max_time = time;
+        }
+
+        printf("gc heap %4d MB, %8" PRIu64 " objects, %" PRIu32
+               " mark helpers: avg pause %8" PRIu64 " us, max pause %8" PRIu64
+               " us\n",
+               heap_size_mb, (uint64_t)(2ULL << (depth - 1)) - 1,
+               helper_nums[i], total_time / round_num, max_time);
+
+        /* all nodes must be kept alive */
+        if (!call_func(exec_env, module_inst, "sum_tree", 0, argv))
+            goto fail;
+        if (argv[0] != get_tree_sum(depth)) {
+            printf("the tree is corrupted after collection.\n");
+            goto fail;
+        }
+    }
+
+    exit_code = 0;
+fail:
+    if (module_inst)
+        wasm_runtime_deinstantiate(module_inst);
+    if (module)
+        wasm_runtime_unload(module);
+    if (buffer)
+        BH_FREE(buffer);
+    wasm_runtime_destroy();
+    return exit_code;
+}
@@ -0,0 +1,55 @@
+(module
+  (type $node (struct (field (ref null $node)) (field (ref null $node)) (field i32)))
+
+  (global $root (mut (ref null $node)) (ref.null $node))
+
+  ;; build a complete binary tree, the value of a node is its depth
+  (func $build (param $depth i32) (result (ref null $node))
+    local.get $depth
+    i32.eqz
+    if (result (ref null $node))
+      ref.null $node
+    else
+      local.get $depth
+      i32.const 1
+      i32.sub
+      call $build
+      local.get $depth
+      i32.const 1
+      i32.sub
+      call $build
+      local.get $depth
+      struct.new $node
+    end
+  )
+
+  (func $sum (param $n (ref null $node)) (result i32)
+    local.get $n
+    ref.is_null
+    if (result i32)
+      i32.const 0
+    else
+      local.get $n
+      struct.get $node 2
+      local.get $n
+      struct.get $node 0
+      call $sum
+      i32.add
+      local.get $n
+      struct.get $node 1
+      call $sum
+      i32.add
+    end
+  )
+
+  (func (export "build_tree") (param $depth i32)
+    local.get $depth
+    call $build
+    global.set $root
+  )
+
+  (func (export "sum_tree") (result i32)
+    global.get $root
+    call $sum
+  )
+)
@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "wasm_export.h"
+#include "bh_read_file.h"
+#include "bh_getopt.h"
+
+#define MAX_THREAD_NUM 256
+
+typedef struct ThreadArgs {
+    wasm_module_t module;
+    uint64_t end_time_us;
+    uint64_t count;
+    bool failed;
+} ThreadArgs;
+
+static uint64_t
+time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void
+print_usage(void)
+{
+    fprintf(stdout, "Options:\r\n");
+    fprintf(stdout, "  -f [path of wasm or aot file] \n");
+    fprintf(stdout, "  -t [number of threads, default 1] \n");
+    fprintf(stdout, "  -d [duration in seconds, default 5] \n");
+    fprintf(stdout, "  -p [slot count of linear memory pool, default 0] \n");
+}
+
+static void *
+thread(void *arg)
+{
+    ThreadArgs *thread_arg = (ThreadArgs *)arg;
+    wasm_module_inst_t module_inst;
+    char error_buf[128];
+
+    if (!wasm_runtime_init_thread_env()) {
+        printf("failed to initialize thread environment\n");
+        thread_arg->failed = true;
+        return NULL;
+    }
+
+    while (time_us() < thread_arg->end_time_us) {
+        module_inst = wasm_runtime_instantiate(thread_arg->module, 16 * 1024,
+                                               0, error_buf, sizeof(error_buf));
+        if (!module_inst) {
+            printf("Instantiate wasm module failed. error: %s\n", error_buf);
+            thread_arg->failed = true;
+            break;
+        }
+        wasm_runtime_deinstantiate(module_inst);
+        thread_arg->count++;
+    }
+
+    wasm_runtime_destroy_thread_env();
+    return NULL;
+}
+
+int
+main(int argc, char *argv_main[])
+{
+    static ThreadArgs thread_args[MAX_THREAD_NUM];
+    pthread_t tids[MAX_THREAD_NUM];
+    char *buffer = NULL, error_buf[128];
+    char *wasm_path = NULL;
+    int opt, thread_num = 1, duration = 5, slot_count = 0, i;
+    int created = 0, exit_code = 1;
+    uint64_t start_time, elapsed_us, total = 0;
+    uint32_t buf_size;
+    wasm_module_t module = NULL;
+    RuntimeInitArgs init_args;
+
+    while ((opt = getopt(argc, argv_main, "hf:t:d:p:")) != -1) {
+        switch (opt) {
+            case 'f':
+                wasm_path = optarg;
+                break;
+            case 't':
+                thread_num = atoi(optarg);
+                break;
+            case 'd':
+                duration = atoi(optarg);
+                break;
+            case 'p':
+                slot_count = atoi(optarg);
+                break;
+            case 'h':
+            default:
+                print_usage();
+                return 0;
+        }
+    }
+    if (!wasm_path || thread_num <= 0 || thread_num > MAX_THREAD_NUM
+        || duration <= 0 || slot_count < 0) {
+        print_usage();
+        return 1;
+    }
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.linear_memory_pool_slot_count = (uint32_t)slot_count;
+
+    if (!wasm_runtime_full_init(&init_args)) {
+        printf("Init runtime environment failed.\n");
+        return 1;
+    }
+
+    buffer = bh_read_file_to_buffer(wasm_path, &buf_size);
+    if (!buffer) {
+        printf("Open wasm app file [%s] failed.\n", wasm_path);
+        goto fail;
+    }
+
+    module = wasm_runtime_load((uint8_t *)buffer, buf_size, error_buf,
+                               sizeof(error_buf));
+    if (!module) {
+        printf("Load wasm module failed. error: %s\n", error_buf);
+        goto fail;
+    }
+
+    start_time = time_us();
+    for (i = 0; i < thread_num; i++) {
+        thread_args[i].module = module;
+        thread_args[i].end_time_us = start_time + (uint64_t)duration * 1000000;
+        if (pthread_create(&tids[i], NULL, thread, &thread_args[i]) != 0) {
+            printf("failed to create thread.\n");
+            break;
+        }
+        created++;
+    }
+
+    for (i = 0; i < created; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    elapsed_us = time_us() - start_time;
+
+    if (created < thread_num)
+        goto fail;
+
+    for (i = 0; i < thread_num; i++) {
+        if (thread_args[i].failed)
+            goto fail;
+        printf("thread %d: %.1f instantiations/s\n", i,
+               thread_args[i].count * 1e6 / elapsed_us);
+        total += thread_args[i].count;
+    }
+    printf("total: %" PRIu64 " instantiations with %d threads, "
+           "%.1f instantiations/s, %.2f us per instantiation\n",
+           total, thread_num, total * 1e6 / elapsed_us,
+           total ? (double)elapsed_us * thread_num / total : 0.0);
+
+    exit_code = 0;
+fail:
+    if (module)
+        wasm_runtime_unload(module);
+    if (buffer)
+        BH_FREE(buffer);
+    wasm_runtime_destroy();
+    return exit_code;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2019 Intel Corporation.  All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "mem_alloc.h"
+
+#define MAX_THREAD_NUM 256
+/* Number of blocks held by each thread at most */
+#define SLOT_NUM 256
+
+typedef struct ThreadArgs {
+    mem_allocator_t allocator;
+    uint32_t max_size;
+    uint32_t seed;
+    uint64_t end_time_us;
+    uint64_t count;
+    bool failed;
+} ThreadArgs;
+
+static uint64_t
+time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+static void
+print_usage(void)
+{
+    fprintf(stdout, "Options:\r\n");
+    fprintf(stdout, "  -t [number of threads, default 1] \n");
+    fprintf(stdout, "  -d [duration in seconds, default 5] \n");
+    fprintf(stdout, "  -s [max block size in bytes, default 256] \n");
+    fprintf(stdout, "  -m [pool size in MB, default 64] \n");
+    fprintf(stdout, "  -c enable thread caches of the allocator \n");
+}
+
+static void *
+thread(void *arg)
+{
+    ThreadArgs *thread_arg = (ThreadArgs *)arg;
+    void *slots[SLOT_NUM] = { 0 };
+    uint32_t x = thread_arg->seed, i, size;
+
+    while (time_us() < thread_arg->end_time_us) {
+        /* check the time every 1024 operations */
+        for (i = 0; i < 1024; i++) {
+            /* xorshift32 */
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+
+            if (slots[x % SLOT_NUM]) {
+                mem_allocator_free(thread_arg->allocator, slots[x % SLOT_NUM]);
+                slots[x % SLOT_NUM] = NULL;
+            }
+            else {
+                size = (x >> 8) % thread_arg->max_size + 1;
+                slots[x % SLOT_NUM] =
+                    mem_allocator_malloc(thread_arg->allocator, size);
+                if (!slots[x % SLOT_NUM]) {
+                    printf("allocate %u bytes failed\n", size);
+                    thread_arg->failed = true;
+                    goto fail;
+                }
+                memset(slots[x % SLOT_NUM], 0, size);
+            }
+        }
+        thread_arg->count += 1024;
+    }
+
+fail:
+    for (i = 0; i < SLOT_NUM; i++) {
+        if (slots[i])
+            mem_allocator_free(thread_arg->allocator, slots[i]);
+    }
+    return NULL;
+}
+
+int
+main(int argc, char **argv)
+{
+    static ThreadArgs thread_args[MAX_THREAD_NUM];
+    pthread_t tids[MAX_THREAD_NUM];
+    int opt, thread_num = 1, duration = 5, max_size = 256, pool_mb = 64, i;
+    int created = 0, exit_code = 1;
+    bool thread_cache = false;
+    uint64_t start_time, elapsed_us, total = 0;
+    char *pool = NULL;
+    mem_allocator_t allocator = NULL;
+
+    while ((opt = getopt(argc, argv, "ht:d:s:m:c")) != -1) {
+        switch (opt) {
+            case 't':
+                thread_num = atoi(optarg);
+                break;
+            case 'd':
+                duration = atoi(optarg);
+                break;
+            case 's':
+                max_size = atoi(optarg);
+                break;
+            case 'm':
+                pool_mb = atoi(optarg);
+                break;
+            case 'c':
+                thread_cache = true;
+                break;
+            case 'h':
+            default:
+                print_usage();
+                return 0;
+        }
+    }
+    if (thread_num <= 0 || thread_num > MAX_THREAD_NUM || duration <= 0
+        || max_size <= 0 || pool_mb <= 0 || pool_mb > 1024) {
+        print_usage();
+        return 1;
+    }
+
+    if (!(pool = malloc((size_t)pool_mb * 1024 * 1024))) {
+        printf("allocate pool failed\n");
+        return 1;
+    }
+
+    allocator = mem_allocator_create(pool, (uint32_t)pool_mb * 1024 * 1024);
+    if (!allocator) {
+        printf("create allocator failed\n");
+        goto fail;
+    }
+
+    if (thread_cache) {
+#if WASM_ENABLE_ALLOC_THREAD_CACHE != 0
+        if (!mem_allocator_enable_thread_cache(allocator)) {
+            printf("enable thread cache failed\n");
+            goto fail;
+        }
+#else
+        printf("thread cache isn't enabled in the build, "
+               "rebuild with -DWAMR_BUILD_ALLOC_THREAD_CACHE=1\n");
+        goto fail;
+#endif
+    }
+
+    start_time = time_us();
+    for (i = 0; i < thread_num; i++) {
+        thread_args[i].allocator = allocator;
+        thread_args[i].max_size = (uint32_t)max_size;
+        thread_args[i].seed = 2463534242u + (uint32_t)i * 7919;
+        thread_args[i].end_time_us = start_time + (uint64_t)duration * 1000000;
+        if (pthread_create(&tids[i], NULL, thread, &thread_args[i]) != 0) {
+            printf("failed to create thread.\n");
+            break;
+        }
+        created++;
+    }
+
+    for (i = 0; i < created; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    elapsed_us = time_us() - start_time;
+
+    if (created < thread_num)
+        goto fail;
+
+    for (i = 0; i < thread_num; i++) {
+        if (thread_args[i].failed)
+            goto fail;
+        total += thread_args[i].count;
+    }
+    printf("thread cache %s, %d threads: %.2f M operations/s, "
+           "%.1f ns per operation\n",
+           thread_cache ? "enabled" : "disabled", thread_num,
+           total / (double)elapsed_us,
+           total ? (double)elapsed_us * 1000 * thread_num / total : 0.0);
+
+    exit_code = 0;
+fail:
+    if (allocator && mem_allocator_destroy(allocator) != 0) {
+        printf("destroy allocator failed\n");
+        exit_code = 1;
+    }
+    free(pool);
+    return exit_code;
+}
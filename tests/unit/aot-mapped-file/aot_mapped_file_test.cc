@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "aot_runtime.h"
+
+#define THREAD_NUM 8
+
+/* Must be larger than LAZY_TEXT_SLOT_NUM of aot_loader.c */
+#define MAPPED_MODULE_NUM 65
+
+class AOTMappedFileTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+
+        CWD = get_binary_path();
+        aot_file = CWD + "/lazy_text.aot";
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    void TearDown()
+    {
+        for (auto module : modules)
+            wasm_runtime_unload(module);
+        if (file_buf)
+            BH_FREE(file_buf);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    wasm_module_t load_mapped()
+    {
+        LoadArgs args;
+        wasm_module_t module;
+
+        memset(&args, 0, sizeof(LoadArgs));
+        module = wasm_runtime_load_from_mapped_file(
+            aot_file.c_str(), &args, error_buf, sizeof(error_buf));
+        if (module)
+            modules.push_back(module);
+        return module;
+    }
+
+    wasm_module_t load_from_buffer()
+    {
+        wasm_module_t module;
+        uint32 file_size;
+
+        file_buf =
+            (uint8 *)bh_read_file_to_buffer(aot_file.c_str(), &file_size);
+        if (!file_buf)
+            return NULL;
+
+        module = wasm_runtime_load(file_buf, file_size, error_buf,
+                                   sizeof(error_buf));
+        if (module)
+            modules.push_back(module);
+        return module;
+    }
+
+    /* Run the export "run", which calls every function of the module */
+    static bool run(wasm_module_t module, int32 x, int32 *result)
+    {
+        char error_buf[128];
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        uint32 argv[1] = { (uint32)x };
+        bool ret = false;
+
+        if (!(module_inst = wasm_runtime_instantiate(
+                  module, 8192, 0, error_buf, sizeof(error_buf))))
+            return false;
+
+        if ((exec_env = wasm_runtime_get_exec_env_singleton(module_inst))
+            && (func = wasm_runtime_lookup_function(module_inst, "run"))
+            && wasm_runtime_call_wasm(exec_env, func, 1, argv)) {
+            *result = (int32)argv[0];
+            ret = true;
+        }
+
+        wasm_runtime_deinstantiate(module_inst);
+        return ret;
+    }
+
+    /* The number of the pages of the module's text which are inaccessible
+       as their relocations haven't been applied yet */
+    static uint32 get_pending_page_count(wasm_module_t module)
+    {
+        AOTModule *aot_module = (AOTModule *)module;
+        uintptr_t text_start = (uintptr_t)aot_module->mapped_text;
+        uintptr_t text_end = text_start + aot_module->mapped_text_size;
+        std::ifstream maps("/proc/self/maps");
+        std::string line;
+        uint32 count = 0;
+
+        while (std::getline(maps, line)) {
+            uintptr_t start, end;
+            char perms[5] = { 0 };
+
+            if (sscanf(line.c_str(), "%lx-%lx %4s", &start, &end, perms) != 3
+                || end <= text_start || start >= text_end)
+                continue;
+            if (!strcmp(perms, "---p"))
+                count += (uint32)((std::min(end, text_end)
+                                   - std::max(start, text_start))
+                                  / os_getpagesize());
+        }
+        return count;
+    }
+
+  public:
+    std::string CWD;
+    std::string aot_file;
+    uint8 *file_buf = NULL;
+    std::vector<wasm_module_t> modules;
+    char error_buf[128];
+};
+
+TEST_F(AOTMappedFileTest, Mapped_matches_loaded)
+{
+    wasm_module_t loaded, mapped;
+    int32 x, expected, result;
+
+    ASSERT_TRUE((loaded = load_from_buffer()) != NULL) << error_buf;
+    ASSERT_TRUE((mapped = load_mapped()) != NULL) << error_buf;
+
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    EXPECT_GT(get_pending_page_count(mapped), 0u);
+#endif
+
+    for (x = -3; x <= 3; x++) {
+        ASSERT_TRUE(run(loaded, x, &expected));
+        ASSERT_TRUE(run(mapped, x, &result));
+        EXPECT_EQ(result, expected);
+    }
+
+    /* Every function has been run, so every page has been patched */
+    EXPECT_EQ(get_pending_page_count(mapped), 0u);
+}
+
+TEST_F(AOTMappedFileTest, Deferred_pages_called_from_threads)
+{
+    wasm_module_t loaded, mapped;
+    std::vector<std::thread> threads;
+    std::atomic<bool> start(false);
+    int32 expected[THREAD_NUM], results[THREAD_NUM];
+    bool succeeded[THREAD_NUM];
+    uint32 i;
+
+    ASSERT_TRUE((loaded = load_from_buffer()) != NULL) << error_buf;
+    ASSERT_TRUE((mapped = load_mapped()) != NULL) << error_buf;
+
+    for (i = 0; i < THREAD_NUM; i++)
+        ASSERT_TRUE(run(loaded, (int32)i, &expected[i]));
+
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    EXPECT_GT(get_pending_page_count(mapped), 0u);
+#endif
+
+    /* The threads fault on the same pending pages at about the same
+       time, each of them has its own instance of the mapped module */
+    for (i = 0; i < THREAD_NUM; i++) {
+        threads.emplace_back([&, i]() {
+            succeeded[i] = false;
+            if (!wasm_runtime_init_thread_env())
+                return;
+            while (!start.load())
+                ;
+            succeeded[i] = run(mapped, (int32)i, &results[i]);
+            wasm_runtime_destroy_thread_env();
+        });
+    }
+    start.store(true);
+    for (auto &thread : threads)
+        thread.join();
+
+    for (i = 0; i < THREAD_NUM; i++) {
+        ASSERT_TRUE(succeeded[i]);
+        EXPECT_EQ(results[i], expected[i]);
+    }
+    EXPECT_EQ(get_pending_page_count(mapped), 0u);
+}
+
+TEST_F(AOTMappedFileTest, Relocations_applied_when_slots_are_used_up)
+{
+    wasm_module_t loaded, mapped[MAPPED_MODULE_NUM];
+    int32 expected, result;
+    uint32 i;
+
+    ASSERT_TRUE((loaded = load_from_buffer()) != NULL) << error_buf;
+    ASSERT_TRUE(run(loaded, 5, &expected));
+
+    for (i = 0; i < MAPPED_MODULE_NUM; i++)
+        ASSERT_TRUE((mapped[i] = load_mapped()) != NULL) << error_buf;
+
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    /* No slot is left for the last module, its text is patched when it
+       is loaded */
+    EXPECT_GT(get_pending_page_count(mapped[0]), 0u);
+    EXPECT_EQ(get_pending_page_count(mapped[MAPPED_MODULE_NUM - 1]), 0u);
+#endif
+
+    ASSERT_TRUE(run(mapped[MAPPED_MODULE_NUM - 1], 5, &result));
+    EXPECT_EQ(result, expected);
+    ASSERT_TRUE(run(mapped[0], 5, &result));
+    EXPECT_EQ(result, expected);
+
+    /* A slot released by unloading is reused by the next module */
+    wasm_runtime_unload(mapped[0]);
+    modules.erase(modules.begin() + 1);
+    ASSERT_TRUE((mapped[0] = load_mapped()) != NULL) << error_buf;
+#ifdef AOT_LAZY_TEXT_RELOCATION
+    EXPECT_GT(get_pending_page_count(mapped[0]), 0u);
+#endif
+    ASSERT_TRUE(run(mapped[0], 5, &result));
+    EXPECT_EQ(result, expected);
+}
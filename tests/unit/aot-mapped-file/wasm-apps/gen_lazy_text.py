@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+
+"""
+Generate lazy_text.wasm, whose AOT text spans many pages with relocations
+to the floating-point constants in each of them:
+
+  (func $f<k> (param $x i32) (result i32)
+    (i32.add (i32.trunc_f64_s (f64.floor (f64.add
+      (f64.mul (f64.convert_i32_s (local.get $x)) (f64.const 1.5))
+      (f64.const <k>.25))))
+      (i32.const <k>)))
+
+  (func (export "run") (param $x i32) (result i32)
+    ;; the sum of $f<k>($x) for all k, called through the table)
+"""
+
+import struct
+import sys
+
+FUNC_NUM = 400
+
+
+def leb(n):
+    out = b""
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out += bytes([b | 0x80])
+        else:
+            return out + bytes([b])
+
+
+def sleb(n):
+    out = b""
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if (n == 0 and not b & 0x40) or (n == -1 and b & 0x40):
+            return out + bytes([b])
+        out += bytes([b | 0x80])
+
+
+def vec(items):
+    return leb(len(items)) + b"".join(items)
+
+
+def section(id, body):
+    return bytes([id]) + leb(len(body)) + body
+
+
+def name(s):
+    return leb(len(s)) + s.encode()
+
+
+def code(locals_, insns):
+    body = vec(locals_) + insns + b"\x0b"
+    return leb(len(body)) + body
+
+
+def main(path):
+    i32 = b"\x7f"
+    codes = []
+
+    for k in range(FUNC_NUM):
+        codes.append(
+            code(
+                [],
+                b"\x20\x00\xb7"
+                + b"\x44" + struct.pack("<d", 1.5) + b"\xa2"
+                + b"\x44" + struct.pack("<d", k + 0.25) + b"\xa0"
+                + b"\x9c\xaa"
+                + b"\x41" + sleb(k) + b"\x6a",
+            )
+        )
+
+    # local 1 is the index of the function to call, local 2 is the sum
+    codes.append(
+        code(
+            [b"\x02" + i32],
+            b"\x03\x40"
+            + b"\x20\x02\x20\x00\x20\x01\x11\x00\x00\x6a\x21\x02"
+            + b"\x20\x01\x41\x01\x6a\x22\x01"
+            + b"\x41" + sleb(FUNC_NUM) + b"\x49\x0d\x00"
+            + b"\x0b\x20\x02",
+        )
+    )
+
+    module = b"\x00asm\x01\x00\x00\x00"
+    module += section(1, vec([b"\x60" + vec([i32]) + vec([i32])]))
+    module += section(3, vec([leb(0)] * (FUNC_NUM + 1)))
+    module += section(4, vec([b"\x70\x00" + leb(FUNC_NUM)]))
+    module += section(7, vec([name("run") + b"\x00" + leb(FUNC_NUM)]))
+    module += section(
+        9, vec([b"\x00\x41\x00\x0b" + vec([leb(k) for k in range(FUNC_NUM)])])
+    )
+    module += section(10, vec(codes))
+
+    with open(path, "wb") as f:
+        f.write(module)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "lazy_text.wasm")
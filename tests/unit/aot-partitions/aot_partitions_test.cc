@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+static const int32 inputs[] = { 0, 1, 5, 100, -7, 123456 };
+
+#define INPUT_NUM (sizeof(inputs) / sizeof(inputs[0]))
+
+class AOTPartitionsTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+    }
+
+    void TearDown()
+    {
+        for (auto module : modules)
+            wasm_runtime_unload(module);
+        for (auto file_buf : file_bufs)
+            BH_FREE(file_buf);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    std::vector<uint8> read_file(const char *file_name)
+    {
+        std::string file = CWD + "/" + file_name;
+        std::vector<uint8> content;
+        uint8 *buf;
+        uint32 size;
+
+        if ((buf = (uint8 *)bh_read_file_to_buffer(file.c_str(), &size))) {
+            content.assign(buf, buf + size);
+            BH_FREE(buf);
+        }
+        return content;
+    }
+
+    wasm_module_t load(const char *file_name)
+    {
+        std::string file = CWD + "/" + file_name;
+        wasm_module_t module;
+        uint8 *buf;
+        uint32 size;
+
+        if (!(buf = (uint8 *)bh_read_file_to_buffer(file.c_str(), &size)))
+            return NULL;
+        file_bufs.push_back(buf);
+
+        if ((module =
+                 wasm_runtime_load(buf, size, error_buf, sizeof(error_buf))))
+            modules.push_back(module);
+        return module;
+    }
+
+    /* Run the export "run", which calls every function of the module */
+    static bool run(wasm_module_t module, int32 x, int32 *result)
+    {
+        char error_buf[128];
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        uint32 argv[1] = { (uint32)x };
+        bool ret = false;
+
+        if (!(module_inst = wasm_runtime_instantiate(
+                  module, 8192, 0, error_buf, sizeof(error_buf))))
+            return false;
+
+        if ((exec_env = wasm_runtime_get_exec_env_singleton(module_inst))
+            && (func = wasm_runtime_lookup_function(module_inst, "run"))
+            && wasm_runtime_call_wasm(exec_env, func, 1, argv)) {
+            *result = (int32)argv[0];
+            ret = true;
+        }
+
+        wasm_runtime_deinstantiate(module_inst);
+        return ret;
+    }
+
+    /* The results of the AOT file must be the ones of the interpreter */
+    void check_aot_file(const char *file_name)
+    {
+        wasm_module_t wasm_module, aot_module;
+        int32 expected, result;
+        uint32 i;
+
+        ASSERT_TRUE(wasm_module = load("partitions.wasm")) << error_buf;
+        ASSERT_TRUE(aot_module = load(file_name)) << error_buf;
+        ASSERT_EQ(wasm_runtime_get_module_package_type(aot_module),
+                  Wasm_Module_AoT);
+
+        for (i = 0; i < INPUT_NUM; i++) {
+            ASSERT_TRUE(run(wasm_module, inputs[i], &expected));
+            ASSERT_TRUE(run(aot_module, inputs[i], &result));
+            EXPECT_EQ(result, expected) << "input " << inputs[i];
+        }
+    }
+
+  public:
+    std::string CWD;
+    std::vector<uint8 *> file_bufs;
+    std::vector<wasm_module_t> modules;
+    char error_buf[128];
+};
+
+TEST_F(AOTPartitionsTest, Single_thread_identical_to_default)
+{
+    std::vector<uint8> aot_default = read_file("partitions.aot");
+
+    ASSERT_FALSE(aot_default.empty());
+    EXPECT_EQ(read_file("partitions_threads_1.aot"), aot_default);
+}
+
+TEST_F(AOTPartitionsTest, Default_output_runs)
+{
+    check_aot_file("partitions.aot");
+}
+
+TEST_F(AOTPartitionsTest, Partitioned_output_runs)
+{
+    check_aot_file("partitions_threads_4.aot");
+}
+
+TEST_F(AOTPartitionsTest, Warm_func_cache_identical_to_cold)
+{
+    std::vector<uint8> aot_cold = read_file("partitions_cache_cold.aot");
+
+    ASSERT_FALSE(aot_cold.empty());
+    EXPECT_EQ(read_file("partitions_cache_warm.aot"), aot_cold);
+    EXPECT_EQ(read_file("partitions_cache_partial.aot"), aot_cold);
+}
+
+TEST_F(AOTPartitionsTest, Func_cache_output_runs)
+{
+    check_aot_file("partitions_cache_warm.aot");
+}
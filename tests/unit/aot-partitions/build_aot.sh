@@ -0,0 +1,41 @@
+#!/bin/bash
+
+#
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+
+WORKDIR="$PWD"
+WAMRC_ROOT_DIR="${WORKDIR}/../../../wamr-compiler"
+WAMRC="${WAMRC_ROOT_DIR}/build/wamrc"
+
+# build wamrc if not exist
+if [ ! -s "$WAMRC" ]; then
+    cd $WAMRC_ROOT_DIR
+    if [ -d "$WAMRC/build" ]; then
+        rm -r build 
+    fi
+    cmake -B build && cmake --build build -j $(nproc)
+    cd $WORKDIR
+fi
+
+set -e
+
+# the default is a single thread, its output must not change with the option
+$WAMRC -o wasm-apps/partitions.aot wasm-apps/partitions.wasm
+$WAMRC --compile-threads=1 -o wasm-apps/partitions_threads_1.aot \
+    wasm-apps/partitions.wasm
+$WAMRC --compile-threads=4 -o wasm-apps/partitions_threads_4.aot \
+    wasm-apps/partitions.wasm
+
+# the function cache, a build with all the functions found in the cache and
+# a build with a part of them found only must be identical to the cold one
+FUNC_CACHE_DIR=$(mktemp -d)
+trap 'rm -rf "$FUNC_CACHE_DIR"' EXIT
+$WAMRC --func-cache-dir="$FUNC_CACHE_DIR" \
+    -o wasm-apps/partitions_cache_cold.aot wasm-apps/partitions.wasm
+$WAMRC --func-cache-dir="$FUNC_CACHE_DIR" \
+    -o wasm-apps/partitions_cache_warm.aot wasm-apps/partitions.wasm
+ls "$FUNC_CACHE_DIR"/*.wfunc | awk 'NR % 2' | xargs rm -f
+$WAMRC --func-cache-dir="$FUNC_CACHE_DIR" \
+    -o wasm-apps/partitions_cache_partial.aot wasm-apps/partitions.wasm
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+
+"""
+Generate partitions.wasm, whose functions call each other directly and
+through the table, and have jump tables and floating-point constants, so
+that the code of a partition refers to the others and to its data:
+
+  (func $f0 (param $x i32) (result i32)
+    (i32.add (i32.mul (local.get $x) (i32.const 7)) (i32.const 1)))
+
+  (func $f<k> (param $x i32) (result i32)
+    (local $t i32)
+    (local.set $t (call $f<k-1> (local.get $x)))
+    ;; br_table on (x + k) & 3 updating $t with one of:
+    ;;   $t ^ C, $t + C, $t * 3, $t rotl 5
+    (i32.add (local.get $t)
+      (i32.trunc_f64_s (f64.mul
+        (f64.convert_i32_u (i32.and (local.get $x) (i32.const 0xffff)))
+        (f64.const <k>.25)))))
+
+  (func (export "run") (param $x i32) (result i32)
+    ;; the sum of $f<k>($x + k) for all k, called through the table)
+"""
+
+import struct
+import sys
+
+FUNC_NUM = 24
+
+
+def leb(n):
+    out = b""
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out += bytes([b | 0x80])
+        else:
+            return out + bytes([b])
+
+
+def sleb(n):
+    out = b""
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if (n == 0 and not b & 0x40) or (n == -1 and b & 0x40):
+            return out + bytes([b])
+        out += bytes([b | 0x80])
+
+
+def vec(items):
+    return leb(len(items)) + b"".join(items)
+
+
+def section(id, body):
+    return bytes([id]) + leb(len(body)) + body
+
+
+def name(s):
+    return leb(len(s)) + s.encode()
+
+
+def code(locals_, insns):
+    body = vec(locals_) + insns + b"\x0b"
+    return leb(len(body)) + body
+
+
+def i32_const(v):
+    return b"\x41" + sleb(v)
+
+
+def func_body(k):
+    get_x, get_t, set_t = b"\x20\x00", b"\x20\x01", b"\x21\x01"
+
+    if k == 0:
+        return get_x + i32_const(7) + b"\x6c" + i32_const(1) + b"\x6a"
+
+    return (
+        get_x
+        + b"\x10" + leb(k - 1)
+        + set_t
+        # block $out, block $3, block $2, block $1, block $0
+        + b"\x02\x40" * 5
+        + get_x + i32_const(k) + b"\x6a" + i32_const(3) + b"\x71"
+        + b"\x0e" + vec([leb(0), leb(1), leb(2), leb(3)]) + leb(3)
+        + b"\x0b"
+        + get_t + i32_const(0x5BD1E995 + k) + b"\x73" + set_t
+        + b"\x0c\x03"
+        + b"\x0b"
+        + get_t + i32_const(1000 * k + 17) + b"\x6a" + set_t
+        + b"\x0c\x02"
+        + b"\x0b"
+        + get_t + i32_const(3) + b"\x6c" + set_t
+        + b"\x0c\x01"
+        + b"\x0b"
+        + get_t + i32_const(5) + b"\x77" + set_t
+        + b"\x0b"
+        + get_t
+        + get_x + i32_const(0xFFFF) + b"\x71" + b"\xb8"
+        + b"\x44" + struct.pack("<d", k + 0.25) + b"\xa2"
+        + b"\xaa"
+        + b"\x6a"
+    )
+
+
+def main(path):
+    i32 = b"\x7f"
+    codes = []
+
+    for k in range(FUNC_NUM):
+        codes.append(code([b"\x01" + i32] if k else [], func_body(k)))
+
+    # local 1 is the index of the function to call, local 2 is the sum
+    codes.append(
+        code(
+            [b"\x02" + i32],
+            b"\x03\x40"
+            + b"\x20\x02\x20\x00\x20\x01\x6a\x20\x01\x11\x00\x00\x6a\x21\x02"
+            + b"\x20\x01\x41\x01\x6a\x22\x01"
+            + i32_const(FUNC_NUM) + b"\x49\x0d\x00"
+            + b"\x0b\x20\x02",
+        )
+    )
+
+    module = b"\x00asm\x01\x00\x00\x00"
+    module += section(1, vec([b"\x60" + vec([i32]) + vec([i32])]))
+    module += section(3, vec([leb(0)] * (FUNC_NUM + 1)))
+    module += section(4, vec([b"\x70\x00" + leb(FUNC_NUM)]))
+    module += section(7, vec([name("run") + b"\x00" + leb(FUNC_NUM)]))
+    module += section(
+        9, vec([b"\x00\x41\x00\x0b" + vec([leb(k) for k in range(FUNC_NUM)])])
+    )
+    module += section(10, vec(codes))
+
+    with open(path, "wb") as f:
+        f.write(module)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "partitions.wasm")
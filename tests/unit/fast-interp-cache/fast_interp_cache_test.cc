@@ -0,0 +1,302 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "wasm.h"
+
+/* The results of the exports of cached.wasm, see cached.wast */
+typedef struct AppResult {
+    uint64 fib;
+    uint32 select[5];
+    uint32 apply[2];
+    uint32 sum;
+    float64 fmul;
+} AppResult;
+
+static const uint8 data_segment[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+class FastInterpCacheTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        char dir[] = "/tmp/wamr-fast-interp-cache-XXXXXX";
+        std::vector<char> content;
+
+        CWD = get_binary_path();
+        ASSERT_TRUE(mkdtemp(dir) != NULL);
+        cache_dir = dir;
+
+        /* The runtime is initialized by each run */
+        content = read_file(CWD + "/cached.wasm");
+        ASSERT_FALSE(content.empty());
+        wasm_buf.assign(content.begin(), content.end());
+    }
+
+    void TearDown()
+    {
+        for (auto &file : get_cache_files())
+            unlink(file.c_str());
+        rmdir(cache_dir.c_str());
+    }
+
+  public:
+    std::vector<std::string> get_cache_files()
+    {
+        std::vector<std::string> files;
+        DIR *dir = opendir(cache_dir.c_str());
+        struct dirent *entry;
+
+        if (dir) {
+            while ((entry = readdir(dir))) {
+                if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+                    files.push_back(cache_dir + "/" + entry->d_name);
+            }
+            closedir(dir);
+        }
+        return files;
+    }
+
+    static std::vector<char> read_file(const std::string &file)
+    {
+        std::ifstream in(file, std::ios::binary);
+
+        return std::vector<char>(std::istreambuf_iterator<char>(in),
+                                 std::istreambuf_iterator<char>());
+    }
+
+    static void write_file(const std::string &file,
+                           const std::vector<char> &content)
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+
+        out.write(content.data(), content.size());
+    }
+
+    /* A module which differs from cached.wasm in its data segment only,
+       so that it has the same index spaces */
+    std::vector<uint8> get_other_wasm()
+    {
+        std::vector<uint8> buf = wasm_buf;
+        auto it = std::search(buf.begin(), buf.end(), data_segment,
+                              data_segment + sizeof(data_segment));
+
+        EXPECT_TRUE(it != buf.end());
+        if (it != buf.end())
+            std::fill(it, it + sizeof(data_segment), 5);
+        return buf;
+    }
+
+    static bool call(wasm_module_inst_t module_inst, const char *name,
+                     uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+
+        return func && exec_env
+               && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    /* Load the module with the code cache, tell whether its code was
+       loaded from the cache, and call its exports */
+    bool run(const std::vector<uint8> &wasm, bool *p_cache_hit,
+             AppResult *result)
+    {
+        RuntimeInitArgs init_args;
+        std::vector<uint8> buf = wasm;
+        wasm_module_t module = NULL;
+        wasm_module_inst_t module_inst = NULL;
+        uint32 argv[2], i;
+        bool ret = false;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.fast_interp_cache_dir = cache_dir.c_str();
+        if (!wasm_runtime_full_init(&init_args))
+            return false;
+
+        memset(result, 0, sizeof(AppResult));
+        if (!(module = wasm_runtime_load(buf.data(), (uint32)buf.size(),
+                                         error_buf, sizeof(error_buf)))
+            || !(module_inst = wasm_runtime_instantiate(
+                     module, 8192, 0, error_buf, sizeof(error_buf))))
+            goto fail;
+        *p_cache_hit = ((WASMModule *)module)->fast_interp_cache_buf != NULL;
+
+        argv[0] = 50;
+        if (!call(module_inst, "fib", 1, argv))
+            goto fail;
+        memcpy(&result->fib, argv, sizeof(uint64));
+
+        for (i = 0; i < 5; i++) {
+            argv[0] = i;
+            if (!call(module_inst, "select", 1, argv))
+                goto fail;
+            result->select[i] = argv[0];
+        }
+
+        for (i = 0; i < 2; i++) {
+            argv[0] = i;
+            argv[1] = 21;
+            if (!call(module_inst, "apply", 2, argv))
+                goto fail;
+            result->apply[i] = argv[0];
+        }
+
+        if (!call(module_inst, "sum", 0, argv))
+            goto fail;
+        result->sum = argv[0];
+
+        result->fmul = 1.5;
+        memcpy(argv, &result->fmul, sizeof(float64));
+        if (!call(module_inst, "fmul", 2, argv))
+            goto fail;
+        memcpy(&result->fmul, argv, sizeof(float64));
+
+        ret = true;
+
+    fail:
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        wasm_runtime_destroy();
+        return ret;
+    }
+
+    static void check_result(const AppResult *result, uint32 sum)
+    {
+        uint32 select[5] = { 10, 20, 30, 40, 40 };
+        uint32 i;
+
+        EXPECT_EQ(result->fib, 12586269025ULL);
+        for (i = 0; i < 5; i++)
+            EXPECT_EQ(result->select[i], select[i]);
+        /* 100 + 21 * 2, then + 21 * 21 */
+        EXPECT_EQ(result->apply[0], 142u);
+        EXPECT_EQ(result->apply[1], 583u);
+        EXPECT_EQ(result->sum, sum);
+        EXPECT_EQ(result->fmul, 3.75);
+    }
+
+  public:
+    std::string CWD;
+    std::string cache_dir;
+    std::vector<uint8> wasm_buf;
+    char error_buf[128];
+};
+
+#if WASM_ENABLE_FAST_INTERP_CACHE != 0
+TEST_F(FastInterpCacheTest, Warm_load_matches_cold_load)
+{
+    AppResult cold, warm;
+    bool cache_hit = true;
+
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &cold)) << error_buf;
+    EXPECT_FALSE(cache_hit);
+    check_result(&cold, 36);
+    ASSERT_EQ(get_cache_files().size(), 1u);
+
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &warm)) << error_buf;
+    EXPECT_TRUE(cache_hit);
+    EXPECT_EQ(memcmp(&warm, &cold, sizeof(AppResult)), 0);
+    EXPECT_EQ(get_cache_files().size(), 1u);
+}
+
+TEST_F(FastInterpCacheTest, Corrupted_cache_rejected)
+{
+    std::vector<char> content;
+    std::string file;
+    AppResult result;
+    bool cache_hit = true;
+
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &result)) << error_buf;
+    ASSERT_EQ(get_cache_files().size(), 1u);
+    file = get_cache_files()[0];
+    content = read_file(file);
+    ASSERT_GT(content.size(), 64u);
+
+    /* A byte of the cached data flipped, the file is ignored and written
+       again */
+    content[content.size() - 8] ^= 0x5A;
+    write_file(file, content);
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &result)) << error_buf;
+    EXPECT_FALSE(cache_hit);
+    check_result(&result, 36);
+
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &result)) << error_buf;
+    EXPECT_TRUE(cache_hit);
+    check_result(&result, 36);
+
+    /* A truncated file */
+    content = read_file(file);
+    content.resize(content.size() / 2);
+    write_file(file, content);
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &result)) << error_buf;
+    EXPECT_FALSE(cache_hit);
+    check_result(&result, 36);
+}
+
+TEST_F(FastInterpCacheTest, Cache_of_another_module_rejected)
+{
+    std::vector<uint8> other_wasm = get_other_wasm();
+    std::vector<std::string> files;
+    std::string file, other_file;
+    AppResult result;
+    bool cache_hit = true;
+
+    ASSERT_TRUE(run(wasm_buf, &cache_hit, &result)) << error_buf;
+    ASSERT_EQ((files = get_cache_files()).size(), 1u);
+    file = files[0];
+
+    /* The other module has a cache file of its own */
+    ASSERT_TRUE(run(other_wasm, &cache_hit, &result)) << error_buf;
+    EXPECT_FALSE(cache_hit);
+    check_result(&result, 40);
+    ASSERT_EQ((files = get_cache_files()).size(), 2u);
+    other_file = files[0] == file ? files[1] : files[0];
+
+    /* The cache file of the first module put in place of the one of the
+       other module is rejected, even though the index spaces match */
+    write_file(other_file, read_file(file));
+    ASSERT_TRUE(run(other_wasm, &cache_hit, &result)) << error_buf;
+    EXPECT_FALSE(cache_hit);
+    check_result(&result, 40);
+
+    ASSERT_TRUE(run(other_wasm, &cache_hit, &result)) << error_buf;
+    EXPECT_TRUE(cache_hit);
+    check_result(&result, 40);
+}
+#endif /* end of WASM_ENABLE_FAST_INTERP_CACHE != 0 */
@@ -0,0 +1,79 @@
+(module
+  (type $t (func (param i32) (result i32)))
+  (memory 1)
+  (global $g (mut i32) (i32.const 100))
+  (table 2 funcref)
+  (elem (i32.const 0) $double $square)
+  (data (i32.const 16) "\01\02\03\04\05\06\07\08")
+
+  (func $double (type $t)
+    (i32.mul (local.get 0) (i32.const 2))
+  )
+
+  (func $square (type $t)
+    (i32.mul (local.get 0) (local.get 0))
+  )
+
+  ;; the n-th Fibonacci number, the branches of the loop are relocated
+  (func (export "fib") (param $n i32) (result i64)
+    (local $a i64) (local $b i64) (local $t i64)
+    (local.set $b (i64.const 1))
+    block
+      loop
+        (br_if 1 (i32.eqz (local.get $n)))
+        (local.set $t (i64.add (local.get $a) (local.get $b)))
+        (local.set $a (local.get $b))
+        (local.set $b (local.get $t))
+        (local.set $n (i32.sub (local.get $n) (i32.const 1)))
+        br 0
+      end
+    end
+    (local.get $a)
+  )
+
+  (func (export "select") (param $i i32) (result i32)
+    block
+      block
+        block
+          block
+            (br_table 0 1 2 3 (local.get $i))
+          end
+          (return (i32.const 10))
+        end
+        (return (i32.const 20))
+      end
+      (return (i32.const 30))
+    end
+    (i32.const 40)
+  )
+
+  ;; call a function of the table and add its result to the global
+  (func (export "apply") (param $idx i32) (param $x i32) (result i32)
+    (global.set $g
+      (i32.add (global.get $g)
+               (call_indirect (type $t) (local.get $x) (local.get $idx))))
+    (global.get $g)
+  )
+
+  ;; the sum of the bytes of the data segment if it is greater than 30,
+  ;; or -1
+  (func (export "sum") (result i32)
+    (local $i i32) (local $s i32)
+    loop
+      (local.set $s
+        (i32.add (local.get $s) (i32.load8_u offset=16 (local.get $i))))
+      (local.tee $i (i32.add (local.get $i) (i32.const 1)))
+      (i32.const 8)
+      i32.lt_u
+      br_if 0
+    end
+    (if (result i32) (i32.gt_u (local.get $s) (i32.const 30))
+      (then (local.get $s))
+      (else (i32.const -1)))
+  )
+
+  ;; the constant is kept in the const table of the function
+  (func (export "fmul") (param f64) (result f64)
+    (f64.mul (local.get 0) (f64.const 2.5))
+  )
+)
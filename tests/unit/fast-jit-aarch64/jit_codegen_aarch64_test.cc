@@ -0,0 +1,934 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "wasm_export.h"
+
+/* Include the codegen to test its static lowering functions */
+#include "cg/aarch64/jit_codegen_aarch64.cpp"
+
+/* The native functions compiled by the test cases, which take the
+   arguments in x0 and x1 and return x0 */
+typedef uint64 (*NativeFunc)(uint64, uint64);
+
+/* The operands of the lowered insns in the native runs, the results are
+   also checked with each of them as the const operand */
+static const uint64 test_values[] = {
+    0,
+    1,
+    2,
+    3,
+    5,
+    31,
+    32,
+    33,
+    63,
+    64,
+    65,
+    0xFF,
+    4095,
+    4096,
+    4097,
+    0x7FFF,
+    0x12345,
+    0x7FFFFFFF,
+    0x80000000,
+    0xFFFFFFFF,
+    0x100000000,
+    0x5555555555555555,
+    0xF0F0F0F0F0F0F0F0,
+    0x123456789ABCDEF0,
+    0xFFFF0000FFFF1234,
+    0x7FFFFFFFFFFFFFFF,
+    0x8000000000000000,
+    (uint64)-4097,
+    (uint64)-4096,
+    (uint64)-4095,
+    (uint64)-2,
+    (uint64)-1,
+};
+
+static uint64
+width_mask(uint32 bits)
+{
+    return bits == 64 ? ~(uint64)0 : ((uint64)1 << bits) - 1;
+}
+
+static int64
+sign_extend(uint64 v, uint32 bits)
+{
+    return bits == 64 ? (int64)v : (int64)(int32)(uint32)v;
+}
+
+/* The result of the alu op on the values of the width, or false if it's
+   undefined, i.e. the division by zero or the overflow */
+static bool
+alu_ref(ALU_OP op, uint32 bits, uint64 x, uint64 y, uint64 *p_result)
+{
+    int64 sx = sign_extend(x, bits), sy = sign_extend(y, bits);
+    int64 smin = bits == 64 ? INT64_MIN : INT32_MIN;
+    uint64 result;
+
+    x &= width_mask(bits);
+    y &= width_mask(bits);
+
+    switch (op) {
+        case ADD:
+            result = x + y;
+            break;
+        case SUB:
+            result = x - y;
+            break;
+        case MUL:
+            result = x * y;
+            break;
+        case DIV_S:
+        case REM_S:
+            if (sy == 0 || (sx == smin && sy == -1))
+                return false;
+            result = (uint64)(op == DIV_S ? sx / sy : sx % sy);
+            break;
+        case DIV_U:
+        case REM_U:
+            if (y == 0)
+                return false;
+            result = op == DIV_U ? x / y : x % y;
+            break;
+        default:
+            return false;
+    }
+
+    *p_result = result & width_mask(bits);
+    return true;
+}
+
+static bool
+bit_ref(BIT_OP op, uint32 bits, uint64 x, uint64 y, uint64 *p_result)
+{
+    *p_result = (op == AND ? x & y : op == OR ? x | y : x ^ y)
+                & width_mask(bits);
+    return true;
+}
+
+static bool
+shift_ref(SHIFT_OP op, uint32 bits, uint64 x, uint64 y, uint64 *p_result)
+{
+    uint32 n = (uint32)y & (bits - 1);
+    uint64 result;
+
+    x &= width_mask(bits);
+
+    switch (op) {
+        case SHL:
+            result = x << n;
+            break;
+        case SHRS:
+            result = (uint64)(sign_extend(x, bits) >> n);
+            break;
+        case SHRU:
+            result = x >> n;
+            break;
+        case ROTL:
+            result = n ? (x << n) | (x >> (bits - n)) : x;
+            break;
+        case ROTR:
+            result = n ? (x >> n) | (x << (bits - n)) : x;
+            break;
+        default:
+            return false;
+    }
+
+    *p_result = result & width_mask(bits);
+    return true;
+}
+
+static bool
+cond_ref(COND_OP op, uint32 bits, uint64 x, uint64 y)
+{
+    int64 sx = sign_extend(x, bits), sy = sign_extend(y, bits);
+
+    x &= width_mask(bits);
+    y &= width_mask(bits);
+
+    switch (op) {
+        case EQ:
+            return x == y;
+        case NE:
+            return x != y;
+        case GTS:
+            return sx > sy;
+        case GES:
+            return sx >= sy;
+        case LTS:
+            return sx < sy;
+        case LES:
+            return sx <= sy;
+        case GTU:
+            return x > y;
+        case GEU:
+            return x >= y;
+        case LTU:
+            return x < y;
+        case LEU:
+            return x <= y;
+        default:
+            return false;
+    }
+}
+
+/* All the bitmask immediates of the width, i.e. the rotated runs of ones
+   in the elements of 2, 4, ..., bits bits replicated to the width */
+static std::set<uint64>
+logical_imms(uint32 bits)
+{
+    std::set<uint64> imms;
+    uint64 run, elem, imm;
+    uint32 size, ones, rot, i;
+
+    for (size = 2; size <= bits; size <<= 1) {
+        for (ones = 1; ones < size; ones++) {
+            run = ((uint64)1 << ones) - 1;
+            for (rot = 0; rot < size; rot++) {
+                elem = rot ? ((run >> rot) | (run << (size - rot)))
+                                 & width_mask(size)
+                           : run;
+                for (imm = 0, i = 0; i < bits; i += size)
+                    imm |= elem << i;
+                imms.insert(imm);
+            }
+        }
+    }
+    return imms;
+}
+
+class JitCodegenAArch64Test : public testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+
+        /* The Fast JIT compiler and its code cache are initialized with
+           the runtime */
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        is_runtime_inited = true;
+
+        cc = (JitCompContext *)wasm_runtime_malloc(sizeof(*cc));
+        ASSERT_TRUE(cc);
+        memset(cc, 0, sizeof(*cc));
+        if (!jit_cc_init(cc, 64)) {
+            wasm_runtime_free(cc);
+            cc = NULL;
+            FAIL() << "Init compilation context failed";
+        }
+    }
+
+    void TearDown()
+    {
+        for (void *code : code_list)
+            jit_code_cache_free(code);
+        if (cc)
+            jit_cc_delete(cc);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    JitReg reg_w(uint32 no) { return jit_reg_new(JIT_REG_KIND_I32, no); }
+
+    JitReg reg_x(uint32 no) { return jit_reg_new(JIT_REG_KIND_I64, no); }
+
+    JitReg new_const(uint32 kind, uint64 value)
+    {
+        if (kind == JIT_REG_KIND_I32)
+            return jit_cc_new_const_I32(cc, (int32)value);
+        return jit_cc_new_const_I64(cc, (int64)value);
+    }
+
+    /* Emit the code with the emitter and get its instruction words */
+    template <typename F>
+    bool emit(F emitter, std::vector<uint32> &words)
+    {
+        JitErrorHandler err_handler;
+        Environment env(Arch::kAArch64);
+        CodeHolder code;
+
+        code.init(env);
+        code.setErrorHandler(&err_handler);
+        a64::Assembler a(&code);
+
+        if (!emitter(a) || err_handler.err)
+            return false;
+
+        auto &buf = code.sectionById(0)->buffer();
+        words.resize(buf.size() / sizeof(uint32));
+        if (!words.empty())
+            memcpy(words.data(), buf.data(), words.size() * sizeof(uint32));
+        return true;
+    }
+
+    /* Emit the code with the emitter followed by a ret into the code
+       cache, return NULL if it fails */
+    template <typename F>
+    NativeFunc compile(F emitter)
+    {
+        JitErrorHandler err_handler;
+        Environment env(Arch::kAArch64);
+        CodeHolder code;
+        union {
+            NativeFunc f;
+            void *v;
+        } u;
+
+        code.init(env);
+        code.setErrorHandler(&err_handler);
+        a64::Assembler a(&code);
+
+        if (!emitter(a))
+            return NULL;
+        a.ret(a64::x30);
+        if (err_handler.err || !(u.v = commit_code(code, NULL)))
+            return NULL;
+
+        code_list.push_back(u.v);
+        return u.f;
+    }
+
+    /* Check the native code of r0 = r1 op r2 emitted by lower against the
+       reference with the test values as the operands, in the forms of
+       x0 = x0 op x1, x0 = x1 op x0, x0 = x0 op const and
+       x0 = const op x0, or the w registers for I32 */
+    void check_binary(
+        uint32 kind,
+        std::function<bool(a64::Assembler &, JitReg, JitReg, JitReg)> lower,
+        std::function<bool(uint32, uint64, uint64, uint64 *)> ref)
+    {
+        uint32 bits = kind == JIT_REG_KIND_I32 ? 32 : 64;
+        JitReg r0 = jit_reg_new(kind, 0), r1 = jit_reg_new(kind, 1), c;
+        NativeFunc func, func_swapped;
+        uint64 expected;
+
+        func = compile([&](a64::Assembler &a) { return lower(a, r0, r0, r1); });
+        func_swapped =
+            compile([&](a64::Assembler &a) { return lower(a, r0, r1, r0); });
+        ASSERT_TRUE(func && func_swapped);
+
+        for (uint64 x : test_values) {
+            for (uint64 y : test_values) {
+                if (!ref(bits, x, y, &expected))
+                    continue;
+                EXPECT_EQ(func(x, y), expected)
+                    << std::hex << "x: " << x << ", y: " << y;
+                EXPECT_EQ(func_swapped(y, x), expected)
+                    << std::hex << "x: " << x << ", y: " << y;
+            }
+        }
+
+        for (uint64 y : test_values) {
+            c = new_const(kind, y);
+            func =
+                compile([&](a64::Assembler &a) { return lower(a, r0, r0, c); });
+            func_swapped =
+                compile([&](a64::Assembler &a) { return lower(a, r0, c, r0); });
+            ASSERT_TRUE(func && func_swapped) << std::hex << "const: " << y;
+
+            for (uint64 x : test_values) {
+                if (ref(bits, x, y, &expected)) {
+                    EXPECT_EQ(func(x, 0), expected)
+                        << std::hex << "x: " << x << ", const: " << y;
+                }
+                if (ref(bits, y, x, &expected)) {
+                    EXPECT_EQ(func_swapped(x, 0), expected)
+                        << std::hex << "const: " << y << ", x: " << x;
+                }
+            }
+        }
+    }
+
+  public:
+    bool is_runtime_inited = false;
+    JitCompContext *cc = NULL;
+    std::vector<void *> code_list;
+};
+
+/* The expected words are the encodings of llvm-mc for the insns */
+TEST_F(JitCodegenAArch64Test, Encoding)
+{
+    struct {
+        const char *insns;
+        std::function<bool(a64::Assembler &)> emitter;
+        std::vector<uint32> words;
+    } cases[] = {
+        /* mov_imm_to_gp */
+        { "movz w0, #0",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0, 32);
+              return true;
+          },
+          { 0x52800000 } },
+        { "movz w0, #0x1234",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0x1234, 32);
+              return true;
+          },
+          { 0x52824680 } },
+        { "movz w0, #0x1234, lsl #16",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0x12340000, 32);
+              return true;
+          },
+          { 0x52a24680 } },
+        { "movn w0, #0",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0xFFFFFFFF, 32);
+              return true;
+          },
+          { 0x12800000 } },
+        { "movn w0, #1",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0xFFFFFFFE, 32);
+              return true;
+          },
+          { 0x12800020 } },
+        { "movz w0, #0x5678; movk w0, #0x1234, lsl #16",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::w0, 0x12345678, 32);
+              return true;
+          },
+          { 0x528acf00, 0x72a24680 } },
+        { "movz x1, #0xdef0; movk x1, #0x9abc, lsl #16; "
+          "movk x1, #0x5678, lsl #32; movk x1, #0x1234, lsl #48",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::x1, 0x123456789ABCDEF0, 64);
+              return true;
+          },
+          { 0xd29bde01, 0xf2b35781, 0xf2cacf01, 0xf2e24681 } },
+        { "movn x1, #0xedcb; movk x1, #0, lsl #32",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::x1, 0xFFFF0000FFFF1234, 64);
+              return true;
+          },
+          { 0x929db961, 0xf2c00001 } },
+        { "movz x1, #1, lsl #32",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::x1, 0x100000000, 64);
+              return true;
+          },
+          { 0xd2c00021 } },
+        { "movn x1, #0",
+          [&](a64::Assembler &a) {
+              mov_imm_to_gp(a, a64::x1, ~(uint64)0, 64);
+              return true;
+          },
+          { 0x92800001 } },
+        /* lower_alu */
+        { "add w0, w1, #4095",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, ADD, reg_w(0), reg_w(1),
+                               new_const(JIT_REG_KIND_I32, 4095));
+          },
+          { 0x113ffc20 } },
+        { "sub w0, w1, #1",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, ADD, reg_w(0), reg_w(1),
+                               new_const(JIT_REG_KIND_I32, -1));
+          },
+          { 0x51000420 } },
+        { "movz w17, #0x1000; add w0, w1, w17",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, ADD, reg_w(0), reg_w(1),
+                               new_const(JIT_REG_KIND_I32, 4096));
+          },
+          { 0x52820011, 0x0b110020 } },
+        { "add x0, x1, #5",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, ADD, reg_x(0),
+                               new_const(JIT_REG_KIND_I64, 5), reg_x(1));
+          },
+          { 0x91001420 } },
+        { "movz x16, #5; sub x0, x16, x1",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, SUB, reg_x(0),
+                               new_const(JIT_REG_KIND_I64, 5), reg_x(1));
+          },
+          { 0xd28000b0, 0xcb010200 } },
+        { "sdiv w16, w1, w2; msub w0, w16, w2, w1",
+          [&](a64::Assembler &a) {
+              return lower_alu(cc, a, REM_S, reg_w(0), reg_w(1), reg_w(2));
+          },
+          { 0x1ac20c30, 0x1b028600 } },
+        /* lower_bit */
+        { "and w0, w1, #0xff",
+          [&](a64::Assembler &a) {
+              return lower_bit(cc, a, AND, reg_w(0), reg_w(1),
+                               new_const(JIT_REG_KIND_I32, 0xFF));
+          },
+          { 0x12001c20 } },
+        { "orr x0, x1, #0x5555555555555555",
+          [&](a64::Assembler &a) {
+              return lower_bit(cc, a, OR, reg_x(0), reg_x(1),
+                               new_const(JIT_REG_KIND_I64, 0x5555555555555555));
+          },
+          { 0xb200f020 } },
+        { "movz w17, #0x2345; movk w17, #1, lsl #16; eor w0, w1, w17",
+          [&](a64::Assembler &a) {
+              return lower_bit(cc, a, XOR, reg_w(0), reg_w(1),
+                               new_const(JIT_REG_KIND_I32, 0x12345));
+          },
+          { 0x528468b1, 0x72a00031, 0x4a110020 } },
+        /* lower_shift */
+        { "lsl w0, w1, #3",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, SHL, reg_w(0), reg_w(1),
+                                 new_const(JIT_REG_KIND_I32, 3));
+          },
+          { 0x531d7020 } },
+        { "asr x0, x1, #1",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, SHRS, reg_x(0), reg_x(1),
+                                 new_const(JIT_REG_KIND_I64, 65));
+          },
+          { 0x9341fc20 } },
+        { "ror w0, w1, #24",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, ROTL, reg_w(0), reg_w(1),
+                                 new_const(JIT_REG_KIND_I32, 8));
+          },
+          { 0x13816020 } },
+        { "lsr w0, w1, w2",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, SHRU, reg_w(0), reg_w(1), reg_w(2));
+          },
+          { 0x1ac22420 } },
+        { "neg x17, x2; ror x0, x1, x17",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, ROTL, reg_x(0), reg_x(1), reg_x(2));
+          },
+          { 0xcb0203f1, 0x9ad12c20 } },
+        { "mov w0, w1",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, SHL, reg_w(0), reg_w(1),
+                                 new_const(JIT_REG_KIND_I32, 32));
+          },
+          { 0x2a0103e0 } },
+        { "",
+          [&](a64::Assembler &a) {
+              return lower_shift(cc, a, SHL, reg_w(0), reg_w(0),
+                                 new_const(JIT_REG_KIND_I32, 0));
+          },
+          {} },
+        /* lower_cmp and lower_select */
+        { "cmp w1, #10",
+          [&](a64::Assembler &a) {
+              return lower_cmp(cc, a, cc->cmp_reg, reg_w(1),
+                               new_const(JIT_REG_KIND_I32, 10));
+          },
+          { 0x7100283f } },
+        { "cmn x1, #10",
+          [&](a64::Assembler &a) {
+              return lower_cmp(cc, a, cc->cmp_reg, reg_x(1),
+                               new_const(JIT_REG_KIND_I64, -10));
+          },
+          { 0xb100283f } },
+        { "cmp w1, w2",
+          [&](a64::Assembler &a) {
+              return lower_cmp(cc, a, cc->cmp_reg, reg_w(1), reg_w(2));
+          },
+          { 0x6b02003f } },
+        { "csel w0, w1, w2, hi",
+          [&](a64::Assembler &a) {
+              return lower_select(cc, a, GTU, reg_w(0), cc->cmp_reg, reg_w(1),
+                                  reg_w(2));
+          },
+          { 0x1a828020 } },
+        /* lower_ld and lower_st */
+        { "ldr w0, [x28, #16]",
+          [&](a64::Assembler &a) {
+              return lower_ld(cc, a, 4, false, reg_w(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 16));
+          },
+          { 0xb9401380 } },
+        { "movz x17, #18; ldr w0, [x28, x17]",
+          [&](a64::Assembler &a) {
+              return lower_ld(cc, a, 4, false, reg_w(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 18));
+          },
+          { 0xd2800251, 0xb8716b80 } },
+        { "movz x17, #0x8000; ldr x0, [x28, x17]",
+          [&](a64::Assembler &a) {
+              return lower_ld(cc, a, 8, false, reg_x(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 8 * 4096));
+          },
+          { 0xd2900011, 0xf8716b80 } },
+        { "ldrsb x0, [x28, #3]",
+          [&](a64::Assembler &a) {
+              return lower_ld(cc, a, 1, true, reg_x(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 3));
+          },
+          { 0x39800f80 } },
+        { "ldrh w0, [x28, #2]",
+          [&](a64::Assembler &a) {
+              return lower_ld(cc, a, 2, false, reg_x(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 2));
+          },
+          { 0x79400780 } },
+        { "str w0, [x28, #16]",
+          [&](a64::Assembler &a) {
+              return lower_st(cc, a, 4, false, reg_w(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 16));
+          },
+          { 0xb9001380 } },
+        { "movz w16, #5; strb w16, [x28, #1]",
+          [&](a64::Assembler &a) {
+              return lower_st(cc, a, 1, false, new_const(JIT_REG_KIND_I32, 5),
+                              reg_x(28), new_const(JIT_REG_KIND_I32, 1));
+          },
+          { 0x528000b0, 0x39000790 } },
+        { "add x17, x28, #8; stlr x0, [x17]",
+          [&](a64::Assembler &a) {
+              return lower_st(cc, a, 8, true, reg_x(0), reg_x(28),
+                              new_const(JIT_REG_KIND_I32, 8));
+          },
+          { 0x91002391, 0xc89ffe20 } },
+    };
+    std::vector<uint32> words;
+
+    for (auto &c : cases) {
+        words.clear();
+        EXPECT_TRUE(emit(c.emitter, words)) << c.insns;
+        EXPECT_EQ(words, c.words) << c.insns;
+    }
+}
+
+TEST_F(JitCodegenAArch64Test, Logical_imm)
+{
+    std::mt19937_64 rand(0);
+    std::vector<uint32> words;
+    uint64 mask, imm;
+    uint32 bits, i;
+
+    for (bits = 32; bits <= 64; bits += 32) {
+        std::set<uint64> imms = logical_imms(bits);
+
+        mask = width_mask(bits);
+        EXPECT_EQ(imms.size(), bits == 32 ? 1302U : 5334U);
+        EXPECT_FALSE(is_logical_imm(0, bits));
+        EXPECT_FALSE(is_logical_imm(mask, bits));
+
+        for (uint64 v : imms) {
+            EXPECT_TRUE(is_logical_imm(v, bits)) << std::hex << v;
+            /* The assembler encodes it into the and insn */
+            EXPECT_TRUE(emit(
+                [&](a64::Assembler &a) {
+                    if (bits == 32)
+                        a.and_(a64::w0, a64::w1, Imm(v));
+                    else
+                        a.and_(a64::x0, a64::x1, Imm(v));
+                    return true;
+                },
+                words))
+                << std::hex << v;
+            /* And the values differing in one bit are mostly not */
+            for (i = 0; i < bits; i++) {
+                imm = v ^ ((uint64)1 << i);
+                EXPECT_EQ(is_logical_imm(imm, bits), imms.count(imm) > 0)
+                    << std::hex << imm;
+            }
+        }
+
+        for (i = 0; i < 100000; i++) {
+            imm = rand() & mask;
+            EXPECT_EQ(is_logical_imm(imm, bits), imms.count(imm) > 0)
+                << std::hex << imm;
+        }
+    }
+
+    EXPECT_TRUE(is_arith_imm(0));
+    EXPECT_TRUE(is_arith_imm(4095));
+    EXPECT_FALSE(is_arith_imm(4096));
+    EXPECT_FALSE(is_arith_imm(-1));
+}
+
+TEST_F(JitCodegenAArch64Test, Mov_imm_runs)
+{
+    static const uint16 chunks[] = { 0, 0xFFFF, 0x8000, 0x7FFF };
+    std::mt19937_64 rand(0);
+    std::vector<uint64> values(test_values,
+                               test_values + sizeof(test_values)
+                                                 / sizeof(test_values[0]));
+    std::vector<uint32> words;
+    uint32 bits, i, j, zero_num, ones_num;
+    uint64 value, r;
+    NativeFunc func;
+
+    /* The values whose chunks are mostly 0, 0xFFFF or near them */
+    for (i = 0; i < 2000; i++) {
+        for (value = 0, j = 0; j < 4; j++) {
+            r = rand();
+            value |= (uint64)(r % 3 ? chunks[r % 4] : (uint16)(r >> 16))
+                     << (j * 16);
+        }
+        values.push_back(value);
+    }
+
+    for (uint64 v : values) {
+        for (bits = 32; bits <= 64; bits += 32) {
+            const a64::Gp &reg = bits == 32 ? a64::w0 : a64::x0;
+
+            value = v & width_mask(bits);
+            func = compile([&](a64::Assembler &a) {
+                mov_imm_to_gp(a, reg, v, bits);
+                return true;
+            });
+            ASSERT_TRUE(func) << std::hex << v;
+            EXPECT_EQ(func(~value, ~value), value) << std::hex << v;
+
+            /* One insn for each chunk that isn't the skipped 0 or 0xFFFF */
+            for (zero_num = ones_num = 0, j = 0; j < bits / 16; j++) {
+                zero_num += (uint16)(v >> (j * 16)) == 0;
+                ones_num += (uint16)(v >> (j * 16)) == 0xFFFF;
+            }
+            ASSERT_TRUE(emit(
+                [&](a64::Assembler &a) {
+                    mov_imm_to_gp(a, reg, v, bits);
+                    return true;
+                },
+                words));
+            EXPECT_EQ(words.size(), std::max(1U, bits / 16
+                                                     - std::max(zero_num,
+                                                                ones_num)))
+                << std::hex << v;
+        }
+    }
+}
+
+TEST_F(JitCodegenAArch64Test, Alu_runs)
+{
+    static const ALU_OP ops[] = { ADD, SUB, MUL, DIV_S, REM_S, DIV_U, REM_U };
+    uint32 kind;
+
+    for (kind = JIT_REG_KIND_I32; kind <= JIT_REG_KIND_I64; kind++) {
+        for (ALU_OP op : ops) {
+            SCOPED_TRACE(testing::Message() << "kind: " << kind
+                                            << ", alu op: " << op);
+            check_binary(
+                kind,
+                [&](a64::Assembler &a, JitReg r0, JitReg r1, JitReg r2) {
+                    return lower_alu(cc, a, op, r0, r1, r2);
+                },
+                [&](uint32 bits, uint64 x, uint64 y, uint64 *p_result) {
+                    return alu_ref(op, bits, x, y, p_result);
+                });
+        }
+    }
+}
+
+TEST_F(JitCodegenAArch64Test, Bit_runs)
+{
+    static const BIT_OP ops[] = { OR, XOR, AND };
+    uint32 kind;
+
+    for (kind = JIT_REG_KIND_I32; kind <= JIT_REG_KIND_I64; kind++) {
+        for (BIT_OP op : ops) {
+            SCOPED_TRACE(testing::Message() << "kind: " << kind
+                                            << ", bit op: " << op);
+            check_binary(
+                kind,
+                [&](a64::Assembler &a, JitReg r0, JitReg r1, JitReg r2) {
+                    return lower_bit(cc, a, op, r0, r1, r2);
+                },
+                [&](uint32 bits, uint64 x, uint64 y, uint64 *p_result) {
+                    return bit_ref(op, bits, x, y, p_result);
+                });
+        }
+    }
+}
+
+TEST_F(JitCodegenAArch64Test, Shift_runs)
+{
+    static const SHIFT_OP ops[] = { SHL, SHRS, SHRU, ROTL, ROTR };
+    uint32 kind;
+
+    for (kind = JIT_REG_KIND_I32; kind <= JIT_REG_KIND_I64; kind++) {
+        for (SHIFT_OP op : ops) {
+            SCOPED_TRACE(testing::Message() << "kind: " << kind
+                                            << ", shift op: " << op);
+            check_binary(
+                kind,
+                [&](a64::Assembler &a, JitReg r0, JitReg r1, JitReg r2) {
+                    return lower_shift(cc, a, op, r0, r1, r2);
+                },
+                [&](uint32 bits, uint64 x, uint64 y, uint64 *p_result) {
+                    return shift_ref(op, bits, x, y, p_result);
+                });
+        }
+    }
+}
+
+/* x0 = (r1 cmp r2) ? 1 : 0 with lower_cmp and lower_select, which covers
+   the condition codes of each COND_OP */
+TEST_F(JitCodegenAArch64Test, Cmp_and_select_runs)
+{
+    uint32 kind, op;
+
+    for (kind = JIT_REG_KIND_I32; kind <= JIT_REG_KIND_I64; kind++) {
+        for (op = EQ; op <= LEU; op++) {
+            SCOPED_TRACE(testing::Message() << "kind: " << kind
+                                            << ", cond op: " << op);
+            check_binary(
+                kind,
+                [&](a64::Assembler &a, JitReg r0, JitReg r1, JitReg r2) {
+                    (void)r0;
+                    return lower_cmp(cc, a, cc->cmp_reg, r1, r2)
+                           && lower_select(cc, a, (COND_OP)op, reg_x(0),
+                                           cc->cmp_reg,
+                                           new_const(JIT_REG_KIND_I64, 1),
+                                           new_const(JIT_REG_KIND_I64, 0));
+                },
+                [&](uint32 bits, uint64 x, uint64 y, uint64 *p_result) {
+                    *p_result = cond_ref((COND_OP)op, bits, x, y) ? 1 : 0;
+                    return true;
+                });
+        }
+    }
+}
+
+/* x0 = LD [x0 + offset] with the offsets encoded in the insn or moved
+   into x17, and the offset register x1 */
+TEST_F(JitCodegenAArch64Test, Load_runs)
+{
+    static const struct {
+        uint32 kind;
+        uint32 bytes;
+        bool is_signed;
+    } loads[] = {
+        { JIT_REG_KIND_I32, 1, true },  { JIT_REG_KIND_I32, 1, false },
+        { JIT_REG_KIND_I32, 2, true },  { JIT_REG_KIND_I32, 2, false },
+        { JIT_REG_KIND_I32, 4, false }, { JIT_REG_KIND_I64, 1, true },
+        { JIT_REG_KIND_I64, 1, false }, { JIT_REG_KIND_I64, 2, true },
+        { JIT_REG_KIND_I64, 2, false }, { JIT_REG_KIND_I64, 4, true },
+        { JIT_REG_KIND_I64, 4, false }, { JIT_REG_KIND_I64, 8, false },
+    };
+    static const int32 offsets[] = { 0,    1,        3,        8,
+                                     18,   4095,     8 * 4095, 8 * 4096,
+                                     -1,   -8,       -1024 };
+    static uint64 mem[8 * 1024];
+    uint8 *base = (uint8 *)mem + 1024;
+    uint64 expected;
+    NativeFunc func, func_reg;
+    uint32 i;
+
+    for (i = 0; i < sizeof(mem); i++)
+        ((uint8 *)mem)[i] = (uint8)(i * 37 + 0x81);
+
+    for (auto &ld : loads) {
+        uint32 bits = ld.kind == JIT_REG_KIND_I32 ? 32 : 64;
+        JitReg r0 = jit_reg_new(ld.kind, 0);
+
+        func_reg = compile([&](a64::Assembler &a) {
+            return lower_ld(cc, a, ld.bytes, ld.is_signed, r0, reg_x(0),
+                            reg_x(1));
+        });
+        ASSERT_TRUE(func_reg);
+
+        for (int32 offset : offsets) {
+            SCOPED_TRACE(testing::Message()
+                         << "kind: " << ld.kind << ", bytes: " << ld.bytes
+                         << ", signed: " << ld.is_signed
+                         << ", offset: " << offset);
+
+            func = compile([&](a64::Assembler &a) {
+                return lower_ld(cc, a, ld.bytes, ld.is_signed, r0, reg_x(0),
+                                new_const(JIT_REG_KIND_I32, offset));
+            });
+            ASSERT_TRUE(func);
+
+            expected = 0;
+            memcpy(&expected, base + offset, ld.bytes);
+            if (ld.is_signed && ld.bytes < 8) {
+                uint32 shift = 64 - ld.bytes * 8;
+                expected = (uint64)((int64)(expected << shift) >> shift);
+            }
+            /* Writing the w register clears the upper 32 bits */
+            expected &= width_mask(bits);
+
+            EXPECT_EQ(func((uintptr_t)base, 0), expected);
+            EXPECT_EQ(func_reg((uintptr_t)base, (uint64)(int64)offset),
+                      expected);
+        }
+    }
+}
+
+/* ST r1, [x0 + offset] with r1 of x1/w1 or a const, stores the bytes of
+   the value and keeps the neighbouring bytes */
+TEST_F(JitCodegenAArch64Test, Store_runs)
+{
+    static const struct {
+        uint32 kind;
+        uint32 bytes;
+    } stores[] = {
+        { JIT_REG_KIND_I32, 1 }, { JIT_REG_KIND_I32, 2 },
+        { JIT_REG_KIND_I32, 4 }, { JIT_REG_KIND_I64, 1 },
+        { JIT_REG_KIND_I64, 2 }, { JIT_REG_KIND_I64, 4 },
+        { JIT_REG_KIND_I64, 8 },
+    };
+    static const int32 offsets[] = { 0, 3, 8, 18, 8 * 4095, 8 * 4096, -8 };
+    static uint64 mem[8 * 1024];
+    static uint8 saved[sizeof(mem)];
+    uint8 *base = (uint8 *)mem + 1024;
+    uint64 value = 0x8192A3B4C5D6E7F8, stored;
+    NativeFunc func, func_const;
+    uint32 i;
+
+    for (i = 0; i < sizeof(mem); i++)
+        ((uint8 *)mem)[i] = (uint8)(i * 37 + 0x81);
+
+    for (auto &st : stores) {
+        JitReg r1 = jit_reg_new(st.kind, 1);
+        JitReg c = new_const(st.kind, value);
+
+        for (int32 offset : offsets) {
+            /* The store-release insns require the aligned address */
+            for (int atomic = 0; atomic < 2; atomic++) {
+                if (atomic && offset % (int32)st.bytes != 0)
+                    continue;
+
+                SCOPED_TRACE(testing::Message()
+                             << "kind: " << st.kind << ", bytes: " << st.bytes
+                             << ", offset: " << offset
+                             << ", atomic: " << atomic);
+
+                func = compile([&](a64::Assembler &a) {
+                    return lower_st(cc, a, st.bytes, atomic, r1, reg_x(0),
+                                    new_const(JIT_REG_KIND_I32, offset));
+                });
+                func_const = compile([&](a64::Assembler &a) {
+                    return lower_st(cc, a, st.bytes, atomic, c, reg_x(0),
+                                    new_const(JIT_REG_KIND_I32, offset));
+                });
+                ASSERT_TRUE(func && func_const);
+
+                for (NativeFunc f : { func, func_const }) {
+                    memcpy(saved, mem, sizeof(mem));
+                    memset(base + offset, 0, st.bytes);
+                    f((uintptr_t)base, value);
+
+                    stored = 0;
+                    memcpy(&stored, base + offset, st.bytes);
+                    EXPECT_EQ(stored, value & width_mask(st.bytes * 8));
+                    memcpy(base + offset, saved + 1024 + offset, st.bytes);
+                    EXPECT_EQ(memcmp(saved, mem, sizeof(mem)), 0);
+                }
+            }
+        }
+    }
+}
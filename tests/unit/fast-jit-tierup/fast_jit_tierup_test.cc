@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "wasm_runtime.h"
+#include "wasm_exec_env.h"
+#include "wasm_interp.h"
+#include "jit_compiler.h"
+#include "jit_codecache.h"
+
+#define TIERUP_THRESHOLD 10
+
+/* Index of the functions in tierup.wasm, the import function is 0 */
+#define FUNC_IDX_ADD 1
+#define FUNC_IDX_CALL_ADD 2
+#define FUNC_IDX_OSR_LOOP 3
+
+/* Iterations of osr_loop run by the interpreter and by the jitted code */
+static uint32 interp_iterations;
+static uint32 jitted_iterations;
+/* Whether the loop counter passed to trace was always the expected one */
+static bool trace_in_order;
+
+static void
+trace(wasm_exec_env_t exec_env, int32 i)
+{
+    WASMInterpFrame *frame =
+        (WASMInterpFrame *)((WASMExecEnv *)exec_env)->cur_frame;
+
+    if ((uint32)i != interp_iterations + jitted_iterations)
+        trace_in_order = false;
+
+    /* The interpreter pushes a frame for the import function it calls,
+       the jitted code calls the native function directly from the frame
+       of osr_loop */
+    if (frame->function->is_import_func)
+        interp_iterations++;
+    else
+        jitted_iterations++;
+}
+
+static NativeSymbol native_symbols[] = {
+    { "trace", (void *)trace, "(i)", NULL },
+};
+
+class FastJITTierupTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        std::string file;
+        uint32 wasm_file_size;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.running_mode = Mode_Fast_JIT;
+        init_args.fast_jit_tierup_threshold = TIERUP_THRESHOLD;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        is_runtime_inited = true;
+
+        ASSERT_TRUE(wasm_runtime_register_natives(
+            "env", native_symbols,
+            sizeof(native_symbols) / sizeof(NativeSymbol)));
+
+        interp_iterations = jitted_iterations = 0;
+        trace_in_order = true;
+
+        file = CWD + "/tierup.wasm";
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_TRUE(module != NULL) << error_buf;
+
+        module_inst = wasm_runtime_instantiate(module, 8192, 8192, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_TRUE(module_inst != NULL) << error_buf;
+
+        exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+        ASSERT_TRUE(exec_env != NULL);
+    }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    WASMFunction *get_func(uint32 func_idx)
+    {
+        WASMModule *wasm_module = (WASMModule *)module;
+
+        return wasm_module->functions[func_idx
+                                      - wasm_module->import_function_count];
+    }
+
+    bool is_compiled(uint32 func_idx)
+    {
+        return jit_compiler_is_compiled((WASMModule *)module, func_idx);
+    }
+
+    bool call_add(uint32 a, uint32 b, uint32 *result)
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, "call_add");
+        uint32 argv[2] = { a, b };
+
+        if (!func || !wasm_runtime_call_wasm(exec_env, func, 2, argv))
+            return false;
+        *result = argv[0];
+        return true;
+    }
+
+  public:
+    std::string CWD;
+    bool is_runtime_inited = false;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+    char error_buf[128];
+};
+
+TEST_F(FastJITTierupTest, Function_below_and_at_threshold)
+{
+    uint32 i, result;
+
+    EXPECT_FALSE(is_compiled(FUNC_IDX_ADD));
+
+    /* Each call of add from call_add is counted, the calls of call_add
+       from the host aren't */
+    for (i = 1; i < TIERUP_THRESHOLD; i++) {
+        ASSERT_TRUE(call_add(i, 100, &result));
+        EXPECT_EQ(result, i + 100);
+        EXPECT_EQ(get_func(FUNC_IDX_ADD)->fast_jit_hotness, i);
+        EXPECT_FALSE(is_compiled(FUNC_IDX_ADD));
+    }
+
+    /* The call reaching the threshold compiles add and runs its jitted
+       code */
+    ASSERT_TRUE(call_add(7, 8, &result));
+    EXPECT_EQ(result, 15u);
+    EXPECT_TRUE(is_compiled(FUNC_IDX_ADD));
+    EXPECT_FALSE(get_func(FUNC_IDX_ADD)->fast_jit_tierup_failed);
+    EXPECT_FALSE(is_compiled(FUNC_IDX_CALL_ADD));
+
+    /* The compiled function isn't counted any more */
+    ASSERT_TRUE(call_add(20, 22, &result));
+    EXPECT_EQ(result, 42u);
+    EXPECT_EQ(get_func(FUNC_IDX_ADD)->fast_jit_hotness,
+              (uint32)TIERUP_THRESHOLD);
+}
+
+TEST_F(FastJITTierupTest, OSR_at_loop_header)
+{
+    wasm_function_inst_t func =
+        wasm_runtime_lookup_function(module_inst, "osr_loop");
+    uint32 n = 100, i, argv[2] = { n }, prod = 1;
+    uint64 expected = 0, result;
+
+    for (i = 0; i < n; i++) {
+        expected += i;
+        prod *= 3;
+    }
+    expected += prod;
+
+    ASSERT_TRUE(func != NULL);
+    ASSERT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv))
+        << wasm_runtime_get_exception(module_inst);
+    memcpy(&result, argv, sizeof(uint64));
+
+    /* The function is compiled at the back edge reaching the threshold
+       and the rest of the iterations run in the jitted code, which takes
+       over the loop counter, the sum and the product from the frame */
+    EXPECT_TRUE(is_compiled(FUNC_IDX_OSR_LOOP));
+    EXPECT_GT(get_func(FUNC_IDX_OSR_LOOP)->fast_jit_osr_entry_count, 0u);
+    EXPECT_EQ(interp_iterations, (uint32)TIERUP_THRESHOLD);
+    EXPECT_EQ(jitted_iterations, n - TIERUP_THRESHOLD);
+    EXPECT_TRUE(trace_in_order);
+    EXPECT_EQ(result, expected);
+}
+
+TEST_F(FastJITTierupTest, Compile_failure_falls_back_to_interpreter)
+{
+    std::vector<void *> code_blocks;
+    uint32 size, i, result;
+    void *code;
+
+    /* Use up the code cache so that the codegen of add fails */
+    for (size = 64 * 1024; size >= 16; size /= 2) {
+        while ((code = jit_code_cache_alloc(size)))
+            code_blocks.push_back(code);
+    }
+
+    for (i = 1; i <= TIERUP_THRESHOLD; i++) {
+        ASSERT_TRUE(call_add(i, 100, &result));
+        EXPECT_EQ(result, i + 100);
+    }
+    EXPECT_FALSE(is_compiled(FUNC_IDX_ADD));
+    EXPECT_TRUE(get_func(FUNC_IDX_ADD)->fast_jit_tierup_failed);
+
+    for (i = 0; i < code_blocks.size(); i++)
+        jit_code_cache_free(code_blocks[i]);
+
+    /* The failed function keeps running in the interpreter and isn't
+       compiled again, even though the code cache has space now */
+    for (i = 0; i < TIERUP_THRESHOLD; i++) {
+        ASSERT_TRUE(call_add(i, 1, &result));
+        EXPECT_EQ(result, i + 1);
+    }
+    EXPECT_FALSE(is_compiled(FUNC_IDX_ADD));
+    EXPECT_EQ(get_func(FUNC_IDX_ADD)->fast_jit_hotness,
+              (uint32)TIERUP_THRESHOLD);
+}
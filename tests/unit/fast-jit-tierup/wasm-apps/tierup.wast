@@ -0,0 +1,51 @@
+(module
+  (import "env" "trace" (func $trace (param i32)))
+
+  (func $add (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    i32.add
+  )
+
+  ;; the calls from the host aren't counted by the tier-up, the ones of
+  ;; $add are
+  (func (export "call_add") (param i32 i32) (result i32)
+    local.get 0
+    local.get 1
+    call $add
+  )
+
+  ;; the sum of 0 .. n-1 plus 3^n, with the loop counter passed to the
+  ;; native function in each iteration
+  (func (export "osr_loop") (param $n i32) (result i64)
+    (local $i i32)
+    (local $sum i64)
+    (local $prod i32)
+    i32.const 1
+    local.set $prod
+    loop $l
+      local.get $i
+      call $trace
+      local.get $sum
+      local.get $i
+      i64.extend_i32_u
+      i64.add
+      local.set $sum
+      local.get $prod
+      i32.const 3
+      i32.mul
+      local.set $prod
+      local.get $i
+      i32.const 1
+      i32.add
+      local.tee $i
+      local.get $n
+      i32.lt_u
+      br_if $l
+    end
+    local.get $sum
+    local.get $prod
+    i64.extend_i32_u
+    i64.add
+  )
+)
@@ -0,0 +1,583 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <map>
+
+#include "jit_ir_test_helper.h"
+#include "jit_codegen.h"
+
+/* clang-format off */
+static const uint8 hreg_info_int[3][HREG_NUM] = {
+    /* 0 is the frame pointer of I64 and unused of I32, 7 is exec_env of
+       I64 and the cmp register of I32 */
+    { 1, 0, 0, 0, 0, 0, 0, 1 }, /* fixed */
+    { 0, 1, 1, 1, 0, 0, 0, 0 }, /* caller_saved_native */
+    { 0, 1, 1, 1, 1, 1, 0, 0 }  /* caller_saved_jitted */
+};
+
+static const JitHardRegInfo g_hreg_info = {
+    {
+        { 0, NULL, NULL, NULL }, /* VOID */
+
+        { HREG_NUM,              /* I32 */
+          hreg_info_int[0],
+          hreg_info_int[1],
+          hreg_info_int[2] },
+
+        { HREG_NUM,              /* I64 */
+          hreg_info_int[0],
+          hreg_info_int[1],
+          hreg_info_int[2] },
+
+        { 0, NULL, NULL, NULL }, /* F32 */
+        { 0, NULL, NULL, NULL }, /* F64 */
+        { 0, NULL, NULL, NULL }, /* V64 */
+        { 0, NULL, NULL, NULL }, /* V128 */
+        { 0, NULL, NULL, NULL }  /* V256 */
+    },
+    /* frame pointer hreg index */
+    0,
+    /* exec_env hreg index */
+    7,
+    /* cmp hreg index */
+    7
+};
+/* clang-format on */
+
+/* The codegen isn't built, the passes only need its hard registers */
+const JitHardRegInfo *
+jit_codegen_get_hreg_info()
+{
+    return &g_hreg_info;
+}
+
+uint64
+mix_native_args(const std::vector<uint64> &args)
+{
+    uint64 result = 17;
+
+    for (uint64 arg : args)
+        result = result * 31 + arg;
+    return result;
+}
+
+bool
+JitIRTest::new_cc()
+{
+    if (cc)
+        jit_cc_delete(cc);
+
+    if (!(cc = (JitCompContext *)wasm_runtime_malloc(sizeof(*cc))))
+        return false;
+    memset(cc, 0, sizeof(*cc));
+
+    if (!jit_cc_init(cc, 64)) {
+        wasm_runtime_free(cc);
+        cc = NULL;
+        return false;
+    }
+
+    cc->spill_cache_offset = SPILL_CACHE_OFFSET;
+    cc->spill_cache_size = SPILL_CACHE_SIZE;
+    cc->total_frame_size = FRAME_SIZE;
+    cc->cur_basic_block = jit_cc_entry_basic_block(cc);
+    return true;
+}
+
+JitReg
+JitIRTest::load_arg_I32(uint32 i)
+{
+    JitReg reg = jit_cc_new_reg_I32(cc);
+
+    GEN_INSN(LDI32, reg, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(i)));
+    return reg;
+}
+
+JitReg
+JitIRTest::load_arg_I64(uint32 i)
+{
+    JitReg reg = jit_cc_new_reg_I64(cc);
+
+    GEN_INSN(LDI64, reg, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(i)));
+    return reg;
+}
+
+uint32
+JitIRTest::count_insns(JitBasicBlock *block, uint32 opcode)
+{
+    JitInsn *insn;
+    uint32 num = 0;
+
+    JIT_FOREACH_INSN(block, insn)
+    {
+        if (opcode == JIT_OP_OPCODE_NUMBER || insn->opcode == opcode)
+            num++;
+    }
+    return num;
+}
+
+uint32
+JitIRTest::count_insns(uint32 opcode)
+{
+    JitBasicBlock *block;
+    unsigned label_index, end_label_index;
+    uint32 num = 0;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        num += count_insns(block, opcode);
+    }
+    return num;
+}
+
+JitInsn *
+JitIRTest::find_insn(JitBasicBlock *block, uint32 opcode, uint32 n)
+{
+    JitInsn *insn;
+
+    JIT_FOREACH_INSN(block, insn)
+    {
+        if (insn->opcode == opcode && n-- == 0)
+            return insn;
+    }
+    return NULL;
+}
+
+bool
+JitIRTest::is_allocated()
+{
+    JitBasicBlock *block;
+    JitInsn *insn;
+    JitRegVec regvec;
+    JitReg *regp;
+    unsigned label_index, end_label_index, i;
+
+    JIT_FOREACH_BLOCK_ENTRY_EXIT(cc, label_index, end_label_index, block)
+    {
+        JIT_FOREACH_INSN(block, insn)
+        {
+            regvec = jit_insn_opnd_regs(insn);
+            JIT_REG_VEC_FOREACH(regvec, i, regp)
+            {
+                if (jit_reg_is_variable(*regp)
+                    && !jit_reg_is_kind(L32, *regp)
+                    && !jit_cc_is_hreg(cc, *regp))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* The operands of the last CMP */
+typedef struct CmpOperands {
+    uint64 a;
+    uint64 b;
+    bool is_i64;
+} CmpOperands;
+
+/* The state of the IR being interpreted */
+class JitIRRunner
+{
+  public:
+    JitIRRunner(JitCompContext *cc, const std::vector<uint64> &args)
+      : cc(cc)
+      , frame(FRAME_SIZE, 0xcc)
+      , is_frame_set(FRAME_SIZE, false)
+    {
+        uint32 i, j;
+
+        for (i = 0; i < args.size(); i++) {
+            for (j = 0; j < 8; j++) {
+                frame[ARG_OFFSET(i) + j] = (uint8)(args[i] >> (8 * j));
+                is_frame_set[ARG_OFFSET(i) + j] = true;
+            }
+        }
+    }
+
+    bool read(JitReg reg, uint64 *p_value)
+    {
+        std::map<JitReg, uint64>::iterator it;
+
+        if (jit_reg_is_const(reg)) {
+            if (jit_reg_is_kind(I32, reg))
+                *p_value = (uint32)jit_cc_get_const_I32(cc, reg);
+            else if (jit_reg_is_kind(I64, reg))
+                *p_value = (uint64)jit_cc_get_const_I64(cc, reg);
+            else
+                return fail("unsupported constant kind");
+            return true;
+        }
+
+        if ((it = regs.find(reg)) == regs.end())
+            return fail("register " + reg_name(reg) + " is read before set");
+        *p_value = it->second;
+        return true;
+    }
+
+    void write(JitReg reg, uint64 value)
+    {
+        regs[reg] = jit_reg_is_kind(I32, reg) ? (uint32)value : value;
+    }
+
+    bool frame_offset(JitReg base, JitReg offset, uint32 bytes,
+                      uint32 *p_offset)
+    {
+        uint64 value;
+
+        if (base != cc->fp_reg || !jit_reg_is_const(offset))
+            return fail("only the frame can be accessed");
+        if (!read(offset, &value))
+            return false;
+        if (value + bytes > FRAME_SIZE)
+            return fail("frame access out of range");
+        *p_offset = (uint32)value;
+        return true;
+    }
+
+    bool load(JitInsn *insn, uint32 bytes)
+    {
+        uint64 value = 0;
+        uint32 offset, i;
+
+        if (!frame_offset(*jit_insn_opnd(insn, 1), *jit_insn_opnd(insn, 2),
+                          bytes, &offset))
+            return false;
+
+        for (i = 0; i < bytes; i++) {
+            if (!is_frame_set[offset + i])
+                return fail("frame is read before set at "
+                            + std::to_string(offset + i));
+            value |= (uint64)frame[offset + i] << (8 * i);
+        }
+        write(*jit_insn_opnd(insn, 0), value);
+        return true;
+    }
+
+    bool store(JitInsn *insn, uint32 bytes)
+    {
+        uint64 value;
+        uint32 offset, i;
+
+        if (!read(*jit_insn_opnd(insn, 0), &value)
+            || !frame_offset(*jit_insn_opnd(insn, 1), *jit_insn_opnd(insn, 2),
+                             bytes, &offset))
+            return false;
+
+        for (i = 0; i < bytes; i++) {
+            frame[offset + i] = (uint8)(value >> (8 * i));
+            is_frame_set[offset + i] = true;
+        }
+        return true;
+    }
+
+    bool unary(JitInsn *insn)
+    {
+        JitReg dst = *jit_insn_opnd(insn, 0);
+        uint64 a;
+
+        if (!read(*jit_insn_opnd(insn, 1), &a))
+            return false;
+
+        switch (insn->opcode) {
+            case JIT_OP_MOV:
+                break;
+            case JIT_OP_NEG:
+                a = (uint64)0 - a;
+                break;
+            case JIT_OP_NOT:
+                a = ~a;
+                break;
+            case JIT_OP_I32TOI64:
+                a = (uint64)(int64)(int32)(uint32)a;
+                break;
+            case JIT_OP_U32TOI64:
+                a = (uint32)a;
+                break;
+            case JIT_OP_I64TOI32:
+                a = (uint32)a;
+                break;
+            default:
+                return fail("unsupported unary opcode");
+        }
+        write(dst, a);
+        return true;
+    }
+
+    bool binary(JitInsn *insn)
+    {
+        JitReg dst = *jit_insn_opnd(insn, 0);
+        bool is_i64 = jit_reg_is_kind(I64, dst);
+        uint32 bits = is_i64 ? 64 : 32;
+        uint64 a, b, result;
+
+        if (!read(*jit_insn_opnd(insn, 1), &a)
+            || !read(*jit_insn_opnd(insn, 2), &b))
+            return false;
+
+        switch (insn->opcode) {
+            case JIT_OP_ADD:
+                result = a + b;
+                break;
+            case JIT_OP_SUB:
+                result = a - b;
+                break;
+            case JIT_OP_MUL:
+                result = a * b;
+                break;
+            case JIT_OP_AND:
+                result = a & b;
+                break;
+            case JIT_OP_OR:
+                result = a | b;
+                break;
+            case JIT_OP_XOR:
+                result = a ^ b;
+                break;
+            case JIT_OP_SHL:
+                result = a << (b % bits);
+                break;
+            case JIT_OP_SHRS:
+                result = is_i64 ? (uint64)((int64)a >> (b % bits))
+                                : (uint64)(uint32)((int32)a >> (b % bits));
+                break;
+            case JIT_OP_SHRU:
+                result = (is_i64 ? a : (uint32)a) >> (b % bits);
+                break;
+            default:
+                return fail("unsupported binary opcode");
+        }
+        write(dst, result);
+        return true;
+    }
+
+    bool cmp(JitInsn *insn)
+    {
+        JitReg r1 = *jit_insn_opnd(insn, 1);
+        CmpOperands operands;
+
+        if (!read(r1, &operands.a)
+            || !read(*jit_insn_opnd(insn, 2), &operands.b))
+            return false;
+        operands.is_i64 = jit_reg_is_kind(I64, r1);
+        cmps[*jit_insn_opnd(insn, 0)] = operands;
+        return true;
+    }
+
+    /* Evaluate the condition of the branch, whose CMP must be run */
+    bool eval_cond(JitInsn *insn, bool *p_cond)
+    {
+        std::map<JitReg, CmpOperands>::iterator it;
+        int64 sa, sb;
+        uint64 ua, ub;
+
+        if ((it = cmps.find(*jit_insn_opnd(insn, 0))) == cmps.end())
+            return fail("branch without CMP");
+
+        ua = it->second.a;
+        ub = it->second.b;
+        sa = it->second.is_i64 ? (int64)ua : (int64)(int32)(uint32)ua;
+        sb = it->second.is_i64 ? (int64)ub : (int64)(int32)(uint32)ub;
+
+        switch (insn->opcode) {
+            case JIT_OP_BEQ:
+                *p_cond = ua == ub;
+                break;
+            case JIT_OP_BNE:
+                *p_cond = ua != ub;
+                break;
+            case JIT_OP_BGTS:
+                *p_cond = sa > sb;
+                break;
+            case JIT_OP_BGES:
+                *p_cond = sa >= sb;
+                break;
+            case JIT_OP_BLTS:
+                *p_cond = sa < sb;
+                break;
+            case JIT_OP_BLES:
+                *p_cond = sa <= sb;
+                break;
+            case JIT_OP_BGTU:
+                *p_cond = ua > ub;
+                break;
+            case JIT_OP_BGEU:
+                *p_cond = ua >= ub;
+                break;
+            case JIT_OP_BLTU:
+                *p_cond = ua < ub;
+                break;
+            case JIT_OP_BLEU:
+                *p_cond = ua <= ub;
+                break;
+            default:
+                return fail("unsupported branch opcode");
+        }
+        return true;
+    }
+
+    bool call_native(JitInsn *insn, uint32 *p_call_num)
+    {
+        JitReg res = *jit_insn_opndv(insn, 0);
+        std::vector<uint64> args;
+        uint64 func, value;
+        uint32 i, j, kind;
+
+        if (!jit_reg_is_const(*jit_insn_opndv(insn, 1))
+            || !read(*jit_insn_opndv(insn, 1), &func)
+            || func != NATIVE_FUNC_MIX)
+            return fail("unknown native function");
+
+        for (i = 2; i < jit_insn_opndv_num(insn); i++) {
+            if (!read(*jit_insn_opndv(insn, i), &value))
+                return false;
+            args.push_back(value);
+        }
+
+        /* The callee may overwrite the caller-saved registers */
+        for (kind = JIT_REG_KIND_VOID; kind < JIT_REG_KIND_L32; kind++)
+            for (j = 0; j < jit_cc_hreg_num(cc, kind); j++) {
+                JitReg hreg = jit_reg_new(kind, j);
+                if (jit_cc_is_hreg_caller_saved_native(cc, hreg))
+                    regs.erase(hreg);
+            }
+
+        if (res)
+            write(res, mix_native_args(args));
+        (*p_call_num)++;
+        return true;
+    }
+
+    bool fail(const std::string &reason)
+    {
+        error = reason;
+        return false;
+    }
+
+    std::string reg_name(JitReg reg)
+    {
+        static const char *kinds[] = { "v", "i", "I", "f", "D", "V", "W", "X" };
+        std::string name = jit_reg_kind(reg) < 8 ? kinds[jit_reg_kind(reg)]
+                                                 : "L";
+
+        return name + std::to_string(jit_reg_no(reg));
+    }
+
+  public:
+    JitCompContext *cc;
+    std::map<JitReg, uint64> regs;
+    std::map<JitReg, CmpOperands> cmps;
+    std::vector<uint8> frame;
+    std::vector<bool> is_frame_set;
+    std::string error;
+};
+
+/* The max number of the instructions run, to stop endless loops */
+#define RUN_INSN_MAX_NUM 1000000
+
+bool
+JitIRTest::run(const std::vector<uint64> &args, uint64 *p_result)
+{
+    JitIRRunner runner(cc, args);
+    JitBasicBlock *block = jit_cc_entry_basic_block(cc);
+    JitInsn *insn = jit_basic_block_first_insn(block);
+    JitReg target;
+    uint32 insn_num;
+    bool cond, ok;
+
+    native_call_num = 0;
+
+    for (insn_num = 0; insn_num < RUN_INSN_MAX_NUM; insn_num++) {
+        if (insn == jit_basic_block_end_insn(block)) {
+            run_error = "fall through the end of a block";
+            return false;
+        }
+
+        target = 0;
+
+        switch (insn->opcode) {
+            case JIT_OP_MOV:
+            case JIT_OP_NEG:
+            case JIT_OP_NOT:
+            case JIT_OP_I32TOI64:
+            case JIT_OP_U32TOI64:
+            case JIT_OP_I64TOI32:
+                ok = runner.unary(insn);
+                break;
+            case JIT_OP_ADD:
+            case JIT_OP_SUB:
+            case JIT_OP_MUL:
+            case JIT_OP_AND:
+            case JIT_OP_OR:
+            case JIT_OP_XOR:
+            case JIT_OP_SHL:
+            case JIT_OP_SHRS:
+            case JIT_OP_SHRU:
+                ok = runner.binary(insn);
+                break;
+            case JIT_OP_CMP:
+                ok = runner.cmp(insn);
+                break;
+            case JIT_OP_LDI32:
+                ok = runner.load(insn, 4);
+                break;
+            case JIT_OP_LDI64:
+                ok = runner.load(insn, 8);
+                break;
+            case JIT_OP_STI32:
+                ok = runner.store(insn, 4);
+                break;
+            case JIT_OP_STI64:
+                ok = runner.store(insn, 8);
+                break;
+            case JIT_OP_CALLNATIVE:
+                ok = runner.call_native(insn, &native_call_num);
+                break;
+            case JIT_OP_JMP:
+                target = *jit_insn_opnd(insn, 0);
+                ok = true;
+                break;
+            case JIT_OP_BEQ:
+            case JIT_OP_BNE:
+            case JIT_OP_BGTS:
+            case JIT_OP_BGES:
+            case JIT_OP_BLTS:
+            case JIT_OP_BLES:
+            case JIT_OP_BGTU:
+            case JIT_OP_BGEU:
+            case JIT_OP_BLTU:
+            case JIT_OP_BLEU:
+                /* A branch to label 0 falls through */
+                if ((ok = runner.eval_cond(insn, &cond)))
+                    target = *jit_insn_opnd(insn, cond ? 1 : 2);
+                break;
+            case JIT_OP_RETURN:
+                if (!runner.read(*jit_insn_opnd(insn, 0), p_result)) {
+                    run_error = runner.error;
+                    return false;
+                }
+                return true;
+            default:
+                ok = runner.fail("unsupported opcode "
+                                 + std::to_string(insn->opcode));
+                break;
+        }
+
+        if (!ok) {
+            run_error = runner.error;
+            return false;
+        }
+
+        if (target) {
+            block = *(jit_annl_basic_block(cc, target));
+            insn = jit_basic_block_first_insn(block);
+        }
+        else
+            insn = insn->next;
+    }
+
+    run_error = "too many instructions run";
+    return false;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "jit_compiler.h"
+#include "jit_ir.h"
+#include "jit_utils.h"
+
+/* The ARG_NUM arguments of the IR functions are loaded from the frame
+   at ARG_OFFSET(i), which are followed by the spill slots */
+#define ARG_NUM 8
+#define ARG_OFFSET(i) ((i) * 8)
+#define SPILL_CACHE_OFFSET ARG_OFFSET(ARG_NUM)
+#define SPILL_CACHE_SIZE 256
+#define FRAME_SIZE (SPILL_CACHE_OFFSET + SPILL_CACHE_SIZE)
+
+/* The hard registers of the fake register file of the test, there are
+   HREG_NUM I32 and I64 registers, HREG_FIRST to HREG_LAST are
+   allocated, the ones up to HREG_LAST_CALLER_SAVED are caller-saved in
+   the native ABI */
+#define HREG_NUM 8
+#define HREG_FIRST 1
+#define HREG_LAST 6
+#define HREG_LAST_CALLER_SAVED 3
+
+/* The native function called by the CALLNATIVE instructions of the IR,
+   which returns an expression of its arguments, see mix_native_args */
+#define NATIVE_FUNC_MIX 0x1234
+
+uint64
+mix_native_args(const std::vector<uint64> &args);
+
+class JitIRTest : public testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        is_runtime_inited = true;
+
+        ASSERT_TRUE(new_cc());
+    }
+
+    void TearDown()
+    {
+        if (cc)
+            jit_cc_delete(cc);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    /* Replace the compilation context with an empty one, whose current
+       block is the entry block */
+    bool new_cc();
+
+    JitBasicBlock *new_block() { return jit_cc_new_basic_block(cc, 0); }
+
+    void set_block(JitBasicBlock *block) { cc->cur_basic_block = block; }
+
+    JitReg label_of(JitBasicBlock *block)
+    {
+        return jit_basic_block_label(block);
+    }
+
+    /* Load the i-th argument to a new register in the current block */
+    JitReg load_arg_I32(uint32 i);
+    JitReg load_arg_I64(uint32 i);
+
+    /* Number of the instructions with the opcode in all blocks, or of
+       all instructions if opcode is JIT_OP_OPCODE_NUMBER */
+    uint32 count_insns(uint32 opcode = JIT_OP_OPCODE_NUMBER);
+    uint32 count_insns(JitBasicBlock *block,
+                       uint32 opcode = JIT_OP_OPCODE_NUMBER);
+
+    /* The n-th instruction with the opcode in the block */
+    JitInsn *find_insn(JitBasicBlock *block, uint32 opcode, uint32 n = 0);
+
+    /* Whether all the variable registers in the IR are hard registers */
+    bool is_allocated();
+
+    /* Interpret the IR with the arguments and return the result of
+       RETURN, the reason is set to run_error if it fails. The frame and
+       the hard registers not written yet are undefined, and so are the
+       caller-saved hard registers after a CALLNATIVE, reading them
+       fails the run. */
+    bool run(const std::vector<uint64> &args, uint64 *p_result);
+
+    /* Run the IR and return its result, which is checked to succeed */
+    uint64 run_ok(const std::vector<uint64> &args)
+    {
+        uint64 result = 0;
+
+        EXPECT_TRUE(run(args, &result)) << run_error;
+        return result;
+    }
+
+  public:
+    bool is_runtime_inited = false;
+    JitCompContext *cc = NULL;
+    std::string run_error;
+    uint32 native_call_num = 0;
+};
@@ -0,0 +1,605 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <climits>
+
+#include "jit_ir_test_helper.h"
+
+class JitOptimizeTest : public JitIRTest
+{
+  public:
+    /* Run the optimization passes of the opt level in the order of the
+       compiler, see jit_compiler_init() */
+    bool optimize(uint32 opt_level)
+    {
+        if (opt_level >= 1
+            && (!jit_pass_const_prop(cc) || !jit_pass_copy_prop(cc)))
+            return false;
+        if (opt_level >= 2
+            && (!jit_pass_cse(cc) || !jit_pass_bounds_check_elim(cc)))
+            return false;
+        if (opt_level >= 1 && !jit_pass_dce(cc))
+            return false;
+        return !jit_get_last_error(cc);
+    }
+
+    JitInsn *gen_binary(uint32 opcode, JitReg dst, JitReg r1, JitReg r2)
+    {
+        switch (opcode) {
+#define CASE_BINARY(NAME) \
+    case JIT_OP_##NAME:   \
+        return GEN_INSN(NAME, dst, r1, r2);
+            CASE_BINARY(ADD)
+            CASE_BINARY(SUB)
+            CASE_BINARY(MUL)
+            CASE_BINARY(AND)
+            CASE_BINARY(OR)
+            CASE_BINARY(XOR)
+            CASE_BINARY(SHL)
+            CASE_BINARY(SHRS)
+            CASE_BINARY(SHRU)
+#undef CASE_BINARY
+            default:
+                return NULL;
+        }
+    }
+
+    JitInsn *gen_unary(uint32 opcode, JitReg dst, JitReg r1)
+    {
+        switch (opcode) {
+#define CASE_UNARY(NAME) \
+    case JIT_OP_##NAME:  \
+        return GEN_INSN(NAME, dst, r1);
+            CASE_UNARY(NEG)
+            CASE_UNARY(NOT)
+            CASE_UNARY(I32TOI64)
+            CASE_UNARY(U32TOI64)
+            CASE_UNARY(I64TOI32)
+#undef CASE_UNARY
+            default:
+                return NULL;
+        }
+    }
+
+    JitReg new_const(unsigned kind, uint64 value)
+    {
+        return kind == JIT_REG_KIND_I32 ? NEW_CONST(I32, (int32)value)
+                                        : NEW_CONST(I64, (int64)value);
+    }
+
+    /* Emit OP d, a, b with a and b moved from the constants, and return
+       d */
+    void gen_binary_of_movs(uint32 opcode, unsigned kind, uint64 v1,
+                            uint64 v2)
+    {
+        JitReg a = jit_cc_new_reg(cc, kind), b = jit_cc_new_reg(cc, kind);
+        JitReg d = jit_cc_new_reg(cc, kind);
+
+        GEN_INSN(MOV, a, new_const(kind, v1));
+        GEN_INSN(MOV, b, new_const(kind, v2));
+        gen_binary(opcode, d, a, b);
+        GEN_INSN(RETURN, d);
+    }
+
+    /* Check that the instruction defining the result of RETURN is folded
+       into a MOV of the constant computed when running the IR */
+    void check_folded(uint32 opcode, uint64 expected)
+    {
+        JitBasicBlock *entry = jit_cc_entry_basic_block(cc);
+        JitInsn *ret = find_insn(entry, JIT_OP_RETURN);
+        JitInsn *mov;
+        JitReg c;
+
+        ASSERT_TRUE(optimize(1));
+        EXPECT_EQ(count_insns(opcode), 0U);
+        ASSERT_EQ(count_insns(entry), 2U);
+
+        ASSERT_TRUE(mov = find_insn(entry, JIT_OP_MOV));
+        EXPECT_EQ(*jit_insn_opnd(mov, 0), *jit_insn_opnd(ret, 0));
+        c = *jit_insn_opnd(mov, 1);
+        ASSERT_TRUE(jit_reg_is_const(c));
+        if (jit_reg_is_kind(I32, c))
+            EXPECT_EQ((uint32)jit_cc_get_const_I32(cc, c), expected);
+        else
+            EXPECT_EQ((uint64)jit_cc_get_const_I64(cc, c), expected);
+
+        EXPECT_EQ(run_ok({}), expected);
+    }
+
+    /* Emit a boundary check of the linear memory as check_and_seek()
+       does, and return the check */
+    JitInsn *gen_bounds_check(JitReg wasm_addr, uint64 offset, JitReg bound,
+                              JitReg exce_label)
+    {
+        JitReg addr = jit_cc_new_reg_I64(cc);
+        JitReg offset1 = jit_cc_new_reg_I64(cc);
+        JitInsn *insn;
+
+        GEN_INSN(U32TOI64, addr, wasm_addr);
+        GEN_INSN(ADD, offset1, NEW_CONST(I64, offset), addr);
+        insn = GEN_INSN(CMP, cc->cmp_reg, offset1, bound);
+        GEN_INSN(BGTU, cc->cmp_reg, exce_label, 0);
+        return insn;
+    }
+
+    /* Build the loop below, whose locals i and sum are kept in the frame
+       as the frontend does, and the body has constant, copied and common
+       subexpressions:
+           for (i = 0; i < n; i++)
+               sum += (i * 3 + 7) + ((i * 3 + 7) >> 1);
+     */
+    void build_loop()
+    {
+        JitBasicBlock *head = new_block(), *body = new_block();
+        JitBasicBlock *done = new_block();
+        JitReg n, i, i_next, sum, c3, c4, k, t1, t2, t3, t4, t5, t6, t7;
+        JitReg i_offset = NEW_CONST(I32, ARG_OFFSET(1));
+        JitReg sum_offset = NEW_CONST(I32, ARG_OFFSET(2));
+
+        GEN_INSN(STI32, NEW_CONST(I32, 0), cc->fp_reg, i_offset);
+        GEN_INSN(STI32, NEW_CONST(I32, 0), cc->fp_reg, sum_offset);
+        GEN_INSN(JMP, label_of(head));
+
+        set_block(head);
+        n = load_arg_I32(0);
+        i = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDI32, i, cc->fp_reg, i_offset);
+        GEN_INSN(CMP, cc->cmp_reg, i, n);
+        GEN_INSN(BGES, cc->cmp_reg, label_of(done), label_of(body));
+
+        set_block(body);
+        i = jit_cc_new_reg_I32(cc);
+        i_next = jit_cc_new_reg_I32(cc);
+        sum = jit_cc_new_reg_I32(cc);
+        c3 = jit_cc_new_reg_I32(cc);
+        c4 = jit_cc_new_reg_I32(cc);
+        k = jit_cc_new_reg_I32(cc);
+        t1 = jit_cc_new_reg_I32(cc);
+        t2 = jit_cc_new_reg_I32(cc);
+        t3 = jit_cc_new_reg_I32(cc);
+        t4 = jit_cc_new_reg_I32(cc);
+        t5 = jit_cc_new_reg_I32(cc);
+        t6 = jit_cc_new_reg_I32(cc);
+        t7 = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDI32, i, cc->fp_reg, i_offset);
+        GEN_INSN(LDI32, sum, cc->fp_reg, sum_offset);
+        GEN_INSN(MOV, c3, NEW_CONST(I32, 3));
+        GEN_INSN(MOV, c4, NEW_CONST(I32, 4));
+        GEN_INSN(ADD, k, c3, c4);
+        GEN_INSN(MUL, t1, i, c3);
+        GEN_INSN(ADD, t2, t1, k);
+        GEN_INSN(MUL, t3, i, c3);
+        GEN_INSN(ADD, t4, t3, k);
+        GEN_INSN(MOV, t5, t4);
+        GEN_INSN(SHRU, t6, t5, NEW_CONST(I32, 1));
+        GEN_INSN(ADD, t7, t2, t6);
+        GEN_INSN(ADD, t7, t7, sum);
+        GEN_INSN(STI32, t7, cc->fp_reg, sum_offset);
+        GEN_INSN(ADD, i_next, i, NEW_CONST(I32, 1));
+        GEN_INSN(STI32, i_next, cc->fp_reg, i_offset);
+        GEN_INSN(JMP, label_of(head));
+
+        set_block(done);
+        sum = jit_cc_new_reg_I32(cc);
+        GEN_INSN(LDI32, sum, cc->fp_reg, sum_offset);
+        GEN_INSN(RETURN, sum);
+    }
+};
+
+TEST_F(JitOptimizeTest, Const_prop_fold_binary)
+{
+    static const uint32 opcodes[] = { JIT_OP_ADD, JIT_OP_SUB,  JIT_OP_MUL,
+                                      JIT_OP_AND, JIT_OP_OR,   JIT_OP_XOR,
+                                      JIT_OP_SHL, JIT_OP_SHRS, JIT_OP_SHRU };
+    static const uint64 values[][2] = {
+        { 7, 3 },
+        { (uint64)-1, 1 },
+        { INT32_MAX, 1 },
+        { 0x80000000, 33 },
+        { (uint64)-8, 65 },
+        { 0x123456789abcdefULL, 0xfedcba987654321ULL },
+    };
+    static const unsigned kinds[] = { JIT_REG_KIND_I32, JIT_REG_KIND_I64 };
+    JitReg d;
+    uint64 expected;
+
+    for (unsigned kind : kinds) {
+        for (uint32 opcode : opcodes) {
+            for (const uint64 *value : values) {
+                SCOPED_TRACE(testing::Message()
+                             << "opcode " << opcode << ", kind " << kind
+                             << ", " << value[0] << ", " << value[1]);
+
+                /* the operands are constants */
+                ASSERT_TRUE(new_cc());
+                d = jit_cc_new_reg(cc, kind);
+                ASSERT_TRUE(gen_binary(opcode, d, new_const(kind, value[0]),
+                                       new_const(kind, value[1])));
+                GEN_INSN(RETURN, d);
+                expected = run_ok({});
+                check_folded(opcode, expected);
+
+                /* the operands are moved from constants */
+                if (opcode == JIT_OP_SHL || opcode == JIT_OP_SHRS
+                    || opcode == JIT_OP_SHRU)
+                    continue;
+                ASSERT_TRUE(new_cc());
+                gen_binary_of_movs(opcode, kind, value[0], value[1]);
+                EXPECT_EQ(run_ok({}), expected);
+                check_folded(opcode, expected);
+            }
+        }
+    }
+}
+
+TEST_F(JitOptimizeTest, Const_prop_fold_unary)
+{
+    static const struct {
+        uint32 opcode;
+        unsigned dst_kind, src_kind;
+        uint64 value, expected;
+    } cases[] = {
+        { JIT_OP_NEG, JIT_REG_KIND_I32, JIT_REG_KIND_I32, 5, 0xfffffffb },
+        { JIT_OP_NEG, JIT_REG_KIND_I64, JIT_REG_KIND_I64, 5,
+          0xfffffffffffffffbULL },
+        { JIT_OP_NOT, JIT_REG_KIND_I32, JIT_REG_KIND_I32, 0xf0, 0xffffff0f },
+        { JIT_OP_I32TOI64, JIT_REG_KIND_I64, JIT_REG_KIND_I32, 0xfffffffe,
+          0xfffffffffffffffeULL },
+        { JIT_OP_U32TOI64, JIT_REG_KIND_I64, JIT_REG_KIND_I32, 0xfffffffe,
+          0xfffffffe },
+        { JIT_OP_I64TOI32, JIT_REG_KIND_I32, JIT_REG_KIND_I64,
+          0x123456789ULL, 0x23456789 },
+    };
+    JitReg d;
+
+    /* The operands of the unary instructions aren't propagated, they are
+       folded when the frontend emits them with constants */
+    for (const auto &c : cases) {
+        ASSERT_TRUE(new_cc());
+        d = jit_cc_new_reg(cc, c.dst_kind);
+        ASSERT_TRUE(gen_unary(c.opcode, d, new_const(c.src_kind, c.value)));
+        GEN_INSN(RETURN, d);
+
+        SCOPED_TRACE(testing::Message() << "opcode " << c.opcode);
+        ASSERT_EQ(run_ok({}), c.expected);
+        check_folded(c.opcode, c.expected);
+    }
+}
+
+TEST_F(JitOptimizeTest, Const_prop_fold_edge_cases)
+{
+    static const struct {
+        uint32 opcode;
+        unsigned kind;
+        uint64 a, b, expected;
+    } cases[] = {
+        /* wrap around of i32 */
+        { JIT_OP_ADD, JIT_REG_KIND_I32, INT32_MAX, 1, 0x80000000 },
+        { JIT_OP_MUL, JIT_REG_KIND_I32, 0x10000, 0x10000, 0 },
+        /* the shift count is taken modulo the bit width */
+        { JIT_OP_SHL, JIT_REG_KIND_I32, 1, 33, 2 },
+        { JIT_OP_SHL, JIT_REG_KIND_I64, 1, 65, 2 },
+        { JIT_OP_SHRS, JIT_REG_KIND_I32, (uint64)-8, 1, 0xfffffffc },
+        { JIT_OP_SHRU, JIT_REG_KIND_I32, (uint64)-8, 1, 0x7ffffffc },
+        { JIT_OP_SHRS, JIT_REG_KIND_I64, (uint64)-8, 65,
+          0xfffffffffffffffcULL },
+    };
+    JitReg d;
+
+    for (const auto &c : cases) {
+        ASSERT_TRUE(new_cc());
+        d = jit_cc_new_reg(cc, c.kind);
+        ASSERT_TRUE(gen_binary(c.opcode, d, new_const(c.kind, c.a),
+                               new_const(c.kind, c.b)));
+        GEN_INSN(RETURN, d);
+
+        SCOPED_TRACE(testing::Message() << "opcode " << c.opcode);
+        ASSERT_EQ(run_ok({}), c.expected);
+        check_folded(c.opcode, c.expected);
+    }
+}
+
+TEST_F(JitOptimizeTest, Const_prop_keeps_non_constants)
+{
+    JitBasicBlock *entry = jit_cc_entry_basic_block(cc);
+    JitBasicBlock *next = new_block();
+    JitReg a = jit_cc_new_reg_I32(cc), b = jit_cc_new_reg_I32(cc);
+    JitReg c = jit_cc_new_reg_I32(cc), d = jit_cc_new_reg_I32(cc);
+    JitReg e = jit_cc_new_reg_I32(cc), f = jit_cc_new_reg_I32(cc);
+    JitReg g = jit_cc_new_reg_I32(cc);
+    JitInsn *add_a, *add_c, *store;
+
+    /* a is defined twice, c is used in another block, and the value
+       stored can't be a constant */
+    GEN_INSN(MOV, a, NEW_CONST(I32, 1));
+    GEN_INSN(ADD, a, a, NEW_CONST(I32, 1));
+    add_a = GEN_INSN(ADD, b, a, NEW_CONST(I32, 10));
+    GEN_INSN(MOV, c, NEW_CONST(I32, 5));
+    GEN_INSN(MOV, d, NEW_CONST(I32, 42));
+    store = GEN_INSN(STI32, d, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(1)));
+    GEN_INSN(JMP, label_of(next));
+
+    set_block(next);
+    add_c = GEN_INSN(ADD, e, c, b);
+    GEN_INSN(LDI32, f, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(1)));
+    GEN_INSN(ADD, g, e, f);
+    GEN_INSN(RETURN, g);
+
+    ASSERT_EQ(run_ok({}), 59U);
+    ASSERT_TRUE(optimize(1));
+    EXPECT_EQ(*jit_insn_opnd(add_a, 1), a);
+    EXPECT_EQ(*jit_insn_opnd(add_c, 1), c);
+    EXPECT_EQ(*jit_insn_opnd(store, 0), d);
+    EXPECT_EQ(count_insns(entry, JIT_OP_STI32), 1U);
+    EXPECT_EQ(run_ok({}), 59U);
+}
+
+TEST_F(JitOptimizeTest, Copy_prop)
+{
+    JitReg x = load_arg_I32(0), y = jit_cc_new_reg_I32(cc);
+    JitReg z = jit_cc_new_reg_I32(cc), s = jit_cc_new_reg_I32(cc);
+    JitInsn *add;
+
+    GEN_INSN(MOV, y, x);
+    GEN_INSN(MOV, z, y);
+    add = GEN_INSN(ADD, s, z, z);
+    GEN_INSN(RETURN, s);
+
+    ASSERT_EQ(run_ok({ 5 }), 10U);
+    ASSERT_TRUE(optimize(1));
+    /* The chain of copies is replaced with its source, and the copies
+       are removed */
+    EXPECT_EQ(*jit_insn_opnd(add, 1), x);
+    EXPECT_EQ(*jit_insn_opnd(add, 2), x);
+    EXPECT_EQ(count_insns(JIT_OP_MOV), 0U);
+    EXPECT_EQ(run_ok({ 5 }), 10U);
+}
+
+TEST_F(JitOptimizeTest, Copy_prop_keeps_changed_source)
+{
+    JitReg x = load_arg_I32(0), y = jit_cc_new_reg_I32(cc);
+    JitReg s = jit_cc_new_reg_I32(cc);
+    JitInsn *add;
+
+    /* The source is changed after the copy */
+    GEN_INSN(MOV, y, x);
+    GEN_INSN(ADD, x, x, NEW_CONST(I32, 1));
+    add = GEN_INSN(ADD, s, y, x);
+    GEN_INSN(RETURN, s);
+
+    ASSERT_EQ(run_ok({ 5 }), 11U);
+    ASSERT_TRUE(optimize(1));
+    EXPECT_EQ(*jit_insn_opnd(add, 1), y);
+    EXPECT_EQ(run_ok({ 5 }), 11U);
+}
+
+TEST_F(JitOptimizeTest, Cse)
+{
+    JitBasicBlock *entry = jit_cc_entry_basic_block(cc);
+    JitBasicBlock *next = new_block();
+    JitReg a = load_arg_I32(0), b = load_arg_I32(1);
+    JitReg x = jit_cc_new_reg_I32(cc), y = jit_cc_new_reg_I32(cc);
+    JitReg z = jit_cc_new_reg_I32(cc), u = jit_cc_new_reg_I32(cc);
+    JitReg v = jit_cc_new_reg_I32(cc), w = jit_cc_new_reg_I32(cc);
+    JitReg l1 = jit_cc_new_reg_I32(cc), l2 = jit_cc_new_reg_I32(cc);
+    JitReg p = jit_cc_new_reg_I32(cc), q = jit_cc_new_reg_I32(cc);
+    JitReg r = jit_cc_new_reg_I32(cc);
+    JitReg offset = NEW_CONST(I32, ARG_OFFSET(2));
+    JitInsn *mul;
+
+    GEN_INSN(ADD, x, a, b);
+    GEN_INSN(ADD, y, a, b);
+    mul = GEN_INSN(MUL, z, x, y);
+    /* the operands in another order are a different expression */
+    GEN_INSN(SUB, u, a, b);
+    GEN_INSN(SUB, v, b, a);
+    GEN_INSN(ADD, w, u, v);
+    GEN_INSN(ADD, w, w, z);
+    /* loads aren't pure, the memory may be changed between them */
+    GEN_INSN(STI32, a, cc->fp_reg, offset);
+    GEN_INSN(LDI32, l1, cc->fp_reg, offset);
+    GEN_INSN(STI32, b, cc->fp_reg, offset);
+    GEN_INSN(LDI32, l2, cc->fp_reg, offset);
+    GEN_INSN(ADD, p, l1, l2);
+    GEN_INSN(STI32, p, cc->fp_reg, offset);
+    GEN_INSN(JMP, label_of(next));
+
+    /* the expressions of another block aren't reused */
+    set_block(next);
+    a = load_arg_I32(0);
+    b = load_arg_I32(1);
+    GEN_INSN(ADD, q, a, b);
+    GEN_INSN(LDI32, p, cc->fp_reg, offset);
+    GEN_INSN(ADD, r, q, p);
+    GEN_INSN(ADD, r, r, w);
+    GEN_INSN(RETURN, r);
+
+    ASSERT_EQ(run_ok({ 3, 4 }), 7U + 7 + (3 + 4) * (3 + 4));
+    ASSERT_TRUE(optimize(2));
+    EXPECT_EQ(*jit_insn_opnd(mul, 1), x);
+    EXPECT_EQ(*jit_insn_opnd(mul, 2), x);
+    EXPECT_EQ(count_insns(entry, JIT_OP_ADD), 4U);
+    EXPECT_EQ(count_insns(entry, JIT_OP_SUB), 2U);
+    EXPECT_EQ(count_insns(entry, JIT_OP_LDI32), 4U);
+    EXPECT_EQ(count_insns(next, JIT_OP_ADD), 3U);
+    EXPECT_EQ(run_ok({ 3, 4 }), 7U + 7 + (3 + 4) * (3 + 4));
+}
+
+#if UINTPTR_MAX == UINT64_MAX && !defined(OS_ENABLE_HW_BOUND_CHECK)
+TEST_F(JitOptimizeTest, Bounds_check_elim)
+{
+    JitBasicBlock *entry = jit_cc_entry_basic_block(cc);
+    JitBasicBlock *next = new_block(), *exce = new_block();
+    JitReg exce_label = label_of(exce), page_count;
+    JitReg bound_4bytes, bound_8bytes, wasm_addr, wasm_addr2;
+    JitInsn *checks[5], *next_check;
+    int i;
+
+    /* The module has a memory, whose registers are freed by
+       jit_cc_destroy */
+    static WASMModule module;
+
+    module.memory_count = 1;
+    cc->cur_wasm_module = &module;
+    ASSERT_TRUE(cc->memory_regs =
+                    (JitMemRegs *)jit_calloc(sizeof(JitMemRegs)));
+    page_count = cc->memory_regs->cur_page_count = jit_cc_new_reg_I32(cc);
+    bound_4bytes = cc->memory_regs->mem_bound_check_4bytes =
+        jit_cc_new_reg_I64(cc);
+    bound_8bytes = cc->memory_regs->mem_bound_check_8bytes =
+        jit_cc_new_reg_I64(cc);
+
+    /* the page count is checked twice */
+    for (i = 0; i < 2; i++) {
+        GEN_INSN(CMP, cc->cmp_reg, page_count, NEW_CONST(I32, 0));
+        GEN_INSN(BEQ, cc->cmp_reg, exce_label, 0);
+    }
+
+    wasm_addr = load_arg_I32(0);
+    wasm_addr2 = load_arg_I32(1);
+    /* [addr + 16, addr + 24) */
+    checks[0] = gen_bounds_check(wasm_addr, 16, bound_8bytes, exce_label);
+    /* [addr + 20, addr + 24) is covered */
+    checks[1] = gen_bounds_check(wasm_addr, 20, bound_4bytes, exce_label);
+    /* [addr + 24, addr + 28) isn't covered */
+    checks[2] = gen_bounds_check(wasm_addr, 24, bound_4bytes, exce_label);
+    /* [addr, addr + 8) is covered by the last check */
+    checks[3] = gen_bounds_check(wasm_addr, 0, bound_8bytes, exce_label);
+    /* another address */
+    checks[4] = gen_bounds_check(wasm_addr2, 0, bound_4bytes, exce_label);
+    GEN_INSN(JMP, label_of(next));
+
+    /* the checks of another block aren't reused */
+    set_block(next);
+    wasm_addr = load_arg_I32(0);
+    next_check = gen_bounds_check(wasm_addr, 0, bound_4bytes, exce_label);
+    GEN_INSN(RETURN, NEW_CONST(I32, 0));
+
+    set_block(exce);
+    GEN_INSN(RETURN, NEW_CONST(I32, -1));
+
+    /* The extensions of the address are merged by CSE first */
+    ASSERT_TRUE(optimize(2));
+
+    EXPECT_EQ(count_insns(entry, JIT_OP_BEQ), 1U);
+    EXPECT_EQ(count_insns(entry, JIT_OP_BGTU), 3U);
+    EXPECT_EQ(count_insns(entry, JIT_OP_CMP), 4U);
+    EXPECT_EQ(find_insn(entry, JIT_OP_CMP, 1), checks[0]);
+    EXPECT_EQ(find_insn(entry, JIT_OP_CMP, 2), checks[2]);
+    EXPECT_EQ(find_insn(entry, JIT_OP_CMP, 3), checks[4]);
+    EXPECT_EQ(find_insn(next, JIT_OP_CMP), next_check);
+    EXPECT_EQ(count_insns(next, JIT_OP_BGTU), 1U);
+}
+
+TEST_F(JitOptimizeTest, Bounds_check_elim_redefined_local)
+{
+    JitBasicBlock *entry = jit_cc_entry_basic_block(cc);
+    JitBasicBlock *exce = new_block();
+    JitReg exce_label = label_of(exce), bound_4bytes, local;
+    JitInsn *checks[2];
+
+    static WASMModule module;
+
+    module.memory_count = 1;
+    cc->cur_wasm_module = &module;
+    ASSERT_TRUE(cc->memory_regs =
+                    (JitMemRegs *)jit_calloc(sizeof(JitMemRegs)));
+    bound_4bytes = cc->memory_regs->mem_bound_check_4bytes =
+        jit_cc_new_reg_I64(cc);
+    GEN_INSN(LDI64, bound_4bytes, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(2)));
+
+    /* The register of a local is defined by each local.set as the
+       frontend does, so CSE doesn't merge the extensions of it */
+    local = jit_cc_new_reg_I32(cc);
+    GEN_INSN(MOV, local, load_arg_I32(0));
+    checks[0] = gen_bounds_check(local, 0, bound_4bytes, exce_label);
+    /* the same address is covered */
+    gen_bounds_check(local, 0, bound_4bytes, exce_label);
+    /* local.set, the new address isn't covered */
+    GEN_INSN(MOV, local, load_arg_I32(1));
+    checks[1] = gen_bounds_check(local, 0, bound_4bytes, exce_label);
+    GEN_INSN(RETURN, NEW_CONST(I32, 0));
+
+    set_block(exce);
+    GEN_INSN(RETURN, NEW_CONST(I32, -1));
+
+    ASSERT_TRUE(optimize(2));
+
+    EXPECT_EQ(count_insns(entry, JIT_OP_CMP), 2U);
+    EXPECT_EQ(count_insns(entry, JIT_OP_BGTU), 2U);
+    EXPECT_EQ(find_insn(entry, JIT_OP_CMP, 0), checks[0]);
+    EXPECT_EQ(find_insn(entry, JIT_OP_CMP, 1), checks[1]);
+
+    /* the memory has 104 bytes, the check of 4 bytes fails for the
+       addresses above 100 */
+    EXPECT_EQ((uint32)run_ok({ 100, 100, 100 }), 0U);
+    EXPECT_EQ((uint32)run_ok({ 100, 101, 100 }), (uint32)-1);
+    EXPECT_EQ((uint32)run_ok({ 101, 0, 100 }), (uint32)-1);
+}
+#endif
+
+TEST_F(JitOptimizeTest, Dce)
+{
+    JitBasicBlock *next = new_block();
+    JitReg a = load_arg_I32(0), t1 = jit_cc_new_reg_I32(cc);
+    JitReg t2 = jit_cc_new_reg_I32(cc), t3 = jit_cc_new_reg_I32(cc);
+    JitReg t4 = jit_cc_new_reg_I32(cc), t5 = jit_cc_new_reg_I32(cc);
+    JitReg res = jit_cc_new_reg_I64(cc), r = jit_cc_new_reg_I32(cc);
+    JitInsn *call;
+
+    /* a chain of unused values */
+    GEN_INSN(ADD, t1, a, NEW_CONST(I32, 1));
+    GEN_INSN(MUL, t2, t1, t1);
+    /* an unused load of the frame */
+    GEN_INSN(LDI32, t3, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(0)));
+    /* the store and the call have side effects */
+    GEN_INSN(STI32, a, cc->fp_reg, NEW_CONST(I32, ARG_OFFSET(2)));
+    call = GEN_INSN(CALLNATIVE, res, NEW_CONST(I64, NATIVE_FUNC_MIX), 1);
+    *(jit_insn_opndv(call, 2)) = a;
+    /* a chain across blocks */
+    GEN_INSN(ADD, t4, a, NEW_CONST(I32, 2));
+    GEN_INSN(JMP, label_of(next));
+
+    set_block(next);
+    GEN_INSN(ADD, t5, t4, NEW_CONST(I32, 1));
+    GEN_INSN(ADD, r, a, a);
+    GEN_INSN(RETURN, r);
+
+    ASSERT_EQ(run_ok({ 21 }), 42U);
+    ASSERT_TRUE(optimize(1));
+    EXPECT_EQ(count_insns(JIT_OP_ADD), 1U);
+    EXPECT_EQ(count_insns(JIT_OP_MUL), 0U);
+    EXPECT_EQ(count_insns(JIT_OP_LDI32), 1U);
+    EXPECT_EQ(count_insns(JIT_OP_STI32), 1U);
+    EXPECT_EQ(count_insns(JIT_OP_CALLNATIVE), 1U);
+    EXPECT_EQ(run_ok({ 21 }), 42U);
+    EXPECT_EQ(native_call_num, 1U);
+}
+
+TEST_F(JitOptimizeTest, Opt_levels_keep_results)
+{
+    static const uint32 ns[] = { 0, 1, 7, 100 };
+    uint32 insn_nums[3], opt_level, i;
+    uint32 expected;
+
+    for (opt_level = 0; opt_level <= 2; opt_level++) {
+        ASSERT_TRUE(new_cc());
+        build_loop();
+        ASSERT_TRUE(optimize(opt_level)) << "opt level " << opt_level;
+        insn_nums[opt_level] = count_insns();
+
+        for (uint32 n : ns) {
+            for (i = 0, expected = 0; i < n; i++)
+                expected += (i * 3 + 7) + ((i * 3 + 7) >> 1);
+            EXPECT_EQ(run_ok({ n }), expected)
+                << "opt level " << opt_level << ", n " << n;
+        }
+    }
+
+    /* Constants and copies are removed at level 1, and the common
+       subexpressions at level 2 */
+    EXPECT_LT(insn_nums[1], insn_nums[0]);
+    EXPECT_LT(insn_nums[2], insn_nums[1]);
+}
@@ -0,0 +1,379 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <random>
+
+#include "jit_ir_test_helper.h"
+
+/* The number of the blocks after the entry block of the random
+   functions, see build_random */
+#define RANDOM_BLOCK_NUM 6U
+
+class JitRegallocTest : public JitIRTest
+{
+  public:
+    bool allocate(bool linear_scan)
+    {
+        return linear_scan ? jit_pass_regalloc_linear_scan(cc)
+                           : jit_pass_regalloc(cc);
+    }
+
+    /* Run the IR with each of the inputs */
+    std::vector<uint64>
+    run_inputs(const std::vector<std::vector<uint64>> &inputs)
+    {
+        std::vector<uint64> results;
+
+        for (const std::vector<uint64> &args : inputs)
+            results.push_back(run_ok(args));
+        return results;
+    }
+
+    /* Build the function below in the entry block, whose values are all
+       live in the middle of it:
+           t[i] = v[i] * (i + 3) for each argument v[i]
+           return sum(t) + sum(v)
+     */
+    void build_high_pressure(unsigned kind)
+    {
+        JitReg v[ARG_NUM], t[ARG_NUM], acc, sum;
+        uint32 i;
+
+        for (i = 0; i < ARG_NUM; i++) {
+            v[i] = kind == JIT_REG_KIND_I32 ? load_arg_I32(i)
+                                            : load_arg_I64(i);
+            t[i] = jit_cc_new_reg(cc, kind);
+        }
+
+        for (i = 0; i < ARG_NUM; i++)
+            GEN_INSN(MUL, t[i], v[i],
+                     kind == JIT_REG_KIND_I32 ? NEW_CONST(I32, i + 3)
+                                              : NEW_CONST(I64, i + 3));
+
+        sum = t[0];
+        for (i = 1; i < ARG_NUM; i++) {
+            acc = jit_cc_new_reg(cc, kind);
+            GEN_INSN(ADD, acc, sum, t[i]);
+            sum = acc;
+        }
+        for (i = 0; i < ARG_NUM; i++) {
+            acc = jit_cc_new_reg(cc, kind);
+            GEN_INSN(ADD, acc, sum, v[i]);
+            sum = acc;
+        }
+        GEN_INSN(RETURN, sum);
+    }
+
+    /* Build the function below in the entry block, where the values of
+       the first live_num arguments are live across the native call:
+           r = mix(v[0], v[1])
+           return v[0] + ... + v[live_num - 1] + r
+     */
+    void build_native_call(uint32 live_num)
+    {
+        JitReg v[ARG_NUM], r = jit_cc_new_reg_I32(cc), sum, acc;
+        JitInsn *call;
+        uint32 i;
+
+        for (i = 0; i < live_num; i++)
+            v[i] = load_arg_I32(i);
+
+        call = GEN_INSN(CALLNATIVE, r, NEW_CONST(I64, NATIVE_FUNC_MIX), 2);
+        *(jit_insn_opndv(call, 2)) = v[0];
+        *(jit_insn_opndv(call, 3)) = v[1];
+
+        sum = r;
+        for (i = 0; i < live_num; i++) {
+            acc = jit_cc_new_reg_I32(cc);
+            GEN_INSN(ADD, acc, sum, v[i]);
+            sum = acc;
+        }
+        GEN_INSN(RETURN, sum);
+    }
+
+    /* Build the loop below, whose x is only used in the loop header and
+       y only after the loop, and the body has more values live than the
+       hard registers, optionally with a native call:
+           for (sum = 0, i = 0; sum += x, i < n; i++) {
+               t[k] = i * (k + 1) + k for k in 0..5
+               sum += t[0] + ... + t[5]
+               if (with_call)
+                   sum += mix(i, sum)
+           }
+           return sum + y
+     */
+    void build_loop(bool with_call)
+    {
+        JitBasicBlock *head = new_block(), *body = new_block();
+        JitBasicBlock *done = new_block();
+        JitReg n = load_arg_I32(0), x = load_arg_I32(1), y = load_arg_I32(2);
+        JitReg i = jit_cc_new_reg_I32(cc), sum = jit_cc_new_reg_I32(cc);
+        JitReg t[6], acc, r;
+        JitInsn *call;
+        uint32 k;
+
+        GEN_INSN(MOV, i, NEW_CONST(I32, 0));
+        GEN_INSN(MOV, sum, NEW_CONST(I32, 0));
+        GEN_INSN(JMP, label_of(head));
+
+        set_block(head);
+        GEN_INSN(ADD, sum, sum, x);
+        GEN_INSN(CMP, cc->cmp_reg, i, n);
+        GEN_INSN(BGES, cc->cmp_reg, label_of(done), label_of(body));
+
+        set_block(body);
+        for (k = 0; k < 6; k++) {
+            t[k] = jit_cc_new_reg_I32(cc);
+            GEN_INSN(MUL, t[k], i, NEW_CONST(I32, k + 1));
+            GEN_INSN(ADD, t[k], t[k], NEW_CONST(I32, k));
+        }
+        for (k = 0; k < 6; k++)
+            GEN_INSN(ADD, sum, sum, t[k]);
+        if (with_call) {
+            r = jit_cc_new_reg_I32(cc);
+            call = GEN_INSN(CALLNATIVE, r, NEW_CONST(I64, NATIVE_FUNC_MIX), 2);
+            *(jit_insn_opndv(call, 2)) = i;
+            *(jit_insn_opndv(call, 3)) = sum;
+            GEN_INSN(ADD, sum, sum, r);
+        }
+        GEN_INSN(ADD, i, i, NEW_CONST(I32, 1));
+        GEN_INSN(JMP, label_of(head));
+
+        set_block(done);
+        acc = jit_cc_new_reg_I32(cc);
+        GEN_INSN(ADD, acc, sum, y);
+        GEN_INSN(RETURN, acc);
+    }
+
+    /* Build a random function of the seed, whose blocks branch forward
+       to one of the next two blocks. The globals are defined in the
+       entry block, and changed and used in the others with the locals
+       of each block, so that the values live across blocks and calls
+       vary between the blocks. */
+    void build_random(uint32 seed)
+    {
+        std::mt19937 rng(seed);
+        JitBasicBlock *blocks[RANDOM_BLOCK_NUM + 1];
+        std::vector<JitReg> globals, values;
+        JitReg dst, r1, r2, sum;
+        JitInsn *call;
+        uint32 global_num = 4 + rng() % 8, i, j, insn_num;
+
+        for (i = 0; i <= RANDOM_BLOCK_NUM; i++)
+            blocks[i] = new_block();
+
+        for (i = 0; i < global_num; i++) {
+            globals.push_back(load_arg_I32(i % ARG_NUM));
+            if (i >= ARG_NUM)
+                GEN_INSN(ADD, globals[i], globals[i], NEW_CONST(I32, i));
+        }
+        GEN_INSN(JMP, label_of(blocks[0]));
+
+        for (i = 0; i < RANDOM_BLOCK_NUM; i++) {
+            set_block(blocks[i]);
+            values = globals;
+            insn_num = 4 + rng() % 16;
+
+            for (j = 0; j < insn_num; j++) {
+                r1 = values[rng() % values.size()];
+                r2 = rng() % 4 ? values[rng() % values.size()]
+                               : NEW_CONST(I32, (int32)rng());
+                if (rng() % 3) {
+                    dst = jit_cc_new_reg_I32(cc);
+                    values.push_back(dst);
+                }
+                else
+                    dst = globals[rng() % global_num];
+
+                switch (rng() % 6) {
+                    case 0:
+                        GEN_INSN(SUB, dst, r1, r2);
+                        break;
+                    case 1:
+                        GEN_INSN(MUL, dst, r1, r2);
+                        break;
+                    case 2:
+                        GEN_INSN(XOR, dst, r1, r2);
+                        break;
+                    case 3:
+                        call = GEN_INSN(CALLNATIVE, dst,
+                                        NEW_CONST(I64, NATIVE_FUNC_MIX), 1);
+                        *(jit_insn_opndv(call, 2)) = r1;
+                        break;
+                    default:
+                        GEN_INSN(ADD, dst, r1, r2);
+                        break;
+                }
+            }
+
+            GEN_INSN(CMP, cc->cmp_reg, values[rng() % values.size()],
+                     NEW_CONST(I32, (int32)rng()));
+            GEN_INSN(BLTU, cc->cmp_reg, label_of(blocks[i + 1]),
+                     label_of(blocks[std::min(i + 2, RANDOM_BLOCK_NUM)]));
+        }
+
+        set_block(blocks[RANDOM_BLOCK_NUM]);
+        sum = jit_cc_new_reg_I32(cc);
+        GEN_INSN(MOV, sum, NEW_CONST(I32, 0));
+        for (i = 0; i < global_num; i++) {
+            GEN_INSN(MUL, sum, sum, NEW_CONST(I32, 31));
+            GEN_INSN(ADD, sum, sum, globals[i]);
+        }
+        GEN_INSN(RETURN, sum);
+    }
+
+    uint32 loop_result(bool with_call, uint32 n, uint32 x, uint32 y)
+    {
+        uint32 sum = 0, i, k;
+
+        for (i = 0;; i++) {
+            sum += x;
+            if (i >= n)
+                break;
+            for (k = 0; k < 6; k++)
+                sum += i * (k + 1) + k;
+            if (with_call)
+                sum += (uint32)mix_native_args({ i, sum });
+        }
+        return sum + y;
+    }
+};
+
+TEST_F(JitRegallocTest, High_register_pressure)
+{
+    static const unsigned kinds[] = { JIT_REG_KIND_I32, JIT_REG_KIND_I64 };
+    std::vector<uint64> args;
+    uint64 expected;
+    uint32 i;
+
+    for (unsigned kind : kinds) {
+        for (bool linear_scan : { false, true }) {
+            SCOPED_TRACE(testing::Message() << "kind " << kind
+                                            << ", linear scan " << linear_scan);
+
+            args.clear();
+            expected = 0;
+            for (i = 0; i < ARG_NUM; i++) {
+                args.push_back(kind == JIT_REG_KIND_I32
+                                   ? 1000 * i + 7
+                                   : 0x100000000ULL * i + 7);
+                expected += args[i] * (i + 3) + args[i];
+            }
+            if (kind == JIT_REG_KIND_I32)
+                expected = (uint32)expected;
+
+            ASSERT_TRUE(new_cc());
+            build_high_pressure(kind);
+            ASSERT_EQ(run_ok(args), expected);
+
+            ASSERT_TRUE(allocate(linear_scan)) << jit_get_last_error(cc);
+            EXPECT_TRUE(is_allocated());
+            /* 16 values are live with 6 hard registers */
+            EXPECT_GT(cc->spill_insn_num, 0U);
+            EXPECT_GT(cc->reload_insn_num, 0U);
+            EXPECT_EQ(run_ok(args), expected);
+        }
+    }
+}
+
+TEST_F(JitRegallocTest, Spill_and_reload_around_native_call)
+{
+    std::vector<uint64> args = { 11, 22, 33, 44, 55 };
+    uint64 expected = (uint32)(mix_native_args({ 11, 22 }) + 11 + 22 + 33
+                               + 44 + 55);
+
+    /* 5 values are live across the call, with 3 callee-saved hard
+       registers */
+    for (bool linear_scan : { false, true }) {
+        SCOPED_TRACE(testing::Message() << "linear scan " << linear_scan);
+
+        ASSERT_TRUE(new_cc());
+        build_native_call(5);
+        ASSERT_EQ(run_ok(args), expected);
+
+        ASSERT_TRUE(allocate(linear_scan)) << jit_get_last_error(cc);
+        EXPECT_TRUE(is_allocated());
+        EXPECT_GT(cc->reload_insn_num, 0U);
+        /* The caller-saved hard registers are lost after the call */
+        EXPECT_EQ(run_ok(args), expected);
+        EXPECT_EQ(native_call_num, 1U);
+    }
+}
+
+TEST_F(JitRegallocTest, Linear_scan_keeps_values_in_callee_saved_regs)
+{
+    std::vector<uint64> args = { 11, 22, 33 };
+    uint64 expected = (uint32)(mix_native_args({ 11, 22 }) + 11 + 22 + 33);
+
+    /* The local allocator reloads the values in caller-saved hard
+       registers after the call */
+    build_native_call(3);
+    ASSERT_TRUE(allocate(false));
+    EXPECT_GT(cc->reload_insn_num, 0U);
+    EXPECT_EQ(run_ok(args), expected);
+
+    /* The linear scan allocates the 3 values live across the call to the
+       callee-saved hard registers */
+    ASSERT_TRUE(new_cc());
+    build_native_call(3);
+    ASSERT_TRUE(allocate(true));
+    EXPECT_TRUE(is_allocated());
+    EXPECT_EQ(cc->spill_insn_num, 0U);
+    EXPECT_EQ(cc->reload_insn_num, 0U);
+    EXPECT_EQ(run_ok(args), expected);
+}
+
+TEST_F(JitRegallocTest, Linear_scan_liveness_across_loop)
+{
+    static const uint32 ns[] = { 0, 1, 5, 100 };
+    std::vector<std::vector<uint64>> inputs;
+    std::vector<uint64> results;
+
+    for (bool with_call : { false, true }) {
+        SCOPED_TRACE(testing::Message() << "with call " << with_call);
+
+        inputs.clear();
+        results.clear();
+        for (uint32 n : ns) {
+            inputs.push_back({ n, 1000, 77 });
+            results.push_back(loop_result(with_call, n, 1000, 77));
+        }
+
+        ASSERT_TRUE(new_cc());
+        build_loop(with_call);
+        ASSERT_EQ(run_inputs(inputs), results);
+
+        ASSERT_TRUE(allocate(true)) << jit_get_last_error(cc);
+        EXPECT_TRUE(is_allocated());
+        /* x and y are kept through the loop body, where the hard
+           registers are all used */
+        EXPECT_EQ(run_inputs(inputs), results);
+    }
+}
+
+TEST_F(JitRegallocTest, Linear_scan_random_functions)
+{
+    std::vector<std::vector<uint64>> inputs;
+    std::vector<uint64> results;
+    uint32 seed, i, j;
+
+    for (i = 0; i < 3; i++) {
+        inputs.push_back({});
+        for (j = 0; j < ARG_NUM; j++)
+            inputs[i].push_back((i + 1) * 0x9e3779b9U * (j + 1));
+    }
+
+    for (seed = 0; seed < 1000; seed++) {
+        SCOPED_TRACE(testing::Message() << "seed " << seed);
+
+        ASSERT_TRUE(new_cc());
+        build_random(seed);
+        results = run_inputs(inputs);
+
+        ASSERT_TRUE(allocate(true)) << jit_get_last_error(cc);
+        ASSERT_TRUE(is_allocated());
+        ASSERT_EQ(run_inputs(inputs), results);
+    }
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gc_test_helper.h"
+#include "ems/ems_gc.h"
+#include "ems/ems_gc_internal.h"
+
+#if GC_ENABLE_BUMP_ALLOC != 0
+
+/* Size of the small wos allocated, a chunk of 32 bytes with the header */
+#define SMALL_WO_SIZE (32 - HMU_SIZE - OBJ_PREFIX_SIZE - OBJ_SUFFIX_SIZE)
+
+/* Size of the large wos, which are never allocated from the buffer */
+#define LARGE_WO_SIZE (GC_BUMP_ALLOC_MAX_SIZE * 2)
+
+#define LIST_LEN 200
+
+static char heap_buf[256 * 1024];
+
+/* The free space counted must be the size of the free chunks, including
+   the unused part of the bump allocation buffer */
+static void
+check_free_size(gc_heap_t *heap)
+{
+    hmu_t *cur = (hmu_t *)heap->base_addr;
+    hmu_t *end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+    gc_size_t free_size = 0;
+    gc_uint32 ut;
+
+    while (cur < end) {
+        ut = hmu_get_ut(cur);
+        if (ut == HMU_FC || ut == HMU_FM)
+            free_size += hmu_get_size(cur);
+        cur = (hmu_t *)((char *)cur + hmu_get_size(cur));
+    }
+
+    ASSERT_EQ(cur, end);
+    ASSERT_EQ(free_size, heap->total_free_size);
+    ASSERT_FALSE(gc_is_heap_corrupted(heap));
+}
+
+static bool
+is_in_buffer(gc_object_t obj, gc_uint8 *buf)
+{
+    gc_uint8 *hmu = (gc_uint8 *)obj_to_hmu(obj);
+
+    return hmu >= buf && hmu < buf + GC_BUMP_ALLOC_BUF_SIZE;
+}
+
+TEST(GCBumpAllocTest, Refill_and_fallback)
+{
+    gc_heap_t *heap;
+    gc_object_t obj, first;
+    gc_uint8 *buf, *buf2;
+    gc_size_t chunk_size, free_size, obj_num, i;
+    gc_uint8 *bump_ptr;
+
+    heap = (gc_heap_t *)gc_init_with_pool(heap_buf, sizeof(heap_buf));
+    ASSERT_TRUE(heap != NULL);
+    free_size = heap->total_free_size;
+    ASSERT_TRUE(heap->bump_ptr == NULL);
+
+    /* The first small wo carves a buffer from the free chunks */
+    first = gc_alloc_wo(heap, SMALL_WO_SIZE);
+    ASSERT_TRUE(first != NULL);
+    chunk_size = hmu_get_size(obj_to_hmu(first));
+    ASSERT_EQ(chunk_size, 32U);
+    buf = (gc_uint8 *)obj_to_hmu(first);
+    ASSERT_EQ(heap->bump_end - buf, GC_BUMP_ALLOC_BUF_SIZE);
+    ASSERT_EQ(heap->bump_ptr, buf + chunk_size);
+    ASSERT_EQ(heap->total_free_size, free_size - chunk_size);
+    check_free_size(heap);
+
+    /* The next wos are bumped from the buffer until it is used up */
+    obj_num = GC_BUMP_ALLOC_BUF_SIZE / chunk_size;
+    for (i = 1; i < obj_num; i++) {
+        obj = gc_alloc_wo(heap, SMALL_WO_SIZE);
+        ASSERT_TRUE(obj != NULL);
+        ASSERT_EQ((gc_uint8 *)obj_to_hmu(obj), buf + i * chunk_size);
+    }
+    ASSERT_TRUE(heap->bump_ptr == NULL);
+    ASSERT_EQ(heap->total_free_size, free_size - obj_num * chunk_size);
+    check_free_size(heap);
+
+    /* The buffer is refilled */
+    obj = gc_alloc_wo(heap, SMALL_WO_SIZE);
+    ASSERT_TRUE(obj != NULL);
+    ASSERT_FALSE(is_in_buffer(obj, buf));
+    buf2 = (gc_uint8 *)obj_to_hmu(obj);
+    ASSERT_EQ(heap->bump_end - buf2, GC_BUMP_ALLOC_BUF_SIZE);
+    ASSERT_EQ(heap->bump_ptr, buf2 + chunk_size);
+    check_free_size(heap);
+
+    /* A large wo is allocated from the free lists */
+    bump_ptr = heap->bump_ptr;
+    obj = gc_alloc_wo(heap, LARGE_WO_SIZE);
+    ASSERT_TRUE(obj != NULL);
+    ASSERT_FALSE(is_in_buffer(obj, buf2));
+    ASSERT_EQ(heap->bump_ptr, bump_ptr);
+    check_free_size(heap);
+
+    /* When the free space drops below the GC threshold, the buffer isn't
+       refilled and the small wos are allocated from the free lists, so
+       that the heap is collected in time */
+    while (heap->total_free_size >= heap->gc_threshold)
+        ASSERT_TRUE(gc_alloc_wo(heap, LARGE_WO_SIZE) != NULL);
+    while (heap->bump_ptr)
+        ASSERT_TRUE(gc_alloc_wo(heap, SMALL_WO_SIZE) != NULL);
+    free_size = heap->total_free_size;
+
+    obj = gc_alloc_wo(heap, SMALL_WO_SIZE);
+    ASSERT_TRUE(obj != NULL);
+    ASSERT_TRUE(heap->bump_ptr == NULL);
+    ASSERT_EQ(heap->total_free_size,
+              free_size - hmu_get_size(obj_to_hmu(obj)));
+    check_free_size(heap);
+
+    gc_destroy_with_pool(heap);
+}
+
+class WasmGCBumpAllocTest : public WasmGCInstanceTest
+{};
+
+TEST_F(WasmGCBumpAllocTest, Reset_by_sweep_and_compaction)
+{
+    gc_heap_t *heap;
+    uint32 argv[1], list_sum = LIST_LEN * (LIST_LEN - 1) / 2;
+    gc_size_t compact_count;
+
+    ASSERT_TRUE(init_runtime(1024 * 1024));
+    ASSERT_TRUE(instantiate("compact1.wasm")) << error_buf;
+    heap = (gc_heap_t *)wasm_runtime_get_gc_heap_handle(module_inst);
+
+    argv[0] = LIST_LEN;
+    ASSERT_TRUE(call_func("fragment", 1, argv));
+    ASSERT_TRUE(heap->bump_ptr != NULL);
+    check_free_size(heap);
+
+    /* The unused part of the buffer is merged into the free chunks by
+       the sweep */
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_TRUE(heap->bump_ptr == NULL);
+    check_free_size(heap);
+    ASSERT_TRUE(call_func("sum_list", 0, argv));
+    ASSERT_EQ(argv[0], list_sum);
+
+    /* The buffer is refilled after the sweep */
+    argv[0] = LIST_LEN;
+    ASSERT_TRUE(call_func("fragment", 1, argv));
+    ASSERT_TRUE(heap->bump_ptr != NULL);
+    check_free_size(heap);
+
+    /* The free chunks are rebuilt by the compaction, which drops the
+       buffer too */
+    compact_count = heap->total_compact_count;
+    ASSERT_EQ(gci_compact_heap(heap), GC_SUCCESS);
+    ASSERT_EQ(heap->total_compact_count, compact_count + 1);
+    ASSERT_TRUE(heap->bump_ptr == NULL);
+    check_free_size(heap);
+    ASSERT_TRUE(call_func("sum_list", 0, argv));
+    ASSERT_EQ(argv[0], list_sum * 2);
+
+    /* And the buffer is refilled after the compaction */
+    argv[0] = LIST_LEN;
+    ASSERT_TRUE(call_func("fragment", 1, argv));
+    ASSERT_TRUE(heap->bump_ptr != NULL);
+    check_free_size(heap);
+    ASSERT_TRUE(call_func("sum_list", 0, argv));
+    ASSERT_EQ(argv[0], list_sum * 3);
+}
+
+#endif /* end of GC_ENABLE_BUMP_ALLOC != 0 */
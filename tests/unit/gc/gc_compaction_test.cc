@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "gc_test_helper.h"
+#include "ems/ems_gc.h"
+#include "ems/ems_gc_internal.h"
+
+#if WASM_ENABLE_GC_COMPACTION != 0
+
+/* Number of nodes kept in the list, a garbage node is allocated before
+   each of them, the heap is only compacted when it is forced */
+#define LIST_LEN 1000
+
+class WasmGCCompactionTest : public WasmGCInstanceTest
+{};
+
+static wasm_obj_t
+get_next(wasm_obj_t obj)
+{
+    wasm_value_t value;
+
+    wasm_struct_obj_get_field((wasm_struct_obj_t)obj, 0, false, &value);
+    return value.gc_obj;
+}
+
+static void
+finalizer(const wasm_obj_t obj, void *data)
+{
+    std::vector<wasm_obj_t> *finalized = (std::vector<wasm_obj_t> *)data;
+
+    finalized->push_back(obj);
+}
+
+TEST_F(WasmGCCompactionTest, Forward_references)
+{
+    std::vector<wasm_obj_t> finalized;
+    gc_heap_t *heap;
+    wasm_obj_t head, next, new_head, new_next, obj;
+    uint32 argv[1], free_size, compact_count, node_num = 0;
+
+    ASSERT_TRUE(init_runtime(1024 * 1024));
+    ASSERT_TRUE(instantiate("compact1.wasm")) << error_buf;
+    heap = (gc_heap_t *)wasm_runtime_get_gc_heap_handle(module_inst);
+
+    argv[0] = LIST_LEN;
+    ASSERT_TRUE(call_func("fragment", 1, argv));
+
+    head = get_global_obj("list");
+    ASSERT_TRUE(head != NULL);
+    next = get_next(head);
+    ASSERT_TRUE(next != NULL);
+    ASSERT_TRUE(wasm_obj_set_gc_finalizer(exec_env, head, finalizer,
+                                          &finalized));
+    ASSERT_TRUE(wasm_obj_set_gc_finalizer(exec_env, next, finalizer,
+                                          &finalized));
+
+    /* Free the garbage nodes, which leaves a hole before each node */
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_TRUE(get_global_obj("list") == head);
+    free_size = heap->total_free_size;
+    compact_count = heap->total_compact_count;
+
+    /* Slide the nodes into the holes */
+    ASSERT_EQ(gci_compact_heap(heap), GC_SUCCESS);
+    ASSERT_EQ(heap->total_compact_count, compact_count + 1);
+    ASSERT_EQ(heap->total_free_size, free_size);
+
+    /* The global, i.e. a root slot, is forwarded to the new address */
+    new_head = get_global_obj("list");
+    ASSERT_TRUE((uint8 *)new_head < (uint8 *)head);
+    ASSERT_EQ(hmu_get_ut(obj_to_hmu(new_head)), HMU_WO);
+
+    /* The references in the objects are forwarded */
+    new_next = get_next(new_head);
+    ASSERT_TRUE((uint8 *)new_next < (uint8 *)next);
+    for (obj = new_head; obj; obj = get_next(obj)) {
+        ASSERT_TRUE((uint8 *)obj > heap->base_addr
+                    && (uint8 *)obj < heap->base_addr + heap->current_size);
+        ASSERT_EQ(hmu_get_ut(obj_to_hmu(obj)), HMU_WO);
+        node_num++;
+    }
+    ASSERT_EQ(node_num, (uint32)LIST_LEN);
+
+    ASSERT_TRUE(call_func("sum_list", 0, argv));
+    ASSERT_EQ(argv[0], (uint32)(LIST_LEN * (LIST_LEN - 1) / 2));
+
+    /* The extra info nodes are forwarded */
+    ASSERT_TRUE(gc_search_extra_info_node(heap, new_head, NULL) != NULL);
+    ASSERT_TRUE(gc_search_extra_info_node(heap, new_next, NULL) != NULL);
+    ASSERT_EQ(heap->extra_info_node_cnt, 2U);
+
+    /* The finalizers are called with the new addresses */
+    ASSERT_TRUE(call_func("clear", 0, argv));
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_EQ(finalized.size(), 2U);
+    ASSERT_TRUE(std::find(finalized.begin(), finalized.end(), new_head)
+                != finalized.end());
+    ASSERT_TRUE(std::find(finalized.begin(), finalized.end(), new_next)
+                != finalized.end());
+    ASSERT_EQ(heap->extra_info_node_cnt, 0U);
+}
+
+#endif /* end of WASM_ENABLE_GC_COMPACTION != 0 */
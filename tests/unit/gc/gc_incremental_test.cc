@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gc_test_helper.h"
+#include "ems/ems_gc.h"
+#include "ems/ems_gc_internal.h"
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+
+/* Depth of the tree in $pad, it has enough nodes to keep the marking
+   cycle in progress after the first marking step */
+#define PAD_TREE_DEPTH 10
+
+class WasmGCIncrementalTest : public WasmGCInstanceTest
+{};
+
+/* Whether obj is still a wo chunk of the heap, a freed wo is turned into
+   a free chunk or merged into the free chunk before it by the sweep */
+static bool
+is_live_wo(gc_heap_t *heap, wasm_obj_t obj)
+{
+    hmu_t *cur = (hmu_t *)heap->base_addr;
+    hmu_t *end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+
+    while (cur < end) {
+        if (hmu_to_obj(cur) == (gc_object_t)obj)
+            return hmu_get_ut(cur) == HMU_WO;
+        cur = (hmu_t *)((char *)cur + hmu_get_size(cur));
+    }
+    return false;
+}
+
+TEST_F(WasmGCIncrementalTest, Write_barrier_keeps_white_object)
+{
+    gc_heap_t *heap;
+    wasm_obj_t holder, obj;
+    wasm_value_t value;
+    uint32 argv[1];
+
+    ASSERT_TRUE(init_runtime(1024 * 1024));
+    ASSERT_TRUE(instantiate("barrier1.wasm")) << error_buf;
+
+    argv[0] = PAD_TREE_DEPTH;
+    ASSERT_TRUE(call_func("init", 1, argv));
+
+    heap = (gc_heap_t *)wasm_runtime_get_gc_heap_handle(module_inst);
+    holder = get_global_obj("holder");
+    ASSERT_TRUE(holder != NULL);
+
+    /* Start a marking cycle, the roots $pad and $holder are marked */
+    ASSERT_FALSE(heap->is_marking);
+    ASSERT_EQ(gci_gc_heap_step(heap), GC_SUCCESS);
+    ASSERT_TRUE(heap->is_marking);
+    ASSERT_TRUE(hmu_is_wo_marked(obj_to_hmu(holder)));
+
+    /* Expand $holder, the last root pushed, and the root of $pad, the
+       children of the tree are left to expand */
+    heap->mark_budget = 2 * hmu_get_size(obj_to_hmu(holder));
+    ASSERT_EQ(gci_gc_heap_step(heap), GC_SUCCESS);
+    ASSERT_TRUE(heap->is_marking);
+    ASSERT_FALSE(hmu_is_wo_gray(obj_to_hmu(holder)));
+
+    /* Store a new white object into $holder, which was expanded, the
+       write barrier must gray $holder so that it is expanded again */
+    argv[0] = 42;
+    ASSERT_TRUE(call_func("attach", 1, argv));
+    ASSERT_TRUE(heap->is_marking);
+    ASSERT_TRUE(hmu_is_wo_gray(obj_to_hmu(holder)));
+
+    wasm_struct_obj_get_field((wasm_struct_obj_t)holder, 0, false, &value);
+    obj = value.gc_obj;
+    ASSERT_TRUE(obj != NULL);
+    ASSERT_FALSE(hmu_is_wo_marked(obj_to_hmu(obj)));
+
+    /* Finish the marking cycle and sweep the heap */
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_FALSE(heap->is_marking);
+    ASSERT_FALSE(hmu_is_wo_gray(obj_to_hmu(holder)));
+    ASSERT_TRUE(is_live_wo(heap, obj));
+
+    ASSERT_TRUE(call_func("get", 0, argv));
+    ASSERT_EQ(argv[0], 42U);
+
+    /* The object is still reachable in the next collection */
+    ASSERT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+    ASSERT_TRUE(is_live_wo(heap, obj));
+    ASSERT_TRUE(call_func("get", 0, argv));
+    ASSERT_EQ(argv[0], 42U);
+}
+
+#endif /* end of WASM_ENABLE_GC_INCREMENTAL != 0 */
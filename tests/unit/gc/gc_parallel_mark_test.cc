@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include "gc_test_helper.h"
+#include "ems/ems_gc.h"
+#include "ems/ems_gc_internal.h"
+
+#if WASM_ENABLE_GC_PARALLEL_MARKING != 0
+
+/* Depth of the tree, a complete binary tree of depth 17 has 131071
+   nodes, about 4 MB, so that with the garbage of the previous tree more
+   than GC_PARALLEL_MARK_MIN_USED_SIZE of the heap is in use, and the heap
+   is marked in parallel when there are mark helpers */
+#define TREE_DEPTH 17
+
+/* The allocated size of a tree node, i.e. a struct with two refs and an
+   i32, including the hmu header */
+#define TREE_NODE_SIZE 32
+
+#define GC_HEAP_SIZE (16 * 1024 * 1024)
+
+#define MARK_HELPER_NUM 3
+
+class WasmGCParallelMarkTest : public WasmGCInstanceTest
+{
+  public:
+    /* Collect the GC heap with the given number of mark helpers, and
+       get the free size of the heap after the collection */
+    uint32 collect(uint32 helper_num)
+    {
+        void *heap = wasm_runtime_get_gc_heap_handle(module_inst);
+        uint32 stats[GC_STAT_MAX];
+
+#if WASM_ENABLE_GC_INCREMENTAL != 0
+        /* finish the marking cycle started by the allocations first, the
+           wos dropped after they were marked in it are still kept */
+        if (((gc_heap_t *)heap)->is_marking) {
+            EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+        }
+#endif
+
+        gc_set_mark_helper_num(heap, helper_num);
+        EXPECT_EQ(gci_gc_heap(heap), GC_SUCCESS);
+
+        gc_heap_stats(heap, stats, GC_STAT_MAX);
+        return stats[GC_STAT_FREE];
+    }
+};
+
+static uint32
+get_tree_sum(uint32 depth)
+{
+    uint32 sum = 0, d;
+
+    /* there are 2^(depth - d) nodes of depth d */
+    for (d = 1; d <= depth; d++)
+        sum += d << (depth - d);
+    return sum;
+}
+
+TEST_F(WasmGCParallelMarkTest, Same_live_set)
+{
+    uint32 argv[1], free_size_serial, free_size_parallel, free_size_empty;
+
+    ASSERT_TRUE(init_runtime(GC_HEAP_SIZE));
+    ASSERT_TRUE(instantiate("tree1.wasm")) << error_buf;
+
+    /* Build a tree and then another one, so that the first tree is
+       garbage when the heap is marked by the collecting thread only */
+    argv[0] = TREE_DEPTH;
+    ASSERT_TRUE(call_func("build_tree", 1, argv));
+    argv[0] = TREE_DEPTH;
+    ASSERT_TRUE(call_func("build_tree", 1, argv));
+    free_size_serial = collect(0);
+
+    ASSERT_TRUE(call_func("sum_tree", 0, argv));
+    ASSERT_EQ(argv[0], get_tree_sum(TREE_DEPTH));
+
+    /* Replace the tree again and mark the heap with the helpers, the live
+       set is the same, so the same size must be reclaimed */
+    argv[0] = TREE_DEPTH;
+    ASSERT_TRUE(call_func("build_tree", 1, argv));
+    free_size_parallel = collect(MARK_HELPER_NUM);
+    ASSERT_EQ(free_size_parallel, free_size_serial);
+
+    ASSERT_TRUE(call_func("sum_tree", 0, argv));
+    ASSERT_EQ(argv[0], get_tree_sum(TREE_DEPTH));
+
+    /* Drop the tree, all of its nodes must be reclaimed */
+    argv[0] = 0;
+    ASSERT_TRUE(call_func("build_tree", 1, argv));
+    free_size_empty = collect(MARK_HELPER_NUM);
+    ASSERT_GE(free_size_empty - free_size_parallel,
+              ((1U << TREE_DEPTH) - 1) * TREE_NODE_SIZE);
+
+    ASSERT_TRUE(call_func("sum_tree", 0, argv));
+    ASSERT_EQ(argv[0], 0U);
+}
+
+#endif /* end of WASM_ENABLE_GC_PARALLEL_MARKING != 0 */
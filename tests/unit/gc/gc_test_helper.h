@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#pragma once
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "gc_export.h"
+#include "wasm_runtime_common.h"
+#include "wasm_runtime.h"
+
+/* Fixture of the tests which run a wasm app with the GC heap of its
+   module instance, the runtime is initialized by each test with the GC
+   heap size it requires */
+class WasmGCInstanceTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp() { CWD = get_binary_path(); }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    bool init_runtime(uint32 gc_heap_size)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.gc_heap_size = gc_heap_size;
+
+        is_runtime_inited = wasm_runtime_full_init(&init_args);
+        return is_runtime_inited;
+    }
+
+    bool instantiate(const char *wasm_file)
+    {
+        std::string file = CWD + "/" + wasm_file;
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        if (!wasm_file_buf)
+            return false;
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        if (!module)
+            return false;
+
+        module_inst = wasm_runtime_instantiate(module, 64 * 1024, 0, error_buf,
+                                               sizeof(error_buf));
+        if (!module_inst)
+            return false;
+
+        exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+        return exec_env != NULL;
+    }
+
+    bool call_func(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+
+        return func && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    /* Read an exported global of GC reference type from the global data
+       of the module instance, wasm_runtime_get_export_global_inst doesn't
+       handle globals of these types */
+    wasm_obj_t get_global_obj(const char *name)
+    {
+        WASMModuleInstance *inst = (WASMModuleInstance *)module_inst;
+        WASMModule *wasm_module = inst->module;
+        WASMGlobalInstance *global;
+        uint32 i;
+
+        for (i = 0; i < wasm_module->export_count; i++) {
+            if (wasm_module->exports[i].kind == EXPORT_KIND_GLOBAL
+                && !strcmp(wasm_module->exports[i].name, name)) {
+                global = &inst->e->globals[wasm_module->exports[i].index];
+                return *(wasm_obj_t *)(inst->global_data
+                                       + global->data_offset);
+            }
+        }
+        return NULL;
+    }
+
+  public:
+    std::string CWD;
+    bool is_runtime_inited = false;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+    char error_buf[128];
+};
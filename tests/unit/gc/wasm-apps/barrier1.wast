@@ -0,0 +1,55 @@
+(module
+  (type $node (struct (field (mut (ref null $node))) (field (mut (ref null $node))) (field i32)))
+
+  ;; $pad keeps the marking cycle in progress after $holder was expanded
+  (global $pad (mut (ref null $node)) (ref.null $node))
+  (global $holder (export "holder") (mut (ref null $node)) (ref.null $node))
+
+  ;; build a complete binary tree, the value of a node is its depth
+  (func $build (param $depth i32) (result (ref null $node))
+    local.get $depth
+    i32.eqz
+    if (result (ref null $node))
+      ref.null $node
+    else
+      local.get $depth
+      i32.const 1
+      i32.sub
+      call $build
+      local.get $depth
+      i32.const 1
+      i32.sub
+      call $build
+      local.get $depth
+      struct.new $node
+    end
+  )
+
+  (func (export "init") (param $depth i32)
+    local.get $depth
+    call $build
+    global.set $pad
+    ref.null $node
+    ref.null $node
+    i32.const 1
+    struct.new $node
+    global.set $holder
+  )
+
+  ;; store a new node into $holder, the new node is only reachable
+  ;; from $holder
+  (func (export "attach") (param $value i32)
+    global.get $holder
+    ref.null $node
+    ref.null $node
+    local.get $value
+    struct.new $node
+    struct.set $node 0
+  )
+
+  (func (export "get") (result i32)
+    global.get $holder
+    struct.get $node 0
+    struct.get $node 2
+  )
+)
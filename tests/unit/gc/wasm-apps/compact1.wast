@@ -0,0 +1,59 @@
+(module
+  (type $node (struct (field (mut (ref null $node))) (field (mut (ref null $node))) (field i32)))
+
+  (global $list (export "list") (mut (ref null $node)) (ref.null $node))
+
+  ;; prepend $n nodes to the list, with a garbage node allocated before
+  ;; each of them, so that the heap is fragmented after collection
+  (func (export "fragment") (param $n i32)
+    (local $i i32)
+    loop
+      ref.null $node
+      ref.null $node
+      local.get $i
+      struct.new $node
+      drop
+      global.get $list
+      ref.null $node
+      local.get $i
+      struct.new $node
+      global.set $list
+      local.get $i
+      i32.const 1
+      i32.add
+      local.tee $i
+      local.get $n
+      i32.lt_u
+      br_if 0
+    end
+  )
+
+  (func (export "sum_list") (result i32)
+    (local $node (ref null $node))
+    (local $sum i32)
+    global.get $list
+    local.set $node
+    block
+      loop
+        local.get $node
+        ref.is_null
+        br_if 1
+        local.get $sum
+        local.get $node
+        struct.get $node 2
+        i32.add
+        local.set $sum
+        local.get $node
+        struct.get $node 0
+        local.set $node
+        br 0
+      end
+    end
+    local.get $sum
+  )
+
+  (func (export "clear")
+    ref.null $node
+    global.set $list
+  )
+)
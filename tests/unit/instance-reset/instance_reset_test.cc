@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <fstream>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+/* The linear memory data is saved to a memory file which is mapped over
+   the linear memory on reset, see wasm_memory_image_map() */
+#if defined(OS_ENABLE_MEMORY_FILE) && defined(OS_ENABLE_FILE_MAPPING) \
+    && defined(OS_ENABLE_HW_BOUND_CHECK) && WASM_MEM_ALLOC_WITH_USAGE == 0
+#define RESET_MAP_MEMORY 1
+#endif
+
+class InstanceResetTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp() { CWD = get_binary_path(); }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    bool init_runtime(uint32 pool_slot_count)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.linear_memory_pool_slot_count = pool_slot_count;
+
+        is_runtime_inited = wasm_runtime_full_init(&init_args);
+        return is_runtime_inited;
+    }
+
+    bool load(const char *wasm_file)
+    {
+        std::string file = CWD + "/" + wasm_file;
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        if (!wasm_file_buf)
+            return false;
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        return module != NULL;
+    }
+
+    bool instantiate(uint32 heap_size)
+    {
+        module_inst = wasm_runtime_instantiate(module, 16 * 1024, heap_size,
+                                               error_buf, sizeof(error_buf));
+        return module_inst != NULL;
+    }
+
+    void deinstantiate()
+    {
+        wasm_runtime_deinstantiate(module_inst);
+        module_inst = NULL;
+    }
+
+    bool set_reset_point()
+    {
+        return wasm_runtime_set_instance_reset_point(module_inst, error_buf,
+                                                     sizeof(error_buf));
+    }
+
+    bool reset()
+    {
+        return wasm_runtime_reset_instance(module_inst, error_buf,
+                                           sizeof(error_buf));
+    }
+
+    bool call_func(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+
+        if (func && exec_env
+            && wasm_runtime_call_wasm(exec_env, func, argc, argv))
+            return true;
+
+        wasm_runtime_clear_exception(module_inst);
+        return false;
+    }
+
+    uint32 call_i32(const char *name, uint32 arg = 0)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call_func(name, 1, argv)) << name;
+        return argv[0];
+    }
+
+    /* Check the state right after the instantiation of state.wasm */
+    void check_fresh_state()
+    {
+        uint32 argv[1] = { 65544 };
+
+        EXPECT_EQ(call_i32("mem_size"), 1U);
+        EXPECT_EQ(call_i32("load", 100), 0U);
+        EXPECT_FALSE(call_func("load", 1, argv));
+        EXPECT_EQ(call_i32("get_global"), 0U);
+        EXPECT_EQ(call_i32("call_slot", 0), 11U);
+        argv[0] = 1;
+        EXPECT_FALSE(call_func("call_slot", 1, argv));
+        argv[0] = 200;
+        EXPECT_TRUE(call_func("copy_data", 1, argv));
+        EXPECT_EQ(call_i32("load", 200), 0x6c6c6568U);
+    }
+
+    /* Check the state set by the "init" function of state.wasm */
+    void check_init_state()
+    {
+        uint32 argv[1] = { 131080 };
+
+        EXPECT_EQ(call_i32("mem_size"), 2U);
+        EXPECT_EQ(call_i32("load", 100), 0x1234U);
+        EXPECT_EQ(call_i32("load", 65544), 0x5678U);
+        EXPECT_FALSE(call_func("load", 1, argv));
+        EXPECT_EQ(call_i32("get_global"), 7U);
+        EXPECT_EQ(call_i32("call_slot", 0), 11U);
+        EXPECT_EQ(call_i32("call_slot", 1), 22U);
+        /* the data segment was dropped */
+        argv[0] = 200;
+        EXPECT_FALSE(call_func("copy_data", 1, argv));
+    }
+
+    /* Whether a memory image is mapped in the process */
+    bool is_image_mapped()
+    {
+        std::ifstream maps("/proc/self/maps");
+        std::stringstream content;
+
+        content << maps.rdbuf();
+        return content.str().find("wasm-memory-image") != std::string::npos;
+    }
+
+  public:
+    std::string CWD;
+    bool is_runtime_inited = false;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    char error_buf[128];
+};
+
+/* The linear memory grown after the reset point can only be shrunk when
+   it is reserved with mmap */
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(InstanceResetTest, Reset_to_instantiation)
+{
+    uint32 argv[1];
+    int i;
+
+    ASSERT_TRUE(init_runtime(0));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+    ASSERT_TRUE(instantiate(0)) << error_buf;
+
+    ASSERT_FALSE(reset());
+
+    ASSERT_TRUE(set_reset_point()) << error_buf;
+
+    for (i = 0; i < 3; i++) {
+        ASSERT_TRUE(call_func("init", 0, argv));
+        ASSERT_TRUE(call_func("mutate", 0, argv));
+        ASSERT_EQ(call_i32("mem_size"), 4U);
+        ASSERT_EQ(call_i32("get_global"), 99U);
+
+        ASSERT_TRUE(reset()) << error_buf;
+        check_fresh_state();
+    }
+#if RESET_MAP_MEMORY != 0
+    /* The saved memory data is mapped over the linear memory */
+    ASSERT_TRUE(is_image_mapped());
+#endif
+}
+
+TEST_F(InstanceResetTest, Reset_after_memory_grow)
+{
+    uint32 argv[1];
+    int i;
+
+    ASSERT_TRUE(init_runtime(0));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+    ASSERT_TRUE(instantiate(0)) << error_buf;
+
+    ASSERT_TRUE(call_func("init", 0, argv));
+    ASSERT_TRUE(set_reset_point()) << error_buf;
+
+    /* The memory grown after the reset point is shrunk back, and the
+       writes to the memory, the global and the table are dropped */
+    for (i = 0; i < 3; i++) {
+        ASSERT_TRUE(call_func("mutate", 0, argv));
+        ASSERT_EQ(call_i32("mem_size"), 4U);
+        ASSERT_EQ(call_i32("load", 100), 0x4321U);
+        ASSERT_EQ(call_i32("load", 131080), 0x9abcU);
+        ASSERT_EQ(call_i32("call_slot", 1), 11U);
+
+        ASSERT_TRUE(reset()) << error_buf;
+        check_init_state();
+    }
+
+    /* An exception is cleared by the reset */
+    ASSERT_TRUE(call_func("mutate", 0, argv));
+    wasm_runtime_set_exception(module_inst, "trapped");
+    ASSERT_TRUE(reset()) << error_buf;
+    ASSERT_EQ(wasm_runtime_get_exception(module_inst), nullptr);
+    check_init_state();
+}
+
+TEST_F(InstanceResetTest, Reset_pooled_memory)
+{
+    uint32 argv[1];
+    int i;
+
+    ASSERT_TRUE(init_runtime(1));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+
+    /* The only slot of the pool is reused by each instance, the image
+       mapped over it mustn't be seen by the next instance */
+    for (i = 0; i < 3; i++) {
+        ASSERT_TRUE(instantiate(0)) << error_buf;
+        check_fresh_state();
+
+        ASSERT_TRUE(call_func("init", 0, argv));
+        ASSERT_TRUE(set_reset_point()) << error_buf;
+
+        ASSERT_TRUE(call_func("mutate", 0, argv));
+        ASSERT_TRUE(reset()) << error_buf;
+        check_init_state();
+
+        ASSERT_TRUE(call_func("mutate", 0, argv));
+        deinstantiate();
+    }
+}
+#endif
+
+TEST_F(InstanceResetTest, Reset_app_heap)
+{
+    uint64 offsets[4];
+    void *native_addr;
+    int i;
+
+    ASSERT_TRUE(init_runtime(0));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+    ASSERT_TRUE(instantiate(16 * 1024)) << error_buf;
+
+    ASSERT_TRUE(wasm_runtime_module_malloc(module_inst, 100, &native_addr));
+    ASSERT_TRUE(set_reset_point()) << error_buf;
+
+    /* The blocks allocated after the reset point are freed by the reset,
+       and the same blocks are allocated again */
+    for (i = 0; i < 4; i++) {
+        offsets[i] = wasm_runtime_module_malloc(module_inst, 1000, NULL);
+        ASSERT_NE(offsets[i], 0U);
+    }
+    memset(wasm_runtime_addr_app_to_native(module_inst, offsets[0]), 0xff,
+           1000);
+
+    ASSERT_TRUE(reset()) << error_buf;
+    for (i = 0; i < 4; i++) {
+        ASSERT_EQ(wasm_runtime_module_malloc(module_inst, 1000, NULL),
+                  offsets[i]);
+    }
+    native_addr = wasm_runtime_addr_app_to_native(module_inst, offsets[0]);
+    ASSERT_EQ(*(uint8 *)native_addr, 0);
+}
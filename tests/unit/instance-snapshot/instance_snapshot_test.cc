@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+/* The linear memory is mapped from the snapshot file when it is reserved
+   with mmap, see wasm_instance_snapshot.c */
+#if defined(OS_ENABLE_FILE_MAPPING) && defined(OS_ENABLE_HW_BOUND_CHECK)
+#define SNAPSHOT_MAP_MEMORY 1
+#endif
+
+class InstanceSnapshotTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        CWD = get_binary_path();
+        snapshot_file = CWD + "/state.snapshot";
+    }
+
+    void TearDown()
+    {
+        for (wasm_module_inst_t inst : insts)
+            wasm_runtime_deinstantiate(inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+        unlink(snapshot_file.c_str());
+    }
+
+  public:
+    bool init_runtime(uint32 pool_slot_count)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.linear_memory_pool_slot_count = pool_slot_count;
+
+        is_runtime_inited = wasm_runtime_full_init(&init_args);
+        return is_runtime_inited;
+    }
+
+    bool load(const char *wasm_file)
+    {
+        std::string file = CWD + "/" + wasm_file;
+        uint32 wasm_file_size;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        if (!wasm_file_buf)
+            return false;
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        return module != NULL;
+    }
+
+    wasm_module_inst_t instantiate()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate(
+            module, 16 * 1024, 0, error_buf, sizeof(error_buf));
+
+        if (inst)
+            insts.push_back(inst);
+        return inst;
+    }
+
+    wasm_module_inst_t restore()
+    {
+        wasm_module_inst_t inst = wasm_runtime_instantiate_from_snapshot(
+            module, NULL, snapshot_file.c_str(), error_buf, sizeof(error_buf));
+
+        if (inst)
+            insts.push_back(inst);
+        return inst;
+    }
+
+    void deinstantiate(wasm_module_inst_t inst)
+    {
+        insts.erase(std::find(insts.begin(), insts.end(), inst));
+        wasm_runtime_deinstantiate(inst);
+    }
+
+    bool call_func(wasm_module_inst_t inst, const char *name, uint32 argc,
+                   uint32 argv[])
+    {
+        wasm_function_inst_t func = wasm_runtime_lookup_function(inst, name);
+        wasm_exec_env_t exec_env = wasm_runtime_get_exec_env_singleton(inst);
+
+        if (func && exec_env
+            && wasm_runtime_call_wasm(exec_env, func, argc, argv))
+            return true;
+
+        wasm_runtime_clear_exception(inst);
+        return false;
+    }
+
+    uint32 call_i32(wasm_module_inst_t inst, const char *name, uint32 arg = 0)
+    {
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(call_func(inst, name, 1, argv)) << name;
+        return argv[0];
+    }
+
+    /* Check the state set by the "init" function of state.wasm */
+    void check_init_state(wasm_module_inst_t inst)
+    {
+        uint32 argv[1] = { 200 };
+
+        EXPECT_EQ(call_i32(inst, "mem_size"), 2U);
+        EXPECT_EQ(call_i32(inst, "load", 100), 0x1234U);
+        EXPECT_EQ(call_i32(inst, "load", 65544), 0x5678U);
+        EXPECT_EQ(call_i32(inst, "get_global"), 7U);
+        EXPECT_EQ(call_i32(inst, "call_slot", 0), 11U);
+        EXPECT_EQ(call_i32(inst, "call_slot", 1), 22U);
+        /* the data segment was dropped */
+        EXPECT_FALSE(call_func(inst, "copy_data", 1, argv));
+    }
+
+    /* Whether the snapshot file is mapped in the process */
+    bool is_snapshot_mapped()
+    {
+        std::ifstream maps("/proc/self/maps");
+        std::stringstream content;
+
+        content << maps.rdbuf();
+        return content.str().find(snapshot_file) != std::string::npos;
+    }
+
+  public:
+    std::string CWD;
+    std::string snapshot_file;
+    bool is_runtime_inited = false;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    std::vector<wasm_module_inst_t> insts;
+    char error_buf[128];
+};
+
+TEST_F(InstanceSnapshotTest, Save_and_restore)
+{
+    wasm_module_inst_t inst, restored, restored2;
+    uint32 argv[1];
+
+    ASSERT_TRUE(init_runtime(0));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+    ASSERT_TRUE(inst = instantiate()) << error_buf;
+
+    ASSERT_TRUE(call_func(inst, "init", 0, argv));
+    ASSERT_TRUE(wasm_runtime_snapshot_instance(inst, snapshot_file.c_str(),
+                                               error_buf, sizeof(error_buf)))
+        << error_buf;
+
+    /* The data segments aren't copied and the memory is grown to the
+       saved size, the globals, the table and the dropped segments are
+       restored */
+    ASSERT_TRUE(restored = restore()) << error_buf;
+    check_init_state(restored);
+
+#if SNAPSHOT_MAP_MEMORY != 0
+    /* The linear memory is mapped from the file copy-on-write */
+    ASSERT_TRUE(is_snapshot_mapped());
+#endif
+
+    /* The writes to a restored instance are private */
+    ASSERT_TRUE(call_func(restored, "mutate", 0, argv));
+    ASSERT_EQ(call_i32(restored, "load", 100), 0x4321U);
+    ASSERT_EQ(call_i32(restored, "mem_size"), 4U);
+
+    ASSERT_TRUE(restored2 = restore()) << error_buf;
+    check_init_state(restored2);
+    check_init_state(inst);
+
+    /* The restored memory is unmapped with the instance */
+    deinstantiate(restored);
+    deinstantiate(restored2);
+    ASSERT_FALSE(is_snapshot_mapped());
+}
+
+#ifdef OS_ENABLE_HW_BOUND_CHECK
+TEST_F(InstanceSnapshotTest, Restore_pooled_memory)
+{
+    wasm_module_inst_t inst, restored;
+    uint32 argv[1];
+    int i;
+
+    ASSERT_TRUE(init_runtime(2));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+    ASSERT_TRUE(inst = instantiate()) << error_buf;
+
+    ASSERT_TRUE(call_func(inst, "init", 0, argv));
+    ASSERT_TRUE(wasm_runtime_snapshot_instance(inst, snapshot_file.c_str(),
+                                               error_buf, sizeof(error_buf)))
+        << error_buf;
+
+    /* The pooled linear memory is discarded and reused instead of being
+       unmapped, so the snapshot is read into it instead of mapped, and a
+       slot reused must not keep the writes of its last instance */
+    for (i = 0; i < 3; i++) {
+        ASSERT_TRUE(restored = restore()) << error_buf;
+        check_init_state(restored);
+        ASSERT_FALSE(is_snapshot_mapped());
+
+        ASSERT_TRUE(call_func(restored, "mutate", 0, argv));
+        ASSERT_EQ(call_i32(restored, "load", 131080), 0x9abcU);
+        deinstantiate(restored);
+    }
+
+    check_init_state(inst);
+}
+#endif
+
+TEST_F(InstanceSnapshotTest, Reject_invalid_snapshot)
+{
+    wasm_module_inst_t inst;
+    FILE *fp;
+
+    ASSERT_TRUE(init_runtime(0));
+    ASSERT_TRUE(load("state.wasm")) << error_buf;
+
+    ASSERT_FALSE(restore());
+
+    ASSERT_TRUE(fp = fopen(snapshot_file.c_str(), "wb"));
+    ASSERT_EQ(fwrite("not a snapshot", 1, 14, fp), 14U);
+    fclose(fp);
+
+    error_buf[0] = '\0';
+    ASSERT_FALSE(restore());
+    ASSERT_NE(error_buf[0], '\0');
+
+    /* A valid instance is still created from the module */
+    ASSERT_TRUE(inst = instantiate()) << error_buf;
+    ASSERT_EQ(call_i32(inst, "mem_size"), 1U);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+class LazyValidationTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        std::string file;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        file = CWD + "/lazy.wasm";
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL);
+    }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    wasm_module_t load_lazily(uint32 size)
+    {
+        LoadArgs load_args;
+
+        memset(&load_args, 0, sizeof(LoadArgs));
+        load_args.name = (char *)"lazy";
+        load_args.lazy_validation = true;
+
+        return wasm_runtime_load_ex(wasm_file_buf, size, &load_args,
+                                    error_buf, sizeof(error_buf));
+    }
+
+    bool call_func(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+
+        EXPECT_TRUE(func != NULL) << name;
+        return func && exec_env
+               && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+  public:
+    std::string CWD;
+    unsigned char *wasm_file_buf = NULL;
+    uint32 wasm_file_size = 0;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    char error_buf[128];
+};
+
+TEST_F(LazyValidationTest, Invalid_function_raises_on_call)
+{
+    std::string load_error;
+    const char *exception;
+    uint32 argv[1];
+    int i;
+
+    /* The invalid function body fails the eager loading, which is given
+       a copy as the loader may rewrite the bytecode */
+    std::vector<uint8> buf(wasm_file_buf, wasm_file_buf + wasm_file_size);
+    ASSERT_FALSE(wasm_runtime_load(buf.data(), wasm_file_size, error_buf,
+                                   sizeof(error_buf)));
+    load_error = error_buf;
+    ASSERT_NE(load_error.find("type mismatch"), std::string::npos)
+        << load_error;
+
+    /* Only the module structure is validated when loading lazily */
+    ASSERT_TRUE(module = load_lazily(wasm_file_size)) << error_buf;
+    ASSERT_TRUE(module_inst = wasm_runtime_instantiate(
+                    module, 16 * 1024, 0, error_buf, sizeof(error_buf)))
+        << error_buf;
+
+    ASSERT_TRUE(call_func("ok", 0, argv));
+    ASSERT_EQ(argv[0], 42U);
+
+    /* The error of the eager loading is raised each time the function is
+       called, directly or from another function */
+    for (i = 0; i < 2; i++) {
+        ASSERT_FALSE(call_func("bad", 0, argv));
+        ASSERT_TRUE(exception = wasm_runtime_get_exception(module_inst));
+        EXPECT_NE(std::string(exception).find(load_error), std::string::npos)
+            << exception;
+        wasm_runtime_clear_exception(module_inst);
+
+        ASSERT_FALSE(call_func("call_bad", 0, argv));
+        ASSERT_TRUE(exception = wasm_runtime_get_exception(module_inst));
+        EXPECT_NE(std::string(exception).find(load_error), std::string::npos)
+            << exception;
+        wasm_runtime_clear_exception(module_inst);
+    }
+
+    /* The valid functions still run, including the ones first called
+       after the failure */
+    argv[0] = 100;
+    ASSERT_TRUE(call_func("sum", 1, argv));
+    ASSERT_EQ(argv[0], 5050U);
+    ASSERT_TRUE(call_func("ok", 0, argv));
+    ASSERT_EQ(argv[0], 42U);
+}
+
+TEST_F(LazyValidationTest, Invalid_structure_fails_loading)
+{
+    /* The code section is cut in the middle of the last function body */
+    ASSERT_FALSE(load_lazily(wasm_file_size - 4));
+    ASSERT_NE(error_buf[0], '\0');
+}
@@ -0,0 +1,29 @@
+;; The module is valid except the body of "bad", it can only be loaded
+;; with LoadArgs::lazy_validation
+(module
+  (func (export "ok") (result i32)
+    (i32.const 42)
+  )
+
+  ;; type mismatch: i32.add of an i32 and an i64
+  (func $bad (export "bad") (result i32)
+    (i32.const 1)
+    (i64.const 2)
+    i32.add
+  )
+
+  (func (export "call_bad") (result i32)
+    (call $bad)
+  )
+
+  ;; the sum of 1 to n, n > 0
+  (func (export "sum") (param $n i32) (result i32)
+    (local $s i32)
+    loop
+      (local.set $s (i32.add (local.get $s) (local.get $n)))
+      (local.tee $n (i32.sub (local.get $n) (i32.const 1)))
+      br_if 0
+    end
+    (local.get $s)
+  )
+)
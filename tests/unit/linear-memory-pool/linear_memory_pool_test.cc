@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "wasm_memory.h"
+#include "wasm_runtime.h"
+
+#define PAGE_SIZE 65536
+
+/* The data segment of image.wasm, see gen_image.py */
+#define IMAGE_DATA_SIZE (64 * 1024 + 100)
+#define IMAGE_DATA 0xA5A5A5A5u
+
+class LinearMemoryPoolTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp() { CWD = get_binary_path(); }
+
+    void TearDown()
+    {
+        for (auto module : modules)
+            wasm_runtime_unload(module);
+        for (auto wasm_file_buf : wasm_file_bufs)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    void init(uint32 slot_count)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.linear_memory_pool_slot_count = slot_count;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        is_runtime_inited = true;
+    }
+
+    wasm_module_t load(const char *wasm_file)
+    {
+        std::string file = CWD + "/" + wasm_file;
+        unsigned char *wasm_file_buf;
+        uint32 wasm_file_size;
+        wasm_module_t module;
+
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        EXPECT_TRUE(wasm_file_buf != NULL);
+        if (!wasm_file_buf)
+            return NULL;
+        wasm_file_bufs.push_back(wasm_file_buf);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        EXPECT_TRUE(module != NULL) << error_buf;
+        if (module)
+            modules.push_back(module);
+        return module;
+    }
+
+    wasm_module_inst_t instantiate(wasm_module_t module)
+    {
+        /* No app heap is inserted into the linear memory */
+        wasm_module_inst_t module_inst = wasm_runtime_instantiate(
+            module, 8192, 0, error_buf, sizeof(error_buf));
+
+        EXPECT_TRUE(module_inst != NULL) << error_buf;
+        return module_inst;
+    }
+
+    static uint8 *get_memory_data(wasm_module_inst_t module_inst)
+    {
+        return (uint8 *)wasm_memory_get_base_address(
+            wasm_runtime_get_default_memory(module_inst));
+    }
+
+    static bool call(wasm_module_inst_t module_inst, const char *name,
+                     uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+
+        return func && exec_env
+               && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    static void store(wasm_module_inst_t module_inst, uint32 addr,
+                      uint32 value)
+    {
+        uint32 argv[2] = { addr, value };
+
+        ASSERT_TRUE(call(module_inst, "store", 2, argv))
+            << wasm_runtime_get_exception(module_inst);
+    }
+
+    static uint32 load_i32(wasm_module_inst_t module_inst, uint32 addr)
+    {
+        uint32 argv[1] = { addr };
+
+        EXPECT_TRUE(call(module_inst, "load", 1, argv))
+            << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+    static uint32 grow(wasm_module_inst_t module_inst, uint32 delta)
+    {
+        uint32 argv[1] = { delta };
+
+        EXPECT_TRUE(call(module_inst, "grow", 1, argv))
+            << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+    static bool is_zeroed(const uint8 *data, uint32 size)
+    {
+        uint32 i;
+
+        for (i = 0; i < size; i++) {
+            if (data[i])
+                return false;
+        }
+        return true;
+    }
+
+  public:
+    std::string CWD;
+    bool is_runtime_inited = false;
+    std::vector<unsigned char *> wasm_file_bufs;
+    std::vector<wasm_module_t> modules;
+    char error_buf[128];
+};
+
+/* See WASM_ENABLE_LINEAR_MEMORY_POOL of wasm_memory.c */
+#if defined(OS_ENABLE_HW_BOUND_CHECK) && defined(OS_ENABLE_MEM_DISCARD)
+TEST_F(LinearMemoryPoolTest, Reused_slot_reads_zeros)
+{
+    wasm_module_t module;
+    wasm_module_inst_t module_inst;
+    uint8 *memory_data;
+
+    init(2);
+    ASSERT_TRUE(module = load("pool.wasm"));
+
+    ASSERT_TRUE(module_inst = instantiate(module));
+    memory_data = get_memory_data(module_inst);
+    ASSERT_TRUE(wasm_linear_memory_pool_contains(memory_data));
+
+    /* Dirty the initial page and the grown pages */
+    store(module_inst, 0, 0x11111111);
+    store(module_inst, PAGE_SIZE - 4, 0x22222222);
+    EXPECT_EQ(grow(module_inst, 2), 1u);
+    store(module_inst, PAGE_SIZE * 2 + 100, 0x33333333);
+    EXPECT_EQ(load_i32(module_inst, PAGE_SIZE * 2 + 100), 0x33333333u);
+    wasm_runtime_deinstantiate(module_inst);
+
+    /* The slot released last is taken by the next instance, which has
+       the initial size and reads zeros only, in the grown pages too */
+    ASSERT_TRUE(module_inst = instantiate(module));
+    EXPECT_EQ(get_memory_data(module_inst), memory_data);
+    EXPECT_EQ(wasm_memory_get_cur_page_count(
+                  wasm_runtime_get_default_memory(module_inst)),
+              1u);
+    EXPECT_EQ(load_i32(module_inst, 0), 0u);
+    EXPECT_EQ(load_i32(module_inst, PAGE_SIZE - 4), 0u);
+    EXPECT_TRUE(is_zeroed(memory_data, PAGE_SIZE));
+
+    EXPECT_EQ(grow(module_inst, 3), 1u);
+    EXPECT_EQ(load_i32(module_inst, PAGE_SIZE * 2 + 100), 0u);
+    EXPECT_TRUE(is_zeroed(memory_data, PAGE_SIZE * 4));
+    wasm_runtime_deinstantiate(module_inst);
+}
+
+TEST_F(LinearMemoryPoolTest, Mapped_when_slots_are_used_up)
+{
+    wasm_module_t module;
+    wasm_module_inst_t module_insts[3];
+    uint8 *memory_data[3];
+    uint32 i;
+
+    init(2);
+    ASSERT_TRUE(module = load("pool.wasm"));
+
+    for (i = 0; i < 3; i++) {
+        ASSERT_TRUE(module_insts[i] = instantiate(module));
+        memory_data[i] = get_memory_data(module_insts[i]);
+        store(module_insts[i], 8, i + 1);
+    }
+    EXPECT_TRUE(wasm_linear_memory_pool_contains(memory_data[0]));
+    EXPECT_TRUE(wasm_linear_memory_pool_contains(memory_data[1]));
+    EXPECT_FALSE(wasm_linear_memory_pool_contains(memory_data[2]));
+
+    /* The memories don't share any page */
+    for (i = 0; i < 3; i++)
+        EXPECT_EQ(load_i32(module_insts[i], 8), i + 1);
+
+    /* Only the pooled memories go back to the pool */
+    wasm_runtime_deinstantiate(module_insts[2]);
+    wasm_runtime_deinstantiate(module_insts[0]);
+    ASSERT_TRUE(module_insts[0] = instantiate(module));
+    EXPECT_EQ(get_memory_data(module_insts[0]), memory_data[0]);
+    EXPECT_EQ(load_i32(module_insts[0], 8), 0u);
+    EXPECT_EQ(load_i32(module_insts[1], 8), 2u);
+
+    wasm_runtime_deinstantiate(module_insts[0]);
+    wasm_runtime_deinstantiate(module_insts[1]);
+}
+
+#if WASM_ENABLE_MEMORY_IMAGE != 0
+TEST_F(LinearMemoryPoolTest, Released_slot_scrubbed_of_memory_image)
+{
+    wasm_module_t image_module, module;
+    wasm_module_inst_t module_inst;
+    uint8 *memory_data;
+
+    init(1);
+    ASSERT_TRUE(image_module = load("image.wasm"));
+    ASSERT_TRUE(module = load("pool.wasm"));
+    ASSERT_TRUE(((WASMModule *)image_module)->memory_image != NULL);
+
+    /* The image is mapped over the pooled memory, a written page becomes
+       private to the instance */
+    ASSERT_TRUE(module_inst = instantiate(image_module));
+    memory_data = get_memory_data(module_inst);
+    ASSERT_TRUE(wasm_linear_memory_pool_contains(memory_data));
+    EXPECT_EQ(load_i32(module_inst, 0), IMAGE_DATA);
+    EXPECT_EQ(load_i32(module_inst, IMAGE_DATA_SIZE - 4), IMAGE_DATA);
+    EXPECT_EQ(load_i32(module_inst, IMAGE_DATA_SIZE), 0u);
+    store(module_inst, 0, 0x12345678);
+    store(module_inst, IMAGE_DATA_SIZE, 0x12345678);
+    wasm_runtime_deinstantiate(module_inst);
+
+    /* The slot taken by a module without image reads zeros only, neither
+       the image nor the writes to it come back */
+    ASSERT_TRUE(module_inst = instantiate(module));
+    ASSERT_EQ(get_memory_data(module_inst), memory_data);
+    EXPECT_EQ(load_i32(module_inst, 0), 0u);
+    EXPECT_EQ(grow(module_inst, 1), 1u);
+    EXPECT_EQ(load_i32(module_inst, IMAGE_DATA_SIZE), 0u);
+    EXPECT_TRUE(is_zeroed(memory_data, PAGE_SIZE * 2));
+    wasm_runtime_deinstantiate(module_inst);
+
+    /* The image module gets the content of the image again */
+    ASSERT_TRUE(module_inst = instantiate(image_module));
+    ASSERT_EQ(get_memory_data(module_inst), memory_data);
+    EXPECT_EQ(load_i32(module_inst, 0), IMAGE_DATA);
+    EXPECT_EQ(load_i32(module_inst, IMAGE_DATA_SIZE), 0u);
+    wasm_runtime_deinstantiate(module_inst);
+}
+#endif
+#endif /* end of defined(OS_ENABLE_HW_BOUND_CHECK) \
+          && defined(OS_ENABLE_MEM_DISCARD) */
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) 2019 Intel Corporation.  All rights reserved.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+#
+
+"""
+Generate image.wasm, the functions of pool.wast with a data segment large
+enough for the loader to build a memory image of it:
+
+  (memory 2 4)
+  (data (i32.const 0) "\\a5\\a5...")  ;; DATA_SIZE bytes
+"""
+
+import sys
+
+# At least WASM_MEMORY_IMAGE_MIN_DATA_SIZE, and not a multiple of the
+# page size
+DATA_SIZE = 64 * 1024 + 100
+DATA_BYTE = 0xA5
+
+
+def leb(n):
+    out = b""
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out += bytes([b | 0x80])
+        else:
+            return out + bytes([b])
+
+
+def vec(items):
+    return leb(len(items)) + b"".join(items)
+
+
+def section(id, body):
+    return bytes([id]) + leb(len(body)) + body
+
+
+def name(s):
+    return leb(len(s)) + s.encode()
+
+
+def code(locals_, insns):
+    body = vec(locals_) + insns + b"\x0b"
+    return leb(len(body)) + body
+
+
+def main(path):
+    i32 = b"\x7f"
+    data = bytes([DATA_BYTE]) * DATA_SIZE
+
+    module = b"\x00asm\x01\x00\x00\x00"
+    module += section(
+        1,
+        vec(
+            [
+                b"\x60" + vec([i32, i32]) + vec([]),
+                b"\x60" + vec([i32]) + vec([i32]),
+            ]
+        ),
+    )
+    module += section(3, vec([leb(0), leb(1), leb(1)]))
+    module += section(5, vec([b"\x01" + leb(2) + leb(4)]))
+    module += section(
+        7,
+        vec(
+            [
+                name("store") + b"\x00" + leb(0),
+                name("load") + b"\x00" + leb(1),
+                name("grow") + b"\x00" + leb(2),
+            ]
+        ),
+    )
+    module += section(
+        10,
+        vec(
+            [
+                code([], b"\x20\x00\x20\x01\x36\x02\x00"),
+                code([], b"\x20\x00\x28\x02\x00"),
+                code([], b"\x20\x00\x40\x00"),
+            ]
+        ),
+    )
+    module += section(11, vec([b"\x00\x41\x00\x0b" + leb(len(data)) + data]))
+
+    with open(path, "wb") as f:
+        f.write(module)
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "image.wasm")
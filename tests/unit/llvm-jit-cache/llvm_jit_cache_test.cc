@@ -0,0 +1,361 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+/* fib(20) and the sum of the bytes 1 to 8 */
+#define FIB_RESULT 6765
+#define SUM_RESULT 36
+
+static uint32
+buf_sum_wrapper(wasm_exec_env_t exec_env, uint8 *buf, uint32 len)
+{
+    uint32 sum = 0, i;
+
+    for (i = 0; i < len; i++)
+        sum += buf[i];
+    return sum;
+}
+
+/* Same as buf_sum_wrapper, but the buffer is passed as an app offset,
+   which is converted by the native function itself */
+static uint32
+buf_sum_offset_wrapper(wasm_exec_env_t exec_env, uint32 offset, uint32 len)
+{
+    wasm_module_inst_t module_inst = wasm_runtime_get_module_inst(exec_env);
+
+    if (!wasm_runtime_validate_app_addr(module_inst, offset, len))
+        return 0;
+    return buf_sum_wrapper(
+        exec_env,
+        (uint8 *)wasm_runtime_addr_app_to_native(module_inst, offset), len);
+}
+
+static NativeSymbol buf_sum_symbols[] = {
+    { "buf_sum", (void *)buf_sum_wrapper, "(*~)i", NULL },
+};
+
+static NativeSymbol buf_sum_offset_symbols[] = {
+    { "buf_sum", (void *)buf_sum_offset_wrapper, "(ii)i", NULL },
+};
+
+typedef struct AppResult {
+    bool success;
+    uint32 fib_result;
+    uint32 sum_result;
+    char error_buf[128];
+} AppResult;
+
+static bool
+run_app_in_child(const std::string &wasm_file, const std::string &cache_dir,
+                 uint32 opt_level, NativeSymbol *native_symbols,
+                 AppResult *result)
+{
+    RuntimeInitArgs init_args;
+    unsigned char *wasm_file_buf = NULL;
+    uint32 wasm_file_size, argv[1];
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env;
+    wasm_function_inst_t func;
+    bool ret = false;
+
+    memset(&init_args, 0, sizeof(RuntimeInitArgs));
+    init_args.mem_alloc_type = Alloc_With_System_Allocator;
+    init_args.running_mode = Mode_LLVM_JIT;
+    init_args.llvm_jit_opt_level = opt_level;
+    init_args.llvm_jit_size_level = 3;
+    init_args.llvm_jit_cache_dir = cache_dir.c_str();
+    init_args.native_module_name = "env";
+    init_args.native_symbols = native_symbols;
+    init_args.n_native_symbols = 1;
+
+    if (!wasm_runtime_full_init(&init_args))
+        return false;
+
+    if (!(wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+              wasm_file.c_str(), &wasm_file_size))
+        || !(module = wasm_runtime_load(wasm_file_buf, wasm_file_size,
+                                        result->error_buf,
+                                        sizeof(result->error_buf)))
+        || !(module_inst = wasm_runtime_instantiate(
+                 module, 8 * 1024, 0, result->error_buf,
+                 sizeof(result->error_buf)))
+        || !(exec_env = wasm_runtime_get_exec_env_singleton(module_inst)))
+        goto fail;
+
+    argv[0] = 20;
+    if (!(func = wasm_runtime_lookup_function(module_inst, "fib"))
+        || !wasm_runtime_call_wasm(exec_env, func, 1, argv))
+        goto fail;
+    result->fib_result = argv[0];
+
+    if (!(func = wasm_runtime_lookup_function(module_inst, "sum"))
+        || !wasm_runtime_call_wasm(exec_env, func, 0, argv))
+        goto fail;
+    result->sum_result = argv[0];
+
+    ret = true;
+
+fail:
+    if (module_inst)
+        wasm_runtime_deinstantiate(module_inst);
+    if (module)
+        wasm_runtime_unload(module);
+    if (wasm_file_buf)
+        BH_FREE(wasm_file_buf);
+    wasm_runtime_destroy();
+    return ret;
+}
+
+class LLVMJITCacheTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        char dir[] = "/tmp/wamr-jit-cache-XXXXXX";
+
+        CWD = get_binary_path();
+        ASSERT_TRUE(mkdtemp(dir) != NULL);
+        cache_dir = dir;
+    }
+
+    void TearDown()
+    {
+        DIR *dir = opendir(cache_dir.c_str());
+        struct dirent *entry;
+
+        if (dir) {
+            while ((entry = readdir(dir))) {
+                if (strcmp(entry->d_name, ".") && strcmp(entry->d_name, ".."))
+                    unlink((cache_dir + "/" + entry->d_name).c_str());
+            }
+            closedir(dir);
+        }
+        rmdir(cache_dir.c_str());
+    }
+
+  public:
+    /* Load the app with the JIT code cache and call its exports in a
+       child process, like a later run of the app, since LLVM can't be
+       initialized again after the runtime is destroyed */
+    bool run_app(uint32 opt_level, NativeSymbol *native_symbols)
+    {
+        AppResult result;
+        int fds[2], status;
+        pid_t pid;
+        bool ret;
+
+        memset(&result, 0, sizeof(AppResult));
+        if (pipe(fds) != 0)
+            return false;
+
+        if ((pid = fork()) == 0) {
+            close(fds[0]);
+            result.success =
+                run_app_in_child(CWD + "/cache1.wasm", cache_dir, opt_level,
+                                 native_symbols, &result);
+            _exit(write(fds[1], &result, sizeof(AppResult))
+                          == (ssize_t)sizeof(AppResult)
+                      ? 0
+                      : 1);
+        }
+
+        close(fds[1]);
+        if (pid < 0) {
+            close(fds[0]);
+            return false;
+        }
+
+        /* The result is incomplete if the child crashed */
+        ret = read(fds[0], &result, sizeof(AppResult))
+              == (ssize_t)sizeof(AppResult);
+        close(fds[0]);
+        ret = waitpid(pid, &status, 0) == pid && WIFEXITED(status)
+              && WEXITSTATUS(status) == 0 && ret && result.success;
+
+        fib_result = result.fib_result;
+        sum_result = result.sum_result;
+        bh_memcpy_s(error_buf, sizeof(error_buf), result.error_buf,
+                    sizeof(result.error_buf));
+        return ret;
+    }
+
+    std::vector<std::string> get_cache_files()
+    {
+        std::vector<std::string> files;
+        DIR *dir = opendir(cache_dir.c_str());
+        struct dirent *entry;
+        size_t len;
+
+        if (!dir)
+            return files;
+        while ((entry = readdir(dir))) {
+            len = strlen(entry->d_name);
+            if (len > 5 && !strcmp(entry->d_name + len - 5, ".wjit"))
+                files.push_back(cache_dir + "/" + entry->d_name);
+        }
+        closedir(dir);
+        return files;
+    }
+
+    /* A cache file is replaced by renaming a new file to it, so that
+       it is rewritten if and only if its inode changes */
+    ino_t get_inode(const std::string &path)
+    {
+        struct stat st;
+
+        return stat(path.c_str(), &st) == 0 ? st.st_ino : 0;
+    }
+
+  public:
+    std::string CWD;
+    std::string cache_dir;
+    uint32 fib_result = 0;
+    uint32 sum_result = 0;
+    char error_buf[128];
+};
+
+TEST_F(LLVMJITCacheTest, Miss_then_hit)
+{
+    std::vector<std::string> files;
+    ino_t inode;
+
+    /* The code is compiled and saved to the empty cache */
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(fib_result, (uint32)FIB_RESULT);
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    files = get_cache_files();
+    ASSERT_EQ(files.size(), 1U);
+    inode = get_inode(files[0]);
+    ASSERT_NE(inode, (ino_t)0);
+
+    /* The cached code is loaded and the file is left as it is */
+    fib_result = sum_result = 0;
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(fib_result, (uint32)FIB_RESULT);
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files(), files);
+    ASSERT_EQ(get_inode(files[0]), inode);
+}
+
+TEST_F(LLVMJITCacheTest, Corrupted_file_is_ignored)
+{
+    std::vector<std::string> files;
+    struct stat st;
+    ino_t inode;
+    FILE *fp;
+    int ch;
+
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    files = get_cache_files();
+    ASSERT_EQ(files.size(), 1U);
+    inode = get_inode(files[0]);
+
+    /* Flip the last byte of the object, the header is kept valid */
+    ASSERT_EQ(stat(files[0].c_str(), &st), 0);
+    ASSERT_TRUE((fp = fopen(files[0].c_str(), "r+b")) != NULL);
+    ASSERT_EQ(fseek(fp, (long)st.st_size - 1, SEEK_SET), 0);
+    ch = fgetc(fp);
+    ASSERT_EQ(fseek(fp, (long)st.st_size - 1, SEEK_SET), 0);
+    fputc(ch ^ 0xFF, fp);
+    fclose(fp);
+
+    /* The file is ignored, the code is compiled and saved again */
+    fib_result = sum_result = 0;
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(fib_result, (uint32)FIB_RESULT);
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files(), files);
+    ASSERT_NE(get_inode(files[0]), inode);
+
+    /* Truncate the file into the middle of the header */
+    ASSERT_EQ(truncate(files[0].c_str(), 16), 0);
+    inode = get_inode(files[0]);
+
+    fib_result = sum_result = 0;
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(fib_result, (uint32)FIB_RESULT);
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_NE(get_inode(files[0]), inode);
+
+    /* And the file saved is valid */
+    inode = get_inode(files[0]);
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(get_inode(files[0]), inode);
+}
+
+TEST_F(LLVMJITCacheTest, Changed_options_miss)
+{
+    std::vector<std::string> files;
+    ino_t inode;
+
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    files = get_cache_files();
+    ASSERT_EQ(files.size(), 1U);
+    inode = get_inode(files[0]);
+
+    /* Another opt level is another configuration */
+    fib_result = sum_result = 0;
+    ASSERT_TRUE(run_app(1, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(fib_result, (uint32)FIB_RESULT);
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files().size(), 2U);
+    ASSERT_EQ(get_inode(files[0]), inode);
+
+    /* Both of them are hit then */
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_TRUE(run_app(1, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(get_cache_files().size(), 2U);
+    ASSERT_EQ(get_inode(files[0]), inode);
+}
+
+TEST_F(LLVMJITCacheTest, Changed_import_signature_miss)
+{
+    /* The caller converts the app offset to the native address for the
+       "(*~)i" signature, and passes it as is for "(ii)i", the code of
+       one must not be reused for the other */
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files().size(), 1U);
+
+    sum_result = 0;
+    ASSERT_TRUE(run_app(3, buf_sum_offset_symbols)) << error_buf;
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files().size(), 2U);
+
+    sum_result = 0;
+    ASSERT_TRUE(run_app(3, buf_sum_symbols)) << error_buf;
+    ASSERT_EQ(sum_result, (uint32)SUM_RESULT);
+    ASSERT_EQ(get_cache_files().size(), 2U);
+}
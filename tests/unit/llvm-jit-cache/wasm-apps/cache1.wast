@@ -0,0 +1,44 @@
+(module
+  (import "env" "buf_sum" (func $buf_sum (param i32 i32) (result i32)))
+
+  (memory (export "memory") 1)
+  (data (i32.const 16) "\01\02\03\04\05\06\07\08")
+
+  (func (export "fib") (param $n i32) (result i32)
+    (local $a i32)
+    (local $b i32)
+    (local $t i32)
+    i32.const 0
+    local.set $a
+    i32.const 1
+    local.set $b
+    block
+      loop
+        local.get $n
+        i32.eqz
+        br_if 1
+        local.get $a
+        local.get $b
+        i32.add
+        local.set $t
+        local.get $b
+        local.set $a
+        local.get $t
+        local.set $b
+        local.get $n
+        i32.const 1
+        i32.sub
+        local.set $n
+        br 0
+      end
+    end
+    local.get $a
+  )
+
+  ;; the sum of the 8 bytes at 16, calculated by the native function
+  (func (export "sum") (result i32)
+    i32.const 16
+    i32.const 8
+    call $buf_sum
+  )
+)
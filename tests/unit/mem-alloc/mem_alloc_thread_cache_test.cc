@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "wasm_export.h"
+#include "mem_alloc.h"
+#include "ems/ems_gc.h"
+#include "ems/ems_gc_internal.h"
+
+#if GC_ENABLE_THREAD_CACHE != 0
+
+/* Size of the small blocks allocated, a chunk of 64 bytes with the
+   header, which is cached */
+#define CHUNK_SIZE 64
+#define SMALL_SIZE (CHUNK_SIZE - HMU_SIZE - OBJ_PREFIX_SIZE - OBJ_SUFFIX_SIZE)
+
+/* A larger block which is still cached, of 3 chunks of 64 bytes */
+#define MEDIUM_SIZE \
+    (CHUNK_SIZE * 3 - HMU_SIZE - OBJ_PREFIX_SIZE - OBJ_SUFFIX_SIZE)
+
+#define RUN_LEN 16
+
+static char heap_buf[64 * 1024];
+
+class MemAllocThreadCacheTest : public testing::Test
+{
+  protected:
+    void SetUp()
+    {
+        allocator = mem_allocator_create(heap_buf, sizeof(heap_buf));
+        ASSERT_TRUE(allocator != NULL);
+        ASSERT_TRUE(mem_allocator_enable_thread_cache(allocator));
+        heap = (gc_heap_t *)allocator;
+    }
+
+    void TearDown()
+    {
+        if (allocator)
+            mem_allocator_destroy(allocator);
+    }
+
+  public:
+    gc_size_t get_cached_size()
+    {
+        gc_size_t size = 0;
+        uint32 i;
+
+        for (i = 0; i < GC_THREAD_CACHE_NUM; i++)
+            size += heap->thread_caches[i].cached_size;
+        return size;
+    }
+
+    /* The free space counted by the heap must be the size of its free
+       chunks, the cached chunks are in use from the view of the heap */
+    void check_heap()
+    {
+        hmu_t *cur = (hmu_t *)heap->base_addr;
+        hmu_t *end = (hmu_t *)((char *)heap->base_addr + heap->current_size);
+        gc_size_t free_size = 0;
+        gc_uint32 ut;
+
+        while (cur < end) {
+            ut = hmu_get_ut(cur);
+            if (ut == HMU_FC || ut == HMU_FM)
+                free_size += hmu_get_size(cur);
+            cur = (hmu_t *)((char *)cur + hmu_get_size(cur));
+        }
+
+        ASSERT_EQ(cur, end);
+        ASSERT_EQ(free_size, heap->total_free_size);
+    }
+
+    mem_alloc_info_t get_alloc_info()
+    {
+        mem_alloc_info_t info;
+
+        EXPECT_TRUE(mem_allocator_get_alloc_info(allocator, &info));
+        return info;
+    }
+
+  public:
+    mem_allocator_t allocator = NULL;
+    gc_heap_t *heap = NULL;
+};
+
+TEST_F(MemAllocThreadCacheTest, Free_from_another_thread)
+{
+    std::vector<void *> blocks, reallocated;
+    gc_size_t free_size = heap->total_free_size;
+    uint32 i;
+
+    for (i = 0; i < RUN_LEN; i++) {
+        blocks.push_back(mem_allocator_malloc(allocator, SMALL_SIZE));
+        ASSERT_TRUE(blocks.back() != NULL);
+    }
+
+    /* The blocks freed by the other thread go to its thread cache, from
+       which it allocates them again */
+    std::thread thread([&]() {
+        gc_size_t cached_size = get_cached_size();
+
+        for (i = 0; i < RUN_LEN; i++)
+            mem_allocator_free(allocator, blocks[i]);
+        EXPECT_EQ(get_cached_size(), cached_size + RUN_LEN * CHUNK_SIZE);
+
+        for (i = 0; i < RUN_LEN; i++)
+            reallocated.push_back(mem_allocator_malloc(allocator, SMALL_SIZE));
+        EXPECT_EQ(get_cached_size(), cached_size);
+    });
+    thread.join();
+
+    std::sort(blocks.begin(), blocks.end());
+    std::sort(reallocated.begin(), reallocated.end());
+    EXPECT_EQ(reallocated, blocks);
+
+    /* Freed by the allocating thread again, the blocks go back to the
+       heap when the caches are flushed */
+    for (i = 0; i < RUN_LEN; i++)
+        mem_allocator_free(allocator, reallocated[i]);
+    gci_flush_thread_caches(heap);
+    EXPECT_EQ(get_cached_size(), 0u);
+    EXPECT_EQ(heap->total_free_size, free_size);
+    check_heap();
+}
+
+TEST_F(MemAllocThreadCacheTest, Double_free_rejected)
+{
+    void *block = mem_allocator_malloc(allocator, SMALL_SIZE);
+    gc_size_t cached_size;
+
+    ASSERT_TRUE(block != NULL);
+    ASSERT_EQ(gc_free_vo(heap, block), GC_SUCCESS);
+    cached_size = get_cached_size();
+
+    /* The block is in the thread cache with its freed bit set, freeing it
+       again is rejected by this thread and by the others */
+#if BH_DEBUG != 0
+    EXPECT_DEATH(gc_free_vo(heap, block), "");
+    EXPECT_DEATH(
+        {
+            std::thread thread([&]() { gc_free_vo(heap, block); });
+            thread.join();
+        },
+        "");
+#else
+    int ret = GC_SUCCESS;
+
+    EXPECT_EQ(gc_free_vo(heap, block), GC_ERROR);
+    std::thread thread([&]() { ret = gc_free_vo(heap, block); });
+    thread.join();
+    EXPECT_EQ(ret, GC_ERROR);
+#endif
+    EXPECT_EQ(get_cached_size(), cached_size);
+
+    /* The block is cached once only */
+    EXPECT_EQ(mem_allocator_malloc(allocator, SMALL_SIZE), block);
+    EXPECT_NE(mem_allocator_malloc(allocator, SMALL_SIZE), block);
+}
+
+TEST_F(MemAllocThreadCacheTest, Flush_on_miss_before_heap_fallback)
+{
+    std::vector<char *> blocks;
+    char *block, *medium;
+    uint32 i, j;
+
+    /* Use up the heap */
+    while ((block = (char *)mem_allocator_malloc(allocator, SMALL_SIZE)))
+        blocks.push_back(block);
+    ASSERT_GT(blocks.size(), (size_t)RUN_LEN);
+    EXPECT_EQ(mem_allocator_malloc(allocator, MEDIUM_SIZE), (void *)NULL);
+
+    /* Find a run of adjacent blocks */
+    std::sort(blocks.begin(), blocks.end());
+    for (i = 0; i + RUN_LEN <= blocks.size(); i++) {
+        for (j = 1; j < RUN_LEN; j++) {
+            if (blocks[i + j] != blocks[i] + CHUNK_SIZE * j)
+                break;
+        }
+        if (j == RUN_LEN)
+            break;
+    }
+    ASSERT_LE(i + RUN_LEN, blocks.size());
+
+    /* Freed by another thread, the run is held by its thread cache */
+    std::thread thread([&]() {
+        for (j = 0; j < RUN_LEN; j++)
+            mem_allocator_free(allocator, blocks[i + j]);
+    });
+    thread.join();
+    EXPECT_EQ(get_cached_size(), (gc_size_t)(RUN_LEN * CHUNK_SIZE));
+
+    /* Neither the cache of this thread nor the heap has a chunk for the
+       medium block, the caches are flushed, so that the run is merged
+       into a free chunk of the heap before the heap is tried */
+    medium = (char *)mem_allocator_malloc(allocator, MEDIUM_SIZE);
+    ASSERT_TRUE(medium != NULL);
+    EXPECT_GE(medium, blocks[i]);
+    EXPECT_LT(medium, blocks[i] + CHUNK_SIZE * RUN_LEN);
+    EXPECT_EQ(get_cached_size(), 0u);
+    check_heap();
+}
+
+TEST_F(MemAllocThreadCacheTest, Alloc_info_counts_cached_chunks_free)
+{
+    mem_alloc_info_t info = get_alloc_info(), info_allocated, info_freed;
+    std::vector<void *> blocks;
+    gc_size_t cached_size;
+    uint32 i;
+
+    /* The thread cache is refilled with more chunks than allocated */
+    for (i = 0; i < RUN_LEN + 4; i++) {
+        blocks.push_back(mem_allocator_malloc(allocator, SMALL_SIZE));
+        ASSERT_TRUE(blocks.back() != NULL);
+    }
+    cached_size = get_cached_size();
+    EXPECT_GT(cached_size, 0u);
+
+    info_allocated = get_alloc_info();
+    EXPECT_EQ(info_allocated.total_size, info.total_size);
+    EXPECT_EQ(info_allocated.total_free_size,
+              info.total_free_size - (RUN_LEN + 4) * CHUNK_SIZE);
+
+    for (i = 0; i < blocks.size(); i++)
+        mem_allocator_free(allocator, blocks[i]);
+    EXPECT_EQ(get_cached_size(),
+              cached_size + (gc_size_t)((RUN_LEN + 4) * CHUNK_SIZE));
+
+    info_freed = get_alloc_info();
+    EXPECT_EQ(info_freed.total_free_size, info.total_free_size);
+    EXPECT_LT(heap->total_free_size, info.total_free_size);
+}
+
+#endif /* end of GC_ENABLE_THREAD_CACHE != 0 */
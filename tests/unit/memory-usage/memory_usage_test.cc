@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+#define PAGE_SIZE 65536
+
+class MemoryUsageTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        std::string file;
+        uint32 wasm_file_size;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+        is_runtime_inited = true;
+
+        file = CWD + "/usage.wasm";
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_TRUE(module != NULL) << error_buf;
+    }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    void instantiate(uint32 heap_size)
+    {
+        module_inst = wasm_runtime_instantiate(module, 8192, heap_size,
+                                               error_buf, sizeof(error_buf));
+        ASSERT_TRUE(module_inst != NULL) << error_buf;
+        memory = wasm_runtime_get_default_memory(module_inst);
+        ASSERT_TRUE(memory != NULL);
+    }
+
+    bool call(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+
+        return func && exec_env
+               && wasm_runtime_call_wasm(exec_env, func, argc, argv);
+    }
+
+    void store(uint32 addr, uint32 value)
+    {
+        uint32 argv[2] = { addr, value };
+
+        ASSERT_TRUE(call("store", 2, argv))
+            << wasm_runtime_get_exception(module_inst);
+    }
+
+    uint32 grow(uint32 delta)
+    {
+        uint32 argv[1] = { delta };
+
+        EXPECT_TRUE(call("grow", 1, argv))
+            << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+  public:
+    std::string CWD;
+    bool is_runtime_inited = false;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_memory_inst_t memory = NULL;
+    char error_buf[128];
+};
+
+#if defined(OS_ENABLE_MEM_RESIDENT_INFO) && defined(OS_ENABLE_HW_BOUND_CHECK)
+TEST_F(MemoryUsageTest, Resident_size_moves_on_touch)
+{
+    uint64 os_page_size = (uint64)os_getpagesize(), resident_size;
+    uint32 i;
+
+    instantiate(0);
+
+    /* The linear memory is freshly mapped, none of its pages has been
+       touched */
+    resident_size = wasm_memory_get_resident_size(memory);
+    EXPECT_EQ(resident_size, 0u);
+
+    store(0, 1);
+    store(100, 1);
+    EXPECT_EQ(wasm_memory_get_resident_size(memory),
+              resident_size + os_page_size);
+    resident_size = wasm_memory_get_resident_size(memory);
+
+    /* The grown pages aren't backed until they are touched, one page of
+       the platform is faulted in for each of them */
+    EXPECT_EQ(grow(8), 1u);
+    EXPECT_EQ(wasm_memory_get_resident_size(memory), resident_size);
+
+    for (i = 1; i <= 8; i++)
+        store(PAGE_SIZE * i + 8, i);
+    EXPECT_EQ(wasm_memory_get_resident_size(memory),
+              resident_size + 8 * os_page_size);
+    EXPECT_LE(wasm_memory_get_resident_size(memory), (uint64)PAGE_SIZE * 9);
+}
+
+TEST_F(MemoryUsageTest, Module_inst_mem_usage)
+{
+    uint64 os_page_size = (uint64)os_getpagesize(), memory_size;
+    module_inst_mem_usage_t usage, usage_grown;
+    uint64 app_offset;
+    void *native_addr;
+
+    instantiate(16384);
+    ASSERT_TRUE(wasm_runtime_set_instance_reset_point(module_inst, error_buf,
+                                                      sizeof(error_buf)))
+        << error_buf;
+
+    ASSERT_TRUE(wasm_runtime_get_module_inst_mem_usage(module_inst, &usage));
+    memory_size = (uint64)PAGE_SIZE * wasm_memory_get_cur_page_count(memory);
+    EXPECT_EQ(usage.linear_memory_size, memory_size);
+    EXPECT_EQ(usage.linear_memory_peak_size, memory_size);
+    EXPECT_EQ(usage.linear_memory_committed_size,
+              wasm_memory_get_resident_size(memory));
+    EXPECT_EQ(usage.linear_memory_reserved_size, 8 * (uint64)BH_GB);
+    EXPECT_GT(usage.app_heap_size, 0u);
+
+    /* The used size of the app heap goes back when the block is freed, its
+       peak doesn't */
+    app_offset = wasm_runtime_module_malloc(module_inst, 1000, &native_addr);
+    ASSERT_NE(app_offset, 0u);
+    memset(native_addr, 1, 1000);
+    ASSERT_TRUE(
+        wasm_runtime_get_module_inst_mem_usage(module_inst, &usage_grown));
+    EXPECT_GE(usage_grown.app_heap_used_size, usage.app_heap_used_size + 1000);
+    EXPECT_GE(usage_grown.app_heap_peak_used_size,
+              usage_grown.app_heap_used_size);
+    wasm_runtime_module_free(module_inst, app_offset);
+    ASSERT_TRUE(wasm_runtime_get_module_inst_mem_usage(module_inst, &usage));
+    EXPECT_LT(usage.app_heap_used_size, usage_grown.app_heap_used_size);
+    EXPECT_EQ(usage.app_heap_peak_used_size,
+              usage_grown.app_heap_peak_used_size);
+
+    /* The current and peak sizes follow the growth, the committed size
+       the touched pages */
+    grow(4);
+    store((uint32)memory_size + 8, 1);
+    ASSERT_TRUE(
+        wasm_runtime_get_module_inst_mem_usage(module_inst, &usage_grown));
+    EXPECT_EQ(usage_grown.linear_memory_size, memory_size + 4 * PAGE_SIZE);
+    EXPECT_EQ(usage_grown.linear_memory_peak_size,
+              memory_size + 4 * PAGE_SIZE);
+    EXPECT_EQ(usage_grown.linear_memory_committed_size,
+              usage.linear_memory_committed_size + os_page_size);
+
+    /* The reset shrinks the memory back, the peak size stays */
+    ASSERT_TRUE(
+        wasm_runtime_reset_instance(module_inst, error_buf, sizeof(error_buf)))
+        << error_buf;
+    ASSERT_TRUE(wasm_runtime_get_module_inst_mem_usage(module_inst, &usage));
+    EXPECT_EQ(usage.linear_memory_size, memory_size);
+    EXPECT_EQ(usage.linear_memory_peak_size, memory_size + 4 * PAGE_SIZE);
+    EXPECT_LE(usage.linear_memory_committed_size, memory_size);
+}
+#endif /* end of defined(OS_ENABLE_MEM_RESIDENT_INFO) \
+          && defined(OS_ENABLE_HW_BOUND_CHECK) */
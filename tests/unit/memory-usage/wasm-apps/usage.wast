@@ -0,0 +1,19 @@
+(module
+  (memory 1 16)
+
+  (func (export "store") (param i32 i32)
+    local.get 0
+    local.get 1
+    i32.store
+  )
+
+  (func (export "load") (param i32) (result i32)
+    local.get 0
+    i32.load
+  )
+
+  (func (export "grow") (param i32) (result i32)
+    local.get 0
+    memory.grow
+  )
+)
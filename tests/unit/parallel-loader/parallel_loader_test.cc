@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "wasm_export.h"
+
+/* The modules are generated so that their code section is larger than
+   WASM_PARALLEL_LOADER_MIN_CODE_SIZE, or they are loaded serially */
+#define FUNC_NUM 2000
+#define ADD_NUM 10
+
+/* The number of i32.const/drop pairs in a slow function, which takes
+   much longer to be validated than the others */
+#define SLOW_FUNC_DROP_NUM 50000
+
+enum FuncKind {
+    FUNC_VALID,
+    /* local.get of a local which doesn't exist */
+    FUNC_UNKNOWN_LOCAL,
+    /* i64 result of an i32 function */
+    FUNC_TYPE_MISMATCH,
+};
+
+typedef struct InvalidFunc {
+    uint32 index;
+    FuncKind kind;
+    /* the number of i32.const/drop pairs before the invalid code */
+    uint32 drop_num;
+} InvalidFunc;
+
+static void
+emit_leb(std::vector<uint8> &buf, uint32 value)
+{
+    do {
+        uint8 byte = value & 0x7f;
+        value >>= 7;
+        buf.push_back(value ? byte | 0x80 : byte);
+    } while (value);
+}
+
+static void
+emit_sleb(std::vector<uint8> &buf, int32 value)
+{
+    bool more = true;
+
+    while (more) {
+        uint8 byte = value & 0x7f;
+        value >>= 7;
+        more = !((value == 0 && !(byte & 0x40))
+                 || (value == -1 && (byte & 0x40)));
+        buf.push_back(more ? byte | 0x80 : byte);
+    }
+}
+
+static void
+emit_section(std::vector<uint8> &buf, uint8 id,
+             const std::vector<uint8> &content)
+{
+    buf.push_back(id);
+    emit_leb(buf, (uint32)content.size());
+    buf.insert(buf.end(), content.begin(), content.end());
+}
+
+/* Function i is (func (param i32) (result i32)) which returns the param
+   plus i * ADD_NUM + ADD_NUM * (ADD_NUM - 1) / 2 if it is valid */
+static std::vector<uint8>
+build_function_body(uint32 i, FuncKind kind, uint32 drop_num)
+{
+    std::vector<uint8> code, body;
+    uint32 k;
+
+    code.push_back(0x00); /* no local declarations */
+
+    for (k = 0; k < drop_num; k++) {
+        code.push_back(0x41); /* i32.const 1 */
+        code.push_back(0x01);
+        code.push_back(0x1a); /* drop */
+    }
+
+    code.push_back(0x20); /* local.get */
+    code.push_back(kind == FUNC_UNKNOWN_LOCAL ? 5 : 0);
+    for (k = 0; k < ADD_NUM; k++) {
+        code.push_back(0x41); /* i32.const i + k */
+        emit_sleb(code, (int32)(i + k));
+        code.push_back(0x6a); /* i32.add */
+    }
+    if (kind == FUNC_TYPE_MISMATCH) {
+        code.push_back(0x1a); /* drop */
+        code.push_back(0x42); /* i64.const 0 */
+        code.push_back(0x00);
+    }
+    code.push_back(0x0b); /* end */
+
+    emit_leb(body, (uint32)code.size());
+    body.insert(body.end(), code.begin(), code.end());
+    return body;
+}
+
+/* Build a module of FUNC_NUM functions exported as "f<i>", the functions
+   not in invalid_funcs are valid */
+static std::vector<uint8>
+build_module(const std::vector<InvalidFunc> &invalid_funcs)
+{
+    static const uint8 header[] = { 0x00, 0x61, 0x73, 0x6d,
+                                    0x01, 0x00, 0x00, 0x00 };
+    std::vector<uint8> buf(header, header + sizeof(header)), section;
+    std::vector<uint8> body;
+    std::string name;
+    FuncKind kind;
+    uint32 drop_num, i;
+
+    /* (type (func (param i32) (result i32))) */
+    section = { 0x01, 0x60, 0x01, 0x7f, 0x01, 0x7f };
+    emit_section(buf, 1, section);
+
+    section.clear();
+    emit_leb(section, FUNC_NUM);
+    for (i = 0; i < FUNC_NUM; i++)
+        section.push_back(0x00);
+    emit_section(buf, 3, section);
+
+    section.clear();
+    emit_leb(section, FUNC_NUM);
+    for (i = 0; i < FUNC_NUM; i++) {
+        name = "f" + std::to_string(i);
+        emit_leb(section, (uint32)name.size());
+        section.insert(section.end(), name.begin(), name.end());
+        section.push_back(0x00);
+        emit_leb(section, i);
+    }
+    emit_section(buf, 7, section);
+
+    section.clear();
+    emit_leb(section, FUNC_NUM);
+    for (i = 0; i < FUNC_NUM; i++) {
+        kind = FUNC_VALID;
+        drop_num = 0;
+        for (const InvalidFunc &func : invalid_funcs) {
+            if (func.index == i) {
+                kind = func.kind;
+                drop_num = func.drop_num;
+            }
+        }
+        body = build_function_body(i, kind, drop_num);
+        section.insert(section.end(), body.begin(), body.end());
+    }
+    emit_section(buf, 10, section);
+
+    return buf;
+}
+
+class ParallelLoaderTest : public testing::Test
+{
+  protected:
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (is_runtime_inited)
+            wasm_runtime_destroy();
+    }
+
+  public:
+    bool init_runtime(uint32 loader_thread_num)
+    {
+        RuntimeInitArgs init_args;
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        init_args.loader_thread_num = loader_thread_num;
+
+        is_runtime_inited = wasm_runtime_full_init(&init_args);
+        return is_runtime_inited;
+    }
+
+    void destroy_runtime()
+    {
+        if (module_inst) {
+            wasm_runtime_deinstantiate(module_inst);
+            module_inst = NULL;
+        }
+        if (module) {
+            wasm_runtime_unload(module);
+            module = NULL;
+        }
+        wasm_runtime_destroy();
+        is_runtime_inited = false;
+    }
+
+    /* Load the module with the threads given, return the error message,
+       which is empty if the module is loaded */
+    std::string load(uint32 loader_thread_num)
+    {
+        EXPECT_TRUE(init_runtime(loader_thread_num));
+
+        /* The loader may rewrite the buffer, load a copy each time */
+        wasm_buf = module_buf;
+        error_buf[0] = '\0';
+        module = wasm_runtime_load(wasm_buf.data(), (uint32)wasm_buf.size(),
+                                   error_buf, sizeof(error_buf));
+        return module ? std::string() : std::string(error_buf);
+    }
+
+    uint32 call_func(uint32 i, uint32 arg)
+    {
+        std::string name = "f" + std::to_string(i);
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name.c_str());
+        wasm_exec_env_t exec_env =
+            wasm_runtime_get_exec_env_singleton(module_inst);
+        uint32 argv[1] = { arg };
+
+        EXPECT_TRUE(func && exec_env
+                    && wasm_runtime_call_wasm(exec_env, func, 1, argv))
+            << name;
+        return argv[0];
+    }
+
+    /* Check that module_buf fails to be loaded with the same error when
+       it is loaded by several threads as when it is loaded serially */
+    void check_same_error_as_serial(const char *error)
+    {
+        static const uint32 thread_nums[] = { 2, 4, 8 };
+        std::string serial_error;
+        int round;
+
+        serial_error = load(1);
+        destroy_runtime();
+        ASSERT_NE(serial_error.find(error), std::string::npos)
+            << serial_error;
+
+        for (uint32 thread_num : thread_nums) {
+            for (round = 0; round < 5; round++) {
+                EXPECT_EQ(load(thread_num), serial_error)
+                    << thread_num << " threads, round " << round;
+                destroy_runtime();
+            }
+        }
+    }
+
+  public:
+    bool is_runtime_inited = false;
+    std::vector<uint8> module_buf, wasm_buf;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    char error_buf[128];
+};
+
+TEST_F(ParallelLoaderTest, Same_module_as_serial)
+{
+    static const uint32 thread_nums[] = { 1, 2, 4, 8 };
+    static const uint32 funcs[] = { 0, 1, 999, FUNC_NUM - 1 };
+
+    module_buf = build_module({});
+
+    for (uint32 thread_num : thread_nums) {
+        ASSERT_EQ(load(thread_num), "") << thread_num << " threads";
+        ASSERT_TRUE(module_inst = wasm_runtime_instantiate(
+                        module, 16 * 1024, 0, error_buf, sizeof(error_buf)))
+            << error_buf;
+
+        for (uint32 i : funcs) {
+            EXPECT_EQ(call_func(i, 7),
+                      7 + i * ADD_NUM + ADD_NUM * (ADD_NUM - 1) / 2)
+                << "f" << i << " loaded by " << thread_num << " threads";
+        }
+        destroy_runtime();
+    }
+}
+
+TEST_F(ParallelLoaderTest, Same_first_error_as_serial)
+{
+    /* The invalid functions are in the middle so that all the threads
+       are running when they are validated. The first invalid function
+       takes the longest to be validated, so the threads usually find
+       the later invalid function first */
+    module_buf = build_module(
+        { { 1000, FUNC_UNKNOWN_LOCAL, SLOW_FUNC_DROP_NUM },
+          { 1010, FUNC_TYPE_MISMATCH, 0 },
+          { FUNC_NUM - 1, FUNC_TYPE_MISMATCH, 0 } });
+    check_same_error_as_serial("unknown local");
+
+    /* The function right after the first invalid one is still being
+       validated when the first one fails, and fails later */
+    module_buf =
+        build_module({ { 1000, FUNC_TYPE_MISMATCH, SLOW_FUNC_DROP_NUM },
+                       { 1001, FUNC_UNKNOWN_LOCAL, SLOW_FUNC_DROP_NUM * 2 } });
+    check_same_error_as_serial("type mismatch");
+
+    /* Only the last function is invalid */
+    module_buf = build_module({ { FUNC_NUM - 1, FUNC_TYPE_MISMATCH, 0 } });
+    check_same_error_as_serial("type mismatch");
+}
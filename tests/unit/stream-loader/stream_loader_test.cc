@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+
+class StreamLoaderTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        std::string file;
+        unsigned char *wasm_file_buf;
+        uint32 wasm_file_size;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        file = CWD + "/state.wasm";
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL);
+        wasm_buf.assign(wasm_file_buf, wasm_file_buf + wasm_file_size);
+        BH_FREE(wasm_file_buf);
+    }
+
+    void TearDown() { wasm_runtime_destroy(); }
+
+  public:
+    /* Load the buffer with wasm_runtime_load, return the module and the
+       error message */
+    wasm_module_t load(const std::vector<uint8> &buf, std::string &error)
+    {
+        wasm_module_t module;
+
+        /* The loader may rewrite the buffer, which must be kept until the
+           module is unloaded */
+        loaded_bufs.push_back(buf);
+        error_buf[0] = '\0';
+        module = wasm_runtime_load(loaded_bufs.back().data(),
+                                   (uint32)buf.size(), error_buf,
+                                   sizeof(error_buf));
+        error = error_buf;
+        return module;
+    }
+
+    /* Load the buffer from a stream fed with chunks of chunk_size bytes,
+       return the module and the error message */
+    wasm_module_t stream_load(const std::vector<uint8> &buf,
+                              uint32 chunk_size, std::string &error)
+    {
+        LoadArgs load_args;
+        wasm_module_stream_t stream;
+        wasm_module_t module;
+        std::vector<uint8> chunk;
+        uint32 offset, size;
+
+        memset(&load_args, 0, sizeof(LoadArgs));
+        load_args.name = (char *)"stream";
+
+        error_buf[0] = '\0';
+        if (!(stream = wasm_runtime_stream_load_begin(&load_args, error_buf,
+                                                      sizeof(error_buf)))) {
+            error = error_buf;
+            return NULL;
+        }
+
+        for (offset = 0; offset < buf.size(); offset += size) {
+            size = std::min(chunk_size, (uint32)buf.size() - offset);
+            /* The chunk is overwritten after being fed, as it can be
+               freed once fed */
+            chunk.assign(buf.begin() + offset, buf.begin() + offset + size);
+            if (!wasm_runtime_stream_load_feed(stream, chunk.data(), size,
+                                               error_buf, sizeof(error_buf))) {
+                error = error_buf;
+                wasm_runtime_stream_load_abort(stream);
+                return NULL;
+            }
+            chunk.assign(size, 0xff);
+        }
+
+        module = wasm_runtime_stream_load_finish(stream, error_buf,
+                                                 sizeof(error_buf));
+        error = error_buf;
+        return module;
+    }
+
+    /* Run state.wasm and return the results of its functions */
+    std::vector<uint32> run(wasm_module_t module)
+    {
+        static const char *funcs[] = { "init",     "mem_size", "get_global",
+                                       "mutate",   "mem_size", "get_global" };
+        wasm_module_inst_t module_inst;
+        wasm_exec_env_t exec_env;
+        wasm_function_inst_t func;
+        std::vector<uint32> results;
+        uint32 argv[1];
+
+        module_inst = wasm_runtime_instantiate(module, 16 * 1024, 0,
+                                               error_buf, sizeof(error_buf));
+        EXPECT_TRUE(module_inst != NULL) << error_buf;
+        if (!module_inst)
+            return results;
+        exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+
+        /* the data segment "hello" isn't dropped yet */
+        argv[0] = 200;
+        func = wasm_runtime_lookup_function(module_inst, "copy_data");
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        argv[0] = 200;
+        func = wasm_runtime_lookup_function(module_inst, "load");
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        results.push_back(argv[0]);
+
+        for (const char *name : funcs) {
+            argv[0] = 0;
+            func = wasm_runtime_lookup_function(module_inst, name);
+            EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 0, argv))
+                << name;
+            results.push_back(argv[0]);
+        }
+
+        argv[0] = 1;
+        func = wasm_runtime_lookup_function(module_inst, "call_slot");
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, 1, argv));
+        results.push_back(argv[0]);
+
+        wasm_runtime_deinstantiate(module_inst);
+        return results;
+    }
+
+  public:
+    std::string CWD;
+    std::vector<uint8> wasm_buf;
+    std::vector<std::vector<uint8>> loaded_bufs;
+    char error_buf[128];
+};
+
+TEST_F(StreamLoaderTest, Load_in_chunks)
+{
+    static const uint32 chunk_sizes[] = { 1, 2, 7, 64, 0xffffffff };
+    wasm_module_t module, streamed;
+    std::vector<uint32> results;
+    std::string error;
+
+    ASSERT_TRUE(module = load(wasm_buf, error)) << error;
+    results = run(module);
+    ASSERT_EQ(results[0], 0x6c6c6568U);
+    wasm_runtime_unload(module);
+
+    for (uint32 chunk_size : chunk_sizes) {
+        ASSERT_TRUE(streamed = stream_load(wasm_buf, chunk_size, error))
+            << chunk_size << " byte chunks: " << error;
+        EXPECT_EQ(run(streamed), results) << chunk_size << " byte chunks";
+        wasm_runtime_unload(streamed);
+    }
+}
+
+TEST_F(StreamLoaderTest, Truncated_input)
+{
+    wasm_module_t module, streamed;
+    std::vector<uint8> buf;
+    std::string error, stream_error;
+    uint32 size;
+
+    /* The stream cut at any byte fails with the same error as
+       wasm_runtime_load, or is loaded as well when it is cut right
+       after a section */
+    for (size = 0; size < wasm_buf.size(); size++) {
+        buf.assign(wasm_buf.begin(), wasm_buf.begin() + size);
+
+        module = load(buf, error);
+        streamed = stream_load(buf, 1, stream_error);
+        EXPECT_EQ(streamed != NULL, module != NULL) << size << " bytes";
+        if (!module) {
+            EXPECT_EQ(stream_error, error) << size << " bytes";
+        }
+
+        if (module)
+            wasm_runtime_unload(module);
+        if (streamed)
+            wasm_runtime_unload(streamed);
+    }
+}
+
+TEST_F(StreamLoaderTest, Corrupted_input)
+{
+    static const uint8 values[] = { 0x00, 0x01, 0x7f, 0x80, 0xff };
+    wasm_module_t module, streamed;
+    std::vector<uint8> buf;
+    std::string error, stream_error;
+    uint32 offset;
+
+    /* The stream with any byte changed is loaded, or rejected, as by
+       wasm_runtime_load. The error messages may differ, as the stream
+       loader checks the sizes of the sections and function bodies
+       before the bytes after them arrive */
+    for (offset = 0; offset < wasm_buf.size(); offset++) {
+        for (uint8 value : values) {
+            if (wasm_buf[offset] == value)
+                continue;
+
+            buf = wasm_buf;
+            buf[offset] = value;
+
+            module = load(buf, error);
+            streamed = stream_load(buf, 1, stream_error);
+            EXPECT_EQ(streamed != NULL, module != NULL)
+                << "byte " << offset << " set to " << (uint32)value << ": "
+                << (module ? stream_error : error);
+
+            if (module)
+                wasm_runtime_unload(module);
+            if (streamed)
+                wasm_runtime_unload(streamed);
+        }
+    }
+}
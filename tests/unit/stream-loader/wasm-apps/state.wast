@@ -0,0 +1,55 @@
+(module
+  (type $get (func (result i32)))
+
+  (table 2 funcref)
+  (memory 1 4)
+  (global $g (mut i32) (i32.const 0))
+
+  (elem (i32.const 0) $a)
+  (elem declare func $b)
+  (data $hello "hello")
+
+  (func $a (type $get) i32.const 11)
+  (func $b (type $get) i32.const 22)
+
+  ;; change the state created by the instantiation
+  (func (export "init")
+    (i32.store (i32.const 100) (i32.const 0x1234))
+    (drop (memory.grow (i32.const 1)))
+    (i32.store (i32.const 65544) (i32.const 0x5678))
+    (global.set $g (i32.const 7))
+    (table.set (i32.const 1) (ref.func $b))
+    (data.drop $hello)
+  )
+
+  (func (export "load") (param $addr i32) (result i32)
+    (i32.load (local.get $addr))
+  )
+
+  (func (export "get_global") (result i32)
+    (global.get $g)
+  )
+
+  (func (export "call_slot") (param $slot i32) (result i32)
+    (call_indirect (type $get) (local.get $slot))
+  )
+
+  (func (export "mem_size") (result i32)
+    (memory.size)
+  )
+
+  ;; trap if the data segment was dropped
+  (func (export "copy_data") (param $dst i32)
+    (memory.init $hello (local.get $dst) (i32.const 0) (i32.const 5))
+  )
+
+  ;; change the state again after "init"
+  (func (export "mutate")
+    (i32.store (i32.const 100) (i32.const 0x4321))
+    (drop (memory.grow (i32.const 2)))
+    (i32.store (i32.const 131080) (i32.const 0x9abc))
+    (global.set $g (i32.const 99))
+    (table.set (i32.const 0) (ref.null func))
+    (table.set (i32.const 1) (ref.func $a))
+  )
+)
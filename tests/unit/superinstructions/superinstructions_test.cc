@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2019 Intel Corporation. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+ */
+
+#include <climits>
+
+#include "gtest/gtest.h"
+#include "bh_platform.h"
+#include "bh_read_file.h"
+#include "wasm_export.h"
+#include "wasm.h"
+
+#define CMP_OP_NUM 11
+
+static const char *cmp_ops[CMP_OP_NUM] = { "eqz",  "eq",   "ne",   "lt_s",
+                                           "lt_u", "gt_s", "gt_u", "le_s",
+                                           "le_u", "ge_s", "ge_u" };
+
+static bool
+eval_cmp(int op, int32 a, int32 b)
+{
+    switch (op) {
+        case 0:
+            return a == 0;
+        case 1:
+            return a == b;
+        case 2:
+            return a != b;
+        case 3:
+            return a < b;
+        case 4:
+            return (uint32)a < (uint32)b;
+        case 5:
+            return a > b;
+        case 6:
+            return (uint32)a > (uint32)b;
+        case 7:
+            return a <= b;
+        case 8:
+            return (uint32)a <= (uint32)b;
+        case 9:
+            return a >= b;
+        default:
+            return (uint32)a >= (uint32)b;
+    }
+}
+
+class SuperinstructionsTest : public testing::Test
+{
+  private:
+    std::string get_binary_path()
+    {
+        char cwd[1024] = { 0 };
+
+        if (readlink("/proc/self/exe", cwd, 1024) <= 0) {
+            return NULL;
+        }
+
+        char *path_end = strrchr(cwd, '/');
+        if (path_end != NULL) {
+            *path_end = '\0';
+        }
+
+        return std::string(cwd);
+    }
+
+  protected:
+    void SetUp()
+    {
+        RuntimeInitArgs init_args;
+        std::string file;
+        uint32 wasm_file_size;
+
+        CWD = get_binary_path();
+
+        memset(&init_args, 0, sizeof(RuntimeInitArgs));
+        init_args.mem_alloc_type = Alloc_With_System_Allocator;
+        ASSERT_TRUE(wasm_runtime_full_init(&init_args));
+
+        file = CWD + "/cmp_br_if.wasm";
+        wasm_file_buf = (unsigned char *)bh_read_file_to_buffer(
+            file.c_str(), &wasm_file_size);
+        ASSERT_TRUE(wasm_file_buf != NULL);
+
+        module = wasm_runtime_load(wasm_file_buf, wasm_file_size, error_buf,
+                                   sizeof(error_buf));
+        ASSERT_TRUE(module != NULL) << error_buf;
+
+        module_inst = wasm_runtime_instantiate(module, 16 * 1024, 0, error_buf,
+                                               sizeof(error_buf));
+        ASSERT_TRUE(module_inst != NULL) << error_buf;
+
+        exec_env = wasm_runtime_get_exec_env_singleton(module_inst);
+        ASSERT_TRUE(exec_env != NULL);
+    }
+
+    void TearDown()
+    {
+        if (module_inst)
+            wasm_runtime_deinstantiate(module_inst);
+        if (module)
+            wasm_runtime_unload(module);
+        if (wasm_file_buf)
+            BH_FREE(wasm_file_buf);
+        wasm_runtime_destroy();
+    }
+
+  public:
+    uint32 call_i32(const char *name, uint32 argc, uint32 argv[])
+    {
+        wasm_function_inst_t func =
+            wasm_runtime_lookup_function(module_inst, name);
+
+        EXPECT_TRUE(func != NULL) << name;
+        EXPECT_TRUE(wasm_runtime_call_wasm(exec_env, func, argc, argv))
+            << name << ": " << wasm_runtime_get_exception(module_inst);
+        return argv[0];
+    }
+
+    /* The size of the pre-compiled code of an exported function */
+    uint32 get_code_compiled_size(const char *name)
+    {
+        WASMModule *wasm_module = (WASMModule *)module;
+        uint32 i;
+
+        for (i = 0; i < wasm_module->export_count; i++) {
+            if (wasm_module->exports[i].kind == EXPORT_KIND_FUNC
+                && !strcmp(wasm_module->exports[i].name, name))
+                return wasm_module->functions[wasm_module->exports[i].index]
+                    ->code_compiled_size;
+        }
+        ADD_FAILURE() << name << " not found";
+        return 0;
+    }
+
+  public:
+    std::string CWD;
+    unsigned char *wasm_file_buf = NULL;
+    wasm_module_t module = NULL;
+    wasm_module_inst_t module_inst = NULL;
+    wasm_exec_env_t exec_env = NULL;
+    char error_buf[128];
+};
+
+TEST_F(SuperinstructionsTest, Fuse_cmp_and_br_if)
+{
+    std::string fused, plain;
+    int op;
+
+    /* The nop between the comparison and br_if emits no code, so the
+       plain function is only larger when the other one is fused */
+    for (op = 0; op < CMP_OP_NUM; op++) {
+        fused = std::string("fused_") + cmp_ops[op];
+        plain = std::string("plain_") + cmp_ops[op];
+        EXPECT_LT(get_code_compiled_size(fused.c_str()),
+                  get_code_compiled_size(plain.c_str()))
+            << cmp_ops[op];
+    }
+    EXPECT_LT(get_code_compiled_size("pick"),
+              get_code_compiled_size("pick_plain"));
+}
+
+TEST_F(SuperinstructionsTest, Run_fused_cmp_and_br_if)
+{
+    static const int32 values[] = { 0,  1,       -1,      2,
+                                    -2, INT_MAX, INT_MIN, 100 };
+    std::string fused, plain;
+    uint32 argv[2], expected;
+    int op;
+
+    for (op = 0; op < CMP_OP_NUM; op++) {
+        fused = std::string("fused_") + cmp_ops[op];
+        plain = std::string("plain_") + cmp_ops[op];
+
+        for (int32 a : values) {
+            for (int32 b : values) {
+                expected = eval_cmp(op, a, b) ? 1 : 0;
+
+                argv[0] = (uint32)a;
+                argv[1] = (uint32)b;
+                EXPECT_EQ(call_i32(fused.c_str(), 2, argv), expected)
+                    << fused << "(" << a << ", " << b << ")";
+
+                argv[0] = (uint32)a;
+                argv[1] = (uint32)b;
+                EXPECT_EQ(call_i32(plain.c_str(), 2, argv), expected)
+                    << plain << "(" << a << ", " << b << ")";
+            }
+        }
+    }
+
+    /* the back edge of a loop */
+    argv[0] = 1000;
+    EXPECT_EQ(call_i32("count", 1, argv), 1000U);
+    argv[0] = 0;
+    EXPECT_EQ(call_i32("count", 1, argv), 1U);
+
+    /* a constant operand */
+    argv[0] = 99;
+    EXPECT_EQ(call_i32("below_100", 1, argv), 1U);
+    argv[0] = 100;
+    EXPECT_EQ(call_i32("below_100", 1, argv), 0U);
+    argv[0] = (uint32)-1;
+    EXPECT_EQ(call_i32("below_100", 1, argv), 0U);
+
+    /* the value carried by br_if */
+    argv[0] = 3;
+    argv[1] = 3;
+    EXPECT_EQ(call_i32("pick", 2, argv), 5U);
+    argv[0] = 3;
+    argv[1] = 4;
+    EXPECT_EQ(call_i32("pick", 2, argv), 7U);
+}
@@ -0,0 +1,244 @@
+(module
+  ;; each comparison followed by br_if is fused, the nop between them
+  ;; in the plain_ functions prevents it
+
+  (func (export "fused_eqz") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) i32.eqz
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_eqz") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) i32.eqz nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_eq") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.eq
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_eq") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.eq nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_ne") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ne
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_ne") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ne nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_lt_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.lt_s
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_lt_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.lt_s nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_lt_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.lt_u
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_lt_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.lt_u nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_gt_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.gt_s
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_gt_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.gt_s nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_gt_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.gt_u
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_gt_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.gt_u nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_le_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.le_s
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_le_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.le_s nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_le_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.le_u
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_le_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.le_u nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_ge_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ge_s
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_ge_s") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ge_s nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "fused_ge_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ge_u
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  (func (export "plain_ge_u") (param $a i32) (param $b i32) (result i32)
+    block
+      (local.get $a) (local.get $b) i32.ge_u nop
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  ;; the back edge of a loop
+  (func (export "count") (param $n i32) (result i32)
+    (local $i i32)
+    loop
+      (local.set $i (i32.add (local.get $i) (i32.const 1)))
+      (local.get $i) (local.get $n) i32.lt_s
+      br_if 0
+    end
+    (local.get $i)
+  )
+
+  ;; a constant operand
+  (func (export "below_100") (param $a i32) (result i32)
+    block
+      (local.get $a) (i32.const 100) i32.lt_u
+      br_if 0
+      (return (i32.const 0))
+    end
+    (i32.const 1)
+  )
+
+  ;; br_if which carries a value
+  (func (export "pick") (param $a i32) (param $b i32) (result i32)
+    block (result i32)
+      (i32.const 5)
+      (local.get $a) (local.get $b) i32.eq
+      br_if 0
+      drop
+      (i32.const 7)
+    end
+  )
+
+  (func (export "pick_plain") (param $a i32) (param $b i32) (result i32)
+    block (result i32)
+      (i32.const 5)
+      (local.get $a) (local.get $b) i32.eq nop
+      br_if 0
+      drop
+      (i32.const 7)
+    end
+  )
+)
@@ -136,6 +136,11 @@ print_help()
     printf("                              1 - Medium code model\n");
     printf("                              2 - Kernel code model\n");
     printf("                              3 - Small code model\n");
+    printf("  --compile-threads=n       Compile the functions in n threads (default is 1)\n");
+    printf("                              The output only depends on n, it falls back to\n");
+    printf("                              1 thread if the target or the options aren't supported\n");
+    printf("  --func-cache-dir=<dir>    Cache the object file of each function in the existing directory <dir>,\n");
+    printf("                              and only optimize and compile the functions not found in it\n");
     printf("  -sgx                      Generate code for SGX platform (Intel Software Guard Extensions)\n");
     printf("  --bounds-checks=1/0       Enable or disable the bounds checks for memory access:\n");
     printf("                              This flag controls bounds checking with a software check. \n"); 
@@ -185,6 +190,9 @@ print_help()
     printf("  --xip                     A shorthand of --enable-indirect-mode --disable-llvm-intrinsics\n");
     printf("  --enable-indirect-mode    Enable call function through symbol table but not direct call\n");
     printf("  --enable-gc               Enable GC (Garbage Collection) feature\n");
+    printf("  --enable-gc-write-barrier Call the write barrier after storing a reference into a GC object,\n");
+    printf("                            required by the runtime built with incremental GC, only takes effect\n");
+    printf("                            when --enable-gc is set\n");
     printf("  --disable-llvm-intrinsics Disable the LLVM built-in intrinsics\n");
     printf("  --enable-builtin-intrinsics=<flags>\n");
     printf("                            Enable the specified built-in intrinsics, it will override the default\n");
@@ -420,6 +428,7 @@ main(int argc, char *argv[])
 
     option.opt_level = 3;
     option.size_level = 3;
+    option.compile_thread_num = 1;
     option.output_format = AOT_FORMAT_FILE;
     /* default value, enable or disable depends on the platform */
     option.bounds_checks = 2;
@@ -491,6 +500,18 @@ main(int argc, char *argv[])
                 option.size_level = 3;
             size_level_set = true;
         }
+        else if (!strncmp(argv[0], "--func-cache-dir=", 17)) {
+            if (argv[0][17] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.func_cache_dir = argv[0] + 17;
+        }
+        else if (!strncmp(argv[0], "--compile-threads=", 18)) {
+            if (argv[0][18] == '\0')
+                PRINT_HELP_AND_EXIT();
+            option.compile_thread_num = (uint32)atoi(argv[0] + 18);
+            if (option.compile_thread_num < 1)
+                option.compile_thread_num = 1;
+        }
         else if (!strcmp(argv[0], "-sgx")) {
             sgx_mode = true;
         }
@@ -594,6 +615,9 @@ main(int argc, char *argv[])
             option.aux_stack_frame_type = AOT_STACK_FRAME_TYPE_STANDARD;
             option.enable_gc = true;
         }
+        else if (!strcmp(argv[0], "--enable-gc-write-barrier")) {
+            option.enable_gc_write_barrier = true;
+        }
         else if (!strcmp(argv[0], "--disable-llvm-intrinsics")) {
             option.disable_llvm_intrinsics = true;
         }
@@ -757,6 +781,11 @@ main(int argc, char *argv[])
         option.enable_ref_types = false;
     }
 
+    if (option.enable_gc_write_barrier && !option.enable_gc) {
+        LOG_WARNING("GC write barrier is disabled since GC isn't enabled");
+        option.enable_gc_write_barrier = false;
+    }
+
     if (option.enable_shared_chain) {
         LOG_VERBOSE("Enable shared chain will overwrite shared heap and sw "
                     "bounds control");